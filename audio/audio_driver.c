@@ -28,6 +28,7 @@
 #include <memalign.h>
 #include <audio/conversion/float_to_s16.h>
 #include <audio/conversion/s16_to_float.h>
+#include <features/features_cpu.h>
 #ifdef HAVE_AUDIOMIXER
 #include <audio/audio_mixer.h>
 #include "../tasks/task_audio_mixer.h"
@@ -55,6 +56,7 @@
 #include "../retroarch.h"
 #include "../list_special.h"
 #include "../file_path_special.h"
+#include "../frame_profiler.h"
 #include "../record/record_driver.h"
 #include "../tasks/task_content.h"
 #include "../verbosity.h"
@@ -385,6 +387,41 @@ bool audio_driver_find_driver(
    return true;
 }
 
+static void audio_driver_flush_stats_log(audio_driver_state_t *audio_st)
+{
+   unsigned i;
+   unsigned ns[AUDIO_FLUSH_STAGE_LAST];
+
+   for (i = 0; i < AUDIO_FLUSH_STAGE_LAST; i++)
+   {
+      ns[i] = (unsigned)(audio_st->flush_stage_usec[i] * 1000000
+            / (retro_time_t)audio_st->flush_stats_frames);
+      audio_st->flush_stage_usec[i] = 0;
+   }
+   audio_st->flush_stats_frames   = 0;
+
+   RARCH_LOG("[Audio]: Flush ns per 1000 frames: convert %u, DSP %u,"
+         " resample %u, mixer %u, output %u, driver write %u.\n",
+         ns[AUDIO_FLUSH_STAGE_CONVERT],
+         ns[AUDIO_FLUSH_STAGE_DSP],
+         ns[AUDIO_FLUSH_STAGE_RESAMPLE],
+         ns[AUDIO_FLUSH_STAGE_MIXER],
+         ns[AUDIO_FLUSH_STAGE_OUTPUT],
+         ns[AUDIO_FLUSH_STAGE_WRITE]);
+}
+
+/* Charges the time since @stage_start to @stage
+ * and starts timing the next stage. */
+static INLINE void audio_driver_flush_stage_end(
+      audio_driver_state_t *audio_st,
+      enum audio_flush_stage stage,
+      retro_time_t *stage_start)
+{
+   retro_time_t now                    = cpu_features_get_time_usec();
+   audio_st->flush_stage_usec[stage]  += now - *stage_start;
+   *stage_start                        = now;
+}
+
 /**
  * audio_driver_flush:
  * @data                 : pointer to audio buffer.
@@ -392,6 +429,10 @@ bool audio_driver_find_driver(
  *
  * Writes audio samples to audio driver. Will first
  * perform DSP processing (if enabled) and resampling.
+ *
+ * The samples go through every stage one block of
+ * AUDIO_FLUSH_BLOCK_FRAMES at a time, and stages that
+ * would not change the data are skipped.
  **/
 static void audio_driver_flush(
       audio_driver_state_t *audio_st,
@@ -400,45 +441,31 @@ static void audio_driver_flush(
       const int16_t *data, size_t samples,
       bool is_slowmotion, bool is_fastmotion)
 {
-   struct resampler_data src_data;
+   double ratio;
+   size_t in_frames                  = samples >> 1;
+   size_t out_frames                 = 0;
+   size_t pos                        = 0;
+   retro_time_t stage_start          = 0;
+   bool stats                        =
+      runloop_state_get_ptr()->perfcnt_enable;
    float audio_volume_gain           = (audio_st->mute_enable ||
          (audio_fastforward_mute && is_fastmotion))
                ? 0.0f 
                : audio_st->volume_gain;
+#ifdef HAVE_AUDIOMIXER
+   bool mixer_override               = true;
+   float mixer_gain                  = 0.0f;
 
-   src_data.data_out                 = NULL;
-   src_data.output_frames            = 0;
-
-   convert_s16_to_float(audio_st->input_data, data, samples,
-         audio_volume_gain);
-
-   src_data.data_in                  = audio_st->input_data;
-   src_data.input_frames             = samples >> 1;
-
-#ifdef HAVE_DSP_FILTER
-   if (audio_st->dsp)
+   if (!audio_st->mixer_mute_enable)
    {
-      struct retro_dsp_data dsp_data;
-
-      dsp_data.input                 = NULL;
-      dsp_data.input_frames          = 0;
-      dsp_data.output                = NULL;
-      dsp_data.output_frames         = 0;
-
-      dsp_data.input                 = audio_st->input_data;
-      dsp_data.input_frames          = (unsigned)(samples >> 1);
-
-      retro_dsp_filter_process(audio_st->dsp, &dsp_data);
-
-      if (dsp_data.output)
-      {
-         src_data.data_in            = dsp_data.output;
-         src_data.input_frames       = dsp_data.output_frames;
-      }
+      if (audio_st->mixer_volume_gain == 1.0f)
+         mixer_override              = false;
+      mixer_gain                     = audio_st->mixer_volume_gain;
    }
 #endif
 
-   src_data.data_out                 = audio_st->output_samples_buf;
+   frame_profiler_begin(FRAME_PROFILER_THREAD_MAIN,
+         FRAME_PROFILER_STAGE_AUDIO_FLUSH);
 
    if (audio_st->control)
    {
@@ -473,10 +500,10 @@ static void audio_driver_flush(
 #endif
    }
 
-   src_data.ratio           = audio_st->source_ratio_current;
+   ratio                   = audio_st->source_ratio_current;
 
    if (is_slowmotion)
-      src_data.ratio       *= slowmotion_ratio;
+      ratio                *= slowmotion_ratio;
 
    /* Note: Ideally we would divide by the user-configured
     * 'fastforward_ratio' when fast forward is enabled,
@@ -495,46 +522,116 @@ static void audio_driver_flush(
     * trying to do anything. Just leave the ratio as-is,
     * and hope for the best... */
 
-   audio_st->resampler->process(
-         audio_st->resampler_data, &src_data);
+   if (stats)
+      stage_start           = cpu_features_get_time_usec();
 
-#ifdef HAVE_AUDIOMIXER
-   if (audio_st->mixer_active)
+   while (pos < in_frames)
    {
-      bool override                       = true;
-      float mixer_gain                    = 0.0f;
-      bool audio_driver_mixer_mute_enable = audio_st->mixer_mute_enable;
+      struct resampler_data src_data;
+      size_t block_frames    = MIN(in_frames - pos,
+            AUDIO_FLUSH_BLOCK_FRAMES);
+      float *block_out       = audio_st->output_samples_buf
+         + out_frames * 2;
+
+      /* Volume is applied as part of the conversion,
+       * muted audio needs no conversion at all */
+      if (audio_volume_gain == 0.0f)
+         memset(audio_st->input_data, 0,
+               block_frames * 2 * sizeof(float));
+      else
+         convert_s16_to_float(audio_st->input_data, data + pos * 2,
+               block_frames * 2, audio_volume_gain);
+
+      src_data.data_in       = audio_st->input_data;
+      src_data.input_frames  = block_frames;
+
+      if (stats)
+         audio_driver_flush_stage_end(audio_st,
+               AUDIO_FLUSH_STAGE_CONVERT, &stage_start);
 
-      if (!audio_driver_mixer_mute_enable)
+#ifdef HAVE_DSP_FILTER
+      if (audio_st->dsp)
       {
-         if (audio_st->mixer_volume_gain == 1.0f)
-            override                      = false;
-         mixer_gain                       = audio_st->mixer_volume_gain;
-            
+         struct retro_dsp_data dsp_data;
+
+         dsp_data.input         = audio_st->input_data;
+         dsp_data.input_frames  = (unsigned)block_frames;
+         dsp_data.output        = NULL;
+         dsp_data.output_frames = 0;
+
+         retro_dsp_filter_process(audio_st->dsp, &dsp_data);
+
+         if (dsp_data.output)
+         {
+            src_data.data_in      = dsp_data.output;
+            src_data.input_frames = dsp_data.output_frames;
+         }
+
+         if (stats)
+            audio_driver_flush_stage_end(audio_st,
+                  AUDIO_FLUSH_STAGE_DSP, &stage_start);
       }
-      audio_mixer_mix(audio_st->output_samples_buf,
-            src_data.output_frames, mixer_gain, override);
-   }
 #endif
 
-   {
-      const void *output_data = audio_st->output_samples_buf;
-      unsigned output_frames  = (unsigned)src_data.output_frames;
+      src_data.data_out      = block_out;
+      src_data.output_frames = 0;
+      src_data.ratio         = ratio;
 
-      if (audio_st->use_float)
-         output_frames       *= sizeof(float);
-      else
+      audio_st->resampler->process(
+            audio_st->resampler_data, &src_data);
+
+      if (stats)
+         audio_driver_flush_stage_end(audio_st,
+               AUDIO_FLUSH_STAGE_RESAMPLE, &stage_start);
+
+#ifdef HAVE_AUDIOMIXER
+      if (audio_st->mixer_active)
       {
-         convert_float_to_s16(audio_st->output_samples_conv_buf,
-               (const float*)output_data, output_frames * 2);
+         audio_mixer_mix(block_out, src_data.output_frames,
+               mixer_gain, mixer_override);
 
-         output_data          = audio_st->output_samples_conv_buf;
-         output_frames       *= sizeof(int16_t);
+         if (stats)
+            audio_driver_flush_stage_end(audio_st,
+                  AUDIO_FLUSH_STAGE_MIXER, &stage_start);
       }
+#endif
 
+      if (!audio_st->use_float)
+      {
+         convert_float_to_s16(
+               audio_st->output_samples_conv_buf + out_frames * 2,
+               block_out, src_data.output_frames * 2);
+
+         if (stats)
+            audio_driver_flush_stage_end(audio_st,
+                  AUDIO_FLUSH_STAGE_OUTPUT, &stage_start);
+      }
+
+      out_frames            += src_data.output_frames;
+      pos                   += block_frames;
+   }
+
+   if (audio_st->use_float)
       audio_st->current_audio->write(audio_st->context_audio_data,
-            output_data, output_frames * 2);
+            audio_st->output_samples_buf,
+            out_frames * 2 * sizeof(float));
+   else
+      audio_st->current_audio->write(audio_st->context_audio_data,
+            audio_st->output_samples_conv_buf,
+            out_frames * 2 * sizeof(int16_t));
+
+   if (stats)
+   {
+      audio_driver_flush_stage_end(audio_st,
+            AUDIO_FLUSH_STAGE_WRITE, &stage_start);
+
+      audio_st->flush_stats_frames  += in_frames;
+      if (audio_st->flush_stats_frames >= AUDIO_FLUSH_STATS_FRAMES)
+         audio_driver_flush_stats_log(audio_st);
    }
+
+   frame_profiler_end(FRAME_PROFILER_THREAD_MAIN,
+         FRAME_PROFILER_STAGE_AUDIO_FLUSH);
 }
 
 #ifdef HAVE_AUDIOMIXER
@@ -44,8 +44,29 @@
 
 #define AUDIO_BUFFER_FREE_SAMPLES_COUNT (8 * 1024)
 
+/* audio_driver_flush() runs every stage on this many frames
+ * before moving on, so a block stays in cache from the
+ * conversion to the final output. */
+#define AUDIO_FLUSH_BLOCK_FRAMES 512
+
+/* With performance counters enabled, the time spent in each
+ * flush stage is logged after this many input frames. */
+#define AUDIO_FLUSH_STATS_FRAMES (48000 * 10)
+
 RETRO_BEGIN_DECLS
 
+enum audio_flush_stage
+{
+   AUDIO_FLUSH_STAGE_CONVERT = 0,
+   AUDIO_FLUSH_STAGE_DSP,
+   AUDIO_FLUSH_STAGE_RESAMPLE,
+   AUDIO_FLUSH_STAGE_MIXER,
+   AUDIO_FLUSH_STAGE_OUTPUT,
+   AUDIO_FLUSH_STAGE_WRITE,
+
+   AUDIO_FLUSH_STAGE_LAST
+};
+
 #ifdef HAVE_AUDIOMIXER
 typedef struct audio_mixer_stream
 {
@@ -165,6 +186,10 @@ typedef struct
 
    uint64_t free_samples_count;
 
+   /* Per-stage flush timings, see AUDIO_FLUSH_STATS_FRAMES */
+   retro_time_t flush_stage_usec[AUDIO_FLUSH_STAGE_LAST];
+   uint64_t flush_stats_frames;
+
    struct string_list *devices_list;
    float  *output_samples_buf;
 #ifdef HAVE_REWIND
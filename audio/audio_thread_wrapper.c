@@ -42,8 +42,10 @@ typedef struct audio_thread
    unsigned latency;
    unsigned block_frames;
 
-   bool alive;
-   bool stopped;
+   /* Also read without the lock by the audio thread, to skip
+    * taking it on every iteration while nothing changes. */
+   volatile bool alive;
+   volatile bool stopped;
    bool stopped_ack;
    bool is_paused;
    bool is_shutdown;
@@ -80,6 +82,15 @@ static void audio_thread_loop(void *data)
 
    for (;;)
    {
+      /* Only synchronize with the emulator thread when it
+       * asked for something, so the callback never has to
+       * wait for it to release the lock. */
+      if (thr->alive && !thr->stopped)
+      {
+         audio_driver_callback();
+         continue;
+      }
+
       slock_lock(thr->lock);
 
       if (!thr->alive)
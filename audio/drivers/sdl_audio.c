@@ -24,7 +24,7 @@
 
 #include <boolean.h>
 #include <rthreads/rthreads.h>
-#include <queues/fifo_queue.h>
+#include <queues/spsc_queue.h>
 #include <retro_inline.h>
 #include <retro_math.h>
 
@@ -39,8 +39,11 @@ typedef struct sdl_audio
 #ifdef HAVE_THREADS
    slock_t *lock;
    scond_t *cond;
+   int64_t period_usec;
 #endif
-   fifo_buffer_t *buffer;
+   /* The callback reads from this without taking the SDL
+    * audio lock, so it never waits on the emulator thread. */
+   spsc_queue_t *buffer;
    bool nonblock;
    bool is_paused;
 } sdl_audio_t;
@@ -48,10 +51,8 @@ typedef struct sdl_audio
 static void sdl_audio_cb(void *data, Uint8 *stream, int len)
 {
    sdl_audio_t  *sdl = (sdl_audio_t*)data;
-   size_t      avail = FIFO_READ_AVAIL(sdl->buffer);
-   size_t write_size = len > (int)avail ? avail : len;
+   size_t write_size = spsc_queue_read(sdl->buffer, stream, len);
 
-   fifo_read(sdl->buffer, stream, write_size);
 #ifdef HAVE_THREADS
    scond_signal(sdl->cond);
 #endif
@@ -124,6 +125,7 @@ static void *sdl_audio_init(const char *device,
 #ifdef HAVE_THREADS
    sdl->lock                = slock_new();
    sdl->cond                = scond_new();
+   sdl->period_usec         = (int64_t)out.samples * 1000000 / out.freq;
 #endif
 
    RARCH_LOG("[SDL audio]: Requested %u ms latency, got %d ms\n",
@@ -132,11 +134,11 @@ static void *sdl_audio_init(const char *device,
    /* Create a buffer twice as big as needed and prefill the buffer. */
    bufsize     = out.samples * 4 * sizeof(int16_t);
    tmp         = calloc(1, bufsize);
-   sdl->buffer = fifo_new(bufsize);
+   sdl->buffer = spsc_queue_new(bufsize);
 
    if (tmp)
    {
-      fifo_write(sdl->buffer, tmp, bufsize);
+      spsc_queue_write(sdl->buffer, tmp, bufsize);
       free(tmp);
    }
 
@@ -154,43 +156,30 @@ static ssize_t sdl_audio_write(void *data, const void *buf, size_t size)
    sdl_audio_t *sdl = (sdl_audio_t*)data;
 
    if (sdl->nonblock)
-   {
-      size_t avail, write_amt;
-
-      SDL_LockAudio();
-      avail = FIFO_WRITE_AVAIL(sdl->buffer);
-      write_amt = avail > size ? size : avail;
-      fifo_write(sdl->buffer, buf, write_amt);
-      SDL_UnlockAudio();
-      ret = write_amt;
-   }
+      ret = spsc_queue_write(sdl->buffer, buf, size);
    else
    {
       size_t written = 0;
 
       while (written < size)
       {
-         size_t avail;
+         size_t write_amt = spsc_queue_write(sdl->buffer,
+               (const char*)buf + written, size - written);
 
-         SDL_LockAudio();
-         avail = FIFO_WRITE_AVAIL(sdl->buffer);
-
-         if (avail == 0)
-         {
-            SDL_UnlockAudio();
+         if (write_amt)
+            written += write_amt;
 #ifdef HAVE_THREADS
-            slock_lock(sdl->lock);
-            scond_wait(sdl->cond, sdl->lock);
-            slock_unlock(sdl->lock);
-#endif
-         }
          else
          {
-            size_t write_amt = size - written > avail ? avail : size - written;
-            fifo_write(sdl->buffer, (const char*)buf + written, write_amt);
-            SDL_UnlockAudio();
-            written += write_amt;
+            /* The callback signals without the lock, so a wakeup
+             * can be missed; don't sleep past the next callback. */
+            slock_lock(sdl->lock);
+            if (!spsc_queue_write_avail(sdl->buffer))
+               scond_wait_timeout(sdl->cond, sdl->lock,
+                     sdl->period_usec);
+            slock_unlock(sdl->lock);
          }
+#endif
       }
       ret = written;
    }
@@ -238,7 +227,7 @@ static void sdl_audio_free(void *data)
 
    if (sdl)
    {
-      fifo_free(sdl->buffer);
+      spsc_queue_free(sdl->buffer);
 #ifdef HAVE_THREADS
       slock_free(sdl->lock);
       scond_free(sdl->cond);
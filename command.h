@@ -258,7 +258,9 @@ enum event_command
    CMD_EVENT_CHEAT_TOGGLE,
    CMD_EVENT_AI_SERVICE_CALL,
    CMD_EVENT_SAVE_FILES,
-   CMD_EVENT_CONTROLLER_INIT
+   CMD_EVENT_CONTROLLER_INIT,
+   /* Writes the frame profiler trace to the log directory. */
+   CMD_EVENT_FRAME_PROFILER_EXPORT
 };
 
 typedef struct command_handle
@@ -228,6 +228,10 @@
  * specific monitors, 1 being the first monitor. */
 #define DEFAULT_MONITOR_INDEX 0
 
+/* Threads running the CPU video filter.
+ * 0 uses one thread per CPU core. */
+#define DEFAULT_VIDEO_FILTER_THREADS 0
+
 /* Window */
 
 /* DEFAULT_WINDOW_DECORATIONS:
@@ -447,6 +451,10 @@
 
 #define DEFAULT_SHADER_DELAY 0
 
+/* Disk space for compiled slang shaders, in MB.
+ * 0 disables the shader cache. */
+#define DEFAULT_VIDEO_SHADER_CACHE_SIZE 64
+
 /* Only scale in integer steps.
  * The base size depends on system-reported geometry and aspect ratio.
  * If video_force_aspect is not set, X/Y will be integer scaled independently.
@@ -916,6 +924,16 @@ static const float message_bgcolor_opacity = 1.0f;
 /* Screenshots post-shaded GPU output if available. */
 #define DEFAULT_GPU_SCREENSHOT true
 
+/* Compare every software frame with the previous one, so that
+ * drivers only update what changed and recording skips
+ * frames that did not change. */
+#define DEFAULT_VIDEO_FRAME_DIFF false
+
+/* Stream software frames through a ring of pixel buffers
+ * in the gl and glcore drivers. Never used on software
+ * rasterizers. */
+#define DEFAULT_VIDEO_UPLOAD_RING false
+
 /* Watch shader files for changes and auto-apply as necessary. */
 #define DEFAULT_VIDEO_SHADER_WATCH_FILES false
 
@@ -1164,6 +1182,20 @@ static const bool audio_enable_menu_bgm    = false;
 /* How many frames to rewind at a time. */
 #define DEFAULT_REWIND_GRANULARITY 1
 #endif
+
+/* Number of worker threads used to compress rewind deltas.
+ * 0 compresses synchronously on the main thread. Large
+ * savestates are split into one stripe per thread. */
+#define DEFAULT_REWIND_COMPRESSION_THREADS 0
+
+/* Size of the compressed rewind tier. Deltas that no longer
+ * fit in the rewind buffer are recompressed and kept here
+ * instead of being dropped. 0 disables it. */
+#define DEFAULT_REWIND_COLD_BUFFER_SIZE 0
+
+/* Size of the memory-mapped file in the cache directory that
+ * takes the oldest compressed rewind blocks. 0 disables it. */
+#define DEFAULT_REWIND_SPILL_SIZE 0
 /* Pause gameplay when gameplay loses focus. */
 #if defined(EMSCRIPTEN)
 #define DEFAULT_PAUSE_NONACTIVE false
@@ -1287,9 +1319,23 @@ static const bool savestate_thumbnail_enable = false;
 /* When using the Run Ahead feature, use a secondary instance of the core. */
 #define DEFAULT_RUN_AHEAD_SECONDARY_INSTANCE true
 
+/* When using a secondary instance for Run Ahead, run it on its own
+ * thread so that it overlaps with the primary instance. */
+#define DEFAULT_RUN_AHEAD_SECONDARY_THREADED false
+
+/* When using the Run Ahead feature, only roll back and re-run
+ * frames when the input has changed. */
+#define DEFAULT_RUN_AHEAD_PREEMPTIVE_FRAMES false
+
 /* Hide warning messages when using the Run Ahead feature. */
 #define DEFAULT_RUN_AHEAD_HIDE_WARNINGS false
 
+/* Record per-frame timings of the core, video, audio and input. */
+#define DEFAULT_FRAME_PROFILER_ENABLE false
+
+/* Draw the recorded frame timings as a graph (needs widgets). */
+#define DEFAULT_FRAME_PROFILER_SHOW_GRAPH false
+
 /* Enable stdin/network command interface. */
 static const bool network_cmd_enable = false;
 static const uint16_t network_cmd_port = 55355;
@@ -1661,7 +1661,11 @@ static struct config_bool_setting *populate_settings_bool(
    SETTING_BOOL("apply_cheats_after_load",       &settings->bools.apply_cheats_after_load, true, DEFAULT_APPLY_CHEATS_AFTER_LOAD, false);
    SETTING_BOOL("run_ahead_enabled",             &settings->bools.run_ahead_enabled, true, false, false);
    SETTING_BOOL("run_ahead_secondary_instance",  &settings->bools.run_ahead_secondary_instance, true, DEFAULT_RUN_AHEAD_SECONDARY_INSTANCE, false);
+   SETTING_BOOL("run_ahead_secondary_threaded",  &settings->bools.run_ahead_secondary_threaded, true, DEFAULT_RUN_AHEAD_SECONDARY_THREADED, false);
+   SETTING_BOOL("run_ahead_preemptive_frames",   &settings->bools.run_ahead_preemptive_frames, true, DEFAULT_RUN_AHEAD_PREEMPTIVE_FRAMES, false);
    SETTING_BOOL("run_ahead_hide_warnings",       &settings->bools.run_ahead_hide_warnings, true, DEFAULT_RUN_AHEAD_HIDE_WARNINGS, false);
+   SETTING_BOOL("frame_profiler_enable",         &settings->bools.frame_profiler_enable, true, DEFAULT_FRAME_PROFILER_ENABLE, false);
+   SETTING_BOOL("frame_profiler_show_graph",     &settings->bools.frame_profiler_show_graph, true, DEFAULT_FRAME_PROFILER_SHOW_GRAPH, false);
    SETTING_BOOL("audio_sync",                    &settings->bools.audio_sync, true, DEFAULT_AUDIO_SYNC, false);
    SETTING_BOOL("video_shader_enable",           &settings->bools.video_shader_enable, true, DEFAULT_SHADER_ENABLE, false);
    SETTING_BOOL("video_shader_watch_files",      &settings->bools.video_shader_watch_files, true, DEFAULT_VIDEO_SHADER_WATCH_FILES, false);
@@ -1697,6 +1701,8 @@ static struct config_bool_setting *populate_settings_bool(
    SETTING_BOOL("video_disable_composition",     &settings->bools.video_disable_composition, true, DEFAULT_DISABLE_COMPOSITION, false);
    SETTING_BOOL("pause_nonactive",               &settings->bools.pause_nonactive, true, DEFAULT_PAUSE_NONACTIVE, false);
    SETTING_BOOL("video_gpu_screenshot",          &settings->bools.video_gpu_screenshot, true, DEFAULT_GPU_SCREENSHOT, false);
+   SETTING_BOOL("video_frame_diff",              &settings->bools.video_frame_diff, true, DEFAULT_VIDEO_FRAME_DIFF, false);
+   SETTING_BOOL("video_upload_ring",             &settings->bools.video_upload_ring, true, DEFAULT_VIDEO_UPLOAD_RING, false);
    SETTING_BOOL("video_post_filter_record",      &settings->bools.video_post_filter_record, true, DEFAULT_POST_FILTER_RECORD, false);
    SETTING_BOOL("video_notch_write_over_enable", &settings->bools.video_notch_write_over_enable, true, DEFAULT_NOTCH_WRITE_OVER_ENABLE, false);
    SETTING_BOOL("keyboard_gamepad_enable",       &settings->bools.input_keyboard_gamepad_enable, true, true, false);
@@ -2141,6 +2147,7 @@ static struct config_uint_setting *populate_settings_uint(
 #endif
    SETTING_UINT("rewind_granularity",           &settings->uints.rewind_granularity, true, DEFAULT_REWIND_GRANULARITY, false);
    SETTING_UINT("rewind_buffer_size_step",      &settings->uints.rewind_buffer_size_step, true, DEFAULT_REWIND_BUFFER_SIZE_STEP, false);
+   SETTING_UINT("rewind_compression_threads",   &settings->uints.rewind_compression_threads, true, DEFAULT_REWIND_COMPRESSION_THREADS, false);
    SETTING_UINT("autosave_interval",            &settings->uints.autosave_interval,  true, DEFAULT_AUTOSAVE_INTERVAL, false);
    SETTING_UINT("savestate_max_keep",           &settings->uints.savestate_max_keep, true, DEFAULT_SAVESTATE_MAX_KEEP, false);
    SETTING_UINT("frontend_log_level",           &settings->uints.frontend_log_level, true, DEFAULT_FRONTEND_LOG_LEVEL, false);
@@ -2148,6 +2155,7 @@ static struct config_uint_setting *populate_settings_uint(
    SETTING_UINT("keyboard_gamepad_mapping_type",&settings->uints.input_keyboard_gamepad_mapping_type, true, 1, false);
    SETTING_UINT("input_poll_type_behavior",     &settings->uints.input_poll_type_behavior, true, 2, false);
    SETTING_UINT("video_monitor_index",          &settings->uints.video_monitor_index, true, DEFAULT_MONITOR_INDEX, false);
+   SETTING_UINT("video_filter_threads",         &settings->uints.video_filter_threads, true, DEFAULT_VIDEO_FILTER_THREADS, false);
 #ifdef __WINRT__
    SETTING_UINT("video_fullscreen_x", &settings->uints.video_fullscreen_x, true, uwp_get_width(), false);
    SETTING_UINT("video_fullscreen_y", &settings->uints.video_fullscreen_y, true, uwp_get_height(), false);
@@ -2160,6 +2168,7 @@ static struct config_uint_setting *populate_settings_uint(
    SETTING_UINT("video_layout_selected_view",   &settings->uints.video_layout_selected_view, true, 0, false);
 #endif
    SETTING_UINT("video_shader_delay",           &settings->uints.video_shader_delay, true, DEFAULT_SHADER_DELAY, false);
+   SETTING_UINT("video_shader_cache_size",      &settings->uints.video_shader_cache_size, true, DEFAULT_VIDEO_SHADER_CACHE_SIZE, false);
 #ifdef HAVE_COMMAND
    SETTING_UINT("network_cmd_port",             &settings->uints.network_cmd_port,    true, network_cmd_port, false);
 #endif
@@ -2356,6 +2365,8 @@ static struct config_size_setting *populate_settings_size(
       return NULL;
 
    SETTING_SIZE("rewind_buffer_size",           &settings->sizes.rewind_buffer_size, true, DEFAULT_REWIND_BUFFER_SIZE, false);
+   SETTING_SIZE("rewind_cold_buffer_size",      &settings->sizes.rewind_cold_buffer_size, true, DEFAULT_REWIND_COLD_BUFFER_SIZE, false);
+   SETTING_SIZE("rewind_spill_size",            &settings->sizes.rewind_spill_size, true, DEFAULT_REWIND_SPILL_SIZE, false);
 
    *size = count;
 
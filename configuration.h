@@ -115,6 +115,8 @@ typedef struct settings
    {
       size_t placeholder;
       size_t rewind_buffer_size;
+      size_t rewind_cold_buffer_size;
+      size_t rewind_spill_size;
    } sizes;
 
    video_viewport_t video_viewport_custom; /* int alignment */
@@ -212,6 +214,7 @@ typedef struct settings
       unsigned libretro_log_level;
       unsigned rewind_granularity;
       unsigned rewind_buffer_size_step;
+      unsigned rewind_compression_threads;
       unsigned autosave_interval;
       unsigned savestate_max_keep;
       unsigned network_cmd_port;
@@ -222,6 +225,7 @@ typedef struct settings
       unsigned crt_switch_resolution_super;
       unsigned screen_brightness;
       unsigned video_monitor_index;
+      unsigned video_filter_threads;
       unsigned video_fullscreen_x;
       unsigned video_fullscreen_y;
       unsigned video_max_swapchain_images;
@@ -252,6 +256,7 @@ typedef struct settings
       unsigned video_overscan_correction_bottom;
 #endif
       unsigned video_shader_delay;
+      unsigned video_shader_cache_size;
 #ifdef HAVE_SCREENSHOTS
       unsigned notification_show_screenshot_duration;
       unsigned notification_show_screenshot_flash;
@@ -561,6 +566,8 @@ typedef struct settings
       bool video_post_filter_record;
       bool video_gpu_record;
       bool video_gpu_screenshot;
+      bool video_frame_diff;
+      bool video_upload_ring;
       bool video_allow_rotate;
       bool video_shared_context;
       bool video_force_srgb_disable;
@@ -858,7 +865,11 @@ typedef struct settings
       bool apply_cheats_after_load;
       bool run_ahead_enabled;
       bool run_ahead_secondary_instance;
+      bool run_ahead_secondary_threaded;
+      bool run_ahead_preemptive_frames;
       bool run_ahead_hide_warnings;
+      bool frame_profiler_enable;
+      bool frame_profiler_show_graph;
       bool pause_nonactive;
       bool block_sram_overwrite;
       bool savestate_auto_index;
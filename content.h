@@ -72,6 +72,43 @@ bool content_serialize_state(void* buffer, size_t buffer_size);
 /* Deserializes the current state. */
 bool content_deserialize_state(const void* serialized_data, size_t serialized_size);
 
+/* Pooled savestate buffers.
+ *
+ * Every buffer holds the serialized core data of the running core
+ * and has room around it for the RASTATE header and end block, plus
+ * the tail padding state_manager_raw_compress() needs. Callers get a
+ * pointer to the core data, which core_serialize()/core_unserialize()
+ * can target directly. Since all buffers share the same layout,
+ * run-ahead, rewind and netplay can hand them to each other instead
+ * of copying. Not thread-safe; main thread only. */
+
+/* (Re)sizes the pool for core states of 'size' bytes. Buffers of
+ * a previous size are freed as they are returned. */
+bool content_state_pool_init(size_t size);
+
+void content_state_pool_deinit(void);
+
+/* Returns the core state size the pool is set up for. */
+size_t content_state_pool_get_size(void);
+
+/* Returns a buffer for core_serialize(), or NULL on failure. */
+void *content_state_pool_get(void);
+
+void content_state_pool_put(void *data);
+
+/* Returns the size of a RASTATE image of a pooled buffer,
+ * or 0 if the current state needs blocks a pooled buffer
+ * has no room for (e.g. achievements). */
+size_t content_state_pool_get_rastate_size(void);
+
+/* Wraps the RASTATE header and end block around the core data
+ * in pooled buffer 'data', in place. Returns the start of the
+ * image, which content_deserialize_state() accepts. */
+void *content_state_pool_to_rastate(void *data);
+
+/* Inverse of content_state_pool_to_rastate(). */
+void *content_state_pool_from_rastate(void *rastate);
+
 /* Waits for any in-progress save state tasks to finish */
 void content_wait_for_save_state_task(void);
 
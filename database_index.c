@@ -0,0 +1,354 @@
+/*  RetroArch - A frontend for libretro.
+ *  Copyright (C) 2011-2017 - Daniel De Matteis
+ *  Copyright (C) 2016-2019 - Brad Parker
+ *
+ *  RetroArch is free software: you can redistribute it and/or modify it under the terms
+ *  of the GNU General Public License as published by the Free Software Found-
+ *  ation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  RetroArch is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ *  without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ *  PURPOSE.  See the GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along with RetroArch.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include <retro_endianness.h>
+#include <string/stdstring.h>
+
+#include "libretro-db/libretrodb.h"
+
+#include "database_index.h"
+
+/* A slot is 12 bytes: record offsets are kept in 32 bits, which
+ * no .rdb comes near. A database that does not fit fails to load
+ * and the scanner queries it the old way. */
+typedef struct
+{
+   uint32_t key;    /* CRC32, or hash of the serial */
+   uint32_t offset;
+   uint32_t db;     /* database ID + 1, 0 for an empty slot */
+} database_index_slot_t;
+
+/* Open addressing with linear probing, at most half full. Records
+ * with the same key (the same ROM in several databases) take
+ * consecutive slots. */
+typedef struct
+{
+   database_index_slot_t *slots;
+   size_t mask;
+   size_t count;
+} database_index_table_t;
+
+typedef struct
+{
+   char *path;
+   uint32_t hash;
+   bool loaded;
+} database_index_db_t;
+
+struct database_index
+{
+   database_index_table_t crc;
+   database_index_table_t serial;
+   database_index_db_t *dbs;
+   size_t records;
+   unsigned count;
+   unsigned capacity;
+};
+
+/* FNV-1a */
+static uint32_t database_index_hash(const char *s, size_t len)
+{
+   size_t i;
+   uint32_t h = 2166136261u;
+   for (i = 0; i < len; i++)
+   {
+      h ^= (uint8_t)s[i];
+      h *= 16777619u;
+   }
+   return h;
+}
+
+/* Keys are CRCs or hashes already; this only spreads
+ * synthetic ones that differ in a few bits */
+static size_t database_index_slot(uint32_t key, size_t mask)
+{
+   key ^= key >> 16;
+   key *= 0x85ebca6bu;
+   key ^= key >> 13;
+   return key & mask;
+}
+
+static void database_index_table_put(database_index_table_t *table,
+      uint32_t key, uint32_t offset, uint32_t db)
+{
+   size_t i = database_index_slot(key, table->mask);
+
+   while (table->slots[i].db)
+      i = (i + 1) & table->mask;
+
+   table->slots[i].key    = key;
+   table->slots[i].offset = offset;
+   table->slots[i].db     = db;
+   table->count++;
+}
+
+static bool database_index_table_add(database_index_table_t *table,
+      uint32_t key, uint32_t offset, uint32_t db)
+{
+   if ((table->count + 1) * 2 > table->mask + 1 || !table->slots)
+   {
+      size_t i;
+      database_index_table_t grown;
+      size_t size  = table->slots ? (table->mask + 1) * 2 : 1024;
+
+      grown.slots  = (database_index_slot_t*)
+         calloc(size, sizeof(*grown.slots));
+      grown.mask   = size - 1;
+      grown.count  = 0;
+
+      if (!grown.slots)
+         return false;
+
+      if (table->slots)
+      {
+         for (i = 0; i <= table->mask; i++)
+            if (table->slots[i].db)
+               database_index_table_put(&grown, table->slots[i].key,
+                     table->slots[i].offset, table->slots[i].db);
+         free(table->slots);
+      }
+
+      *table = grown;
+   }
+
+   database_index_table_put(table, key, offset, db);
+   return true;
+}
+
+static size_t database_index_table_find(
+      const database_index_table_t *table,
+      uint32_t key, uint32_t db, uint64_t *offsets, size_t max)
+{
+   size_t i;
+   size_t n = 0;
+
+   if (!table->slots)
+      return 0;
+
+   for (i = database_index_slot(key, table->mask);
+         table->slots[i].db && n < max;
+         i = (i + 1) & table->mask)
+   {
+      if (table->slots[i].key == key && table->slots[i].db == db)
+         offsets[n++] = table->slots[i].offset;
+   }
+
+   return n;
+}
+
+static uint32_t database_index_crc(const struct rmsgpack_dom_value *val)
+{
+   if (val->type != RDT_BINARY)
+      return 0;
+
+   switch (val->val.binary.len)
+   {
+      case 1:
+         return *(uint8_t*)val->val.binary.buff;
+      case 2:
+         return swap_if_little16(*(uint16_t*)val->val.binary.buff);
+      case 4:
+         return swap_if_little32(*(uint32_t*)val->val.binary.buff);
+      default:
+         break;
+   }
+
+   return 0;
+}
+
+static bool database_index_read(database_index_t *index,
+      const char *rdb_path, uint32_t id)
+{
+   struct rmsgpack_dom_value item;
+   bool ret                 = false;
+   libretrodb_t *db         = libretrodb_new();
+   libretrodb_cursor_t *cur = libretrodb_cursor_new();
+
+   if (!db || !cur)
+      goto end;
+
+   if (libretrodb_open(rdb_path, db) != 0)
+      goto end;
+
+   if (libretrodb_cursor_open(db, cur, NULL) != 0)
+   {
+      libretrodb_close(db);
+      goto end;
+   }
+
+   for (;;)
+   {
+      unsigned i;
+      int64_t offset = libretrodb_cursor_tell(cur);
+
+      if (offset < 0 || offset > (int64_t)UINT32_MAX)
+         break;
+
+      if (libretrodb_cursor_read_item(cur, &item) != 0)
+      {
+         ret = true;
+         break;
+      }
+
+      if (item.type == RDT_MAP)
+      {
+         for (i = 0; i < item.val.map.len; i++)
+         {
+            const struct rmsgpack_dom_value *key =
+               &item.val.map.items[i].key;
+            const struct rmsgpack_dom_value *val =
+               &item.val.map.items[i].value;
+            bool added                           = true;
+
+            if (key->type != RDT_STRING)
+               continue;
+
+            if (string_is_equal(key->val.string.buff, "crc"))
+            {
+               uint32_t crc = database_index_crc(val);
+               if (crc)
+                  added = database_index_table_add(&index->crc,
+                        crc, (uint32_t)offset, id + 1);
+            }
+            else if (string_is_equal(key->val.string.buff, "serial"))
+            {
+               if (     (val->type == RDT_STRING || val->type == RDT_BINARY)
+                     && val->val.string.len)
+                  added = database_index_table_add(&index->serial,
+                        database_index_hash(val->val.string.buff,
+                           val->val.string.len),
+                        (uint32_t)offset, id + 1);
+            }
+
+            if (!added)
+               break;
+         }
+
+         /* Out of memory */
+         if (i < item.val.map.len)
+         {
+            rmsgpack_dom_value_free(&item);
+            break;
+         }
+
+         index->records++;
+      }
+
+      rmsgpack_dom_value_free(&item);
+   }
+
+   libretrodb_cursor_close(cur);
+   libretrodb_close(db);
+
+end:
+   if (cur)
+      libretrodb_cursor_free(cur);
+   if (db)
+      libretrodb_free(db);
+   return ret;
+}
+
+database_index_t *database_index_new(void)
+{
+   return (database_index_t*)calloc(1, sizeof(database_index_t));
+}
+
+void database_index_free(database_index_t *index)
+{
+   unsigned i;
+
+   if (!index)
+      return;
+
+   for (i = 0; i < index->count; i++)
+      free(index->dbs[i].path);
+
+   free(index->dbs);
+   free(index->crc.slots);
+   free(index->serial.slots);
+   free(index);
+}
+
+int database_index_load(database_index_t *index, const char *rdb_path)
+{
+   unsigned i;
+   database_index_db_t *entry = NULL;
+   uint32_t hash              = database_index_hash(rdb_path,
+         strlen(rdb_path));
+
+   for (i = 0; i < index->count; i++)
+   {
+      if (     index->dbs[i].hash == hash
+            && string_is_equal(index->dbs[i].path, rdb_path))
+         return index->dbs[i].loaded ? (int)i : -1;
+   }
+
+   if (index->count == index->capacity)
+   {
+      unsigned capacity        = index->capacity ? index->capacity * 2 : 32;
+      database_index_db_t *dbs = (database_index_db_t*)
+         realloc(index->dbs, capacity * sizeof(*dbs));
+
+      if (!dbs)
+         return -1;
+
+      index->dbs      = dbs;
+      index->capacity = capacity;
+   }
+
+   entry         = &index->dbs[index->count];
+   entry->path   = strdup(rdb_path);
+   entry->hash   = hash;
+   entry->loaded = false;
+
+   if (!entry->path)
+      return -1;
+
+   index->count++;
+
+   entry->loaded = database_index_read(index, rdb_path, i);
+
+   return entry->loaded ? (int)i : -1;
+}
+
+size_t database_index_find_crc(const database_index_t *index, int db,
+      uint32_t crc, uint64_t *offsets, size_t max)
+{
+   if (db < 0 || !crc)
+      return 0;
+   return database_index_table_find(&index->crc, crc,
+         (uint32_t)db + 1, offsets, max);
+}
+
+size_t database_index_find_serial(const database_index_t *index, int db,
+      const char *serial, uint64_t *offsets, size_t max)
+{
+   size_t len = strlen(serial);
+
+   if (db < 0 || !len)
+      return 0;
+   return database_index_table_find(&index->serial,
+         database_index_hash(serial, len),
+         (uint32_t)db + 1, offsets, max);
+}
+
+size_t database_index_records(const database_index_t *index)
+{
+   return index->records;
+}
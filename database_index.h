@@ -0,0 +1,90 @@
+/*  RetroArch - A frontend for libretro.
+ *  Copyright (C) 2011-2017 - Daniel De Matteis
+ *  Copyright (C) 2016-2019 - Brad Parker
+ *
+ *  RetroArch is free software: you can redistribute it and/or modify it under the terms
+ *  of the GNU General Public License as published by the Free Software Found-
+ *  ation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  RetroArch is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ *  without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ *  PURPOSE.  See the GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along with RetroArch.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef DATABASE_INDEX_H_
+#define DATABASE_INDEX_H_
+
+#include <stdint.h>
+#include <stddef.h>
+
+#include <boolean.h>
+#include <retro_common_api.h>
+
+RETRO_BEGIN_DECLS
+
+/* Records of one database a single lookup returns, at most */
+#define DATABASE_INDEX_MAX_MATCHES 32
+
+/* Index of the records of any number of .rdb files by CRC32 and
+ * by serial. Each database is read through once when it is first
+ * loaded; lookups only return the offsets of the records in their
+ * file, to be read in full with database_info_list_new_offsets(). */
+typedef struct database_index database_index_t;
+
+database_index_t *database_index_new(void);
+
+void database_index_free(database_index_t *index);
+
+/**
+ * database_index_load:
+ * @index                : index.
+ * @rdb_path             : path of a .rdb file.
+ *
+ * Adds the records of @rdb_path to @index, unless an earlier call
+ * already did.
+ *
+ * Returns: ID of the database for the lookups, or -1 if it could
+ * not be read (which is not retried).
+ **/
+int database_index_load(database_index_t *index, const char *rdb_path);
+
+/**
+ * database_index_find_crc:
+ * @index                : index.
+ * @db                   : database ID from database_index_load().
+ * @crc                  : CRC32 to look for.
+ * @offsets              : offsets of the matching records are
+ *                         stored here.
+ * @max                  : room in @offsets.
+ *
+ * Returns: number of offsets stored, in no particular order.
+ **/
+size_t database_index_find_crc(const database_index_t *index, int db,
+      uint32_t crc, uint64_t *offsets, size_t max);
+
+/**
+ * database_index_find_serial:
+ * @index                : index.
+ * @db                   : database ID from database_index_load().
+ * @serial               : serial to look for.
+ * @offsets              : offsets of the records that may match are
+ *                         stored here.
+ * @max                  : room in @offsets.
+ *
+ * Serials are indexed by hash, so the records have to be compared
+ * with @serial once read.
+ *
+ * Returns: number of offsets stored, in no particular order.
+ **/
+size_t database_index_find_serial(const database_index_t *index, int db,
+      const char *serial, uint64_t *offsets, size_t max);
+
+/* Number of records indexed in all databases */
+size_t database_index_records(const database_index_t *index);
+
+RETRO_END_DECLS
+
+#endif
@@ -675,6 +675,60 @@ end:
    return database_info_list;
 }
 
+database_info_list_t *database_info_list_new_offsets(
+      const char *rdb_path, const uint64_t *offsets, size_t count)
+{
+   size_t i;
+   libretrodb_t *db                         = NULL;
+   libretrodb_cursor_t *cur                 = NULL;
+   database_info_list_t *database_info_list = (database_info_list_t*)
+      malloc(sizeof(*database_info_list));
+
+   if (!database_info_list)
+      return NULL;
+
+   database_info_list->count  = 0;
+   database_info_list->list   = NULL;
+
+   /* Nothing to read, no need to open the database */
+   if (!count)
+      return database_info_list;
+
+   db                         = libretrodb_new();
+   cur                        = libretrodb_cursor_new();
+   database_info_list->list   = (database_info_t*)
+      calloc(count, sizeof(database_info_t));
+
+   if (!db || !cur || !database_info_list->list)
+      goto end;
+
+   if ((database_cursor_open(db, cur, rdb_path, NULL) != 0))
+      goto end;
+
+   for (i = 0; i < count; i++)
+   {
+      database_info_t *db_info =
+         &database_info_list->list[database_info_list->count];
+
+      if (libretrodb_cursor_seek(cur, offsets[i]) != 0)
+         continue;
+
+      if (database_cursor_iterate(cur, db_info) == 0)
+         database_info_list->count++;
+   }
+
+end:
+   if (db)
+   {
+      database_cursor_close(db, cur);
+      libretrodb_free(db);
+   }
+   if (cur)
+      libretrodb_cursor_free(cur);
+
+   return database_info_list;
+}
+
 void database_info_list_free(database_info_list_t *database_info_list)
 {
    size_t i;
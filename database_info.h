@@ -139,6 +139,11 @@ typedef struct
 database_info_list_t *database_info_list_new(const char *rdb_path,
       const char *query);
 
+/* Reads the records at @offsets of @rdb_path, such as
+ * database_index_find_crc() returns, in that order */
+database_info_list_t *database_info_list_new_offsets(const char *rdb_path,
+      const uint64_t *offsets, size_t count);
+
 void database_info_list_free(database_info_list_t *list);
 
 database_info_handle_t *database_info_dir_init(const char *dir,
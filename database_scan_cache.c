@@ -0,0 +1,627 @@
+/*  RetroArch - A frontend for libretro.
+ *  Copyright (C) 2011-2017 - Daniel De Matteis
+ *  Copyright (C) 2016-2019 - Brad Parker
+ *
+ *  RetroArch is free software: you can redistribute it and/or modify it under the terms
+ *  of the GNU General Public License as published by the Free Software Found-
+ *  ation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  RetroArch is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ *  without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ *  PURPOSE.  See the GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along with RetroArch.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include <compat/strl.h>
+#include <encodings/crc32.h>
+#include <file/file_path.h>
+#include <streams/file_stream.h>
+#include <string/stdstring.h>
+
+#include "database_scan_cache.h"
+
+/* Bump when the layout of the entries changes, or when the
+ * scanner would probe the same file differently */
+#define DATABASE_SCAN_CACHE_VERSION 1
+
+/* The whole cache is a single file:
+ *
+ *    "RADS", version, database signature, entry count,
+ *    payload size, payload CRC32
+ *    payload, per entry: size, mtime, crc, archive_crc, type,
+ *    path, serial, db_path, label, db_crc
+ *
+ * Strings are a length and their bytes, 0xffffffff for NULL.
+ * Integers are in native byte order, the cache never leaves the
+ * machine that wrote it. */
+struct database_scan_cache_header
+{
+   char magic[4];
+   uint32_t version;
+   uint32_t db_signature;
+   uint32_t count;
+   uint32_t payload_size;
+   uint32_t payload_crc;
+};
+
+#define DATABASE_SCAN_CACHE_NULL 0xffffffffu
+
+struct database_scan_cache
+{
+   database_scan_cache_entry_t *entries;
+   uint32_t *slots;       /* entry + 1, 0 for an empty slot */
+   size_t mask;
+   size_t count;
+   size_t capacity;
+   uint32_t db_signature;
+};
+
+typedef struct
+{
+   uint8_t *data;
+   size_t size;
+   size_t capacity;
+   bool failed;
+} database_scan_cache_buf_t;
+
+/* FNV-1a, as database_index */
+static uint32_t database_scan_cache_hash(const char *s)
+{
+   uint32_t h = 2166136261u;
+   while (*s)
+   {
+      h ^= (uint8_t)*s++;
+      h *= 16777619u;
+   }
+   return h;
+}
+
+static void database_scan_cache_entry_free(
+      database_scan_cache_entry_t *entry)
+{
+   free(entry->path);
+   free(entry->serial);
+   free(entry->db_path);
+   free(entry->label);
+   free(entry->db_crc);
+}
+
+static void database_scan_cache_clear_match(
+      database_scan_cache_entry_t *entry)
+{
+   free(entry->db_path);
+   free(entry->label);
+   free(entry->db_crc);
+   entry->db_path = NULL;
+   entry->label   = NULL;
+   entry->db_crc  = NULL;
+}
+
+/* Slot of @path, or the empty one it would go in */
+static size_t database_scan_cache_slot(
+      const database_scan_cache_t *cache,
+      const char *path, uint32_t hash)
+{
+   size_t i = hash & cache->mask;
+
+   while (cache->slots[i])
+   {
+      const database_scan_cache_entry_t *entry =
+         &cache->entries[cache->slots[i] - 1];
+      if (entry->hash == hash && string_is_equal(entry->path, path))
+         break;
+      i = (i + 1) & cache->mask;
+   }
+
+   return i;
+}
+
+/* Keeps the slots at most half full */
+static bool database_scan_cache_reserve(database_scan_cache_t *cache,
+      size_t count)
+{
+   if (count > cache->capacity)
+   {
+      size_t capacity = cache->capacity ? cache->capacity * 2 : 256;
+      database_scan_cache_entry_t *entries;
+
+      while (capacity < count)
+         capacity *= 2;
+
+      if (!(entries = (database_scan_cache_entry_t*)realloc(
+                  cache->entries, capacity * sizeof(*entries))))
+         return false;
+
+      cache->entries  = entries;
+      cache->capacity = capacity;
+   }
+
+   if (count * 2 > cache->mask + 1)
+   {
+      size_t i;
+      size_t size     = (cache->mask + 1) * 2;
+      uint32_t *slots = NULL;
+
+      while (count * 2 > size)
+         size *= 2;
+
+      if (!(slots = (uint32_t*)calloc(size, sizeof(*slots))))
+         return false;
+
+      free(cache->slots);
+      cache->slots = slots;
+      cache->mask  = size - 1;
+
+      for (i = 0; i < cache->count; i++)
+         cache->slots[database_scan_cache_slot(cache,
+               cache->entries[i].path, cache->entries[i].hash)] =
+            (uint32_t)i + 1;
+   }
+
+   return true;
+}
+
+static database_scan_cache_t *database_scan_cache_new(
+      uint32_t db_signature)
+{
+   database_scan_cache_t *cache = (database_scan_cache_t*)
+      calloc(1, sizeof(*cache));
+
+   if (!cache)
+      return NULL;
+
+   cache->db_signature = db_signature;
+   cache->mask         = 1023;
+
+   if (!(cache->slots = (uint32_t*)calloc(cache->mask + 1,
+               sizeof(*cache->slots))))
+   {
+      free(cache);
+      return NULL;
+   }
+
+   return cache;
+}
+
+void database_scan_cache_free(database_scan_cache_t *cache)
+{
+   size_t i;
+
+   if (!cache)
+      return;
+
+   for (i = 0; i < cache->count; i++)
+      database_scan_cache_entry_free(&cache->entries[i]);
+
+   free(cache->entries);
+   free(cache->slots);
+   free(cache);
+}
+
+static bool database_scan_cache_get(const uint8_t **p, const uint8_t *end,
+      void *data, size_t len)
+{
+   if ((size_t)(end - *p) < len)
+      return false;
+   memcpy(data, *p, len);
+   *p += len;
+   return true;
+}
+
+static bool database_scan_cache_get_string(const uint8_t **p,
+      const uint8_t *end, char **s)
+{
+   uint32_t len;
+
+   *s = NULL;
+
+   if (!database_scan_cache_get(p, end, &len, sizeof(len)))
+      return false;
+   if (len == DATABASE_SCAN_CACHE_NULL)
+      return true;
+   if ((size_t)(end - *p) < len || !(*s = (char*)malloc(len + 1)))
+      return false;
+
+   memcpy(*s, *p, len);
+   (*s)[len] = '\0';
+   *p       += len;
+   return true;
+}
+
+static bool database_scan_cache_read(database_scan_cache_t *cache,
+      const uint8_t *data, size_t len)
+{
+   uint32_t i;
+   struct database_scan_cache_header header;
+   const uint8_t *p   = data + sizeof(header);
+   const uint8_t *end = data + len;
+   bool matches       = false;
+
+   if (len < sizeof(header))
+      return false;
+
+   memcpy(&header, data, sizeof(header));
+
+   if (     memcmp(header.magic, "RADS", 4) != 0
+         || header.version != DATABASE_SCAN_CACHE_VERSION
+         || header.payload_size != len - sizeof(header)
+         || encoding_crc32(0, p, header.payload_size)
+            != header.payload_crc)
+      return false;
+
+   /* The playlist entries came from other databases */
+   matches = header.db_signature == cache->db_signature;
+
+   if (!database_scan_cache_reserve(cache, header.count))
+      return false;
+
+   for (i = 0; i < header.count; i++)
+   {
+      size_t slot;
+      uint8_t type;
+      database_scan_cache_entry_t *entry = &cache->entries[cache->count];
+
+      memset(entry, 0, sizeof(*entry));
+
+      if (     !database_scan_cache_get(&p, end, &entry->size, sizeof(entry->size))
+            || !database_scan_cache_get(&p, end, &entry->mtime, sizeof(entry->mtime))
+            || !database_scan_cache_get(&p, end, &entry->crc, sizeof(entry->crc))
+            || !database_scan_cache_get(&p, end, &entry->archive_crc, sizeof(entry->archive_crc))
+            || !database_scan_cache_get(&p, end, &type, sizeof(type))
+            || !database_scan_cache_get_string(&p, end, &entry->path)
+            || !database_scan_cache_get_string(&p, end, &entry->serial)
+            || !database_scan_cache_get_string(&p, end, &entry->db_path)
+            || !database_scan_cache_get_string(&p, end, &entry->label)
+            || !database_scan_cache_get_string(&p, end, &entry->db_crc)
+            || !entry->path)
+      {
+         database_scan_cache_entry_free(entry);
+         return false;
+      }
+
+      entry->type = (enum database_type)type;
+      entry->hash = database_scan_cache_hash(entry->path);
+
+      if (!matches || !entry->db_path || !entry->label || !entry->db_crc)
+         database_scan_cache_clear_match(entry);
+
+      slot = database_scan_cache_slot(cache, entry->path, entry->hash);
+
+      /* Written by this code, but not worth trusting blindly */
+      if (cache->slots[slot])
+      {
+         database_scan_cache_entry_free(entry);
+         continue;
+      }
+
+      cache->slots[slot] = (uint32_t)++cache->count;
+   }
+
+   return true;
+}
+
+database_scan_cache_t *database_scan_cache_load(const char *path,
+      uint32_t db_signature)
+{
+   void *data                   = NULL;
+   int64_t len                  = 0;
+   database_scan_cache_t *cache = database_scan_cache_new(db_signature);
+
+   if (!cache)
+      return NULL;
+
+   if (     string_is_empty(path)
+         || !path_is_valid(path)
+         || !filestream_read_file(path, &data, &len))
+      return cache;
+
+   /* A damaged or outdated cache is only a slower scan */
+   if (!database_scan_cache_read(cache, (const uint8_t*)data, (size_t)len))
+   {
+      database_scan_cache_free(cache);
+      cache = database_scan_cache_new(db_signature);
+   }
+
+   free(data);
+   return cache;
+}
+
+static void database_scan_cache_put_data(database_scan_cache_buf_t *buf,
+      const void *data, size_t len)
+{
+   if (buf->failed)
+      return;
+
+   if (buf->size + len > buf->capacity)
+   {
+      size_t capacity = buf->capacity ? buf->capacity * 2 : 65536;
+      uint8_t *grown  = NULL;
+
+      while (buf->size + len > capacity)
+         capacity *= 2;
+
+      if (!(grown = (uint8_t*)realloc(buf->data, capacity)))
+      {
+         buf->failed = true;
+         return;
+      }
+
+      buf->data     = grown;
+      buf->capacity = capacity;
+   }
+
+   memcpy(buf->data + buf->size, data, len);
+   buf->size += len;
+}
+
+static void database_scan_cache_put_string(database_scan_cache_buf_t *buf,
+      const char *s)
+{
+   uint32_t len = s ? (uint32_t)strlen(s) : DATABASE_SCAN_CACHE_NULL;
+   database_scan_cache_put_data(buf, &len, sizeof(len));
+   if (s)
+      database_scan_cache_put_data(buf, s, len);
+}
+
+static bool database_scan_cache_in_dir(const char *path,
+      const char *dir, size_t dir_len)
+{
+   if (strncmp(path, dir, dir_len) != 0)
+      return false;
+   if (dir_len && (dir[dir_len - 1] == '/' || dir[dir_len - 1] == '\\'))
+      return true;
+   return path[dir_len] == '/' || path[dir_len] == '\\';
+}
+
+bool database_scan_cache_save(database_scan_cache_t *cache,
+      const char *path, const char *prune_dir)
+{
+   size_t i;
+   char tmp_path[PATH_MAX_LENGTH];
+   struct database_scan_cache_header header;
+   database_scan_cache_buf_t buf;
+   RFILE *file    = NULL;
+   bool stored    = false;
+   size_t dir_len = prune_dir ? strlen(prune_dir) : 0;
+
+   if (!cache || string_is_empty(path))
+      return false;
+
+   buf.data     = NULL;
+   buf.size     = 0;
+   buf.capacity = 0;
+   buf.failed   = false;
+
+   memset(&header, 0, sizeof(header));
+   database_scan_cache_put_data(&buf, &header, sizeof(header));
+
+   for (i = 0; i < cache->count; i++)
+   {
+      uint8_t type                             = 0;
+      const database_scan_cache_entry_t *entry = &cache->entries[i];
+
+      if (     !entry->seen && dir_len
+            && database_scan_cache_in_dir(entry->path, prune_dir, dir_len))
+         continue;
+
+      type = (uint8_t)entry->type;
+      database_scan_cache_put_data(&buf, &entry->size, sizeof(entry->size));
+      database_scan_cache_put_data(&buf, &entry->mtime, sizeof(entry->mtime));
+      database_scan_cache_put_data(&buf, &entry->crc, sizeof(entry->crc));
+      database_scan_cache_put_data(&buf, &entry->archive_crc, sizeof(entry->archive_crc));
+      database_scan_cache_put_data(&buf, &type, sizeof(type));
+      database_scan_cache_put_string(&buf, entry->path);
+      database_scan_cache_put_string(&buf, entry->serial);
+      database_scan_cache_put_string(&buf, entry->db_path);
+      database_scan_cache_put_string(&buf, entry->label);
+      database_scan_cache_put_string(&buf, entry->db_crc);
+      header.count++;
+   }
+
+   if (buf.failed)
+   {
+      free(buf.data);
+      return false;
+   }
+
+   memcpy(header.magic, "RADS", 4);
+   header.version      = DATABASE_SCAN_CACHE_VERSION;
+   header.db_signature = cache->db_signature;
+   header.payload_size = (uint32_t)(buf.size - sizeof(header));
+   header.payload_crc  = encoding_crc32(0,
+         buf.data + sizeof(header), header.payload_size);
+   memcpy(buf.data, &header, sizeof(header));
+
+   strlcpy(tmp_path, path, sizeof(tmp_path));
+   strlcat(tmp_path, ".tmp", sizeof(tmp_path));
+
+   /* Write to a temporary file first, so an interrupted
+    * save never leaves a truncated cache behind */
+   if ((file = filestream_open(tmp_path,
+               RETRO_VFS_FILE_ACCESS_WRITE,
+               RETRO_VFS_FILE_ACCESS_HINT_NONE)))
+   {
+      stored = filestream_write(file, buf.data, buf.size)
+         == (int64_t)buf.size;
+      if (filestream_close(file) != 0)
+         stored = false;
+   }
+
+   free(buf.data);
+
+   if (stored)
+   {
+      /* rename() does not replace existing files everywhere */
+      filestream_delete(path);
+      stored = filestream_rename(tmp_path, path) == 0;
+   }
+
+   if (!stored)
+      filestream_delete(tmp_path);
+
+   return stored;
+}
+
+uint32_t database_scan_cache_signature(const struct string_list *rdbs)
+{
+   size_t i;
+   uint32_t signature = 0;
+
+   if (!rdbs)
+      return 0;
+
+   /* A sum, so the order of the list does not matter */
+   for (i = 0; i < rdbs->size; i++)
+   {
+      int64_t size     = -1;
+      int64_t mtime    = -1;
+      const char *path = rdbs->elems[i].data;
+      uint32_t crc     = encoding_crc32(0, (const uint8_t*)path,
+            strlen(path));
+
+      path_get_info(path, &size, &mtime);
+      crc        = encoding_crc32(crc, (const uint8_t*)&size, sizeof(size));
+      crc        = encoding_crc32(crc, (const uint8_t*)&mtime, sizeof(mtime));
+      signature += crc;
+   }
+
+   return signature;
+}
+
+bool database_scan_cache_stat(const char *path,
+      int64_t *size, int64_t *mtime)
+{
+   char archive_path[PATH_MAX_LENGTH];
+   const char *delim = path_get_archive_delim(path);
+
+   if (!delim)
+      return path_get_info(path, size, mtime);
+
+   if ((size_t)(delim - path) >= sizeof(archive_path))
+      return false;
+
+   memcpy(archive_path, path, delim - path);
+   archive_path[delim - path] = '\0';
+   return path_get_info(archive_path, size, mtime);
+}
+
+database_scan_cache_entry_t *database_scan_cache_find(
+      database_scan_cache_t *cache, const char *path,
+      int64_t size, int64_t mtime)
+{
+   size_t slot;
+   database_scan_cache_entry_t *entry = NULL;
+
+   if (!cache)
+      return NULL;
+
+   slot = database_scan_cache_slot(cache, path,
+         database_scan_cache_hash(path));
+
+   if (!cache->slots[slot])
+      return NULL;
+
+   entry = &cache->entries[cache->slots[slot] - 1];
+
+   if (entry->size != size || entry->mtime != mtime)
+      return NULL;
+
+   entry->seen = true;
+   return entry;
+}
+
+static char *database_scan_cache_strdup(const char *s, bool *failed)
+{
+   char *copy = NULL;
+   if (!s)
+      return NULL;
+   if (!(copy = strdup(s)))
+      *failed = true;
+   return copy;
+}
+
+bool database_scan_cache_put(database_scan_cache_t *cache,
+      const char *path, int64_t size, int64_t mtime,
+      enum database_type type, uint32_t crc, uint32_t archive_crc,
+      const char *serial)
+{
+   size_t slot;
+   database_scan_cache_entry_t entry;
+   bool failed = false;
+
+   if (!cache)
+      return false;
+
+   entry.path        = database_scan_cache_strdup(path, &failed);
+   entry.serial      = database_scan_cache_strdup(
+         string_is_empty(serial) ? NULL : serial, &failed);
+   entry.db_path     = NULL;
+   entry.label       = NULL;
+   entry.db_crc      = NULL;
+   entry.size        = size;
+   entry.mtime       = mtime;
+   entry.crc         = crc;
+   entry.archive_crc = archive_crc;
+   entry.hash        = database_scan_cache_hash(path);
+   entry.type        = type;
+   entry.seen        = true;
+
+   if (failed || !database_scan_cache_reserve(cache, cache->count + 1))
+   {
+      database_scan_cache_entry_free(&entry);
+      return false;
+   }
+
+   slot = database_scan_cache_slot(cache, path, entry.hash);
+
+   if (cache->slots[slot])
+   {
+      database_scan_cache_entry_t *old =
+         &cache->entries[cache->slots[slot] - 1];
+      database_scan_cache_entry_free(old);
+      *old = entry;
+      return true;
+   }
+
+   cache->entries[cache->count] = entry;
+   cache->slots[slot]           = (uint32_t)++cache->count;
+   return true;
+}
+
+bool database_scan_cache_set_match(database_scan_cache_t *cache,
+      const char *path, const char *db_path, const char *label,
+      const char *db_crc)
+{
+   size_t slot;
+   database_scan_cache_entry_t *entry = NULL;
+   bool failed                        = false;
+
+   if (!cache)
+      return false;
+
+   slot = database_scan_cache_slot(cache, path,
+         database_scan_cache_hash(path));
+
+   if (!cache->slots[slot])
+      return false;
+
+   entry = &cache->entries[cache->slots[slot] - 1];
+
+   database_scan_cache_clear_match(entry);
+   entry->db_path = database_scan_cache_strdup(db_path, &failed);
+   entry->label   = database_scan_cache_strdup(label, &failed);
+   entry->db_crc  = database_scan_cache_strdup(db_crc, &failed);
+
+   if (failed || !entry->db_path || !entry->label || !entry->db_crc)
+   {
+      database_scan_cache_clear_match(entry);
+      return false;
+   }
+
+   return true;
+}
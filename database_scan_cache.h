@@ -0,0 +1,157 @@
+/*  RetroArch - A frontend for libretro.
+ *  Copyright (C) 2011-2017 - Daniel De Matteis
+ *  Copyright (C) 2016-2019 - Brad Parker
+ *
+ *  RetroArch is free software: you can redistribute it and/or modify it under the terms
+ *  of the GNU General Public License as published by the Free Software Found-
+ *  ation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  RetroArch is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ *  without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ *  PURPOSE.  See the GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along with RetroArch.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef DATABASE_SCAN_CACHE_H_
+#define DATABASE_SCAN_CACHE_H_
+
+#include <stdint.h>
+#include <stddef.h>
+
+#include <boolean.h>
+#include <retro_common_api.h>
+#include <lists/string_list.h>
+
+#include "database_info.h"
+
+RETRO_BEGIN_DECLS
+
+/* What a content scan found out about a file: how it is looked
+ * up, its CRC32 or serial, and the playlist entry it got. A file
+ * is only hashed again once its size or modification time
+ * changed; its playlist entry is only trusted while the .rdb
+ * files are the same as when it was found. */
+typedef struct database_scan_cache_entry
+{
+   char *path;            /* archive members as archive#member */
+   char *serial;          /* NULL if the file has none */
+   char *db_path;         /* .rdb of the match, NULL if none */
+   char *label;           /* name of the match */
+   char *db_crc;          /* "XXXXXXXX|crc" or "serial|serial" */
+   int64_t size;          /* of the archive, for its members */
+   int64_t mtime;
+   uint32_t crc;
+   uint32_t archive_crc;
+   uint32_t hash;         /* of path */
+   enum database_type type;
+   bool seen;             /* looked up or stored by this scan */
+} database_scan_cache_entry_t;
+
+typedef struct database_scan_cache database_scan_cache_t;
+
+/**
+ * database_scan_cache_load:
+ * @path                 : cache file.
+ * @db_signature         : database_scan_cache_signature() of the
+ *                         .rdb files the scan uses.
+ *
+ * Reads the entries of the cache file at @path, if there is a
+ * valid one. Their matches are dropped if @db_signature is not the
+ * one they were stored with.
+ *
+ * Returns: cache, empty if @path could not be read, or NULL if
+ * out of memory.
+ **/
+database_scan_cache_t *database_scan_cache_load(const char *path,
+      uint32_t db_signature);
+
+/**
+ * database_scan_cache_save:
+ * @cache                : cache.
+ * @path                 : cache file.
+ * @prune_dir            : directory scanned in full, or NULL.
+ *
+ * Replaces the cache file at @path with the entries of @cache.
+ * Entries of files in @prune_dir that this scan did not see were
+ * removed or renamed since and are left out.
+ *
+ * Returns: true if the file was written.
+ **/
+bool database_scan_cache_save(database_scan_cache_t *cache,
+      const char *path, const char *prune_dir);
+
+void database_scan_cache_free(database_scan_cache_t *cache);
+
+/* Hash of the paths, sizes and modification times of @rdbs */
+uint32_t database_scan_cache_signature(const struct string_list *rdbs);
+
+/**
+ * database_scan_cache_stat:
+ * @path                 : file, or archive#member.
+ * @size                 : size, of the archive for a member.
+ * @mtime                : modification time, idem.
+ *
+ * Returns: false if the platform does not report them, in which
+ * case the file cannot be cached.
+ **/
+bool database_scan_cache_stat(const char *path,
+      int64_t *size, int64_t *mtime);
+
+/**
+ * database_scan_cache_find:
+ * @cache                : cache.
+ * @path                 : file, or archive#member.
+ * @size                 : from database_scan_cache_stat().
+ * @mtime                : idem.
+ *
+ * Returns: entry of @path if it is still up to date, otherwise
+ * NULL. It stays valid until the next database_scan_cache_put().
+ **/
+database_scan_cache_entry_t *database_scan_cache_find(
+      database_scan_cache_t *cache, const char *path,
+      int64_t size, int64_t mtime);
+
+/**
+ * database_scan_cache_put:
+ * @cache                : cache.
+ * @path                 : file, or archive#member.
+ * @size                 : from database_scan_cache_stat().
+ * @mtime                : idem.
+ * @type                 : DATABASE_TYPE_CRC_LOOKUP,
+ *                         DATABASE_TYPE_SERIAL_LOOKUP or
+ *                         DATABASE_TYPE_ITERATE_ARCHIVE.
+ * @crc                  : CRC32 of the file.
+ * @archive_crc          : CRC32 of the archive itself.
+ * @serial               : serial, or NULL.
+ *
+ * Stores what the scan found out about @path, without a match,
+ * replacing its previous entry.
+ *
+ * Returns: false if out of memory.
+ **/
+bool database_scan_cache_put(database_scan_cache_t *cache,
+      const char *path, int64_t size, int64_t mtime,
+      enum database_type type, uint32_t crc, uint32_t archive_crc,
+      const char *serial);
+
+/**
+ * database_scan_cache_set_match:
+ * @cache                : cache.
+ * @path                 : file stored with database_scan_cache_put().
+ * @db_path              : .rdb the file was found in.
+ * @label                : name of its record.
+ * @db_crc               : CRC field of its playlist entry.
+ *
+ * Remembers the playlist entry @path got.
+ *
+ * Returns: false if @path has no entry, or if out of memory.
+ **/
+bool database_scan_cache_set_match(database_scan_cache_t *cache,
+      const char *path, const char *db_path, const char *label,
+      const char *db_crc);
+
+RETRO_END_DECLS
+
+#endif
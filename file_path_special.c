@@ -172,6 +172,20 @@ void fill_pathname_application_special(char *s,
                fill_pathname_basedir(s, path_get(RARCH_PATH_CONFIG), len);
          }
          break;
+      case APPLICATION_SPECIAL_DIRECTORY_CACHE:
+         {
+            settings_t *settings  = config_get_ptr();
+            const char *dir_cache = settings->paths.directory_cache;
+
+            /* The cache directory is not set everywhere,
+             * fallback to the configuration directory. */
+            if (!string_is_empty(dir_cache))
+               strlcpy(s, dir_cache, len);
+            else
+               fill_pathname_application_special(s, len,
+                     APPLICATION_SPECIAL_DIRECTORY_CONFIG);
+         }
+         break;
       case APPLICATION_SPECIAL_DIRECTORY_ASSETS_PKG:
          {
             settings_t *settings   = config_get_ptr();
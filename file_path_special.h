@@ -32,6 +32,7 @@ RETRO_BEGIN_DECLS
 #define FILE_PATH_BUILTIN          "builtin"
 #define FILE_PATH_DETECT           "DETECT"
 #define FILE_PATH_LUTRO_PLAYLIST   "Lutro.lpl"
+#define FILE_PATH_DATABASE_SCAN_CACHE "database_scan.cache"
 #define FILE_PATH_NUL              "nul"
 #define FILE_PATH_CGP_EXTENSION ".cgp"
 #define FILE_PATH_GLSLP_EXTENSION ".glslp"
@@ -121,6 +122,7 @@ enum application_special_type
    APPLICATION_SPECIAL_NONE = 0,
    APPLICATION_SPECIAL_DIRECTORY_AUTOCONFIG,
    APPLICATION_SPECIAL_DIRECTORY_CONFIG,
+   APPLICATION_SPECIAL_DIRECTORY_CACHE,
    APPLICATION_SPECIAL_DIRECTORY_ASSETS_PKG,
    APPLICATION_SPECIAL_DIRECTORY_ASSETS_PKG_AR_FONT,
    APPLICATION_SPECIAL_DIRECTORY_ASSETS_PKG_CJK_FONT,
@@ -0,0 +1,334 @@
+/*  RetroArch - A frontend for libretro.
+ *  Copyright (C) 2010-2014 - Hans-Kristian Arntzen
+ *  Copyright (C) 2011-2021 - Daniel De Matteis
+ *
+ *  RetroArch is free software: you can redistribute it and/or modify it under the terms
+ *  of the GNU General Public License as published by the Free Software Found-
+ *  ation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  RetroArch is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ *  without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ *  PURPOSE.  See the GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along with RetroArch.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include <retro_miscellaneous.h>
+#include <features/features_cpu.h>
+#include <streams/file_stream.h>
+
+#include "frame_profiler.h"
+#include "verbosity.h"
+
+/* Maximum nesting of spans on one thread. Deeper spans
+ * are not recorded, but still balance begin/end. */
+#define FRAME_PROFILER_DEPTH 8
+
+/* Every ring has a single writer that publishes new entries by
+ * bumping a position counter; readers copy entries out and then
+ * discard whatever the writer may have overwritten meanwhile. */
+#if defined(__GNUC__) && ((__GNUC__ > 4) || (__GNUC__ == 4 && __GNUC_MINOR__ >= 7))
+#define FRAME_PROFILER_PUBLISH(dst, val) __atomic_store_n(&(dst), (val), __ATOMIC_RELEASE)
+#define FRAME_PROFILER_ACQUIRE(src)      __atomic_load_n(&(src), __ATOMIC_ACQUIRE)
+#else
+#define FRAME_PROFILER_PUBLISH(dst, val) ((dst) = (val))
+#define FRAME_PROFILER_ACQUIRE(src)      (src)
+#endif
+
+struct frame_profiler_event
+{
+   retro_time_t start;
+   uint32_t duration;
+   uint32_t frame;
+   uint8_t stage;
+};
+
+struct frame_profiler_span
+{
+   retro_time_t start;
+   retro_time_t children;
+   unsigned stage;
+};
+
+struct frame_profiler_ring
+{
+   struct frame_profiler_event events[FRAME_PROFILER_EVENTS];
+   struct frame_profiler_span stack[FRAME_PROFILER_DEPTH];
+   volatile unsigned write_pos;
+   unsigned depth;
+};
+
+struct frame_profiler_state
+{
+   struct frame_profiler_ring rings[FRAME_PROFILER_THREAD_LAST];
+   frame_profiler_frame_t frames[FRAME_PROFILER_FRAMES];
+   /* Frame being recorded by the main thread */
+   frame_profiler_frame_t current;
+   retro_time_t frame_start;
+   volatile unsigned frame_pos;
+   volatile uint32_t frame_count;
+   volatile bool enabled;
+   volatile bool show_graph;
+};
+
+/* Static so that enabling the profiler never allocates,
+ * and so that threads still inside a span when it is
+ * disabled never touch freed memory. */
+static struct frame_profiler_state frame_profiler_st;
+
+static const char *frame_profiler_stage_names[FRAME_PROFILER_STAGE_LAST] = {
+   "core_run",
+   "input_poll",
+   "video_frame",
+   "audio_flush",
+   "runahead",
+   "rewind",
+   "sleep",
+   "softfilter"
+};
+
+static const char *frame_profiler_thread_names[FRAME_PROFILER_THREAD_LAST] = {
+   "Main",
+   "Video",
+   "Run-Ahead"
+};
+
+const char *frame_profiler_stage_name(enum frame_profiler_stage stage)
+{
+   if (stage < FRAME_PROFILER_STAGE_LAST)
+      return frame_profiler_stage_names[stage];
+   return "unknown";
+}
+
+bool frame_profiler_is_enabled(void)
+{
+   return frame_profiler_st.enabled;
+}
+
+bool frame_profiler_graph_visible(void)
+{
+   return frame_profiler_st.show_graph;
+}
+
+void frame_profiler_update(bool enable, bool show_graph)
+{
+   struct frame_profiler_state *st = &frame_profiler_st;
+   retro_time_t now                = 0;
+
+   if (!enable && !st->enabled)
+      return;
+
+   now = cpu_features_get_time_usec();
+
+   if (st->enabled && st->frame_start)
+   {
+      unsigned pos              = st->frame_pos;
+      st->current.frame_usec    = (uint32_t)(now - st->frame_start);
+      st->frames[pos % FRAME_PROFILER_FRAMES] = st->current;
+      FRAME_PROFILER_PUBLISH(st->frame_pos, pos + 1);
+   }
+   else if (enable)
+      RARCH_LOG("[Profiler]: Recording frame times.\n");
+
+   memset(&st->current, 0, sizeof(st->current));
+   st->frame_start = enable ? now : 0;
+   st->frame_count++;
+   st->enabled     = enable;
+   st->show_graph  = enable && show_graph;
+}
+
+void frame_profiler_begin(enum frame_profiler_thread thread,
+      enum frame_profiler_stage stage)
+{
+   struct frame_profiler_ring *ring = NULL;
+
+   if (!frame_profiler_st.enabled)
+      return;
+
+   ring = &frame_profiler_st.rings[thread];
+
+   if (ring->depth < FRAME_PROFILER_DEPTH)
+   {
+      struct frame_profiler_span *span = &ring->stack[ring->depth];
+      span->start    = cpu_features_get_time_usec();
+      span->children = 0;
+      span->stage    = stage;
+   }
+
+   ring->depth++;
+}
+
+void frame_profiler_end(enum frame_profiler_thread thread,
+      enum frame_profiler_stage stage)
+{
+   retro_time_t duration;
+   unsigned pos;
+   struct frame_profiler_span *span   = NULL;
+   struct frame_profiler_event *event = NULL;
+   struct frame_profiler_ring *ring   = &frame_profiler_st.rings[thread];
+
+   /* Not checking 'enabled' here, spans begun before the
+    * profiler was disabled still need to be popped. */
+   if (!ring->depth)
+      return;
+
+   if (--ring->depth >= FRAME_PROFILER_DEPTH)
+      return;
+
+   span = &ring->stack[ring->depth];
+
+   /* Unbalanced begin/end, start over */
+   if (span->stage != (unsigned)stage)
+   {
+      ring->depth = 0;
+      return;
+   }
+
+   duration = cpu_features_get_time_usec() - span->start;
+
+   if (ring->depth)
+      ring->stack[ring->depth - 1].children += duration;
+
+   if (thread == FRAME_PROFILER_THREAD_MAIN)
+      frame_profiler_st.current.stage_usec[stage] +=
+         (uint32_t)(duration - span->children);
+
+   pos             = ring->write_pos;
+   event           = &ring->events[pos & (FRAME_PROFILER_EVENTS - 1)];
+   event->start    = span->start;
+   event->duration = (uint32_t)duration;
+   event->frame    = frame_profiler_st.frame_count;
+   event->stage    = (uint8_t)stage;
+   FRAME_PROFILER_PUBLISH(ring->write_pos, pos + 1);
+}
+
+unsigned frame_profiler_get_frames(frame_profiler_frame_t *frames,
+      unsigned count)
+{
+   unsigned i, first, oldest;
+   struct frame_profiler_state *st = &frame_profiler_st;
+   unsigned pos                    = FRAME_PROFILER_ACQUIRE(st->frame_pos);
+
+   if (count > FRAME_PROFILER_FRAMES)
+      count = FRAME_PROFILER_FRAMES;
+   if (count > pos)
+      count = pos;
+
+   first = pos - count;
+   for (i = 0; i < count; i++)
+      frames[i] = st->frames[(first + i) % FRAME_PROFILER_FRAMES];
+
+   /* Drop the frames the main thread may have
+    * overwritten while we were copying them. */
+   pos    = FRAME_PROFILER_ACQUIRE(st->frame_pos);
+   oldest = (pos >= FRAME_PROFILER_FRAMES)
+      ? pos - FRAME_PROFILER_FRAMES + 1
+      : 0;
+   if (first < oldest)
+   {
+      unsigned skip = oldest - first;
+      if (skip >= count)
+         return 0;
+      memmove(frames, frames + skip, (count - skip) * sizeof(*frames));
+      count -= skip;
+   }
+
+   return count;
+}
+
+static unsigned frame_profiler_copy_events(
+      struct frame_profiler_ring *ring,
+      struct frame_profiler_event *events)
+{
+   unsigned i, first, oldest;
+   unsigned pos   = FRAME_PROFILER_ACQUIRE(ring->write_pos);
+   unsigned count = (pos > FRAME_PROFILER_EVENTS)
+      ? FRAME_PROFILER_EVENTS
+      : pos;
+
+   first = pos - count;
+   for (i = 0; i < count; i++)
+      events[i] = ring->events[(first + i) & (FRAME_PROFILER_EVENTS - 1)];
+
+   pos    = FRAME_PROFILER_ACQUIRE(ring->write_pos);
+   oldest = (pos >= FRAME_PROFILER_EVENTS)
+      ? pos - FRAME_PROFILER_EVENTS + 1
+      : 0;
+   if (first < oldest)
+   {
+      unsigned skip = oldest - first;
+      if (skip >= count)
+         return 0;
+      memmove(events, events + skip, (count - skip) * sizeof(*events));
+      count -= skip;
+   }
+
+   return count;
+}
+
+bool frame_profiler_export(const char *path)
+{
+   unsigned t, i;
+   bool first                          = true;
+   unsigned total                      = 0;
+   struct frame_profiler_event *events = NULL;
+   RFILE *file                         = NULL;
+
+   if (!path || !*path)
+      return false;
+
+   if (!(events = (struct frame_profiler_event*)
+            malloc(FRAME_PROFILER_EVENTS * sizeof(*events))))
+      return false;
+
+   if (!(file = filestream_open(path,
+               RETRO_VFS_FILE_ACCESS_WRITE,
+               RETRO_VFS_FILE_ACCESS_HINT_NONE)))
+   {
+      RARCH_ERR("[Profiler]: Failed to open \"%s\" for writing.\n", path);
+      free(events);
+      return false;
+   }
+
+   filestream_printf(file, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+
+   for (t = 0; t < FRAME_PROFILER_THREAD_LAST; t++)
+   {
+      unsigned count = frame_profiler_copy_events(
+            &frame_profiler_st.rings[t], events);
+
+      if (!count)
+         continue;
+
+      filestream_printf(file,
+            "%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%u,"
+            "\"args\":{\"name\":\"%s\"}}",
+            first ? "" : ",\n", t, frame_profiler_thread_names[t]);
+      first = false;
+
+      for (i = 0; i < count; i++)
+         filestream_printf(file,
+               ",\n{\"name\":\"%s\",\"cat\":\"frame\",\"ph\":\"X\","
+               "\"ts\":%lld,\"dur\":%u,\"pid\":1,\"tid\":%u,"
+               "\"args\":{\"frame\":%u}}",
+               frame_profiler_stage_name(
+                  (enum frame_profiler_stage)events[i].stage),
+               (long long)events[i].start,
+               (unsigned)events[i].duration,
+               t,
+               (unsigned)events[i].frame);
+
+      total += count;
+   }
+
+   filestream_printf(file, "\n]}\n");
+   filestream_close(file);
+   free(events);
+
+   RARCH_LOG("[Profiler]: Wrote %u spans to \"%s\".\n", total, path);
+   return true;
+}
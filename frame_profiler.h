@@ -0,0 +1,124 @@
+/*  RetroArch - A frontend for libretro.
+ *  Copyright (C) 2010-2014 - Hans-Kristian Arntzen
+ *  Copyright (C) 2011-2021 - Daniel De Matteis
+ *
+ *  RetroArch is free software: you can redistribute it and/or modify it under the terms
+ *  of the GNU General Public License as published by the Free Software Found-
+ *  ation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  RetroArch is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ *  without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ *  PURPOSE.  See the GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along with RetroArch.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __FRAME_PROFILER_H
+#define __FRAME_PROFILER_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+#include <boolean.h>
+#include <retro_common_api.h>
+
+RETRO_BEGIN_DECLS
+
+/* Number of frames kept for the graph. */
+#define FRAME_PROFILER_FRAMES 256
+
+/* Number of spans each thread can record before
+ * the oldest ones are overwritten. Must be a power of two. */
+#define FRAME_PROFILER_EVENTS 4096
+
+enum frame_profiler_stage
+{
+   FRAME_PROFILER_STAGE_CORE_RUN = 0,
+   FRAME_PROFILER_STAGE_INPUT_POLL,
+   FRAME_PROFILER_STAGE_VIDEO_FRAME,
+   FRAME_PROFILER_STAGE_AUDIO_FLUSH,
+   FRAME_PROFILER_STAGE_RUNAHEAD,
+   FRAME_PROFILER_STAGE_REWIND,
+   FRAME_PROFILER_STAGE_SLEEP,
+   FRAME_PROFILER_STAGE_SOFTFILTER,
+
+   FRAME_PROFILER_STAGE_LAST
+};
+
+/* Each thread that records spans owns one ring buffer,
+ * so recording never needs a lock. */
+enum frame_profiler_thread
+{
+   FRAME_PROFILER_THREAD_MAIN = 0,
+   FRAME_PROFILER_THREAD_VIDEO,
+   FRAME_PROFILER_THREAD_RUNAHEAD,
+
+   FRAME_PROFILER_THREAD_LAST
+};
+
+/* Time spent in each stage during one frame of the main
+ * thread. Nested stages are not counted twice, e.g. the
+ * time the core spends in video_driver_frame() is only
+ * counted as FRAME_PROFILER_STAGE_VIDEO_FRAME. */
+typedef struct frame_profiler_frame
+{
+   uint32_t stage_usec[FRAME_PROFILER_STAGE_LAST];
+   uint32_t frame_usec;
+} frame_profiler_frame_t;
+
+/**
+ * frame_profiler_update:
+ * @enable               : record spans.
+ * @show_graph           : let the widget draw the graph.
+ *
+ * Closes the current frame of the main thread and starts
+ * a new one. Call once per runloop iteration, from the
+ * main thread.
+ **/
+void frame_profiler_update(bool enable, bool show_graph);
+
+bool frame_profiler_is_enabled(void);
+
+bool frame_profiler_graph_visible(void);
+
+/**
+ * frame_profiler_begin:
+ *
+ * Starts a span of @stage on @thread. Spans may nest, but
+ * must be ended in reverse order, by the same thread.
+ **/
+void frame_profiler_begin(enum frame_profiler_thread thread,
+      enum frame_profiler_stage stage);
+
+void frame_profiler_end(enum frame_profiler_thread thread,
+      enum frame_profiler_stage stage);
+
+/**
+ * frame_profiler_get_frames:
+ * @frames               : receives up to @count frames, oldest first.
+ *
+ * Copies the most recent frames of the main thread.
+ * Safe to call from any thread.
+ *
+ * Returns: number of frames copied.
+ **/
+unsigned frame_profiler_get_frames(frame_profiler_frame_t *frames,
+      unsigned count);
+
+const char *frame_profiler_stage_name(enum frame_profiler_stage stage);
+
+/**
+ * frame_profiler_export:
+ * @path                 : file to write.
+ *
+ * Writes the spans still held by every thread as a Chrome
+ * trace-event JSON file (chrome://tracing, Perfetto).
+ *
+ * Returns: true on success.
+ **/
+bool frame_profiler_export(const char *path);
+
+RETRO_END_DECLS
+
+#endif
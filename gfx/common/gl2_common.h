@@ -33,6 +33,7 @@
 
 #include "../video_coord_array.h"
 #include "../../retroarch.h"
+#include "gl_common.h"
 
 RETRO_BEGIN_DECLS
 
@@ -217,6 +218,9 @@ struct gl2
    GLenum wrap_mode;
 
    struct scaler_ctx pbo_readback_scaler;
+#ifdef HAVE_GL_UPLOAD_RING
+   gl_upload_ring_t upload_ring;
+#endif
    struct video_viewport vp;                          /* int alignment */
    math_matrix_4x4 mvp, mvp_no_rot;
    struct video_coords coords;                        /* ptr alignment */
@@ -255,6 +259,7 @@ struct gl2
    bool have_sync;
    bool pbo_readback_valid[4];
    bool pbo_readback_enable;
+   bool upload_ring_enable;
 };
 
 #define GL2_BIND_TEXTURE(id, wrap_mode, mag_filter, min_filter) \
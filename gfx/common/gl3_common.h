@@ -35,6 +35,7 @@
 #include "../video_coord_array.h"
 #include "../../retroarch.h"
 #include "../drivers_shader/shader_gl3.h"
+#include "gl_common.h"
 
 RETRO_BEGIN_DECLS
 
@@ -61,6 +62,9 @@ typedef struct gl3
    GLsync fences[GL_CORE_NUM_FENCES];
    void *readback_buffer_screenshot;
    struct scaler_ctx pbo_readback_scaler;
+#ifdef HAVE_GL_UPLOAD_RING
+   gl_upload_ring_t upload_ring;
+#endif
 
    video_info_t video_info;
    video_viewport_t vp;
@@ -117,6 +121,7 @@ typedef struct gl3
 
    bool pbo_readback_valid[GL_CORE_NUM_PBOS];
    bool pbo_readback_enable;
+   bool upload_ring_enable;
    bool hw_render_bottom_left;
    bool hw_render_enable;
    bool use_shared_context;
@@ -19,8 +19,12 @@
 #include "../../config.h"
 #endif
 
+#include <string.h>
+
 #include <glsym/glsym.h>
 
+#include "gl_common.h"
+
 void gl_flush(void)
 {
    glFlush();
@@ -47,3 +51,165 @@ void gl_finish(void)
 {
    glFinish();
 }
+
+#ifdef HAVE_GL_UPLOAD_RING
+#ifndef GL_MAP_PERSISTENT_BIT
+#define GL_MAP_PERSISTENT_BIT 0x0040
+#endif
+#ifndef GL_MAP_COHERENT_BIT
+#define GL_MAP_COHERENT_BIT 0x0080
+#endif
+
+void gl_upload_ring_init(gl_upload_ring_t *ring,
+      bool persistent, bool map_range)
+{
+   memset(ring, 0, sizeof(*ring));
+   ring->persistent = persistent;
+   ring->map_range  = map_range;
+}
+
+void gl_upload_ring_free(gl_upload_ring_t *ring)
+{
+   unsigned i;
+   bool persistent = ring->persistent;
+   bool map_range  = ring->map_range;
+
+   for (i = 0; i < GL_UPLOAD_RING_SIZE; i++)
+   {
+      if (ring->fences[i])
+         glDeleteSync(ring->fences[i]);
+   }
+
+   /* Deleting a buffer unmaps it */
+   if (ring->buffers[0])
+      glDeleteBuffers(GL_UPLOAD_RING_SIZE, ring->buffers);
+
+   gl_upload_ring_init(ring, persistent, map_range);
+}
+
+bool gl_upload_ring_reserve(gl_upload_ring_t *ring, size_t size)
+{
+   unsigned i;
+   GLbitfield flags = GL_MAP_WRITE_BIT
+      | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+
+   if (size <= ring->size)
+      return true;
+
+   gl_upload_ring_free(ring);
+
+   glGenBuffers(GL_UPLOAD_RING_SIZE, ring->buffers);
+   for (i = 0; i < GL_UPLOAD_RING_SIZE; i++)
+   {
+      glBindBuffer(GL_PIXEL_UNPACK_BUFFER, ring->buffers[i]);
+      if (ring->persistent)
+      {
+         glBufferStorage(GL_PIXEL_UNPACK_BUFFER, size, NULL, flags);
+         ring->maps[i] = (uint8_t*)glMapBufferRange(
+               GL_PIXEL_UNPACK_BUFFER, 0, size, flags);
+         if (!ring->maps[i])
+            break;
+      }
+      else
+         glBufferData(GL_PIXEL_UNPACK_BUFFER, size, NULL, GL_STREAM_DRAW);
+   }
+   glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+
+   if (i < GL_UPLOAD_RING_SIZE)
+   {
+      gl_upload_ring_free(ring);
+      return false;
+   }
+
+   ring->size = size;
+   return true;
+}
+
+uint8_t *gl_upload_ring_map(gl_upload_ring_t *ring)
+{
+   unsigned i = ring->index;
+
+   if (!ring->size)
+      return NULL;
+
+   if (ring->persistent)
+   {
+      if (ring->fences[i])
+      {
+         /* Only waits when the GPU is more than
+          * GL_UPLOAD_RING_SIZE - 1 frames behind */
+         glClientWaitSync(ring->fences[i],
+               GL_SYNC_FLUSH_COMMANDS_BIT, 1000000000);
+         glDeleteSync(ring->fences[i]);
+         ring->fences[i] = NULL;
+      }
+   }
+   else if (!ring->maps[i])
+   {
+      /* Orphan the old storage so the GPU can keep
+       * reading it while we write the new one. */
+      glBindBuffer(GL_PIXEL_UNPACK_BUFFER, ring->buffers[i]);
+      if (ring->map_range)
+         ring->maps[i] = (uint8_t*)glMapBufferRange(
+               GL_PIXEL_UNPACK_BUFFER, 0, ring->size,
+               GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT);
+      else
+      {
+         glBufferData(GL_PIXEL_UNPACK_BUFFER, ring->size, NULL,
+               GL_STREAM_DRAW);
+         ring->maps[i] = (uint8_t*)glMapBuffer(
+               GL_PIXEL_UNPACK_BUFFER, GL_WRITE_ONLY);
+      }
+      glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+   }
+
+   return ring->maps[i];
+}
+
+void gl_upload_ring_bind(gl_upload_ring_t *ring)
+{
+   unsigned i = ring->index;
+
+   glBindBuffer(GL_PIXEL_UNPACK_BUFFER, ring->buffers[i]);
+   if (!ring->persistent && ring->maps[i])
+   {
+      glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
+      ring->maps[i] = NULL;
+   }
+}
+
+void gl_upload_ring_submit(gl_upload_ring_t *ring)
+{
+   unsigned i = ring->index;
+
+   if (ring->persistent)
+      ring->fences[i] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+   glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+   ring->index = (i + 1) % GL_UPLOAD_RING_SIZE;
+}
+
+bool gl_upload_ring_supported(void)
+{
+   static const char *software[] = {
+      "llvmpipe",
+      "softpipe",
+      "SwiftShader",
+      "Software Rasterizer",
+      "GDI Generic",
+      "Apple Software Renderer"
+   };
+   unsigned i;
+   const char *renderer = (const char*)glGetString(GL_RENDERER);
+
+   if (!renderer)
+      return false;
+
+   /* The "upload" is a memcpy on these as well, so staging the
+    * frame first only adds a copy */
+   for (i = 0; i < sizeof(software) / sizeof(software[0]); i++)
+      if (strstr(renderer, software[i]))
+         return false;
+
+   return true;
+}
+#endif
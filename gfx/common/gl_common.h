@@ -27,4 +27,109 @@ void gl_finish(void);
 
 void gl_flush(void);
 
+#if (defined(HAVE_OPENGL) || defined(HAVE_OPENGL_CORE)) && !defined(HAVE_OPENGLES) && !defined(HAVE_PSGL)
+#define HAVE_GL_UPLOAD_RING
+#endif
+
+#ifdef HAVE_GL_UPLOAD_RING
+#include <stddef.h>
+#include <stdint.h>
+
+#include <boolean.h>
+#include <glsym/glsym.h>
+
+#define GL_UPLOAD_RING_SIZE 3
+
+/* Ring of pixel unpack buffers that software frames are written
+ * into before glTexSubImage2D() reads them, so texture uploads
+ * do not wait for the driver to copy out of client memory.
+ *
+ * With ARB_buffer_storage the buffers stay mapped for their whole
+ * life and a fence tells when the GPU is done reading one.
+ * Otherwise each buffer is orphaned and mapped again every frame. */
+typedef struct gl_upload_ring
+{
+   GLuint buffers[GL_UPLOAD_RING_SIZE];
+   GLsync fences[GL_UPLOAD_RING_SIZE];
+   uint8_t *maps[GL_UPLOAD_RING_SIZE];
+   size_t size;
+   unsigned index;
+   bool persistent;
+   bool map_range;
+} gl_upload_ring_t;
+
+/**
+ * gl_upload_ring_init:
+ * @ring                      : Upload ring
+ * @persistent                : Map the buffers persistently.
+ *                              Needs GL_CAPS_BUFFER_STORAGE and
+ *                              GL_CAPS_SYNC.
+ * @map_range                 : Orphan buffers by mapping them with
+ *                              GL_MAP_INVALIDATE_BUFFER_BIT rather
+ *                              than reallocating them.
+ *                              Needs GL_CAPS_MAP_BUFFER_RANGE.
+ *
+ * Sets up an empty ring, see gl_upload_ring_reserve().
+ **/
+void gl_upload_ring_init(gl_upload_ring_t *ring,
+      bool persistent, bool map_range);
+
+/**
+ * gl_upload_ring_reserve:
+ * @ring                      : Upload ring
+ * @size                      : Bytes needed for one frame
+ *
+ * Makes every buffer at least @size bytes, recreating them
+ * if they are smaller.
+ *
+ * Returns: true (1) if the ring can hold @size bytes,
+ * otherwise false (0).
+ **/
+bool gl_upload_ring_reserve(gl_upload_ring_t *ring, size_t size);
+
+/**
+ * gl_upload_ring_map:
+ * @ring                      : Upload ring
+ *
+ * Waits until the GPU is done with the current buffer and
+ * maps it for writing. Mapping the same buffer again returns
+ * the same pointer.
+ *
+ * Returns: pointer to the current buffer, or NULL on failure.
+ **/
+uint8_t *gl_upload_ring_map(gl_upload_ring_t *ring);
+
+/**
+ * gl_upload_ring_bind:
+ * @ring                      : Upload ring
+ *
+ * Unmaps the current buffer if needed and binds it to
+ * GL_PIXEL_UNPACK_BUFFER, so the next upload reads from it
+ * with a NULL offset.
+ **/
+void gl_upload_ring_bind(gl_upload_ring_t *ring);
+
+/**
+ * gl_upload_ring_submit:
+ * @ring                      : Upload ring
+ *
+ * Call after the upload reading the current buffer. Fences the
+ * buffer, unbinds GL_PIXEL_UNPACK_BUFFER and moves to the next.
+ **/
+void gl_upload_ring_submit(gl_upload_ring_t *ring);
+
+void gl_upload_ring_free(gl_upload_ring_t *ring);
+
+/**
+ * gl_upload_ring_supported:
+ *
+ * Tells whether the current context has a real GPU behind it.
+ * Software rasterizers copy out of client memory anyway, so
+ * the ring only costs them an extra copy.
+ *
+ * Returns: false (0) on a software rasterizer, otherwise true (1).
+ **/
+bool gl_upload_ring_supported(void);
+#endif
+
 #endif
@@ -25,6 +25,7 @@
 #include <errno.h>
 
 #include <compat/strl.h>
+#include <retro_miscellaneous.h>
 #include <rthreads/rthreads.h>
 #include <string/stdstring.h>
 
@@ -70,6 +71,11 @@ struct drm_rect
 struct drm_page
 {
    struct modeset_buf buf;
+
+   /* What changed in the frame since this page got its last
+    * copy of it. Nothing if width or height is 0. */
+   struct drm_rect dirty;
+
    bool used;
 
    /* Each page has it's own mutex for
@@ -253,6 +259,10 @@ static void drm_surface_setup(void *data,  int src_width, int src_height,
       surface->pages[i].surface         = surface;
       surface->pages[i].drmvars         = _drmvars;
       surface->pages[i].page_used_mutex = slock_new();
+      surface->pages[i].dirty.x         = 0;
+      surface->pages[i].dirty.y         = 0;
+      surface->pages[i].dirty.width     = src_width;
+      surface->pages[i].dirty.height    = src_height;
    }
 
    /* Create the framebuffer for each one of the pages of the surface. */
@@ -313,24 +323,95 @@ static void drm_page_flip(struct drm_surface *surface)
    drmModeAtomicFree(req);
 }
 
+/* Adds the part of @x, @y, @width, @height on the
+ * surface to the region of every page that is behind. */
+static void drm_surface_add_dirty(struct drm_surface *surface,
+      int x, int y, int width, int height)
+{
+   unsigned i;
+
+   if (x >= surface->src_width || y >= surface->src_height)
+      return;
+   width  = MIN(width,  surface->src_width  - x);
+   height = MIN(height, surface->src_height - y);
+
+   for (i = 0; i < surface->numpages; i++)
+   {
+      struct drm_rect *dirty = &surface->pages[i].dirty;
+      int right, bottom;
+
+      if (!dirty->width || !dirty->height)
+      {
+         dirty->x      = x;
+         dirty->y      = y;
+         dirty->width  = width;
+         dirty->height = height;
+         continue;
+      }
+
+      right          = MAX(dirty->x + dirty->width,  x + width);
+      bottom         = MAX(dirty->y + dirty->height, y + height);
+      dirty->x       = MIN(dirty->x, x);
+      dirty->y       = MIN(dirty->y, y);
+      dirty->width   = right  - dirty->x;
+      dirty->height  = bottom - dirty->y;
+   }
+}
+
+/* @damage is what changed in @frame, in @num_damage
+ * rectangles. If NULL, all of it may have. */
 static void drm_surface_update(void *data, const void *frame,
-      struct drm_surface *surface)
+      struct drm_surface *surface,
+      const struct frame_diff_rect *damage, unsigned num_damage)
 {
+   unsigned i;
    struct drm_video *_drmvars  = data;
-   struct drm_page       *page = NULL;
+   struct drm_page       *page = &surface->pages[surface->flip_page];
+   struct drm_rect      *dirty = &page->dirty;
    /* Frame blitting */
    int line                    = 0;
    int src_offset              = 0;
    int dst_offset              = 0;
 
-   for (line = 0; line < surface->src_height; line++)
+   if (!damage)
+      drm_surface_add_dirty(surface, 0, 0,
+            surface->src_width, surface->src_height);
+   else
+      for (i = 0; i < num_damage; i++)
+         drm_surface_add_dirty(surface, damage[i].x, damage[i].y,
+               damage[i].width, damage[i].height);
+
+   /* The page to be shown gets everything it is behind
+    * by at once, the frame is newer than all of it */
+   if (dirty->width && dirty->height)
    {
-      memcpy (
-            surface->pages[surface->flip_page].buf.map + dst_offset,
-            (uint8_t*)frame + src_offset,
-            surface->pitch);
-      src_offset += surface->total_pitch;
-      dst_offset += surface->pitch;
+      drmModeClip clip;
+
+      src_offset = dirty->y * surface->total_pitch
+         + dirty->x * surface->bpp;
+      dst_offset = dirty->y * surface->pitch
+         + dirty->x * surface->bpp;
+
+      for (line = 0; line < dirty->height; line++)
+      {
+         memcpy (
+               page->buf.map + dst_offset,
+               (uint8_t*)frame + src_offset,
+               dirty->width * surface->bpp);
+         src_offset += surface->total_pitch;
+         dst_offset += surface->pitch;
+      }
+
+      /* Only displays that are not refreshed from the buffer
+       * on their own need this, the others do not implement it */
+      clip.x1 = dirty->x;
+      clip.y1 = dirty->y;
+      clip.x2 = dirty->x + dirty->width;
+      clip.y2 = dirty->y + dirty->height;
+      drmModeDirtyFB(drm.fd, page->buf.fb_id, &clip, 1);
+
+      dirty->width  = 0;
+      dirty->height = 0;
    }
 
    /* Page flipping */
@@ -798,7 +879,9 @@ static bool drm_gfx_frame(void *data, const void *frame, unsigned width,
 #endif
 
    /* Update main surface: locate free page, blit and flip. */
-   drm_surface_update(_drmvars, frame, _drmvars->main_surface);
+   if (frame)
+      drm_surface_update(_drmvars, frame, _drmvars->main_surface,
+            video_info->damage, video_info->damage_count);
    return true;
 }
 
@@ -877,7 +960,8 @@ static void drm_set_texture_frame(void *data, const void *frame, bool rgb32,
    }
 
    /* We update the menu surface if menu is active. */
-   drm_surface_update(_drmvars, frame_output, _drmvars->menu_surface);
+   drm_surface_update(_drmvars, frame_output, _drmvars->menu_surface,
+         NULL, 0);
 }
 
 static void drm_gfx_set_nonblock_state(void *a, bool b, bool c, unsigned d) { }
@@ -935,8 +1019,17 @@ static void drm_set_aspect_ratio (void *data, unsigned aspect_ratio_idx)
    }
 }
 
+static uint32_t drm_get_flags(void *data)
+{
+   uint32_t flags = 0;
+
+   BIT32_SET(flags, GFX_CTX_FLAGS_FRAME_DAMAGE);
+
+   return flags;
+}
+
 static const video_poke_interface_t drm_poke_interface = {
-   NULL, /* get_flags */
+   drm_get_flags,
    NULL,
    NULL,
    NULL, /* set_video_mode */
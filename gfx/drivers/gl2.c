@@ -1401,6 +1401,26 @@ error:
    glDisable(GL_DITHER)
 #endif
 
+#ifdef HAVE_GL_UPLOAD_RING
+/* Maps the next upload buffer for a frame of @size bytes.
+ * Returns NULL when the frame has to come from client memory. */
+static uint8_t *gl2_upload_ring_map(gl2_t *gl, size_t size)
+{
+   if (!gl->upload_ring_enable)
+      return NULL;
+
+   if (!gl_upload_ring_reserve(&gl->upload_ring, size))
+   {
+      RARCH_WARN("[GL]: Failed to create upload PBOs, "
+            "uploading from client memory.\n");
+      gl->upload_ring_enable = false;
+      return NULL;
+   }
+
+   return gl_upload_ring_map(&gl->upload_ring);
+}
+#endif
+
 static void gl2_renderchain_copy_frame(
       gl2_t *gl,
       gl2_renderchain_data_t *chain,
@@ -1504,10 +1524,19 @@ static void gl2_renderchain_copy_frame(
 #else
    {
       const GLvoid *data_buf = frame;
-      glPixelStorei(GL_UNPACK_ALIGNMENT, gl2_get_alignment(pitch));
+#ifdef HAVE_GL_UPLOAD_RING
+      uint8_t *staged        = NULL;
+#endif
 
       if (gl->base_size == 2 && !gl->have_es2_compat)
       {
+         void *conv_buffer   = gl->conv_buffer;
+#ifdef HAVE_GL_UPLOAD_RING
+         if ((staged = gl2_upload_ring_map(gl,
+                     (size_t)width * height * sizeof(uint32_t))))
+            conv_buffer      = staged;
+#endif
+
          /* Convert to 32-bit textures on desktop GL.
           *
           * It is *much* faster (order of magnitude on my setup)
@@ -1515,20 +1544,56 @@ static void gl2_renderchain_copy_frame(
           * than letting GL do it. */
          video_frame_convert_rgb16_to_rgb32(
                &gl->scaler,
-               gl->conv_buffer,
+               conv_buffer,
                frame,
                width,
                height,
                pitch);
-         data_buf = gl->conv_buffer;
+         data_buf = conv_buffer;
       }
       else
+      {
+#ifdef HAVE_GL_UPLOAD_RING
+         unsigned line_bytes = width * gl->base_size;
+
+         /* The core may have rendered straight into the
+          * buffer, see gl2_get_current_software_framebuffer() */
+         if (     (staged = gl2_upload_ring_map(gl,
+                     (size_t)line_bytes * height))
+               && staged != frame)
+         {
+            unsigned h;
+            uint8_t *dst       = staged;
+            const uint8_t *src = (const uint8_t*)frame;
+
+            for (h = 0; h < height; h++, src += pitch, dst += line_bytes)
+               memcpy(dst, src, line_bytes);
+            pitch = line_bytes;
+         }
+#endif
          glPixelStorei(GL_UNPACK_ROW_LENGTH, pitch / gl->base_size);
+      }
+
+      glPixelStorei(GL_UNPACK_ALIGNMENT, gl2_get_alignment(pitch));
+
+#ifdef HAVE_GL_UPLOAD_RING
+      /* Upload from offset 0 of the bound buffer */
+      if (staged)
+      {
+         gl_upload_ring_bind(&gl->upload_ring);
+         data_buf = NULL;
+      }
+#endif
 
       glTexSubImage2D(GL_TEXTURE_2D,
             0, 0, 0, width, height, gl->texture_type,
             gl->texture_fmt, data_buf);
 
+#ifdef HAVE_GL_UPLOAD_RING
+      if (staged)
+         gl_upload_ring_submit(&gl->upload_ring);
+#endif
+
       glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
    }
 #endif
@@ -3227,6 +3292,10 @@ static void gl2_free(void *data)
       scaler_ctx_gen_reset(&gl->pbo_readback_scaler);
    }
 
+#ifdef HAVE_GL_UPLOAD_RING
+   gl_upload_ring_free(&gl->upload_ring);
+#endif
+
 #ifndef HAVE_OPENGLES
    if (gl->core_context_in_use)
    {
@@ -3297,6 +3366,20 @@ static bool gl2_resolve_extensions(gl2_t *gl, const char *context_ident, const v
    if (gl->have_sync && video_hard_sync)
       RARCH_LOG("[GL]: Using ARB_sync to reduce latency.\n");
 
+#ifdef HAVE_GL_UPLOAD_RING
+   gl_upload_ring_init(&gl->upload_ring,
+            gl->have_sync
+         && gl_check_capability(GL_CAPS_BUFFER_STORAGE),
+         gl_check_capability(GL_CAPS_MAP_BUFFER_RANGE));
+   gl->upload_ring_enable        = settings->bools.video_upload_ring
+         && gl_check_capability(GL_CAPS_PBO)
+         && gl_upload_ring_supported();
+
+   if (gl->upload_ring_enable)
+      RARCH_LOG("[GL]: Streaming frames through %s PBOs.\n",
+            gl->upload_ring.persistent ? "persistently mapped" : "orphaned");
+#endif
+
    video_driver_unset_rgba();
 
    gl2_renderchain_resolve_extensions(gl,
@@ -4589,6 +4672,55 @@ static uint32_t gl2_get_flags(void *data)
    return flags;
 }
 
+#ifdef HAVE_GL_UPLOAD_RING
+/* Lets the core render into the next upload buffer, so
+ * gl2_renderchain_copy_frame() has nothing left to copy.
+ * Only persistently mapped buffers stay valid long enough. */
+static bool gl2_get_current_software_framebuffer(void *data,
+      struct retro_framebuffer *framebuffer)
+{
+   size_t pitch;
+   uint8_t *dst                   = NULL;
+   gl2_t *gl                      = (gl2_t*)data;
+   video_driver_state_t *video_st = video_state_get_ptr();
+   enum retro_pixel_format fmt    = RETRO_PIXEL_FORMAT_RGB565;
+
+   if (     !gl
+         || !gl->upload_ring_enable
+         || !gl->upload_ring.persistent
+         || gl->hw_render_use
+         || video_st->state_filter)
+      return false;
+
+   /* 16-bit frames are converted to 32 bits
+    * without GL_RGB565 support */
+   if (gl->base_size == 2 && !gl->have_es2_compat)
+      return false;
+
+   if (gl->base_size == 4)
+      fmt = RETRO_PIXEL_FORMAT_XRGB8888;
+
+   /* 0RGB1555 frames get converted before they reach us */
+   if (video_st->pix_fmt != fmt)
+      return false;
+
+   pitch = framebuffer->width * gl->base_size;
+
+   if (gl_upload_ring_reserve(&gl->upload_ring,
+            pitch * framebuffer->height))
+      dst = gl_upload_ring_map(&gl->upload_ring);
+
+   if (!dst)
+      return false;
+
+   framebuffer->data         = dst;
+   framebuffer->pitch        = pitch;
+   framebuffer->format       = fmt;
+   framebuffer->memory_flags = 0;
+   return true;
+}
+#endif
+
 static const video_poke_interface_t gl2_poke_interface = {
    gl2_get_flags,
    gl2_load_texture,
@@ -4609,7 +4741,11 @@ static const video_poke_interface_t gl2_poke_interface = {
    gl2_show_mouse,
    NULL,
    gl2_get_current_shader,
+#ifdef HAVE_GL_UPLOAD_RING
+   gl2_get_current_software_framebuffer,
+#else
    NULL,                      /* get_current_software_framebuffer */
+#endif
    NULL,                      /* get_hw_render_interface */
    NULL,                      /* set_hdr_max_nits */
    NULL,                      /* set_hdr_paper_white_nits */
@@ -583,6 +583,9 @@ static void gl3_destroy_resources(gl3_t *gl)
 #endif
    gl3_deinit_fences(gl);
    gl3_deinit_pbo_readback(gl);
+#ifdef HAVE_GL_UPLOAD_RING
+   gl_upload_ring_free(&gl->upload_ring);
+#endif
    gl3_deinit_hw_render(gl);
 }
 
@@ -1329,6 +1332,20 @@ static void *gl3_init(const video_info_t *video,
       RARCH_LOG("[GLCore]: Async PBO readback enabled.\n");
    }
 
+#ifdef HAVE_GL_UPLOAD_RING
+   gl_upload_ring_init(&gl->upload_ring,
+            gl_check_capability(GL_CAPS_BUFFER_STORAGE)
+         && gl_check_capability(GL_CAPS_SYNC),
+         true);
+   gl->upload_ring_enable =  settings->bools.video_upload_ring
+         && !gl->hw_render_enable
+         && gl_upload_ring_supported();
+
+   if (gl->upload_ring_enable)
+      RARCH_LOG("[GLCore]: Streaming frames through %s PBOs.\n",
+            gl->upload_ring.persistent ? "persistently mapped" : "orphaned");
+#endif
+
    if (!gl_check_error(&error_string))
    {
       RARCH_ERR("%s\n", error_string);
@@ -1748,10 +1765,56 @@ error:
    return false;
 }
 
+#ifdef HAVE_GL_UPLOAD_RING
+/* Puts the frame in the next upload buffer, unless the core
+ * rendered straight into it, and binds that buffer.
+ * Returns false when the frame has to come from client memory. */
+static bool gl3_upload_ring_stage(gl3_t *gl,
+      const void *frame, unsigned width, unsigned height,
+      unsigned *pitch)
+{
+   uint8_t *dst;
+   unsigned bpp         = gl->video_info.rgb32 ? 4 : 2;
+   unsigned line_bytes  = width * bpp;
+
+   if (!gl->upload_ring_enable)
+      return false;
+
+   if (!gl_upload_ring_reserve(&gl->upload_ring,
+            (size_t)line_bytes * height))
+   {
+      RARCH_WARN("[GLCore]: Failed to create upload PBOs, "
+            "uploading from client memory.\n");
+      gl->upload_ring_enable = false;
+      return false;
+   }
+
+   if (!(dst = gl_upload_ring_map(&gl->upload_ring)))
+      return false;
+
+   if (frame != dst)
+   {
+      unsigned h;
+      const uint8_t *src = (const uint8_t*)frame;
+
+      for (h = 0; h < height; h++, src += *pitch, dst += line_bytes)
+         memcpy(dst, src, line_bytes);
+      *pitch = line_bytes;
+   }
+
+   gl_upload_ring_bind(&gl->upload_ring);
+   return true;
+}
+#endif
+
 static void gl3_update_cpu_texture(gl3_t *gl,
                                        struct gl3_streamed_texture *streamed,
                                        const void *frame, unsigned width, unsigned height, unsigned pitch)
 {
+#ifdef HAVE_GL_UPLOAD_RING
+   bool staged = false;
+#endif
+
    if (width != streamed->width || height != streamed->height)
    {
       if (streamed->tex != 0)
@@ -1772,7 +1835,14 @@ static void gl3_update_cpu_texture(gl3_t *gl,
    else
       glBindTexture(GL_TEXTURE_2D, streamed->tex);
 
-   glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+#ifdef HAVE_GL_UPLOAD_RING
+   /* The upload then reads from offset 0 of the bound buffer */
+   if ((staged = gl3_upload_ring_stage(gl, frame, width, height, &pitch)))
+      frame = NULL;
+   else
+#endif
+      glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+
    if (gl->video_info.rgb32)
    {
       glPixelStorei(GL_UNPACK_ROW_LENGTH, pitch >> 2);
@@ -1787,6 +1857,11 @@ static void gl3_update_cpu_texture(gl3_t *gl,
       glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0,
                       width, height, GL_RGB, GL_UNSIGNED_SHORT_5_6_5, frame);
    }
+
+#ifdef HAVE_GL_UPLOAD_RING
+   if (staged)
+      gl_upload_ring_submit(&gl->upload_ring);
+#endif
 }
 
 #if defined(HAVE_MENU)
@@ -2270,6 +2345,50 @@ static retro_proc_address_t gl3_get_proc_address(
    return NULL;
 }
 
+#ifdef HAVE_GL_UPLOAD_RING
+/* Lets the core render into the next upload buffer, so
+ * gl3_update_cpu_texture() has nothing left to copy.
+ * Only persistently mapped buffers stay valid long enough. */
+static bool gl3_get_current_software_framebuffer(void *data,
+      struct retro_framebuffer *framebuffer)
+{
+   size_t pitch;
+   uint8_t *dst                   = NULL;
+   gl3_t *gl                      = (gl3_t*)data;
+   video_driver_state_t *video_st = video_state_get_ptr();
+   enum retro_pixel_format fmt    = RETRO_PIXEL_FORMAT_RGB565;
+
+   if (     !gl
+         || !gl->upload_ring_enable
+         || !gl->upload_ring.persistent
+         || gl->hw_render_enable
+         || video_st->state_filter)
+      return false;
+
+   if (gl->video_info.rgb32)
+      fmt = RETRO_PIXEL_FORMAT_XRGB8888;
+
+   /* 0RGB1555 frames get converted before they reach us */
+   if (video_st->pix_fmt != fmt)
+      return false;
+
+   pitch = framebuffer->width * (gl->video_info.rgb32 ? 4 : 2);
+
+   if (gl_upload_ring_reserve(&gl->upload_ring,
+            pitch * framebuffer->height))
+      dst = gl_upload_ring_map(&gl->upload_ring);
+
+   if (!dst)
+      return false;
+
+   framebuffer->data         = dst;
+   framebuffer->pitch        = pitch;
+   framebuffer->format       = fmt;
+   framebuffer->memory_flags = 0;
+   return true;
+}
+#endif
+
 static const video_poke_interface_t gl3_poke_interface = {
    gl3_get_flags,
    gl3_load_texture,
@@ -2290,7 +2409,11 @@ static const video_poke_interface_t gl3_poke_interface = {
    gl3_show_mouse,
    NULL,                               /* grab_mouse_toggle */
    gl3_get_current_shader,
+#ifdef HAVE_GL_UPLOAD_RING
+   gl3_get_current_software_framebuffer,
+#else
    NULL,
+#endif
    NULL,
    NULL, /* set_hdr_max_nits */
    NULL, /* set_hdr_paper_white_nits */
@@ -19,6 +19,7 @@
 #include <string.h>
 
 #include <retro_inline.h>
+#include <retro_miscellaneous.h>
 #include <gfx/scaler/scaler.h>
 
 #ifdef HAVE_CONFIG_H
@@ -281,7 +282,8 @@ static void sdl_refresh_viewport(sdl2_video_t *vid)
    sdl_refresh_renderer(vid);
 }
 
-static void sdl_refresh_input_size(sdl2_video_t *vid, bool menu, bool rgb32,
+/* Returns true if the texture was created anew, without content */
+static bool sdl_refresh_input_size(sdl2_video_t *vid, bool menu, bool rgb32,
       unsigned width, unsigned height, unsigned pitch)
 {
    sdl2_tex_t *target = menu ? &vid->menu : &vid->frame;
@@ -309,7 +311,7 @@ static void sdl_refresh_input_size(sdl2_video_t *vid, bool menu, bool rgb32,
       {
          RARCH_ERR("[SDL2]: Failed to create %s texture: %s\n", menu ? "menu" : "main",
                    SDL_GetError());
-         return;
+         return false;
       }
 
       if (menu)
@@ -325,7 +327,10 @@ static void sdl_refresh_input_size(sdl2_video_t *vid, bool menu, bool rgb32,
        * sdl2_poke_texture_enable()) */
       if (!menu)
          target->active = true;
+      return true;
    }
+
+   return false;
 }
 
 static void *sdl2_gfx_init(const video_info_t *video,
@@ -485,9 +490,33 @@ static bool sdl2_gfx_frame(void *data, const void *frame, unsigned width,
 
    if (frame)
    {
+      const struct frame_diff_rect *damage = video_info->damage;
+
       SDL_RenderClear(vid->renderer);
-      sdl_refresh_input_size(vid, false, vid->video.rgb32, width, height, pitch);
-      SDL_UpdateTexture(vid->frame.tex, NULL, frame, pitch);
+      if (sdl_refresh_input_size(vid, false, vid->video.rgb32,
+               width, height, pitch))
+         damage = NULL;
+
+      if (!damage)
+         SDL_UpdateTexture(vid->frame.tex, NULL, frame, pitch);
+      else
+      {
+         /* The texture still holds the previous frame */
+         unsigned i;
+         unsigned bpp = vid->video.rgb32 ? 4 : 2;
+
+         for (i = 0; i < video_info->damage_count; i++)
+         {
+            SDL_Rect rect;
+            rect.x = damage[i].x;
+            rect.y = damage[i].y;
+            rect.w = damage[i].width;
+            rect.h = damage[i].height;
+            SDL_UpdateTexture(vid->frame.tex, &rect,
+                  (const uint8_t*)frame + damage[i].y * pitch
+                  + damage[i].x * bpp, pitch);
+         }
+      }
    }
 
    SDL_RenderCopyEx(vid->renderer, vid->frame.tex, NULL, NULL, vid->rotation, NULL, SDL_FLIP_NONE);
@@ -682,7 +711,14 @@ static void sdl2_grab_mouse_toggle(void *data)
    sdl2_video_t *vid = (sdl2_video_t*)data;
    SDL_SetWindowGrab(vid->window, SDL_GetWindowGrab(vid->window));
 }
-static uint32_t sdl2_get_flags(void *data) { return 0; }
+static uint32_t sdl2_get_flags(void *data)
+{
+   uint32_t flags = 0;
+
+   BIT32_SET(flags, GFX_CTX_FLAGS_FRAME_DAMAGE);
+
+   return flags;
+}
 
 static video_poke_interface_t sdl2_video_poke_interface = {
    sdl2_get_flags,
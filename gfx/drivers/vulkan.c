@@ -27,6 +27,9 @@
 #include <retro_math.h>
 #include <retro_assert.h>
 #include <string/stdstring.h>
+#include <file/file_path.h>
+#include <streams/file_stream.h>
+#include <encodings/crc32.h>
 #include <libretro.h>
 
 #ifdef HAVE_CONFIG_H
@@ -52,6 +55,7 @@
 
 #include "../../retroarch.h"
 #include "../../verbosity.h"
+#include "../../file_path_special.h"
 #include "../../record/record_driver.h"
 
 #include "../video_coord_array.h"
@@ -1035,10 +1039,148 @@ static void vulkan_init_resources(vk_t *vk)
    vulkan_init_command_buffers(vk);
 }
 
+#define VULKAN_PIPELINE_CACHE_VERSION 1
+
+/* Precedes the pipeline cache data on disk. Drivers should
+ * reject data written by another driver or GPU themselves,
+ * not all of them get it right. */
+typedef struct
+{
+   char magic[4];
+   uint32_t version;
+   uint32_t vendor_id;
+   uint32_t device_id;
+   uint32_t driver_version;
+   uint8_t uuid[VK_UUID_SIZE];
+   uint32_t data_size;
+   uint32_t data_crc;
+} vulkan_pipeline_cache_header_t;
+
+static void vulkan_pipeline_cache_header(vk_t *vk,
+      vulkan_pipeline_cache_header_t *header)
+{
+   const VkPhysicalDeviceProperties *props = &vk->context->gpu_properties;
+
+   memset(header, 0, sizeof(*header));
+   memcpy(header->magic, "RAPC", 4);
+   header->version        = VULKAN_PIPELINE_CACHE_VERSION;
+   header->vendor_id      = props->vendorID;
+   header->device_id      = props->deviceID;
+   header->driver_version = props->driverVersion;
+   memcpy(header->uuid, props->pipelineCacheUUID, VK_UUID_SIZE);
+}
+
+static bool vulkan_pipeline_cache_path(vk_t *vk, char *s, size_t len)
+{
+   char dir[PATH_MAX_LENGTH];
+   char name[64];
+   const VkPhysicalDeviceProperties *props = &vk->context->gpu_properties;
+
+   dir[0] = '\0';
+   fill_pathname_application_special(dir, sizeof(dir),
+         APPLICATION_SPECIAL_DIRECTORY_CACHE);
+
+   if (string_is_empty(dir))
+      return false;
+
+   /* One file per GPU, so switching between them
+    * does not throw the other one's cache away */
+   snprintf(name, sizeof(name), "vulkan_pipelines_%04x_%04x.bin",
+         (unsigned)props->vendorID, (unsigned)props->deviceID);
+   fill_pathname_join(s, dir, name, len);
+   return true;
+}
+
+/* Returns the file contents, the pipeline cache
+ * data follows the header. NULL if there is no usable
+ * pipeline cache for this GPU and driver. */
+static uint8_t *vulkan_load_pipeline_cache(vk_t *vk, size_t *size)
+{
+   char path[PATH_MAX_LENGTH];
+   vulkan_pipeline_cache_header_t expected;
+   vulkan_pipeline_cache_header_t header;
+   void *buf   = NULL;
+   int64_t len = 0;
+
+   if (     !vulkan_pipeline_cache_path(vk, path, sizeof(path))
+         || !path_is_valid(path)
+         || !filestream_read_file(path, &buf, &len))
+      return NULL;
+
+   vulkan_pipeline_cache_header(vk, &expected);
+
+   if (len >= (int64_t)sizeof(header))
+   {
+      memcpy(&header, buf, sizeof(header));
+      expected.data_size = header.data_size;
+      expected.data_crc  = header.data_crc;
+
+      if (     !memcmp(&header, &expected, sizeof(header))
+            && header.data_size == len - sizeof(header)
+            && encoding_crc32(0, (const uint8_t*)buf + sizeof(header),
+               header.data_size) == header.data_crc)
+      {
+         RARCH_LOG("[Vulkan]: Loaded pipeline cache (%u KB).\n",
+               (unsigned)(header.data_size >> 10));
+         *size = header.data_size;
+         return (uint8_t*)buf;
+      }
+   }
+
+   RARCH_LOG("[Vulkan]: Pipeline cache is corrupt or for another GPU or driver, discarding it.\n");
+   free(buf);
+   return NULL;
+}
+
+static void vulkan_save_pipeline_cache(vk_t *vk)
+{
+   char path[PATH_MAX_LENGTH];
+   char tmp_path[PATH_MAX_LENGTH];
+   vulkan_pipeline_cache_header_t header;
+   uint8_t *buf = NULL;
+   size_t size  = 0;
+   bool saved   = false;
+
+   if (     vk->pipelines.cache == VK_NULL_HANDLE
+         || !vulkan_pipeline_cache_path(vk, path, sizeof(path))
+         || vkGetPipelineCacheData(vk->context->device,
+               vk->pipelines.cache, &size, NULL) != VK_SUCCESS
+         || !size)
+      return;
+
+   if (!(buf = (uint8_t*)malloc(sizeof(header) + size)))
+      return;
+
+   if (vkGetPipelineCacheData(vk->context->device, vk->pipelines.cache,
+            &size, buf + sizeof(header)) == VK_SUCCESS)
+   {
+      vulkan_pipeline_cache_header(vk, &header);
+      header.data_size = (uint32_t)size;
+      header.data_crc  = encoding_crc32(0, buf + sizeof(header), size);
+      memcpy(buf, &header, sizeof(header));
+
+      /* Never leave a truncated cache behind */
+      strlcpy(tmp_path, path, sizeof(tmp_path));
+      strlcat(tmp_path, ".tmp", sizeof(tmp_path));
+      if (filestream_write_file(tmp_path, buf, sizeof(header) + size))
+      {
+         filestream_delete(path);
+         saved = filestream_rename(tmp_path, path) == 0;
+      }
+   }
+
+   free(buf);
+
+   if (!saved)
+      RARCH_WARN("[Vulkan]: Failed to save pipeline cache to \"%s\".\n", path);
+}
+
 static void vulkan_init_static_resources(vk_t *vk)
 {
    unsigned i;
    uint32_t blank[4 * 4];
+   uint8_t *cache_data               = NULL;
+   size_t cache_size                 = 0;
    VkCommandPoolCreateInfo pool_info = {
       VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO };
 
@@ -1051,8 +1193,25 @@ static void vulkan_init_static_resources(vk_t *vk)
    if (!vk->context)
       return;
 
-   vkCreatePipelineCache(vk->context->device,
-         &cache, NULL, &vk->pipelines.cache);
+   /* Start with the pipelines of the last session */
+   if ((cache_data = vulkan_load_pipeline_cache(vk, &cache_size)))
+   {
+      cache.initialDataSize = cache_size;
+      cache.pInitialData    = cache_data
+         + sizeof(vulkan_pipeline_cache_header_t);
+   }
+
+   if (     vkCreatePipelineCache(vk->context->device,
+               &cache, NULL, &vk->pipelines.cache) != VK_SUCCESS
+         && cache_data)
+   {
+      cache.initialDataSize = 0;
+      cache.pInitialData    = NULL;
+      vkCreatePipelineCache(vk->context->device,
+            &cache, NULL, &vk->pipelines.cache);
+   }
+
+   free(cache_data);
 
    pool_info.queueFamilyIndex = vk->context->graphics_queue_index;
 
@@ -1070,6 +1229,7 @@ static void vulkan_init_static_resources(vk_t *vk)
 static void vulkan_deinit_static_resources(vk_t *vk)
 {
    unsigned i;
+   vulkan_save_pipeline_cache(vk);
    vkDestroyPipelineCache(vk->context->device,
          vk->pipelines.cache, NULL);
    vulkan_destroy_texture(
@@ -1628,6 +1788,9 @@ static bool vulkan_set_shader(void *data,
       return false;
    }
 
+   /* Keep the new pipelines even if the session
+    * does not end cleanly */
+   vulkan_save_pipeline_cache(vk);
    return true;
 }
 
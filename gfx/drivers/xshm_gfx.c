@@ -24,6 +24,8 @@
 #include <X11/Xutil.h>
 #include <X11/extensions/XShm.h>
 
+#include <retro_miscellaneous.h>
+
 #ifdef HAVE_CONFIG_H
 #include "../../config.h"
 #endif
@@ -37,10 +39,15 @@
 #include "../common/x11_common.h"
 #include "../../verbosity.h"
 
+/* Frames between two full puts while only damage is put,
+ * so that the window recovers from being drawn over */
+#define XSHM_FULL_PUT_INTERVAL 60
+
 typedef struct xshm
 {
    int width;
    int height;
+   unsigned since_full_put;
    bool use_shm;
    uint8_t *fbptr;
 
@@ -108,6 +115,7 @@ static void *xshm_gfx_init(const video_info_t *video,
 
    xshm->width = video->width;
    xshm->height = video->height;
+   xshm->since_full_put = 0;
 
    if (!x11_input_ctx_new(true))
       goto error;
@@ -132,30 +140,86 @@ static void *xshm_gfx_init(const video_info_t *video,
    return NULL;
 }
 
+/* Clips a damaged rectangle to the image.
+ * Returns false if nothing of it is left. */
+static bool xshm_clip_damage(const xshm_t *xshm,
+      const struct frame_diff_rect *rect, unsigned *w, unsigned *h)
+{
+   if (     rect->x >= (unsigned)xshm->width
+         || rect->y >= (unsigned)xshm->height)
+      return false;
+   *w = MIN(rect->width,  xshm->width  - rect->x);
+   *h = MIN(rect->height, xshm->height - rect->y);
+   return true;
+}
+
 static bool xshm_gfx_frame(void *data, const void *frame, unsigned width,
       unsigned height, uint64_t frame_count,
       unsigned pitch, const char *msg, video_frame_info_t *video_info)
 {
-   unsigned y;
+   unsigned i, y, w, h;
    xshm_t      *xshm  = (xshm_t*)data;
+   const struct frame_diff_rect
+      *damage         = video_info->damage;
 #ifdef HAVE_MENU
    bool menu_is_alive = video_info->menu_is_alive;
 #endif
 
-   for (y = 0; y < height; y++)
-      memcpy(xshm->fbptr + sizeof(uint32_t)*xshm->width*y,
-            (uint8_t*)frame + pitch*y, pitch);
+   /* A duped frame changes nothing */
+   if (!frame)
+      return true;
+
+   if (!damage)
+      for (y = 0; y < height; y++)
+         memcpy(xshm->fbptr + sizeof(uint32_t)*xshm->width*y,
+               (uint8_t*)frame + pitch*y, pitch);
+   else
+   {
+      /* The image still holds the previous frame,
+       * only what changed is copied over it */
+      for (i = 0; i < video_info->damage_count; i++)
+      {
+         if (!xshm_clip_damage(xshm, &damage[i], &w, &h))
+            continue;
+         for (y = damage[i].y; y < damage[i].y + h; y++)
+            memcpy(xshm->fbptr
+                  + sizeof(uint32_t) * (xshm->width * y + damage[i].x),
+                  (const uint8_t*)frame + pitch * y
+                  + sizeof(uint32_t) * damage[i].x,
+                  sizeof(uint32_t) * w);
+      }
+   }
 
 #ifdef HAVE_MENU
    menu_driver_frame(menu_is_alive, video_info);
 #endif
 
-   if (xshm->use_shm)
-      XShmPutImage(g_x11_dpy, g_x11_win, xshm->gc, xshm->image,
-		   0, 0, 0, 0, xshm->width, xshm->height, False);
+   if (!damage || ++xshm->since_full_put >= XSHM_FULL_PUT_INTERVAL)
+   {
+      xshm->since_full_put = 0;
+      if (xshm->use_shm)
+         XShmPutImage(g_x11_dpy, g_x11_win, xshm->gc, xshm->image,
+               0, 0, 0, 0, xshm->width, xshm->height, False);
+      else
+         XPutImage(g_x11_dpy, g_x11_win, xshm->gc, xshm->image,
+               0, 0, 0, 0, xshm->width, xshm->height);
+   }
    else
-      XPutImage(g_x11_dpy, g_x11_win, xshm->gc, xshm->image,
-		0, 0, 0, 0, xshm->width, xshm->height);
+   {
+      for (i = 0; i < video_info->damage_count; i++)
+      {
+         if (!xshm_clip_damage(xshm, &damage[i], &w, &h))
+            continue;
+         if (xshm->use_shm)
+            XShmPutImage(g_x11_dpy, g_x11_win, xshm->gc, xshm->image,
+                  damage[i].x, damage[i].y, damage[i].x, damage[i].y,
+                  w, h, False);
+         else
+            XPutImage(g_x11_dpy, g_x11_win, xshm->gc, xshm->image,
+                  damage[i].x, damage[i].y, damage[i].x, damage[i].y,
+                  w, h);
+      }
+   }
    XFlush(g_x11_dpy);
 
    return true;
@@ -180,8 +244,17 @@ static void xshm_poke_set_osd_msg(void *data,
 static void xshm_show_mouse(void *data, bool state) { }
 static void xshm_grab_mouse_toggle(void *data) { }
 
+static uint32_t xshm_get_flags(void *data)
+{
+   uint32_t flags = 0;
+
+   BIT32_SET(flags, GFX_CTX_FLAGS_FRAME_DAMAGE);
+
+   return flags;
+}
+
 static video_poke_interface_t xshm_video_poke_interface = {
-   NULL, /* get_flags */
+   xshm_get_flags,
    NULL,
    NULL,
    NULL,
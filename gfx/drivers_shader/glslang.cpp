@@ -28,6 +28,7 @@
 #include <iostream>
 #include <cstring>
 #include <cstdlib>
+#include <cstdio>
 #include <mutex>
 
 #include "../../verbosity.h"
@@ -45,26 +46,34 @@ struct SlangProcess
       TBuiltInResource Resources;
 };
 
-/* We don't use glslang from multiple threads, but to be sure.
- * Initializing TLS and freeing it for glslang works around 
+/* Initializing TLS and freeing it for glslang works around 
  * a really bizarre issue where the TLS key is suddenly 
- * corrupted *somehow*.
+ * corrupted *somehow*. glslang stays initialized while any
+ * thread is compiling, so that the passes of a preset can
+ * compile in parallel. Only setting up and tearing down
+ * is serialized, glslang does not guard all of it.
  */
 static std::mutex glslang_global_lock;
+static unsigned glslang_process_refs;
 
-struct SlangProcessHolder
+void glslang::acquire_process()
 {
-   SlangProcessHolder()
-   {
-      glslang_global_lock.lock();
+   std::lock_guard<std::mutex> holder(glslang_global_lock);
+   if (!glslang_process_refs++)
       InitializeProcess();
-   }
+}
 
-   ~SlangProcessHolder()
-   {
+void glslang::release_process()
+{
+   std::lock_guard<std::mutex> holder(glslang_global_lock);
+   if (!--glslang_process_refs)
       FinalizeProcess();
-      glslang_global_lock.unlock();
-   }
+}
+
+struct SlangProcessHolder
+{
+   SlangProcessHolder()  { glslang::acquire_process(); }
+   ~SlangProcessHolder() { glslang::release_process(); }
 };
 
 SlangProcess::SlangProcess()
@@ -457,3 +466,13 @@ bool glslang::compile_spirv(const string &source, Stage stage,
    GlslangToSpv(*program.getIntermediate(language), *spirv);
    return true;
 }
+
+string glslang::compiler_version()
+{
+   char generator[16];
+   string spirv_version;
+   GetSpirvVersion(spirv_version);
+   snprintf(generator, sizeof(generator), "%d", GetSpirvGeneratorVersion());
+   return string(GetGlslVersionString()) + " " + spirv_version
+      + " generator " + generator;
+}
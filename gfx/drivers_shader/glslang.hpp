@@ -18,6 +18,16 @@ namespace glslang
     };
 
     bool compile_spirv(const std::string &source, Stage stage, std::vector<uint32_t> *spirv);
+
+    /* Keeps glslang initialized between compile_spirv() calls.
+     * Otherwise its built-in symbol tables are set up again
+     * for every stage. */
+    void acquire_process();
+    void release_process();
+
+    /* Changes whenever compile_spirv could produce different SPIR-V
+     * for the same source. */
+    std::string compiler_version();
 }
 
 #endif
@@ -0,0 +1,446 @@
+/*  RetroArch - A frontend for libretro.
+ *  Copyright (C) 2010-2017 - Hans-Kristian Arntzen
+ *
+ *  RetroArch is free software: you can redistribute it and/or modify it under the terms
+ *  of the GNU General Public License as published by the Free Software Found-
+ *  ation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  RetroArch is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ *  without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ *  PURPOSE.  See the GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along with RetroArch.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <mutex>
+
+#include <lrc_hash.h>
+#include <file/file_path.h>
+#include <lists/dir_list.h>
+#include <streams/file_stream.h>
+#include <encodings/crc32.h>
+#include <string/stdstring.h>
+
+#include "glslang_util.h"
+#include "glslang_util_cxx.h"
+#include "glslang_cache.h"
+#include "../../verbosity.h"
+
+/* Bump when the layout of the payload changes,
+ * or when the same source compiles differently
+ * for reasons the key does not cover. */
+#define GLSLANG_CACHE_VERSION 1
+#define GLSLANG_CACHE_EXT     "slangc"
+
+/* Every entry is a single file:
+ *
+ *    "RASC", version, last used (seconds), payload size, payload CRC32
+ *    payload: vertex SPIR-V, fragment SPIR-V, rt_format, name, parameters
+ *
+ * Integers are in native byte order, the cache never
+ * leaves the machine that wrote it.
+ */
+struct glslang_cache_header
+{
+   char magic[4];
+   uint32_t version;
+   uint64_t last_used;
+   uint32_t payload_size;
+   uint32_t payload_crc;
+};
+
+struct glslang_cache_entry
+{
+   std::string path;
+   uint64_t last_used;
+   uint64_t size;
+};
+
+static std::mutex glslang_cache_lock;
+static std::string glslang_cache_dir;
+static uint64_t glslang_cache_max_size;
+/* Size of the cache as of the last scan,
+ * plus what was stored since. */
+static uint64_t glslang_cache_size;
+
+static void glslang_cache_entry_path(const char *key, std::string *path)
+{
+   *path  = glslang_cache_dir;
+   path->append("/");
+   path->append(key);
+   path->append("." GLSLANG_CACHE_EXT);
+}
+
+static bool glslang_cache_read_header(RFILE *file,
+      struct glslang_cache_header *header)
+{
+   if (filestream_read(file, header, sizeof(*header)) != sizeof(*header))
+      return false;
+   return memcmp(header->magic, "RASC", 4) == 0
+      && header->version == GLSLANG_CACHE_VERSION;
+}
+
+static bool glslang_cache_entry_older(const glslang_cache_entry &a,
+      const glslang_cache_entry &b)
+{
+   return a.last_used < b.last_used;
+}
+
+/* Removes the least recently used entries until the
+ * cache fits in its limit again. Expects the lock. */
+static void glslang_cache_evict(void)
+{
+   size_t i;
+   std::vector<glslang_cache_entry> entries;
+   struct string_list *list = dir_list_new(glslang_cache_dir.c_str(),
+         GLSLANG_CACHE_EXT "|tmp", false, true, false, false);
+
+   glslang_cache_size = 0;
+   if (!list)
+      return;
+
+   for (i = 0; i < list->size; i++)
+   {
+      struct glslang_cache_header header;
+      glslang_cache_entry entry;
+      const char *path = list->elems[i].data;
+      RFILE *file      = NULL;
+      bool valid       = false;
+
+      /* Leftovers of an interrupted store */
+      if (string_is_equal(path_get_extension(path), "tmp"))
+      {
+         filestream_delete(path);
+         continue;
+      }
+
+      if ((file = filestream_open(path, RETRO_VFS_FILE_ACCESS_READ,
+                  RETRO_VFS_FILE_ACCESS_HINT_NONE)))
+      {
+         valid      = glslang_cache_read_header(file, &header);
+         entry.size = (uint64_t)filestream_get_size(file);
+         filestream_close(file);
+      }
+
+      /* Written by another version, never used again */
+      if (!valid)
+      {
+         filestream_delete(path);
+         continue;
+      }
+
+      entry.path          = path;
+      entry.last_used     = header.last_used;
+      glslang_cache_size += entry.size;
+      entries.push_back(entry);
+   }
+
+   dir_list_free(list);
+
+   if (glslang_cache_size <= glslang_cache_max_size)
+      return;
+
+   std::sort(entries.begin(), entries.end(), glslang_cache_entry_older);
+
+   for (i = 0; i < entries.size()
+         && glslang_cache_size > glslang_cache_max_size; i++)
+   {
+      if (filestream_delete(entries[i].path.c_str()) == 0)
+         glslang_cache_size -= entries[i].size;
+   }
+
+   RARCH_LOG("[slang]: Shader cache trimmed to %u KB.\n",
+         (unsigned)(glslang_cache_size >> 10));
+}
+
+void glslang_cache_init(const char *dir, uint64_t max_size)
+{
+   std::lock_guard<std::mutex> holder(glslang_cache_lock);
+
+   glslang_cache_dir.clear();
+   glslang_cache_max_size = max_size;
+   glslang_cache_size     = 0;
+
+   if (string_is_empty(dir) || !max_size)
+      return;
+
+   if (!path_is_directory(dir) && !path_mkdir(dir))
+   {
+      RARCH_WARN("[slang]: Could not create shader cache directory \"%s\".\n",
+            dir);
+      return;
+   }
+
+   glslang_cache_dir = dir;
+   glslang_cache_evict();
+}
+
+void glslang_cache_key(const struct string_list *lines,
+      const char *compiler, char *key)
+{
+   size_t i;
+   char version[16];
+   std::string blob;
+
+   snprintf(version, sizeof(version), "%d\n", GLSLANG_CACHE_VERSION);
+   blob.append(version);
+   blob.append(compiler);
+   blob.append("\n");
+
+   for (i = 0; i < lines->size; i++)
+   {
+      blob.append(lines->elems[i].data);
+      blob.append("\n");
+   }
+
+   sha256_hash(key, (const uint8_t*)blob.data(), blob.size());
+}
+
+static void glslang_cache_put(std::vector<uint8_t> *out,
+      const void *data, size_t size)
+{
+   const uint8_t *bytes = (const uint8_t*)data;
+   out->insert(out->end(), bytes, bytes + size);
+}
+
+static void glslang_cache_put_u32(std::vector<uint8_t> *out, uint32_t value)
+{
+   glslang_cache_put(out, &value, sizeof(value));
+}
+
+static void glslang_cache_put_string(std::vector<uint8_t> *out,
+      const std::string &str)
+{
+   glslang_cache_put_u32(out, (uint32_t)str.size());
+   glslang_cache_put(out, str.data(), str.size());
+}
+
+static void glslang_cache_put_spirv(std::vector<uint8_t> *out,
+      const std::vector<uint32_t> &spirv)
+{
+   glslang_cache_put_u32(out, (uint32_t)spirv.size());
+   if (!spirv.empty())
+      glslang_cache_put(out, spirv.data(), spirv.size() * sizeof(uint32_t));
+}
+
+struct glslang_cache_reader
+{
+   const uint8_t *data;
+   size_t size;
+   size_t offset;
+};
+
+static bool glslang_cache_get(glslang_cache_reader *in,
+      void *data, size_t size)
+{
+   if (size > in->size - in->offset)
+      return false;
+   memcpy(data, in->data + in->offset, size);
+   in->offset += size;
+   return true;
+}
+
+static bool glslang_cache_get_u32(glslang_cache_reader *in, uint32_t *value)
+{
+   return glslang_cache_get(in, value, sizeof(*value));
+}
+
+static bool glslang_cache_get_string(glslang_cache_reader *in,
+      std::string *str)
+{
+   uint32_t len;
+   if (!glslang_cache_get_u32(in, &len) || len > in->size - in->offset)
+      return false;
+   str->assign((const char*)in->data + in->offset, len);
+   in->offset += len;
+   return true;
+}
+
+static bool glslang_cache_get_spirv(glslang_cache_reader *in,
+      std::vector<uint32_t> *spirv)
+{
+   uint32_t words;
+   if (!glslang_cache_get_u32(in, &words)
+         || words > (in->size - in->offset) / sizeof(uint32_t))
+      return false;
+   spirv->resize(words);
+   return !words
+      || glslang_cache_get(in, spirv->data(), words * sizeof(uint32_t));
+}
+
+static bool glslang_cache_parse(glslang_cache_reader *in,
+      glslang_output *output)
+{
+   uint32_t i, rt_format, count;
+
+   if (   !glslang_cache_get_spirv(in, &output->vertex)
+       || !glslang_cache_get_spirv(in, &output->fragment)
+       || !glslang_cache_get_u32(in, &rt_format)
+       || !glslang_cache_get_string(in, &output->meta.name)
+       || !glslang_cache_get_u32(in, &count))
+      return false;
+
+   output->meta.rt_format = (glslang_format)rt_format;
+   output->meta.parameters.clear();
+
+   for (i = 0; i < count; i++)
+   {
+      glslang_parameter param;
+
+      if (   !glslang_cache_get_string(in, &param.id)
+          || !glslang_cache_get_string(in, &param.desc)
+          || !glslang_cache_get(in, &param.initial, sizeof(float))
+          || !glslang_cache_get(in, &param.minimum, sizeof(float))
+          || !glslang_cache_get(in, &param.maximum, sizeof(float))
+          || !glslang_cache_get(in, &param.step, sizeof(float)))
+         return false;
+
+      output->meta.parameters.push_back(param);
+   }
+
+   return in->offset == in->size;
+}
+
+bool glslang_cache_load(const char *key, glslang_output *output)
+{
+   std::string path;
+   struct glslang_cache_header header;
+   glslang_cache_reader in;
+   std::vector<uint8_t> payload;
+   RFILE *file = NULL;
+   bool valid  = false;
+   std::lock_guard<std::mutex> holder(glslang_cache_lock);
+
+   if (glslang_cache_dir.empty())
+      return false;
+
+   glslang_cache_entry_path(key, &path);
+
+   if (!(file = filestream_open(path.c_str(),
+               RETRO_VFS_FILE_ACCESS_READ_WRITE
+               | RETRO_VFS_FILE_ACCESS_UPDATE_EXISTING,
+               RETRO_VFS_FILE_ACCESS_HINT_NONE)))
+      return false;
+
+   if (     glslang_cache_read_header(file, &header)
+         && header.payload_size == filestream_get_size(file) - sizeof(header))
+   {
+      payload.resize(header.payload_size);
+      valid = header.payload_size
+         && filestream_read(file, payload.data(), header.payload_size)
+            == (int64_t)header.payload_size
+         && encoding_crc32(0, payload.data(), payload.size())
+            == header.payload_crc;
+   }
+
+   if (valid)
+   {
+      in.data   = payload.data();
+      in.size   = payload.size();
+      in.offset = 0;
+      valid     = glslang_cache_parse(&in, output);
+   }
+
+   if (valid)
+   {
+      /* Mark as recently used, eviction goes by this
+       * rather than by file times */
+      header.last_used = (uint64_t)time(NULL);
+      filestream_seek(file, offsetof(struct glslang_cache_header, last_used),
+            RETRO_VFS_SEEK_POSITION_START);
+      filestream_write(file, &header.last_used, sizeof(header.last_used));
+   }
+
+   filestream_close(file);
+
+   if (!valid)
+   {
+      output->vertex.clear();
+      output->fragment.clear();
+      output->meta = glslang_meta();
+      RARCH_WARN("[slang]: Discarding corrupt shader cache entry \"%s\".\n",
+            path.c_str());
+      filestream_delete(path.c_str());
+   }
+
+   return valid;
+}
+
+void glslang_cache_store(const char *key, const glslang_output *output)
+{
+   size_t i;
+   std::string path, tmp_path;
+   struct glslang_cache_header header;
+   std::vector<uint8_t> data(sizeof(header));
+   RFILE *file = NULL;
+   bool stored = false;
+   std::lock_guard<std::mutex> holder(glslang_cache_lock);
+
+   if (glslang_cache_dir.empty())
+      return;
+
+   glslang_cache_put_spirv(&data, output->vertex);
+   glslang_cache_put_spirv(&data, output->fragment);
+   glslang_cache_put_u32(&data, (uint32_t)output->meta.rt_format);
+   glslang_cache_put_string(&data, output->meta.name);
+   glslang_cache_put_u32(&data, (uint32_t)output->meta.parameters.size());
+
+   for (i = 0; i < output->meta.parameters.size(); i++)
+   {
+      const glslang_parameter &param = output->meta.parameters[i];
+      glslang_cache_put_string(&data, param.id);
+      glslang_cache_put_string(&data, param.desc);
+      glslang_cache_put(&data, &param.initial, sizeof(float));
+      glslang_cache_put(&data, &param.minimum, sizeof(float));
+      glslang_cache_put(&data, &param.maximum, sizeof(float));
+      glslang_cache_put(&data, &param.step, sizeof(float));
+   }
+
+   memcpy(header.magic, "RASC", 4);
+   header.version      = GLSLANG_CACHE_VERSION;
+   header.last_used    = (uint64_t)time(NULL);
+   header.payload_size = (uint32_t)(data.size() - sizeof(header));
+   header.payload_crc  = encoding_crc32(0,
+         data.data() + sizeof(header), header.payload_size);
+   memcpy(data.data(), &header, sizeof(header));
+
+   glslang_cache_entry_path(key, &path);
+   tmp_path = path + ".tmp";
+
+   /* Write to a temporary file first, so an interrupted
+    * store never leaves a truncated entry behind */
+   if ((file = filestream_open(tmp_path.c_str(),
+               RETRO_VFS_FILE_ACCESS_WRITE,
+               RETRO_VFS_FILE_ACCESS_HINT_NONE)))
+   {
+      stored = filestream_write(file, data.data(), data.size())
+         == (int64_t)data.size();
+      if (filestream_close(file) != 0)
+         stored = false;
+   }
+
+   if (stored)
+   {
+      /* rename() does not replace existing files everywhere */
+      filestream_delete(path.c_str());
+      stored = filestream_rename(tmp_path.c_str(), path.c_str()) == 0;
+   }
+
+   if (!stored)
+   {
+      filestream_delete(tmp_path.c_str());
+      return;
+   }
+
+   glslang_cache_size += data.size();
+   if (glslang_cache_size > glslang_cache_max_size)
+      glslang_cache_evict();
+}
@@ -0,0 +1,67 @@
+/*  RetroArch - A frontend for libretro.
+ *  Copyright (C) 2010-2017 - Hans-Kristian Arntzen
+ *
+ *  RetroArch is free software: you can redistribute it and/or modify it under the terms
+ *  of the GNU General Public License as published by the Free Software Found-
+ *  ation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  RetroArch is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ *  without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ *  PURPOSE.  See the GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along with RetroArch.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef GLSLANG_CACHE_H
+#define GLSLANG_CACHE_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+#include <retro_common_api.h>
+#include <boolean.h>
+
+#include <lists/string_list.h>
+
+/* Length of a cache key, including the terminator */
+#define GLSLANG_CACHE_KEY_SIZE 65
+
+RETRO_BEGIN_DECLS
+
+/**
+ * glslang_cache_init:
+ * @dir                  : directory of the cache, created if missing.
+ * @max_size             : size limit of the cache in bytes.
+ *
+ * Slang shaders compiled to SPIR-V are kept in @dir, so that
+ * loading the same shader again skips glslang. The least
+ * recently used shaders are removed once the cache grows
+ * past @max_size. An empty @dir or a @max_size of 0
+ * disables the cache.
+ **/
+void glslang_cache_init(const char *dir, uint64_t max_size);
+
+RETRO_END_DECLS
+
+#ifdef __cplusplus
+struct glslang_output;
+
+/**
+ * glslang_cache_key:
+ * @lines                : shader source, with includes expanded.
+ * @compiler             : compiler version.
+ * @key                  : GLSLANG_CACHE_KEY_SIZE bytes, receives
+ *                         the key as a hex string.
+ **/
+void glslang_cache_key(const struct string_list *lines,
+      const char *compiler, char *key);
+
+/* Returns true and fills in @output if the shader with
+ * @key is in the cache. */
+bool glslang_cache_load(const char *key, glslang_output *output);
+
+void glslang_cache_store(const char *key, const glslang_output *output);
+#endif
+
+#endif
@@ -23,15 +23,21 @@
 #include <file/config_file.h>
 #include <streams/file_stream.h>
 #include <string/stdstring.h>
+#include <features/features_cpu.h>
 
 #ifdef HAVE_CONFIG_H
 #include "../../config.h"
 #endif
 
+#ifdef HAVE_THREADS
+#include <rthreads/tpool.h>
+#endif
+
 #include "glslang_util.h"
 #include "glslang_util_cxx.h"
 #if defined(HAVE_GLSLANG)
 #include "glslang.hpp"
+#include "glslang_cache.h"
 #endif
 #include "../../verbosity.h"
 
@@ -222,15 +228,28 @@ bool glslang_compile_shader(const char *shader_path, glslang_output *output)
 {
 #if defined(HAVE_GLSLANG)
    struct string_list lines;
+   char key[GLSLANG_CACHE_KEY_SIZE];
    
    if (!string_list_initialize(&lines))
       return false;
 
-   RARCH_LOG("[slang]: Compiling shader: \"%s\".\n", shader_path);
-
    if (!glslang_read_shader_file(shader_path, &lines, true))
       goto error;
+
+   /* The key covers the source with its includes expanded,
+    * the #pragma parameters and the compiler that is used */
+   glslang_cache_key(&lines, glslang::compiler_version().c_str(), key);
    output->meta = glslang_meta{};
+
+   if (glslang_cache_load(key, output))
+   {
+      RARCH_LOG("[slang]: Loaded cached shader: \"%s\".\n", shader_path);
+      string_list_deinitialize(&lines);
+      return true;
+   }
+
+   RARCH_LOG("[slang]: Compiling shader: \"%s\".\n", shader_path);
+
    if (!glslang_parse_meta(&lines, &output->meta))
       goto error;
 
@@ -248,6 +267,7 @@ bool glslang_compile_shader(const char *shader_path, glslang_output *output)
       goto error;
    }
 
+   glslang_cache_store(key, output);
    string_list_deinitialize(&lines);
 
    return true;
@@ -258,3 +278,97 @@ error:
 
    return false;
 }
+
+struct glslang_compile_job
+{
+   const char *path;
+   glslang_output *output;
+   retro_time_t usec;
+   bool done;
+   bool ok;
+};
+
+static void glslang_compile_job_run(void *data)
+{
+   glslang_compile_job *job = (glslang_compile_job*)data;
+   retro_time_t start       = cpu_features_get_time_usec();
+
+   job->ok   = glslang_compile_shader(job->path, job->output);
+   job->usec = cpu_features_get_time_usec() - start;
+   job->done = true;
+}
+
+bool glslang_compile_shaders(const char *const *paths, unsigned count,
+      glslang_output *outputs, unsigned *failed_pass)
+{
+   unsigned i;
+   std::vector<glslang_compile_job> jobs(count);
+   retro_time_t start = cpu_features_get_time_usec();
+   unsigned threads   = 1;
+#ifdef HAVE_THREADS
+   tpool_t *pool      = NULL;
+
+   threads = cpu_features_get_core_amount();
+   if (threads > count)
+      threads = count;
+#endif
+
+#if defined(HAVE_GLSLANG)
+   glslang::acquire_process();
+#endif
+
+   for (i = 0; i < count; i++)
+   {
+      jobs[i].path   = paths[i];
+      jobs[i].output = &outputs[i];
+      jobs[i].usec   = 0;
+      jobs[i].done   = false;
+      jobs[i].ok     = false;
+   }
+
+#ifdef HAVE_THREADS
+   /* Passes do not depend on each other until the
+    * filter chain is built, so compile them all at once */
+   if (threads > 1 && (pool = tpool_create(threads)))
+   {
+      for (i = 0; i < count; i++)
+      {
+         if (!tpool_add_work(pool, glslang_compile_job_run, &jobs[i]))
+            break;
+      }
+      tpool_wait(pool);
+      tpool_destroy(pool);
+   }
+   else
+      threads = 1;
+#endif
+
+   /* Whatever the pool did not take */
+   for (i = 0; i < count; i++)
+   {
+      if (!jobs[i].done)
+         glslang_compile_job_run(&jobs[i]);
+   }
+
+#if defined(HAVE_GLSLANG)
+   glslang::release_process();
+#endif
+
+   for (i = 0; i < count; i++)
+   {
+      RARCH_LOG("[slang]: Pass #%u took %.1f ms: \"%s\".\n",
+            i, jobs[i].usec / 1000.0, paths[i]);
+
+      if (!jobs[i].ok)
+      {
+         if (failed_pass)
+            *failed_pass = i;
+         return false;
+      }
+   }
+
+   RARCH_LOG("[slang]: Compiled %u passes in %.1f ms on %u threads.\n",
+         count, (cpu_features_get_time_usec() - start) / 1000.0, threads);
+
+   return true;
+}
@@ -55,6 +55,13 @@ struct glslang_output
 
 bool glslang_compile_shader(const char *shader_path, glslang_output *output);
 
+/* Compiles the passes of a preset at once, spread over
+ * the available cores. Outputs are in the order of @paths.
+ * On failure, @failed_pass receives the first pass that
+ * did not compile. */
+bool glslang_compile_shaders(const char *const *paths, unsigned count,
+      glslang_output *outputs, unsigned *failed_pass);
+
 /* Helpers for internal use. */
 bool glslang_parse_meta(const struct string_list *lines, glslang_meta *meta);
 
@@ -2233,6 +2233,8 @@ gl3_filter_chain_t *gl3_filter_chain_create_from_preset(
       const char *path, glslang_filter_chain_filter filter)
 {
    unsigned i;
+   std::vector<const char*> paths;
+   std::vector<glslang_output> outputs;
    std::unique_ptr<video_shader> shader{ new video_shader() };
    if (!shader)
       return nullptr;
@@ -2253,8 +2255,20 @@ gl3_filter_chain_t *gl3_filter_chain_create_from_preset(
    shader->num_parameters = 0;
 
    for (i = 0; i < shader->passes; i++)
+      paths.push_back(shader->pass[i].source.path);
+   outputs.resize(shader->passes);
+
+   if (!glslang_compile_shaders(paths.data(), shader->passes,
+            outputs.data(), &i))
    {
-      glslang_output output;
+      RARCH_ERR("[GLCore]: Failed to compile shader: \"%s\".\n",
+            shader->pass[i].source.path);
+      return nullptr;
+   }
+
+   for (i = 0; i < shader->passes; i++)
+   {
+      glslang_output &output             = outputs[i];
       struct gl3_filter_chain_pass_info pass_info;
       const video_shader_pass *pass      = &shader->pass[i];
       const video_shader_pass *next_pass =
@@ -2270,13 +2284,6 @@ gl3_filter_chain_t *gl3_filter_chain_create_from_preset(
       pass_info.address       = GLSLANG_FILTER_CHAIN_ADDRESS_REPEAT;
       pass_info.max_levels    = 0;
 
-      if (!glslang_compile_shader(pass->source.path, &output))
-      {
-         RARCH_ERR("[GLCore]: Failed to compile shader: \"%s\".\n",
-               pass->source.path);
-         return nullptr;
-      }
-
       for (auto &meta_param : output.meta.parameters)
       {
          if (shader->num_parameters >= GFX_MAX_PARAMETERS)
@@ -29,6 +29,7 @@
 #include <formats/image.h>
 #include <string/stdstring.h>
 #include <retro_miscellaneous.h>
+#include <features/features_cpu.h>
 
 #include "slang_reflection.h"
 #include "slang_reflection.hpp"
@@ -1701,6 +1702,7 @@ bool Pass::init_pipeline()
       VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO };
    VkGraphicsPipelineCreateInfo pipe                     = {
       VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO };
+   retro_time_t start;
 
    if (!init_pipeline_layout())
       return false;
@@ -1789,6 +1791,8 @@ bool Pass::init_pipeline()
       framebuffer->get_render_pass();
    pipe.layout              = pipeline_layout;
 
+   /* Fast when the pipeline cache from an earlier session has it */
+   start = cpu_features_get_time_usec();
    if (vkCreateGraphicsPipelines(device,
             cache, 1, &pipe, NULL, &pipeline) != VK_SUCCESS)
    {
@@ -1796,6 +1800,8 @@ bool Pass::init_pipeline()
       vkDestroyShaderModule(device, shader_stages[1].module, NULL);
       return false;
    }
+   RARCH_LOG("[Vulkan filter chain]: Created pipeline for pass #%u in %.2f ms.\n",
+         pass_number, (cpu_features_get_time_usec() - start) / 1000.0);
 
    vkDestroyShaderModule(device, shader_stages[0].module, NULL);
    vkDestroyShaderModule(device, shader_stages[1].module, NULL);
@@ -2584,6 +2590,8 @@ vulkan_filter_chain_t *vulkan_filter_chain_create_from_preset(
       const char *path, glslang_filter_chain_filter filter)
 {
    unsigned i;
+   std::vector<const char*> paths;
+   std::vector<glslang_output> outputs;
    std::unique_ptr<video_shader> shader{ new video_shader() };
 
    if (!shader)
@@ -2605,9 +2613,21 @@ vulkan_filter_chain_t *vulkan_filter_chain_create_from_preset(
 
    shader->num_parameters = 0;
 
+   for (i = 0; i < shader->passes; i++)
+      paths.push_back(shader->pass[i].source.path);
+   outputs.resize(shader->passes);
+
+   if (!glslang_compile_shaders(paths.data(), shader->passes,
+            outputs.data(), &i))
+   {
+      RARCH_ERR("[Vulkan]: Failed to compile shader: \"%s\".\n",
+            shader->pass[i].source.path);
+      goto error;
+   }
+
    for (i = 0; i < shader->passes; i++)
    {
-      glslang_output output;
+      glslang_output &output             = outputs[i];
       struct vulkan_filter_chain_pass_info pass_info;
       const video_shader_pass *pass      = &shader->pass[i];
       const video_shader_pass *next_pass =
@@ -2623,13 +2643,6 @@ vulkan_filter_chain_t *vulkan_filter_chain_create_from_preset(
       pass_info.address       = GLSLANG_FILTER_CHAIN_ADDRESS_REPEAT;
       pass_info.max_levels    = 0;
 
-      if (!glslang_compile_shader(pass->source.path, &output))
-      {
-         RARCH_ERR("[Vulkan]: Failed to compile shader: \"%s\".\n",
-               pass->source.path);
-         goto error;
-      }
-
       for (auto &meta_param : output.meta.parameters)
       {
          if (shader->num_parameters >= GFX_MAX_PARAMETERS)
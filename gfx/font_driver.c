@@ -22,6 +22,7 @@
 #endif
 
 #include "font_driver.h"
+#include "gfx_display.h"
 #include "video_thread_wrapper.h"
 
 #include "../retroarch.h"
@@ -1207,6 +1208,10 @@ void font_driver_render_msg(
 #else
       char *new_msg = (char*)msg;
 #endif
+      /* Without a block the text is drawn right away,
+       * on top of the quads held back so far */
+      if (!font->block)
+         gfx_display_batch_flush();
       font->renderer->render_msg(data,
             font->renderer_data, new_msg, params);
 #ifdef HAVE_LANGEXTRA
@@ -1221,14 +1226,20 @@ void font_driver_bind_block(void *font_data, void *block)
    font_data_t *font = (font_data_t*)(font_data ? font_data : video_font_driver);
 
    if (font && font->renderer && font->renderer->bind_block)
+   {
+      font->block = block;
       font->renderer->bind_block(font->renderer_data, block);
+   }
 }
 
 void font_driver_flush(unsigned width, unsigned height, void *font_data)
 {
    font_data_t *font = (font_data_t*)(font_data ? font_data : video_font_driver);
    if (font && font->renderer && font->renderer->flush)
+   {
+      gfx_display_batch_flush();
       font->renderer->flush(width, height, font->renderer_data);
+   }
 }
 
 int font_driver_get_message_width(void *font_data,
@@ -1357,6 +1368,7 @@ font_data_t *font_driver_init_first(
       {
          font->renderer      = (const font_renderer_t*)font_driver;
          font->renderer_data = font_handle;
+         font->block         = NULL;
          font->size          = font_size;
          return font;
       }
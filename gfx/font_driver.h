@@ -132,6 +132,7 @@ typedef struct
 {
    const font_renderer_t *renderer;
    void *renderer_data;
+   void *block;
    float size;
 } font_data_t;
 
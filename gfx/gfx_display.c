@@ -16,6 +16,8 @@
  */
 #include "gfx_display.h"
 
+#include <retro_math.h>
+
 #include "video_coord_array.h"
 #include "../configuration.h"
 #include "../verbosity.h"
@@ -1254,6 +1256,51 @@ void gfx_display_draw_keyboard(
    }
 }
 
+/* Copies an icon into the atlas being put together, with its
+ * edge pixels repeated into the padding around it */
+static void gfx_display_atlas_stage(gfx_display_t *p_disp,
+      const struct texture_image *ti, uintptr_t texture)
+{
+   int y;
+   unsigned x0, y0;
+   int pad = GFX_DISPLAY_ATLAS_PADDING;
+
+   if (!texture || !ti->pixels)
+      return;
+
+   if (!p_disp->atlas_pixels)
+   {
+      if (!(p_disp->atlas_pixels = (uint32_t*)calloc(
+            GFX_DISPLAY_ATLAS_SIZE * GFX_DISPLAY_ATLAS_SIZE,
+            sizeof(uint32_t))))
+      {
+         p_disp->atlas_staging = false;
+         return;
+      }
+   }
+
+   if (!gfx_display_atlas_place(&p_disp->batch, texture,
+            ti->width, ti->height, &x0, &y0))
+      return;
+
+   for (y = -pad; y < (int)ti->height + pad; y++)
+   {
+      int x;
+      int src_y          = y < 0 ? 0
+         : (y >= (int)ti->height ? (int)ti->height - 1 : y);
+      const uint32_t *in = ti->pixels + (size_t)src_y * ti->width;
+      uint32_t *out      = p_disp->atlas_pixels
+         + (size_t)((int)y0 + y) * GFX_DISPLAY_ATLAS_SIZE + x0;
+
+      memcpy(out, in, ti->width * sizeof(uint32_t));
+      for (x = 1; x <= pad; x++)
+      {
+         out[-x]                    = in[0];
+         out[ti->width - 1 + x]     = in[ti->width - 1];
+      }
+   }
+}
+
 /* NOTE: Reads image from file */
 bool gfx_display_reset_textures_list(
       const char *texture_path, const char *iconpath,
@@ -1286,11 +1333,72 @@ bool gfx_display_reset_textures_list(
 
    video_driver_texture_load(&ti,
          filter_type, item);
+
+   if (dispgfx_st.atlas_staging && filter_type == dispgfx_st.atlas_filter)
+      gfx_display_atlas_stage(&dispgfx_st, &ti, *item);
+
    image_texture_free(&ti);
 
    return true;
 }
 
+void gfx_display_atlas_begin(gfx_display_t *p_disp,
+      enum texture_filter_type filter_type)
+{
+   gfx_display_atlas_free(p_disp);
+
+   if (!gfx_display_batch_supported(p_disp->dispctx))
+      return;
+
+   p_disp->atlas_filter  = filter_type;
+   p_disp->atlas_staging = true;
+}
+
+void gfx_display_atlas_end(gfx_display_t *p_disp)
+{
+   struct texture_image ti;
+   uintptr_t texture          = 0;
+   gfx_display_batch_t *batch = &p_disp->batch;
+
+   if (!p_disp->atlas_staging)
+      return;
+
+   p_disp->atlas_staging      = false;
+
+   if (p_disp->atlas_pixels && batch->atlas_count)
+   {
+      ti.width              = GFX_DISPLAY_ATLAS_SIZE;
+      ti.height             = next_pow2(batch->atlas_height);
+      ti.pixels             = p_disp->atlas_pixels;
+      ti.supports_rgba      = video_driver_supports_rgba();
+
+      video_driver_texture_load(&ti, p_disp->atlas_filter, &texture);
+
+      if (texture)
+         RARCH_LOG("[Display]: Icon atlas: %u icons in %ux%u.\n",
+               batch->atlas_count, ti.width, ti.height);
+   }
+
+   gfx_display_atlas_finish(batch, texture, next_pow2(batch->atlas_height));
+
+   free(p_disp->atlas_pixels);
+   p_disp->atlas_pixels     = NULL;
+}
+
+void gfx_display_atlas_free(gfx_display_t *p_disp)
+{
+   gfx_display_batch_t *batch = &p_disp->batch;
+
+   if (batch->atlas_texture)
+      video_driver_texture_unload(&batch->atlas_texture);
+
+   gfx_display_atlas_reset(batch);
+
+   free(p_disp->atlas_pixels);
+   p_disp->atlas_pixels       = NULL;
+   p_disp->atlas_staging      = false;
+}
+
 /* Teardown; deinitializes and frees all
  * fonts associated to the display driver */
 void gfx_display_font_free(font_data_t *font)
@@ -1321,8 +1429,18 @@ void gfx_display_init_white_texture(void)
 void gfx_display_free(void)
 {
    gfx_display_t *p_disp       = &dispgfx_st;
+   gfx_display_batch_t *batch  = &p_disp->batch;
    video_coord_array_free(&p_disp->dispca);
 
+   if (batch->frames)
+      RARCH_LOG("[Display]: Menu draws: %.1f submitted, %.1f issued per frame over %llu frames.\n",
+            (double)batch->draws_submitted / batch->frames,
+            (double)batch->draws_issued    / batch->frames,
+            (unsigned long long)batch->frames);
+
+   gfx_display_atlas_free(p_disp);
+   gfx_display_batch_free(batch);
+
    p_disp->msg_force           = false;
    p_disp->header_height       = 0;
    p_disp->framebuf_width      = 0;
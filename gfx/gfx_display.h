@@ -174,6 +174,85 @@ struct gfx_display_ctx_draw
    bool pipeline_active;
 };
 
+/* Draws of the same texture gfx_display_batch_draw() can hold
+ * back at once, and how many groups back a new quad may look for
+ * its texture */
+#define GFX_DISPLAY_BATCH_GROUPS   64
+#define GFX_DISPLAY_BATCH_LOOKBACK 8
+
+/* Menu icons up to GFX_DISPLAY_ATLAS_MAX_ICON pixels on a side
+ * share one GFX_DISPLAY_ATLAS_SIZE texture, each surrounded by
+ * GFX_DISPLAY_ATLAS_PADDING pixels of its own edge so that
+ * filtering never reaches a neighbour */
+#define GFX_DISPLAY_ATLAS_SIZE     2048
+#define GFX_DISPLAY_ATLAS_PADDING  8
+#define GFX_DISPLAY_ATLAS_MAX_ICON 256
+/* Power of two, twice the icons the atlas may hold */
+#define GFX_DISPLAY_ATLAS_SLOTS    256
+
+/* Two triangles, ready to be copied out */
+typedef struct gfx_display_batch_quad
+{
+   float vertex[12];
+   float tex_coord[12];
+   float color[24];
+   int next;
+} gfx_display_batch_quad_t;
+
+typedef struct gfx_display_batch_group
+{
+   uintptr_t texture;
+   /* Window area covered by the group's quads */
+   float x0;
+   float y0;
+   float x1;
+   float y1;
+   int first;
+   int last;
+   unsigned quads;
+} gfx_display_batch_group_t;
+
+typedef struct gfx_display_atlas_entry
+{
+   uintptr_t texture;
+   /* In pixels while packing, in texture coordinates after */
+   float x;
+   float y;
+   float width;
+   float height;
+} gfx_display_atlas_entry_t;
+
+typedef struct gfx_display_batch
+{
+   /* Stands in for the display driver during a menu frame */
+   gfx_display_ctx_driver_t proxy;
+   gfx_display_ctx_driver_t *dispctx;
+   void *data;
+   gfx_display_batch_quad_t *quads;
+   video_coord_array_t ca; /* ptr alignment */
+   gfx_display_batch_group_t groups[GFX_DISPLAY_BATCH_GROUPS];
+   gfx_display_atlas_entry_t atlas[GFX_DISPLAY_ATLAS_SLOTS];
+   uintptr_t atlas_texture;
+   uint64_t frames;
+   uint64_t draws_submitted;
+   uint64_t draws_issued;
+   size_t quads_allocated;
+   /* Window coordinates to default MVP vertex coordinates */
+   float unproject[6];
+   unsigned num_quads;
+   unsigned num_groups;
+   unsigned video_width;
+   unsigned video_height;
+   unsigned frame_submitted;
+   unsigned frame_issued;
+   unsigned atlas_count;
+   unsigned atlas_height;
+   unsigned shelf_x;
+   unsigned shelf_y;
+   unsigned shelf_height;
+   bool active;
+} gfx_display_batch_t;
+
 typedef struct gfx_display_ctx_rotate_draw
 {
    math_matrix_4x4 *matrix;
@@ -210,6 +289,8 @@ struct gfx_display
 {
    gfx_display_ctx_driver_t *dispctx;
    video_coord_array_t dispca; /* ptr alignment */
+   gfx_display_batch_t batch;  /* ptr alignment */
+   uint32_t *atlas_pixels;
 
    /* Width, height and pitch of the display framebuffer */
    size_t   framebuf_pitch;
@@ -220,8 +301,10 @@ struct gfx_display
    unsigned header_height;
 
    enum menu_driver_id_type menu_driver_id;
+   enum texture_filter_type atlas_filter;
 
    bool has_windowed;
+   bool atlas_staging;
    bool msg_force;
    bool framebuf_dirty;
 };
@@ -320,6 +403,135 @@ bool gfx_display_reset_textures_list(
       uintptr_t *item, enum texture_filter_type filter_type,
       unsigned *width, unsigned *height);
 
+/**
+ * gfx_display_atlas_begin:
+ * @p_disp               : display state.
+ * @filter_type          : filter the menu loads its icons with.
+ *
+ * Replaces the previous atlas. Until gfx_display_atlas_end(),
+ * gfx_display_reset_textures_list() also copies every icon it
+ * loads with @filter_type into a new one. Does nothing if the
+ * display driver does not batch.
+ **/
+void gfx_display_atlas_begin(gfx_display_t *p_disp,
+      enum texture_filter_type filter_type);
+
+/**
+ * gfx_display_atlas_end:
+ * @p_disp               : display state.
+ *
+ * Uploads the atlas. From now on batched draws of its icons
+ * sample it instead, so that they share a single draw call.
+ **/
+void gfx_display_atlas_end(gfx_display_t *p_disp);
+
+/**
+ * gfx_display_atlas_free:
+ * @p_disp               : display state.
+ *
+ * Unloads the atlas. Call it whenever the icons in it are
+ * unloaded, before their texture handles can be reused.
+ **/
+void gfx_display_atlas_free(gfx_display_t *p_disp);
+
+/**
+ * gfx_display_batch_supported:
+ * @dispctx              : display driver.
+ *
+ * Returns: true if @dispctx draws into a viewport with a plain
+ * 2D matrix, so that its quads can be moved into one draw call.
+ **/
+bool gfx_display_batch_supported(const gfx_display_ctx_driver_t *dispctx);
+
+/**
+ * gfx_display_batch_begin:
+ * @batch                : batcher.
+ * @dispctx              : display driver in use, replaced by the
+ *                         batcher's own until gfx_display_batch_end().
+ * @data                 : video driver data.
+ * @video_width          : width of the viewport.
+ * @video_height         : height of the viewport.
+ *
+ * Textured quads drawn through *@dispctx from now on are held back
+ * and grouped by texture. A group goes out in one draw call when
+ * anything else happens: a blend, scissor or pipeline change, a
+ * draw that is not a quad, text, or the end of the frame. A quad
+ * joins an earlier group of its texture only when it does not
+ * cover anything drawn since, so what ends up on screen does not
+ * change.
+ *
+ * Returns: true if batching, false if @dispctx cannot.
+ **/
+bool gfx_display_batch_begin(gfx_display_batch_t *batch,
+      gfx_display_ctx_driver_t **dispctx, void *data,
+      unsigned video_width, unsigned video_height);
+
+/**
+ * gfx_display_batch_end:
+ * @batch                : batcher.
+ * @dispctx              : where gfx_display_batch_begin() swapped
+ *                         the display driver.
+ *
+ * Draws whatever is held back and puts the display driver back.
+ **/
+void gfx_display_batch_end(gfx_display_batch_t *batch,
+      gfx_display_ctx_driver_t **dispctx);
+
+/**
+ * gfx_display_batch_flush:
+ *
+ * Draws whatever the active batcher holds back. To be called
+ * before anything draws without going through the display driver,
+ * such as a font renderer. Does nothing outside a batched frame.
+ **/
+void gfx_display_batch_flush(void);
+
+/**
+ * gfx_display_batch_free:
+ * @batch                : batcher.
+ *
+ * Frees the vertex arrays. The counters stay.
+ **/
+void gfx_display_batch_free(gfx_display_batch_t *batch);
+
+/**
+ * gfx_display_atlas_reset:
+ * @batch                : batcher.
+ *
+ * Forgets the icons in the atlas. Unloading its texture is up
+ * to the caller.
+ **/
+void gfx_display_atlas_reset(gfx_display_batch_t *batch);
+
+/**
+ * gfx_display_atlas_place:
+ * @batch                : batcher.
+ * @texture              : icon's own texture.
+ * @width                : width of the icon.
+ * @height               : height of the icon.
+ * @x                    : left of the icon in the atlas.
+ * @y                    : top of the icon in the atlas.
+ *
+ * Finds the icon a place on the current shelf of the atlas, or
+ * on a new one below it.
+ *
+ * Returns: false if the icon is too large or the atlas is full.
+ **/
+bool gfx_display_atlas_place(gfx_display_batch_t *batch,
+      uintptr_t texture, unsigned width, unsigned height,
+      unsigned *x, unsigned *y);
+
+/**
+ * gfx_display_atlas_finish:
+ * @batch                : batcher.
+ * @texture              : atlas texture, GFX_DISPLAY_ATLAS_SIZE wide.
+ * @height               : height of @texture.
+ *
+ * Makes the placed icons draw from @texture.
+ **/
+void gfx_display_atlas_finish(gfx_display_batch_t *batch,
+      uintptr_t texture, unsigned height);
+
 /* Returns the OSK key at a given position */
 int gfx_display_osk_ptr_at_pos(void *data, int x, int y,
       unsigned width, unsigned height);
@@ -0,0 +1,597 @@
+/*  RetroArch - A frontend for libretro.
+ *  Copyright (C) 2010-2014 - Hans-Kristian Arntzen
+ *  Copyright (C) 2011-2021 - Daniel De Matteis
+ *
+ *  RetroArch is free software: you can redistribute it and/or modify it under the terms
+ *  of the GNU General Public License as published by the Free Software Found-
+ *  ation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  RetroArch is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ *  without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ *  PURPOSE.  See the GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along with RetroArch.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include <retro_inline.h>
+#include <retro_miscellaneous.h>
+
+#include "gfx_display.h"
+#include "video_coord_array.h"
+
+/* The proxy's callbacks only get the video driver's data,
+ * this is the batcher they work for */
+static gfx_display_batch_t *gfx_display_batch_st = NULL;
+
+bool gfx_display_batch_supported(const gfx_display_ctx_driver_t *dispctx)
+{
+   if (!dispctx || !dispctx->draw || !dispctx->get_default_mvp)
+      return false;
+
+   /* These set the viewport from the draw rectangle and apply the
+    * matrix to the vertices as they are. Vulkan flips them first,
+    * the others keep their own transform. */
+   switch (dispctx->type)
+   {
+      case GFX_VIDEO_DRIVER_OPENGL:
+      case GFX_VIDEO_DRIVER_OPENGL1:
+      case GFX_VIDEO_DRIVER_OPENGL_CORE:
+         return true;
+      default:
+         break;
+   }
+
+   return false;
+}
+
+static INLINE unsigned gfx_display_atlas_slot(uintptr_t texture)
+{
+   return (unsigned)(((uint32_t)texture * 2654435761u) >> 24)
+      & (GFX_DISPLAY_ATLAS_SLOTS - 1);
+}
+
+static gfx_display_atlas_entry_t *gfx_display_atlas_find(
+      gfx_display_batch_t *batch, uintptr_t texture)
+{
+   unsigned slot = gfx_display_atlas_slot(texture);
+
+   while (batch->atlas[slot].texture)
+   {
+      if (batch->atlas[slot].texture == texture)
+         return &batch->atlas[slot];
+      slot = (slot + 1) & (GFX_DISPLAY_ATLAS_SLOTS - 1);
+   }
+
+   return NULL;
+}
+
+void gfx_display_atlas_reset(gfx_display_batch_t *batch)
+{
+   memset(batch->atlas, 0, sizeof(batch->atlas));
+   batch->atlas_texture = 0;
+   batch->atlas_count   = 0;
+   batch->atlas_height  = 0;
+   batch->shelf_x       = 0;
+   batch->shelf_y       = 0;
+   batch->shelf_height  = 0;
+}
+
+bool gfx_display_atlas_place(gfx_display_batch_t *batch,
+      uintptr_t texture, unsigned width, unsigned height,
+      unsigned *x, unsigned *y)
+{
+   unsigned slot;
+   unsigned cell_width  = width  + 2 * GFX_DISPLAY_ATLAS_PADDING;
+   unsigned cell_height = height + 2 * GFX_DISPLAY_ATLAS_PADDING;
+
+   if (     !texture
+         || !width
+         || !height
+         || width  > GFX_DISPLAY_ATLAS_MAX_ICON
+         || height > GFX_DISPLAY_ATLAS_MAX_ICON
+         || batch->atlas_count >= GFX_DISPLAY_ATLAS_SLOTS / 2
+         || gfx_display_atlas_find(batch, texture))
+      return false;
+
+   if (batch->shelf_x + cell_width > GFX_DISPLAY_ATLAS_SIZE)
+   {
+      batch->shelf_y     += batch->shelf_height;
+      batch->shelf_x      = 0;
+      batch->shelf_height = 0;
+   }
+
+   if (batch->shelf_y + cell_height > GFX_DISPLAY_ATLAS_SIZE)
+      return false;
+
+   *x = batch->shelf_x + GFX_DISPLAY_ATLAS_PADDING;
+   *y = batch->shelf_y + GFX_DISPLAY_ATLAS_PADDING;
+
+   batch->shelf_x      += cell_width;
+   batch->shelf_height  = MAX(batch->shelf_height, cell_height);
+   batch->atlas_height  = batch->shelf_y + batch->shelf_height;
+
+   slot = gfx_display_atlas_slot(texture);
+   while (batch->atlas[slot].texture)
+      slot = (slot + 1) & (GFX_DISPLAY_ATLAS_SLOTS - 1);
+
+   batch->atlas[slot].texture = texture;
+   batch->atlas[slot].x       = *x;
+   batch->atlas[slot].y       = *y;
+   batch->atlas[slot].width   = width;
+   batch->atlas[slot].height  = height;
+   batch->atlas_count++;
+
+   return true;
+}
+
+void gfx_display_atlas_finish(gfx_display_batch_t *batch,
+      uintptr_t texture, unsigned height)
+{
+   unsigned i;
+   float norm_x = 1.0f / GFX_DISPLAY_ATLAS_SIZE;
+   float norm_y;
+
+   if (!texture || !height)
+   {
+      gfx_display_atlas_reset(batch);
+      return;
+   }
+
+   norm_y = 1.0f / height;
+
+   for (i = 0; i < GFX_DISPLAY_ATLAS_SLOTS; i++)
+   {
+      gfx_display_atlas_entry_t *entry = &batch->atlas[i];
+      if (!entry->texture)
+         continue;
+      entry->x      *= norm_x;
+      entry->y      *= norm_y;
+      entry->width  *= norm_x;
+      entry->height *= norm_y;
+   }
+
+   batch->atlas_texture = texture;
+}
+
+static void gfx_display_batch_issue(gfx_display_batch_t *batch,
+      gfx_display_ctx_draw_t *draw, void *data,
+      unsigned video_width, unsigned video_height)
+{
+   batch->draws_issued++;
+   batch->frame_issued++;
+   batch->dispctx->draw(draw, data, video_width, video_height);
+}
+
+static void gfx_display_batch_flush_internal(gfx_display_batch_t *batch)
+{
+   unsigned i;
+   unsigned offset           = 0;
+   video_coord_array_t *ca   = &batch->ca;
+
+   if (!batch->num_groups)
+      return;
+
+   ca->coords.vertices       = 0;
+
+   /* Each group's quads one after the other, two triangles each */
+   for (i = 0; i < batch->num_groups; i++)
+   {
+      int q;
+      for (q = batch->groups[i].first; q >= 0; q = batch->quads[q].next)
+      {
+         struct video_coords coords;
+         const gfx_display_batch_quad_t *quad = &batch->quads[q];
+
+         coords.vertex        = quad->vertex;
+         coords.tex_coord     = quad->tex_coord;
+         coords.lut_tex_coord = quad->tex_coord;
+         coords.color         = quad->color;
+         coords.index         = NULL;
+         coords.vertices      = 6;
+         coords.indexes       = 0;
+
+         if (!video_coord_array_append(ca, &coords, 6))
+         {
+            batch->num_groups = i;
+            break;
+         }
+      }
+   }
+
+   /* The arrays are complete, nothing moves them any more */
+   for (i = 0; i < batch->num_groups; i++)
+   {
+      gfx_display_ctx_draw_t draw;
+      struct video_coords coords;
+      unsigned vertices     = batch->groups[i].quads * 6;
+
+      coords.vertex         = ca->coords.vertex        + offset * 2;
+      coords.tex_coord      = ca->coords.tex_coord     + offset * 2;
+      coords.lut_tex_coord  = ca->coords.lut_tex_coord + offset * 2;
+      coords.color          = ca->coords.color         + offset * 4;
+      coords.index          = NULL;
+      coords.vertices       = vertices;
+      coords.indexes        = 0;
+      offset               += vertices;
+
+      memset(&draw, 0, sizeof(draw));
+      draw.x                = 0;
+      draw.y                = 0;
+      draw.width            = batch->video_width;
+      draw.height           = batch->video_height;
+      draw.coords           = &coords;
+      draw.color            = ca->coords.color + (offset - vertices) * 4;
+      draw.matrix_data      = NULL;
+      draw.texture          = batch->groups[i].texture;
+      draw.prim_type        = GFX_DISPLAY_PRIM_TRIANGLES;
+      draw.scale_factor     = 1.0f;
+
+      gfx_display_batch_issue(batch, &draw, batch->data,
+            batch->video_width, batch->video_height);
+   }
+
+   batch->num_groups          = 0;
+   batch->num_quads           = 0;
+   ca->coords.vertices        = 0;
+}
+
+void gfx_display_batch_flush(void)
+{
+   if (gfx_display_batch_st)
+      gfx_display_batch_flush_internal(gfx_display_batch_st);
+}
+
+/* Window position of the quad's corners, the way the display
+ * driver would have put them: viewport at the draw rectangle,
+ * vertex times the draw's matrix or the default one */
+static bool gfx_display_batch_add(gfx_display_batch_t *batch,
+      gfx_display_ctx_draw_t *draw)
+{
+   /* Strip corners of the two triangles */
+   static const unsigned strip[6]     = { 0, 1, 2, 2, 1, 3 };
+   unsigned i;
+   int q;
+   float vertex_out[8];
+   float tex_coord_out[8];
+   float window[8];
+   float x0, y0, x1, y1;
+   const math_matrix_4x4 *mat;
+   const float *vertex;
+   const float *tex_coord;
+   gfx_display_batch_quad_t *quad;
+   gfx_display_batch_group_t *group   = NULL;
+   const gfx_display_atlas_entry_t *entry = NULL;
+   const struct video_coords *coords  = draw->coords;
+   uintptr_t texture                  = draw->texture;
+   float vp_x                         = (float)(int)draw->x;
+   float vp_y                         = (float)(int)draw->y;
+   float half_w                       = draw->width  * 0.5f;
+   float half_h                       = draw->height * 0.5f;
+
+   if (     !coords
+         || !coords->color
+         || coords->vertices != 4
+         || draw->prim_type  != GFX_DISPLAY_PRIM_TRIANGLESTRIP
+         || draw->pipeline_id
+         || !texture
+         || !draw->width
+         || !draw->height)
+      return false;
+
+   mat = draw->matrix_data
+      ? (const math_matrix_4x4*)draw->matrix_data
+      : (const math_matrix_4x4*)batch->dispctx->get_default_mvp(batch->data);
+
+   if (     !mat
+         || MAT_ELEM_4X4(*mat, 3, 0) != 0.0f
+         || MAT_ELEM_4X4(*mat, 3, 1) != 0.0f
+         || MAT_ELEM_4X4(*mat, 3, 3) != 1.0f)
+      return false;
+
+   vertex    = coords->vertex;
+   tex_coord = coords->tex_coord;
+   if (!vertex && batch->dispctx->get_default_vertices)
+      vertex    = batch->dispctx->get_default_vertices();
+   if (!tex_coord && batch->dispctx->get_default_tex_coords)
+      tex_coord = batch->dispctx->get_default_tex_coords();
+   if (!vertex || !tex_coord)
+      return false;
+
+   x0 = y0 =  1e30f;
+   x1 = y1 = -1e30f;
+
+   for (i = 0; i < 4; i++)
+   {
+      float vx = vertex[i * 2 + 0];
+      float vy = vertex[i * 2 + 1];
+      float cx = MAT_ELEM_4X4(*mat, 0, 0) * vx
+         + MAT_ELEM_4X4(*mat, 0, 1) * vy + MAT_ELEM_4X4(*mat, 0, 3);
+      float cy = MAT_ELEM_4X4(*mat, 1, 0) * vx
+         + MAT_ELEM_4X4(*mat, 1, 1) * vy + MAT_ELEM_4X4(*mat, 1, 3);
+      float wx = vp_x + (cx + 1.0f) * half_w;
+      float wy = vp_y + (cy + 1.0f) * half_h;
+
+      window[i * 2 + 0] = wx;
+      window[i * 2 + 1] = wy;
+      x0 = MIN(x0, wx);
+      y0 = MIN(y0, wy);
+      x1 = MAX(x1, wx);
+      y1 = MAX(y1, wy);
+   }
+
+   /* Icons in the atlas draw from it, unless they
+    * wrap their texture coordinates */
+   if (batch->atlas_texture && (entry = gfx_display_atlas_find(batch, texture)))
+   {
+      for (i = 0; i < 8; i++)
+      {
+         if (tex_coord[i] < 0.0f || tex_coord[i] > 1.0f)
+         {
+            entry = NULL;
+            break;
+         }
+      }
+      if (entry)
+         texture = batch->atlas_texture;
+   }
+
+   /* Latest group of the texture this quad can join without
+    * going under anything drawn after that group */
+   for (i = batch->num_groups; i-- > 0
+         && batch->num_groups - i <= GFX_DISPLAY_BATCH_LOOKBACK; )
+   {
+      gfx_display_batch_group_t *g = &batch->groups[i];
+      if (g->texture == texture)
+      {
+         group = g;
+         break;
+      }
+      if (     x0 < g->x1 && x1 > g->x0
+            && y0 < g->y1 && y1 > g->y0)
+         break;
+   }
+
+   if (!group)
+   {
+      if (batch->num_groups == GFX_DISPLAY_BATCH_GROUPS)
+         gfx_display_batch_flush_internal(batch);
+      group          = &batch->groups[batch->num_groups++];
+      group->texture = texture;
+      group->x0      = x0;
+      group->y0      = y0;
+      group->x1      = x1;
+      group->y1      = y1;
+      group->first   = -1;
+      group->last    = -1;
+      group->quads   = 0;
+   }
+
+   if (batch->num_quads == batch->quads_allocated)
+   {
+      size_t allocated                = batch->quads_allocated
+         ? batch->quads_allocated * 2 : 256;
+      gfx_display_batch_quad_t *quads = (gfx_display_batch_quad_t*)
+         realloc(batch->quads, allocated * sizeof(*quads));
+      if (!quads)
+      {
+         if (!group->quads)
+            batch->num_groups--;
+         return false;
+      }
+      batch->quads           = quads;
+      batch->quads_allocated = allocated;
+   }
+
+   q    = (int)batch->num_quads++;
+   quad = &batch->quads[q];
+
+   for (i = 0; i < 4; i++)
+   {
+      float wx = window[i * 2 + 0];
+      float wy = window[i * 2 + 1];
+      vertex_out[i * 2 + 0] = batch->unproject[0] * wx
+         + batch->unproject[1] * wy + batch->unproject[2];
+      vertex_out[i * 2 + 1] = batch->unproject[3] * wx
+         + batch->unproject[4] * wy + batch->unproject[5];
+
+      if (entry)
+      {
+         tex_coord_out[i * 2 + 0] = entry->x
+            + tex_coord[i * 2 + 0] * entry->width;
+         tex_coord_out[i * 2 + 1] = entry->y
+            + tex_coord[i * 2 + 1] * entry->height;
+      }
+      else
+      {
+         tex_coord_out[i * 2 + 0] = tex_coord[i * 2 + 0];
+         tex_coord_out[i * 2 + 1] = tex_coord[i * 2 + 1];
+      }
+   }
+
+   for (i = 0; i < 6; i++)
+   {
+      unsigned s                   = strip[i];
+      quad->vertex[i * 2 + 0]      = vertex_out[s * 2 + 0];
+      quad->vertex[i * 2 + 1]      = vertex_out[s * 2 + 1];
+      quad->tex_coord[i * 2 + 0]   = tex_coord_out[s * 2 + 0];
+      quad->tex_coord[i * 2 + 1]   = tex_coord_out[s * 2 + 1];
+      memcpy(&quad->color[i * 4], &coords->color[s * 4], 4 * sizeof(float));
+   }
+   quad->next = -1;
+
+   if (group->last >= 0)
+      batch->quads[group->last].next = q;
+   else
+      group->first = q;
+   group->last  = q;
+   group->quads++;
+   group->x0    = MIN(group->x0, x0);
+   group->y0    = MIN(group->y0, y0);
+   group->x1    = MAX(group->x1, x1);
+   group->y1    = MAX(group->y1, y1);
+
+   return true;
+}
+
+static void gfx_display_batch_draw(gfx_display_ctx_draw_t *draw,
+      void *data, unsigned video_width, unsigned video_height)
+{
+   gfx_display_batch_t *batch = gfx_display_batch_st;
+
+   batch->draws_submitted++;
+   batch->frame_submitted++;
+
+   if (!draw)
+      return;
+
+   if (     data         == batch->data
+         && video_width  == batch->video_width
+         && video_height == batch->video_height
+         && gfx_display_batch_add(batch, draw))
+      return;
+
+   gfx_display_batch_flush_internal(batch);
+   gfx_display_batch_issue(batch, draw, data, video_width, video_height);
+}
+
+static void gfx_display_batch_draw_pipeline(gfx_display_ctx_draw_t *draw,
+      gfx_display_t *p_disp, void *data,
+      unsigned video_width, unsigned video_height)
+{
+   gfx_display_batch_t *batch = gfx_display_batch_st;
+   gfx_display_batch_flush_internal(batch);
+   if (batch->dispctx->draw_pipeline)
+      batch->dispctx->draw_pipeline(draw, p_disp, data,
+            video_width, video_height);
+}
+
+static void gfx_display_batch_blend_begin(void *data)
+{
+   gfx_display_batch_t *batch = gfx_display_batch_st;
+   gfx_display_batch_flush_internal(batch);
+   if (batch->dispctx->blend_begin)
+      batch->dispctx->blend_begin(data);
+}
+
+static void gfx_display_batch_blend_end(void *data)
+{
+   gfx_display_batch_t *batch = gfx_display_batch_st;
+   gfx_display_batch_flush_internal(batch);
+   if (batch->dispctx->blend_end)
+      batch->dispctx->blend_end(data);
+}
+
+static void gfx_display_batch_scissor_begin(void *data,
+      unsigned video_width, unsigned video_height,
+      int x, int y, unsigned width, unsigned height)
+{
+   gfx_display_batch_t *batch = gfx_display_batch_st;
+   gfx_display_batch_flush_internal(batch);
+   if (batch->dispctx->scissor_begin)
+      batch->dispctx->scissor_begin(data, video_width, video_height,
+            x, y, width, height);
+}
+
+static void gfx_display_batch_scissor_end(void *data,
+      unsigned video_width, unsigned video_height)
+{
+   gfx_display_batch_t *batch = gfx_display_batch_st;
+   gfx_display_batch_flush_internal(batch);
+   if (batch->dispctx->scissor_end)
+      batch->dispctx->scissor_end(data, video_width, video_height);
+}
+
+bool gfx_display_batch_begin(gfx_display_batch_t *batch,
+      gfx_display_ctx_driver_t **dispctx, void *data,
+      unsigned video_width, unsigned video_height)
+{
+   float det, inv;
+   float i00, i01, i10, i11, tx, ty;
+   const math_matrix_4x4 *mvp;
+   gfx_display_ctx_driver_t *drv = *dispctx;
+
+   if (     gfx_display_batch_st
+         || !video_width
+         || !video_height
+         || !gfx_display_batch_supported(drv))
+      return false;
+
+   if (!(mvp = (const math_matrix_4x4*)drv->get_default_mvp(data)))
+      return false;
+
+   /* Batched quads go out through the default matrix over the
+    * whole viewport, their vertices have to undo both */
+   det = MAT_ELEM_4X4(*mvp, 0, 0) * MAT_ELEM_4X4(*mvp, 1, 1)
+       - MAT_ELEM_4X4(*mvp, 0, 1) * MAT_ELEM_4X4(*mvp, 1, 0);
+   if (     det == 0.0f
+         || MAT_ELEM_4X4(*mvp, 3, 0) != 0.0f
+         || MAT_ELEM_4X4(*mvp, 3, 1) != 0.0f
+         || MAT_ELEM_4X4(*mvp, 3, 3) != 1.0f)
+      return false;
+
+   inv = 1.0f / det;
+   i00 =  MAT_ELEM_4X4(*mvp, 1, 1) * inv;
+   i01 = -MAT_ELEM_4X4(*mvp, 0, 1) * inv;
+   i10 = -MAT_ELEM_4X4(*mvp, 1, 0) * inv;
+   i11 =  MAT_ELEM_4X4(*mvp, 0, 0) * inv;
+   tx  = -1.0f - MAT_ELEM_4X4(*mvp, 0, 3);
+   ty  = -1.0f - MAT_ELEM_4X4(*mvp, 1, 3);
+
+   batch->unproject[0]           = i00 * 2.0f / video_width;
+   batch->unproject[1]           = i01 * 2.0f / video_height;
+   batch->unproject[2]           = i00 * tx + i01 * ty;
+   batch->unproject[3]           = i10 * 2.0f / video_width;
+   batch->unproject[4]           = i11 * 2.0f / video_height;
+   batch->unproject[5]           = i10 * tx + i11 * ty;
+
+   batch->proxy                  = *drv;
+   batch->proxy.draw             = gfx_display_batch_draw;
+   batch->proxy.draw_pipeline    = gfx_display_batch_draw_pipeline;
+   batch->proxy.blend_begin      = gfx_display_batch_blend_begin;
+   batch->proxy.blend_end        = gfx_display_batch_blend_end;
+   batch->proxy.scissor_begin    = gfx_display_batch_scissor_begin;
+   batch->proxy.scissor_end      = gfx_display_batch_scissor_end;
+
+   batch->dispctx                = drv;
+   batch->data                   = data;
+   batch->video_width            = video_width;
+   batch->video_height           = video_height;
+   batch->num_groups             = 0;
+   batch->num_quads              = 0;
+   batch->frame_submitted        = 0;
+   batch->frame_issued           = 0;
+   batch->active                 = true;
+
+   gfx_display_batch_st          = batch;
+   *dispctx                      = &batch->proxy;
+
+   return true;
+}
+
+void gfx_display_batch_end(gfx_display_batch_t *batch,
+      gfx_display_ctx_driver_t **dispctx)
+{
+   if (!batch->active)
+      return;
+
+   gfx_display_batch_flush_internal(batch);
+
+   *dispctx             = batch->dispctx;
+   batch->active        = false;
+   batch->frames++;
+   gfx_display_batch_st = NULL;
+}
+
+void gfx_display_batch_free(gfx_display_batch_t *batch)
+{
+   video_coord_array_free(&batch->ca);
+   free(batch->quads);
+   batch->quads           = NULL;
+   batch->quads_allocated = 0;
+   batch->num_quads       = 0;
+   batch->num_groups      = 0;
+}
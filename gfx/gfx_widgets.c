@@ -87,6 +87,7 @@ const static gfx_widget_t* const widgets[] = {
    &gfx_widget_screenshot,
 #endif
    &gfx_widget_volume,
+   &gfx_widget_frame_profiler,
 #ifdef HAVE_CHEEVOS
    &gfx_widget_achievement_popup,
    &gfx_widget_leaderboard_display,
@@ -373,6 +373,7 @@ dispgfx_widget_t *dispwidget_get_ptr(void);
 
 extern const gfx_widget_t gfx_widget_screenshot;
 extern const gfx_widget_t gfx_widget_volume;
+extern const gfx_widget_t gfx_widget_frame_profiler;
 extern const gfx_widget_t gfx_widget_generic_message;
 extern const gfx_widget_t gfx_widget_libretro_message;
 extern const gfx_widget_t gfx_widget_progress_message;
@@ -208,7 +208,10 @@ enum display_flags
    GFX_CTX_FLAGS_SHADERS_HLSL,
    GFX_CTX_FLAGS_SHADERS_SLANG,
    GFX_CTX_FLAGS_SCREENSHOTS_SUPPORTED,
-   GFX_CTX_FLAGS_OVERLAY_BEHIND_MENU_SUPPORTED
+   GFX_CTX_FLAGS_OVERLAY_BEHIND_MENU_SUPPORTED,
+   /* Uses video_frame_info_t damage to update only
+    * the parts of a software frame that changed */
+   GFX_CTX_FLAGS_FRAME_DAMAGE
 };
 
 enum shader_uniform_type
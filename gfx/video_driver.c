@@ -24,6 +24,7 @@
 #endif
 
 #include <gfx/video_frame.h>
+#include <gfx/scaler/scaler.h>
 
 #include "../config.def.h"
 
@@ -40,6 +41,10 @@
 #include "video_thread_wrapper.h"
 #endif
 
+#ifdef HAVE_SLANG
+#include "drivers_shader/glslang_cache.h"
+#endif
+
 #ifdef HAVE_MENU
 #include "../menu/menu_driver.h"
 #endif
@@ -54,6 +59,7 @@
 #include "../ui/ui_companion_driver.h"
 #include "../driver.h"
 #include "../file_path_special.h"
+#include "../frame_profiler.h"
 #include "../list_special.h"
 #include "../retroarch.h"
 #include "../verbosity.h"
@@ -993,8 +999,21 @@ void recording_dump_frame(
 
       ffemu_data.pitch  = -ffemu_data.pitch;
    }
-   else
-      ffemu_data.is_dupe = !data;
+   else if (!data)
+      ffemu_data.is_dupe = true;
+   else if (config_get_ptr()->bools.video_frame_diff)
+   {
+      unsigned bpp = (video_st->pix_fmt == RETRO_PIXEL_FORMAT_XRGB8888)
+         ? 4 : 2;
+#ifdef HAVE_VIDEO_FILTER
+      if (video_st->state_filter && data == video_st->state_buffer)
+         bpp = video_st->state_out_bpp;
+#endif
+      /* An unchanged frame is encoded as a repeat of the last one,
+       * without converting or queueing it again */
+      ffemu_data.is_dupe = !frame_diff_update(&record_st->frame_diff,
+            data, width, height, pitch, bpp);
+   }
 
    record_st->driver->push_video(record_st->data, &ffemu_data);
 }
@@ -1393,7 +1412,7 @@ void video_driver_init_filter(enum retro_pixel_format colfmt_int,
 
    video_st->state_filter   = rarch_softfilter_new(
          settings->paths.path_softfilter_plugin,
-         RARCH_SOFTFILTER_THREADS_AUTO, colfmt, width, height);
+         settings->uints.video_filter_threads, colfmt, width, height);
 
    if (!video_st->state_filter)
    {
@@ -1518,6 +1537,19 @@ VIDEO_DRIVER_IS_THREADED_INTERNAL(video_st);
 #ifdef HAVE_VIDEO_FILTER
    video_driver_filter_free();
 #endif
+
+   if (video_st->frame_diff.frames)
+      RARCH_LOG("[Video]: Damage tracking: %.1f%% of %" PRIu64
+            " frames unchanged, %.1f%% of pixels updated per frame.\n",
+            100.0 * video_st->frame_diff.frames_unchanged
+            / video_st->frame_diff.frames,
+            video_st->frame_diff.frames,
+            video_st->frame_diff.pixels
+            ? 100.0 * video_st->frame_diff.pixels_changed
+            / video_st->frame_diff.pixels : 0.0);
+   frame_diff_free(&video_st->frame_diff);
+   memset(&video_st->frame_diff, 0, sizeof(video_st->frame_diff));
+   video_st->frame_diff_enable = false;
 #if defined(HAVE_CG) || defined(HAVE_GLSL) || defined(HAVE_SLANG) || defined(HAVE_HLSL)
    dir_free_shader(
          (struct rarch_dir_shader_list*)&video_st->dir_shader_list,
@@ -2710,6 +2742,21 @@ void video_driver_build_info(video_frame_info_t *video_info)
    video_info->fps_show                    = settings->bools.video_fps_show;
    video_info->memory_show                 = settings->bools.video_memory_show;
    video_info->statistics_show             = settings->bools.video_statistics_show;
+   if (video_info->statistics_show)
+   {
+      /* Set here rather than in video_driver_frame() so the
+       * threaded wrapper's video thread gets them too */
+      video_info->osd_stat_params.x           = 0.010f;
+      video_info->osd_stat_params.y           = 0.950f;
+      video_info->osd_stat_params.scale       = 1.0f;
+      video_info->osd_stat_params.full_screen = true;
+      video_info->osd_stat_params.drop_x      = -2;
+      video_info->osd_stat_params.drop_y      = -2;
+      video_info->osd_stat_params.drop_mod    = 0.3f;
+      video_info->osd_stat_params.drop_alpha  = 1.0f;
+      video_info->osd_stat_params.color       = COLOR_ABGR(
+            255, 255, 255, 255);
+   }
    video_info->framecount_show             = settings->bools.video_framecount_show;
    video_info->core_status_msg_show        = runloop_st->core_status_msg.set;
    video_info->aspect_ratio_idx            = settings->uints.video_aspect_ratio_idx;
@@ -2809,6 +2856,8 @@ void video_driver_build_info(video_frame_info_t *video_info)
       input_st->nonblocking_flag : false;
    video_info->input_driver_grab_mouse_state = input_st->grab_mouse_state;
    video_info->disp_userdata                 = disp_get_ptr();
+   video_info->damage                        = NULL;
+   video_info->damage_count                  = 0;
 
    video_info->userdata                      =
 VIDEO_DRIVER_GET_PTR_INTERNAL(video_st);
@@ -3240,6 +3289,26 @@ const char* video_driver_get_gpu_api_version_string(void)
    return video_st->gpu_api_version_string;
 }
 
+#ifdef HAVE_SLANG
+static void video_driver_init_shader_cache(settings_t *settings)
+{
+   char dir[PATH_MAX_LENGTH];
+   char base[PATH_MAX_LENGTH];
+
+   base[0] = '\0';
+   fill_pathname_application_special(base, sizeof(base),
+         APPLICATION_SPECIAL_DIRECTORY_CACHE);
+
+   if (string_is_empty(base))
+      dir[0] = '\0';
+   else
+      fill_pathname_join(dir, base, "shader_cache", sizeof(dir));
+
+   glslang_cache_init(dir,
+         (uint64_t)settings->uints.video_shader_cache_size << 20);
+}
+#endif
+
 bool video_driver_init_internal(bool *video_is_threaded, bool verbosity_enabled)
 {
    video_info_t video;
@@ -3261,6 +3330,13 @@ bool video_driver_init_internal(bool *video_is_threaded, bool verbosity_enabled)
       video_driver_init_filter(video_driver_pix_fmt, settings);
 #endif
 
+#ifdef HAVE_SLANG
+   video_driver_init_shader_cache(settings);
+#endif
+
+   scaler_init_simd(cpu_features_get());
+   frame_diff_init_simd(cpu_features_get());
+
    max_dim   = MAX(geom->max_width, geom->max_height);
    scale     = next_pow2(max_dim) / RARCH_SCALE_BASE;
    scale     = MAX(scale, 1);
@@ -3496,6 +3572,11 @@ VIDEO_DRIVER_IS_THREADED_INTERNAL(video_st);
       video_st->current_video->poke_interface(
             video_st->data, &video_st->poke);
 
+   /* Only worth comparing frames if the driver
+    * makes use of what changed */
+   video_st->frame_diff_enable = settings->bools.video_frame_diff
+      && video_driver_test_all_flags(GFX_CTX_FLAGS_FRAME_DAMAGE);
+
    if (video_st->current_video->viewport_info &&
          (!custom_vp->width  ||
           !custom_vp->height))
@@ -3602,6 +3683,9 @@ void video_driver_frame(const void *data, unsigned width,
    if (!video_driver_active)
       return;
 
+   frame_profiler_begin(FRAME_PROFILER_THREAD_MAIN,
+         FRAME_PROFILER_STAGE_VIDEO_FRAME);
+
    new_time                      = cpu_features_get_time_usec();
 
    if (data)
@@ -3882,6 +3966,32 @@ void video_driver_frame(const void *data, unsigned width,
    }
 #endif
 
+   if (     render_frame
+         && data
+         && data != RETRO_HW_FRAME_BUFFER_VALID)
+   {
+      if (     video_st->frame_diff_enable
+#ifdef HAVE_THREADS
+            && !VIDEO_DRIVER_IS_THREADED_INTERNAL(video_st)
+#endif
+         )
+      {
+         unsigned bpp = (video_driver_pix_fmt == RETRO_PIXEL_FORMAT_XRGB8888)
+            ? 4 : 2;
+#ifdef HAVE_VIDEO_FILTER
+         if (video_st->state_filter)
+            bpp = video_st->state_out_bpp;
+#endif
+         video_info.damage_count = frame_diff_update(&video_st->frame_diff,
+               data, width, height, pitch, bpp);
+         video_info.damage       = video_st->frame_diff.rects;
+      }
+      else
+         /* The driver gets this frame without damage,
+          * so the next one is compared with nothing */
+         frame_diff_invalidate(&video_st->frame_diff);
+   }
+
    if (runloop_st->msg_queue_size > 0)
    {
       /* If widgets are currently enabled, then
@@ -3938,10 +4048,6 @@ void video_driver_frame(const void *data, unsigned width,
       audio_statistics_t audio_stats;
       double stddev                          = 0.0;
       struct retro_system_av_info *av_info   = &video_st->av_info;
-      unsigned red                           = 255;
-      unsigned green                         = 255;
-      unsigned blue                          = 255;
-      unsigned alpha                         = 255;
 
       audio_stats.samples                    = 0;
       audio_stats.average_buffer_saturation  = 0.0f;
@@ -3951,17 +4057,6 @@ void video_driver_frame(const void *data, unsigned width,
 
       video_monitor_fps_statistics(NULL, &stddev, NULL);
 
-      video_info.osd_stat_params.x           = 0.010f;
-      video_info.osd_stat_params.y           = 0.950f;
-      video_info.osd_stat_params.scale       = 1.0f;
-      video_info.osd_stat_params.full_screen = true;
-      video_info.osd_stat_params.drop_x      = -2;
-      video_info.osd_stat_params.drop_y      = -2;
-      video_info.osd_stat_params.drop_mod    = 0.3f;
-      video_info.osd_stat_params.drop_alpha  = 1.0f;
-      video_info.osd_stat_params.color       = COLOR_ABGR(
-            red, green, blue, alpha);
-
       audio_compute_buffer_statistics(&audio_stats);
 
       snprintf(video_info.stat_text,
@@ -3992,15 +4087,51 @@ void video_driver_frame(const void *data, unsigned width,
             av_info->timing.fps,
             av_info->timing.sample_rate);
 
+#ifdef HAVE_THREADS
+      if (VIDEO_DRIVER_IS_THREADED_INTERNAL(video_st))
+      {
+         struct video_thread_stats thread_stats;
+         size_t _len = strlen(video_info.stat_text);
+
+         video_thread_get_stats(video_st->data, &thread_stats);
+         snprintf(video_info.stat_text + _len,
+               sizeof(video_info.stat_text) - _len,
+               "Threaded Video:\n -Frames pushed: %" PRIu64 "\n -Frames dropped: %" PRIu64 "\n"
+               " -Frames duplicated: %" PRIu64 "\n -Frames blocked: %" PRIu64 "\n",
+               thread_stats.pushed,
+               thread_stats.dropped,
+               thread_stats.duplicated,
+               thread_stats.blocked);
+      }
+#endif
+
+      if (video_st->frame_diff.frames)
+      {
+         const frame_diff_t *diff = &video_st->frame_diff;
+         size_t _len              = strlen(video_info.stat_text);
+
+         snprintf(video_info.stat_text + _len,
+               sizeof(video_info.stat_text) - _len,
+               "Damage Tracking:\n -Frames unchanged: %.2f %%\n -Pixels updated: %.2f %%\n",
+               100.0 * diff->frames_unchanged / diff->frames,
+               diff->pixels ? 100.0 * diff->pixels_changed / diff->pixels : 0.0);
+      }
+
       /* TODO/FIXME - add OSD chat text here */
    }
 
    if (render_frame && video_st->current_video && video_st->current_video->frame)
+   {
+      /* Taken out of the core run time the frame delay learns from */
+      retro_time_t present_start = cpu_features_get_time_usec();
       video_st->active = video_st->current_video->frame(
             video_st->data, data, width, height,
             video_st->frame_count, (unsigned)pitch,
             video_info.menu_screensaver_active || video_info.notifications_hidden ? "" : video_driver_msg,
             &video_info);
+      video_st->frame_present_time += cpu_features_get_time_usec()
+         - present_start;
+   }
 
    video_st->frame_count++;
 
@@ -4069,6 +4200,9 @@ void video_driver_frame(const void *data, unsigned width,
    else if (!video_info.crt_switch_resolution)
 #endif
       video_st->crt_switching_active = false;
+
+   frame_profiler_end(FRAME_PROFILER_THREAD_MAIN,
+         FRAME_PROFILER_STAGE_VIDEO_FRAME);
 }
 
 static void video_driver_reinit_context(settings_t *settings, int flags)
@@ -4104,162 +4238,10 @@ void video_driver_reinit(int flags)
    video_st->cache_context     = false;
 }
 
-#define FRAME_DELAY_AUTO_DEBUG 0
 void video_frame_delay_auto(video_driver_state_t *video_st, video_frame_delay_auto_t *vfda)
 {
-   unsigned i                    = 0;
-   unsigned frame_time           = 0;
-   unsigned frame_time_frames    = vfda->frame_time_interval;
-   unsigned frame_time_target    = 1000000.0f / vfda->refresh_rate;
-   unsigned frame_time_limit_min = frame_time_target * 1.30f;
-   unsigned frame_time_limit_med = frame_time_target * 1.50f;
-   unsigned frame_time_limit_max = frame_time_target * 1.90f;
-   unsigned frame_time_limit_cap = frame_time_target * 2.50f;
-   unsigned frame_time_limit_ign = frame_time_target * 3.75f;
-   unsigned frame_time_min       = frame_time_target;
-   unsigned frame_time_max       = frame_time_target;
-   unsigned frame_time_count_pos = 0;
-   unsigned frame_time_count_min = 0;
-   unsigned frame_time_count_med = 0;
-   unsigned frame_time_count_max = 0;
-   unsigned frame_time_count_ign = 0;
-   unsigned frame_time_index     =
-         (video_st->frame_time_count &
-         (MEASURE_FRAME_TIME_SAMPLES_COUNT - 1));
-
-   /* Calculate average frame time */
-   for (i = 1; i < frame_time_frames + 1; i++)
-   {
-      unsigned frame_time_i = 0;
-
-      if (i > frame_time_index)
-         continue;
-
-      frame_time_i = video_st->frame_time_samples[frame_time_index - i];
-
-      if (frame_time_max < frame_time_i)
-         frame_time_max = frame_time_i;
-      if (frame_time_min > frame_time_i)
-         frame_time_min = frame_time_i;
-
-      /* Count frames over the target */
-      if (frame_time_i > frame_time_target)
-      {
-         frame_time_count_pos++;
-         if (frame_time_i > frame_time_limit_min)
-            frame_time_count_min++;
-         if (frame_time_i > frame_time_limit_med)
-            frame_time_count_med++;
-         if (frame_time_i > frame_time_limit_max)
-            frame_time_count_max++;
-         if (frame_time_i > frame_time_limit_ign)
-            frame_time_count_ign++;
-
-         /* Limit maximum to prevent false positives */
-         if (frame_time_i > frame_time_limit_cap)
-            frame_time_i = frame_time_limit_cap;
-      }
-
-      frame_time += frame_time_i;
-   }
-
-   frame_time /= frame_time_frames;
-
-   /* Ignore values when core is doing internal frame skipping */
-   if (frame_time_count_ign > 0)
-      frame_time = 0;
-
-   /* Special handlings for different video driver frame timings */
-   if (frame_time < frame_time_limit_med && frame_time > frame_time_target)
-   {
-      unsigned frame_time_frames_half = frame_time_frames / 2;
-      unsigned frame_time_delta       = frame_time_max - frame_time_min;
-
-      /* Ensure outcome on certain conditions */
-      int mode = 0;
-
-      /* All frames are above the target */
-      if (frame_time_count_pos == frame_time_frames)
-         mode = 1;
-      /* At least half of interval frames are above minimum level */
-      else if (frame_time_count_min >= frame_time_frames_half)
-         mode = 2;
-      /* D3Dx stripe equalizer */
-      else if (
-               frame_time_count_pos == frame_time_frames_half
-            && frame_time_count_min >= 1
-            && frame_time_delta > (frame_time_target / 3)
-            && frame_time_delta < (frame_time_target / 2)
-            && frame_time > frame_time_target
-         )
-         mode = 3;
-      /* Boost med/max spikes */
-      else if (
-               frame_time_count_pos >= frame_time_frames_half
-            && (  frame_time_count_max > 0
-               || frame_time_count_med > 1)
-            && frame_time_count_max == frame_time_count_med
-            && frame_time_delta < frame_time_target
-         )
-         mode = 4;
-      /* Ignore */
-      else if (frame_time_delta > frame_time_target
-            && frame_time_count_med == 0
-         )
-         mode = -1;
-
-      if (mode > 0)
-      {
-#if FRAME_DELAY_AUTO_DEBUG
-         RARCH_LOG("[Video]: Frame delay nudge %d by mode %d.\n", frame_time, mode);
-#endif
-         frame_time = frame_time_limit_med;
-      }
-      else if (mode < 0)
-      {
-#if FRAME_DELAY_AUTO_DEBUG
-         RARCH_LOG("[Video]: Frame delay ignore %d.\n", frame_time);
-#endif
-         frame_time = 0;
-      }
-   }
-
-   /* Final output decision */
-   if (frame_time > frame_time_limit_min)
-   {
-      unsigned delay_decrease = 1;
-
-      /* Increase decrease the more frame time is off target */
-      if (frame_time > frame_time_limit_med && video_st->frame_delay_effective > delay_decrease)
-      {
-         delay_decrease++;
-         if (frame_time > frame_time_limit_max && video_st->frame_delay_effective > delay_decrease)
-            delay_decrease++;
-      }
-
-      vfda->decrease = delay_decrease;
-   }
-
-   vfda->time   = frame_time;
-   vfda->target = frame_time_target;
-
-#if FRAME_DELAY_AUTO_DEBUG
-   if (frame_time_index > frame_time_frames)
-      RARCH_LOG("[Video]: %5d / pos:%d min:%d med:%d max:%d / delta:%5d = %5d %5d %5d %5d %5d %5d %5d %5d\n",
-            frame_time,
-            frame_time_count_pos,
-            frame_time_count_min,
-            frame_time_count_med,
-            frame_time_count_max,
-            frame_time_max - frame_time_min,
-            video_st->frame_time_samples[frame_time_index - 1],
-            video_st->frame_time_samples[frame_time_index - 2],
-            video_st->frame_time_samples[frame_time_index - 3],
-            video_st->frame_time_samples[frame_time_index - 4],
-            video_st->frame_time_samples[frame_time_index - 5],
-            video_st->frame_time_samples[frame_time_index - 6],
-            video_st->frame_time_samples[frame_time_index - 7],
-            video_st->frame_time_samples[frame_time_index - 8]
-      );
-#endif
+   video_frame_delay_auto_samples(video_st->frame_time_samples,
+         (unsigned)(video_st->frame_time_count &
+            (MEASURE_FRAME_TIME_SAMPLES_COUNT - 1)),
+         video_st->frame_delay_effective, vfda);
 }
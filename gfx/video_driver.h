@@ -34,6 +34,7 @@
 
 #include <gfx/scaler/pixconv.h>
 #include <gfx/scaler/scaler.h>
+#include <gfx/frame_diff.h>
 
 #include "../configuration.h"
 #include "../input/input_driver.h"
@@ -52,6 +53,7 @@
 #include "video_coord_array.h"
 #include "video_shader_parse.h"
 #include "video_filter.h"
+#include "video_frame_delay.h"
 
 #define RARCH_SCALE_BASE 256
 
@@ -84,6 +86,9 @@
 
 #define MAX_VARIABLES 64
 
+/* Size of the statistics text, also kept by the threaded wrapper */
+#define VIDEO_STAT_TEXT_SIZE 768
+
 #ifdef HAVE_THREADS
 #define VIDEO_DRIVER_IS_THREADED_INTERNAL(video_st) ((!video_driver_is_hw_context() && video_st->threaded) ? true : false)
 #define VIDEO_DRIVER_LOCK(video_st) \
@@ -468,7 +473,13 @@ typedef struct video_frame_info
       bool full_screen;
    } osd_stat_params;
 
-   char stat_text[512];
+   char stat_text[VIDEO_STAT_TEXT_SIZE];
+
+   /* Parts of the frame that changed since the previous one,
+    * for drivers with GFX_CTX_FLAGS_FRAME_DAMAGE.
+    * NULL if unknown, in which case all of it may have. */
+   const struct frame_diff_rect *damage;
+   unsigned damage_count;
 
    bool widgets_active;
    bool notifications_hidden;
@@ -821,8 +832,11 @@ typedef struct
    struct retro_system_av_info av_info; /* double alignment */
    retro_time_t frame_time_samples[MEASURE_FRAME_TIME_SAMPLES_COUNT];
    retro_time_t core_frame_time;
+   retro_time_t frame_present_time;
    uint64_t frame_time_count;
    uint64_t frame_count;
+   frame_delay_learn_t frame_delay_learn;  /* uint64_t alignment */
+   frame_diff_t frame_diff;                /* uint64_t alignment */
    uint8_t *record_gpu_buffer;
 #ifdef HAVE_VIDEO_FILTER
    rarch_softfilter_t *state_filter;
@@ -951,6 +965,8 @@ typedef struct
 #ifdef HAVE_VIDEO_FILTER
    bool state_out_rgb32;
 #endif
+   /* Damage tracking is on and the driver can use it */
+   bool frame_diff_enable;
    bool crt_switching_active;
    bool force_fullscreen;
    bool threaded;
@@ -962,14 +978,6 @@ typedef struct
 #endif
 } video_driver_state_t;
 
-typedef struct video_frame_delay_auto {
-   float refresh_rate;
-   unsigned frame_time_interval;
-   unsigned decrease;
-   unsigned target;
-   unsigned time;
-} video_frame_delay_auto_t;
-
 extern struct aspect_ratio_elem aspectratio_lut[ASPECT_RATIO_END];
 
 bool video_driver_has_windowed(void);
@@ -15,6 +15,7 @@
  */
 
 #include <stdlib.h>
+#include <string.h>
 
 #include <file/file_path.h>
 #include <file/config_file_userdata.h>
@@ -28,13 +29,31 @@
 #include "../config.h"
 #endif
 
+#ifdef HAVE_THREADS
+#include <rthreads/rthreads.h>
+#include <rthreads/tpool.h>
+#endif
+
 #include "../frontend/frontend_driver.h"
 #include "../dynamic.h"
+#include "../frame_profiler.h"
 #include "../performance_counters.h"
 #include "../verbosity.h"
 #include "video_filter.h"
 #include "video_filters/softfilter.h"
 
+/* Oldest softfilter API still loaded. Plugs older
+ * than version 3 have no slice_halo. */
+#define SOFTFILTER_API_VERSION_MIN  2
+
+/* Bands are at least this many input rows high, smaller
+ * ones cost more in halo rows than they save. */
+#define SOFTFILTER_BAND_ROWS_MIN    16
+
+/* A few bands per thread, so that a thread which gets
+ * preempted doesn't hold up the whole frame. */
+#define SOFTFILTER_BANDS_PER_THREAD 4
+
 struct rarch_soft_plug
 {
 #ifdef HAVE_DYLIB
@@ -43,65 +62,110 @@ struct rarch_soft_plug
    const struct softfilter_implementation *impl;
 };
 
+/* One filter of the chain. */
+struct softfilter_stage
+{
+   const struct softfilter_implementation *impl;
+   /* One instance per band when the chain is split into
+    * bands, otherwise a single one for whole frames. */
+   void **instances;
+   /* num_packets packets for each instance */
+   struct softfilter_work_packet *packets;
+   /* Output of all but the last stage, only
+    * allocated when filtering whole frames */
+   uint8_t *frame_buf;
+   uint8_t *frame;
+   size_t frame_pitch;
+   unsigned num_instances;
+   unsigned num_packets;
+   unsigned out_bpp;
+   enum retro_pixel_format out_pix_fmt;
+};
+
 struct rarch_softfilter
 {
    config_file_t *conf;
 
-   const struct softfilter_implementation *impl;
-   void *impl_data;
-
    struct rarch_soft_plug *plugs;
    unsigned num_plugs;
 
+   struct softfilter_stage *stages;
+   unsigned num_stages;
+
    unsigned max_width, max_height;
    enum retro_pixel_format pix_fmt, out_pix_fmt;
 
-   struct softfilter_work_packet *packets;
+   /* Threads working on a frame, including the caller */
    unsigned threads;
 
+   /* Number of bands a frame may be split into,
+    * 0 if the chain has to filter whole frames. */
+   unsigned max_bands;
+   /* Input rows added above and below each band, so
+    * that the rows of the band itself come out right */
+   unsigned halo;
+   /* Vertical scale of the whole chain */
+   unsigned scale_y;
+
+   /* Two buffers per band for the output of the
+    * stages, scratch_size bytes each including
+    * scratch_pad bytes on either end */
+   uint8_t *scratch;
+   size_t scratch_size;
+   size_t scratch_pad;
+
+   /* Frame being filtered */
+   const uint8_t *input;
+   uint8_t *output;
+   size_t input_stride;
+   size_t output_stride;
+   unsigned width;
+   unsigned height;
+   unsigned num_bands;
+   /* Stage whose packets the jobs run,
+    * when filtering whole frames */
+   unsigned stage;
+
+   unsigned num_jobs;
+   unsigned next_job;
+
+   retro_time_t total_usec;
+   unsigned frames;
+
 #ifdef HAVE_THREADS
-   struct filter_thread_data *thread_data;
+   slock_t *job_lock;
 #endif
 };
 
 #ifdef HAVE_THREADS
-#include <rthreads/rthreads.h>
-
-struct filter_thread_data
-{
-   sthread_t *thread;
-   const struct softfilter_work_packet *packet;
-   scond_t *cond;
-   slock_t *lock;
-   void *userdata;
-   bool die;
-   bool done;
-};
-
-static void filter_thread_loop(void *data)
+/* Workers shared by every softfilter, kept for as
+ * long as one exists. The thread calling
+ * rarch_softfilter_process() works along with them. */
+static tpool_t *softfilter_pool      = NULL;
+static unsigned softfilter_pool_size = 0;
+static unsigned softfilter_pool_refs = 0;
+
+static bool softfilter_pool_acquire(unsigned workers)
 {
-   struct filter_thread_data *thr = (struct filter_thread_data*)data;
-
-   for (;;)
+   if (!softfilter_pool_refs)
    {
-      bool die;
-      slock_lock(thr->lock);
-      while (thr->done && !thr->die)
-         scond_wait(thr->cond, thr->lock);
-      die = thr->die;
-      slock_unlock(thr->lock);
-
-      if (die)
-         break;
+      if (!(softfilter_pool = tpool_create(workers)))
+         return false;
+      softfilter_pool_size = workers;
+   }
+
+   softfilter_pool_refs++;
+   return true;
+}
 
-      if (thr->packet && thr->packet->work)
-         thr->packet->work(thr->userdata, thr->packet->thread_data);
+static void softfilter_pool_release(void)
+{
+   if (!softfilter_pool_refs || --softfilter_pool_refs)
+      return;
 
-      slock_lock(thr->lock);
-      thr->done = true;
-      scond_signal(thr->cond);
-      slock_unlock(thr->lock);
-   }
+   tpool_destroy(softfilter_pool);
+   softfilter_pool      = NULL;
+   softfilter_pool_size = 0;
 }
 #endif
 
@@ -129,49 +193,73 @@ static const struct softfilter_config softfilter_config = {
    config_userdata_free,
 };
 
-static bool create_softfilter_graph(rarch_softfilter_t *filt,
-      enum retro_pixel_format in_pixel_format,
-      unsigned max_width, unsigned max_height,
-      softfilter_simd_mask_t cpu_features,
-      unsigned threads)
+static unsigned softfilter_slice_halo(
+      const struct softfilter_implementation *impl)
 {
-   unsigned input_fmts, input_fmt, output_fmts, i = 0;
-   struct config_file_userdata userdata;
-   char key[64], name[64];
+   if (impl->api_version < 3)
+      return SOFTFILTER_SLICE_NONE;
+   return impl->slice_halo;
+}
 
-   (void)i;
+/* A chain lists its filters as filter0, filter1 and so on,
+ * a single filter may just use "filter". */
+static void softfilter_stage_key(rarch_softfilter_t *filt,
+      unsigned index, char *key, size_t len)
+{
+   if (filt->num_stages > 1 || config_get_entry(filt->conf, "filters"))
+      snprintf(key, len, "filter%u", index);
+   else
+      strlcpy(key, "filter", len);
+}
 
-   key[0] = name[0] = '\0';
+/* Vertical scale of @stage, which has to be a whole
+ * number that doesn't change with the height. */
+static bool softfilter_stage_scale_y(struct softfilter_stage *stage,
+      unsigned max_width, unsigned max_height, unsigned *scale)
+{
+   unsigned width1, height1, width2, height2, width_max, height_max;
+   void *instance = stage->instances[0];
+
+   stage->impl->query_output_size(instance,
+         &width1, &height1, max_width, 1);
+   stage->impl->query_output_size(instance,
+         &width2, &height2, max_width, 2);
+   stage->impl->query_output_size(instance,
+         &width_max, &height_max, max_width, max_height);
+
+   if (     !height1
+         || height2    != 2 * height1
+         || height_max != max_height * height1
+         || width1     != width2
+         || width1     != width_max)
+      return false;
 
-   snprintf(key, sizeof(key), "filter");
+   *scale = height1;
+   return true;
+}
 
-   if (!config_get_array(filt->conf, key, name, sizeof(name)))
-   {
-      RARCH_ERR("Could not find 'filter' array in config.\n");
-      return false;
-   }
+static bool softfilter_create_stage(rarch_softfilter_t *filt,
+      unsigned index, enum retro_pixel_format in_pixel_format,
+      unsigned max_width, unsigned max_height,
+      softfilter_simd_mask_t cpu_features)
+{
+   unsigned i, input_fmts, input_fmt, output_fmts;
+   struct config_file_userdata userdata;
+   char key[64];
+   struct softfilter_stage *stage = &filt->stages[index];
+   /* Each band is filtered by a single thread */
+   unsigned threads               = filt->max_bands ? 1 : filt->threads;
 
-   if (filt->num_plugs == 0)
-   {
-      RARCH_ERR("No filter plugs found. Exiting...\n");
-      return false;
-   }
+   key[0] = '\0';
 
-   filt->impl = softfilter_find_implementation(filt, name);
-   if (!filt->impl)
-   {
-      RARCH_ERR("Could not find implementation.\n");
-      return false;
-   }
+   softfilter_stage_key(filt, index, key, sizeof(key));
 
    userdata.conf = filt->conf;
    /* Index-specific configs take priority over ident-specific. */
    userdata.prefix[0] = key;
-   userdata.prefix[1] = filt->impl->short_ident;
+   userdata.prefix[1] = stage->impl->short_ident;
 
-   /* Simple assumptions. */
-   filt->pix_fmt = in_pixel_format;
-   input_fmts = filt->impl->query_input_formats();
+   input_fmts = stage->impl->query_input_formats();
 
    switch (in_pixel_format)
    {
@@ -187,82 +275,191 @@ static bool create_softfilter_graph(rarch_softfilter_t *filt,
 
    if (!(input_fmt & input_fmts))
    {
-      RARCH_ERR("Softfilter does not support input format.\n");
+      RARCH_ERR("Softfilter %s does not support input format.\n",
+            stage->impl->short_ident);
       return false;
    }
 
-   output_fmts = filt->impl->query_output_formats(input_fmt);
+   output_fmts = stage->impl->query_output_formats(input_fmt);
    /* If we have a match of input/output formats, use that. */
    if (output_fmts & input_fmt)
-      filt->out_pix_fmt = in_pixel_format;
+      stage->out_pix_fmt = in_pixel_format;
    else if (output_fmts & SOFTFILTER_FMT_XRGB8888)
-      filt->out_pix_fmt = RETRO_PIXEL_FORMAT_XRGB8888;
+      stage->out_pix_fmt = RETRO_PIXEL_FORMAT_XRGB8888;
    else if (output_fmts & SOFTFILTER_FMT_RGB565)
-      filt->out_pix_fmt = RETRO_PIXEL_FORMAT_RGB565;
+      stage->out_pix_fmt = RETRO_PIXEL_FORMAT_RGB565;
    else
    {
       RARCH_ERR("Did not find suitable output format for softfilter.\n");
       return false;
    }
 
-   filt->max_width = max_width;
-   filt->max_height = max_height;
+   stage->out_bpp       = (stage->out_pix_fmt == RETRO_PIXEL_FORMAT_XRGB8888)
+      ? sizeof(uint32_t) : sizeof(uint16_t);
+   stage->num_instances = filt->max_bands ? filt->max_bands : 1;
+   stage->instances     = (void**)
+      calloc(stage->num_instances, sizeof(*stage->instances));
+   if (!stage->instances)
+      return false;
 
-   filt->impl_data = filt->impl->create(
-         &softfilter_config, input_fmt, input_fmt, max_width, max_height,
-         threads != RARCH_SOFTFILTER_THREADS_AUTO ? threads :
-         cpu_features_get_core_amount(), cpu_features,
-         &userdata);
-   if (!filt->impl_data)
+   for (i = 0; i < stage->num_instances; i++)
    {
-      RARCH_ERR("Failed to create softfilter state.\n");
-      return false;
+      stage->instances[i] = stage->impl->create(
+            &softfilter_config, input_fmt, input_fmt, max_width, max_height,
+            threads, cpu_features, &userdata);
+      if (!stage->instances[i])
+      {
+         RARCH_ERR("Failed to create softfilter state.\n");
+         return false;
+      }
    }
 
-   threads = filt->impl->query_num_threads(filt->impl_data);
-   if (!threads)
+   stage->num_packets = stage->impl->query_num_threads(stage->instances[0]);
+   if (!stage->num_packets)
    {
       RARCH_ERR("Invalid number of threads.\n");
       return false;
    }
 
-   filt->threads = threads;
-   RARCH_LOG("Using %u threads for softfilter.\n", threads);
-
-   filt->packets = (struct softfilter_work_packet*)
-      calloc(threads, sizeof(*filt->packets));
-   if (!filt->packets)
+   stage->packets = (struct softfilter_work_packet*)calloc(
+         stage->num_instances * stage->num_packets, sizeof(*stage->packets));
+   if (!stage->packets)
    {
       RARCH_ERR("Failed to allocate softfilter packets.\n");
       return false;
    }
 
-#ifdef HAVE_THREADS
-   if (filt->threads > 1)
+   return true;
+}
+
+static bool create_softfilter_graph(rarch_softfilter_t *filt,
+      enum retro_pixel_format in_pixel_format,
+      unsigned max_width, unsigned max_height,
+      softfilter_simd_mask_t cpu_features)
+{
+   unsigned i;
+   unsigned num_stages             = 1;
+   unsigned width                  = max_width;
+   unsigned height                 = max_height;
+   bool banded                     = true;
+   enum retro_pixel_format pix_fmt = in_pixel_format;
+
+   if (filt->num_plugs == 0)
    {
-      filt->thread_data = (struct filter_thread_data*)
-         calloc(threads, sizeof(*filt->thread_data));
-      if (!filt->thread_data)
+      RARCH_ERR("No filter plugs found. Exiting...\n");
+      return false;
+   }
+
+   if (     config_get_entry(filt->conf, "filters")
+         && (!config_get_uint(filt->conf, "filters", &num_stages)
+            || !num_stages))
+   {
+      RARCH_ERR("Invalid number of filters in config.\n");
+      return false;
+   }
+
+   filt->stages = (struct softfilter_stage*)
+      calloc(num_stages, sizeof(*filt->stages));
+   if (!filt->stages)
+      return false;
+   filt->num_stages = num_stages;
+
+   for (i = 0; i < num_stages; i++)
+   {
+      char key[64], name[64];
+      struct softfilter_stage *stage = &filt->stages[i];
+
+      key[0] = name[0] = '\0';
+
+      softfilter_stage_key(filt, i, key, sizeof(key));
+
+      if (!config_get_array(filt->conf, key, name, sizeof(name)))
+      {
+         RARCH_ERR("Could not find '%s' array in config.\n", key);
          return false;
+      }
 
-      for (i = 0; i < threads; i++)
+      stage->impl = softfilter_find_implementation(filt, name);
+      if (!stage->impl)
       {
-         filt->thread_data[i].userdata = filt->impl_data;
-         filt->thread_data[i].done     = true;
+         RARCH_ERR("Could not find implementation: %s.\n", name);
+         return false;
+      }
 
-         filt->thread_data[i].lock     = slock_new();
-         if (!filt->thread_data[i].lock)
-            return false;
-         filt->thread_data[i].cond     = scond_new();
-         if (!filt->thread_data[i].cond)
+      if (softfilter_slice_halo(stage->impl) == SOFTFILTER_SLICE_NONE)
+         banded = false;
+   }
+
+   filt->pix_fmt    = in_pixel_format;
+   filt->max_width  = max_width;
+   filt->max_height = max_height;
+   filt->scale_y    = 1;
+
+   if (banded)
+   {
+      filt->max_bands = filt->threads * SOFTFILTER_BANDS_PER_THREAD;
+      if (filt->max_bands > max_height / SOFTFILTER_BAND_ROWS_MIN)
+         filt->max_bands = MAX(max_height / SOFTFILTER_BAND_ROWS_MIN, 1);
+   }
+
+   for (i = 0; i < num_stages; i++)
+   {
+      unsigned out_width, out_height;
+      struct softfilter_stage *stage = &filt->stages[i];
+
+      if (!softfilter_create_stage(filt, i, pix_fmt,
+               width, height, cpu_features))
+         return false;
+
+      stage->impl->query_output_size(stage->instances[0],
+            &out_width, &out_height, width, height);
+
+      if (filt->max_bands)
+      {
+         unsigned scale_y;
+         unsigned halo = stage->impl->slice_halo;
+
+         if (!softfilter_stage_scale_y(stage, width, height, &scale_y))
+         {
+            RARCH_ERR("Softfilter %s does not scale by a whole number.\n",
+                  stage->impl->short_ident);
             return false;
-         filt->thread_data[i].thread   = sthread_create(
-               filter_thread_loop, &filt->thread_data[i]);
-         if (!filt->thread_data[i].thread)
+         }
+
+         /* Halo of this stage in rows of the chain's input */
+         filt->halo    += (halo + filt->scale_y - 1) / filt->scale_y;
+         filt->scale_y *= scale_y;
+      }
+      else if (i < num_stages - 1)
+      {
+         /* Two rows of padding on either end, filters
+          * may read a little past the edges of a frame. */
+         size_t pad         = 2 * out_width * stage->out_bpp;
+
+         stage->frame_pitch = out_width * stage->out_bpp;
+         stage->frame_buf   = (uint8_t*)malloc(
+               stage->frame_pitch * out_height + 2 * pad);
+         if (!stage->frame_buf)
+         {
+            RARCH_ERR("Failed to allocate softfilter frame.\n");
             return false;
+         }
+         stage->frame       = stage->frame_buf + pad;
       }
+
+      pix_fmt = stage->out_pix_fmt;
+      width   = out_width;
+      height  = out_height;
    }
-#endif
+
+   filt->out_pix_fmt = pix_fmt;
+
+   if (filt->max_bands)
+      RARCH_LOG("[SoftFilter]: %u filter(s) on %u thread(s), up to %u bands of a frame.\n",
+            num_stages, filt->threads, filt->max_bands);
+   else
+      RARCH_LOG("[SoftFilter]: %u filter(s) on %u thread(s), whole frames.\n",
+            num_stages, filt->threads);
 
    return true;
 }
@@ -385,7 +582,8 @@ static bool append_softfilter_plugs(rarch_softfilter_t *filt,
          continue;
       }
 
-      if (impl->api_version != SOFTFILTER_API_VERSION)
+      if (impl->api_version < SOFTFILTER_API_VERSION_MIN
+            || impl->api_version > SOFTFILTER_API_VERSION)
       {
          dylib_close(lib);
          continue;
@@ -467,8 +665,24 @@ rarch_softfilter_t *rarch_softfilter_new(const char *filter_config,
       string_list_free(plugs);
    plugs = NULL;
 
+   if (threads == RARCH_SOFTFILTER_THREADS_AUTO)
+      threads = cpu_features_get_core_amount();
+   filt->threads = 1;
+
+#ifdef HAVE_THREADS
+   if (threads > 1 && softfilter_pool_acquire(threads - 1))
+   {
+      if (!(filt->job_lock = slock_new()))
+      {
+         softfilter_pool_release();
+         goto error;
+      }
+      filt->threads = MIN(threads, softfilter_pool_size + 1);
+   }
+#endif
+
    if (!create_softfilter_graph(filt, in_pixel_format,
-            max_width, max_height, cpu_features, threads))
+            max_width, max_height, cpu_features))
    {
       RARCH_ERR("[SoftFitler]: Failed to create softfilter graph...\n");
       goto error;
@@ -492,9 +706,30 @@ void rarch_softfilter_free(rarch_softfilter_t *filt)
    if (!filt)
       return;
 
-   free(filt->packets);
-   if (filt->impl && filt->impl_data)
-      filt->impl->destroy(filt->impl_data);
+   if (filt->frames)
+      RARCH_LOG("[SoftFilter]: %u us per frame on average over %u frames, %u thread(s).\n",
+            (unsigned)(filt->total_usec / filt->frames),
+            filt->frames, filt->threads);
+
+   for (i = 0; i < filt->num_stages; i++)
+   {
+      unsigned j;
+      struct softfilter_stage *stage = &filt->stages[i];
+
+      if (stage->instances)
+      {
+         for (j = 0; j < stage->num_instances; j++)
+         {
+            if (stage->instances[j])
+               stage->impl->destroy(stage->instances[j]);
+         }
+      }
+      free(stage->instances);
+      free(stage->packets);
+      free(stage->frame_buf);
+   }
+   free(filt->stages);
+   free(filt->scratch);
 
 #ifdef HAVE_DYLIB
    for (i = 0; i < filt->num_plugs; i++)
@@ -506,23 +741,10 @@ void rarch_softfilter_free(rarch_softfilter_t *filt)
 #endif
 
 #ifdef HAVE_THREADS
-   if (filt->threads > 1)
+   if (filt->job_lock)
    {
-      for (i = 0; i < filt->threads; i++)
-      {
-         if (!&filt->thread_data[i])
-            continue;
-         if (!filt->thread_data[i].thread)
-            continue;
-         slock_lock(filt->thread_data[i].lock);
-         filt->thread_data[i].die = true;
-         scond_signal(filt->thread_data[i].cond);
-         slock_unlock(filt->thread_data[i].lock);
-         sthread_join(filt->thread_data[i].thread);
-         slock_free(filt->thread_data[i].lock);
-         scond_free(filt->thread_data[i].cond);
-      }
-      free(filt->thread_data);
+      slock_free(filt->job_lock);
+      softfilter_pool_release();
    }
 #endif
 
@@ -543,9 +765,20 @@ void rarch_softfilter_get_output_size(rarch_softfilter_t *filt,
       unsigned *out_width, unsigned *out_height,
       unsigned width, unsigned height)
 {
-   if (filt && filt->impl && filt->impl->query_output_size)
-      filt->impl->query_output_size(filt->impl_data, out_width,
-            out_height, width, height);
+   unsigned i;
+
+   if (!filt || !filt->stages)
+      return;
+
+   for (i = 0; i < filt->num_stages; i++)
+   {
+      struct softfilter_stage *stage = &filt->stages[i];
+      stage->impl->query_output_size(stage->instances[0],
+            &width, &height, width, height);
+   }
+
+   *out_width  = width;
+   *out_height = height;
 }
 
 enum retro_pixel_format rarch_softfilter_get_output_format(
@@ -554,51 +787,270 @@ enum retro_pixel_format rarch_softfilter_get_output_format(
    return filt->out_pix_fmt;
 }
 
+/* Runs every stage of the chain on the rows of one band,
+ * plus the halo rows around it. */
+static void softfilter_process_band(rarch_softfilter_t *filt,
+      unsigned band)
+{
+   unsigned i;
+   unsigned y0         = (unsigned)((uint64_t)filt->height
+         * band / filt->num_bands);
+   unsigned y1         = (unsigned)((uint64_t)filt->height
+         * (band + 1) / filt->num_bands);
+   unsigned r0         = (y0 > filt->halo) ? y0 - filt->halo : 0;
+   unsigned r1         = MIN(y1 + filt->halo, filt->height);
+   unsigned width      = filt->width;
+   unsigned height     = r1 - r0;
+   const uint8_t *in   = filt->input + r0 * filt->input_stride;
+   size_t in_stride    = filt->input_stride;
+   uint8_t *scratch    = filt->scratch
+      + 2 * band * filt->scratch_size + filt->scratch_pad;
+   uint8_t *output     = filt->output
+      + (size_t)y0 * filt->scale_y * filt->output_stride;
+
+   if (y0 == y1)
+      return;
+
+   for (i = 0; i < filt->num_stages; i++)
+   {
+      unsigned j, out_width, out_height;
+      uint8_t *out;
+      size_t out_stride;
+      struct softfilter_stage *stage         = &filt->stages[i];
+      void *instance                         = stage->instances[band];
+      struct softfilter_work_packet *packets = stage->packets
+         + band * stage->num_packets;
+
+      stage->impl->query_output_size(instance,
+            &out_width, &out_height, width, height);
+
+      /* Without a halo the band's output is exactly
+       * what belongs in the frame */
+      if (i == filt->num_stages - 1 && !filt->halo)
+      {
+         out        = output;
+         out_stride = filt->output_stride;
+      }
+      else
+      {
+         out        = scratch + (i & 1) * filt->scratch_size;
+         out_stride = out_width * stage->out_bpp;
+      }
+
+      if (stage->impl->get_work_packets)
+         stage->impl->get_work_packets(instance, packets,
+               out, out_stride, in, width, height, in_stride);
+
+      for (j = 0; j < stage->num_packets; j++)
+         packets[j].work(instance, packets[j].thread_data);
+
+      in        = out;
+      in_stride = out_stride;
+      width     = out_width;
+      height    = out_height;
+   }
+
+   if (filt->halo)
+   {
+      /* Only keep the rows of the band itself */
+      unsigned rows   = (y1 - y0) * filt->scale_y;
+      size_t row_size = width
+         * filt->stages[filt->num_stages - 1].out_bpp;
+
+      in += (size_t)(y0 - r0) * filt->scale_y * in_stride;
+
+      for (i = 0; i < rows; i++)
+         memcpy(output + i * filt->output_stride,
+               in + i * in_stride, row_size);
+   }
+}
+
+static void softfilter_run_jobs(void *data)
+{
+   rarch_softfilter_t *filt = (rarch_softfilter_t*)data;
+
+   for (;;)
+   {
+      unsigned job;
+
+#ifdef HAVE_THREADS
+      if (filt->job_lock)
+         slock_lock(filt->job_lock);
+#endif
+      job = filt->next_job;
+      if (job < filt->num_jobs)
+         filt->next_job++;
+#ifdef HAVE_THREADS
+      if (filt->job_lock)
+         slock_unlock(filt->job_lock);
+#endif
+
+      if (job >= filt->num_jobs)
+         break;
+
+      if (filt->max_bands)
+         softfilter_process_band(filt, job);
+      else
+      {
+         struct softfilter_stage *stage = &filt->stages[filt->stage];
+         stage->packets[job].work(stage->instances[0],
+               stage->packets[job].thread_data);
+      }
+   }
+}
+
+/* Jobs are handed out one at a time to whichever thread
+ * asks first, so the ones that are done early take over
+ * the jobs that are left. Returns once all of them are
+ * done. */
+static void softfilter_run(rarch_softfilter_t *filt, unsigned num_jobs)
+{
+   filt->num_jobs = num_jobs;
+   filt->next_job = 0;
+
+#ifdef HAVE_THREADS
+   if (filt->job_lock && num_jobs > 1)
+   {
+      unsigned i;
+      unsigned helpers = MIN(num_jobs, filt->threads) - 1;
+
+      for (i = 0; i < helpers; i++)
+         tpool_add_work(softfilter_pool, softfilter_run_jobs, filt);
+
+      softfilter_run_jobs(filt);
+      tpool_wait(softfilter_pool);
+      return;
+   }
+#endif
+
+   softfilter_run_jobs(filt);
+}
+
+/* Grows the band buffers to fit the current frame. */
+static bool softfilter_reserve_scratch(rarch_softfilter_t *filt,
+      unsigned bands)
+{
+   unsigned i;
+   size_t size, pad;
+   size_t frame_size = 0;
+   size_t row_max    = 0;
+   unsigned width    = filt->width;
+   unsigned height   = (filt->height + bands - 1) / bands + 2 * filt->halo;
+
+   if (filt->num_stages == 1 && !filt->halo)
+      return true;
+
+   for (i = 0; i < filt->num_stages; i++)
+   {
+      size_t row;
+      struct softfilter_stage *stage = &filt->stages[i];
+
+      stage->impl->query_output_size(stage->instances[0],
+            &width, &height, width, height);
+
+      row = width * stage->out_bpp;
+      if (row * height > frame_size)
+         frame_size = row * height;
+      if (row > row_max)
+         row_max = row;
+   }
+
+   /* Two rows of padding on either end, filters
+    * may read a little past the edges of a frame. */
+   pad  = 2 * row_max;
+   size = frame_size + 2 * pad;
+
+   if (size <= filt->scratch_size && pad <= filt->scratch_pad)
+      return true;
+
+   free(filt->scratch);
+   filt->scratch_size = 0;
+   filt->scratch_pad  = 0;
+
+   if (!(filt->scratch = (uint8_t*)calloc(2 * filt->max_bands, size)))
+      return false;
+
+   filt->scratch_size = size;
+   filt->scratch_pad  = pad;
+   return true;
+}
+
 void rarch_softfilter_process(rarch_softfilter_t *filt,
       void *output, size_t output_stride,
       const void *input, unsigned width, unsigned height,
       size_t input_stride)
 {
    unsigned i;
+   retro_time_t start;
 
-   if (!filt)
+   if (!filt || !filt->stages)
       return;
 
-   if (filt->impl && filt->impl->get_work_packets)
-      filt->impl->get_work_packets(filt->impl_data, filt->packets,
-            output, output_stride, input, width, height, input_stride);
+   frame_profiler_begin(FRAME_PROFILER_THREAD_MAIN,
+         FRAME_PROFILER_STAGE_SOFTFILTER);
 
-#ifdef HAVE_THREADS
-   if (filt->threads > 1)
+   start               = cpu_features_get_time_usec();
+   filt->input         = (const uint8_t*)input;
+   filt->output        = (uint8_t*)output;
+   filt->input_stride  = input_stride;
+   filt->output_stride = output_stride;
+   filt->width         = width;
+   filt->height        = height;
+
+   if (filt->max_bands)
    {
-      /* Fire off workers */
-      for (i = 0; i < filt->threads; i++)
+      unsigned bands = height / SOFTFILTER_BAND_ROWS_MIN;
+
+      if (bands > filt->max_bands)
+         bands = filt->max_bands;
+      if (!bands)
+         bands = 1;
+
+      if (softfilter_reserve_scratch(filt, bands))
       {
-#if 0
-         RARCH_LOG("Firing off filter thread %u ...\n", i);
-#endif
-         filt->thread_data[i].packet = &filt->packets[i];
-         slock_lock(filt->thread_data[i].lock);
-         filt->thread_data[i].done = false;
-         scond_signal(filt->thread_data[i].cond);
-         slock_unlock(filt->thread_data[i].lock);
+         filt->num_bands = bands;
+         softfilter_run(filt, bands);
       }
+      else
+         RARCH_ERR("[SoftFilter]: Failed to allocate band buffers.\n");
+   }
+   else
+   {
+      const uint8_t *in = (const uint8_t*)input;
 
-      /* Wait for workers */
-      for (i = 0; i < filt->threads; i++)
+      for (i = 0; i < filt->num_stages; i++)
       {
-#if 0
-         RARCH_LOG("Waiting for filter thread %u ...\n", i);
-#endif
-         slock_lock(filt->thread_data[i].lock);
-         while (!filt->thread_data[i].done)
-            scond_wait(filt->thread_data[i].cond, filt->thread_data[i].lock);
-         slock_unlock(filt->thread_data[i].lock);
+         unsigned out_width, out_height;
+         struct softfilter_stage *stage = &filt->stages[i];
+         bool last                      = (i == filt->num_stages - 1);
+         uint8_t *out                   = last
+            ? (uint8_t*)output : stage->frame;
+         size_t out_stride              = last
+            ? output_stride    : stage->frame_pitch;
+
+         stage->impl->query_output_size(stage->instances[0],
+               &out_width, &out_height, width, height);
+
+         if (stage->impl->get_work_packets)
+            stage->impl->get_work_packets(stage->instances[0],
+                  stage->packets, out, out_stride,
+                  in, width, height, input_stride);
+
+         /* Every packet of a stage is done before the next
+          * stage starts, as that one reads their output */
+         filt->stage = i;
+         softfilter_run(filt, stage->num_packets);
+
+         in           = out;
+         input_stride = out_stride;
+         width        = out_width;
+         height       = out_height;
       }
-      return;
    }
-#endif
 
-   for (i = 0; i < filt->threads; i++)
-      filt->packets[i].work(filt->impl_data, filt->packets[i].thread_data);
+   filt->total_usec += cpu_features_get_time_usec() - start;
+   filt->frames++;
+
+   frame_profiler_end(FRAME_PROFILER_THREAD_MAIN,
+         FRAME_PROFILER_STAGE_SOFTFILTER);
 }
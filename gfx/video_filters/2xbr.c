@@ -744,6 +744,7 @@ static const struct softfilter_implementation twoxbr_generic = {
    SOFTFILTER_API_VERSION,
    "2xBR",
    "2xbr",
+   2,
 };
 
 const struct softfilter_implementation *softfilter_get_implementation(
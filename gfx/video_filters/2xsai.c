@@ -375,6 +375,7 @@ static const struct softfilter_implementation twoxsai_generic = {
    SOFTFILTER_API_VERSION,
    "2xSaI",
    "2xsai",
+   2,
 };
 
 const struct softfilter_implementation *softfilter_get_implementation(
@@ -289,6 +289,7 @@ static const struct softfilter_implementation blargg_ntsc_snes_generic = {
    SOFTFILTER_API_VERSION,
    "Blargg NTSC SNES",
    "blargg_ntsc_snes",
+   SOFTFILTER_SLICE_NONE,
 };
 
 const struct softfilter_implementation *softfilter_get_implementation(
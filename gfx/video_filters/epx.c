@@ -258,6 +258,7 @@ static const struct softfilter_implementation epx_generic = {
    SOFTFILTER_API_VERSION,
    "EPX",
    "epx",
+   1,
 };
 
 const struct softfilter_implementation *softfilter_get_implementation(
@@ -386,6 +386,7 @@ static const struct softfilter_implementation gameboy3x_generic = {
    SOFTFILTER_API_VERSION,
    "Gameboy3x",
    "gameboy3x",
+   0,
 };
 
 const struct softfilter_implementation *softfilter_get_implementation(
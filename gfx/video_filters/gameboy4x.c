@@ -444,6 +444,7 @@ static const struct softfilter_implementation gameboy4x_generic = {
    SOFTFILTER_API_VERSION,
    "Gameboy4x",
    "gameboy4x",
+   0,
 };
 
 const struct softfilter_implementation *softfilter_get_implementation(
@@ -235,6 +235,7 @@ static const struct softfilter_implementation grid2x_generic = {
    SOFTFILTER_API_VERSION,
    "Grid2x",
    "grid2x",
+   0,
 };
 
 const struct softfilter_implementation *softfilter_get_implementation(
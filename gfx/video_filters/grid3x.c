@@ -251,6 +251,7 @@ static const struct softfilter_implementation grid3x_generic = {
    SOFTFILTER_API_VERSION,
    "Grid3x",
    "grid3x",
+   0,
 };
 
 const struct softfilter_implementation *softfilter_get_implementation(
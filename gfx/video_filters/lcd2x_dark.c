@@ -203,6 +203,7 @@ static const struct softfilter_implementation lcd2x_dark_generic = {
    SOFTFILTER_API_VERSION,
    "LCD2x_dark",
    "lcd2x_dark",
+   0,
 };
 
 const struct softfilter_implementation *softfilter_get_implementation(
@@ -203,6 +203,7 @@ static const struct softfilter_implementation lcd2x_light_generic = {
    SOFTFILTER_API_VERSION,
    "LCD2x_light",
    "lcd2x_light",
+   0,
 };
 
 const struct softfilter_implementation *softfilter_get_implementation(
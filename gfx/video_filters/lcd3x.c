@@ -201,6 +201,7 @@ static const struct softfilter_implementation lcd3x_generic = {
    SOFTFILTER_API_VERSION,
    "LCD3x",
    "lcd3x",
+   0,
 };
 
 const struct softfilter_implementation *softfilter_get_implementation(
@@ -213,6 +213,7 @@ static const struct softfilter_implementation lcd3x_dark_generic = {
    SOFTFILTER_API_VERSION,
    "LCD3x_dark",
    "lcd3x_dark",
+   0,
 };
 
 const struct softfilter_implementation *softfilter_get_implementation(
@@ -213,6 +213,7 @@ static const struct softfilter_implementation lcd3x_light_generic = {
    SOFTFILTER_API_VERSION,
    "LCD3x_light",
    "lcd3x_light",
+   0,
 };
 
 const struct softfilter_implementation *softfilter_get_implementation(
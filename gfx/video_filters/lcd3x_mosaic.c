@@ -213,6 +213,7 @@ static const struct softfilter_implementation lcd3x_mosaic_generic = {
    SOFTFILTER_API_VERSION,
    "LCD3x_mosaic",
    "lcd3x_mosaic",
+   0,
 };
 
 const struct softfilter_implementation *softfilter_get_implementation(
@@ -277,6 +277,7 @@ static const struct softfilter_implementation lq2x_generic = {
    SOFTFILTER_API_VERSION,
    "LQ2x",
    "lq2x",
+   1,
 };
 
 const struct softfilter_implementation *softfilter_get_implementation(
@@ -231,6 +231,7 @@ static const struct softfilter_implementation normal2x_generic = {
    SOFTFILTER_API_VERSION,
    "Normal2x",
    "normal2x",
+   0,
 };
 
 const struct softfilter_implementation *softfilter_get_implementation(
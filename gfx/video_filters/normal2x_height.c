@@ -203,6 +203,7 @@ static const struct softfilter_implementation normal2x_height_generic = {
    SOFTFILTER_API_VERSION,
    "Normal2x Height",
    "normal2x_height",
+   0,
 };
 
 const struct softfilter_implementation *softfilter_get_implementation(
@@ -205,6 +205,7 @@ static const struct softfilter_implementation normal2x_width_generic = {
    SOFTFILTER_API_VERSION,
    "Normal2x Width",
    "normal2x_width",
+   0,
 };
 
 const struct softfilter_implementation *softfilter_get_implementation(
@@ -200,6 +200,7 @@ static const struct softfilter_implementation normal3x_generic = {
    SOFTFILTER_API_VERSION,
    "Normal3x",
    "normal3x",
+   0,
 };
 
 const struct softfilter_implementation *softfilter_get_implementation(
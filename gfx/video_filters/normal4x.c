@@ -251,6 +251,7 @@ static const struct softfilter_implementation normal4x_generic = {
    SOFTFILTER_API_VERSION,
    "Normal4x",
    "normal4x",
+   0,
 };
 
 const struct softfilter_implementation *softfilter_get_implementation(
@@ -485,6 +485,7 @@ static const struct softfilter_implementation phosphor2x_generic = {
    SOFTFILTER_API_VERSION,
    "Phosphor2x",
    "phosphor2x",
+   0,
 };
 
 const struct softfilter_implementation *softfilter_get_implementation(
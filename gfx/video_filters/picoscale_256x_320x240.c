@@ -500,6 +500,7 @@ static const struct softfilter_implementation picoscale_256x_320x240_generic = {
    SOFTFILTER_API_VERSION,
    "Picoscale_256x-320x240",
    "picoscale_256x_320x240",
+   SOFTFILTER_SLICE_NONE,
 };
 
 const struct softfilter_implementation *softfilter_get_implementation(
@@ -243,6 +243,7 @@ static const struct softfilter_implementation scale2x_generic = {
    SOFTFILTER_API_VERSION,
    "Scale2x",
    "scale2x",
+   1,
 };
 
 const struct softfilter_implementation *softfilter_get_implementation(
@@ -235,6 +235,7 @@ static const struct softfilter_implementation scanline2x_generic = {
    SOFTFILTER_API_VERSION,
    "Scanline2x",
    "scanline2x",
+   0,
 };
 
 const struct softfilter_implementation *softfilter_get_implementation(
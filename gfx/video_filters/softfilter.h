@@ -97,7 +97,10 @@ typedef const struct softfilter_implementation
 const struct softfilter_implementation *softfilter_get_implementation(
       softfilter_simd_mask_t simd);
 
-#define SOFTFILTER_API_VERSION  2
+#define SOFTFILTER_API_VERSION  3
+
+/* slice_halo value of filters that must see whole frames. */
+#define SOFTFILTER_SLICE_NONE   (~0u)
 
 /* Required base color formats */
 
@@ -183,6 +186,16 @@ struct softfilter_implementation
    /* Computer-friendly short version of ident.
     * Lower case, no spaces and special characters, etc. */
    const char *short_ident;
+
+   /* Since API version 3.
+    *
+    * If every output row only depends on the input rows it was
+    * scaled from, and on at most slice_halo rows above and below
+    * them, the host may run the filter on horizontal bands of the
+    * frame, on several threads at once and chained with other
+    * filters. The vertical scale must be a whole number.
+    * Otherwise SOFTFILTER_SLICE_NONE. */
+   unsigned slice_halo;
 };
 
 #ifdef __cplusplus
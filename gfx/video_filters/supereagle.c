@@ -338,6 +338,7 @@ static const struct softfilter_implementation supereagle_generic = {
    SOFTFILTER_API_VERSION,
    "SuperEagle",
    "supereagle",
+   2,
 };
 
 const struct softfilter_implementation *softfilter_get_implementation(softfilter_simd_mask_t simd)
@@ -285,6 +285,7 @@ static const struct softfilter_implementation upscale_1_5x_generic = {
    SOFTFILTER_API_VERSION,
    "Upscale1.5x",
    "upscale_1_5x",
+   SOFTFILTER_SLICE_NONE,
 };
 
 const struct softfilter_implementation *softfilter_get_implementation(
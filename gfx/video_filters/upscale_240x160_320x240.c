@@ -459,6 +459,7 @@ static const struct softfilter_implementation upscale_240x160_320x240_generic =
    SOFTFILTER_API_VERSION,
    "Upscale_240x160-320x240",
    "upscale_240x160_320x240",
+   SOFTFILTER_SLICE_NONE,
 };
 
 const struct softfilter_implementation *softfilter_get_implementation(
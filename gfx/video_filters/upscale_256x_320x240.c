@@ -709,6 +709,7 @@ static const struct softfilter_implementation upscale_256x_320x240_generic = {
    SOFTFILTER_API_VERSION,
    "Upscale_256x-320x240",
    "upscale_256x_320x240",
+   SOFTFILTER_SLICE_NONE,
 };
 
 const struct softfilter_implementation *softfilter_get_implementation(
@@ -0,0 +1,385 @@
+/*  RetroArch - A frontend for libretro.
+ *  Copyright (C) 2010-2014 - Hans-Kristian Arntzen
+ *  Copyright (C) 2011-2021 - Daniel De Matteis
+ *
+ *  RetroArch is free software: you can redistribute it and/or modify it under the terms
+ *  of the GNU General Public License as published by the Free Software Found-
+ *  ation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  RetroArch is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ *  without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ *  PURPOSE.  See the GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along with RetroArch.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include <retro_miscellaneous.h>
+#include <file/config_file.h>
+
+#include "video_frame_delay.h"
+
+#define FRAME_DELAY_AUTO_DEBUG 0
+#if FRAME_DELAY_AUTO_DEBUG
+#include "../verbosity.h"
+#endif
+
+void video_frame_delay_auto_samples(const retro_time_t *samples,
+      unsigned index, unsigned delay, video_frame_delay_auto_t *vfda)
+{
+   unsigned i                    = 0;
+   unsigned frame_time           = 0;
+   unsigned frame_time_frames    = vfda->frame_time_interval;
+   unsigned frame_time_target    = 1000000.0f / vfda->refresh_rate;
+   unsigned frame_time_limit_min = frame_time_target * 1.30f;
+   unsigned frame_time_limit_med = frame_time_target * 1.50f;
+   unsigned frame_time_limit_max = frame_time_target * 1.90f;
+   unsigned frame_time_limit_cap = frame_time_target * 2.50f;
+   unsigned frame_time_limit_ign = frame_time_target * 3.75f;
+   unsigned frame_time_min       = frame_time_target;
+   unsigned frame_time_max       = frame_time_target;
+   unsigned frame_time_count_pos = 0;
+   unsigned frame_time_count_min = 0;
+   unsigned frame_time_count_med = 0;
+   unsigned frame_time_count_max = 0;
+   unsigned frame_time_count_ign = 0;
+   unsigned frame_time_index     = index;
+
+   /* Calculate average frame time */
+   for (i = 1; i < frame_time_frames + 1; i++)
+   {
+      unsigned frame_time_i = 0;
+
+      if (i > frame_time_index)
+         continue;
+
+      frame_time_i = samples[frame_time_index - i];
+
+      if (frame_time_max < frame_time_i)
+         frame_time_max = frame_time_i;
+      if (frame_time_min > frame_time_i)
+         frame_time_min = frame_time_i;
+
+      /* Count frames over the target */
+      if (frame_time_i > frame_time_target)
+      {
+         frame_time_count_pos++;
+         if (frame_time_i > frame_time_limit_min)
+            frame_time_count_min++;
+         if (frame_time_i > frame_time_limit_med)
+            frame_time_count_med++;
+         if (frame_time_i > frame_time_limit_max)
+            frame_time_count_max++;
+         if (frame_time_i > frame_time_limit_ign)
+            frame_time_count_ign++;
+
+         /* Limit maximum to prevent false positives */
+         if (frame_time_i > frame_time_limit_cap)
+            frame_time_i = frame_time_limit_cap;
+      }
+
+      frame_time += frame_time_i;
+   }
+
+   frame_time /= frame_time_frames;
+
+   /* Ignore values when core is doing internal frame skipping */
+   if (frame_time_count_ign > 0)
+      frame_time = 0;
+
+   /* Special handlings for different video driver frame timings */
+   if (frame_time < frame_time_limit_med && frame_time > frame_time_target)
+   {
+      unsigned frame_time_frames_half = frame_time_frames / 2;
+      unsigned frame_time_delta       = frame_time_max - frame_time_min;
+
+      /* Ensure outcome on certain conditions */
+      int mode = 0;
+
+      /* All frames are above the target */
+      if (frame_time_count_pos == frame_time_frames)
+         mode = 1;
+      /* At least half of interval frames are above minimum level */
+      else if (frame_time_count_min >= frame_time_frames_half)
+         mode = 2;
+      /* D3Dx stripe equalizer */
+      else if (
+               frame_time_count_pos == frame_time_frames_half
+            && frame_time_count_min >= 1
+            && frame_time_delta > (frame_time_target / 3)
+            && frame_time_delta < (frame_time_target / 2)
+            && frame_time > frame_time_target
+         )
+         mode = 3;
+      /* Boost med/max spikes */
+      else if (
+               frame_time_count_pos >= frame_time_frames_half
+            && (  frame_time_count_max > 0
+               || frame_time_count_med > 1)
+            && frame_time_count_max == frame_time_count_med
+            && frame_time_delta < frame_time_target
+         )
+         mode = 4;
+      /* Ignore */
+      else if (frame_time_delta > frame_time_target
+            && frame_time_count_med == 0
+         )
+         mode = -1;
+
+      if (mode > 0)
+      {
+#if FRAME_DELAY_AUTO_DEBUG
+         RARCH_LOG("[Video]: Frame delay nudge %d by mode %d.\n", frame_time, mode);
+#endif
+         frame_time = frame_time_limit_med;
+      }
+      else if (mode < 0)
+      {
+#if FRAME_DELAY_AUTO_DEBUG
+         RARCH_LOG("[Video]: Frame delay ignore %d.\n", frame_time);
+#endif
+         frame_time = 0;
+      }
+   }
+
+   /* Final output decision */
+   if (frame_time > frame_time_limit_min)
+   {
+      unsigned delay_decrease = 1;
+
+      /* Increase decrease the more frame time is off target */
+      if (frame_time > frame_time_limit_med && delay > delay_decrease)
+      {
+         delay_decrease++;
+         if (frame_time > frame_time_limit_max && delay > delay_decrease)
+            delay_decrease++;
+      }
+
+      vfda->decrease = delay_decrease;
+   }
+
+   vfda->time   = frame_time;
+   vfda->target = frame_time_target;
+
+#if FRAME_DELAY_AUTO_DEBUG
+   if (frame_time_index > frame_time_frames)
+      RARCH_LOG("[Video]: %5d / pos:%d min:%d med:%d max:%d / delta:%5d = %5d %5d %5d %5d %5d %5d %5d %5d\n",
+            frame_time,
+            frame_time_count_pos,
+            frame_time_count_min,
+            frame_time_count_med,
+            frame_time_count_max,
+            frame_time_max - frame_time_min,
+            samples[frame_time_index - 1],
+            samples[frame_time_index - 2],
+            samples[frame_time_index - 3],
+            samples[frame_time_index - 4],
+            samples[frame_time_index - 5],
+            samples[frame_time_index - 6],
+            samples[frame_time_index - 7],
+            samples[frame_time_index - 8]
+      );
+#endif
+}
+
+/* Grows on every missed deadline, shrinks slowly after
+ * FRAME_DELAY_LEARN_RELAX frames without one. */
+#define FRAME_DELAY_LEARN_HEADROOM_MIN 500
+
+static unsigned frame_delay_learn_target(const frame_delay_learn_t *fdl)
+{
+   unsigned used = fdl->work_high + fdl->headroom;
+
+   if (used >= fdl->period)
+      return 0;
+   return MIN((fdl->period - used) / 1000, fdl->delay_max);
+}
+
+static void frame_delay_learn_set(frame_delay_learn_t *fdl, unsigned delay)
+{
+   fdl->delay        = delay;
+   fdl->since_change = 0;
+}
+
+void frame_delay_learn_init(frame_delay_learn_t *fdl,
+      float refresh_rate, unsigned delay, unsigned delay_max)
+{
+   memset(fdl, 0, sizeof(*fdl));
+   fdl->period    = refresh_rate > 0.0f
+      ? (unsigned)(1000000.0f / refresh_rate) : 0;
+   fdl->headroom  = MAX(fdl->period / 10, FRAME_DELAY_LEARN_HEADROOM_MIN);
+   fdl->delay_max = delay_max;
+   fdl->delay     = MIN(delay, delay_max);
+}
+
+bool frame_delay_learn_ready(const frame_delay_learn_t *fdl)
+{
+   return fdl->profile || fdl->samples >= FRAME_DELAY_LEARN_WARMUP;
+}
+
+unsigned frame_delay_learn_percentile(const frame_delay_learn_t *fdl,
+      unsigned permille)
+{
+   unsigned i;
+   uint64_t seen   = 0;
+   uint64_t wanted = ((uint64_t)fdl->samples * permille + 999) / 1000;
+
+   if (!fdl->samples)
+      return 0;
+
+   for (i = 0; i < FRAME_DELAY_LEARN_BUCKETS - 1; i++)
+   {
+      seen += fdl->work[0][i] + fdl->work[1][i];
+      if (seen >= wanted)
+         break;
+   }
+
+   return (i + 1) * FRAME_DELAY_LEARN_BUCKET_USEC;
+}
+
+bool frame_delay_learn_push(frame_delay_learn_t *fdl,
+      retro_time_t work, retro_time_t frame_time)
+{
+   unsigned bucket;
+   unsigned target;
+   unsigned delay = fdl->delay;
+   /* Longer than that the core skipped frames on purpose,
+    * or the frontend was busy with something else. */
+   bool missed    =
+            frame_time > (retro_time_t)fdl->period * 3 / 2
+         && frame_time < (retro_time_t)fdl->period * 15 / 4;
+
+   if (!fdl->period)
+      return false;
+
+   bucket         = work > 0
+      ? (unsigned)(work / FRAME_DELAY_LEARN_BUCKET_USEC) : 0;
+   if (bucket >= FRAME_DELAY_LEARN_BUCKETS)
+      bucket = FRAME_DELAY_LEARN_BUCKETS - 1;
+
+   /* Start a new window, dropping the one before the last,
+    * so that a new level or scene takes over quickly */
+   if (fdl->window >= FRAME_DELAY_LEARN_WINDOW)
+   {
+      fdl->samples  = fdl->window;
+      fdl->window   = 0;
+      memcpy(fdl->work[0], fdl->work[1], sizeof(fdl->work[0]));
+      memset(fdl->work[1], 0, sizeof(fdl->work[1]));
+      fdl->work_peak -= fdl->work_peak / FRAME_DELAY_LEARN_PEAK_DECAY;
+   }
+
+   /* A frame that could not have fit whatever the delay,
+    * such as loading, says nothing about the delay */
+   if (     work < (retro_time_t)fdl->period
+         && (unsigned)work > fdl->work_peak)
+      fdl->work_peak = (unsigned)work;
+
+   fdl->work[1][bucket]++;
+   fdl->window++;
+   fdl->samples++;
+   fdl->frames++;
+   fdl->delay_sum += fdl->delay;
+   fdl->since_change++;
+   fdl->since_decision++;
+
+   if (missed)
+   {
+      fdl->misses++;
+      fdl->since_miss = 0;
+      /* The core running longer explains the miss by itself,
+       * otherwise presenting or sleeping took more than the
+       * headroom allowed for */
+      if ((unsigned)work + fdl->headroom + delay * 1000 < fdl->period)
+         fdl->headroom = MIN(fdl->headroom + fdl->headroom / 2,
+               fdl->period / 2);
+   }
+   else if (++fdl->since_miss >= FRAME_DELAY_LEARN_RELAX)
+   {
+      fdl->since_miss = 0;
+      fdl->headroom   = MAX(fdl->headroom - fdl->headroom / 8,
+            FRAME_DELAY_LEARN_HEADROOM_MIN);
+   }
+
+   if (!missed && (fdl->since_decision < FRAME_DELAY_LEARN_INTERVAL
+            || fdl->samples < FRAME_DELAY_LEARN_WARMUP))
+      return false;
+
+   fdl->since_decision = 0;
+   if (fdl->samples >= FRAME_DELAY_LEARN_WARMUP)
+      fdl->work_high   = MAX(frame_delay_learn_percentile(fdl,
+            FRAME_DELAY_LEARN_PERMILLE), fdl->work_peak);
+   if (missed)
+      fdl->work_high   = MAX(fdl->work_high, (bucket + 1)
+            * FRAME_DELAY_LEARN_BUCKET_USEC);
+   target              = frame_delay_learn_target(fdl);
+
+   if (missed)
+   {
+      /* Whatever the histogram says, this delay was too much */
+      if (delay > 0)
+         frame_delay_learn_set(fdl, MIN(target, delay - 1));
+   }
+   else if (target < delay)
+      frame_delay_learn_set(fdl, target);
+   else if (target > delay && fdl->since_change >= FRAME_DELAY_LEARN_RAISE)
+      frame_delay_learn_set(fdl, delay + 1);
+
+   return fdl->delay != delay;
+}
+
+bool frame_delay_learn_load(frame_delay_learn_t *fdl, const char *path)
+{
+   unsigned period    = 0;
+   unsigned delay     = 0;
+   unsigned headroom  = 0;
+   unsigned work_high = 0;
+   bool ret           = false;
+   config_file_t *conf;
+
+   if (!path || !*path || !(conf = config_file_new_from_path_to_string(path)))
+      return false;
+
+   /* A profile from another refresh rate says nothing
+    * about how much of this frame period is left */
+   if (     config_get_uint(conf, "frame_delay_period",   &period)
+         && config_get_uint(conf, "frame_delay",          &delay)
+         && config_get_uint(conf, "frame_delay_headroom", &headroom)
+         && config_get_uint(conf, "frame_delay_work",     &work_high)
+         && period + period / 100 >= fdl->period
+         && period <= fdl->period + fdl->period / 100)
+   {
+      fdl->delay     = MIN(delay, fdl->delay_max);
+      fdl->headroom  = MIN(MAX(headroom, FRAME_DELAY_LEARN_HEADROOM_MIN),
+            fdl->period / 2);
+      fdl->work_high = work_high;
+      fdl->work_peak = work_high;
+      fdl->profile   = true;
+      ret            = true;
+   }
+
+   config_file_free(conf);
+   return ret;
+}
+
+bool frame_delay_learn_save(const frame_delay_learn_t *fdl, const char *path)
+{
+   bool ret;
+   config_file_t *conf;
+
+   if (     !path || !*path
+         || !frame_delay_learn_ready(fdl)
+         || !(conf = config_file_new_alloc()))
+      return false;
+
+   config_set_uint(conf, "frame_delay_period",   fdl->period);
+   config_set_uint(conf, "frame_delay",          fdl->delay);
+   config_set_uint(conf, "frame_delay_headroom", fdl->headroom);
+   config_set_uint(conf, "frame_delay_work",     fdl->work_high);
+
+   ret = config_file_write(conf, path, false);
+   config_file_free(conf);
+   return ret;
+}
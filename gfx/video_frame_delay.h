@@ -0,0 +1,166 @@
+/*  RetroArch - A frontend for libretro.
+ *  Copyright (C) 2010-2014 - Hans-Kristian Arntzen
+ *  Copyright (C) 2011-2021 - Daniel De Matteis
+ *
+ *  RetroArch is free software: you can redistribute it and/or modify it under the terms
+ *  of the GNU General Public License as published by the Free Software Found-
+ *  ation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  RetroArch is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ *  without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ *  PURPOSE.  See the GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along with RetroArch.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __VIDEO_FRAME_DELAY_H
+#define __VIDEO_FRAME_DELAY_H
+
+#include <stdint.h>
+
+#include <boolean.h>
+#include <retro_common_api.h>
+#include <libretro.h>
+
+RETRO_BEGIN_DECLS
+
+/* Core run time histogram: 256 buckets of 128 usec, the
+ * last one also holds everything slower than 32 ms. */
+#define FRAME_DELAY_LEARN_BUCKETS      256
+#define FRAME_DELAY_LEARN_BUCKET_USEC  128
+
+/* Frames measured before the histogram is trusted */
+#define FRAME_DELAY_LEARN_WARMUP       120
+/* The histogram covers the last one to two windows of frames */
+#define FRAME_DELAY_LEARN_WINDOW       300
+/* Frames between two decisions */
+#define FRAME_DELAY_LEARN_INTERVAL     8
+/* Frames without a change before the delay goes up by 1 ms */
+#define FRAME_DELAY_LEARN_RAISE        60
+/* Frames without a miss before the headroom shrinks */
+#define FRAME_DELAY_LEARN_RELAX        600
+/* Percentile of the core run time the delay leaves room for */
+#define FRAME_DELAY_LEARN_PERMILLE     999
+/* The slowest run time is left room for as well, losing
+ * 1/32 of it every window so that rare spikes still count */
+#define FRAME_DELAY_LEARN_PEAK_DECAY   32
+
+typedef struct video_frame_delay_auto {
+   float refresh_rate;
+   unsigned frame_time_interval;
+   unsigned decrease;
+   unsigned target;
+   unsigned time;
+} video_frame_delay_auto_t;
+
+typedef struct frame_delay_learn
+{
+   uint64_t frames;
+   uint64_t misses;
+   uint64_t delay_sum;
+   uint16_t work[2][FRAME_DELAY_LEARN_BUCKETS]; /* previous, current */
+   unsigned samples;        /* in both windows */
+   unsigned window;         /* samples in the current one */
+   unsigned period;         /* usec per frame */
+   unsigned headroom;       /* usec kept free for presenting */
+   unsigned work_high;      /* last core run time percentile */
+   unsigned work_peak;      /* slowest recent core run time */
+   unsigned delay;          /* ms */
+   unsigned delay_max;
+   unsigned since_change;
+   unsigned since_miss;
+   unsigned since_decision;
+   bool profile;            /* delay and headroom were loaded */
+} frame_delay_learn_t;
+
+/**
+ * video_frame_delay_auto_samples:
+ * @samples               : ring of frame times in usec.
+ * @index                 : where the next frame time goes in @samples.
+ * @delay                 : current frame delay.
+ * @vfda                  : refresh rate and interval in, decrease out.
+ *
+ * Looks at the @vfda->frame_time_interval frame times before @index
+ * and tells by how much the frame delay should go down, if at all.
+ **/
+void video_frame_delay_auto_samples(const retro_time_t *samples,
+      unsigned index, unsigned delay, video_frame_delay_auto_t *vfda);
+
+/**
+ * frame_delay_learn_init:
+ * @fdl                   : learner.
+ * @refresh_rate          : effective refresh rate.
+ * @delay                 : frame delay to start with.
+ * @delay_max             : highest frame delay ever chosen.
+ *
+ * Forgets everything measured, the way a new game starts.
+ * A @refresh_rate of 0 leaves the learner unused.
+ **/
+void frame_delay_learn_init(frame_delay_learn_t *fdl,
+      float refresh_rate, unsigned delay, unsigned delay_max);
+
+/**
+ * frame_delay_learn_push:
+ * @fdl                   : learner.
+ * @work                  : usec the core ran this frame, not counting
+ *                          the time the video driver took.
+ * @frame_time            : usec since the previous frame.
+ *
+ * Records one frame. A frame that took 1.5 frame periods or more
+ * missed its deadline: the delay drops at once, and unless the core
+ * running longer explains the miss, the headroom grows. Otherwise
+ * every FRAME_DELAY_LEARN_INTERVAL frames the delay becomes whatever
+ * leaves FRAME_DELAY_LEARN_PERMILLE of the core run times, or the
+ * slowest recent one if that is longer, plus the headroom before
+ * the deadline. Going down happens at once, going up 1 ms at a time.
+ *
+ * Returns: true if the delay changed.
+ **/
+bool frame_delay_learn_push(frame_delay_learn_t *fdl,
+      retro_time_t work, retro_time_t frame_time);
+
+/**
+ * frame_delay_learn_ready:
+ * @fdl                   : learner.
+ *
+ * Returns: true once the delay comes from measurements, either
+ * this session's or a loaded profile's.
+ **/
+bool frame_delay_learn_ready(const frame_delay_learn_t *fdl);
+
+/**
+ * frame_delay_learn_percentile:
+ * @fdl                   : learner.
+ * @permille              : 0 to 1000.
+ *
+ * Returns: upper bound of the core run time in usec that
+ * @permille of the recent frames stayed under, 0 if none.
+ **/
+unsigned frame_delay_learn_percentile(const frame_delay_learn_t *fdl,
+      unsigned permille);
+
+/**
+ * frame_delay_learn_load:
+ * @fdl                   : learner, initialised.
+ * @path                  : profile to read.
+ *
+ * Starts from the delay and headroom learned last time,
+ * if the profile was saved at the same refresh rate.
+ *
+ * Returns: true if the profile was used.
+ **/
+bool frame_delay_learn_load(frame_delay_learn_t *fdl, const char *path);
+
+/**
+ * frame_delay_learn_save:
+ * @fdl                   : learner.
+ * @path                  : profile to write.
+ *
+ * Returns: true if there was something learned and it was written.
+ **/
+bool frame_delay_learn_save(const frame_delay_learn_t *fdl, const char *path);
+
+RETRO_END_DECLS
+
+#endif
@@ -27,6 +27,7 @@
 #include "video_thread_wrapper.h"
 #include "font_driver.h"
 
+#include "../frame_profiler.h"
 #include "../retroarch.h"
 #include "../verbosity.h"
 
@@ -416,7 +417,17 @@ static void video_thread_loop(void *data)
       while (thr->send_cmd == CMD_VIDEO_NONE && !thr->frame.updated)
          scond_wait(thr->cond_thread, thr->lock);
       if (thr->frame.updated)
-         updated = true;
+      {
+         /* Take the newest frame, and give the mailbox
+          * the buffer we are done drawing. */
+         unsigned front        = thr->frame.front;
+         thr->frame.front      = thr->frame.mailbox;
+         thr->frame.mailbox    = front;
+         thr->frame.updated    = false;
+         thr->frame.drawing    = true;
+         updated               = true;
+         scond_signal(thr->cond_cmd);
+      }
 
       /* To avoid race condition where send_cmd is updated
        * right after the switch is checked. */
@@ -430,6 +441,8 @@ static void video_thread_loop(void *data)
       if (updated)
       {
          struct video_viewport vp;
+         struct video_thread_buffer *buf =
+            &thr->frame.buffers[thr->frame.front];
          bool                 ret = false;
          bool               alive = false;
          bool               focus = false;
@@ -452,12 +465,20 @@ static void video_thread_loop(void *data)
             /* TODO/FIXME - not thread-safe - should get 
              * rid of this */
             video_driver_build_info(&video_info);
+            if (buf->stats)
+               strlcpy(video_info.stat_text, buf->stat_text,
+                     sizeof(video_info.stat_text));
 
+            frame_profiler_begin(FRAME_PROFILER_THREAD_VIDEO,
+                  FRAME_PROFILER_STAGE_VIDEO_FRAME);
+            /* A dupe leaves the last upload on screen */
             ret = thr->driver->frame(thr->driver_data,
-                  thr->frame.buffer, thr->frame.width, thr->frame.height,
-                  thr->frame.count,
-                  thr->frame.pitch, *thr->frame.msg ? thr->frame.msg : NULL,
+                  buf->dupe ? NULL : buf->data, buf->width, buf->height,
+                  buf->count,
+                  buf->pitch, *buf->msg ? buf->msg : NULL,
                   &video_info);
+            frame_profiler_end(FRAME_PROFILER_THREAD_VIDEO,
+                  FRAME_PROFILER_STAGE_VIDEO_FRAME);
          }
 
          slock_unlock(thr->frame.lock);
@@ -478,7 +499,7 @@ static void video_thread_loop(void *data)
          thr->alive         = alive;
          thr->focus         = focus;
          thr->has_windowed  = has_windowed;
-         thr->frame.updated = false;
+         thr->frame.drawing = false;
          thr->vp            = vp;
          scond_signal(thr->cond_cmd);
          slock_unlock(thr->lock);
@@ -547,10 +568,11 @@ static bool video_thread_frame(void *data, const void *frame_,
       unsigned width, unsigned height, uint64_t frame_count,
       unsigned pitch, const char *msg, video_frame_info_t *video_info)
 {
-   unsigned copy_stride;
+   unsigned back_idx;
+   struct video_thread_buffer *back    = NULL;
    const uint8_t *src                  = NULL;
-   uint8_t *dst                        = NULL;
    thread_video_t *thr                 = (thread_video_t*)data;
+   bool blocked                        = false;
 
    /* If called from within read_viewport, we're actually in the
     * driver thread, so just render directly. */
@@ -564,17 +586,55 @@ static bool video_thread_frame(void *data, const void *frame_,
       return false;
    }
 
-   copy_stride = width * (thr->info.rgb32
-         ? sizeof(uint32_t) : sizeof(uint16_t));
+   /* The back buffer belongs to this thread until it is
+    * swapped into the mailbox, so fill it without the lock. */
+   src  = (const uint8_t*)frame_;
+   back = &thr->frame.buffers[thr->frame.back];
+
+   if (src && src != back->data)
+   {
+      unsigned h;
+      uint8_t *dst         = back->data;
+      unsigned copy_stride = width * (thr->info.rgb32
+            ? sizeof(uint32_t) : sizeof(uint16_t));
+
+      for (h = 0; h < height; h++, src += pitch, dst += copy_stride)
+         memcpy(dst, src, copy_stride);
 
-   src = (const uint8_t*)frame_;
-   dst = thr->frame.buffer;
+      pitch = copy_stride;
+   }
+   /* else the core rendered straight into the back buffer,
+    * see thread_get_current_software_framebuffer() */
+
+   back->dupe   = !src;
+   back->width  = width;
+   back->height = height;
+   back->count  = frame_count;
+   back->pitch  = pitch;
+   back->stats  = video_info->statistics_show;
+
+   if (msg)
+      strlcpy(back->msg, msg, sizeof(back->msg));
+   else
+      *back->msg = '\0';
+
+   if (back->stats)
+      strlcpy(back->stat_text, video_info->stat_text,
+            sizeof(back->stat_text));
 
    slock_lock(thr->lock);
 
-   if (!thr->nonblock)
+   /* A dupe must not replace a real frame still waiting
+    * to be drawn. */
+   if (back->dupe && thr->frame.updated)
    {
+      slock_unlock(thr->lock);
+      thr->last_time = cpu_features_get_time_usec();
+      return true;
+   }
 
+   if (!thr->nonblock)
+   {
       retro_time_t target_frame_time = (retro_time_t)
          roundf(1000000 / video_info->refresh_rate);
       retro_time_t target = thr->last_time + target_frame_time;
@@ -588,46 +648,36 @@ static bool video_thread_frame(void *data, const void *frame_,
          if (delta <= 0)
             break;
 
+         blocked = true;
          if (!scond_wait_timeout(thr->cond_cmd, thr->lock, delta))
             break;
       }
    }
 
-   /* Drop frame if updated flag is still set, as thread is
-    * still working on last frame. */
-   if (!thr->frame.updated)
-   {
-      if (src)
-      {
-         unsigned h;
-         for (h = 0; h < height; h++, src += pitch, dst += copy_stride)
-            memcpy(dst, src, copy_stride);
-      }
-
-      thr->frame.updated = true;
-      thr->frame.width  = width;
-      thr->frame.height = height;
-      thr->frame.count  = frame_count;
-      thr->frame.pitch  = copy_stride;
-
-      if (msg)
-         strlcpy(thr->frame.msg, msg, sizeof(thr->frame.msg));
-      else
-         *thr->frame.msg = '\0';
+   /* If the video thread has not taken the last frame yet,
+    * it is dropped in favour of this one. */
+   if (thr->frame.updated)
+      thr->stats.dropped++;
+   if (blocked)
+      thr->stats.blocked++;
+   if (back->dupe)
+      thr->stats.duplicated++;
+   thr->stats.pushed++;
+
+   back_idx           = thr->frame.back;
+   thr->frame.back    = thr->frame.mailbox;
+   thr->frame.mailbox = back_idx;
+   thr->frame.updated = true;
 
-      scond_signal(thr->cond_thread);
+   scond_signal(thr->cond_thread);
 
 #if defined(HAVE_MENU)
-      if (thr->texture.enable)
-      {
-         while (thr->frame.updated)
-            scond_wait(thr->cond_cmd, thr->lock);
-      }
-#endif
-      thr->hit_count++;
+   if (thr->texture.enable)
+   {
+      while (thr->frame.updated || thr->frame.drawing)
+         scond_wait(thr->cond_cmd, thr->lock);
    }
-   else
-      thr->miss_count++;
+#endif
 
    slock_unlock(thr->lock);
 
@@ -648,6 +698,7 @@ static bool video_thread_init(thread_video_t *thr,
       const video_info_t info,
       input_driver_t **input, void **input_data)
 {
+   unsigned i;
    size_t max_size;
    thread_packet_t pkt;
 
@@ -669,16 +720,25 @@ static bool video_thread_init(thread_video_t *thr,
    max_size                  = info.input_scale * RARCH_SCALE_BASE;
    max_size                 *= max_size;
    max_size                 *= info.rgb32 ? sizeof(uint32_t) : sizeof(uint16_t);
+   thr->frame.buffer_size    = max_size;
+
+   for (i = 0; i < ARRAY_SIZE(thr->frame.buffers); i++)
+   {
 #ifdef _3DS
-   thr->frame.buffer         = linearMemAlign(max_size, 0x80);
+      thr->frame.buffers[i].data = (uint8_t*)linearMemAlign(max_size, 0x80);
 #else
-   thr->frame.buffer         = (uint8_t*)malloc(max_size);
+      thr->frame.buffers[i].data = (uint8_t*)malloc(max_size);
 #endif
 
-   if (!thr->frame.buffer)
-      return false;
+      if (!thr->frame.buffers[i].data)
+         return false;
+
+      memset(thr->frame.buffers[i].data, 0x80, max_size);
+   }
 
-   memset(thr->frame.buffer, 0x80, max_size);
+   thr->frame.back           = 0;
+   thr->frame.mailbox        = 1;
+   thr->frame.front          = 2;
 
    thr->last_time            = cpu_features_get_time_usec();
    thr->thread               = sthread_create(video_thread_loop, thr);
@@ -779,6 +839,7 @@ static bool video_thread_read_viewport(void *data,
 
 static void video_thread_free(void *data)
 {
+   unsigned i;
    thread_packet_t pkt;
    thread_video_t *thr = (thread_video_t*)data;
 
@@ -793,11 +854,14 @@ static void video_thread_free(void *data)
 #if defined(HAVE_MENU)
    free(thr->texture.frame);
 #endif
+   for (i = 0; i < ARRAY_SIZE(thr->frame.buffers); i++)
+   {
 #ifdef _3DS
-   linearFree(thr->frame.buffer);
+      linearFree(thr->frame.buffers[i].data);
 #else
-   free(thr->frame.buffer);
+      free(thr->frame.buffers[i].data);
 #endif
+   }
    slock_free(thr->frame.lock);
    slock_free(thr->lock);
    scond_free(thr->cond_cmd);
@@ -806,8 +870,11 @@ static void video_thread_free(void *data)
    free(thr->alpha_mod);
    slock_free(thr->alpha_lock);
 
-   RARCH_LOG("Threaded video stats: Frames pushed: %u, Frames dropped: %u.\n",
-         thr->hit_count, thr->miss_count);
+   RARCH_LOG("Threaded video stats: Frames pushed: %" PRIu64
+         ", Frames dropped: %" PRIu64 ", Frames duplicated: %" PRIu64
+         ", Frames blocked: %" PRIu64 ".\n",
+         thr->stats.pushed, thr->stats.dropped,
+         thr->stats.duplicated, thr->stats.blocked);
 
    free(thr);
 }
@@ -1190,6 +1257,49 @@ static uint32_t thread_get_flags(void *data)
    return thr->poke->get_flags(thr->driver_data);
 }
 
+/* Hands the core the back buffer to render into, so
+ * video_thread_frame() can pass it on without a copy. */
+static bool thread_get_current_software_framebuffer(void *data,
+      struct retro_framebuffer *framebuffer)
+{
+   size_t pitch;
+   thread_video_t *thr            = (thread_video_t*)data;
+   video_driver_state_t *video_st = video_state_get_ptr();
+
+   if (!thr || !framebuffer)
+      return false;
+
+   /* A softfilter reads the core frame in the core's own
+    * format and writes its output elsewhere. */
+   if (video_st->state_filter)
+      return false;
+
+   switch (video_st->pix_fmt)
+   {
+      case RETRO_PIXEL_FORMAT_XRGB8888:
+         if (!thr->info.rgb32)
+            return false;
+         pitch = framebuffer->width * sizeof(uint32_t);
+         break;
+      case RETRO_PIXEL_FORMAT_RGB565:
+         if (thr->info.rgb32)
+            return false;
+         pitch = framebuffer->width * sizeof(uint16_t);
+         break;
+      default:
+         return false;
+   }
+
+   if (pitch * framebuffer->height > thr->frame.buffer_size)
+      return false;
+
+   framebuffer->data         = thr->frame.buffers[thr->frame.back].data;
+   framebuffer->pitch        = pitch;
+   framebuffer->format       = video_st->pix_fmt;
+   framebuffer->memory_flags = RETRO_MEMORY_TYPE_CACHED;
+   return true;
+}
+
 static const video_poke_interface_t thread_poke = {
    thread_get_flags,
    thread_load_texture,
@@ -1212,7 +1322,7 @@ static const video_poke_interface_t thread_poke = {
    thread_grab_mouse_toggle,
 
    thread_get_current_shader,
-   NULL,                      /* get_current_software_framebuffer */
+   thread_get_current_software_framebuffer,
    NULL,                      /* get_hw_render_interface */
    thread_set_hdr_max_nits,
    thread_set_hdr_paper_white_nits,
@@ -1383,3 +1493,15 @@ unsigned video_thread_texture_load(void *data,
 
    return pkt.data.custom_command.return_value;
 }
+
+void video_thread_get_stats(void *data, struct video_thread_stats *stats)
+{
+   thread_video_t *thr = (thread_video_t*)data;
+
+   if (!thr || !stats)
+      return;
+
+   slock_lock(thr->lock);
+   *stats = thr->stats;
+   slock_unlock(thr->lock);
+}
@@ -75,6 +75,31 @@ typedef bool (*custom_font_command_method_t)(const void **font_driver,
 
 typedef struct thread_packet thread_packet_t;
 
+/* One of the three frame buffers handed between the main
+ * thread and the video thread. Only the thread owning the
+ * buffer (see thread_video_t frame.back/mailbox/front) may
+ * touch it; ownership changes under thr->lock. */
+struct video_thread_buffer
+{
+   uint8_t *data;
+   uint64_t count;
+   unsigned width;
+   unsigned height;
+   unsigned pitch;
+   char msg[NAME_MAX_LENGTH];
+   char stat_text[VIDEO_STAT_TEXT_SIZE];
+   bool dupe;
+   bool stats;
+};
+
+struct video_thread_stats
+{
+   uint64_t pushed;     /* Frames handed to the video thread */
+   uint64_t dropped;    /* Frames replaced before being drawn */
+   uint64_t duplicated; /* Dupe frames, drawn without an upload */
+   uint64_t blocked;    /* Frames that had to wait for the video thread */
+};
+
 struct thread_packet
 {
    union
@@ -206,8 +231,7 @@ typedef struct thread_video
       bool full_screen;
    } texture;
 
-   unsigned hit_count;
-   unsigned miss_count;
+   struct video_thread_stats stats;
    unsigned alpha_mods;
 
    struct video_viewport vp;
@@ -222,16 +246,19 @@ typedef struct thread_video
 
    bool alpha_update;
 
+   /* Triple buffer: the main thread fills 'back', the video
+    * thread draws 'front', and finished frames wait in 'mailbox'.
+    * Handing a frame over swaps indices, never pixels. */
    struct
    {
-      uint64_t count;
+      struct video_thread_buffer buffers[3];
       slock_t *lock;
-      uint8_t *buffer;
-      unsigned width;
-      unsigned height;
-      unsigned pitch;
-      char msg[NAME_MAX_LENGTH];
-      bool updated;
+      size_t buffer_size;
+      unsigned back;
+      unsigned mailbox;
+      unsigned front;
+      bool updated; /* Mailbox holds a frame not yet taken */
+      bool drawing; /* Video thread is drawing the front buffer */
       bool within_thread;
    } frame;
 
@@ -278,6 +305,15 @@ bool video_thread_font_init(
 unsigned video_thread_texture_load(void *data,
       custom_command_method_t func);
 
+/**
+ * video_thread_get_stats:
+ * @data                      : Threaded video driver data
+ * @stats                     : Output frame counters
+ *
+ * Reads the frame handoff counters of the threaded video driver.
+ **/
+void video_thread_get_stats(void *data, struct video_thread_stats *stats);
+
 RETRO_END_DECLS
 
 #endif
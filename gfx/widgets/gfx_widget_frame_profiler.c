@@ -0,0 +1,227 @@
+/*  RetroArch - A frontend for libretro.
+ *  Copyright (C) 2014-2017 - Jean-André Santoni
+ *  Copyright (C) 2015-2018 - Andre Leiradella
+ *  Copyright (C) 2018-2020 - natinusala
+ *
+ *  RetroArch is free software: you can redistribute it and/or modify it under the terms
+ *  of the GNU General Public License as published by the Free Software Found-
+ *  ation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  RetroArch is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ *  without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ *  PURPOSE.  See the GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along with RetroArch.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "../gfx_widgets.h"
+#include "../gfx_display.h"
+#include "../video_driver.h"
+#include "../../frame_profiler.h"
+
+/* Number of frames shown by the graph */
+#define FRAME_PROFILER_GRAPH_FRAMES 120
+
+/* Widget state */
+struct gfx_widget_frame_profiler_state
+{
+   frame_profiler_frame_t frames[FRAME_PROFILER_GRAPH_FRAMES];
+   float stage_colors[FRAME_PROFILER_STAGE_LAST][16];
+   float other_color[16];
+   float target_color[16];
+};
+
+typedef struct gfx_widget_frame_profiler_state gfx_widget_frame_profiler_state_t;
+
+static gfx_widget_frame_profiler_state_t p_w_frame_profiler_st = {
+   {{{0}}},
+   {
+      COLOR_HEX_TO_FLOAT(0x198AC6, 1.0f), /* core_run */
+      COLOR_HEX_TO_FLOAT(0xC678DD, 1.0f), /* input_poll */
+      COLOR_HEX_TO_FLOAT(0x2EB82E, 1.0f), /* video_frame */
+      COLOR_HEX_TO_FLOAT(0xF5DD19, 1.0f), /* audio_flush */
+      COLOR_HEX_TO_FLOAT(0xE5862D, 1.0f), /* runahead */
+      COLOR_HEX_TO_FLOAT(0xC23B22, 1.0f), /* rewind */
+      COLOR_HEX_TO_FLOAT(0x3A3A3A, 1.0f), /* sleep */
+      COLOR_HEX_TO_FLOAT(0x7FD67F, 1.0f)  /* softfilter */
+   },
+   COLOR_HEX_TO_FLOAT(0x878787, 1.0f),
+   COLOR_HEX_TO_FLOAT(0xFFFFFF, 0.5f)
+};
+
+/* Short names for the legend, same order as frame_profiler_stage */
+static const char *const gfx_widget_frame_profiler_labels[FRAME_PROFILER_STAGE_LAST] = {
+   "Core",
+   "Input",
+   "Video",
+   "Audio",
+   "RA",
+   "Rew",
+   "Sleep",
+   "Filter"
+};
+
+static void gfx_widget_frame_profiler_frame(void *data, void *userdata)
+{
+   unsigned i, s, count;
+   char legend[256];
+   size_t _len;
+   uint64_t totals[FRAME_PROFILER_STAGE_LAST];
+   float usec_per_pixel;
+   unsigned bar_width, graph_width, graph_height;
+   int graph_x, graph_y, target_y;
+   double target_usec;
+   video_frame_info_t *video_info            = NULL;
+   dispgfx_widget_t *p_dispwidget            = NULL;
+   gfx_display_t *p_disp                     = NULL;
+   gfx_widget_frame_profiler_state_t *state  = &p_w_frame_profiler_st;
+
+   if (!frame_profiler_graph_visible())
+      return;
+
+   if (!(count = frame_profiler_get_frames(state->frames,
+               FRAME_PROFILER_GRAPH_FRAMES)))
+      return;
+
+   video_info     = (video_frame_info_t*)data;
+   p_dispwidget   = (dispgfx_widget_t*)userdata;
+   p_disp         = (gfx_display_t*)video_info->disp_userdata;
+
+   /* Scale the graph so that a frame twice as
+    * long as the target fills it */
+   target_usec    = video_state_get_ptr()->av_info.timing.fps > 0.0
+      ? 1000000.0 / video_state_get_ptr()->av_info.timing.fps
+      : 1000000.0 / 60.0;
+
+   bar_width      = video_info->width / 3 / FRAME_PROFILER_GRAPH_FRAMES;
+   if (bar_width < 1)
+      bar_width   = 1;
+   graph_width    = bar_width * FRAME_PROFILER_GRAPH_FRAMES;
+   graph_height   = video_info->height / 5;
+   graph_x        = (int)(video_info->width - graph_width
+         - p_dispwidget->simple_widget_padding);
+   graph_y        = (int)(video_info->height - graph_height
+         - p_dispwidget->simple_widget_height * 2);
+   usec_per_pixel = (float)(target_usec * 2.0 / graph_height);
+
+   gfx_display_set_alpha(p_dispwidget->backdrop_orig, DEFAULT_BACKDROP);
+   gfx_display_draw_quad(
+         p_disp,
+         video_info->userdata,
+         video_info->width,
+         video_info->height,
+         graph_x - (int)p_dispwidget->simple_widget_padding,
+         graph_y,
+         graph_width + p_dispwidget->simple_widget_padding * 2,
+         graph_height + p_dispwidget->simple_widget_height,
+         video_info->width,
+         video_info->height,
+         p_dispwidget->backdrop_orig,
+         NULL);
+
+   for (s = 0; s < FRAME_PROFILER_STAGE_LAST; s++)
+      totals[s] = 0;
+
+   /* Newest frame on the right */
+   for (i = 0; i < count; i++)
+   {
+      const frame_profiler_frame_t *frame = &state->frames[i];
+      int x             = graph_x + (int)((FRAME_PROFILER_GRAPH_FRAMES
+               - count + i) * bar_width);
+      int bottom        = graph_y + (int)graph_height;
+      uint32_t measured = 0;
+
+      for (s = 0; s < FRAME_PROFILER_STAGE_LAST; s++)
+      {
+         unsigned height = (unsigned)(frame->stage_usec[s] / usec_per_pixel);
+
+         measured  += frame->stage_usec[s];
+         totals[s] += frame->stage_usec[s];
+
+         if (!height)
+            continue;
+         if ((int)height > bottom - graph_y)
+            height = bottom - graph_y;
+
+         bottom -= height;
+         gfx_display_draw_quad(
+               p_disp,
+               video_info->userdata,
+               video_info->width,
+               video_info->height,
+               x, bottom, bar_width, height,
+               video_info->width,
+               video_info->height,
+               state->stage_colors[s],
+               NULL);
+      }
+
+      /* Whatever the frame spent outside of the recorded stages */
+      if (frame->frame_usec > measured)
+      {
+         unsigned height = (unsigned)(
+               (frame->frame_usec - measured) / usec_per_pixel);
+
+         if ((int)height > bottom - graph_y)
+            height = bottom - graph_y;
+
+         if (height)
+            gfx_display_draw_quad(
+                  p_disp,
+                  video_info->userdata,
+                  video_info->width,
+                  video_info->height,
+                  x, bottom - height, bar_width, height,
+                  video_info->width,
+                  video_info->height,
+                  state->other_color,
+                  NULL);
+      }
+   }
+
+   /* Target frame time */
+   target_y = graph_y + (int)graph_height - (int)(target_usec / usec_per_pixel);
+   gfx_display_draw_quad(
+         p_disp,
+         video_info->userdata,
+         video_info->width,
+         video_info->height,
+         graph_x, target_y, graph_width, 1,
+         video_info->width,
+         video_info->height,
+         state->target_color,
+         NULL);
+
+   /* Average milliseconds spent in each stage */
+   _len      = 0;
+   legend[0] = '\0';
+   for (s = 0; s < FRAME_PROFILER_STAGE_LAST && _len < sizeof(legend); s++)
+      _len += snprintf(legend + _len, sizeof(legend) - _len, "%s%s %.1f",
+            s ? "  " : "",
+            gfx_widget_frame_profiler_labels[s],
+            totals[s] / (1000.0 * count));
+
+   gfx_widgets_draw_text(
+         &p_dispwidget->gfx_widget_fonts.regular,
+         legend,
+         graph_x,
+         graph_y + graph_height
+         + p_dispwidget->simple_widget_height / 2.0f
+         + p_dispwidget->gfx_widget_fonts.regular.line_centre_offset,
+         video_info->width,
+         video_info->height,
+         0xFFFFFFFF,
+         TEXT_ALIGN_LEFT,
+         true);
+}
+
+const gfx_widget_t gfx_widget_frame_profiler = {
+   NULL, /* init */
+   NULL, /* free */
+   NULL, /* context_reset*/
+   NULL, /* context_destroy */
+   NULL, /* layout */
+   NULL, /* iterate */
+   &gfx_widget_frame_profiler_frame
+};
@@ -231,6 +231,7 @@ CHEATS
 #include "../libretro-common/hash/lrc_hash.c"
 
 #include "../gfx/video_driver.c"
+#include "../gfx/video_frame_delay.c"
 /*============================================================
 UI COMMON CONTEXT
 ============================================================ */
@@ -862,12 +863,14 @@ INPUT (HID)
 FIFO BUFFER
 ============================================================ */
 #include "../libretro-common/queues/fifo_queue.c"
+#include "../libretro-common/queues/spsc_queue.c"
 
 /*============================================================
 AUDIO RESAMPLER
 ============================================================ */
 #include "../libretro-common/audio/resampler/audio_resampler.c"
 #include "../libretro-common/audio/resampler/drivers/sinc_resampler.c"
+#include "../libretro-common/audio/resampler/drivers/polyphase_resampler.c"
 #ifdef HAVE_NEAREST_RESAMPLER
 #include "../libretro-common/audio/resampler/drivers/nearest_resampler.c"
 #endif
@@ -1012,6 +1015,7 @@ DRIVERS
 #endif
 #include "../gfx/gfx_animation.c"
 #include "../gfx/gfx_display.c"
+#include "../gfx/gfx_display_batch.c"
 #include "../gfx/gfx_thumbnail_path.c"
 #include "../gfx/gfx_thumbnail.c"
 #include "../gfx/video_coord_array.c"
@@ -1026,6 +1030,7 @@ SCALERS
 #include "../libretro-common/gfx/scaler/pixconv.c"
 #include "../libretro-common/gfx/scaler/scaler.c"
 #include "../libretro-common/gfx/scaler/scaler_int.c"
+#include "../libretro-common/gfx/frame_diff.c"
 
 /*============================================================
 FILTERS
@@ -1153,6 +1158,7 @@ STATE MANAGER
 ============================================================ */
 #ifdef HAVE_REWIND
 #include "../state_manager.c"
+#include "../state_manager_delta.c"
 #endif
 
 /*============================================================
@@ -1234,6 +1240,7 @@ RETROARCH
 ============================================================ */
 #include "../retroarch.c"
 #include "../runloop.c"
+#include "../frame_profiler.c"
 #include "../command.c"
 #include "../driver.c"
 #include "../midi_driver.c"
@@ -1318,6 +1325,7 @@ THREAD
 #endif
 
 #include "../libretro-common/rthreads/rthreads.c"
+#include "../libretro-common/rthreads/tpool.c"
 #include "../gfx/video_thread_wrapper.c"
 #include "../audio/audio_thread_wrapper.c"
 #endif
@@ -1400,6 +1408,7 @@ MENU
 #include "../gfx/widgets/gfx_widget_screenshot.c"
 #endif
 #include "../gfx/widgets/gfx_widget_volume.c"
+#include "../gfx/widgets/gfx_widget_frame_profiler.c"
 #include "../gfx/widgets/gfx_widget_generic_message.c"
 #include "../gfx/widgets/gfx_widget_libretro_message.c"
 #include "../gfx/widgets/gfx_widget_progress_message.c"
@@ -1591,6 +1600,8 @@ XML
 #include "../libretro-db/rmsgpack_dom.c"
 #include "../libretro-db/query.c"
 #include "../database_info.c"
+#include "../database_index.c"
+#include "../database_scan_cache.c"
 #endif
 
 /*============================================================
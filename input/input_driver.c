@@ -47,6 +47,7 @@
 #include "../command.h"
 #include "../config.def.keybinds.h"
 #include "../driver.h"
+#include "../frame_profiler.h"
 #include "../retroarch.h"
 #include "../verbosity.h"
 #include "../configuration.h"
@@ -4000,7 +4001,7 @@ int16_t input_state_device(
    return res;
 }
 
-void input_driver_poll(void)
+static void input_driver_poll_internal(void)
 {
    size_t i, j;
    rarch_joypad_info_t joypad_info[MAX_USERS];
@@ -4451,6 +4452,15 @@ void input_driver_poll(void)
 #endif
 }
 
+void input_driver_poll(void)
+{
+   frame_profiler_begin(FRAME_PROFILER_THREAD_MAIN,
+         FRAME_PROFILER_STAGE_INPUT_POLL);
+   input_driver_poll_internal();
+   frame_profiler_end(FRAME_PROFILER_THREAD_MAIN,
+         FRAME_PROFILER_STAGE_INPUT_POLL);
+}
+
 #ifdef HAVE_BSV_MOVIE
 #define MAGIC_INDEX        0
 #define SERIALIZER_INDEX   1
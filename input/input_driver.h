@@ -191,6 +191,8 @@ typedef struct input_remote_state
 typedef struct input_list_element_t
 {
    int16_t *state;
+   /* Non-zero for every id the core has actually asked for */
+   uint8_t *logged;
    unsigned port;
    unsigned device;
    unsigned index;
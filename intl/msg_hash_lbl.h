@@ -2884,6 +2884,18 @@ MSG_HASH(
    MENU_ENUM_LABEL_REWIND_GRANULARITY,
    "rewind_granularity"
    )
+MSG_HASH(
+   MENU_ENUM_LABEL_REWIND_COMPRESSION_THREADS,
+   "rewind_compression_threads"
+   )
+MSG_HASH(
+   MENU_ENUM_LABEL_REWIND_COLD_BUFFER_SIZE,
+   "rewind_cold_buffer_size"
+   )
+MSG_HASH(
+   MENU_ENUM_LABEL_REWIND_SPILL_SIZE,
+   "rewind_spill_size"
+   )
 MSG_HASH(
    MENU_ENUM_LABEL_REWIND_BUFFER_SIZE,
    "rewind_buffer_size"
@@ -3110,6 +3122,14 @@ MSG_HASH(
    MENU_ENUM_LABEL_RUN_AHEAD_SECONDARY_INSTANCE,
    "run_ahead_secondary_instance"
    )
+MSG_HASH(
+   MENU_ENUM_LABEL_RUN_AHEAD_SECONDARY_THREADED,
+   "run_ahead_secondary_threaded"
+   )
+MSG_HASH(
+   MENU_ENUM_LABEL_RUN_AHEAD_PREEMPTIVE_FRAMES,
+   "run_ahead_preemptive_frames"
+   )
 MSG_HASH(
    MENU_ENUM_LABEL_RUN_AHEAD_HIDE_WARNINGS,
    "run_ahead_hide_warnings"
@@ -3118,6 +3138,18 @@ MSG_HASH(
    MENU_ENUM_LABEL_RUN_AHEAD_FRAMES,
    "run_ahead_frames"
    )
+MSG_HASH(
+   MENU_ENUM_LABEL_FRAME_PROFILER_ENABLE,
+   "frame_profiler_enable"
+   )
+MSG_HASH(
+   MENU_ENUM_LABEL_FRAME_PROFILER_SHOW_GRAPH,
+   "frame_profiler_show_graph"
+   )
+MSG_HASH(
+   MENU_ENUM_LABEL_FRAME_PROFILER_EXPORT,
+   "frame_profiler_export"
+   )
 MSG_HASH(
    MENU_ENUM_LABEL_SORT_SAVEFILES_ENABLE,
    "sort_savefiles_enable"
@@ -3474,6 +3506,10 @@ MSG_HASH(
    MENU_ENUM_LABEL_VIDEO_FILTER,
    "video_filter"
    )
+MSG_HASH(
+   MENU_ENUM_LABEL_VIDEO_FILTER_THREADS,
+   "video_filter_threads"
+   )
 MSG_HASH(
    MENU_ENUM_LABEL_VIDEO_FILTER_REMOVE,
    "video_filter_remove"
@@ -3518,6 +3554,10 @@ MSG_HASH(
    MENU_ENUM_LABEL_VIDEO_SHADER_DELAY,
    "video_shader_delay"
    )
+MSG_HASH(
+   MENU_ENUM_LABEL_VIDEO_SHADER_CACHE_SIZE,
+   "video_shader_cache_size"
+   )
 MSG_HASH(
    MENU_ENUM_LABEL_VIDEO_FULLSCREEN,
    "video_fullscreen"
@@ -3534,6 +3574,14 @@ MSG_HASH(
    MENU_ENUM_LABEL_VIDEO_GPU_SCREENSHOT,
    "video_gpu_screenshot"
    )
+MSG_HASH(
+   MENU_ENUM_LABEL_VIDEO_FRAME_DIFF,
+   "video_frame_diff"
+   )
+MSG_HASH(
+   MENU_ENUM_LABEL_VIDEO_UPLOAD_RING,
+   "video_upload_ring"
+   )
 MSG_HASH(
    MENU_ENUM_LABEL_VIDEO_HARD_SYNC,
    "video_hard_sync"
@@ -1489,6 +1489,22 @@ MSG_HASH(
    MENU_ENUM_SUBLABEL_VIDEO_GPU_SCREENSHOT,
    "Screenshots capture GPU shaded material if available."
    )
+MSG_HASH(
+   MENU_ENUM_LABEL_VALUE_VIDEO_FRAME_DIFF,
+   "Damage Tracking"
+   )
+MSG_HASH(
+   MENU_ENUM_SUBLABEL_VIDEO_FRAME_DIFF,
+   "Compare each frame of a software-rendered core with the previous one. Video drivers that support it (xshm, sdl2, drm) only update the parts that changed, and recording skips frames that did not change. Costs some CPU time for the comparison."
+   )
+MSG_HASH(
+   MENU_ENUM_LABEL_VALUE_VIDEO_UPLOAD_RING,
+   "Pixel Buffer Uploads"
+   )
+MSG_HASH(
+   MENU_ENUM_SUBLABEL_VIDEO_UPLOAD_RING,
+   "Upload the frames of a software-rendered core through a ring of pixel buffers in the 'gl' and 'glcore' video drivers, so the upload does not wait for the driver to copy the frame. Has no effect on software rasterizers."
+   )
 MSG_HASH(
    MENU_ENUM_LABEL_VALUE_VIDEO_SMOOTH,
    "Bilinear Filtering"
@@ -1545,6 +1561,14 @@ MSG_HASH(
    MENU_ENUM_SUBLABEL_VIDEO_SHADER_DELAY,
    "Delay auto-loading shaders (in ms). Can work around graphical glitches when using 'screen grabbing' software."
    )
+MSG_HASH(
+   MENU_ENUM_LABEL_VALUE_VIDEO_SHADER_CACHE_SIZE,
+   "Shader Cache Size"
+   )
+MSG_HASH(
+   MENU_ENUM_SUBLABEL_VIDEO_SHADER_CACHE_SIZE,
+   "Disk space (in MB) for keeping compiled Slang shaders, so that presets load faster the next time. The least recently used shaders are removed first. Takes effect when the video driver is reinitialized."
+   )
 MSG_HASH(
    MENU_ENUM_LABEL_VALUE_VIDEO_FILTER,
    "Video Filter"
@@ -1553,6 +1577,14 @@ MSG_HASH(
    MENU_ENUM_SUBLABEL_VIDEO_FILTER,
    "Apply a CPU-powered video filter. Might come at a high performance cost. Some video filters might only work for cores that use 32-bit or 16-bit color."
    )
+MSG_HASH(
+   MENU_ENUM_LABEL_VALUE_VIDEO_FILTER_THREADS,
+   "Video Filter Threads"
+   )
+MSG_HASH(
+   MENU_ENUM_SUBLABEL_VIDEO_FILTER_THREADS,
+   "Number of threads the video filter runs on. 0 uses one per CPU core. Filters that allow it are split into bands of rows, so that several threads share a frame."
+   )
 MSG_HASH(
    MENU_ENUM_LABEL_VALUE_VIDEO_FILTER_REMOVE,
    "Remove Video Filter"
@@ -3237,6 +3269,22 @@ MSG_HASH(
    MENU_ENUM_SUBLABEL_RUN_AHEAD_SECONDARY_INSTANCE,
    "Use a second instance of the RetroArch core to run-ahead. Prevents audio problems due to loading state."
    )
+MSG_HASH(
+   MENU_ENUM_LABEL_VALUE_RUN_AHEAD_SECONDARY_THREADED,
+   "Run Second Instance on a Thread"
+   )
+MSG_HASH(
+   MENU_ENUM_SUBLABEL_RUN_AHEAD_SECONDARY_THREADED,
+   "Run the second instance on its own thread, in parallel with the main one. Lowers the cost of Run-Ahead on multi-core CPUs. Not available for hardware rendered cores."
+   )
+MSG_HASH(
+   MENU_ENUM_LABEL_VALUE_RUN_AHEAD_PREEMPTIVE_FRAMES,
+   "Preemptive Frames"
+   )
+MSG_HASH(
+   MENU_ENUM_SUBLABEL_RUN_AHEAD_PREEMPTIVE_FRAMES,
+   "Only roll back and re-run frames when the input changes, instead of on every frame. Much cheaper than regular Run-Ahead for the same latency reduction."
+   )
 MSG_HASH(
    MENU_ENUM_LABEL_VALUE_RUN_AHEAD_HIDE_WARNINGS,
    "Hide Run-Ahead Warnings"
@@ -3245,6 +3293,30 @@ MSG_HASH(
    MENU_ENUM_SUBLABEL_RUN_AHEAD_HIDE_WARNINGS,
    "Hide the warning message that appears when using Run-Ahead and the core does not support save states."
    )
+MSG_HASH(
+   MENU_ENUM_LABEL_VALUE_FRAME_PROFILER_ENABLE,
+   "Frame Time Profiler"
+   )
+MSG_HASH(
+   MENU_ENUM_SUBLABEL_FRAME_PROFILER_ENABLE,
+   "Record how long the core, video, audio, input, Run-Ahead, Rewind and frame pacing take each frame. Cheap enough to leave enabled."
+   )
+MSG_HASH(
+   MENU_ENUM_LABEL_VALUE_FRAME_PROFILER_SHOW_GRAPH,
+   "Display Frame Time Graph"
+   )
+MSG_HASH(
+   MENU_ENUM_SUBLABEL_FRAME_PROFILER_SHOW_GRAPH,
+   "Draw the recorded frame times as an onscreen graph. Requires Graphics Widgets."
+   )
+MSG_HASH(
+   MENU_ENUM_LABEL_VALUE_FRAME_PROFILER_EXPORT,
+   "Export Frame Time Trace"
+   )
+MSG_HASH(
+   MENU_ENUM_SUBLABEL_FRAME_PROFILER_EXPORT,
+   "Write the last few seconds recorded by the profiler to the log directory, as a trace that can be opened with chrome://tracing or Perfetto."
+   )
 
 /* Settings > Core */
 
@@ -3720,6 +3792,34 @@ MSG_HASH(
    MENU_ENUM_SUBLABEL_REWIND_GRANULARITY,
    "The number of frames to rewind per step. Higher values increase the rewind speed."
    )
+MSG_HASH(
+   MENU_ENUM_LABEL_VALUE_REWIND_COMPRESSION_THREADS,
+   "Rewind Compression Threads"
+   )
+MSG_HASH(
+   MENU_ENUM_SUBLABEL_REWIND_COMPRESSION_THREADS,
+   "Compress rewind states on worker threads in the background. Large savestates are split across threads. 0 compresses on the main thread."
+   )
+MSG_HASH(
+   MENU_ENUM_LABEL_VALUE_REWIND_COLD_BUFFER_SIZE,
+   "Compressed Rewind Buffer Size (MB)"
+   )
+MSG_HASH(
+   MENU_ENUM_SUBLABEL_REWIND_COLD_BUFFER_SIZE,
+   "Memory for older rewind history. Once the rewind buffer is full, the oldest states are recompressed and kept here instead of being discarded. 0 disables it."
+   )
+MSG_HASH(
+   MENU_ENUM_LABEL_VALUE_REWIND_SPILL_SIZE,
+   "Rewind Disk Spill Size (MB)"
+   )
+MSG_HASH(
+   MENU_ENUM_SUBLABEL_REWIND_SPILL_SIZE,
+   "Disk space in the cache directory for the oldest rewind history, once the compressed rewind buffer is full. 0 disables it."
+   )
+MSG_HASH(
+   MSG_REWIND_RETAINED,
+   "Rewind History: %.1f s (%u states) - %.1f MB memory, %.1f MB compressed, %.1f MB disk"
+   )
 MSG_HASH(
    MENU_ENUM_LABEL_VALUE_REWIND_BUFFER_SIZE,
    "Rewind Buffer Size (MB)"
@@ -12606,6 +12706,14 @@ MSG_HASH(
    MSG_RUNAHEAD_FAILED_TO_CREATE_SECONDARY_INSTANCE,
    "Failed to create second instance. Run-Ahead will now use only one instance."
    )
+MSG_HASH(
+   MSG_FRAME_PROFILER_EXPORTED,
+   "Frame time trace written to \"%s\"."
+   )
+MSG_HASH(
+   MSG_FRAME_PROFILER_EXPORT_FAILED,
+   "Failed to write frame time trace."
+   )
 MSG_HASH(
    MSG_SCANNING_OF_FILE_FINISHED,
    "Scanning of file finished"
@@ -28,9 +28,23 @@
 #include <altivec.h>
 #endif
 
+#include <boolean.h>
 #include <features/features_cpu.h>
 #include <audio/conversion/float_to_s16.h>
 
+/* The AVX2 kernel is compiled for its ISA through a function
+ * attribute and only used when the CPU supports it. */
+#if (defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)) \
+   && (defined(__clang__) || (defined(__GNUC__) && __GNUC__ >= 7) || (defined(_MSC_VER) && _MSC_VER >= 1910))
+#define FLOAT_TO_S16_HAVE_AVX2
+#include <immintrin.h>
+#if defined(__GNUC__) || defined(__clang__)
+#define FLOAT_TO_S16_TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#define FLOAT_TO_S16_TARGET_AVX2
+#endif
+#endif
+
 #if (defined(__ARM_NEON__) || defined(HAVE_NEON))
 #include <arm_neon.h>
 static bool float_to_s16_neon_enabled = false;
@@ -90,13 +104,52 @@ void convert_float_to_s16_init_simd(void)
       float_to_s16_neon_enabled = true;
 }
 #else
+#ifdef FLOAT_TO_S16_HAVE_AVX2
+static bool float_to_s16_avx2_enabled = false;
+
+/* Converts 16 samples per iteration, returns how many were done.
+ * Rounds and saturates the same way as the SSE2 path. */
+static FLOAT_TO_S16_TARGET_AVX2 size_t convert_float_to_s16_avx2(
+      int16_t *out, const float *in, size_t samples)
+{
+   size_t i;
+   __m256 factor = _mm256_set1_ps((float)0x8000);
+
+   for (i = 0; i + 16 <= samples; i += 16)
+   {
+      __m256i ints_l = _mm256_cvtps_epi32(
+            _mm256_mul_ps(_mm256_loadu_ps(in + i), factor));
+      __m256i ints_r = _mm256_cvtps_epi32(
+            _mm256_mul_ps(_mm256_loadu_ps(in + i + 8), factor));
+      /* Packing works per 128-bit lane, put the quarters back
+       * in order */
+      __m256i packed = _mm256_permute4x64_epi64(
+            _mm256_packs_epi32(ints_l, ints_r), 0xd8);
+
+      _mm256_storeu_si256((__m256i*)(out + i), packed);
+   }
+
+   return i;
+}
+#endif
+
 void convert_float_to_s16(int16_t *out,
       const float *in, size_t samples)
 {
    size_t i          = 0;
 #if defined(__SSE2__)
    __m128 factor     = _mm_set1_ps((float)0x8000);
-
+#endif
+#ifdef FLOAT_TO_S16_HAVE_AVX2
+   if (float_to_s16_avx2_enabled)
+   {
+      size_t done    = convert_float_to_s16_avx2(out, in, samples);
+      in            += done;
+      out           += done;
+      samples       -= done;
+   }
+#endif
+#if defined(__SSE2__)
    for (i = 0; i + 8 <= samples; i += 8, in += 8, out += 8)
    {
       __m128 input_l = _mm_loadu_ps(in + 0);
@@ -173,5 +226,12 @@ void convert_float_to_s16(int16_t *out,
    }
 }
 
-void convert_float_to_s16_init_simd(void) { }
+void convert_float_to_s16_init_simd(void)
+{
+#ifdef FLOAT_TO_S16_HAVE_AVX2
+   uint64_t cpu = cpu_features_get();
+
+   float_to_s16_avx2_enabled = (cpu & RETRO_SIMD_AVX2) ? true : false;
+#endif
+}
 #endif
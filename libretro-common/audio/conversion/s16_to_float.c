@@ -29,6 +29,19 @@
 #include <features/features_cpu.h>
 #include <audio/conversion/s16_to_float.h>
 
+/* The AVX2 kernel is compiled for its ISA through a function
+ * attribute and only used when the CPU supports it. */
+#if (defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)) \
+   && (defined(__clang__) || (defined(__GNUC__) && __GNUC__ >= 7) || (defined(_MSC_VER) && _MSC_VER >= 1910))
+#define S16_TO_FLOAT_HAVE_AVX2
+#include <immintrin.h>
+#if defined(__GNUC__) || defined(__clang__)
+#define S16_TO_FLOAT_TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#define S16_TO_FLOAT_TARGET_AVX2
+#endif
+#endif
+
 #if (defined(__ARM_NEON__) || defined(HAVE_NEON))
 static bool s16_to_float_neon_enabled = false;
 
@@ -90,15 +103,53 @@ void convert_s16_to_float_init_simd(void)
       s16_to_float_neon_enabled = true;
 }
 #else
+#ifdef S16_TO_FLOAT_HAVE_AVX2
+static bool s16_to_float_avx2_enabled = false;
+
+/* Converts 16 samples per iteration, returns how many were done. */
+static S16_TO_FLOAT_TARGET_AVX2 size_t convert_s16_to_float_avx2(
+      float *out, const int16_t *in, size_t samples, float gain)
+{
+   size_t i;
+   __m256 factor = _mm256_set1_ps(gain / 0x8000);
+
+   for (i = 0; i + 16 <= samples; i += 16)
+   {
+      __m256i lo = _mm256_cvtepi16_epi32(
+            _mm_loadu_si128((const __m128i*)(in + i)));
+      __m256i hi = _mm256_cvtepi16_epi32(
+            _mm_loadu_si128((const __m128i*)(in + i + 8)));
+
+      _mm256_storeu_ps(out + i,
+            _mm256_mul_ps(_mm256_cvtepi32_ps(lo), factor));
+      _mm256_storeu_ps(out + i + 8,
+            _mm256_mul_ps(_mm256_cvtepi32_ps(hi), factor));
+   }
+
+   return i;
+}
+#endif
+
 void convert_s16_to_float(float *out,
       const int16_t *in, size_t samples, float gain)
 {
    unsigned i      = 0;
-
 #if defined(__SSE2__)
-   float fgain   = gain / UINT32_C(0x80000000);
-   __m128 factor = _mm_set1_ps(fgain);
+   float fgain     = gain / UINT32_C(0x80000000);
+   __m128 factor   = _mm_set1_ps(fgain);
+#endif
 
+#ifdef S16_TO_FLOAT_HAVE_AVX2
+   if (s16_to_float_avx2_enabled)
+   {
+      size_t done = convert_s16_to_float_avx2(out, in, samples, gain);
+      in         += done;
+      out        += done;
+      samples    -= done;
+   }
+#endif
+
+#if defined(__SSE2__)
    for (i = 0; i + 8 <= samples; i += 8, in += 8, out += 8)
    {
       __m128i input    = _mm_loadu_si128((const __m128i *)in);
@@ -200,6 +251,13 @@ void convert_s16_to_float(float *out,
       out[i] = (float)in[i] * gain;
 }
 
-void convert_s16_to_float_init_simd(void) { }
+void convert_s16_to_float_init_simd(void)
+{
+#ifdef S16_TO_FLOAT_HAVE_AVX2
+   uint64_t cpu = cpu_features_get();
+
+   s16_to_float_avx2_enabled = (cpu & RETRO_SIMD_AVX2) ? true : false;
+#endif
+}
 #endif
 
@@ -44,6 +44,7 @@ retro_resampler_t null_resampler = {
 
 static const retro_resampler_t *resampler_drivers[] = {
    &sinc_resampler,
+   &polyphase_resampler,
 #ifdef HAVE_CC_RESAMPLER
    &CC_resampler,
 #endif
@@ -117,6 +118,12 @@ static bool resampler_append_plugs(void **re,
       double bw_ratio)
 {
    resampler_simd_mask_t mask = (resampler_simd_mask_t)cpu_features_get();
+   uint64_t ext               = cpu_features_get_extensions();
+
+   if (ext & CPU_FEATURES_FMA)
+      mask |= RESAMPLER_SIMD_FMA;
+   if (ext & CPU_FEATURES_AVX512)
+      mask |= RESAMPLER_SIMD_AVX512;
 
    if (*backend)
       *re = (*backend)->init(&resampler_config, bw_ratio, quality, mask);
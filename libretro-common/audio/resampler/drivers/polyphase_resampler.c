@@ -0,0 +1,800 @@
+/* Copyright  (C) 2010-2020 The RetroArch team
+ *
+ * ---------------------------------------------------------------------------------------
+ * The following license statement only applies to this file (polyphase_resampler.c).
+ * ---------------------------------------------------------------------------------------
+ *
+ * Permission is hereby granted, free of charge,
+ * to any person obtaining a copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+ * and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/* Polyphase Kaiser-windowed SINC with precomputed filter banks.
+ *
+ * Unlike the sinc driver, the filter bank is not tied to the
+ * bandwidth the resampler was created with: downsampling ratios
+ * are grouped in 1/16 octave buckets, and a bank is built (and
+ * cached) for each bucket the ratio falls in. The dot products
+ * run on planar history, so any number of interleaved channels
+ * can be processed, and the SIMD kernel is picked at runtime
+ * from the CPU features mask.
+ */
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <math.h>
+#include <string.h>
+
+#include <retro_inline.h>
+#include <filters.h>
+#include <memalign.h>
+
+#include <audio/audio_resampler.h>
+
+#if defined(__SSE__)
+#include <xmmintrin.h>
+#endif
+
+/* AVX2 and AVX-512 kernels are compiled for the target ISA through
+ * function attributes, so the rest of the file (and the frontend)
+ * does not need to be built with -mavx2. */
+#if (defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)) \
+   && (defined(__clang__) || (defined(__GNUC__) && __GNUC__ >= 7) || (defined(_MSC_VER) && _MSC_VER >= 1910))
+#define POLYPHASE_HAVE_X86_KERNELS
+#include <immintrin.h>
+#if defined(__GNUC__) || defined(__clang__)
+#define POLYPHASE_TARGET_AVX2   __attribute__((target("avx2,fma")))
+#define POLYPHASE_TARGET_AVX512 __attribute__((target("avx512f")))
+#else
+#define POLYPHASE_TARGET_AVX2
+#define POLYPHASE_TARGET_AVX512
+#endif
+#endif
+
+#if defined(__ARM_NEON__) || defined(__ARM_NEON) || defined(HAVE_NEON)
+#define POLYPHASE_HAVE_NEON
+#include <arm_neon.h>
+#endif
+
+/* Taps are padded to a whole number of AVX vectors. */
+#define POLYPHASE_TAP_ALIGN    8
+/* Total fixed-point bits of the time accumulator. */
+#define POLYPHASE_TIME_BITS    24
+/* Ratios are bucketed every 1/POLYPHASE_BUCKETS_PER_OCTAVE octave. */
+#define POLYPHASE_BUCKETS_PER_OCTAVE 16
+/* Lowest supported ratio; anything lower is filtered as this. */
+#define POLYPHASE_MIN_RATIO    0.25
+/* Dynamic rate control keeps the ratio within a fraction of a
+ * percent of 1.0, don't throw away bandwidth for that. */
+#define POLYPHASE_UNITY_RATIO  0.99
+/* Number of filter banks kept around. */
+#define POLYPHASE_CACHED_BANKS 4
+
+typedef void (*polyphase_kernel_t)(const float *coeff,
+      const float *delta, float frac, float *scratch,
+      const float *history, size_t history_stride,
+      unsigned channels, unsigned taps, float *out);
+
+typedef struct polyphase_bank
+{
+   /* With interpolation, each phase holds 'taps' coefficients
+    * followed by 'taps' deltas to the next phase. Without,
+    * each phase only holds the coefficients, and there is one
+    * extra phase so the phase can be rounded to nearest. */
+   float *table;
+   unsigned taps;
+   unsigned stamp;
+   int bucket;
+} polyphase_bank_t;
+
+struct polyphase_resampler
+{
+   polyphase_bank_t banks[POLYPHASE_CACHED_BANKS];
+   polyphase_bank_t *bank;
+   /* Kernel for the current bank */
+   polyphase_kernel_t kernel;
+   const char *kernel_ident;
+   resampler_simd_mask_t mask;
+
+   /* Planar history, each channel holds two copies of a ring of
+    * 'history_len' samples so a window never has to wrap. */
+   float *history;
+   float *scratch;
+   size_t history_stride;
+   unsigned history_len;
+   unsigned ptr;
+   unsigned channels;
+
+   unsigned phase_bits;
+   unsigned subphase_bits;
+   unsigned subphase_mask;
+   float subphase_mod;
+   uint32_t time;
+   unsigned stamp;
+
+   /* Filter design */
+   double cutoff;
+   double kaiser_beta;
+   unsigned sidelobes;
+   bool interpolate;
+};
+
+/* Kernels
+ *
+ * 'coeff' is the phase right before the output sample, 'delta'
+ * the difference to the next phase (or NULL to use 'coeff' as is).
+ * Interpolated coefficients are written to 'scratch' once and
+ * reused for every channel, channels are filtered in pairs so
+ * the coefficients are only loaded once per pair. 'taps' is a
+ * multiple of POLYPHASE_TAP_ALIGN; 'coeff', 'delta' and 'scratch'
+ * are 32-byte aligned, the history is not. */
+
+static void polyphase_kernel_c(const float *coeff,
+      const float *delta, float frac, float *scratch,
+      const float *history, size_t history_stride,
+      unsigned channels, unsigned taps, float *out)
+{
+   unsigned c, i;
+
+   if (delta)
+   {
+      for (i = 0; i < taps; i++)
+         scratch[i] = coeff[i] + delta[i] * frac;
+      coeff = scratch;
+   }
+
+   for (c = 0; c + 1 < channels; c += 2, history += 2 * history_stride)
+   {
+      const float *history_b = history + history_stride;
+      float sum_a            = 0.0f;
+      float sum_b            = 0.0f;
+      for (i = 0; i < taps; i++)
+      {
+         sum_a += coeff[i] * history[i];
+         sum_b += coeff[i] * history_b[i];
+      }
+      out[c]     = sum_a;
+      out[c + 1] = sum_b;
+   }
+
+   if (c < channels)
+   {
+      float sum = 0.0f;
+      for (i = 0; i < taps; i++)
+         sum += coeff[i] * history[i];
+      out[c] = sum;
+   }
+}
+
+#if defined(__SSE__)
+static void polyphase_kernel_sse(const float *coeff,
+      const float *delta, float frac, float *scratch,
+      const float *history, size_t history_stride,
+      unsigned channels, unsigned taps, float *out)
+{
+   unsigned c, i;
+
+   if (delta)
+   {
+      __m128 f = _mm_set1_ps(frac);
+      for (i = 0; i < taps; i += 4)
+         _mm_store_ps(scratch + i, _mm_add_ps(_mm_load_ps(coeff + i),
+                  _mm_mul_ps(_mm_load_ps(delta + i), f)));
+      coeff = scratch;
+   }
+
+   for (c = 0; c + 1 < channels; c += 2, history += 2 * history_stride)
+   {
+      __m128 sum;
+      const float *history_b = history + history_stride;
+      __m128 sum_a           = _mm_setzero_ps();
+      __m128 sum_b           = _mm_setzero_ps();
+      for (i = 0; i < taps; i += 4)
+      {
+         __m128 co = _mm_load_ps(coeff + i);
+         sum_a     = _mm_add_ps(sum_a, _mm_mul_ps(co, _mm_loadu_ps(history + i)));
+         sum_b     = _mm_add_ps(sum_b, _mm_mul_ps(co, _mm_loadu_ps(history_b + i)));
+      }
+      /* Horizontal add of both channels at once */
+      sum = _mm_add_ps(_mm_unpacklo_ps(sum_a, sum_b),
+            _mm_unpackhi_ps(sum_a, sum_b));
+      sum = _mm_add_ps(sum, _mm_movehl_ps(sum, sum));
+      _mm_storel_pi((__m64*)(out + c), sum);
+   }
+
+   if (c < channels)
+   {
+      __m128 sum = _mm_setzero_ps();
+      for (i = 0; i < taps; i += 4)
+         sum = _mm_add_ps(sum, _mm_mul_ps(_mm_load_ps(coeff + i),
+                  _mm_loadu_ps(history + i)));
+      sum = _mm_add_ps(sum, _mm_movehl_ps(sum, sum));
+      sum = _mm_add_ss(sum, _mm_shuffle_ps(sum, sum, 1));
+      _mm_store_ss(out + c, sum);
+   }
+}
+#endif
+
+#ifdef POLYPHASE_HAVE_X86_KERNELS
+POLYPHASE_TARGET_AVX2
+static void polyphase_kernel_avx2(const float *coeff,
+      const float *delta, float frac, float *scratch,
+      const float *history, size_t history_stride,
+      unsigned channels, unsigned taps, float *out)
+{
+   unsigned c, i;
+
+   if (delta)
+   {
+      __m256 f = _mm256_set1_ps(frac);
+      for (i = 0; i < taps; i += 8)
+         _mm256_store_ps(scratch + i, _mm256_fmadd_ps(
+                  _mm256_load_ps(delta + i), f, _mm256_load_ps(coeff + i)));
+      coeff = scratch;
+   }
+
+   for (c = 0; c + 1 < channels; c += 2, history += 2 * history_stride)
+   {
+      __m128 sum;
+      __m256 sum8;
+      const float *history_b = history + history_stride;
+      __m256 sum_a           = _mm256_setzero_ps();
+      __m256 sum_b           = _mm256_setzero_ps();
+      for (i = 0; i < taps; i += 8)
+      {
+         __m256 co = _mm256_load_ps(coeff + i);
+         sum_a     = _mm256_fmadd_ps(co, _mm256_loadu_ps(history + i), sum_a);
+         sum_b     = _mm256_fmadd_ps(co, _mm256_loadu_ps(history_b + i), sum_b);
+      }
+      /* Horizontal add of both channels at once */
+      sum8 = _mm256_add_ps(_mm256_unpacklo_ps(sum_a, sum_b),
+            _mm256_unpackhi_ps(sum_a, sum_b));
+      sum  = _mm_add_ps(_mm256_castps256_ps128(sum8),
+            _mm256_extractf128_ps(sum8, 1));
+      sum  = _mm_add_ps(sum, _mm_movehl_ps(sum, sum));
+      _mm_storel_pi((__m64*)(out + c), sum);
+   }
+
+   if (c < channels)
+   {
+      __m128 sum;
+      __m256 sum8 = _mm256_setzero_ps();
+      for (i = 0; i < taps; i += 8)
+         sum8 = _mm256_fmadd_ps(_mm256_load_ps(coeff + i),
+               _mm256_loadu_ps(history + i), sum8);
+      sum  = _mm_add_ps(_mm256_castps256_ps128(sum8),
+            _mm256_extractf128_ps(sum8, 1));
+      sum  = _mm_add_ps(sum, _mm_movehl_ps(sum, sum));
+      sum  = _mm_add_ss(sum, _mm_shuffle_ps(sum, sum, 1));
+      _mm_store_ss(out + c, sum);
+   }
+}
+
+POLYPHASE_TARGET_AVX512
+static void polyphase_kernel_avx512(const float *coeff,
+      const float *delta, float frac, float *scratch,
+      const float *history, size_t history_stride,
+      unsigned channels, unsigned taps, float *out)
+{
+   unsigned c, i;
+
+   /* Taps are only a multiple of 8, the last vector
+    * may need to be half empty. */
+   __mmask16 tail = (taps & 15) ? 0x00FF : 0xFFFF;
+   unsigned body  = (taps - 1) & ~15;
+
+   if (delta)
+   {
+      __m512 f = _mm512_set1_ps(frac);
+      for (i = 0; i < body; i += 16)
+         _mm512_storeu_ps(scratch + i, _mm512_fmadd_ps(
+                  _mm512_loadu_ps(delta + i), f, _mm512_loadu_ps(coeff + i)));
+      _mm512_mask_storeu_ps(scratch + i, tail, _mm512_fmadd_ps(
+               _mm512_maskz_loadu_ps(tail, delta + i), f,
+               _mm512_maskz_loadu_ps(tail, coeff + i)));
+      coeff = scratch;
+   }
+
+   for (c = 0; c + 1 < channels; c += 2, history += 2 * history_stride)
+   {
+      __m512 co;
+      const float *history_b = history + history_stride;
+      __m512 sum_a           = _mm512_setzero_ps();
+      __m512 sum_b           = _mm512_setzero_ps();
+      for (i = 0; i < body; i += 16)
+      {
+         co    = _mm512_loadu_ps(coeff + i);
+         sum_a = _mm512_fmadd_ps(co, _mm512_loadu_ps(history + i), sum_a);
+         sum_b = _mm512_fmadd_ps(co, _mm512_loadu_ps(history_b + i), sum_b);
+      }
+      co    = _mm512_maskz_loadu_ps(tail, coeff + i);
+      sum_a = _mm512_fmadd_ps(co,
+            _mm512_maskz_loadu_ps(tail, history + i), sum_a);
+      sum_b = _mm512_fmadd_ps(co,
+            _mm512_maskz_loadu_ps(tail, history_b + i), sum_b);
+      out[c]     = _mm512_reduce_add_ps(sum_a);
+      out[c + 1] = _mm512_reduce_add_ps(sum_b);
+   }
+
+   if (c < channels)
+   {
+      __m512 sum = _mm512_setzero_ps();
+      for (i = 0; i < body; i += 16)
+         sum = _mm512_fmadd_ps(_mm512_loadu_ps(coeff + i),
+               _mm512_loadu_ps(history + i), sum);
+      sum = _mm512_fmadd_ps(_mm512_maskz_loadu_ps(tail, coeff + i),
+            _mm512_maskz_loadu_ps(tail, history + i), sum);
+      out[c] = _mm512_reduce_add_ps(sum);
+   }
+}
+#endif
+
+#ifdef POLYPHASE_HAVE_NEON
+static void polyphase_kernel_neon(const float *coeff,
+      const float *delta, float frac, float *scratch,
+      const float *history, size_t history_stride,
+      unsigned channels, unsigned taps, float *out)
+{
+   unsigned c, i;
+
+   if (delta)
+   {
+      float32x4_t f = vdupq_n_f32(frac);
+      for (i = 0; i < taps; i += 4)
+         vst1q_f32(scratch + i, vmlaq_f32(vld1q_f32(coeff + i),
+                  vld1q_f32(delta + i), f));
+      coeff = scratch;
+   }
+
+   for (c = 0; c + 1 < channels; c += 2, history += 2 * history_stride)
+   {
+      float32x2_t sum_a2, sum_b2;
+      const float *history_b = history + history_stride;
+      float32x4_t sum_a      = vdupq_n_f32(0.0f);
+      float32x4_t sum_b      = vdupq_n_f32(0.0f);
+      for (i = 0; i < taps; i += 4)
+      {
+         float32x4_t co = vld1q_f32(coeff + i);
+         sum_a = vmlaq_f32(sum_a, co, vld1q_f32(history + i));
+         sum_b = vmlaq_f32(sum_b, co, vld1q_f32(history_b + i));
+      }
+      sum_a2 = vadd_f32(vget_low_f32(sum_a), vget_high_f32(sum_a));
+      sum_b2 = vadd_f32(vget_low_f32(sum_b), vget_high_f32(sum_b));
+      vst1_f32(out + c, vpadd_f32(sum_a2, sum_b2));
+   }
+
+   if (c < channels)
+   {
+      float32x2_t sum2;
+      float32x4_t sum = vdupq_n_f32(0.0f);
+      for (i = 0; i < taps; i += 4)
+         sum = vmlaq_f32(sum, vld1q_f32(coeff + i),
+               vld1q_f32(history + i));
+      sum2   = vadd_f32(vget_low_f32(sum), vget_high_f32(sum));
+      sum2   = vpadd_f32(sum2, sum2);
+      out[c] = vget_lane_f32(sum2, 0);
+   }
+}
+#endif
+
+typedef struct polyphase_kernel_info
+{
+   polyphase_kernel_t run;
+   const char *ident;
+   resampler_simd_mask_t mask;
+   /* Wide vectors lose to SSE on short filters. */
+   unsigned min_taps;
+} polyphase_kernel_info_t;
+
+/* Best first */
+static const polyphase_kernel_info_t polyphase_kernels[] = {
+#ifdef POLYPHASE_HAVE_X86_KERNELS
+   { polyphase_kernel_avx512, "avx512", RESAMPLER_SIMD_AVX512, 64 },
+   { polyphase_kernel_avx2,   "avx2",   RESAMPLER_SIMD_AVX2 | RESAMPLER_SIMD_FMA, 32 },
+#endif
+#if defined(__SSE__)
+   { polyphase_kernel_sse,    "sse",    RESAMPLER_SIMD_SSE, 0 },
+#endif
+#ifdef POLYPHASE_HAVE_NEON
+   { polyphase_kernel_neon,   "neon",   RESAMPLER_SIMD_NEON, 0 },
+#endif
+   { polyphase_kernel_c,      "c",      0, 0 }
+};
+
+/* Filter banks */
+
+static unsigned polyphase_round_taps(unsigned taps)
+{
+   return (taps + POLYPHASE_TAP_ALIGN - 1) & ~(POLYPHASE_TAP_ALIGN - 1);
+}
+
+/* Longest filter any bucket can need. */
+static unsigned polyphase_max_taps(const polyphase_resampler_t *re)
+{
+   return polyphase_round_taps(
+         (unsigned)ceil(re->sidelobes * 2 / POLYPHASE_MIN_RATIO));
+}
+
+/* Returns -1 when the ratio does not need a lower cutoff. */
+static int polyphase_ratio_bucket(double ratio)
+{
+   int bucket;
+
+   if (ratio >= POLYPHASE_UNITY_RATIO)
+      return -1;
+   if (ratio < POLYPHASE_MIN_RATIO)
+      ratio = POLYPHASE_MIN_RATIO;
+
+   bucket = (int)floor(-log(ratio) / log(2.0)
+         * POLYPHASE_BUCKETS_PER_OCTAVE);
+   if (bucket > 2 * POLYPHASE_BUCKETS_PER_OCTAVE - 1)
+      bucket = 2 * POLYPHASE_BUCKETS_PER_OCTAVE - 1;
+   return bucket;
+}
+
+static bool polyphase_build_bank(polyphase_resampler_t *re,
+      polyphase_bank_t *bank, int bucket)
+{
+   int p;
+   unsigned j, len, taps;
+   size_t elems;
+   double sidelobes;
+   /* Need to normalize w(0) to 1.0. */
+   double window_mod = kaiser_window_function(0.0, re->kaiser_beta);
+   int phases        = 1 << re->phase_bits;
+   double cutoff     = re->cutoff;
+   /* Filter length before padding */
+   len               = re->sidelobes * 2;
+
+   /* Downsampling, must lower cutoff, and extend number of
+    * taps accordingly to keep same stopband attenuation.
+    * Use the lower edge of the bucket so nothing aliases. */
+   if (bucket >= 0)
+   {
+      double bandwidth = pow(2.0,
+            -(double)(bucket + 1) / POLYPHASE_BUCKETS_PER_OCTAVE);
+      cutoff          *= bandwidth;
+      len              = (unsigned)ceil(len / bandwidth);
+      len              = (len + 1) & ~1;
+   }
+
+   taps      = polyphase_round_taps(len);
+   sidelobes = len / 2.0;
+   elems     = re->interpolate
+      ? (size_t)phases * taps * 2
+      : (size_t)(phases + 1) * taps;
+
+   memalign_free(bank->table);
+   bank->bucket = bucket;
+   bank->taps   = 0;
+   if (!(bank->table = (float*)memalign_alloc(32, elems * sizeof(float))))
+      return false;
+   /* Padding taps stay zero */
+   memset(bank->table, 0, elems * sizeof(float));
+
+   for (p = 0; p <= phases; p++)
+   {
+      for (j = 0; j < len; j++)
+      {
+         int n               = j * phases + p;
+         double window_phase = (double)n / (phases * len); /* [0, 1] */
+         double sinc_phase;
+         float val;
+
+         window_phase        = 2.0 * window_phase - 1.0;   /* [-1, 1] */
+         sinc_phase          = sidelobes * window_phase;
+         val                 = cutoff * sinc(M_PI * sinc_phase * cutoff) *
+            kaiser_window_function(window_phase, re->kaiser_beta) / window_mod;
+
+         if (!re->interpolate)
+            bank->table[p * taps + j] = val;
+         else
+         {
+            if (p < phases)
+               bank->table[p * taps * 2 + j] = val;
+            if (p > 0)
+               bank->table[(p - 1) * taps * 2 + taps + j] =
+                  val - bank->table[(p - 1) * taps * 2 + j];
+         }
+      }
+   }
+
+   bank->taps = taps;
+   return true;
+}
+
+static void polyphase_set_bank(polyphase_resampler_t *re,
+      polyphase_bank_t *bank)
+{
+   unsigned i;
+
+   re->bank = bank;
+
+   for (i = 0; i < sizeof(polyphase_kernels) / sizeof(polyphase_kernels[0]); i++)
+   {
+      const polyphase_kernel_info_t *info = &polyphase_kernels[i];
+      if (     (re->mask & info->mask) == info->mask
+            && bank->taps >= info->min_taps)
+      {
+         re->kernel       = info->run;
+         re->kernel_ident = info->ident;
+         return;
+      }
+   }
+}
+
+static polyphase_bank_t *polyphase_get_bank(
+      polyphase_resampler_t *re, int bucket)
+{
+   unsigned i;
+   polyphase_bank_t *victim = &re->banks[0];
+
+   for (i = 0; i < POLYPHASE_CACHED_BANKS; i++)
+   {
+      polyphase_bank_t *bank = &re->banks[i];
+      if (bank->table && bank->taps && bank->bucket == bucket)
+      {
+         bank->stamp = ++re->stamp;
+         return bank;
+      }
+      if (!bank->table || bank->stamp < victim->stamp)
+         victim = bank;
+   }
+
+   if (!polyphase_build_bank(re, victim, bucket))
+      return NULL;
+   victim->stamp = ++re->stamp;
+   return victim;
+}
+
+/* Public API */
+
+size_t polyphase_resampler_process(polyphase_resampler_t *re,
+      const float *in, size_t in_frames, float *out, double ratio)
+{
+   const float *table;
+   unsigned taps, phases;
+   uint32_t step;
+   polyphase_kernel_t kernel;
+   size_t out_frames         = 0;
+   unsigned channels         = re->channels;
+   size_t stride             = re->history_stride;
+   unsigned len              = re->history_len;
+   unsigned ptr              = re->ptr;
+   uint32_t time             = re->time;
+   unsigned subphase_bits    = re->subphase_bits;
+   unsigned subphase_mask    = re->subphase_mask;
+   float subphase_mod        = re->subphase_mod;
+   int bucket                = polyphase_ratio_bucket(ratio);
+
+   if (re->bank->bucket != bucket)
+   {
+      polyphase_bank_t *bank = polyphase_get_bank(re, bucket);
+      /* Out of memory, keep using the current bank */
+      if (bank)
+         polyphase_set_bank(re, bank);
+   }
+
+   kernel = re->kernel;
+   table  = re->bank->table;
+   taps   = re->bank->taps;
+   phases = 1 << (re->phase_bits + subphase_bits);
+   step   = (uint32_t)(phases / ratio);
+
+   while (in_frames)
+   {
+      while (in_frames && time >= phases)
+      {
+         unsigned c;
+         float *history;
+
+         /* Push in reverse to make filter more obvious. */
+         if (!ptr)
+            ptr = len;
+         ptr--;
+
+         history = re->history + ptr;
+         for (c = 0; c < channels; c++, history += stride)
+            history[0] = history[len] = *in++;
+
+         time -= phases;
+         in_frames--;
+      }
+
+      if (re->interpolate)
+      {
+         while (time < phases)
+         {
+            const float *coeff = table
+               + (time >> subphase_bits) * taps * 2;
+
+            kernel(coeff, coeff + taps,
+                  (time & subphase_mask) * subphase_mod,
+                  re->scratch, re->history + ptr, stride,
+                  channels, taps, out);
+
+            out  += channels;
+            out_frames++;
+            time += step;
+         }
+      }
+      else
+      {
+         while (time < phases)
+         {
+            /* Round to the nearest phase, the table has
+             * an extra phase for this. */
+            const float *coeff = table
+               + ((time + (1 << (subphase_bits - 1)))
+                     >> subphase_bits) * taps;
+
+            kernel(coeff, NULL, 0.0f, NULL, re->history + ptr, stride,
+                  channels, taps, out);
+
+            out  += channels;
+            out_frames++;
+            time += step;
+         }
+      }
+   }
+
+   re->ptr  = ptr;
+   re->time = time;
+   return out_frames;
+}
+
+const char *polyphase_resampler_kernel(const polyphase_resampler_t *re)
+{
+   return re->kernel_ident;
+}
+
+void polyphase_resampler_free(polyphase_resampler_t *re)
+{
+   unsigned i;
+
+   if (!re)
+      return;
+
+   for (i = 0; i < POLYPHASE_CACHED_BANKS; i++)
+      memalign_free(re->banks[i].table);
+   memalign_free(re->history);
+   memalign_free(re->scratch);
+   free(re);
+}
+
+polyphase_resampler_t *polyphase_resampler_new(unsigned channels,
+      double bandwidth_mod, enum resampler_quality quality,
+      resampler_simd_mask_t mask)
+{
+   unsigned max_taps;
+   polyphase_resampler_t *re = NULL;
+
+   if (!channels)
+      return NULL;
+
+   if (!(re = (polyphase_resampler_t*)calloc(1, sizeof(*re))))
+      return NULL;
+
+   switch (quality)
+   {
+      case RESAMPLER_QUALITY_LOWEST:
+         re->cutoff      = 0.90;
+         re->sidelobes   = 4;
+         re->kaiser_beta = 4.5;
+         re->phase_bits  = 8;
+         re->interpolate = false;
+         break;
+      case RESAMPLER_QUALITY_LOWER:
+         re->cutoff      = 0.90;
+         re->sidelobes   = 8;
+         re->kaiser_beta = 5.5;
+         re->phase_bits  = 9;
+         re->interpolate = false;
+         break;
+      case RESAMPLER_QUALITY_HIGHER:
+         re->cutoff      = 0.90;
+         re->sidelobes   = 32;
+         re->kaiser_beta = 10.5;
+         re->phase_bits  = 10;
+         re->interpolate = true;
+         break;
+      case RESAMPLER_QUALITY_HIGHEST:
+         re->cutoff      = 0.962;
+         re->sidelobes   = 128;
+         re->kaiser_beta = 14.5;
+         re->phase_bits  = 10;
+         re->interpolate = true;
+         break;
+      case RESAMPLER_QUALITY_NORMAL:
+      case RESAMPLER_QUALITY_DONTCARE:
+         re->cutoff      = 0.825;
+         re->sidelobes   = 8;
+         re->kaiser_beta = 5.5;
+         re->phase_bits  = 8;
+         re->interpolate = true;
+         break;
+   }
+
+   re->channels      = channels;
+   re->subphase_bits = POLYPHASE_TIME_BITS - re->phase_bits;
+   re->subphase_mask = (1 << re->subphase_bits) - 1;
+   re->subphase_mod  = 1.0f / (1 << re->subphase_bits);
+   /* Start with the first output right at the first input */
+   re->time          = 1 << POLYPHASE_TIME_BITS;
+
+   max_taps           = polyphase_max_taps(re);
+   re->history_len    = max_taps;
+   re->history_stride = max_taps * 2;
+
+   if (!(re->history = (float*)memalign_alloc(32,
+               re->history_stride * channels * sizeof(float))))
+      goto error;
+   if (!(re->scratch = (float*)memalign_alloc(32,
+               max_taps * sizeof(float))))
+      goto error;
+
+   memset(re->history, 0, re->history_stride * channels * sizeof(float));
+
+#if defined(POLYPHASE_HAVE_NEON) && (defined(__aarch64__) || defined(_M_ARM64))
+   /* Always there on AArch64 */
+   mask |= RESAMPLER_SIMD_NEON;
+#endif
+   re->mask = mask;
+
+   /* Build the bank for the expected ratio now rather
+    * than on the first call to process. */
+   {
+      polyphase_bank_t *bank = polyphase_get_bank(re,
+            polyphase_ratio_bucket(bandwidth_mod));
+      if (!bank)
+         goto error;
+      polyphase_set_bank(re, bank);
+   }
+
+   return re;
+
+error:
+   polyphase_resampler_free(re);
+   return NULL;
+}
+
+/* Stereo driver interface */
+
+static void *resampler_polyphase_new(const struct resampler_config *config,
+      double bandwidth_mod, enum resampler_quality quality,
+      resampler_simd_mask_t mask)
+{
+   return polyphase_resampler_new(2, bandwidth_mod, quality, mask);
+}
+
+static void resampler_polyphase_process(void *re_, struct resampler_data *data)
+{
+   data->output_frames = polyphase_resampler_process(
+         (polyphase_resampler_t*)re_, data->data_in, data->input_frames,
+         data->data_out, data->ratio);
+}
+
+static void resampler_polyphase_free(void *re_)
+{
+   polyphase_resampler_free((polyphase_resampler_t*)re_);
+}
+
+retro_resampler_t polyphase_resampler = {
+   resampler_polyphase_new,
+   resampler_polyphase_process,
+   resampler_polyphase_free,
+   RESAMPLER_API_VERSION,
+   "polyphase",
+   "polyphase"
+};
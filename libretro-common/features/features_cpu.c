@@ -29,6 +29,7 @@
 #include <unistd.h>
 #endif
 
+#include <boolean.h>
 #include <compat/strl.h>
 #include <streams/file_stream.h>
 #include <libretro.h>
@@ -289,7 +290,10 @@ void x86_cpuid(int func, int flags[4])
          "cpuid\n"
          "xchg %%" REG_b ", %%" REG_S "\n"
          : "=a"(flags[0]), "=S"(flags[1]), "=c"(flags[2]), "=d"(flags[3])
-         : "a"(func));
+         : "a"(func), "c"(0));
+#elif defined(_MSC_VER) && _MSC_VER >= 1500
+   /* Leaf 7 has subleaves, ECX must be 0 */
+   __cpuidex(flags, func, 0);
 #elif defined(_MSC_VER)
    __cpuid(flags, func);
 #else
@@ -588,87 +592,82 @@ unsigned cpu_features_get_core_amount(void)
 #define VENDOR_INTEL_c  0x6c65746e
 #define VENDOR_INTEL_d  0x49656e69
 
-/**
- * cpu_features_get:
- *
- * Gets CPU features..
- *
- * Returns: bitmask of all CPU features available.
- **/
-uint64_t cpu_features_get(void)
+#if defined(__MACH__)
+/* The hw.optional keys of features a CPU lacks may
+ * exist with a value of 0 */
+static bool cpu_features_sysctl_enabled(const char *name)
+{
+   int64_t value = 0;
+   size_t len    = sizeof(value);
+   return sysctlbyname(name, &value, &len, NULL, 0) == 0 && value;
+}
+#endif
+
+static uint64_t cpu_features_query(uint64_t *extensions)
 {
    uint64_t cpu        = 0;
+   uint64_t ext        = 0;
 #if defined(CPU_X86) && !defined(__MACH__)
    int vendor_is_intel = 0;
    const int avx_flags = (1 << 27) | (1 << 28);
 #endif
 #if defined(__MACH__)
-   size_t len          = sizeof(size_t);
-
-   if (sysctlbyname("hw.optional.floatingpoint", NULL, &len, NULL, 0) == 0)
+   if (cpu_features_sysctl_enabled("hw.optional.floatingpoint"))
    {
       cpu |= RETRO_SIMD_CMOV;
    }
 
 #if defined(CPU_X86)
-   len            = sizeof(size_t);
-   if (sysctlbyname("hw.optional.mmx", NULL, &len, NULL, 0) == 0)
+   if (cpu_features_sysctl_enabled("hw.optional.mmx"))
    {
       cpu |= RETRO_SIMD_MMX;
       cpu |= RETRO_SIMD_MMXEXT;
    }
 
-   len            = sizeof(size_t);
-   if (sysctlbyname("hw.optional.sse", NULL, &len, NULL, 0) == 0)
+   if (cpu_features_sysctl_enabled("hw.optional.sse"))
       cpu |= RETRO_SIMD_SSE;
 
-   len            = sizeof(size_t);
-   if (sysctlbyname("hw.optional.sse2", NULL, &len, NULL, 0) == 0)
+   if (cpu_features_sysctl_enabled("hw.optional.sse2"))
       cpu |= RETRO_SIMD_SSE2;
 
-   len            = sizeof(size_t);
-   if (sysctlbyname("hw.optional.sse3", NULL, &len, NULL, 0) == 0)
+   if (cpu_features_sysctl_enabled("hw.optional.sse3"))
       cpu |= RETRO_SIMD_SSE3;
 
-   len            = sizeof(size_t);
-   if (sysctlbyname("hw.optional.supplementalsse3", NULL, &len, NULL, 0) == 0)
+   if (cpu_features_sysctl_enabled("hw.optional.supplementalsse3"))
       cpu |= RETRO_SIMD_SSSE3;
 
-   len            = sizeof(size_t);
-   if (sysctlbyname("hw.optional.sse4_1", NULL, &len, NULL, 0) == 0)
+   if (cpu_features_sysctl_enabled("hw.optional.sse4_1"))
       cpu |= RETRO_SIMD_SSE4;
 
-   len            = sizeof(size_t);
-   if (sysctlbyname("hw.optional.sse4_2", NULL, &len, NULL, 0) == 0)
+   if (cpu_features_sysctl_enabled("hw.optional.sse4_2"))
       cpu |= RETRO_SIMD_SSE42;
 
-   len            = sizeof(size_t);
-   if (sysctlbyname("hw.optional.aes", NULL, &len, NULL, 0) == 0)
+   if (cpu_features_sysctl_enabled("hw.optional.aes"))
       cpu |= RETRO_SIMD_AES;
 
-   len            = sizeof(size_t);
-   if (sysctlbyname("hw.optional.avx1_0", NULL, &len, NULL, 0) == 0)
+   if (cpu_features_sysctl_enabled("hw.optional.avx1_0"))
       cpu |= RETRO_SIMD_AVX;
 
-   len            = sizeof(size_t);
-   if (sysctlbyname("hw.optional.avx2_0", NULL, &len, NULL, 0) == 0)
+   if (cpu_features_sysctl_enabled("hw.optional.avx2_0"))
       cpu |= RETRO_SIMD_AVX2;
 
-   len            = sizeof(size_t);
-   if (sysctlbyname("hw.optional.altivec", NULL, &len, NULL, 0) == 0)
+   if (cpu_features_sysctl_enabled("hw.optional.fma"))
+      ext |= CPU_FEATURES_FMA;
+
+   if (cpu_features_sysctl_enabled("hw.optional.avx512f"))
+      ext |= CPU_FEATURES_AVX512;
+
+   if (cpu_features_sysctl_enabled("hw.optional.altivec"))
       cpu |= RETRO_SIMD_VMX;
 
 #else
-   len            = sizeof(size_t);
-   if (sysctlbyname("hw.optional.neon", NULL, &len, NULL, 0) == 0)
+   if (cpu_features_sysctl_enabled("hw.optional.neon"))
       cpu |= RETRO_SIMD_NEON;
 
-   len            = sizeof(size_t);
-   if (sysctlbyname("hw.optional.neon_fp16", NULL, &len, NULL, 0) == 0)
+   if (cpu_features_sysctl_enabled("hw.optional.neon_fp16"))
       cpu |= RETRO_SIMD_VFPV3;
 
-   len            = sizeof(size_t);
-   if (sysctlbyname("hw.optional.neon_hpfp", NULL, &len, NULL, 0) == 0)
+   if (cpu_features_sysctl_enabled("hw.optional.neon_hpfp"))
       cpu |= RETRO_SIMD_VFPV4;
 #endif
 #elif defined(_XBOX1)
@@ -681,6 +680,7 @@ uint64_t cpu_features_get(void)
    int vendor_shuffle[3];
    char vendor[13];
    uint64_t cpu_flags  = 0;
+   uint64_t xcr0       = 0;
    x86_cpuid(0, flags);
    vendor_shuffle[0] = flags[1];
    vendor_shuffle[1] = flags[3];
@@ -742,14 +742,24 @@ uint64_t cpu_features_get(void)
    /* Must only perform xgetbv check if we have
     * AVX CPU support (guaranteed to have at least i686). */
    if (((flags[2] & avx_flags) == avx_flags)
-         && ((xgetbv_x86(0) & 0x6) == 0x6))
+         && (((xcr0 = xgetbv_x86(0)) & 0x6) == 0x6))
+   {
       cpu |= RETRO_SIMD_AVX;
 
+      if (flags[2] & (1 << 12))
+         ext |= CPU_FEATURES_FMA;
+   }
+
    if (max_flag >= 7)
    {
       x86_cpuid(7, flags);
       if (flags[1] & (1 << 5))
          cpu |= RETRO_SIMD_AVX2;
+
+      /* AVX-512 also needs the OS to save the opmask
+       * and upper ZMM registers. */
+      if ((flags[1] & (1 << 16)) && ((xcr0 & 0xe6) == 0xe6))
+         ext |= CPU_FEATURES_AVX512;
    }
 
    x86_cpuid(0x80000000, flags);
@@ -816,9 +826,37 @@ uint64_t cpu_features_get(void)
    cpu |= RETRO_SIMD_PS;
 #endif
 
+   if (extensions)
+      *extensions = ext;
    return cpu;
 }
 
+/**
+ * cpu_features_get:
+ *
+ * Gets CPU features..
+ *
+ * Returns: bitmask of all CPU features available.
+ **/
+uint64_t cpu_features_get(void)
+{
+   return cpu_features_query(NULL);
+}
+
+/**
+ * cpu_features_get_extensions:
+ *
+ * Gets the CPU features that have no RETRO_SIMD_* bit.
+ *
+ * Returns: bitmask of CPU_FEATURES_* flags.
+ **/
+uint64_t cpu_features_get_extensions(void)
+{
+   uint64_t ext = 0;
+   cpu_features_query(&ext);
+   return ext;
+}
+
 void cpu_features_get_model_name(char *name, int len)
 {
 #if defined(CPU_X86) && !defined(__MACH__)
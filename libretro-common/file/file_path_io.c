@@ -40,6 +40,7 @@
 
 #ifdef _WIN32
 #include <direct.h>
+#include <encodings/utf.h>
 #else
 #include <unistd.h> /* stat() is defined here */
 #endif
@@ -100,6 +101,78 @@ int32_t path_get_size(const char *path)
    return -1;
 }
 
+/**
+ * path_get_info:
+ * @path               : path
+ * @size               : size of the file in bytes, if not NULL.
+ * @mtime              : time of its last modification, in seconds
+ *                       since the epoch, if not NULL.
+ *
+ * Unlike the functions above, this asks the platform directly:
+ * the VFS interface has no file times.
+ *
+ * Returns: true if the file exists and the platform reports both.
+ */
+bool path_get_info(const char *path, int64_t *size, int64_t *mtime)
+{
+#if defined(_XBOX) || defined(VITA) || defined(ORBIS) || defined(__PSL1GHT__) || defined(__PS3__)
+   (void)path;
+   (void)size;
+   (void)mtime;
+   return false;
+#elif defined(_WIN32) && !defined(LEGACY_WIN32)
+   struct __stat64 buf;
+   int ret;
+   wchar_t *path_wide = NULL;
+
+   if (!path || !*path)
+      return false;
+   if (!(path_wide = utf8_to_utf16_string_alloc(path)))
+      return false;
+
+   ret = _wstat64(path_wide, &buf);
+   free(path_wide);
+
+   if (ret != 0)
+      return false;
+   if (size)
+      *size  = (int64_t)buf.st_size;
+   if (mtime)
+      *mtime = (int64_t)buf.st_mtime;
+   return true;
+#elif defined(_WIN32)
+   struct _stat buf;
+   int ret;
+   char *path_local = NULL;
+
+   if (!path || !*path)
+      return false;
+   if (!(path_local = utf8_to_local_string_alloc(path)))
+      return false;
+
+   ret = _stat(path_local, &buf);
+   free(path_local);
+
+   if (ret != 0)
+      return false;
+   if (size)
+      *size  = (int64_t)buf.st_size;
+   if (mtime)
+      *mtime = (int64_t)buf.st_mtime;
+   return true;
+#else
+   struct stat buf;
+
+   if (!path || !*path || stat(path, &buf) != 0)
+      return false;
+   if (size)
+      *size  = (int64_t)buf.st_size;
+   if (mtime)
+      *mtime = (int64_t)buf.st_mtime;
+   return true;
+#endif
+}
+
 /**
  * path_mkdir:
  * @dir                : directory
@@ -0,0 +1,331 @@
+/* Copyright  (C) 2010-2020 The RetroArch team
+ *
+ * ---------------------------------------------------------------------------------------
+ * The following license statement only applies to this file (frame_diff.c).
+ * ---------------------------------------------------------------------------------------
+ *
+ * Permission is hereby granted, free of charge,
+ * to any person obtaining a copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+ * and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <boolean.h>
+#include <libretro.h>
+#include <retro_miscellaneous.h>
+
+#include <gfx/frame_diff.h>
+
+#if _MSC_VER && _MSC_VER <= 1800
+#define FRAME_DIFF_NO_SIMD
+#endif
+
+#if defined(__SSE2__) && !defined(FRAME_DIFF_NO_SIMD)
+#include <emmintrin.h>
+#endif
+
+/* Same arrangement as pixconv: the AVX2 loops are compiled for
+ * their ISA through a function attribute and only used once
+ * frame_diff_init_simd() saw AVX2 in the CPU mask. */
+#if !defined(FRAME_DIFF_NO_SIMD) \
+   && (defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)) \
+   && (defined(__clang__) || (defined(__GNUC__) && __GNUC__ >= 7) || (defined(_MSC_VER) && _MSC_VER >= 1910))
+#define FRAME_DIFF_HAVE_AVX2
+#include <immintrin.h>
+#if defined(__GNUC__) || defined(__clang__)
+#define FRAME_DIFF_TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#define FRAME_DIFF_TARGET_AVX2
+#endif
+#endif
+
+#if !defined(FRAME_DIFF_NO_SIMD) && (defined(__ARM_NEON__) || defined(__ARM_NEON) || defined(HAVE_NEON))
+#define FRAME_DIFF_HAVE_NEON
+#include <arm_neon.h>
+#endif
+
+#ifdef FRAME_DIFF_HAVE_AVX2
+static bool frame_diff_avx2_enabled = false;
+#endif
+#ifdef FRAME_DIFF_HAVE_NEON
+static bool frame_diff_neon_enabled = false;
+#endif
+
+void frame_diff_init_simd(uint64_t cpu)
+{
+#ifdef FRAME_DIFF_HAVE_AVX2
+   frame_diff_avx2_enabled = (cpu & RETRO_SIMD_AVX2) ? true : false;
+#endif
+#ifdef FRAME_DIFF_HAVE_NEON
+   frame_diff_neon_enabled = (cpu & RETRO_SIMD_NEON) ? true : false;
+#endif
+}
+
+/* Each of these skips the equal blocks at the start (forward)
+ * or end (backward) of [a, a + len) and returns how far it got
+ * in whole blocks, leaving the exact byte to the C loops. */
+
+#ifdef FRAME_DIFF_HAVE_AVX2
+static FRAME_DIFF_TARGET_AVX2 size_t frame_diff_forward_avx2(
+      const uint8_t *a, const uint8_t *b, size_t len)
+{
+   size_t i = 0;
+   for (; i + 32 <= len; i += 32)
+   {
+      __m256i va = _mm256_loadu_si256((const __m256i*)(a + i));
+      __m256i vb = _mm256_loadu_si256((const __m256i*)(b + i));
+      if ((unsigned)_mm256_movemask_epi8(_mm256_cmpeq_epi8(va, vb))
+            != 0xffffffffu)
+         break;
+   }
+   return i;
+}
+
+static FRAME_DIFF_TARGET_AVX2 size_t frame_diff_backward_avx2(
+      const uint8_t *a, const uint8_t *b, size_t len)
+{
+   size_t i = len;
+   for (; i >= 32; i -= 32)
+   {
+      __m256i va = _mm256_loadu_si256((const __m256i*)(a + i - 32));
+      __m256i vb = _mm256_loadu_si256((const __m256i*)(b + i - 32));
+      if ((unsigned)_mm256_movemask_epi8(_mm256_cmpeq_epi8(va, vb))
+            != 0xffffffffu)
+         break;
+   }
+   return i;
+}
+#endif
+
+#if defined(__SSE2__) && !defined(FRAME_DIFF_NO_SIMD)
+static size_t frame_diff_forward_sse2(
+      const uint8_t *a, const uint8_t *b, size_t len)
+{
+   size_t i = 0;
+   for (; i + 16 <= len; i += 16)
+   {
+      __m128i va = _mm_loadu_si128((const __m128i*)(a + i));
+      __m128i vb = _mm_loadu_si128((const __m128i*)(b + i));
+      if (_mm_movemask_epi8(_mm_cmpeq_epi8(va, vb)) != 0xffff)
+         break;
+   }
+   return i;
+}
+
+static size_t frame_diff_backward_sse2(
+      const uint8_t *a, const uint8_t *b, size_t len)
+{
+   size_t i = len;
+   for (; i >= 16; i -= 16)
+   {
+      __m128i va = _mm_loadu_si128((const __m128i*)(a + i - 16));
+      __m128i vb = _mm_loadu_si128((const __m128i*)(b + i - 16));
+      if (_mm_movemask_epi8(_mm_cmpeq_epi8(va, vb)) != 0xffff)
+         break;
+   }
+   return i;
+}
+#endif
+
+#ifdef FRAME_DIFF_HAVE_NEON
+static bool frame_diff_block_equal_neon(const uint8_t *a, const uint8_t *b)
+{
+   uint64x2_t x = vreinterpretq_u64_u8(veorq_u8(vld1q_u8(a), vld1q_u8(b)));
+   return !(vgetq_lane_u64(x, 0) | vgetq_lane_u64(x, 1));
+}
+
+static size_t frame_diff_forward_neon(
+      const uint8_t *a, const uint8_t *b, size_t len)
+{
+   size_t i = 0;
+   for (; i + 16 <= len; i += 16)
+      if (!frame_diff_block_equal_neon(a + i, b + i))
+         break;
+   return i;
+}
+
+static size_t frame_diff_backward_neon(
+      const uint8_t *a, const uint8_t *b, size_t len)
+{
+   size_t i = len;
+   for (; i >= 16; i -= 16)
+      if (!frame_diff_block_equal_neon(a + i - 16, b + i - 16))
+         break;
+   return i;
+}
+#endif
+
+bool frame_diff_row_span(const uint8_t *a, const uint8_t *b, size_t len,
+      size_t *first, size_t *last)
+{
+   size_t start = 0;
+   size_t end   = len;
+
+#if defined(FRAME_DIFF_HAVE_AVX2)
+   if (frame_diff_avx2_enabled)
+      start = frame_diff_forward_avx2(a, b, len);
+#elif defined(FRAME_DIFF_HAVE_NEON)
+   if (frame_diff_neon_enabled)
+      start = frame_diff_forward_neon(a, b, len);
+#endif
+#if defined(__SSE2__) && !defined(FRAME_DIFF_NO_SIMD)
+   start += frame_diff_forward_sse2(a + start, b + start, len - start);
+#endif
+
+   while (start < len && a[start] == b[start])
+      start++;
+
+   if (start == len)
+      return false;
+
+   /* There is a difference at start, so the backward
+    * scan stops before it */
+#if defined(FRAME_DIFF_HAVE_AVX2)
+   if (frame_diff_avx2_enabled)
+      end = start + frame_diff_backward_avx2(
+            a + start, b + start, len - start);
+#elif defined(FRAME_DIFF_HAVE_NEON)
+   if (frame_diff_neon_enabled)
+      end = start + frame_diff_backward_neon(
+            a + start, b + start, len - start);
+#endif
+#if defined(__SSE2__) && !defined(FRAME_DIFF_NO_SIMD)
+   end = start + frame_diff_backward_sse2(
+         a + start, b + start, end - start);
+#endif
+
+   while (a[end - 1] == b[end - 1])
+      end--;
+
+   *first = start;
+   *last  = end;
+   return true;
+}
+
+void frame_diff_invalidate(frame_diff_t *diff)
+{
+   diff->valid = false;
+}
+
+void frame_diff_free(frame_diff_t *diff)
+{
+   free(diff->prev);
+   diff->prev      = NULL;
+   diff->prev_size = 0;
+   diff->valid     = false;
+}
+
+unsigned frame_diff_update(frame_diff_t *diff, const void *frame,
+      unsigned width, unsigned height, size_t pitch, unsigned bpp)
+{
+   unsigned y;
+   unsigned n             = 0;
+   bool extend            = false;
+   size_t row             = (size_t)width * bpp;
+   size_t size            = row * height;
+   const uint8_t *src     = (const uint8_t*)frame;
+   uint8_t *dst           = NULL;
+   struct frame_diff_rect *rect;
+
+   diff->frames++;
+   diff->pixels += (uint64_t)width * height;
+
+   if (     !diff->valid
+         || width  != diff->width
+         || height != diff->height
+         || bpp    != diff->bpp)
+   {
+      rect            = &diff->rects[0];
+      rect->x         = 0;
+      rect->y         = 0;
+      rect->width     = width;
+      rect->height    = height;
+      diff->num_rects = 1;
+      diff->pixels_changed += (uint64_t)width * height;
+
+      if (size > diff->prev_size)
+      {
+         uint8_t *prev = (uint8_t*)realloc(diff->prev, size);
+         if (!prev)
+         {
+            diff->valid = false;
+            return 1;
+         }
+         diff->prev      = prev;
+         diff->prev_size = size;
+      }
+
+      for (y = 0; y < height; y++)
+         memcpy(diff->prev + y * row, src + y * pitch, row);
+
+      diff->width  = width;
+      diff->height = height;
+      diff->bpp    = bpp;
+      diff->valid  = true;
+      return 1;
+   }
+
+   for (y = 0, dst = diff->prev; y < height; y++, src += pitch, dst += row)
+   {
+      size_t first, last;
+      unsigned x0, x1;
+
+      if (!frame_diff_row_span(src, dst, row, &first, &last))
+      {
+         extend = false;
+         continue;
+      }
+
+      memcpy(dst + first, src + first, last - first);
+      x0 = (unsigned)(first / bpp);
+      x1 = (unsigned)((last + bpp - 1) / bpp);
+
+      /* Out of rectangles: the last one grows down to here,
+       * over whatever did not change in between */
+      if (!extend && n == FRAME_DIFF_MAX_RECTS)
+         extend = true;
+
+      if (extend)
+      {
+         unsigned right = MAX(diff->rects[n - 1].x
+               + diff->rects[n - 1].width, x1);
+         rect           = &diff->rects[n - 1];
+         rect->x        = MIN(rect->x, x0);
+         rect->width    = right - rect->x;
+         rect->height   = y + 1 - rect->y;
+      }
+      else
+      {
+         rect         = &diff->rects[n++];
+         rect->x      = x0;
+         rect->y      = y;
+         rect->width  = x1 - x0;
+         rect->height = 1;
+         extend       = true;
+      }
+   }
+
+   diff->num_rects = n;
+
+   if (!n)
+      diff->frames_unchanged++;
+   for (y = 0; y < n; y++)
+      diff->pixels_changed += (uint64_t)diff->rects[y].width
+         * diff->rects[y].height;
+
+   return n;
+}
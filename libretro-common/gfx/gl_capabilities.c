@@ -324,6 +324,35 @@ bool gl_check_capability(enum gl_capability_enum enum_idx)
 #else
          if (gl_query_extension("EXT_texture_storage"))
             return true;
+#endif
+         break;
+      case GL_CAPS_PBO:
+#if defined(HAVE_OPENGLES)
+         if (major >= 3)
+            return true;
+#elif !defined(HAVE_PSGL)
+         if (     (major > 2 || (major == 2 && minor >= 1))
+               || gl_query_extension("ARB_pixel_buffer_object"))
+            return true;
+#endif
+         break;
+      case GL_CAPS_MAP_BUFFER_RANGE:
+#if defined(HAVE_OPENGLES)
+         if (major >= 3)
+            return true;
+#elif !defined(HAVE_PSGL)
+         if (     (major >= 3 || gl_query_extension("ARB_map_buffer_range"))
+               && glMapBufferRange)
+            return true;
+#endif
+         break;
+      case GL_CAPS_BUFFER_STORAGE:
+#if !defined(HAVE_OPENGLES) && !defined(HAVE_PSGL)
+         /* Persistent mapping also needs ARB_map_buffer_range */
+         if (     ((major > 4 || (major == 4 && minor >= 4))
+                  || gl_query_extension("ARB_buffer_storage"))
+               && glBufferStorage && glMapBufferRange)
+            return true;
 #endif
          break;
       case GL_CAPS_NONE:
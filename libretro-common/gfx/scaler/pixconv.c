@@ -25,7 +25,9 @@
 #include <stdlib.h>
 #include <string.h>
 
+#include <boolean.h>
 #include <retro_inline.h>
+#include <libretro.h>
 
 #include <gfx/scaler/pixconv.h>
 
@@ -43,6 +45,153 @@
 #include <mmintrin.h>
 #endif
 
+/* The AVX2 kernels are compiled for their ISA through a function
+ * attribute and only used once conv_init_simd() saw AVX2 in the
+ * CPU mask. Each kernel converts as much of a line as it can in
+ * whole vectors and leaves the rest to the SSE2 and C loops. */
+#if !defined(SCALER_NO_SIMD) \
+   && (defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)) \
+   && (defined(__clang__) || (defined(__GNUC__) && __GNUC__ >= 7) || (defined(_MSC_VER) && _MSC_VER >= 1910))
+#define PIXCONV_HAVE_AVX2
+#include <immintrin.h>
+#if defined(__GNUC__) || defined(__clang__)
+#define PIXCONV_TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#define PIXCONV_TARGET_AVX2
+#endif
+#endif
+
+#if !defined(SCALER_NO_SIMD) && (defined(__ARM_NEON__) || defined(__ARM_NEON) || defined(HAVE_NEON))
+#define PIXCONV_HAVE_NEON
+#include <arm_neon.h>
+#endif
+
+#ifdef PIXCONV_HAVE_AVX2
+static bool conv_avx2_enabled = false;
+#endif
+#ifdef PIXCONV_HAVE_NEON
+static bool conv_neon_enabled = false;
+#endif
+
+void conv_init_simd(uint64_t cpu)
+{
+#ifdef PIXCONV_HAVE_AVX2
+   conv_avx2_enabled = (cpu & RETRO_SIMD_AVX2) ? true : false;
+#endif
+#ifdef PIXCONV_HAVE_NEON
+   conv_neon_enabled = (cpu & RETRO_SIMD_NEON) ? true : false;
+#endif
+}
+
+#ifdef PIXCONV_HAVE_AVX2
+/* Interleaves 16 pixels of 16-bit B, G, R and A channel
+ * values (0 - 255) into ARGB8888, pixels 0-7 go to @px0
+ * and 8-15 to @px1. */
+static PIXCONV_TARGET_AVX2 void conv_interleave_argb8888_avx2(
+      __m256i b, __m256i g, __m256i r, __m256i a,
+      __m256i *px0, __m256i *px1)
+{
+   /* Unpacking works within 128-bit lanes, so the low half
+    * ends up with pixels 0-3 and 8-11, the high half with
+    * pixels 4-7 and 12-15. */
+   __m256i lo = _mm256_or_si256(_mm256_unpacklo_epi8(b, g),
+         _mm256_slli_si256(_mm256_unpacklo_epi8(r, a), 2));
+   __m256i hi = _mm256_or_si256(_mm256_unpackhi_epi8(b, g),
+         _mm256_slli_si256(_mm256_unpackhi_epi8(r, a), 2));
+
+   *px0       = _mm256_permute2x128_si256(lo, hi, 0x20);
+   *px1       = _mm256_permute2x128_si256(lo, hi, 0x31);
+}
+
+static PIXCONV_TARGET_AVX2 void conv_store_argb8888_avx2(uint32_t *out,
+      __m256i b, __m256i g, __m256i r, __m256i a)
+{
+   __m256i px0, px1;
+   conv_interleave_argb8888_avx2(b, g, r, a, &px0, &px1);
+   _mm256_storeu_si256((__m256i*)(out + 0), px0);
+   _mm256_storeu_si256((__m256i*)(out + 8), px1);
+}
+
+/* Byte order of BGR24 in ARGB8888 and ABGR8888 pixels,
+ * for conv_store_bgr24_avx2(). */
+#define PIXCONV_SHUF_ARGB_BGR24 \
+   _mm256_setr_epi8( 0,  1,  2,  4,  5,  6,  8,  9, 10, 12, 13, 14, -1, -1, -1, -1, \
+                     0,  1,  2,  4,  5,  6,  8,  9, 10, 12, 13, 14, -1, -1, -1, -1)
+#define PIXCONV_SHUF_ABGR_BGR24 \
+   _mm256_setr_epi8( 2,  1,  0,  6,  5,  4, 10,  9,  8, 14, 13, 12, -1, -1, -1, -1, \
+                     2,  1,  0,  6,  5,  4, 10,  9,  8, 14, 13, 12, -1, -1, -1, -1)
+
+/* Stores the low three bytes of 8 pixels picked by @shuf,
+ * which has to leave the top four bytes of each lane empty. */
+static PIXCONV_TARGET_AVX2 void conv_store_bgr24_avx2(uint8_t *out,
+      __m256i pix, __m256i shuf)
+{
+   const __m256i pack = _mm256_setr_epi32(0, 1, 2, 4, 5, 6, 3, 7);
+   __m256i res        = _mm256_permutevar8x32_epi32(
+         _mm256_shuffle_epi8(pix, shuf), pack);
+
+   _mm_storeu_si128((__m128i*)out, _mm256_castsi256_si128(res));
+   _mm_storel_epi64((__m128i*)(out + 16), _mm256_extracti128_si256(res, 1));
+}
+
+/* Packs 16 pixels held in the low 16 bits of two vectors
+ * of 32-bit values. */
+static PIXCONV_TARGET_AVX2 void conv_store_16bit_avx2(uint16_t *out,
+      __m256i lo, __m256i hi)
+{
+   _mm256_storeu_si256((__m256i*)out, _mm256_permute4x64_epi64(
+            _mm256_packus_epi32(lo, hi), 0xd8));
+}
+#endif
+
+#ifdef PIXCONV_HAVE_NEON
+/* Widens 8 channels of 5 bits to 8 bits. */
+static INLINE uint8x8_t conv_expand5_neon(uint8x8_t c)
+{
+   return vorr_u8(vshl_n_u8(c, 3), vshr_n_u8(c, 2));
+}
+#endif
+
+#ifdef PIXCONV_HAVE_AVX2
+static PIXCONV_TARGET_AVX2 int conv_rgb565_0rgb1555_avx2(uint16_t *output,
+      const uint16_t *input, int width)
+{
+   int w;
+   const __m256i hi_mask = _mm256_set1_epi16(0x7fe0);
+   const __m256i lo_mask = _mm256_set1_epi16(0x1f);
+
+   for (w = 0; w + 16 <= width; w += 16)
+   {
+      const __m256i in = _mm256_loadu_si256((const __m256i*)(input + w));
+      __m256i hi       = _mm256_and_si256(_mm256_srli_epi16(in, 1), hi_mask);
+      __m256i lo       = _mm256_and_si256(in, lo_mask);
+      _mm256_storeu_si256((__m256i*)(output + w), _mm256_or_si256(hi, lo));
+   }
+
+   return w;
+}
+#endif
+
+#ifdef PIXCONV_HAVE_NEON
+static int conv_rgb565_0rgb1555_neon(uint16_t *output,
+      const uint16_t *input, int width)
+{
+   int w;
+   const uint16x8_t hi_mask = vdupq_n_u16(0x7fe0);
+   const uint16x8_t lo_mask = vdupq_n_u16(0x1f);
+
+   for (w = 0; w + 8 <= width; w += 8)
+   {
+      uint16x8_t in = vld1q_u16(input + w);
+      vst1q_u16(output + w, vorrq_u16(
+               vandq_u16(vshrq_n_u16(in, 1), hi_mask),
+               vandq_u16(in, lo_mask)));
+   }
+
+   return w;
+}
+#endif
+
 void conv_rgb565_0rgb1555(void *output_, const void *input_,
       int width, int height,
       int out_stride, int in_stride)
@@ -61,11 +210,19 @@ void conv_rgb565_0rgb1555(void *output_, const void *input_,
          h++, output += out_stride >> 1, input += in_stride >> 1)
    {
       int w = 0;
+#ifdef PIXCONV_HAVE_AVX2
+      if (conv_avx2_enabled)
+         w = conv_rgb565_0rgb1555_avx2(output, input, width);
+#endif
+#ifdef PIXCONV_HAVE_NEON
+      if (conv_neon_enabled)
+         w = conv_rgb565_0rgb1555_neon(output, input, width);
+#endif
 #if defined(__SSE2__)
       for (; w < max_width; w += 8)
       {
          const __m128i in = _mm_loadu_si128((const __m128i*)(input + w));
-         __m128i hi = _mm_and_si128(_mm_slli_epi16(in, 1), hi_mask);
+         __m128i hi = _mm_and_si128(_mm_srli_epi16(in, 1), hi_mask);
          __m128i lo = _mm_and_si128(in, lo_mask);
          _mm_storeu_si128((__m128i*)(output + w), _mm_or_si128(hi, lo));
       }
@@ -81,6 +238,52 @@ void conv_rgb565_0rgb1555(void *output_, const void *input_,
    }
 }
 
+#ifdef PIXCONV_HAVE_AVX2
+static PIXCONV_TARGET_AVX2 int conv_0rgb1555_rgb565_avx2(uint16_t *output,
+      const uint16_t *input, int width)
+{
+   int w;
+   const __m256i hi_mask   = _mm256_set1_epi16(
+         (int16_t)((0x1f << 11) | (0x1f << 6)));
+   const __m256i lo_mask   = _mm256_set1_epi16(0x1f);
+   const __m256i glow_mask = _mm256_set1_epi16(1 << 5);
+
+   for (w = 0; w + 16 <= width; w += 16)
+   {
+      const __m256i in = _mm256_loadu_si256((const __m256i*)(input + w));
+      __m256i rg       = _mm256_and_si256(_mm256_slli_epi16(in, 1), hi_mask);
+      __m256i b        = _mm256_and_si256(in, lo_mask);
+      __m256i glow     = _mm256_and_si256(_mm256_srli_epi16(in, 4), glow_mask);
+      _mm256_storeu_si256((__m256i*)(output + w),
+            _mm256_or_si256(rg, _mm256_or_si256(b, glow)));
+   }
+
+   return w;
+}
+#endif
+
+#ifdef PIXCONV_HAVE_NEON
+static int conv_0rgb1555_rgb565_neon(uint16_t *output,
+      const uint16_t *input, int width)
+{
+   int w;
+   const uint16x8_t hi_mask   = vdupq_n_u16((0x1f << 11) | (0x1f << 6));
+   const uint16x8_t lo_mask   = vdupq_n_u16(0x1f);
+   const uint16x8_t glow_mask = vdupq_n_u16(1 << 5);
+
+   for (w = 0; w + 8 <= width; w += 8)
+   {
+      uint16x8_t in   = vld1q_u16(input + w);
+      uint16x8_t rg   = vandq_u16(vshlq_n_u16(in, 1), hi_mask);
+      uint16x8_t b    = vandq_u16(in, lo_mask);
+      uint16x8_t glow = vandq_u16(vshrq_n_u16(in, 4), glow_mask);
+      vst1q_u16(output + w, vorrq_u16(rg, vorrq_u16(b, glow)));
+   }
+
+   return w;
+}
+#endif
+
 void conv_0rgb1555_rgb565(void *output_, const void *input_,
       int width, int height,
       int out_stride, int in_stride)
@@ -102,6 +305,14 @@ void conv_0rgb1555_rgb565(void *output_, const void *input_,
          h++, output += out_stride >> 1, input += in_stride >> 1)
    {
       int w = 0;
+#ifdef PIXCONV_HAVE_AVX2
+      if (conv_avx2_enabled)
+         w = conv_0rgb1555_rgb565_avx2(output, input, width);
+#endif
+#ifdef PIXCONV_HAVE_NEON
+      if (conv_neon_enabled)
+         w = conv_0rgb1555_rgb565_neon(output, input, width);
+#endif
 #if defined(__SSE2__)
       for (; w < max_width; w += 8)
       {
@@ -125,6 +336,58 @@ void conv_0rgb1555_rgb565(void *output_, const void *input_,
    }
 }
 
+#ifdef PIXCONV_HAVE_AVX2
+static PIXCONV_TARGET_AVX2 int conv_0rgb1555_argb8888_avx2(uint32_t *output,
+      const uint16_t *input, int width)
+{
+   int w;
+   const __m256i pix_mask_r  = _mm256_set1_epi16(0x1f << 10);
+   const __m256i pix_mask_gb = _mm256_set1_epi16(0x1f <<  5);
+   const __m256i mul15_mid   = _mm256_set1_epi16(0x4200);
+   const __m256i mul15_hi    = _mm256_set1_epi16(0x0210);
+   const __m256i a           = _mm256_set1_epi16(0x00ff);
+
+   for (w = 0; w + 16 <= width; w += 16)
+   {
+      const __m256i in = _mm256_loadu_si256((const __m256i*)(input + w));
+      __m256i r        = _mm256_and_si256(in, pix_mask_r);
+      __m256i g        = _mm256_and_si256(in, pix_mask_gb);
+      __m256i b        = _mm256_and_si256(_mm256_slli_epi16(in, 5), pix_mask_gb);
+
+      r                = _mm256_mulhi_epi16(r, mul15_hi);
+      g                = _mm256_mulhi_epi16(g, mul15_mid);
+      b                = _mm256_mulhi_epi16(b, mul15_mid);
+
+      conv_store_argb8888_avx2(output + w, b, g, r, a);
+   }
+
+   return w;
+}
+#endif
+
+#ifdef PIXCONV_HAVE_NEON
+static int conv_0rgb1555_argb8888_neon(uint32_t *output,
+      const uint16_t *input, int width)
+{
+   int w;
+   const uint8x8_t mask = vdup_n_u8(0x1f);
+
+   for (w = 0; w + 8 <= width; w += 8)
+   {
+      uint8x8x4_t res;
+      uint16x8_t in = vld1q_u16(input + w);
+      res.val[0]    = conv_expand5_neon(vand_u8(vmovn_u16(in), mask));
+      res.val[1]    = conv_expand5_neon(vand_u8(vshrn_n_u16(in, 5), mask));
+      res.val[2]    = conv_expand5_neon(vand_u8(
+               vmovn_u16(vshrq_n_u16(in, 10)), mask));
+      res.val[3]    = vdup_n_u8(0xff);
+      vst4_u8((uint8_t*)(output + w), res);
+   }
+
+   return w;
+}
+#endif
+
 void conv_0rgb1555_argb8888(void *output_, const void *input_,
       int width, int height,
       int out_stride, int in_stride)
@@ -147,6 +410,14 @@ void conv_0rgb1555_argb8888(void *output_, const void *input_,
          h++, output += out_stride >> 2, input += in_stride >> 1)
    {
       int w = 0;
+#ifdef PIXCONV_HAVE_AVX2
+      if (conv_avx2_enabled)
+         w = conv_0rgb1555_argb8888_avx2(output, input, width);
+#endif
+#ifdef PIXCONV_HAVE_NEON
+      if (conv_neon_enabled)
+         w = conv_0rgb1555_argb8888_neon(output, input, width);
+#endif
 #ifdef __SSE2__
       for (; w < max_width; w += 8)
       {
@@ -192,6 +463,75 @@ void conv_0rgb1555_argb8888(void *output_, const void *input_,
    }
 }
 
+#ifdef PIXCONV_HAVE_AVX2
+/* Splits 16 RGB565 pixels into 16-bit channels (0 - 255). */
+static PIXCONV_TARGET_AVX2 void conv_split_rgb565_avx2(const uint16_t *input,
+      __m256i *r, __m256i *g, __m256i *b)
+{
+   const __m256i pix_mask_r = _mm256_set1_epi16(0x1f << 10);
+   const __m256i pix_mask_g = _mm256_set1_epi16(0x3f <<  5);
+   const __m256i pix_mask_b = _mm256_set1_epi16(0x1f <<  5);
+   const __m256i mul16_r    = _mm256_set1_epi16(0x0210);
+   const __m256i mul16_g    = _mm256_set1_epi16(0x2080);
+   const __m256i mul16_b    = _mm256_set1_epi16(0x4200);
+   const __m256i in         = _mm256_loadu_si256((const __m256i*)input);
+
+   *r = _mm256_mulhi_epi16(_mm256_and_si256(
+            _mm256_srli_epi16(in, 1), pix_mask_r), mul16_r);
+   *g = _mm256_mulhi_epi16(_mm256_and_si256(in, pix_mask_g), mul16_g);
+   *b = _mm256_mulhi_epi16(_mm256_and_si256(
+            _mm256_slli_epi16(in, 5), pix_mask_b), mul16_b);
+}
+
+static PIXCONV_TARGET_AVX2 int conv_rgb565_argb8888_avx2(uint32_t *output,
+      const uint16_t *input, int width)
+{
+   int w;
+   const __m256i a = _mm256_set1_epi16(0x00ff);
+
+   for (w = 0; w + 16 <= width; w += 16)
+   {
+      __m256i r, g, b;
+      conv_split_rgb565_avx2(input + w, &r, &g, &b);
+      conv_store_argb8888_avx2(output + w, b, g, r, a);
+   }
+
+   return w;
+}
+#endif
+
+#ifdef PIXCONV_HAVE_NEON
+/* Splits 8 RGB565 pixels into 8-bit channels. */
+static INLINE void conv_split_rgb565_neon(const uint16_t *input,
+      uint8x8_t *r, uint8x8_t *g, uint8x8_t *b)
+{
+   uint16x8_t in = vld1q_u16(input);
+   uint8x8_t  r5 = vmovn_u16(vshrq_n_u16(in, 11));
+   uint8x8_t  g6 = vand_u8(vshrn_n_u16(in, 5), vdup_n_u8(0x3f));
+   uint8x8_t  b5 = vand_u8(vmovn_u16(in), vdup_n_u8(0x1f));
+
+   *r = conv_expand5_neon(r5);
+   *g = vorr_u8(vshl_n_u8(g6, 2), vshr_n_u8(g6, 4));
+   *b = conv_expand5_neon(b5);
+}
+
+static int conv_rgb565_argb8888_neon(uint32_t *output,
+      const uint16_t *input, int width)
+{
+   int w;
+
+   for (w = 0; w + 8 <= width; w += 8)
+   {
+      uint8x8x4_t res;
+      conv_split_rgb565_neon(input + w, &res.val[2], &res.val[1], &res.val[0]);
+      res.val[3] = vdup_n_u8(0xff);
+      vst4_u8((uint8_t*)(output + w), res);
+   }
+
+   return w;
+}
+#endif
+
 void conv_rgb565_argb8888(void *output_, const void *input_,
       int width, int height,
       int out_stride, int in_stride)
@@ -226,6 +566,14 @@ void conv_rgb565_argb8888(void *output_, const void *input_,
          h++, output += out_stride >> 2, input += in_stride >> 1)
    {
       int w = 0;
+#ifdef PIXCONV_HAVE_AVX2
+      if (conv_avx2_enabled)
+         w = conv_rgb565_argb8888_avx2(output, input, width);
+#endif
+#ifdef PIXCONV_HAVE_NEON
+      if (conv_neon_enabled)
+         w = conv_rgb565_argb8888_neon(output, input, width);
+#endif
 #if defined(__SSE2__)
       for (; w < max_width; w += 8)
       {
@@ -299,6 +647,42 @@ void conv_rgb565_argb8888(void *output_, const void *input_,
    }
 }
 
+#ifdef PIXCONV_HAVE_AVX2
+static PIXCONV_TARGET_AVX2 int conv_rgb565_abgr8888_avx2(uint32_t *output,
+      const uint16_t *input, int width)
+{
+   int w;
+   const __m256i a = _mm256_set1_epi16(0x00ff);
+
+   for (w = 0; w + 16 <= width; w += 16)
+   {
+      __m256i r, g, b;
+      conv_split_rgb565_avx2(input + w, &r, &g, &b);
+      conv_store_argb8888_avx2(output + w, r, g, b, a);
+   }
+
+   return w;
+}
+#endif
+
+#ifdef PIXCONV_HAVE_NEON
+static int conv_rgb565_abgr8888_neon(uint32_t *output,
+      const uint16_t *input, int width)
+{
+   int w;
+
+   for (w = 0; w + 8 <= width; w += 8)
+   {
+      uint8x8x4_t res;
+      conv_split_rgb565_neon(input + w, &res.val[0], &res.val[1], &res.val[2]);
+      res.val[3] = vdup_n_u8(0xff);
+      vst4_u8((uint8_t*)(output + w), res);
+   }
+
+   return w;
+}
+#endif
+
 void conv_rgb565_abgr8888(void *output_, const void *input_,
       int width, int height,
       int out_stride, int in_stride)
@@ -320,6 +704,14 @@ void conv_rgb565_abgr8888(void *output_, const void *input_,
          h++, output += out_stride >> 2, input += in_stride >> 1)
    {
       int w = 0;
+#ifdef PIXCONV_HAVE_AVX2
+      if (conv_avx2_enabled)
+         w = conv_rgb565_abgr8888_avx2(output, input, width);
+#endif
+#ifdef PIXCONV_HAVE_NEON
+      if (conv_neon_enabled)
+         w = conv_rgb565_abgr8888_neon(output, input, width);
+#endif
 #if defined(__SSE2__)
       for (; w < max_width; w += 8)
       {
@@ -332,10 +724,10 @@ void conv_rgb565_abgr8888(void *output_, const void *input_,
          r                = _mm_mulhi_epi16(r, mul16_r);
          g                = _mm_mulhi_epi16(g, mul16_g);
          b                = _mm_mulhi_epi16(b, mul16_b);
-         res_lo_bg        = _mm_unpacklo_epi8(b, g);
-         res_hi_bg        = _mm_unpackhi_epi8(b, g);
-         res_lo_ra        = _mm_unpacklo_epi8(r, a);
-         res_hi_ra        = _mm_unpackhi_epi8(r, a);
+         res_lo_bg        = _mm_unpacklo_epi8(r, g);
+         res_hi_bg        = _mm_unpackhi_epi8(r, g);
+         res_lo_ra        = _mm_unpacklo_epi8(b, a);
+         res_hi_ra        = _mm_unpackhi_epi8(b, a);
          res_lo           = _mm_or_si128(res_lo_bg,
                _mm_slli_si128(res_lo_ra, 2));
          res_hi           = _mm_or_si128(res_hi_bg,
@@ -358,34 +750,184 @@ void conv_rgb565_abgr8888(void *output_, const void *input_,
    }
 }
 
+#ifdef PIXCONV_HAVE_AVX2
+/* Converts 8 ARGB8888 pixels to RGBA4444 in 32-bit lanes. */
+static PIXCONV_TARGET_AVX2 __m256i conv_argb8888_rgba4444_epi32_avx2(
+      const uint32_t *input)
+{
+   const __m256i mask_r = _mm256_set1_epi32(0xf000);
+   const __m256i mask_g = _mm256_set1_epi32(0x0f00);
+   const __m256i mask_b = _mm256_set1_epi32(0x00f0);
+   const __m256i in     = _mm256_loadu_si256((const __m256i*)input);
+   __m256i r            = _mm256_and_si256(_mm256_srli_epi32(in, 8), mask_r);
+   __m256i g            = _mm256_and_si256(_mm256_srli_epi32(in, 4), mask_g);
+   __m256i b            = _mm256_and_si256(in, mask_b);
+   __m256i a            = _mm256_srli_epi32(in, 28);
+
+   return _mm256_or_si256(_mm256_or_si256(r, g), _mm256_or_si256(b, a));
+}
+
+static PIXCONV_TARGET_AVX2 int conv_argb8888_rgba4444_avx2(uint16_t *output,
+      const uint32_t *input, int width)
+{
+   int w;
+
+   for (w = 0; w + 16 <= width; w += 16)
+      conv_store_16bit_avx2(output + w,
+            conv_argb8888_rgba4444_epi32_avx2(input + w),
+            conv_argb8888_rgba4444_epi32_avx2(input + w + 8));
+
+   return w;
+}
+#endif
+
+#ifdef PIXCONV_HAVE_NEON
+static int conv_argb8888_rgba4444_neon(uint16_t *output,
+      const uint32_t *input, int width)
+{
+   int w;
+   const uint8x8_t mask = vdup_n_u8(0xf0);
+
+   for (w = 0; w + 8 <= width; w += 8)
+   {
+      uint8x8x4_t in = vld4_u8((const uint8_t*)(input + w));
+      uint16x8_t rg  = vorrq_u16(
+            vshll_n_u8(vand_u8(in.val[2], mask), 8),
+            vshll_n_u8(vand_u8(in.val[1], mask), 4));
+      uint16x8_t ba  = vmovl_u8(vorr_u8(
+               vand_u8(in.val[0], mask), vshr_n_u8(in.val[3], 4)));
+      vst1q_u16(output + w, vorrq_u16(rg, ba));
+   }
+
+   return w;
+}
+#endif
+
 void conv_argb8888_rgba4444(void *output_, const void *input_,
       int width, int height,
       int out_stride, int in_stride)
 {
-   int h, w;
+   int h;
    const uint32_t *input = (const uint32_t*)input_;
    uint16_t *output      = (uint16_t*)output_;
 
+#if defined(__SSE2__)
+   const __m128i mask_r  = _mm_set1_epi32(0xf000);
+   const __m128i mask_g  = _mm_set1_epi32(0x0f00);
+   const __m128i mask_b  = _mm_set1_epi32(0x00f0);
+
+   int max_width         = width - 7;
+#endif
+
    for (h = 0; h < height;
-         h++, output += out_stride >> 2, input += in_stride >> 1)
+         h++, output += out_stride >> 1, input += in_stride >> 2)
    {
-      for (w = 0; w < width; w++)
+      int w = 0;
+#ifdef PIXCONV_HAVE_AVX2
+      if (conv_avx2_enabled)
+         w = conv_argb8888_rgba4444_avx2(output, input, width);
+#endif
+#ifdef PIXCONV_HAVE_NEON
+      if (conv_neon_enabled)
+         w = conv_argb8888_rgba4444_neon(output, input, width);
+#endif
+#if defined(__SSE2__)
+      for (; w < max_width; w += 8)
+      {
+         __m128i res[2];
+         int i;
+
+         for (i = 0; i < 2; i++)
+         {
+            const __m128i in = _mm_loadu_si128(
+                  (const __m128i*)(input + w + i * 4));
+            __m128i r = _mm_and_si128(_mm_srli_epi32(in, 8), mask_r);
+            __m128i g = _mm_and_si128(_mm_srli_epi32(in, 4), mask_g);
+            __m128i b = _mm_and_si128(in, mask_b);
+            __m128i a = _mm_srli_epi32(in, 28);
+            res[i]    = _mm_or_si128(_mm_or_si128(r, g), _mm_or_si128(b, a));
+            /* Sign extend, so the signed pack keeps all 16 bits */
+            res[i]    = _mm_srai_epi32(_mm_slli_epi32(res[i], 16), 16);
+         }
+
+         _mm_storeu_si128((__m128i*)(output + w),
+               _mm_packs_epi32(res[0], res[1]));
+      }
+#endif
+
+      for (; w < width; w++)
       {
          uint32_t col = input[w];
-         uint32_t r   = (col >> 16) & 0xf;
-         uint32_t g   = (col >>  8) & 0xf;
-         uint32_t b   = (col) & 0xf;
-         uint32_t a   = (col >>  24) & 0xf;
-         r            = (r >> 4) | r;
-         g            = (g >> 4) | g;
-         b            = (b >> 4) | b;
-         a            = (a >> 4) | a;
+         uint32_t r   = (col >> 20) & 0xf;
+         uint32_t g   = (col >> 12) & 0xf;
+         uint32_t b   = (col >>  4) & 0xf;
+         uint32_t a   = (col >> 28) & 0xf;
 
          output[w]    = (r << 12) | (g << 8) | (b << 4) | a;
       }
    }
 }
 
+#ifdef PIXCONV_HAVE_AVX2
+static PIXCONV_TARGET_AVX2 int conv_rgba4444_argb8888_avx2(uint32_t *output,
+      const uint16_t *input, int width)
+{
+   int w;
+   const __m256i pix_mask_r   = _mm256_set1_epi16(0xf << 10);
+   const __m256i pix_mask_gba = _mm256_set1_epi16(0xf << 8);
+   const __m256i mul16_r      = _mm256_set1_epi16(0x0440);
+   const __m256i mul16_gba    = _mm256_set1_epi16(0x1100);
+
+   for (w = 0; w + 16 <= width; w += 16)
+   {
+      const __m256i in = _mm256_loadu_si256((const __m256i*)(input + w));
+      __m256i r = _mm256_and_si256(_mm256_srli_epi16(in, 2), pix_mask_r);
+      __m256i g = _mm256_and_si256(in, pix_mask_gba);
+      __m256i b = _mm256_and_si256(_mm256_slli_epi16(in, 4), pix_mask_gba);
+      __m256i a = _mm256_and_si256(_mm256_slli_epi16(in, 8), pix_mask_gba);
+
+      r         = _mm256_mulhi_epi16(r, mul16_r);
+      g         = _mm256_mulhi_epi16(g, mul16_gba);
+      b         = _mm256_mulhi_epi16(b, mul16_gba);
+      a         = _mm256_mulhi_epi16(a, mul16_gba);
+
+      conv_store_argb8888_avx2(output + w, b, g, r, a);
+   }
+
+   return w;
+}
+#endif
+
+#ifdef PIXCONV_HAVE_NEON
+static int conv_rgba4444_argb8888_neon(uint32_t *output,
+      const uint16_t *input, int width)
+{
+   int w;
+   const uint8x8_t mask = vdup_n_u8(0xf0);
+
+   for (w = 0; w + 8 <= width; w += 8)
+   {
+      uint8x8x4_t res;
+      uint16x8_t in = vld1q_u16(input + w);
+      /* High nibbles of each byte, then low nibbles */
+      uint8x8_t  rg = vshrn_n_u16(in, 8);
+      uint8x8_t  ba = vmovn_u16(in);
+      uint8x8_t  r  = vand_u8(rg, mask);
+      uint8x8_t  g  = vshl_n_u8(rg, 4);
+      uint8x8_t  b  = vand_u8(ba, mask);
+      uint8x8_t  a  = vshl_n_u8(ba, 4);
+
+      res.val[0]    = vorr_u8(b, vshr_n_u8(b, 4));
+      res.val[1]    = vorr_u8(g, vshr_n_u8(g, 4));
+      res.val[2]    = vorr_u8(r, vshr_n_u8(r, 4));
+      res.val[3]    = vorr_u8(a, vshr_n_u8(a, 4));
+      vst4_u8((uint8_t*)(output + w), res);
+   }
+
+   return w;
+}
+#endif
+
 void conv_rgba4444_argb8888(void *output_, const void *input_,
       int width, int height,
       int out_stride, int in_stride)
@@ -394,14 +936,20 @@ void conv_rgba4444_argb8888(void *output_, const void *input_,
    const uint16_t *input = (const uint16_t*)input_;
    uint32_t *output      = (uint32_t*)output_;
 
-#if defined(__MMX__)
+#if defined(__SSE2__)
+   const __m128i pix_mask_r   = _mm_set1_epi16(0xf << 10);
+   const __m128i pix_mask_gba = _mm_set1_epi16(0xf << 8);
+   const __m128i mul16_r      = _mm_set1_epi16(0x0440);
+   const __m128i mul16_gba    = _mm_set1_epi16(0x1100);
+
+   int max_width              = width - 7;
+#elif defined(__MMX__)
    const __m64 pix_mask_r = _mm_set1_pi16(0xf << 10);
    const __m64 pix_mask_g = _mm_set1_pi16(0xf << 8);
    const __m64 pix_mask_b = _mm_set1_pi16(0xf << 8);
    const __m64 mul16_r    = _mm_set1_pi16(0x0440);
    const __m64 mul16_g    = _mm_set1_pi16(0x1100);
    const __m64 mul16_b    = _mm_set1_pi16(0x1100);
-   const __m64 a          = _mm_set1_pi16(0x00ff);
 
    int max_width            = width - 3;
 #endif
@@ -410,7 +958,44 @@ void conv_rgba4444_argb8888(void *output_, const void *input_,
          h++, output += out_stride >> 2, input += in_stride >> 1)
    {
       int w = 0;
-#if defined(__MMX__)
+#ifdef PIXCONV_HAVE_AVX2
+      if (conv_avx2_enabled)
+         w = conv_rgba4444_argb8888_avx2(output, input, width);
+#endif
+#ifdef PIXCONV_HAVE_NEON
+      if (conv_neon_enabled)
+         w = conv_rgba4444_argb8888_neon(output, input, width);
+#endif
+#if defined(__SSE2__)
+      for (; w < max_width; w += 8)
+      {
+         __m128i res_lo, res_hi;
+         __m128i res_lo_bg, res_hi_bg, res_lo_ra, res_hi_ra;
+         const __m128i in = _mm_loadu_si128((const __m128i*)(input + w));
+         __m128i        r = _mm_and_si128(_mm_srli_epi16(in, 2), pix_mask_r);
+         __m128i        g = _mm_and_si128(in, pix_mask_gba);
+         __m128i        b = _mm_and_si128(_mm_slli_epi16(in, 4), pix_mask_gba);
+         __m128i        a = _mm_and_si128(_mm_slli_epi16(in, 8), pix_mask_gba);
+
+         r                = _mm_mulhi_epi16(r, mul16_r);
+         g                = _mm_mulhi_epi16(g, mul16_gba);
+         b                = _mm_mulhi_epi16(b, mul16_gba);
+         a                = _mm_mulhi_epi16(a, mul16_gba);
+
+         res_lo_bg        = _mm_unpacklo_epi8(b, g);
+         res_hi_bg        = _mm_unpackhi_epi8(b, g);
+         res_lo_ra        = _mm_unpacklo_epi8(r, a);
+         res_hi_ra        = _mm_unpackhi_epi8(r, a);
+
+         res_lo           = _mm_or_si128(res_lo_bg,
+               _mm_slli_si128(res_lo_ra, 2));
+         res_hi           = _mm_or_si128(res_hi_bg,
+               _mm_slli_si128(res_hi_ra, 2));
+
+         _mm_storeu_si128((__m128i*)(output + w + 0), res_lo);
+         _mm_storeu_si128((__m128i*)(output + w + 4), res_hi);
+      }
+#elif defined(__MMX__)
       for (; w < max_width; w += 4)
       {
          __m64 res_lo, res_hi;
@@ -419,10 +1004,12 @@ void conv_rgba4444_argb8888(void *output_, const void *input_,
          __m64          r = _mm_and_si64(_mm_srli_pi16(in, 2), pix_mask_r);
          __m64          g = _mm_and_si64(in, pix_mask_g);
          __m64          b = _mm_and_si64(_mm_slli_pi16(in, 4), pix_mask_b);
+         __m64          a = _mm_and_si64(_mm_slli_pi16(in, 8), pix_mask_b);
 
          r                = _mm_mulhi_pi16(r, mul16_r);
          g                = _mm_mulhi_pi16(g, mul16_g);
          b                = _mm_mulhi_pi16(b, mul16_b);
+         a                = _mm_mulhi_pi16(a, mul16_b);
 
          res_lo_bg        = _mm_unpacklo_pi8(b, g);
          res_hi_bg        = _mm_unpackhi_pi8(b, g);
@@ -458,18 +1045,92 @@ void conv_rgba4444_argb8888(void *output_, const void *input_,
    }
 }
 
+#ifdef PIXCONV_HAVE_AVX2
+static PIXCONV_TARGET_AVX2 int conv_rgba4444_rgb565_avx2(uint16_t *output,
+      const uint16_t *input, int width)
+{
+   int w;
+   const __m256i mask_r = _mm256_set1_epi16((int16_t)0xf000);
+   const __m256i mask_g = _mm256_set1_epi16(0x0780);
+   const __m256i mask_b = _mm256_set1_epi16(0x001e);
+
+   for (w = 0; w + 16 <= width; w += 16)
+   {
+      const __m256i in = _mm256_loadu_si256((const __m256i*)(input + w));
+      __m256i r        = _mm256_and_si256(in, mask_r);
+      __m256i g        = _mm256_and_si256(_mm256_srli_epi16(in, 1), mask_g);
+      __m256i b        = _mm256_and_si256(_mm256_srli_epi16(in, 3), mask_b);
+      _mm256_storeu_si256((__m256i*)(output + w),
+            _mm256_or_si256(r, _mm256_or_si256(g, b)));
+   }
+
+   return w;
+}
+#endif
+
+#ifdef PIXCONV_HAVE_NEON
+static int conv_rgba4444_rgb565_neon(uint16_t *output,
+      const uint16_t *input, int width)
+{
+   int w;
+   const uint16x8_t mask_r = vdupq_n_u16(0xf000);
+   const uint16x8_t mask_g = vdupq_n_u16(0x0780);
+   const uint16x8_t mask_b = vdupq_n_u16(0x001e);
+
+   for (w = 0; w + 8 <= width; w += 8)
+   {
+      uint16x8_t in = vld1q_u16(input + w);
+      uint16x8_t r  = vandq_u16(in, mask_r);
+      uint16x8_t g  = vandq_u16(vshrq_n_u16(in, 1), mask_g);
+      uint16x8_t b  = vandq_u16(vshrq_n_u16(in, 3), mask_b);
+      vst1q_u16(output + w, vorrq_u16(r, vorrq_u16(g, b)));
+   }
+
+   return w;
+}
+#endif
+
 void conv_rgba4444_rgb565(void *output_, const void *input_,
       int width, int height,
       int out_stride, int in_stride)
 {
-   int h, w;
+   int h;
    const uint16_t *input = (const uint16_t*)input_;
    uint16_t *output      = (uint16_t*)output_;
 
+#if defined(__SSE2__)
+   const __m128i mask_r  = _mm_set1_epi16((int16_t)0xf000);
+   const __m128i mask_g  = _mm_set1_epi16(0x0780);
+   const __m128i mask_b  = _mm_set1_epi16(0x001e);
+
+   int max_width         = width - 7;
+#endif
+
    for (h = 0; h < height;
          h++, output += out_stride >> 1, input += in_stride >> 1)
    {
-      for (w = 0; w < width; w++)
+      int w = 0;
+#ifdef PIXCONV_HAVE_AVX2
+      if (conv_avx2_enabled)
+         w = conv_rgba4444_rgb565_avx2(output, input, width);
+#endif
+#ifdef PIXCONV_HAVE_NEON
+      if (conv_neon_enabled)
+         w = conv_rgba4444_rgb565_neon(output, input, width);
+#endif
+#if defined(__SSE2__)
+      for (; w < max_width; w += 8)
+      {
+         const __m128i in = _mm_loadu_si128((const __m128i*)(input + w));
+         __m128i r        = _mm_and_si128(in, mask_r);
+         __m128i g        = _mm_and_si128(_mm_srli_epi16(in, 1), mask_g);
+         __m128i b        = _mm_and_si128(_mm_srli_epi16(in, 3), mask_b);
+         _mm_storeu_si128((__m128i*)(output + w),
+               _mm_or_si128(r, _mm_or_si128(g, b)));
+      }
+#endif
+
+      for (; w < width; w++)
       {
          uint32_t col = input[w];
          uint32_t r   = (col >> 12) & 0xf;
@@ -528,14 +1189,69 @@ static INLINE void store_bgr24_sse2(void *output, __m128i a,
 }
 #endif
 
-void conv_0rgb1555_bgr24(void *output_, const void *input_,
-      int width, int height,
-      int out_stride, int in_stride)
+#ifdef PIXCONV_HAVE_AVX2
+static PIXCONV_TARGET_AVX2 int conv_0rgb1555_bgr24_avx2(uint8_t *output,
+      const uint16_t *input, int width)
 {
-   int h;
-   const uint16_t *input     = (const uint16_t*)input_;
-   uint8_t *output           = (uint8_t*)output_;
-
+   int w;
+   const __m256i pix_mask_r  = _mm256_set1_epi16(0x1f << 10);
+   const __m256i pix_mask_gb = _mm256_set1_epi16(0x1f <<  5);
+   const __m256i mul15_mid   = _mm256_set1_epi16(0x4200);
+   const __m256i mul15_hi    = _mm256_set1_epi16(0x0210);
+   const __m256i a           = _mm256_setzero_si256();
+   const __m256i shuf        = PIXCONV_SHUF_ARGB_BGR24;
+
+   for (w = 0; w + 16 <= width; w += 16, output += 48)
+   {
+      __m256i px0, px1;
+      const __m256i in = _mm256_loadu_si256((const __m256i*)(input + w));
+      __m256i r        = _mm256_and_si256(in, pix_mask_r);
+      __m256i g        = _mm256_and_si256(in, pix_mask_gb);
+      __m256i b        = _mm256_and_si256(_mm256_slli_epi16(in, 5), pix_mask_gb);
+
+      r                = _mm256_mulhi_epi16(r, mul15_hi);
+      g                = _mm256_mulhi_epi16(g, mul15_mid);
+      b                = _mm256_mulhi_epi16(b, mul15_mid);
+
+      conv_interleave_argb8888_avx2(b, g, r, a, &px0, &px1);
+      conv_store_bgr24_avx2(output +  0, px0, shuf);
+      conv_store_bgr24_avx2(output + 24, px1, shuf);
+   }
+
+   return w;
+}
+#endif
+
+#ifdef PIXCONV_HAVE_NEON
+static int conv_0rgb1555_bgr24_neon(uint8_t *output,
+      const uint16_t *input, int width)
+{
+   int w;
+   const uint8x8_t mask = vdup_n_u8(0x1f);
+
+   for (w = 0; w + 8 <= width; w += 8, output += 24)
+   {
+      uint8x8x3_t res;
+      uint16x8_t in = vld1q_u16(input + w);
+      res.val[0]    = conv_expand5_neon(vand_u8(vmovn_u16(in), mask));
+      res.val[1]    = conv_expand5_neon(vand_u8(vshrn_n_u16(in, 5), mask));
+      res.val[2]    = conv_expand5_neon(vand_u8(
+               vmovn_u16(vshrq_n_u16(in, 10)), mask));
+      vst3_u8(output, res);
+   }
+
+   return w;
+}
+#endif
+
+void conv_0rgb1555_bgr24(void *output_, const void *input_,
+      int width, int height,
+      int out_stride, int in_stride)
+{
+   int h;
+   const uint16_t *input     = (const uint16_t*)input_;
+   uint8_t *output           = (uint8_t*)output_;
+
 #if defined(__SSE2__)
    const __m128i pix_mask_r  = _mm_set1_epi16(0x1f << 10);
    const __m128i pix_mask_gb = _mm_set1_epi16(0x1f <<  5);
@@ -551,6 +1267,20 @@ void conv_0rgb1555_bgr24(void *output_, const void *input_,
    {
       uint8_t *out = output;
       int   w = 0;
+#ifdef PIXCONV_HAVE_AVX2
+      if (conv_avx2_enabled)
+      {
+         w    = conv_0rgb1555_bgr24_avx2(out, input, width);
+         out += w * 3;
+      }
+#endif
+#ifdef PIXCONV_HAVE_NEON
+      if (conv_neon_enabled)
+      {
+         w    = conv_0rgb1555_bgr24_neon(out, input, width);
+         out += w * 3;
+      }
+#endif
 
 #if defined(__SSE2__)
       for (; w < max_width; w += 16, out += 48)
@@ -614,6 +1344,44 @@ void conv_0rgb1555_bgr24(void *output_, const void *input_,
    }
 }
 
+#ifdef PIXCONV_HAVE_AVX2
+static PIXCONV_TARGET_AVX2 int conv_rgb565_bgr24_avx2(uint8_t *output,
+      const uint16_t *input, int width)
+{
+   int w;
+   const __m256i a    = _mm256_setzero_si256();
+   const __m256i shuf = PIXCONV_SHUF_ARGB_BGR24;
+
+   for (w = 0; w + 16 <= width; w += 16, output += 48)
+   {
+      __m256i r, g, b, px0, px1;
+      conv_split_rgb565_avx2(input + w, &r, &g, &b);
+      conv_interleave_argb8888_avx2(b, g, r, a, &px0, &px1);
+      conv_store_bgr24_avx2(output +  0, px0, shuf);
+      conv_store_bgr24_avx2(output + 24, px1, shuf);
+   }
+
+   return w;
+}
+#endif
+
+#ifdef PIXCONV_HAVE_NEON
+static int conv_rgb565_bgr24_neon(uint8_t *output,
+      const uint16_t *input, int width)
+{
+   int w;
+
+   for (w = 0; w + 8 <= width; w += 8, output += 24)
+   {
+      uint8x8x3_t res;
+      conv_split_rgb565_neon(input + w, &res.val[2], &res.val[1], &res.val[0]);
+      vst3_u8(output, res);
+   }
+
+   return w;
+}
+#endif
+
 void conv_rgb565_bgr24(void *output_, const void *input_,
       int width, int height,
       int out_stride, int in_stride)
@@ -638,6 +1406,20 @@ void conv_rgb565_bgr24(void *output_, const void *input_,
    {
       uint8_t *out = output;
       int        w = 0;
+#ifdef PIXCONV_HAVE_AVX2
+      if (conv_avx2_enabled)
+      {
+         w    = conv_rgb565_bgr24_avx2(out, input, width);
+         out += w * 3;
+      }
+#endif
+#ifdef PIXCONV_HAVE_NEON
+      if (conv_neon_enabled)
+      {
+         w    = conv_rgb565_bgr24_neon(out, input, width);
+         out += w * 3;
+      }
+#endif
 #if defined(__SSE2__)
       for (; w < max_width; w += 16, out += 48)
       {
@@ -699,11 +1481,62 @@ void conv_rgb565_bgr24(void *output_, const void *input_,
    }
 }
 
+#ifdef PIXCONV_HAVE_AVX2
+/* Expands 8 BGR24 pixels to ARGB8888. Reads 32 bytes, which
+ * is 8 bytes more than the pixels take. */
+static PIXCONV_TARGET_AVX2 __m256i conv_load_bgr24_avx2(const uint8_t *input)
+{
+   const __m256i spread = _mm256_setr_epi32(0, 1, 2, 0, 3, 4, 5, 0);
+   const __m256i shuf   = _mm256_setr_epi8(
+         0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11, -1,
+         0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11, -1);
+   const __m256i alpha  = _mm256_set1_epi32((int)0xff000000u);
+   __m256i in           = _mm256_permutevar8x32_epi32(
+         _mm256_loadu_si256((const __m256i*)input), spread);
+
+   return _mm256_or_si256(_mm256_shuffle_epi8(in, shuf), alpha);
+}
+
+static PIXCONV_TARGET_AVX2 int conv_bgr24_argb8888_avx2(uint32_t *output,
+      const uint8_t *input, int width)
+{
+   int w;
+
+   /* Stop early enough for the overlong load of the last pixels */
+   for (w = 0; w + 11 <= width; w += 8)
+      _mm256_storeu_si256((__m256i*)(output + w),
+            conv_load_bgr24_avx2(input + w * 3));
+
+   return w;
+}
+#endif
+
+#ifdef PIXCONV_HAVE_NEON
+static int conv_bgr24_argb8888_neon(uint32_t *output,
+      const uint8_t *input, int width)
+{
+   int w;
+
+   for (w = 0; w + 16 <= width; w += 16)
+   {
+      uint8x16x4_t res;
+      uint8x16x3_t in = vld3q_u8(input + w * 3);
+      res.val[0]      = in.val[0];
+      res.val[1]      = in.val[1];
+      res.val[2]      = in.val[2];
+      res.val[3]      = vdupq_n_u8(0xff);
+      vst4q_u8((uint8_t*)(output + w), res);
+   }
+
+   return w;
+}
+#endif
+
 void conv_bgr24_argb8888(void *output_, const void *input_,
       int width, int height,
       int out_stride, int in_stride)
 {
-   int h, w;
+   int h;
    const uint8_t *input = (const uint8_t*)input_;
    uint32_t *output     = (uint32_t*)output_;
 
@@ -711,7 +1544,23 @@ void conv_bgr24_argb8888(void *output_, const void *input_,
          h++, output += out_stride >> 2, input += in_stride)
    {
       const uint8_t *inp = input;
-      for (w = 0; w < width; w++)
+      int              w = 0;
+#ifdef PIXCONV_HAVE_AVX2
+      if (conv_avx2_enabled)
+      {
+         w    = conv_bgr24_argb8888_avx2(output, inp, width);
+         inp += w * 3;
+      }
+#endif
+#ifdef PIXCONV_HAVE_NEON
+      if (conv_neon_enabled)
+      {
+         w    = conv_bgr24_argb8888_neon(output, inp, width);
+         inp += w * 3;
+      }
+#endif
+
+      for (; w < width; w++)
       {
          uint32_t b = *inp++;
          uint32_t g = *inp++;
@@ -721,18 +1570,84 @@ void conv_bgr24_argb8888(void *output_, const void *input_,
    }
 }
 
+#ifdef PIXCONV_HAVE_AVX2
+static PIXCONV_TARGET_AVX2 __m256i conv_argb8888_rgb565_epi32_avx2(
+      __m256i in)
+{
+   const __m256i mask_r = _mm256_set1_epi32(0xf800);
+   const __m256i mask_g = _mm256_set1_epi32(0x07e0);
+   const __m256i mask_b = _mm256_set1_epi32(0x001f);
+   __m256i r            = _mm256_and_si256(_mm256_srli_epi32(in, 8), mask_r);
+   __m256i g            = _mm256_and_si256(_mm256_srli_epi32(in, 5), mask_g);
+   __m256i b            = _mm256_and_si256(_mm256_srli_epi32(in, 3), mask_b);
+
+   return _mm256_or_si256(r, _mm256_or_si256(g, b));
+}
+
+static PIXCONV_TARGET_AVX2 int conv_bgr24_rgb565_avx2(uint16_t *output,
+      const uint8_t *input, int width)
+{
+   int w;
+
+   for (w = 0; w + 19 <= width; w += 16)
+      conv_store_16bit_avx2(output + w,
+            conv_argb8888_rgb565_epi32_avx2(
+               conv_load_bgr24_avx2(input + w * 3)),
+            conv_argb8888_rgb565_epi32_avx2(
+               conv_load_bgr24_avx2(input + w * 3 + 24)));
+
+   return w;
+}
+#endif
+
+#ifdef PIXCONV_HAVE_NEON
+static int conv_bgr24_rgb565_neon(uint16_t *output,
+      const uint8_t *input, int width)
+{
+   int w;
+
+   for (w = 0; w + 8 <= width; w += 8)
+   {
+      uint8x8x3_t in = vld3_u8(input + w * 3);
+      uint16x8_t r   = vshll_n_u8(vand_u8(in.val[2], vdup_n_u8(0xf8)), 8);
+      uint16x8_t g   = vshlq_n_u16(vmovl_u8(
+               vand_u8(in.val[1], vdup_n_u8(0xfc))), 3);
+      uint16x8_t b   = vmovl_u8(vshr_n_u8(in.val[0], 3));
+      vst1q_u16(output + w, vorrq_u16(r, vorrq_u16(g, b)));
+   }
+
+   return w;
+}
+#endif
+
 void conv_bgr24_rgb565(void *output_, const void *input_,
       int width, int height,
       int out_stride, int in_stride)
 {
-   int h, w;
+   int h;
    const uint8_t *input = (const uint8_t*)input_;
    uint16_t *output     = (uint16_t*)output_;
    for (h = 0; h < height;
-         h++, output += out_stride, input += in_stride)
+         h++, output += out_stride >> 1, input += in_stride)
    {
       const uint8_t *inp = input;
-      for (w = 0; w < width; w++)
+      int              w = 0;
+#ifdef PIXCONV_HAVE_AVX2
+      if (conv_avx2_enabled)
+      {
+         w    = conv_bgr24_rgb565_avx2(output, inp, width);
+         inp += w * 3;
+      }
+#endif
+#ifdef PIXCONV_HAVE_NEON
+      if (conv_neon_enabled)
+      {
+         w    = conv_bgr24_rgb565_neon(output, inp, width);
+         inp += w * 3;
+      }
+#endif
+
+      for (; w < width; w++)
       {
          uint16_t b = *inp++;
          uint16_t g = *inp++;
@@ -743,18 +1658,105 @@ void conv_bgr24_rgb565(void *output_, const void *input_,
    }
 }
 
+#ifdef PIXCONV_HAVE_AVX2
+static PIXCONV_TARGET_AVX2 __m256i conv_argb8888_0rgb1555_epi32_avx2(
+      const uint32_t *input)
+{
+   const __m256i mask_r = _mm256_set1_epi32(0x7c00);
+   const __m256i mask_g = _mm256_set1_epi32(0x03e0);
+   const __m256i mask_b = _mm256_set1_epi32(0x001f);
+   const __m256i in     = _mm256_loadu_si256((const __m256i*)input);
+   __m256i r            = _mm256_and_si256(_mm256_srli_epi32(in, 9), mask_r);
+   __m256i g            = _mm256_and_si256(_mm256_srli_epi32(in, 6), mask_g);
+   __m256i b            = _mm256_and_si256(_mm256_srli_epi32(in, 3), mask_b);
+
+   return _mm256_or_si256(r, _mm256_or_si256(g, b));
+}
+
+static PIXCONV_TARGET_AVX2 int conv_argb8888_0rgb1555_avx2(uint16_t *output,
+      const uint32_t *input, int width)
+{
+   int w;
+
+   for (w = 0; w + 16 <= width; w += 16)
+      conv_store_16bit_avx2(output + w,
+            conv_argb8888_0rgb1555_epi32_avx2(input + w),
+            conv_argb8888_0rgb1555_epi32_avx2(input + w + 8));
+
+   return w;
+}
+#endif
+
+#ifdef PIXCONV_HAVE_NEON
+static int conv_argb8888_0rgb1555_neon(uint16_t *output,
+      const uint32_t *input, int width)
+{
+   int w;
+
+   for (w = 0; w + 8 <= width; w += 8)
+   {
+      uint8x8x4_t in = vld4_u8((const uint8_t*)(input + w));
+      uint16x8_t r   = vshlq_n_u16(vmovl_u8(vshr_n_u8(in.val[2], 3)), 10);
+      uint16x8_t g   = vshlq_n_u16(vmovl_u8(vshr_n_u8(in.val[1], 3)), 5);
+      uint16x8_t b   = vmovl_u8(vshr_n_u8(in.val[0], 3));
+      vst1q_u16(output + w, vorrq_u16(r, vorrq_u16(g, b)));
+   }
+
+   return w;
+}
+#endif
+
 void conv_argb8888_0rgb1555(void *output_, const void *input_,
       int width, int height,
       int out_stride, int in_stride)
 {
-   int h, w;
+   int h;
    const uint32_t *input = (const uint32_t*)input_;
    uint16_t *output      = (uint16_t*)output_;
 
+#if defined(__SSE2__)
+   const __m128i mask_r  = _mm_set1_epi32(0x7c00);
+   const __m128i mask_g  = _mm_set1_epi32(0x03e0);
+   const __m128i mask_b  = _mm_set1_epi32(0x001f);
+
+   int max_width         = width - 7;
+#endif
+
    for (h = 0; h < height;
          h++, output += out_stride >> 1, input += in_stride >> 2)
    {
-      for (w = 0; w < width; w++)
+      int w = 0;
+#ifdef PIXCONV_HAVE_AVX2
+      if (conv_avx2_enabled)
+         w = conv_argb8888_0rgb1555_avx2(output, input, width);
+#endif
+#ifdef PIXCONV_HAVE_NEON
+      if (conv_neon_enabled)
+         w = conv_argb8888_0rgb1555_neon(output, input, width);
+#endif
+#if defined(__SSE2__)
+      for (; w < max_width; w += 8)
+      {
+         __m128i res[2];
+         int i;
+
+         for (i = 0; i < 2; i++)
+         {
+            const __m128i in = _mm_loadu_si128(
+                  (const __m128i*)(input + w + i * 4));
+            __m128i r = _mm_and_si128(_mm_srli_epi32(in, 9), mask_r);
+            __m128i g = _mm_and_si128(_mm_srli_epi32(in, 6), mask_g);
+            __m128i b = _mm_and_si128(_mm_srli_epi32(in, 3), mask_b);
+            res[i]    = _mm_or_si128(r, _mm_or_si128(g, b));
+         }
+
+         /* 15-bit values pass the signed pack unchanged */
+         _mm_storeu_si128((__m128i*)(output + w),
+               _mm_packs_epi32(res[0], res[1]));
+      }
+#endif
+
+      for (; w < width; w++)
       {
          uint32_t col = input[w];
          uint16_t r   = (col >> 19) & 0x1f;
@@ -765,6 +1767,140 @@ void conv_argb8888_0rgb1555(void *output_, const void *input_,
    }
 }
 
+#ifdef PIXCONV_HAVE_AVX2
+static PIXCONV_TARGET_AVX2 int conv_argb8888_rgb565_avx2(uint16_t *output,
+      const uint32_t *input, int width)
+{
+   int w;
+
+   for (w = 0; w + 16 <= width; w += 16)
+      conv_store_16bit_avx2(output + w,
+            conv_argb8888_rgb565_epi32_avx2(
+               _mm256_loadu_si256((const __m256i*)(input + w))),
+            conv_argb8888_rgb565_epi32_avx2(
+               _mm256_loadu_si256((const __m256i*)(input + w + 8))));
+
+   return w;
+}
+#endif
+
+#ifdef PIXCONV_HAVE_NEON
+static int conv_argb8888_rgb565_neon(uint16_t *output,
+      const uint32_t *input, int width)
+{
+   int w;
+
+   for (w = 0; w + 8 <= width; w += 8)
+   {
+      uint8x8x4_t in = vld4_u8((const uint8_t*)(input + w));
+      uint16x8_t r   = vshll_n_u8(vand_u8(in.val[2], vdup_n_u8(0xf8)), 8);
+      uint16x8_t g   = vshlq_n_u16(vmovl_u8(
+               vand_u8(in.val[1], vdup_n_u8(0xfc))), 3);
+      uint16x8_t b   = vmovl_u8(vshr_n_u8(in.val[0], 3));
+      vst1q_u16(output + w, vorrq_u16(r, vorrq_u16(g, b)));
+   }
+
+   return w;
+}
+#endif
+
+void conv_argb8888_rgb565(void *output_, const void *input_,
+      int width, int height,
+      int out_stride, int in_stride)
+{
+   int h;
+   const uint32_t *input = (const uint32_t*)input_;
+   uint16_t *output      = (uint16_t*)output_;
+
+#if defined(__SSE2__)
+   const __m128i mask_r  = _mm_set1_epi32(0xf800);
+   const __m128i mask_g  = _mm_set1_epi32(0x07e0);
+   const __m128i mask_b  = _mm_set1_epi32(0x001f);
+
+   int max_width         = width - 7;
+#endif
+
+   for (h = 0; h < height;
+         h++, output += out_stride >> 1, input += in_stride >> 2)
+   {
+      int w = 0;
+#ifdef PIXCONV_HAVE_AVX2
+      if (conv_avx2_enabled)
+         w = conv_argb8888_rgb565_avx2(output, input, width);
+#endif
+#ifdef PIXCONV_HAVE_NEON
+      if (conv_neon_enabled)
+         w = conv_argb8888_rgb565_neon(output, input, width);
+#endif
+#if defined(__SSE2__)
+      for (; w < max_width; w += 8)
+      {
+         __m128i res[2];
+         int i;
+
+         for (i = 0; i < 2; i++)
+         {
+            const __m128i in = _mm_loadu_si128(
+                  (const __m128i*)(input + w + i * 4));
+            __m128i r = _mm_and_si128(_mm_srli_epi32(in, 8), mask_r);
+            __m128i g = _mm_and_si128(_mm_srli_epi32(in, 5), mask_g);
+            __m128i b = _mm_and_si128(_mm_srli_epi32(in, 3), mask_b);
+            res[i]    = _mm_or_si128(r, _mm_or_si128(g, b));
+            /* Sign extend, so the signed pack keeps all 16 bits */
+            res[i]    = _mm_srai_epi32(_mm_slli_epi32(res[i], 16), 16);
+         }
+
+         _mm_storeu_si128((__m128i*)(output + w),
+               _mm_packs_epi32(res[0], res[1]));
+      }
+#endif
+
+      for (; w < width; w++)
+      {
+         uint32_t col = input[w];
+         uint16_t r   = (col >> 19) & 0x1f;
+         uint16_t g   = (col >> 10) & 0x3f;
+         uint16_t b   = (col >>  3) & 0x1f;
+         output[w]    = (r << 11) | (g << 5) | (b << 0);
+      }
+   }
+}
+
+#ifdef PIXCONV_HAVE_AVX2
+static PIXCONV_TARGET_AVX2 int conv_argb8888_bgr24_avx2(uint8_t *output,
+      const uint32_t *input, int width)
+{
+   int w;
+   const __m256i shuf = PIXCONV_SHUF_ARGB_BGR24;
+
+   for (w = 0; w + 8 <= width; w += 8, output += 24)
+      conv_store_bgr24_avx2(output,
+            _mm256_loadu_si256((const __m256i*)(input + w)), shuf);
+
+   return w;
+}
+#endif
+
+#ifdef PIXCONV_HAVE_NEON
+static int conv_argb8888_bgr24_neon(uint8_t *output,
+      const uint32_t *input, int width)
+{
+   int w;
+
+   for (w = 0; w + 16 <= width; w += 16, output += 48)
+   {
+      uint8x16x3_t res;
+      uint8x16x4_t in = vld4q_u8((const uint8_t*)(input + w));
+      res.val[0]      = in.val[0];
+      res.val[1]      = in.val[1];
+      res.val[2]      = in.val[2];
+      vst3q_u8(output, res);
+   }
+
+   return w;
+}
+#endif
+
 void conv_argb8888_bgr24(void *output_, const void *input_,
       int width, int height,
       int out_stride, int in_stride)
@@ -782,6 +1918,20 @@ void conv_argb8888_bgr24(void *output_, const void *input_,
    {
       uint8_t *out = output;
       int        w = 0;
+#ifdef PIXCONV_HAVE_AVX2
+      if (conv_avx2_enabled)
+      {
+         w    = conv_argb8888_bgr24_avx2(out, input, width);
+         out += w * 3;
+      }
+#endif
+#ifdef PIXCONV_HAVE_NEON
+      if (conv_neon_enabled)
+      {
+         w    = conv_argb8888_bgr24_neon(out, input, width);
+         out += w * 3;
+      }
+#endif
 #if defined(__SSE2__)
       for (; w < max_width; w += 16, out += 48)
       {
@@ -818,6 +1968,41 @@ static INLINE __m128i conv_shuffle_rb_epi32(__m128i c)
 }
 #endif
 
+#ifdef PIXCONV_HAVE_AVX2
+static PIXCONV_TARGET_AVX2 int conv_abgr8888_bgr24_avx2(uint8_t *output,
+      const uint32_t *input, int width)
+{
+   int w;
+   const __m256i shuf = PIXCONV_SHUF_ABGR_BGR24;
+
+   for (w = 0; w + 8 <= width; w += 8, output += 24)
+      conv_store_bgr24_avx2(output,
+            _mm256_loadu_si256((const __m256i*)(input + w)), shuf);
+
+   return w;
+}
+#endif
+
+#ifdef PIXCONV_HAVE_NEON
+static int conv_abgr8888_bgr24_neon(uint8_t *output,
+      const uint32_t *input, int width)
+{
+   int w;
+
+   for (w = 0; w + 16 <= width; w += 16, output += 48)
+   {
+      uint8x16x3_t res;
+      uint8x16x4_t in = vld4q_u8((const uint8_t*)(input + w));
+      res.val[0]      = in.val[2];
+      res.val[1]      = in.val[1];
+      res.val[2]      = in.val[0];
+      vst3q_u8(output, res);
+   }
+
+   return w;
+}
+#endif
+
 void conv_abgr8888_bgr24(void *output_, const void *input_,
       int width, int height,
       int out_stride, int in_stride)
@@ -835,6 +2020,20 @@ void conv_abgr8888_bgr24(void *output_, const void *input_,
    {
       uint8_t *out = output;
       int        w = 0;
+#ifdef PIXCONV_HAVE_AVX2
+      if (conv_avx2_enabled)
+      {
+         w    = conv_abgr8888_bgr24_avx2(out, input, width);
+         out += w * 3;
+      }
+#endif
+#ifdef PIXCONV_HAVE_NEON
+      if (conv_neon_enabled)
+      {
+         w    = conv_abgr8888_bgr24_neon(out, input, width);
+         out += w * 3;
+      }
+#endif
 #if defined(__SSE2__)
       for (; w < max_width; w += 16, out += 48)
       {
@@ -860,18 +2059,83 @@ void conv_abgr8888_bgr24(void *output_, const void *input_,
    }
 }
 
+#ifdef PIXCONV_HAVE_AVX2
+static PIXCONV_TARGET_AVX2 int conv_argb8888_abgr8888_avx2(uint32_t *output,
+      const uint32_t *input, int width)
+{
+   int w;
+   const __m256i shuf = _mm256_setr_epi8(
+         2, 1, 0, 3, 6, 5, 4, 7, 10, 9, 8, 11, 14, 13, 12, 15,
+         2, 1, 0, 3, 6, 5, 4, 7, 10, 9, 8, 11, 14, 13, 12, 15);
+
+   for (w = 0; w + 8 <= width; w += 8)
+      _mm256_storeu_si256((__m256i*)(output + w), _mm256_shuffle_epi8(
+               _mm256_loadu_si256((const __m256i*)(input + w)), shuf));
+
+   return w;
+}
+#endif
+
+#ifdef PIXCONV_HAVE_NEON
+static int conv_argb8888_abgr8888_neon(uint32_t *output,
+      const uint32_t *input, int width)
+{
+   int w;
+
+   for (w = 0; w + 16 <= width; w += 16)
+   {
+      uint8x16x4_t px = vld4q_u8((const uint8_t*)(input + w));
+      uint8x16_t    b = px.val[0];
+      px.val[0]       = px.val[2];
+      px.val[2]       = b;
+      vst4q_u8((uint8_t*)(output + w), px);
+   }
+
+   return w;
+}
+#endif
+
 void conv_argb8888_abgr8888(void *output_, const void *input_,
       int width, int height,
       int out_stride, int in_stride)
 {
-   int h, w;
+   int h;
    const uint32_t *input = (const uint32_t*)input_;
    uint32_t *output      = (uint32_t*)output_;
 
+#if defined(__SSE2__)
+   const __m128i b_mask  = _mm_set1_epi32(0x000000ff);
+   const __m128i ga_mask = _mm_set1_epi32((int)0xff00ff00u);
+   const __m128i r_mask  = _mm_set1_epi32(0x00ff0000);
+
+   int max_width         = width - 3;
+#endif
+
    for (h = 0; h < height;
          h++, output += out_stride >> 2, input += in_stride >> 2)
    {
-      for (w = 0; w < width; w++)
+      int w = 0;
+#ifdef PIXCONV_HAVE_AVX2
+      if (conv_avx2_enabled)
+         w = conv_argb8888_abgr8888_avx2(output, input, width);
+#endif
+#ifdef PIXCONV_HAVE_NEON
+      if (conv_neon_enabled)
+         w = conv_argb8888_abgr8888_neon(output, input, width);
+#endif
+#if defined(__SSE2__)
+      for (; w < max_width; w += 4)
+      {
+         const __m128i in = _mm_loadu_si128((const __m128i*)(input + w));
+         __m128i sl       = _mm_and_si128(_mm_slli_epi32(in, 16), r_mask);
+         __m128i sr       = _mm_and_si128(_mm_srli_epi32(in, 16), b_mask);
+         __m128i ga       = _mm_and_si128(in, ga_mask);
+         _mm_storeu_si128((__m128i*)(output + w),
+               _mm_or_si128(ga, _mm_or_si128(sl, sr)));
+      }
+#endif
+
+      for (; w < width; w++)
       {
          uint32_t col = input[w];
          output[w]    = ((col << 16) & 0xff0000) |
@@ -888,6 +2152,141 @@ void conv_argb8888_abgr8888(void *output_, const void *input_,
 #define YUV_MAT_V_R (90)
 #define YUV_MAT_V_G (-46)
 
+#ifdef PIXCONV_HAVE_AVX2
+/* Same steps as the SSE2 loop below, on 32 pixels at a time. */
+static PIXCONV_TARGET_AVX2 int conv_yuyv_argb8888_avx2(uint32_t *dst,
+      const uint8_t *src, int width)
+{
+   int w;
+   const __m256i mask_y        = _mm256_set1_epi16(0xff);
+   const __m256i mask_u        = _mm256_set1_epi32(0xff << 8);
+   const __m256i mask_v        = _mm256_set1_epi32((int)(0xffu << 24));
+   const __m256i chroma_offset = _mm256_set1_epi16(128);
+   const __m256i round_offset  = _mm256_set1_epi16(YUV_OFFSET);
+
+   const __m256i yuv_mul       = _mm256_set1_epi16(YUV_MAT_Y);
+   const __m256i u_g_mul       = _mm256_set1_epi16(YUV_MAT_U_G);
+   const __m256i u_b_mul       = _mm256_set1_epi16(YUV_MAT_U_B);
+   const __m256i v_r_mul       = _mm256_set1_epi16(YUV_MAT_V_R);
+   const __m256i v_g_mul       = _mm256_set1_epi16(YUV_MAT_V_G);
+   const __m256i a             = _mm256_set1_epi8(-1);
+
+   for (w = 0; w + 32 <= width; w += 32, src += 64, dst += 32)
+   {
+      __m256i u, v, u0, u1, v0, v1, r0, g0, b0, r1, g1, b1;
+      __m256i res_lo_bg, res_hi_bg, res_lo_ra, res_hi_ra;
+      __m256i res0, res1, res2, res3;
+      /* Lanes hold pixels 0-7, 8-15 and 16-23, 24-31 */
+      __m256i yuv0 = _mm256_loadu_si256((const __m256i*)(src +  0));
+      __m256i yuv1 = _mm256_loadu_si256((const __m256i*)(src + 32));
+      __m256i _y0  = _mm256_and_si256(yuv0, mask_y);
+      __m256i _y1  = _mm256_and_si256(yuv1, mask_y);
+
+      u0  = _mm256_srli_si256(_mm256_and_si256(yuv0, mask_u), 1);
+      v0  = _mm256_srli_si256(_mm256_and_si256(yuv0, mask_v), 3);
+      u1  = _mm256_srli_si256(_mm256_and_si256(yuv1, mask_u), 1);
+      v1  = _mm256_srli_si256(_mm256_and_si256(yuv1, mask_v), 3);
+      u   = _mm256_sub_epi16(_mm256_packs_epi32(u0, u1), chroma_offset);
+      v   = _mm256_sub_epi16(_mm256_packs_epi32(v0, v1), chroma_offset);
+
+      /* The packs interleave the lanes of both loads, so the
+       * low unpacks line up with _y0 and the high ones with _y1. */
+      u0  = _mm256_unpacklo_epi16(u, u);
+      u1  = _mm256_unpackhi_epi16(u, u);
+      v0  = _mm256_unpacklo_epi16(v, v);
+      v1  = _mm256_unpackhi_epi16(v, v);
+
+      _y0 = _mm256_mullo_epi16(_y0, yuv_mul);
+      _y1 = _mm256_mullo_epi16(_y1, yuv_mul);
+
+      r0  = _mm256_srai_epi16(_mm256_adds_epi16(_mm256_adds_epi16(_y0,
+                  _mm256_mullo_epi16(v0, v_r_mul)), round_offset), YUV_SHIFT);
+      g0  = _mm256_srai_epi16(_mm256_adds_epi16(_mm256_adds_epi16(
+                  _mm256_adds_epi16(_y0, _mm256_mullo_epi16(v0, v_g_mul)),
+                  _mm256_mullo_epi16(u0, u_g_mul)), round_offset), YUV_SHIFT);
+      b0  = _mm256_srai_epi16(_mm256_adds_epi16(_mm256_adds_epi16(_y0,
+                  _mm256_mullo_epi16(u0, u_b_mul)), round_offset), YUV_SHIFT);
+
+      r1  = _mm256_srai_epi16(_mm256_adds_epi16(_mm256_adds_epi16(_y1,
+                  _mm256_mullo_epi16(v1, v_r_mul)), round_offset), YUV_SHIFT);
+      g1  = _mm256_srai_epi16(_mm256_adds_epi16(_mm256_adds_epi16(
+                  _mm256_adds_epi16(_y1, _mm256_mullo_epi16(v1, v_g_mul)),
+                  _mm256_mullo_epi16(u1, u_g_mul)), round_offset), YUV_SHIFT);
+      b1  = _mm256_srai_epi16(_mm256_adds_epi16(_mm256_adds_epi16(_y1,
+                  _mm256_mullo_epi16(u1, u_b_mul)), round_offset), YUV_SHIFT);
+
+      r0  = _mm256_packus_epi16(r0, r1);
+      g0  = _mm256_packus_epi16(g0, g1);
+      b0  = _mm256_packus_epi16(b0, b1);
+
+      res_lo_bg = _mm256_unpacklo_epi8(b0, g0);
+      res_hi_bg = _mm256_unpackhi_epi8(b0, g0);
+      res_lo_ra = _mm256_unpacklo_epi8(r0, a);
+      res_hi_ra = _mm256_unpackhi_epi8(r0, a);
+      res0      = _mm256_unpacklo_epi16(res_lo_bg, res_lo_ra);
+      res1      = _mm256_unpackhi_epi16(res_lo_bg, res_lo_ra);
+      res2      = _mm256_unpacklo_epi16(res_hi_bg, res_hi_ra);
+      res3      = _mm256_unpackhi_epi16(res_hi_bg, res_hi_ra);
+
+      _mm256_storeu_si256((__m256i*)(dst +  0),
+            _mm256_permute2x128_si256(res0, res1, 0x20));
+      _mm256_storeu_si256((__m256i*)(dst +  8),
+            _mm256_permute2x128_si256(res0, res1, 0x31));
+      _mm256_storeu_si256((__m256i*)(dst + 16),
+            _mm256_permute2x128_si256(res2, res3, 0x20));
+      _mm256_storeu_si256((__m256i*)(dst + 24),
+            _mm256_permute2x128_si256(res2, res3, 0x31));
+   }
+
+   return w;
+}
+#endif
+
+#ifdef PIXCONV_HAVE_NEON
+static int conv_yuyv_argb8888_neon(uint32_t *dst,
+      const uint8_t *src, int width)
+{
+   int w;
+
+   for (w = 0; w + 16 <= width; w += 16, src += 32, dst += 16)
+   {
+      uint8x8x2_t r, g, b;
+      uint8x8x4_t res;
+      /* Even pixels, U, odd pixels, V */
+      uint8x8x4_t yuv = vld4_u8(src);
+      int16x8_t u     = vreinterpretq_s16_u16(
+            vsubl_u8(yuv.val[1], vdup_n_u8(128)));
+      int16x8_t v     = vreinterpretq_s16_u16(
+            vsubl_u8(yuv.val[3], vdup_n_u8(128)));
+      int16x8_t _y0   = vreinterpretq_s16_u16(vshll_n_u8(yuv.val[0], 6));
+      int16x8_t _y1   = vreinterpretq_s16_u16(vshll_n_u8(yuv.val[2], 6));
+      int16x8_t cr    = vmulq_n_s16(v, YUV_MAT_V_R);
+      int16x8_t cg    = vmlaq_n_s16(vmulq_n_s16(u, YUV_MAT_U_G), v, YUV_MAT_V_G);
+      int16x8_t cb    = vmulq_n_s16(u, YUV_MAT_U_B);
+
+      /* Rounding shift and clamp to 0 - 255 in one go */
+      r = vzip_u8(vqrshrun_n_s16(vaddq_s16(_y0, cr), YUV_SHIFT),
+                  vqrshrun_n_s16(vaddq_s16(_y1, cr), YUV_SHIFT));
+      g = vzip_u8(vqrshrun_n_s16(vaddq_s16(_y0, cg), YUV_SHIFT),
+                  vqrshrun_n_s16(vaddq_s16(_y1, cg), YUV_SHIFT));
+      b = vzip_u8(vqrshrun_n_s16(vaddq_s16(_y0, cb), YUV_SHIFT),
+                  vqrshrun_n_s16(vaddq_s16(_y1, cb), YUV_SHIFT));
+
+      res.val[3] = vdup_n_u8(0xff);
+      res.val[0] = b.val[0];
+      res.val[1] = g.val[0];
+      res.val[2] = r.val[0];
+      vst4_u8((uint8_t*)(dst + 0), res);
+      res.val[0] = b.val[1];
+      res.val[1] = g.val[1];
+      res.val[2] = r.val[1];
+      vst4_u8((uint8_t*)(dst + 8), res);
+   }
+
+   return w;
+}
+#endif
+
 void conv_yuyv_argb8888(void *output_, const void *input_,
       int width, int height,
       int out_stride, int in_stride)
@@ -917,6 +2316,22 @@ void conv_yuyv_argb8888(void *output_, const void *input_,
       const uint8_t *src = input;
       uint32_t      *dst = output;
       int              w = 0;
+#ifdef PIXCONV_HAVE_AVX2
+      if (conv_avx2_enabled)
+      {
+         w    = conv_yuyv_argb8888_avx2(dst, src, width);
+         src += w * 2;
+         dst += w;
+      }
+#endif
+#ifdef PIXCONV_HAVE_NEON
+      if (conv_neon_enabled)
+      {
+         w    = conv_yuyv_argb8888_neon(dst, src, width);
+         src += w * 2;
+         dst += w;
+      }
+#endif
 
 #if defined(__SSE2__)
       /* Each loop processes 16 pixels. */
@@ -29,6 +29,196 @@
 #include <gfx/scaler/scaler_int.h>
 #include <gfx/scaler/filter.h>
 #include <gfx/scaler/pixconv.h>
+#include <retro_miscellaneous.h>
+
+#ifdef HAVE_THREADS
+#include <rthreads/tpool.h>
+#endif
+
+/* Bands are at least this many rows high, the
+ * workers cost more than they save on smaller ones. */
+#define SCALER_BAND_ROWS_MIN 16
+
+/* Rows @first to @last - 1 of a frame being scaled */
+struct scaler_band
+{
+   struct scaler_ctx *ctx;
+   void *output;
+   const void *input;
+   int first;
+   int last;
+};
+
+struct scaler_pool
+{
+#ifdef HAVE_THREADS
+   tpool_t *tpool;
+#endif
+   struct scaler_band *bands;
+   unsigned num_bands;
+};
+
+static void scaler_pool_free(struct scaler_pool *pool)
+{
+#ifdef HAVE_THREADS
+   if (pool->tpool)
+      tpool_destroy(pool->tpool);
+#endif
+   free(pool->bands);
+   free(pool);
+}
+
+static struct scaler_pool *scaler_pool_new(unsigned threads)
+{
+#ifdef HAVE_THREADS
+   struct scaler_pool *pool = (struct scaler_pool*)
+      calloc(1, sizeof(*pool));
+
+   if (!pool)
+      return NULL;
+
+   pool->num_bands = threads;
+   pool->bands     = (struct scaler_band*)
+      calloc(threads, sizeof(*pool->bands));
+
+   /* The caller takes the first band, the workers the others */
+   if (!pool->bands || !(pool->tpool = tpool_create(threads - 1)))
+   {
+      scaler_pool_free(pool);
+      return NULL;
+   }
+
+   return pool;
+#else
+   return NULL;
+#endif
+}
+
+/* Splits @rows rows into bands and calls @func on each,
+ * on the workers of @ctx if it has any. Returns once
+ * all bands are done. */
+static void scaler_run_bands(struct scaler_ctx *ctx,
+      void (*func)(void*), void *output, const void *input, int rows)
+{
+   struct scaler_band band;
+#ifdef HAVE_THREADS
+   struct scaler_pool *pool = ctx->pool;
+
+   if (pool && rows >= 2 * SCALER_BAND_ROWS_MIN)
+   {
+      unsigned i;
+      unsigned num_bands = MIN(pool->num_bands,
+            (unsigned)rows / SCALER_BAND_ROWS_MIN);
+      int band_rows      = (rows + num_bands - 1) / num_bands;
+
+      for (i = 0; i < num_bands; i++)
+      {
+         struct scaler_band *b = &pool->bands[i];
+         b->ctx                = ctx;
+         b->output             = output;
+         b->input              = input;
+         b->first              = MIN(rows, (int)i * band_rows);
+         b->last               = MIN(rows, b->first + band_rows);
+      }
+
+      for (i = 1; i < num_bands; i++)
+         if (!tpool_add_work(pool->tpool, func, &pool->bands[i]))
+            func(&pool->bands[i]);
+
+      func(&pool->bands[0]);
+      tpool_wait(pool->tpool);
+      return;
+   }
+#endif
+
+   band.ctx    = ctx;
+   band.output = output;
+   band.input  = input;
+   band.first  = 0;
+   band.last   = rows;
+   func(&band);
+}
+
+/* Converts input rows to ARGB8888 and, unless the filter
+ * has a special path, scales them horizontally. */
+static void scaler_band_input(void *data)
+{
+   struct scaler_band *band = (struct scaler_band*)data;
+   struct scaler_ctx *ctx   = band->ctx;
+   const void *input_frame  = band->input;
+   int input_stride         = ctx->in_stride;
+
+   if (ctx->in_fmt != SCALER_FMT_ARGB8888)
+   {
+      ctx->in_pixconv(
+            (uint8_t*)ctx->input.frame + band->first * ctx->input.stride,
+            (const uint8_t*)band->input + band->first * ctx->in_stride,
+            ctx->in_width, band->last - band->first,
+            ctx->input.stride, ctx->in_stride);
+
+      input_frame       = ctx->input.frame;
+      input_stride      = ctx->input.stride;
+   }
+
+   if (!ctx->scaler_special && ctx->scaler_horiz)
+      ctx->scaler_horiz(ctx, input_frame, input_stride,
+            band->first, band->last);
+}
+
+/* Scales output rows vertically, or through the special
+ * path, and converts them to the output format. */
+static void scaler_band_output(void *data)
+{
+   struct scaler_band *band = (struct scaler_band*)data;
+   struct scaler_ctx *ctx   = band->ctx;
+   const void *input_frame  = band->input;
+   void *output_frame       = band->output;
+   int input_stride         = ctx->in_stride;
+   int output_stride        = ctx->out_stride;
+
+   if (ctx->in_fmt != SCALER_FMT_ARGB8888)
+   {
+      input_frame   = ctx->input.frame;
+      input_stride  = ctx->input.stride;
+   }
+
+   if (ctx->out_fmt != SCALER_FMT_ARGB8888)
+   {
+      output_frame  = ctx->output.frame;
+      output_stride = ctx->output.stride;
+   }
+
+   /* Take some special, and (hopefully) more optimized path. */
+   if (ctx->scaler_special)
+      ctx->scaler_special(ctx, output_frame, input_frame,
+            ctx->out_width, ctx->out_height,
+            ctx->in_width, ctx->in_height,
+            output_stride, input_stride,
+            band->first, band->last);
+   /* Take generic filter path. */
+   else if (ctx->scaler_vert)
+      ctx->scaler_vert(ctx, output_frame, output_stride,
+            band->first, band->last);
+
+   if (ctx->out_fmt != SCALER_FMT_ARGB8888)
+      ctx->out_pixconv(
+            (uint8_t*)band->output + band->first * ctx->out_stride,
+            (const uint8_t*)ctx->output.frame + band->first * ctx->output.stride,
+            ctx->out_width, band->last - band->first,
+            ctx->out_stride, ctx->output.stride);
+}
+
+static void scaler_band_direct(void *data)
+{
+   struct scaler_band *band = (struct scaler_band*)data;
+   struct scaler_ctx *ctx   = band->ctx;
+
+   ctx->direct_pixconv(
+         (uint8_t*)band->output + band->first * ctx->out_stride,
+         (const uint8_t*)band->input + band->first * ctx->in_stride,
+         ctx->out_width, band->last - band->first,
+         ctx->out_stride, ctx->in_stride);
+}
 
 static bool allocate_frames(struct scaler_ctx *ctx)
 {
@@ -84,6 +274,9 @@ bool scaler_ctx_gen_filter(struct scaler_ctx *ctx)
    if (!allocate_frames(ctx))
       return false;
 
+   if (ctx->threads > 1)
+      ctx->pool = scaler_pool_new(ctx->threads);
+
    if (     ctx->in_width  == ctx->out_width
          && ctx->in_height == ctx->out_height)
    {
@@ -282,6 +475,8 @@ void scaler_ctx_gen_reset(struct scaler_ctx *ctx)
       free(ctx->input.frame);
    if (ctx->output.frame)
       free(ctx->output.frame);
+   if (ctx->pool)
+      scaler_pool_free(ctx->pool);
 
    ctx->horiz.filter        = NULL;
    ctx->horiz.filter_len    = 0;
@@ -303,6 +498,8 @@ void scaler_ctx_gen_reset(struct scaler_ctx *ctx)
 
    ctx->output.frame        = NULL;
    ctx->output.stride       = 0;
+
+   ctx->pool                = NULL;
 }
 
 /**
@@ -316,44 +513,19 @@ void scaler_ctx_gen_reset(struct scaler_ctx *ctx)
 void scaler_ctx_scale(struct scaler_ctx *ctx,
       void *output, const void *input)
 {
-   const void *input_frame = input;
-   void *output_frame      = output;
-   int input_stride        = ctx->in_stride;
-   int output_stride       = ctx->out_stride;
-
-   if (ctx->in_fmt != SCALER_FMT_ARGB8888)
+   if (ctx->unscaled)
    {
-      ctx->in_pixconv(ctx->input.frame, input,
-            ctx->in_width, ctx->in_height,
-            ctx->input.stride, ctx->in_stride);
-
-      input_frame       = ctx->input.frame;
-      input_stride      = ctx->input.stride;
-   }
-
-   if (ctx->out_fmt != SCALER_FMT_ARGB8888)
-   {
-      output_frame  = ctx->output.frame;
-      output_stride = ctx->output.stride;
-   }
-
-   /* Take some special, and (hopefully) more optimized path. */
-   if (ctx->scaler_special)
-      ctx->scaler_special(ctx, output_frame, input_frame,
-            ctx->out_width, ctx->out_height,
-            ctx->in_width, ctx->in_height,
-            output_stride, input_stride);
-   else
-   {
-      /* Take generic filter path. */
-      if (ctx->scaler_horiz)
-         ctx->scaler_horiz(ctx, input_frame, input_stride);
-      if (ctx->scaler_vert)
-         ctx->scaler_vert (ctx, output, output_stride);
+      scaler_run_bands(ctx, scaler_band_direct,
+            output, input, ctx->out_height);
+      return;
    }
 
-   if (ctx->out_fmt != SCALER_FMT_ARGB8888)
-      ctx->out_pixconv(output, ctx->output.frame,
-            ctx->out_width, ctx->out_height,
-            ctx->out_stride, ctx->output.stride);
+   /* The vertical filter of one band reads the rows the
+    * horizontal filter of other bands wrote, so all
+    * of those have to be done first. */
+   if (!ctx->scaler_special || ctx->in_fmt != SCALER_FMT_ARGB8888)
+      scaler_run_bands(ctx, scaler_band_input,
+            output, input, ctx->in_height);
+   scaler_run_bands(ctx, scaler_band_output,
+         output, input, ctx->out_height);
 }
@@ -21,8 +21,10 @@
  */
 
 #include <gfx/scaler/scaler_int.h>
+#include <gfx/scaler/pixconv.h>
 
 #include <retro_inline.h>
+#include <libretro.h>
 
 #ifdef SCALER_NO_SIMD
 #undef __SSE2__
@@ -35,6 +37,48 @@
 #endif
 #endif
 
+/* Same as in pixconv.c: the AVX2 kernels are built for their ISA
+ * through a function attribute and only used once
+ * scaler_init_simd() saw AVX2 in the CPU mask. */
+#if !defined(SCALER_NO_SIMD) \
+   && (defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)) \
+   && (defined(__clang__) || (defined(__GNUC__) && __GNUC__ >= 7) || (defined(_MSC_VER) && _MSC_VER >= 1910))
+#define SCALER_HAVE_AVX2
+#include <immintrin.h>
+#if defined(__GNUC__) || defined(__clang__)
+#define SCALER_TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#define SCALER_TARGET_AVX2
+#endif
+#endif
+
+#if !defined(SCALER_NO_SIMD) && (defined(__ARM_NEON__) || defined(__ARM_NEON) || defined(HAVE_NEON))
+#define SCALER_HAVE_NEON
+#include <arm_neon.h>
+#endif
+
+/* Copies a filter tap into 4 16-bit channels. Going through
+ * uint16_t keeps negative taps from borrowing across channels. */
+#define SCALER_SPREAD_COEFF(c) ((long long)((uint16_t)(c) * 0x0001000100010001ull))
+
+#ifdef SCALER_HAVE_AVX2
+static bool scaler_avx2_enabled = false;
+#endif
+#ifdef SCALER_HAVE_NEON
+static bool scaler_neon_enabled = false;
+#endif
+
+void scaler_init_simd(uint64_t cpu)
+{
+#ifdef SCALER_HAVE_AVX2
+   scaler_avx2_enabled = (cpu & RETRO_SIMD_AVX2) ? true : false;
+#endif
+#ifdef SCALER_HAVE_NEON
+   scaler_neon_enabled = (cpu & RETRO_SIMD_NEON) ? true : false;
+#endif
+   conv_init_simd(cpu);
+}
+
 /* ARGB8888 scaler is split in two:
  *
  * First, horizontal scaler is applied.
@@ -60,23 +104,236 @@
  *
  * The C version of scalers perform the exact same operations as the
  * SIMD code for testing purposes.
+ *
+ * The AVX2 and NEON kernels do the same mulhi steps, but on
+ * several pixels (vertical) or taps (horizontal) at once, and
+ * leave whatever is left of a line to the loops below. The taps
+ * are summed in another order, which gives the same result as
+ * the sums never come close to saturating.
  */
 
-void scaler_argb8888_vert(const struct scaler_ctx *ctx, void *output_, int stride)
+#ifdef SCALER_HAVE_AVX2
+/* Filters 8 pixels of a line at a time, each 256-bit
+ * register holds 4 of them. The intermediate frame is
+ * padded to 8 pixels, so this never reads past a line. */
+static SCALER_TARGET_AVX2 int scaler_argb8888_vert_avx2(
+      const struct scaler_ctx *ctx, const uint64_t *input,
+      uint32_t *output, const int16_t *filter_vert)
+{
+   int w, y;
+   const int in_stride = ctx->scaled.stride >> 3;
+
+   for (w = 0; w + 8 <= ctx->out_width; w += 8)
+   {
+      const uint64_t *input_base_y = input + w;
+      __m256i res_lo               = _mm256_setzero_si256();
+      __m256i res_hi               = _mm256_setzero_si256();
+
+      for (y = 0; y < ctx->vert.filter_len; y++,
+            input_base_y += in_stride)
+      {
+         __m256i coeff = _mm256_set1_epi16(filter_vert[y]);
+         __m256i col_lo = _mm256_loadu_si256((const __m256i*)input_base_y);
+         __m256i col_hi = _mm256_loadu_si256((const __m256i*)(input_base_y + 4));
+
+         res_lo        = _mm256_adds_epi16(_mm256_mulhi_epi16(col_lo, coeff), res_lo);
+         res_hi        = _mm256_adds_epi16(_mm256_mulhi_epi16(col_hi, coeff), res_hi);
+      }
+
+      res_lo = _mm256_srai_epi16(res_lo, (7 - 2 - 2));
+      res_hi = _mm256_srai_epi16(res_hi, (7 - 2 - 2));
+
+      /* Packing works within 128-bit lanes, giving
+       * pixels 0, 1, 4, 5, 2, 3, 6, 7 */
+      _mm256_storeu_si256((__m256i*)(output + w),
+            _mm256_permute4x64_epi64(
+               _mm256_packus_epi16(res_lo, res_hi), 0xd8));
+   }
+
+   return w;
+}
+
+/* Horizontal filters with 4, 8, 16... taps go 4 taps at a time
+ * for one pixel. Bilinear goes 2 taps at a time for 2 pixels in
+ * one register. Returns 0 for other filters. */
+static SCALER_TARGET_AVX2 int scaler_argb8888_horiz_avx2(
+      const struct scaler_ctx *ctx, const uint32_t *input,
+      uint64_t *output)
+{
+   int w, x;
+   const int16_t *filter_horiz = ctx->horiz.filter;
+   /* Spreads 4 coefficients from the low 64 bits of each
+    * lane across 4 channels each, 0 and 1 to the low lane
+    * and 2 and 3 to the high one */
+   const __m256i spread        = _mm256_setr_epi8(
+         0, 1, 0, 1, 0, 1, 0, 1, 2, 3, 2, 3, 2, 3, 2, 3,
+         4, 5, 4, 5, 4, 5, 4, 5, 6, 7, 6, 7, 6, 7, 6, 7);
+
+   if ((ctx->horiz.filter_len & 3) == 0)
+   {
+      for (w = 0; w < ctx->scaled.width; w++,
+            filter_horiz += ctx->horiz.filter_stride)
+      {
+         const uint32_t *input_base_x = input + ctx->horiz.filter_pos[w];
+         __m256i res                  = _mm256_setzero_si256();
+         __m128i sum;
+
+         for (x = 0; x < ctx->horiz.filter_len; x += 4)
+         {
+            __m256i coeff = _mm256_shuffle_epi8(_mm256_broadcastq_epi64(
+                     _mm_loadl_epi64((const __m128i*)(filter_horiz + x))), spread);
+            __m256i col   = _mm256_cvtepu8_epi16(
+                  _mm_loadu_si128((const __m128i*)(input_base_x + x)));
+
+            col           = _mm256_slli_epi16(col, 7);
+            res           = _mm256_adds_epi16(_mm256_mulhi_epi16(col, coeff), res);
+         }
+
+         sum = _mm_adds_epi16(_mm256_castsi256_si128(res),
+               _mm256_extracti128_si256(res, 1));
+         sum = _mm_adds_epi16(_mm_srli_si128(sum, 8), sum);
+         _mm_storel_epi64((__m128i*)(output + w), sum);
+      }
+
+      return w;
+   }
+
+   if (ctx->horiz.filter_len != 2 || ctx->horiz.filter_stride != 2)
+      return 0;
+
+   for (w = 0; w + 4 <= ctx->scaled.width; w += 4, filter_horiz += 8)
+   {
+      const int *pos = ctx->horiz.filter_pos + w;
+      /* Both taps of pixels w and w + 1, and of w + 2 and w + 3 */
+      __m256i col0   = _mm256_cvtepu8_epi16(_mm_unpacklo_epi64(
+               _mm_loadl_epi64((const __m128i*)(input + pos[0])),
+               _mm_loadl_epi64((const __m128i*)(input + pos[1]))));
+      __m256i col1   = _mm256_cvtepu8_epi16(_mm_unpacklo_epi64(
+               _mm_loadl_epi64((const __m128i*)(input + pos[2])),
+               _mm_loadl_epi64((const __m128i*)(input + pos[3]))));
+      __m256i coeff0 = _mm256_shuffle_epi8(_mm256_broadcastq_epi64(
+               _mm_loadl_epi64((const __m128i*)filter_horiz)), spread);
+      __m256i coeff1 = _mm256_shuffle_epi8(_mm256_broadcastq_epi64(
+               _mm_loadl_epi64((const __m128i*)(filter_horiz + 4))), spread);
+      __m256i res0   = _mm256_mulhi_epi16(_mm256_slli_epi16(col0, 7), coeff0);
+      __m256i res1   = _mm256_mulhi_epi16(_mm256_slli_epi16(col1, 7), coeff1);
+
+      res0           = _mm256_adds_epi16(_mm256_srli_si256(res0, 8), res0);
+      res1           = _mm256_adds_epi16(_mm256_srli_si256(res1, 8), res1);
+
+      /* Pixels w, w + 2 in the low lane, w + 1, w + 3 in the high one */
+      _mm256_storeu_si256((__m256i*)(output + w),
+            _mm256_permute4x64_epi64(
+               _mm256_unpacklo_epi64(res0, res1), 0xd8));
+   }
+
+   return w;
+}
+#endif
+
+#ifdef SCALER_HAVE_NEON
+/* (a * b) >> 16 like _mm_mulhi_epi16(), vqdmulh gives
+ * (2 * a * b) >> 16, which never saturates here. */
+#define SCALER_MULHI_NEON(a, b) vshrq_n_s16(vqdmulhq_s16(a, b), 1)
+
+static int scaler_argb8888_vert_neon(
+      const struct scaler_ctx *ctx, const uint64_t *input,
+      uint32_t *output, const int16_t *filter_vert)
+{
+   int w, y;
+   const int in_stride = ctx->scaled.stride >> 1;
+
+   for (w = 0; w + 4 <= ctx->out_width; w += 4)
+   {
+      const int16_t *input_base_y = (const int16_t*)(input + w);
+      int16x8_t res_lo            = vdupq_n_s16(0);
+      int16x8_t res_hi            = vdupq_n_s16(0);
+
+      for (y = 0; y < ctx->vert.filter_len; y++,
+            input_base_y += in_stride)
+      {
+         int16x8_t coeff = vdupq_n_s16(filter_vert[y]);
+
+         res_lo          = vqaddq_s16(SCALER_MULHI_NEON(vld1q_s16(input_base_y), coeff), res_lo);
+         res_hi          = vqaddq_s16(SCALER_MULHI_NEON(vld1q_s16(input_base_y + 8), coeff), res_hi);
+      }
+
+      /* Shift and saturate to 8 bits in one go */
+      vst1q_u8((uint8_t*)(output + w), vcombine_u8(
+               vqshrun_n_s16(res_lo, (7 - 2 - 2)),
+               vqshrun_n_s16(res_hi, (7 - 2 - 2))));
+   }
+
+   return w;
+}
+
+static int scaler_argb8888_horiz_neon(
+      const struct scaler_ctx *ctx, const uint32_t *input,
+      uint64_t *output)
+{
+   int w, x;
+   const int16_t *filter_horiz = ctx->horiz.filter;
+
+   for (w = 0; w < ctx->scaled.width; w++,
+         filter_horiz += ctx->horiz.filter_stride)
+   {
+      const uint32_t *input_base_x = input + ctx->horiz.filter_pos[w];
+      int16x8_t res                = vdupq_n_s16(0);
+      int16x4_t sum;
+
+      for (x = 0; (x + 1) < ctx->horiz.filter_len; x += 2)
+      {
+         int16x8_t coeff = vcombine_s16(vdup_n_s16(filter_horiz[x + 0]),
+               vdup_n_s16(filter_horiz[x + 1]));
+         int16x8_t col   = vreinterpretq_s16_u16(vshll_n_u8(
+                  vld1_u8((const uint8_t*)(input_base_x + x)), 7));
+
+         res             = vqaddq_s16(SCALER_MULHI_NEON(col, coeff), res);
+      }
+
+      sum = vqadd_s16(vget_low_s16(res), vget_high_s16(res));
+
+      if (x < ctx->horiz.filter_len)
+      {
+         int16x4_t col = vget_low_s16(vreinterpretq_s16_u16(vshll_n_u8(
+                     vreinterpret_u8_u32(vdup_n_u32(input_base_x[x])), 7)));
+
+         sum           = vqadd_s16(vshr_n_s16(vqdmulh_s16(col,
+                     vdup_n_s16(filter_horiz[x])), 1), sum);
+      }
+
+      vst1_s16((int16_t*)(output + w), sum);
+   }
+
+   return w;
+}
+#endif
+
+void scaler_argb8888_vert(const struct scaler_ctx *ctx, void *output_, int stride,
+      int first, int last)
 {
    int h, w, y;
    const uint64_t      *input = ctx->scaled.frame;
-   uint32_t           *output = (uint32_t*)output_;
+   uint32_t           *output = (uint32_t*)output_ + first * (stride >> 2);
 
-   const int16_t *filter_vert = ctx->vert.filter;
+   const int16_t *filter_vert = ctx->vert.filter + first * ctx->vert.filter_stride;
 
-   for (h = 0; h < ctx->out_height; h++,
+   for (h = first; h < last; h++,
          filter_vert += ctx->vert.filter_stride, output += stride >> 2)
    {
       const uint64_t *input_base = input + ctx->vert.filter_pos[h]
          * (ctx->scaled.stride >> 3);
 
-      for (w = 0; w < ctx->out_width; w++)
+      w = 0;
+#if defined(SCALER_HAVE_AVX2)
+      if (scaler_avx2_enabled)
+         w = scaler_argb8888_vert_avx2(ctx, input_base, output, filter_vert);
+#elif defined(SCALER_HAVE_NEON)
+      if (scaler_neon_enabled)
+         w = scaler_argb8888_vert_neon(ctx, input_base, output, filter_vert);
+#endif
+
+      for (; w < ctx->out_width; w++)
       {
          const uint64_t *input_base_y = input_base + w;
 #if defined(__SSE2__)
@@ -86,7 +343,8 @@ void scaler_argb8888_vert(const struct scaler_ctx *ctx, void *output_, int strid
          for (y = 0; (y + 1) < ctx->vert.filter_len; y += 2,
                input_base_y += (ctx->scaled.stride >> 2))
          {
-            __m128i coeff = _mm_set_epi64x(filter_vert[y + 1] * 0x0001000100010001ll, filter_vert[y + 0] * 0x0001000100010001ll);
+            __m128i coeff = _mm_set_epi64x(
+                  SCALER_SPREAD_COEFF(filter_vert[y + 1]), SCALER_SPREAD_COEFF(filter_vert[y + 0]));
             __m128i col   = _mm_set_epi64x(input_base_y[ctx->scaled.stride >> 3], input_base_y[0]);
 
             res           = _mm_adds_epi16(_mm_mulhi_epi16(col, coeff), res);
@@ -94,7 +352,7 @@ void scaler_argb8888_vert(const struct scaler_ctx *ctx, void *output_, int strid
 
          for (; y < ctx->vert.filter_len; y++, input_base_y += (ctx->scaled.stride >> 3))
          {
-            __m128i coeff = _mm_set_epi64x(0, filter_vert[y] * 0x0001000100010001ll);
+            __m128i coeff = _mm_set_epi64x(0, SCALER_SPREAD_COEFF(filter_vert[y]));
             __m128i col   = _mm_set_epi64x(0, input_base_y[0]);
 
             res           = _mm_adds_epi16(_mm_mulhi_epi16(col, coeff), res);
@@ -145,18 +403,29 @@ void scaler_argb8888_vert(const struct scaler_ctx *ctx, void *output_, int strid
    }
 }
 
-void scaler_argb8888_horiz(const struct scaler_ctx *ctx, const void *input_, int stride)
+void scaler_argb8888_horiz(const struct scaler_ctx *ctx, const void *input_, int stride,
+      int first, int last)
 {
    int h, w, x;
-   const uint32_t *input = (uint32_t*)input_;
-   uint64_t *output      = ctx->scaled.frame;
+   const uint32_t *input = (const uint32_t*)input_ + first * (stride >> 2);
+   uint64_t *output      = ctx->scaled.frame + first * (ctx->scaled.stride >> 3);
 
-   for (h = 0; h < ctx->scaled.height; h++, input += stride >> 2,
+   for (h = first; h < last; h++, input += stride >> 2,
          output += ctx->scaled.stride >> 3)
    {
-      const int16_t *filter_horiz = ctx->horiz.filter;
+      const int16_t *filter_horiz = NULL;
+
+      w = 0;
+#if defined(SCALER_HAVE_AVX2)
+      if (scaler_avx2_enabled)
+         w = scaler_argb8888_horiz_avx2(ctx, input, output);
+#elif defined(SCALER_HAVE_NEON)
+      if (scaler_neon_enabled)
+         w = scaler_argb8888_horiz_neon(ctx, input, output);
+#endif
+      filter_horiz = ctx->horiz.filter + w * ctx->horiz.filter_stride;
 
-      for (w = 0; w < ctx->scaled.width; w++,
+      for (; w < ctx->scaled.width; w++,
             filter_horiz += ctx->horiz.filter_stride)
       {
          const uint32_t *input_base_x = input + ctx->horiz.filter_pos[w];
@@ -171,7 +440,8 @@ void scaler_argb8888_horiz(const struct scaler_ctx *ctx, const void *input_, int
 #endif
          for (x = 0; (x + 1) < ctx->horiz.filter_len; x += 2)
          {
-            __m128i coeff = _mm_set_epi64x(filter_horiz[x + 1] * 0x0001000100010001ll, filter_horiz[x + 0] * 0x0001000100010001ll);
+            __m128i coeff = _mm_set_epi64x(
+                  SCALER_SPREAD_COEFF(filter_horiz[x + 1]), SCALER_SPREAD_COEFF(filter_horiz[x + 0]));
 
             __m128i col   = _mm_unpacklo_epi8(_mm_set_epi64x(0,
                      ((uint64_t)input_base_x[x + 1] << 32) | input_base_x[x + 0]), _mm_setzero_si128());
@@ -182,7 +452,7 @@ void scaler_argb8888_horiz(const struct scaler_ctx *ctx, const void *input_, int
 
          for (; x < ctx->horiz.filter_len; x++)
          {
-            __m128i coeff = _mm_set_epi64x(0, filter_horiz[x] * 0x0001000100010001ll);
+            __m128i coeff = _mm_set_epi64x(0, SCALER_SPREAD_COEFF(filter_horiz[x]));
             __m128i col   = _mm_unpacklo_epi8(_mm_set_epi32(0, 0, 0, input_base_x[x]), _mm_setzero_si128());
 
             col           = _mm_slli_epi16(col, 7);
@@ -221,11 +491,12 @@ void scaler_argb8888_horiz(const struct scaler_ctx *ctx, const void *input_, int
             res_b         += (b * coeff) >> 16;
          }
 
+         /* Negative sums must not spill into the other channels */
          output[w]         = (
-               (uint64_t)res_a  << 48)  |
-               ((uint64_t)res_r << 32)  |
-               ((uint64_t)res_g << 16)  |
-               ((uint64_t)res_b << 0);
+               (uint64_t)(uint16_t)res_a  << 48)  |
+               ((uint64_t)(uint16_t)res_r << 32)  |
+               ((uint64_t)(uint16_t)res_g << 16)  |
+               ((uint64_t)(uint16_t)res_b << 0);
 #endif
       }
    }
@@ -235,7 +506,8 @@ void scaler_argb8888_point_special(const struct scaler_ctx *ctx,
       void *output_, const void *input_,
       int out_width, int out_height,
       int in_width, int in_height,
-      int out_stride, int in_stride)
+      int out_stride, int in_stride,
+      int first, int last)
 {
    int h, w;
    int x_pos             = (1 << 15) * in_width / out_width - (1 << 15);
@@ -250,7 +522,10 @@ void scaler_argb8888_point_special(const struct scaler_ctx *ctx,
    if (y_pos < 0)
       y_pos = 0;
 
-   for (h = 0; h < out_height; h++, y_pos += y_step, output += out_stride >> 2)
+   y_pos  += first * y_step;
+   output += first * (out_stride >> 2);
+
+   for (h = first; h < last; h++, y_pos += y_step, output += out_stride >> 2)
    {
       int               x = x_pos;
       const uint32_t *inp = input + (y_pos >> 16) * (in_stride >> 2);
@@ -46,6 +46,8 @@ RETRO_BEGIN_DECLS
 #define RESAMPLER_SIMD_AVX2     (1 << 12)
 #define RESAMPLER_SIMD_VFPU     (1 << 13)
 #define RESAMPLER_SIMD_PS       (1 << 14)
+#define RESAMPLER_SIMD_FMA      (1 << 22)
+#define RESAMPLER_SIMD_AVX512   (1 << 23)
 
 enum resampler_quality
 {
@@ -155,6 +157,44 @@ extern retro_resampler_t sinc_resampler;
 extern retro_resampler_t CC_resampler;
 #endif
 extern retro_resampler_t nearest_resampler;
+extern retro_resampler_t polyphase_resampler;
+
+typedef struct polyphase_resampler polyphase_resampler_t;
+
+/**
+ * polyphase_resampler_new:
+ * @channels                   : Number of interleaved channels.
+ * @bandwidth_mod              : Expected resampling ratio.
+ * @quality                    : Filter quality.
+ * @mask                       : SIMD instruction sets the kernel may use.
+ *
+ * Creates a polyphase resampler for any number of channels.
+ * The polyphase driver is the stereo case of this.
+ *
+ * Returns: handle, or NULL on failure.
+ **/
+polyphase_resampler_t *polyphase_resampler_new(unsigned channels,
+      double bandwidth_mod, enum resampler_quality quality,
+      resampler_simd_mask_t mask);
+
+/**
+ * polyphase_resampler_process:
+ * @in                         : Interleaved input frames.
+ * @in_frames                  : Number of input frames.
+ * @out                        : Interleaved output frames, must have
+ *                               room for in_frames * ratio + 1 frames.
+ * @ratio                      : Output rate / input rate.
+ *
+ * Returns: number of output frames written.
+ **/
+size_t polyphase_resampler_process(polyphase_resampler_t *re,
+      const float *in, size_t in_frames, float *out, double ratio);
+
+/* Name of the SIMD kernel in use, e.g. "avx2". It depends on
+ * the CPU and on the filter length. */
+const char *polyphase_resampler_kernel(const polyphase_resampler_t *re);
+
+void polyphase_resampler_free(polyphase_resampler_t *re);
 
 /**
  * audio_resampler_driver_find_handle:
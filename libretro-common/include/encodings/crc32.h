@@ -26,11 +26,38 @@
 #include <stdint.h>
 #include <stddef.h>
 
+#include <boolean.h>
 #include <retro_common_api.h>
 
 RETRO_BEGIN_DECLS
 
+/* Implementations behind encoding_crc32(). They all compute the
+ * same CRC (zlib's polynomial); the fastest one this build can run
+ * on the CPU is picked on first use. */
+enum encoding_crc32_impl
+{
+   ENCODING_CRC32_TABLE = 0, /* one table lookup per byte */
+   ENCODING_CRC32_SLICE16,   /* slicing-by-16, portable */
+   ENCODING_CRC32_PCLMUL,    /* x86 PCLMULQDQ folding */
+   ENCODING_CRC32_ARMV8      /* ARMv8 CRC32 instructions */
+};
+
 uint32_t encoding_crc32(uint32_t crc, const uint8_t *buf, size_t len);
+
+/**
+ * encoding_crc32_select:
+ * @impl                 : implementation to use from now on.
+ *
+ * Meant for tests and benchmarks; nothing else needs to call it.
+ *
+ * Returns: false, changing nothing, if @impl is not built in or
+ * the CPU does not support it.
+ **/
+bool encoding_crc32_select(enum encoding_crc32_impl impl);
+
+/* Fastest implementation available, the one picked by default */
+enum encoding_crc32_impl encoding_crc32_best(void);
+
 uint32_t file_crc32(uint32_t crc, const char *path);
 
 RETRO_END_DECLS
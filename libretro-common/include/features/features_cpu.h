@@ -31,6 +31,12 @@
 
 RETRO_BEGIN_DECLS
 
+/* CPU features the frontend uses that libretro.h has no RETRO_SIMD_*
+ * bit for. They are kept out of cpu_features_get(), which is what
+ * cores are handed. */
+#define CPU_FEATURES_FMA    (1 << 0)
+#define CPU_FEATURES_AVX512 (1 << 1)
+
 /**
  * cpu_features_get_perf_counter:
  *
@@ -59,6 +65,15 @@ retro_time_t cpu_features_get_time_usec(void);
  **/
 uint64_t cpu_features_get(void);
 
+/**
+ * cpu_features_get_extensions:
+ *
+ * Gets the CPU features that have no RETRO_SIMD_* bit.
+ *
+ * Returns: bitmask of CPU_FEATURES_* flags.
+ **/
+uint64_t cpu_features_get_extensions(void);
+
 /**
  * cpu_features_get_core_amount:
  *
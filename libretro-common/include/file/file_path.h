@@ -531,6 +531,8 @@ bool path_is_valid(const char *path);
 
 int32_t path_get_size(const char *path);
 
+bool path_get_info(const char *path, int64_t *size, int64_t *mtime);
+
 bool is_path_accessible_using_standard_io(const char *path);
 
 RETRO_END_DECLS
@@ -0,0 +1,126 @@
+/* Copyright  (C) 2010-2020 The RetroArch team
+ *
+ * ---------------------------------------------------------------------------------------
+ * The following license statement only applies to this file (frame_diff.h).
+ * ---------------------------------------------------------------------------------------
+ *
+ * Permission is hereby granted, free of charge,
+ * to any person obtaining a copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+ * and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef __LIBRETRO_SDK_GFX_FRAME_DIFF_H__
+#define __LIBRETRO_SDK_GFX_FRAME_DIFF_H__
+
+#include <stdint.h>
+#include <stddef.h>
+
+#include <retro_common_api.h>
+#include <boolean.h>
+
+RETRO_BEGIN_DECLS
+
+/* Rectangles a frame's changes are reported in, at most */
+#define FRAME_DIFF_MAX_RECTS 16
+
+/* In pixels */
+struct frame_diff_rect
+{
+   unsigned x;
+   unsigned y;
+   unsigned width;
+   unsigned height;
+};
+
+typedef struct frame_diff
+{
+   uint64_t frames;
+   uint64_t frames_unchanged;
+   uint64_t pixels;          /* in all frames */
+   uint64_t pixels_changed;  /* in the rectangles of all frames */
+   uint8_t *prev;
+   size_t prev_size;
+   struct frame_diff_rect rects[FRAME_DIFF_MAX_RECTS];
+   unsigned num_rects;
+   unsigned width;
+   unsigned height;
+   unsigned bpp;
+   bool valid;
+} frame_diff_t;
+
+/**
+ * frame_diff_init_simd:
+ * @cpu                  : RETRO_SIMD_* mask, usually cpu_features_get().
+ *
+ * Lets frame_diff_update() compare rows with AVX2 or NEON when
+ * @cpu has it. Until then SSE2 is used where the library was built
+ * for it. The result is the same either way.
+ **/
+void frame_diff_init_simd(uint64_t cpu);
+
+/**
+ * frame_diff_row_span:
+ * @a                    : row.
+ * @b                    : row to compare with.
+ * @len                  : bytes in each row.
+ * @first                : first byte that differs.
+ * @last                 : one past the last byte that differs.
+ *
+ * Returns: true if the rows differ at all.
+ **/
+bool frame_diff_row_span(const uint8_t *a, const uint8_t *b, size_t len,
+      size_t *first, size_t *last);
+
+/**
+ * frame_diff_update:
+ * @diff                 : tracker, zeroed to start with.
+ * @frame                : frame.
+ * @width                : width of @frame in pixels.
+ * @height               : height of @frame.
+ * @pitch                : bytes from one row of @frame to the next.
+ * @bpp                  : bytes per pixel.
+ *
+ * Compares @frame with the previous one and keeps a copy of it.
+ * Rows that changed next to each other make up one rectangle, as
+ * wide as all their changes together. When there would be more
+ * than FRAME_DIFF_MAX_RECTS, the last ones are merged. The first
+ * frame, and any frame of another size or format, is one
+ * rectangle covering all of it.
+ *
+ * Returns: number of rectangles in @diff->rects, 0 if the frame
+ * did not change.
+ **/
+unsigned frame_diff_update(frame_diff_t *diff, const void *frame,
+      unsigned width, unsigned height, size_t pitch, unsigned bpp);
+
+/**
+ * frame_diff_invalidate:
+ * @diff                 : tracker.
+ *
+ * Makes the next frame count as changed everywhere, for when
+ * the previous one was never shown in full.
+ **/
+void frame_diff_invalidate(frame_diff_t *diff);
+
+/**
+ * frame_diff_free:
+ * @diff                 : tracker.
+ *
+ * Frees the copy of the previous frame. The totals stay.
+ **/
+void frame_diff_free(frame_diff_t *diff);
+
+RETRO_END_DECLS
+
+#endif
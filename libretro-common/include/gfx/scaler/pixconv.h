@@ -23,12 +23,24 @@
 #ifndef __LIBRETRO_SDK_SCALER_PIXCONV_H__
 #define __LIBRETRO_SDK_SCALER_PIXCONV_H__
 
+#include <stdint.h>
+
 #include <clamping.h>
 
 #include <retro_common_api.h>
 
 RETRO_BEGIN_DECLS
 
+/**
+ * conv_init_simd:
+ * @cpu                  : RETRO_SIMD_* mask, usually cpu_features_get().
+ *
+ * Lets the converters use the AVX2 or NEON kernels that @cpu
+ * supports. Until this is called, only the kernels the library
+ * was built for (SSE2) are used. The output is the same either way.
+ **/
+void conv_init_simd(uint64_t cpu);
+
 void conv_0rgb1555_argb8888(void *output, const void *input,
       int width, int height,
       int out_stride, int in_stride);
@@ -32,6 +32,8 @@
 
 RETRO_BEGIN_DECLS
 
+struct scaler_pool;
+
 enum scaler_pix_fmt
 {
    SCALER_FMT_ARGB8888 = 0,
@@ -62,11 +64,11 @@ struct scaler_filter
 struct scaler_ctx
 {
    void (*scaler_horiz)(const struct scaler_ctx*,
-         const void*, int);
+         const void*, int, int, int);
    void (*scaler_vert)(const struct scaler_ctx*,
-         void*, int);
+         void*, int, int, int);
    void (*scaler_special)(const struct scaler_ctx*,
-         void*, const void*, int, int, int, int, int, int);
+         void*, const void*, int, int, int, int, int, int, int, int);
 
    void (*in_pixconv)(void*, const void*, int, int, int, int);
    void (*out_pixconv)(void*, const void*, int, int, int, int);
@@ -105,9 +107,30 @@ struct scaler_ctx
    enum scaler_pix_fmt out_fmt;
    enum scaler_type scaler_type;
 
+   /* Workers for @threads, set up by scaler_ctx_gen_filter() */
+   struct scaler_pool *pool;
+
+   /* Number of threads scaling a frame, each one taking a
+    * band of rows. The caller is one of them. 0 and 1 scale
+    * on the calling thread only, as does a build without
+    * HAVE_THREADS. Read by scaler_ctx_gen_filter(). */
+   unsigned threads;
+
    bool unscaled;
 };
 
+/**
+ * scaler_init_simd:
+ * @cpu                  : RETRO_SIMD_* mask, usually cpu_features_get().
+ *
+ * Lets the horizontal and vertical filters and the pixel
+ * converters (see conv_init_simd()) use the AVX2 or NEON kernels
+ * that @cpu supports. Until this is called, only the kernels the
+ * library was built for (SSE2) are used. The output is the same
+ * either way.
+ **/
+void scaler_init_simd(uint64_t cpu);
+
 bool scaler_ctx_gen_filter(struct scaler_ctx *ctx);
 
 void scaler_ctx_gen_reset(struct scaler_ctx *ctx);
@@ -118,7 +141,8 @@ void scaler_ctx_gen_reset(struct scaler_ctx *ctx);
  * @output       : pointer to output image.
  * @input        : pointer to input image.
  *
- * Scales an input image to an output image.
+ * Scales an input image to an output image. With
+ * @ctx->threads above 1, rows are split across threads.
  **/
 void scaler_ctx_scale(struct scaler_ctx *ctx,
       void *output, const void *input);
@@ -0,0 +1,85 @@
+/* Copyright  (C) 2010-2020 The RetroArch team
+ *
+ * ---------------------------------------------------------------------------------------
+ * The following license statement only applies to this file (spsc_queue.h).
+ * ---------------------------------------------------------------------------------------
+ *
+ * Permission is hereby granted, free of charge,
+ * to any person obtaining a copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+ * and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef __LIBRETRO_SDK_SPSC_QUEUE_H
+#define __LIBRETRO_SDK_SPSC_QUEUE_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+#include <retro_common_api.h>
+#include <boolean.h>
+
+RETRO_BEGIN_DECLS
+
+/* Lock-free byte ring buffer for exactly one producer thread
+ * and one consumer thread, e.g. an emulator thread feeding a
+ * realtime audio thread. Neither side ever blocks the other;
+ * waiting for room or data is up to the caller. */
+typedef struct spsc_queue spsc_queue_t;
+
+/**
+ * spsc_queue_new:
+ * @size                 : capacity in bytes.
+ *
+ * Returns: new queue, or NULL on allocation failure.
+ **/
+spsc_queue_t *spsc_queue_new(size_t size);
+
+void spsc_queue_free(spsc_queue_t *queue);
+
+size_t spsc_queue_capacity(const spsc_queue_t *queue);
+
+/**
+ * spsc_queue_write:
+ *
+ * Producer side. Copies as much of @data as fits, and makes
+ * it visible to the consumer at once.
+ *
+ * Returns: number of bytes written.
+ **/
+size_t spsc_queue_write(spsc_queue_t *queue, const void *data, size_t size);
+
+/**
+ * spsc_queue_read:
+ *
+ * Consumer side. Copies up to @size bytes out of the queue.
+ *
+ * Returns: number of bytes read.
+ **/
+size_t spsc_queue_read(spsc_queue_t *queue, void *data, size_t size);
+
+/* Bytes the consumer can read. Only an estimate
+ * when not called from the consumer thread. */
+size_t spsc_queue_read_avail(spsc_queue_t *queue);
+
+/* Bytes the producer can write. Only an estimate
+ * when not called from the producer thread. */
+size_t spsc_queue_write_avail(spsc_queue_t *queue);
+
+/* Empties the queue. Only safe while neither
+ * the producer nor the consumer is running. */
+void spsc_queue_clear(spsc_queue_t *queue);
+
+RETRO_END_DECLS
+
+#endif
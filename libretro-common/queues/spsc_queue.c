@@ -0,0 +1,219 @@
+/* Copyright  (C) 2010-2020 The RetroArch team
+ *
+ * ---------------------------------------------------------------------------------------
+ * The following license statement only applies to this file (spsc_queue.c).
+ * ---------------------------------------------------------------------------------------
+ *
+ * Permission is hereby granted, free of charge,
+ * to any person obtaining a copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+ * and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include <retro_inline.h>
+
+#include <queues/spsc_queue.h>
+
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#endif
+
+/* Keeps the producer and consumer indices on separate
+ * cache lines so the two threads don't bounce one line. */
+#define SPSC_QUEUE_CACHE_LINE 64
+
+/* The producer publishes data by storing its index with release
+ * semantics, the consumer frees room the same way. Loading the
+ * other side's index with acquire semantics makes the bytes it
+ * published visible. */
+#if defined(__clang__) || (defined(__GNUC__) && ((__GNUC__ > 4) || (__GNUC__ == 4 && __GNUC_MINOR__ >= 7)))
+#define SPSC_QUEUE_LOAD_ACQUIRE(src)      __atomic_load_n(&(src), __ATOMIC_ACQUIRE)
+#define SPSC_QUEUE_STORE_RELEASE(dst, v)  __atomic_store_n(&(dst), (v), __ATOMIC_RELEASE)
+#elif defined(__GNUC__)
+static INLINE size_t spsc_queue_load_acquire(volatile size_t *src)
+{
+   size_t val = *src;
+   __sync_synchronize();
+   return val;
+}
+#define SPSC_QUEUE_LOAD_ACQUIRE(src)      spsc_queue_load_acquire(&(src))
+#define SPSC_QUEUE_STORE_RELEASE(dst, v)  do { __sync_synchronize(); (dst) = (v); } while (0)
+#elif defined(_MSC_VER) && (defined(_M_ARM) || defined(_M_ARM64))
+static INLINE size_t spsc_queue_load_acquire(volatile size_t *src)
+{
+   size_t val = *src;
+   __dmb(0xB); /* ISH */
+   return val;
+}
+#define SPSC_QUEUE_LOAD_ACQUIRE(src)      spsc_queue_load_acquire(&(src))
+#define SPSC_QUEUE_STORE_RELEASE(dst, v)  do { __dmb(0xB); (dst) = (v); } while (0)
+#elif defined(_MSC_VER)
+/* x86 only reorders stores after loads, so keeping
+ * the compiler in line is enough. */
+static INLINE size_t spsc_queue_load_acquire(volatile size_t *src)
+{
+   size_t val = *src;
+   _ReadWriteBarrier();
+   return val;
+}
+#define SPSC_QUEUE_LOAD_ACQUIRE(src)      spsc_queue_load_acquire(&(src))
+#define SPSC_QUEUE_STORE_RELEASE(dst, v)  do { _ReadWriteBarrier(); (dst) = (v); } while (0)
+#else
+#define SPSC_QUEUE_LOAD_ACQUIRE(src)      (src)
+#define SPSC_QUEUE_STORE_RELEASE(dst, v)  ((dst) = (v))
+#endif
+
+struct spsc_queue
+{
+   uint8_t *buffer;
+   size_t capacity;
+   /* Storage is rounded up to a power of two, indices are
+    * free running and masked on access. */
+   size_t mask;
+   uint8_t pad0[SPSC_QUEUE_CACHE_LINE];
+
+   /* Written by the producer only */
+   volatile size_t write_pos;
+   /* Last read_pos the producer saw, saves touching the
+    * consumer's cache line while there is known room */
+   size_t cached_read_pos;
+   uint8_t pad1[SPSC_QUEUE_CACHE_LINE];
+
+   /* Written by the consumer only */
+   volatile size_t read_pos;
+   size_t cached_write_pos;
+   uint8_t pad2[SPSC_QUEUE_CACHE_LINE];
+};
+
+spsc_queue_t *spsc_queue_new(size_t size)
+{
+   size_t storage       = 1;
+   spsc_queue_t *queue  = NULL;
+
+   if (!size)
+      return NULL;
+
+   while (storage < size)
+      storage <<= 1;
+
+   if (!(queue = (spsc_queue_t*)calloc(1, sizeof(*queue))))
+      return NULL;
+
+   if (!(queue->buffer = (uint8_t*)calloc(1, storage)))
+   {
+      free(queue);
+      return NULL;
+   }
+
+   queue->capacity = size;
+   queue->mask     = storage - 1;
+   return queue;
+}
+
+void spsc_queue_free(spsc_queue_t *queue)
+{
+   if (!queue)
+      return;
+   free(queue->buffer);
+   free(queue);
+}
+
+size_t spsc_queue_capacity(const spsc_queue_t *queue)
+{
+   return queue->capacity;
+}
+
+size_t spsc_queue_write(spsc_queue_t *queue, const void *data, size_t size)
+{
+   size_t offset, first;
+   size_t write_pos = queue->write_pos;
+   size_t avail     = queue->capacity
+      - (write_pos - queue->cached_read_pos);
+
+   if (avail < size)
+   {
+      queue->cached_read_pos = SPSC_QUEUE_LOAD_ACQUIRE(queue->read_pos);
+      avail                  = queue->capacity
+         - (write_pos - queue->cached_read_pos);
+   }
+
+   if (size > avail)
+      size = avail;
+   if (!size)
+      return 0;
+
+   offset = write_pos & queue->mask;
+   first  = queue->mask + 1 - offset;
+   if (first > size)
+      first = size;
+
+   memcpy(queue->buffer + offset, data, first);
+   memcpy(queue->buffer, (const uint8_t*)data + first, size - first);
+
+   SPSC_QUEUE_STORE_RELEASE(queue->write_pos, write_pos + size);
+   return size;
+}
+
+size_t spsc_queue_read(spsc_queue_t *queue, void *data, size_t size)
+{
+   size_t offset, first;
+   size_t read_pos = queue->read_pos;
+   size_t avail    = queue->cached_write_pos - read_pos;
+
+   if (avail < size)
+   {
+      queue->cached_write_pos = SPSC_QUEUE_LOAD_ACQUIRE(queue->write_pos);
+      avail                   = queue->cached_write_pos - read_pos;
+   }
+
+   if (size > avail)
+      size = avail;
+   if (!size)
+      return 0;
+
+   offset = read_pos & queue->mask;
+   first  = queue->mask + 1 - offset;
+   if (first > size)
+      first = size;
+
+   memcpy(data, queue->buffer + offset, first);
+   memcpy((uint8_t*)data + first, queue->buffer, size - first);
+
+   SPSC_QUEUE_STORE_RELEASE(queue->read_pos, read_pos + size);
+   return size;
+}
+
+size_t spsc_queue_read_avail(spsc_queue_t *queue)
+{
+   size_t read_pos  = SPSC_QUEUE_LOAD_ACQUIRE(queue->read_pos);
+   size_t write_pos = SPSC_QUEUE_LOAD_ACQUIRE(queue->write_pos);
+   return write_pos - read_pos;
+}
+
+size_t spsc_queue_write_avail(spsc_queue_t *queue)
+{
+   size_t write_pos = SPSC_QUEUE_LOAD_ACQUIRE(queue->write_pos);
+   size_t read_pos  = SPSC_QUEUE_LOAD_ACQUIRE(queue->read_pos);
+   return queue->capacity - (write_pos - read_pos);
+}
+
+void spsc_queue_clear(spsc_queue_t *queue)
+{
+   queue->write_pos        = 0;
+   queue->cached_read_pos  = 0;
+   queue->read_pos         = 0;
+   queue->cached_write_pos = 0;
+}
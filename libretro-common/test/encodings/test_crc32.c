@@ -0,0 +1,132 @@
+/* Copyright  (C) 2021 The RetroArch team
+ *
+ * ---------------------------------------------------------------------------------------
+ * The following license statement only applies to this file (test_crc32.c).
+ * ---------------------------------------------------------------------------------------
+ *
+ * Permission is hereby granted, free of charge,
+ * to any person obtaining a copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+ * and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include <check.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <boolean.h>
+#include <encodings/crc32.h>
+
+#define SUITE_NAME "crc32"
+
+#define BUF_SIZE 4096
+
+static const enum encoding_crc32_impl impls[] = {
+   ENCODING_CRC32_TABLE,
+   ENCODING_CRC32_SLICE16,
+   ENCODING_CRC32_PCLMUL,
+   ENCODING_CRC32_ARMV8
+};
+
+/* Known values, whichever implementation the CPU gets */
+START_TEST (test_crc32_known)
+{
+   unsigned i;
+   const char *quick = "The quick brown fox jumps over the lazy dog";
+   uint8_t *zeros    = (uint8_t*)calloc(1, BUF_SIZE);
+
+   ck_assert(zeros != NULL);
+
+   for (i = 0; i < sizeof(impls) / sizeof(impls[0]); i++)
+   {
+      if (!encoding_crc32_select(impls[i]))
+         continue;
+
+      ck_assert_uint_eq(encoding_crc32(0, (const uint8_t*)quick,
+               strlen(quick)), 0x414fa339);
+      ck_assert_uint_eq(encoding_crc32(0, zeros, BUF_SIZE), 0xc71c0011);
+      ck_assert_uint_eq(encoding_crc32(0x12345678, zeros, 0), 0x12345678);
+   }
+
+   ck_assert(encoding_crc32_select(encoding_crc32_best()));
+   free(zeros);
+}
+END_TEST
+
+/* Random contents, lengths, alignments and starting CRCs against
+ * the byte-wise table, also split in two calls */
+START_TEST (test_crc32_random)
+{
+   unsigned i, round;
+   uint8_t *buf = (uint8_t*)malloc(BUF_SIZE + 16);
+
+   ck_assert(buf != NULL);
+
+   srand(1234);
+   for (i = 0; i < BUF_SIZE + 16; i++)
+      buf[i] = (uint8_t)rand();
+
+   for (round = 0; round < 2000; round++)
+   {
+      unsigned j;
+      uint32_t expected, crc;
+      size_t align = (size_t)(rand() % 16);
+      size_t len   = (round < 300) ? round : (size_t)(rand() % BUF_SIZE);
+      size_t split = len ? (size_t)(rand() % len) : 0;
+      uint32_t seed = (round & 1) ? (uint32_t)rand() * 2654435761u : 0;
+
+      ck_assert(encoding_crc32_select(ENCODING_CRC32_TABLE));
+      expected = encoding_crc32(seed, buf + align, len);
+
+      for (j = 1; j < sizeof(impls) / sizeof(impls[0]); j++)
+      {
+         if (!encoding_crc32_select(impls[j]))
+            continue;
+
+         ck_assert_uint_eq(encoding_crc32(seed, buf + align, len), expected);
+
+         crc = encoding_crc32(seed, buf + align, split);
+         crc = encoding_crc32(crc, buf + align + split, len - split);
+         ck_assert_uint_eq(crc, expected);
+      }
+   }
+
+   ck_assert(encoding_crc32_select(encoding_crc32_best()));
+   free(buf);
+}
+END_TEST
+
+Suite *create_suite(void)
+{
+   Suite *s = suite_create(SUITE_NAME);
+
+   TCase *tc_core = tcase_create("Core");
+   tcase_add_test(tc_core, test_crc32_known);
+   tcase_add_test(tc_core, test_crc32_random);
+   suite_add_tcase(s, tc_core);
+
+   return s;
+}
+
+int main(void)
+{
+   int num_fail;
+   Suite *s = create_suite();
+   SRunner *sr = srunner_create(s);
+   srunner_run_all(sr, CK_NORMAL);
+   num_fail = srunner_ntests_failed(sr);
+   srunner_free(sr);
+   return (num_fail == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,198 @@
+/* Copyright  (C) 2021 The RetroArch team
+ *
+ * ---------------------------------------------------------------------------------------
+ * The following license statement only applies to this file (test_frame_diff.c).
+ * ---------------------------------------------------------------------------------------
+ *
+ * Permission is hereby granted, free of charge,
+ * to any person obtaining a copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+ * and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include <check.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <boolean.h>
+#include <libretro.h>
+#include <features/features_cpu.h>
+#include <gfx/frame_diff.h>
+
+#define SUITE_NAME "frame_diff"
+
+#define FRAME_WIDTH  160
+#define FRAME_HEIGHT 144
+/* Pitch wider than the frame; the padding must never count */
+#define FRAME_PITCH  (FRAME_WIDTH * 4 + 64)
+
+static void fill_frame(uint8_t *frame, uint8_t pad)
+{
+   unsigned y;
+
+   for (y = 0; y < FRAME_HEIGHT; y++)
+   {
+      unsigned x;
+      uint8_t *line = frame + y * FRAME_PITCH;
+      for (x = 0; x < FRAME_WIDTH * 4; x++)
+         line[x] = (uint8_t)(x * 7 + y * 13);
+      memset(line + FRAME_WIDTH * 4, pad, FRAME_PITCH - FRAME_WIDTH * 4);
+   }
+}
+
+static void set_pixel(uint8_t *frame, unsigned x, unsigned y)
+{
+   frame[y * FRAME_PITCH + x * 4 + 1] ^= 0xff;
+}
+
+/* Every offset of the difference against every row length the
+ * block loops split differently, with and without the CPU's SIMD */
+START_TEST (test_frame_diff_row_span)
+{
+   uint8_t a[200];
+   uint8_t b[200];
+   size_t len, i, j;
+   unsigned pass;
+
+   for (i = 0; i < sizeof(a); i++)
+      a[i] = (uint8_t)(i * 31);
+
+   for (pass = 0; pass < 2; pass++)
+   {
+      frame_diff_init_simd(pass ? cpu_features_get() : 0);
+
+      for (len = 1; len <= sizeof(a); len++)
+      {
+         size_t first = 0, last = 0;
+
+         memcpy(b, a, len);
+         ck_assert(!frame_diff_row_span(a, b, len, &first, &last));
+
+         for (i = 0; i < len; i++)
+         {
+            for (j = i; j < len; j += 5)
+            {
+               memcpy(b, a, len);
+               b[i] ^= 1;
+               b[j] ^= 0x80;
+               ck_assert(frame_diff_row_span(a, b, len, &first, &last));
+               ck_assert_uint_eq(first, i);
+               ck_assert_uint_eq(last, j + 1);
+            }
+         }
+      }
+   }
+}
+END_TEST
+
+START_TEST (test_frame_diff_rects)
+{
+   frame_diff_t diff;
+   uint8_t *frame = (uint8_t*)malloc(FRAME_PITCH * FRAME_HEIGHT);
+   unsigned y;
+
+   ck_assert(frame != NULL);
+   memset(&diff, 0, sizeof(diff));
+   frame_diff_init_simd(cpu_features_get());
+   fill_frame(frame, 0);
+
+   /* First frame: everything */
+   ck_assert_uint_eq(frame_diff_update(&diff, frame,
+            FRAME_WIDTH, FRAME_HEIGHT, FRAME_PITCH, 4), 1);
+   ck_assert_uint_eq(diff.rects[0].width, FRAME_WIDTH);
+   ck_assert_uint_eq(diff.rects[0].height, FRAME_HEIGHT);
+
+   /* Same frame, different padding: nothing */
+   fill_frame(frame, 0x55);
+   ck_assert_uint_eq(frame_diff_update(&diff, frame,
+            FRAME_WIDTH, FRAME_HEIGHT, FRAME_PITCH, 4), 0);
+   ck_assert_uint_eq(diff.frames_unchanged, 1);
+
+   /* Two separate blocks of rows */
+   set_pixel(frame, 10, 5);
+   set_pixel(frame, 20, 6);
+   set_pixel(frame, 159, 100);
+   ck_assert_uint_eq(frame_diff_update(&diff, frame,
+            FRAME_WIDTH, FRAME_HEIGHT, FRAME_PITCH, 4), 2);
+   ck_assert_uint_eq(diff.rects[0].x, 10);
+   ck_assert_uint_eq(diff.rects[0].y, 5);
+   ck_assert_uint_eq(diff.rects[0].width, 11);
+   ck_assert_uint_eq(diff.rects[0].height, 2);
+   ck_assert_uint_eq(diff.rects[1].x, 159);
+   ck_assert_uint_eq(diff.rects[1].y, 100);
+   ck_assert_uint_eq(diff.rects[1].width, 1);
+   ck_assert_uint_eq(diff.rects[1].height, 1);
+
+   /* The copy was updated, so the same frame is unchanged again */
+   ck_assert_uint_eq(frame_diff_update(&diff, frame,
+            FRAME_WIDTH, FRAME_HEIGHT, FRAME_PITCH, 4), 0);
+
+   /* More blocks than rectangles: the last one takes the rest */
+   for (y = 0; y < FRAME_HEIGHT; y += 4)
+      set_pixel(frame, y, y);
+   ck_assert_uint_eq(frame_diff_update(&diff, frame,
+            FRAME_WIDTH, FRAME_HEIGHT, FRAME_PITCH, 4),
+         FRAME_DIFF_MAX_RECTS);
+   ck_assert_uint_eq(diff.rects[FRAME_DIFF_MAX_RECTS - 1].y,
+         (FRAME_DIFF_MAX_RECTS - 1) * 4);
+   ck_assert_uint_eq(diff.rects[FRAME_DIFF_MAX_RECTS - 1].x,
+         (FRAME_DIFF_MAX_RECTS - 1) * 4);
+   ck_assert_uint_eq(diff.rects[FRAME_DIFF_MAX_RECTS - 1].y
+         + diff.rects[FRAME_DIFF_MAX_RECTS - 1].height, FRAME_HEIGHT - 3);
+   ck_assert_uint_eq(diff.rects[FRAME_DIFF_MAX_RECTS - 1].x
+         + diff.rects[FRAME_DIFF_MAX_RECTS - 1].width, FRAME_HEIGHT - 3);
+
+   /* Invalidated or resized: everything again */
+   frame_diff_invalidate(&diff);
+   ck_assert_uint_eq(frame_diff_update(&diff, frame,
+            FRAME_WIDTH, FRAME_HEIGHT, FRAME_PITCH, 4), 1);
+   ck_assert_uint_eq(diff.rects[0].width, FRAME_WIDTH);
+   ck_assert_uint_eq(frame_diff_update(&diff, frame,
+            FRAME_WIDTH / 2, FRAME_HEIGHT, FRAME_PITCH, 2), 1);
+   ck_assert_uint_eq(diff.rects[0].width, FRAME_WIDTH / 2);
+
+   ck_assert_uint_eq(diff.frames, 7);
+   ck_assert_uint_eq(diff.pixels,
+         6 * FRAME_WIDTH * FRAME_HEIGHT + FRAME_WIDTH / 2 * FRAME_HEIGHT);
+
+   frame_diff_free(&diff);
+   ck_assert(diff.prev == NULL);
+   ck_assert_uint_eq(diff.frames, 7);
+   free(frame);
+}
+END_TEST
+
+Suite *create_suite(void)
+{
+   Suite *s = suite_create(SUITE_NAME);
+
+   TCase *tc_core = tcase_create("Core");
+   tcase_add_test(tc_core, test_frame_diff_row_span);
+   tcase_add_test(tc_core, test_frame_diff_rects);
+   suite_add_tcase(s, tc_core);
+
+   return s;
+}
+
+int main(void)
+{
+   int num_fail;
+   Suite *s = create_suite();
+   SRunner *sr = srunner_create(s);
+   srunner_run_all(sr, CK_NORMAL);
+   num_fail = srunner_ntests_failed(sr);
+   srunner_free(sr);
+   return (num_fail == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,490 @@
+/* Copyright  (C) 2021 The RetroArch team
+ *
+ * ---------------------------------------------------------------------------------------
+ * The following license statement only applies to this file (test_pixconv.c).
+ * ---------------------------------------------------------------------------------------
+ *
+ * Permission is hereby granted, free of charge,
+ * to any person obtaining a copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+ * and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include <check.h>
+#include <stdarg.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <boolean.h>
+#include <libretro.h>
+#include <features/features_cpu.h>
+#include <gfx/scaler/pixconv.h>
+
+#define SUITE_NAME "pixconv"
+
+/* Bytes around each line the converters must leave alone */
+#define LINE_PAD 40
+
+#define BENCH_WIDTH  640
+#define BENCH_HEIGHT 480
+#define BENCH_FRAMES 20
+
+typedef void (*pixconv_fn)(void *output, const void *input,
+      int width, int height, int out_stride, int in_stride);
+typedef void (*pixconv_ref_fn)(uint8_t *out, const uint8_t *in, int width);
+
+/* Scalar reference of every conversion, one line at a time */
+
+static uint32_t ref_load16(const uint8_t *in, int w)
+{
+   uint16_t col;
+   memcpy(&col, in + w * 2, 2);
+   return col;
+}
+
+static uint32_t ref_load32(const uint8_t *in, int w)
+{
+   uint32_t col;
+   memcpy(&col, in + w * 4, 4);
+   return col;
+}
+
+static void ref_store16(uint8_t *out, int w, uint32_t col)
+{
+   uint16_t c = (uint16_t)col;
+   memcpy(out + w * 2, &c, 2);
+}
+
+static void ref_store32(uint8_t *out, int w, uint32_t col)
+{
+   memcpy(out + w * 4, &col, 4);
+}
+
+static uint32_t ref_argb(uint32_t a, uint32_t r, uint32_t g, uint32_t b)
+{
+   return (a << 24) | (r << 16) | (g << 8) | b;
+}
+
+static uint32_t ref_expand5(uint32_t c) { return (c << 3) | (c >> 2); }
+static uint32_t ref_expand6(uint32_t c) { return (c << 2) | (c >> 4); }
+static uint32_t ref_expand4(uint32_t c) { return (c << 4) | c; }
+
+static uint8_t ref_clamp(int v)
+{
+   return v < 0 ? 0 : (v > 255 ? 255 : (uint8_t)v);
+}
+
+static void ref_rgb565_0rgb1555(uint8_t *out, const uint8_t *in, int width)
+{
+   int w;
+   for (w = 0; w < width; w++)
+   {
+      uint32_t col = ref_load16(in, w);
+      ref_store16(out, w, ((col >> 1) & 0x7fe0) | (col & 0x1f));
+   }
+}
+
+static void ref_0rgb1555_rgb565(uint8_t *out, const uint8_t *in, int width)
+{
+   int w;
+   for (w = 0; w < width; w++)
+   {
+      uint32_t col = ref_load16(in, w);
+      ref_store16(out, w, ((col << 1) & 0xffc0)
+            | (col & 0x1f) | ((col >> 4) & 0x20));
+   }
+}
+
+static void ref_0rgb1555_argb8888(uint8_t *out, const uint8_t *in, int width)
+{
+   int w;
+   for (w = 0; w < width; w++)
+   {
+      uint32_t col = ref_load16(in, w);
+      ref_store32(out, w, ref_argb(0xff,
+               ref_expand5((col >> 10) & 0x1f),
+               ref_expand5((col >>  5) & 0x1f),
+               ref_expand5(col & 0x1f)));
+   }
+}
+
+static void ref_rgb565_argb8888(uint8_t *out, const uint8_t *in, int width)
+{
+   int w;
+   for (w = 0; w < width; w++)
+   {
+      uint32_t col = ref_load16(in, w);
+      ref_store32(out, w, ref_argb(0xff,
+               ref_expand5(col >> 11),
+               ref_expand6((col >> 5) & 0x3f),
+               ref_expand5(col & 0x1f)));
+   }
+}
+
+static void ref_rgb565_abgr8888(uint8_t *out, const uint8_t *in, int width)
+{
+   int w;
+   for (w = 0; w < width; w++)
+   {
+      uint32_t col = ref_load16(in, w);
+      ref_store32(out, w, ref_argb(0xff,
+               ref_expand5(col & 0x1f),
+               ref_expand6((col >> 5) & 0x3f),
+               ref_expand5(col >> 11)));
+   }
+}
+
+static void ref_argb8888_rgba4444(uint8_t *out, const uint8_t *in, int width)
+{
+   int w;
+   for (w = 0; w < width; w++)
+   {
+      uint32_t col = ref_load32(in, w);
+      ref_store16(out, w, (((col >> 20) & 0xf) << 12)
+            | (((col >> 12) & 0xf) << 8)
+            | (((col >>  4) & 0xf) << 4)
+            | (col >> 28));
+   }
+}
+
+static void ref_rgba4444_argb8888(uint8_t *out, const uint8_t *in, int width)
+{
+   int w;
+   for (w = 0; w < width; w++)
+   {
+      uint32_t col = ref_load16(in, w);
+      ref_store32(out, w, ref_argb(
+               ref_expand4(col & 0xf),
+               ref_expand4(col >> 12),
+               ref_expand4((col >> 8) & 0xf),
+               ref_expand4((col >> 4) & 0xf)));
+   }
+}
+
+static void ref_rgba4444_rgb565(uint8_t *out, const uint8_t *in, int width)
+{
+   int w;
+   for (w = 0; w < width; w++)
+   {
+      uint32_t col = ref_load16(in, w);
+      ref_store16(out, w, ((col >> 12) << 12)
+            | (((col >> 8) & 0xf) << 7)
+            | (((col >> 4) & 0xf) << 1));
+   }
+}
+
+static void ref_bgr24_argb8888(uint8_t *out, const uint8_t *in, int width)
+{
+   int w;
+   for (w = 0; w < width; w++)
+      ref_store32(out, w, ref_argb(0xff,
+               in[w * 3 + 2], in[w * 3 + 1], in[w * 3]));
+}
+
+static void ref_bgr24_rgb565(uint8_t *out, const uint8_t *in, int width)
+{
+   int w;
+   for (w = 0; w < width; w++)
+      ref_store16(out, w, ((in[w * 3 + 2] >> 3) << 11)
+            | ((in[w * 3 + 1] >> 2) << 5) | (in[w * 3] >> 3));
+}
+
+static void ref_argb8888_0rgb1555(uint8_t *out, const uint8_t *in, int width)
+{
+   int w;
+   for (w = 0; w < width; w++)
+   {
+      uint32_t col = ref_load32(in, w);
+      ref_store16(out, w, (((col >> 19) & 0x1f) << 10)
+            | (((col >> 11) & 0x1f) << 5) | ((col >> 3) & 0x1f));
+   }
+}
+
+static void ref_argb8888_rgb565(uint8_t *out, const uint8_t *in, int width)
+{
+   int w;
+   for (w = 0; w < width; w++)
+   {
+      uint32_t col = ref_load32(in, w);
+      ref_store16(out, w, (((col >> 19) & 0x1f) << 11)
+            | (((col >> 10) & 0x3f) << 5) | ((col >> 3) & 0x1f));
+   }
+}
+
+static void ref_argb8888_bgr24(uint8_t *out, const uint8_t *in, int width)
+{
+   int w;
+   for (w = 0; w < width; w++)
+      memcpy(out + w * 3, in + w * 4, 3);
+}
+
+static void ref_abgr8888_bgr24(uint8_t *out, const uint8_t *in, int width)
+{
+   int w;
+   for (w = 0; w < width; w++)
+   {
+      out[w * 3 + 0] = in[w * 4 + 2];
+      out[w * 3 + 1] = in[w * 4 + 1];
+      out[w * 3 + 2] = in[w * 4 + 0];
+   }
+}
+
+static void ref_argb8888_abgr8888(uint8_t *out, const uint8_t *in, int width)
+{
+   int w;
+   for (w = 0; w < width; w++)
+   {
+      uint32_t col = ref_load32(in, w);
+      ref_store32(out, w, (col & 0xff00ff00)
+            | ((col & 0xff) << 16) | ((col >> 16) & 0xff));
+   }
+}
+
+static void ref_0rgb1555_bgr24(uint8_t *out, const uint8_t *in, int width)
+{
+   int w;
+   for (w = 0; w < width; w++)
+   {
+      uint32_t col   = ref_load16(in, w);
+      out[w * 3 + 0] = ref_expand5(col & 0x1f);
+      out[w * 3 + 1] = ref_expand5((col >>  5) & 0x1f);
+      out[w * 3 + 2] = ref_expand5((col >> 10) & 0x1f);
+   }
+}
+
+static void ref_rgb565_bgr24(uint8_t *out, const uint8_t *in, int width)
+{
+   int w;
+   for (w = 0; w < width; w++)
+   {
+      uint32_t col   = ref_load16(in, w);
+      out[w * 3 + 0] = ref_expand5(col & 0x1f);
+      out[w * 3 + 1] = ref_expand6((col >> 5) & 0x3f);
+      out[w * 3 + 2] = ref_expand5(col >> 11);
+   }
+}
+
+static void ref_yuyv_argb8888(uint8_t *out, const uint8_t *in, int width)
+{
+   int w;
+   for (w = 0; w < width; w++)
+   {
+      int y = in[w * 2];
+      int u = in[(w & ~1) * 2 + 1] - 128;
+      int v = in[(w & ~1) * 2 + 3] - 128;
+      ref_store32(out, w, ref_argb(0xff,
+               ref_clamp((64 * y + 90 * v + 32) >> 6),
+               ref_clamp((64 * y - 22 * u - 46 * v + 32) >> 6),
+               ref_clamp((64 * y + 113 * u + 32) >> 6)));
+   }
+}
+
+static void ref_copy(uint8_t *out, const uint8_t *in, int width)
+{
+   memcpy(out, in, width * 4);
+}
+
+typedef struct
+{
+   const char *name;
+   pixconv_fn conv;
+   pixconv_ref_fn ref;
+   int in_bpp;
+   int out_bpp;
+   /* Only converts pairs of pixels */
+   bool even;
+} pixconv_case_t;
+
+static const pixconv_case_t pixconv_cases[] = {
+   { "rgb565_0rgb1555",   conv_rgb565_0rgb1555,   ref_rgb565_0rgb1555,   2, 2, false },
+   { "0rgb1555_rgb565",   conv_0rgb1555_rgb565,   ref_0rgb1555_rgb565,   2, 2, false },
+   { "0rgb1555_argb8888", conv_0rgb1555_argb8888, ref_0rgb1555_argb8888, 2, 4, false },
+   { "rgb565_argb8888",   conv_rgb565_argb8888,   ref_rgb565_argb8888,   2, 4, false },
+   { "rgb565_abgr8888",   conv_rgb565_abgr8888,   ref_rgb565_abgr8888,   2, 4, false },
+   { "argb8888_rgba4444", conv_argb8888_rgba4444, ref_argb8888_rgba4444, 4, 2, false },
+   { "rgba4444_argb8888", conv_rgba4444_argb8888, ref_rgba4444_argb8888, 2, 4, false },
+   { "rgba4444_rgb565",   conv_rgba4444_rgb565,   ref_rgba4444_rgb565,   2, 2, false },
+   { "bgr24_argb8888",    conv_bgr24_argb8888,    ref_bgr24_argb8888,    3, 4, false },
+   { "bgr24_rgb565",      conv_bgr24_rgb565,      ref_bgr24_rgb565,      3, 2, false },
+   { "argb8888_0rgb1555", conv_argb8888_0rgb1555, ref_argb8888_0rgb1555, 4, 2, false },
+   { "argb8888_rgb565",   conv_argb8888_rgb565,   ref_argb8888_rgb565,   4, 2, false },
+   { "argb8888_bgr24",    conv_argb8888_bgr24,    ref_argb8888_bgr24,    4, 3, false },
+   { "abgr8888_bgr24",    conv_abgr8888_bgr24,    ref_abgr8888_bgr24,    4, 3, false },
+   { "argb8888_abgr8888", conv_argb8888_abgr8888, ref_argb8888_abgr8888, 4, 4, false },
+   { "0rgb1555_bgr24",    conv_0rgb1555_bgr24,    ref_0rgb1555_bgr24,    2, 3, false },
+   { "rgb565_bgr24",      conv_rgb565_bgr24,      ref_rgb565_bgr24,      2, 3, false },
+   { "yuyv_argb8888",     conv_yuyv_argb8888,     ref_yuyv_argb8888,     2, 4, true  },
+   { "copy",              conv_copy,              ref_copy,              4, 4, false },
+};
+
+#define PIXCONV_CASES (sizeof(pixconv_cases) / sizeof(pixconv_cases[0]))
+
+static void fill_random(uint8_t *data, size_t size, uint32_t seed)
+{
+   size_t i;
+   for (i = 0; i < size; i++)
+   {
+      seed    = seed * 1664525u + 1013904223u;
+      data[i] = (uint8_t)(seed >> 24);
+   }
+}
+
+/* Converts random lines of every width up to @max_width and
+ * checks the result and the padding against the reference. */
+static void check_case(const pixconv_case_t *c, int max_width)
+{
+   int width;
+   const int height = 3;
+
+   for (width = 1; width <= max_width; width++)
+   {
+      int h;
+      int in_stride    = width * c->in_bpp  + LINE_PAD;
+      int out_stride   = width * c->out_bpp + LINE_PAD;
+      uint8_t *in      = (uint8_t*)malloc(in_stride * height);
+      uint8_t *out     = (uint8_t*)malloc(out_stride * height);
+      uint8_t *expect  = (uint8_t*)malloc(out_stride * height);
+
+      if (c->even && (width & 1))
+      {
+         free(in);
+         free(out);
+         free(expect);
+         continue;
+      }
+
+      /* conv_copy copies the whole stride */
+      if (c->conv == conv_copy)
+         out_stride = in_stride;
+
+      fill_random(in, in_stride * height, (uint32_t)width);
+      memset(out, 0xa5, out_stride * height);
+      memset(expect, 0xa5, out_stride * height);
+
+      for (h = 0; h < height; h++)
+         c->ref(expect + h * out_stride, in + h * in_stride,
+               c->conv == conv_copy ? in_stride / 4 : width);
+
+      c->conv(out, in, width, height, out_stride, in_stride);
+
+      if (memcmp(out, expect, out_stride * height))
+         printf("%s differs at width %d\n", c->name, width);
+      ck_assert(!memcmp(out, expect, out_stride * height));
+
+      free(in);
+      free(out);
+      free(expect);
+   }
+}
+
+START_TEST (test_pixconv_exact)
+{
+   unsigned i;
+
+   /* Without AVX2 and NEON first, then with what the CPU has */
+   conv_init_simd(0);
+   for (i = 0; i < PIXCONV_CASES; i++)
+      check_case(&pixconv_cases[i], 80);
+
+   conv_init_simd(cpu_features_get());
+   for (i = 0; i < PIXCONV_CASES; i++)
+      check_case(&pixconv_cases[i], 80);
+}
+END_TEST
+
+START_TEST (test_pixconv_wide)
+{
+   unsigned i;
+
+   conv_init_simd(cpu_features_get());
+   for (i = 0; i < PIXCONV_CASES; i++)
+      check_case(&pixconv_cases[i], 333);
+}
+END_TEST
+
+static double bench_case(const pixconv_case_t *c,
+      uint8_t *out, const uint8_t *in)
+{
+   int i;
+   retro_time_t start;
+   retro_time_t usec;
+   double bytes = (double)BENCH_WIDTH * BENCH_HEIGHT * BENCH_FRAMES
+      * (c->in_bpp + c->out_bpp);
+
+   start = cpu_features_get_time_usec();
+   for (i = 0; i < BENCH_FRAMES; i++)
+      c->conv(out, in, BENCH_WIDTH, BENCH_HEIGHT,
+            BENCH_WIDTH * c->out_bpp, BENCH_WIDTH * c->in_bpp);
+   usec = cpu_features_get_time_usec() - start;
+
+   return bytes / (usec > 0 ? usec : 1) / 1000.0;
+}
+
+/* Reports the throughput (bytes read and written) of every
+ * conversion with and without the AVX2 and NEON kernels. */
+START_TEST (test_pixconv_bench)
+{
+   unsigned i;
+   uint64_t cpu = cpu_features_get();
+   uint8_t *in  = (uint8_t*)malloc(BENCH_WIDTH * BENCH_HEIGHT * 4);
+   uint8_t *out = (uint8_t*)malloc(BENCH_WIDTH * BENCH_HEIGHT * 4);
+
+   ck_assert_ptr_nonnull(in);
+   ck_assert_ptr_nonnull(out);
+   fill_random(in, BENCH_WIDTH * BENCH_HEIGHT * 4, 1);
+
+   printf("%-20s %10s %10s   (GB/s, %dx%d)\n", "conversion",
+         "baseline", "dispatch", BENCH_WIDTH, BENCH_HEIGHT);
+
+   for (i = 0; i < PIXCONV_CASES; i++)
+   {
+      double base, best;
+
+      conv_init_simd(0);
+      base = bench_case(&pixconv_cases[i], out, in);
+      conv_init_simd(cpu);
+      best = bench_case(&pixconv_cases[i], out, in);
+
+      printf("%-20s %10.2f %10.2f\n", pixconv_cases[i].name, base, best);
+   }
+
+   free(in);
+   free(out);
+}
+END_TEST
+
+Suite *create_suite(void)
+{
+   Suite *s = suite_create(SUITE_NAME);
+
+   TCase *tc_core = tcase_create("Core");
+   tcase_add_test(tc_core, test_pixconv_exact);
+   tcase_add_test(tc_core, test_pixconv_wide);
+   tcase_add_test(tc_core, test_pixconv_bench);
+   suite_add_tcase(s, tc_core);
+
+   return s;
+}
+
+int main(void)
+{
+   int num_fail;
+   Suite *s = create_suite();
+   SRunner *sr = srunner_create(s);
+   srunner_run_all(sr, CK_NORMAL);
+   num_fail = srunner_ntests_failed(sr);
+   srunner_free(sr);
+   return (num_fail == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,182 @@
+/* Copyright  (C) 2010-2020 The RetroArch team
+ *
+ * ---------------------------------------------------------------------------------------
+ * The following license statement only applies to this file (test_spsc_queue.c).
+ * ---------------------------------------------------------------------------------------
+ *
+ * Permission is hereby granted, free of charge,
+ * to any person obtaining a copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+ * and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#include <check.h>
+#include <stdarg.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <queues/spsc_queue.h>
+#include <rthreads/rthreads.h>
+#include <retro_timers.h>
+
+#define SUITE_NAME "SPSC Queue"
+
+#define STRESS_BYTES (1024 * 1024)
+
+START_TEST (test_spsc_queue_create)
+{
+   spsc_queue_t *queue = spsc_queue_new(1000);
+   ck_assert_ptr_nonnull(queue);
+   ck_assert_uint_eq(spsc_queue_capacity(queue), 1000);
+   ck_assert_uint_eq(spsc_queue_read_avail(queue), 0);
+   ck_assert_uint_eq(spsc_queue_write_avail(queue), 1000);
+   spsc_queue_free(queue);
+   spsc_queue_free(NULL);
+   ck_assert_ptr_null(spsc_queue_new(0));
+}
+END_TEST
+
+START_TEST (test_spsc_queue_full_empty)
+{
+   uint8_t in[1000], out[1000];
+   spsc_queue_t *queue = spsc_queue_new(1000);
+
+   memset(in, 0x5a, sizeof(in));
+
+   /* Capacity is exact even though storage is a power of two */
+   ck_assert_uint_eq(spsc_queue_write(queue, in, 600), 600);
+   ck_assert_uint_eq(spsc_queue_write(queue, in, 600), 400);
+   ck_assert_uint_eq(spsc_queue_write(queue, in, 1), 0);
+   ck_assert_uint_eq(spsc_queue_write_avail(queue), 0);
+   ck_assert_uint_eq(spsc_queue_read_avail(queue), 1000);
+
+   ck_assert_uint_eq(spsc_queue_read(queue, out, sizeof(out)), 1000);
+   ck_assert_uint_eq(spsc_queue_read(queue, out, 1), 0);
+   ck_assert_uint_eq(spsc_queue_read_avail(queue), 0);
+   ck_assert_int_eq(memcmp(in, out, sizeof(in)), 0);
+
+   spsc_queue_free(queue);
+}
+END_TEST
+
+START_TEST (test_spsc_queue_wrap)
+{
+   unsigned i, j;
+   uint8_t in[100], out[100];
+   uint8_t next_in     = 0;
+   uint8_t next_out    = 0;
+   spsc_queue_t *queue = spsc_queue_new(256);
+
+   /* Odd sizes so reads and writes straddle the end */
+   for (i = 0; i < 1000; i++)
+   {
+      size_t written, read;
+      size_t size = 1 + (i * 37) % sizeof(in);
+
+      for (j = 0; j < size; j++)
+         in[j] = next_in + j;
+      written  = spsc_queue_write(queue, in, size);
+      next_in += written;
+
+      read     = spsc_queue_read(queue, out, 1 + (i * 53) % sizeof(out));
+      for (j = 0; j < read; j++)
+         ck_assert_uint_eq(out[j], (uint8_t)(next_out + j));
+      next_out += read;
+   }
+
+   spsc_queue_clear(queue);
+   ck_assert_uint_eq(spsc_queue_read_avail(queue), 0);
+   ck_assert_uint_eq(spsc_queue_write_avail(queue), 256);
+
+   spsc_queue_free(queue);
+}
+END_TEST
+
+static void spsc_queue_producer(void *data)
+{
+   uint8_t chunk[333];
+   size_t sent         = 0;
+   spsc_queue_t *queue = (spsc_queue_t*)data;
+
+   while (sent < STRESS_BYTES)
+   {
+      size_t i, written;
+      size_t size = sizeof(chunk);
+
+      if (size > STRESS_BYTES - sent)
+         size = STRESS_BYTES - sent;
+      for (i = 0; i < size; i++)
+         chunk[i] = (uint8_t)((sent + i) * 7);
+
+      written = spsc_queue_write(queue, chunk, size);
+      /* Only sends what fit, the rest is sent next time */
+      sent   += written;
+      if (!written)
+         retro_sleep(1);
+   }
+}
+
+START_TEST (test_spsc_queue_threaded)
+{
+   uint8_t chunk[211];
+   sthread_t *producer;
+   size_t received     = 0;
+   bool corrupt        = false;
+   spsc_queue_t *queue = spsc_queue_new(4096);
+
+   producer = sthread_create(spsc_queue_producer, queue);
+   ck_assert_ptr_nonnull(producer);
+
+   while (received < STRESS_BYTES)
+   {
+      size_t i;
+      size_t read = spsc_queue_read(queue, chunk, sizeof(chunk));
+
+      for (i = 0; i < read; i++)
+         if (chunk[i] != (uint8_t)((received + i) * 7))
+            corrupt = true;
+      received += read;
+      if (!read)
+         retro_sleep(1);
+   }
+
+   sthread_join(producer);
+   ck_assert(!corrupt);
+   ck_assert_uint_eq(spsc_queue_read_avail(queue), 0);
+   spsc_queue_free(queue);
+}
+END_TEST
+
+Suite *create_suite(void)
+{
+   Suite *s = suite_create(SUITE_NAME);
+
+   TCase *tc_core = tcase_create("Core");
+   tcase_add_test(tc_core, test_spsc_queue_create);
+   tcase_add_test(tc_core, test_spsc_queue_full_empty);
+   tcase_add_test(tc_core, test_spsc_queue_wrap);
+   tcase_add_test(tc_core, test_spsc_queue_threaded);
+   suite_add_tcase(s, tc_core);
+
+   return s;
+}
+
+int main(void)
+{
+	int num_fail;
+	Suite *s = create_suite();
+	SRunner *sr = srunner_create(s);
+	srunner_run_all(sr, CK_NORMAL);
+	num_fail = srunner_ntests_failed(sr);
+	srunner_free(sr);
+	return (num_fail == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -30,7 +30,10 @@
 #include <errno.h>
 #include <sys/stat.h>
 #include <stdlib.h>
+#include <fcntl.h>
 
+#include <boolean.h>
+#include <memmap.h>
 #include <streams/file_stream.h>
 #include <retro_endianness.h>
 #include <string/stdstring.h>
@@ -83,6 +86,12 @@ struct libretrodb_cursor
    RFILE *fd;
 	libretrodb_query_t *query;
 	libretrodb_t *db;
+   /* When the database could be mapped, items are read from
+    * here instead of fd, and filtered before they are copied */
+   const uint8_t *map;
+   size_t map_size;
+   size_t map_pos;
+   struct rmsgpack_dom_pool pool;
 	int is_valid;
 	int eof;
 };
@@ -361,6 +370,12 @@ int libretrodb_find_entry(libretrodb_t *db, const char *index_name,
 int libretrodb_cursor_reset(libretrodb_cursor_t *cursor)
 {
    cursor->eof = 0;
+   if (cursor->map)
+   {
+      cursor->map_pos = (size_t)(cursor->db->root
+            + sizeof(libretrodb_header_t));
+      return (int)cursor->map_pos;
+   }
    return (int)filestream_seek(cursor->fd,
          (ssize_t)(cursor->db->root + sizeof(libretrodb_header_t)),
          RETRO_VFS_SEEK_POSITION_START);
@@ -374,6 +389,27 @@ int libretrodb_cursor_read_item(libretrodb_cursor_t *cursor,
    if (cursor->eof)
       return EOF;
 
+   if (cursor->map)
+   {
+      struct rmsgpack_dom_value item;
+
+      do
+      {
+         if ((rv = rmsgpack_dom_read_buf(cursor->map, cursor->map_size,
+                     &cursor->map_pos, &cursor->pool, &item)) < 0)
+            return rv;
+
+         if (item.type == RDT_NULL)
+         {
+            cursor->eof = 1;
+            return EOF;
+         }
+      } while (cursor->query
+            && !libretrodb_query_filter(cursor->query, &item));
+
+      return rmsgpack_dom_value_copy(out, &item);
+   }
+
 retry:
    rv = rmsgpack_dom_read(cursor->fd, out);
    if (rv < 0)
@@ -397,6 +433,34 @@ retry:
    return 0;
 }
 
+int64_t libretrodb_cursor_tell(libretrodb_cursor_t *cursor)
+{
+   if (cursor->map)
+      return (int64_t)cursor->map_pos;
+   if (!cursor->fd)
+      return -1;
+   return filestream_tell(cursor->fd);
+}
+
+int libretrodb_cursor_seek(libretrodb_cursor_t *cursor, uint64_t offset)
+{
+   if (cursor->map)
+   {
+      if (offset >= cursor->map_size)
+         return -1;
+      cursor->eof     = 0;
+      cursor->map_pos = (size_t)offset;
+      return 0;
+   }
+   if (!cursor->fd)
+      return -1;
+   cursor->eof = 0;
+   if (filestream_seek(cursor->fd, (int64_t)offset,
+            RETRO_VFS_SEEK_POSITION_START) < 0)
+      return -1;
+   return 0;
+}
+
 /**
  * libretrodb_cursor_close:
  * @cursor              : Handle to database cursor.
@@ -411,16 +475,52 @@ void libretrodb_cursor_close(libretrodb_cursor_t *cursor)
    if (cursor->fd)
       filestream_close(cursor->fd);
 
+#ifdef HAVE_MMAN
+   if (cursor->map)
+      munmap((void*)cursor->map, cursor->map_size);
+#endif
+   rmsgpack_dom_pool_free(&cursor->pool);
+
    if (cursor->query)
       libretrodb_query_free(cursor->query);
 
    cursor->is_valid = 0;
    cursor->eof      = 1;
    cursor->fd       = NULL;
+   cursor->map      = NULL;
+   cursor->map_size = 0;
    cursor->db       = NULL;
    cursor->query    = NULL;
 }
 
+#ifdef HAVE_MMAN
+static bool libretrodb_cursor_map(libretrodb_cursor_t *cursor,
+      const char *path)
+{
+   struct stat st;
+   void *map = MAP_FAILED;
+   int fd    = open(path, O_RDONLY);
+
+   if (fd < 0)
+      return false;
+
+   if (     fstat(fd, &st) == 0
+         && st.st_size > (off_t)sizeof(libretrodb_header_t)
+         && (uint64_t)st.st_size <= (uint64_t)(size_t)-1)
+      map = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+
+   /* The mapping holds its own reference to the file */
+   close(fd);
+
+   if (map == MAP_FAILED)
+      return false;
+
+   cursor->map      = (const uint8_t*)map;
+   cursor->map_size = (size_t)st.st_size;
+   return true;
+}
+#endif
+
 /**
  * libretrodb_cursor_open:
  * @db                  : Handle to database.
@@ -439,12 +539,21 @@ int libretrodb_cursor_open(libretrodb_t *db,
    if (!db || string_is_empty(db->path))
       return -errno;
 
-   fd = filestream_open(db->path,
-         RETRO_VFS_FILE_ACCESS_READ,
-         RETRO_VFS_FILE_ACCESS_HINT_NONE);
+   cursor->map      = NULL;
+   cursor->map_size = 0;
+   memset(&cursor->pool, 0, sizeof(cursor->pool));
 
-   if (!fd)
-      return -errno;
+#ifdef HAVE_MMAN
+   if (!libretrodb_cursor_map(cursor, db->path))
+#endif
+   {
+      fd = filestream_open(db->path,
+            RETRO_VFS_FILE_ACCESS_READ,
+            RETRO_VFS_FILE_ACCESS_HINT_NONE);
+
+      if (!fd)
+         return -errno;
+   }
 
    cursor->fd       = fd;
    cursor->db       = db;
@@ -585,10 +694,15 @@ libretrodb_cursor_t *libretrodb_cursor_new(void)
 
    dbc->is_valid            = 0;
    dbc->fd                  = NULL;
+   dbc->map                 = NULL;
+   dbc->map_size            = 0;
+   dbc->map_pos             = 0;
    dbc->eof                 = 0;
    dbc->query               = NULL;
    dbc->db                  = NULL;
 
+   memset(&dbc->pool, 0, sizeof(dbc->pool));
+
    return dbc;
 }
 
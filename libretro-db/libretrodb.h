@@ -105,6 +105,28 @@ void libretrodb_query_free(void *q);
 int libretrodb_cursor_read_item(libretrodb_cursor_t *cursor,
       struct rmsgpack_dom_value *out);
 
+/**
+ * libretrodb_cursor_tell:
+ * @cursor              : Handle to database cursor.
+ *
+ * Without a query, the next item the cursor reads starts here.
+ *
+ * Returns: offset in the database file, negative on error.
+ **/
+int64_t libretrodb_cursor_tell(libretrodb_cursor_t *cursor);
+
+/**
+ * libretrodb_cursor_seek:
+ * @cursor              : Handle to database cursor.
+ * @offset              : Offset of an item, as returned by
+ *                        libretrodb_cursor_tell().
+ *
+ * Makes @offset the next item the cursor reads.
+ *
+ * Returns: 0 if successful, otherwise negative.
+ **/
+int libretrodb_cursor_seek(libretrodb_cursor_t *cursor, uint64_t offset);
+
 RETRO_END_DECLS
 
 #endif
@@ -243,24 +243,35 @@ static struct rmsgpack_dom_value query_func_glob(
       unsigned argc, const struct argument * argv)
 {
    struct rmsgpack_dom_value res;
-   unsigned i    = 0;
+   char tmp[256];
+   char *str     = tmp;
 
    res.type      = RDT_BOOL;
    res.val.bool_ = 0;
 
-   (void)i;
-
    if (argc != 1)
       return res;
    if (argv[0].type != AT_VALUE || argv[0].a.value.type != RDT_STRING)
       return res;
    if (input.type != RDT_STRING)
       return res;
+
+   /* Strings read in place from a mapped database
+    * are not NUL-terminated */
+   if (     input.val.string.len >= sizeof(tmp)
+         && !(str = (char*)malloc(input.val.string.len + 1)))
+      return res;
+   memcpy(str, input.val.string.buff, input.val.string.len);
+   str[input.val.string.len] = '\0';
+
    res.val.bool_ = rl_fnmatch(
          argv[0].a.value.val.string.buff,
-         input.val.string.buff,
+         str,
          0
          ) == 0;
+
+   if (str != tmp)
+      free(str);
    return res;
 }
 
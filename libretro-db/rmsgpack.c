@@ -658,3 +658,243 @@ int rmsgpack_read(RFILE *fd,
 error:
    return -errno;
 }
+
+static int buf_read_uint(const uint8_t *buf, size_t len, size_t *pos,
+      uint64_t *out, size_t size)
+{
+   union { uint64_t u64; uint32_t u32; uint16_t u16; uint8_t u8; } tmp;
+
+   if (len - *pos < size)
+      return -EINVAL;
+
+   memcpy(&tmp, buf + *pos, size);
+   *pos += size;
+
+   switch (size)
+   {
+      case 1:
+         *out = tmp.u8;
+         break;
+      case 2:
+         *out = swap_if_little16(tmp.u16);
+         break;
+      case 4:
+         *out = swap_if_little32(tmp.u32);
+         break;
+      case 8:
+         *out = swap_if_little64(tmp.u64);
+         break;
+   }
+   return 0;
+}
+
+static int buf_read_int(const uint8_t *buf, size_t len, size_t *pos,
+      int64_t *out, size_t size)
+{
+   uint64_t tmp = 0;
+
+   if (buf_read_uint(buf, len, pos, &tmp, size) < 0)
+      return -EINVAL;
+
+   switch (size)
+   {
+      case 1:
+         *out = (int8_t)tmp;
+         break;
+      case 2:
+         *out = (int16_t)tmp;
+         break;
+      case 4:
+         *out = (int32_t)tmp;
+         break;
+      case 8:
+         *out = (int64_t)tmp;
+         break;
+   }
+   return 0;
+}
+
+static int buf_read_buff(const uint8_t *buf, size_t len, size_t *pos,
+      uint64_t size_len, char **pbuff, uint64_t *out_len)
+{
+   if (     size_len
+         && buf_read_uint(buf, len, pos, out_len, (size_t)size_len) < 0)
+      return -EINVAL;
+
+   if (len - *pos < *out_len)
+      return -EINVAL;
+
+   *pbuff  = (char*)buf + *pos;
+   *pos   += (size_t)*out_len;
+   return 0;
+}
+
+/**
+ * rmsgpack_read_buf:
+ * @buf                 : msgpack data.
+ * @len                 : size of @buf.
+ * @pos                 : offset in @buf of the object to read, moved
+ *                        past it.
+ * @callbacks           : callbacks, all of which may be NULL to
+ *                        skip the object.
+ * @data                : passed to the callbacks.
+ *
+ * Like rmsgpack_read(), but strings and binaries are handed to the
+ * callbacks in place: they point into @buf, are not NUL-terminated
+ * and must not be freed.
+ *
+ * Returns: 0 if successful, otherwise negative.
+ **/
+int rmsgpack_read_buf(const uint8_t *buf, size_t len, size_t *pos,
+      struct rmsgpack_read_callbacks *callbacks, void *data)
+{
+   int rv;
+   unsigned i;
+   uint64_t tmp_len  = 0;
+   uint64_t tmp_uint = 0;
+   int64_t tmp_int   = 0;
+   uint8_t type      = 0;
+   char *buff        = NULL;
+
+   if (*pos >= len)
+      return -EINVAL;
+
+   type = buf[(*pos)++];
+
+   if (type < MPF_FIXMAP)
+   {
+      if (!callbacks->read_int)
+         return 0;
+      return callbacks->read_int(type, data);
+   }
+   else if (type < MPF_FIXARRAY)
+   {
+      tmp_len = type - MPF_FIXMAP;
+      goto map;
+   }
+   else if (type < MPF_FIXSTR)
+   {
+      tmp_len = type - MPF_FIXARRAY;
+      goto array;
+   }
+   else if (type < MPF_NIL)
+   {
+      tmp_len = type - MPF_FIXSTR;
+      if (buf_read_buff(buf, len, pos, 0, &buff, &tmp_len) < 0)
+         return -EINVAL;
+      if (!callbacks->read_string)
+         return 0;
+      return callbacks->read_string(buff, (uint32_t)tmp_len, data);
+   }
+   else if (type > MPF_MAP32)
+   {
+      if (!callbacks->read_int)
+         return 0;
+      return callbacks->read_int(type - 0xff - 1, data);
+   }
+
+   switch (type)
+   {
+      case _MPF_NIL:
+         if (callbacks->read_nil)
+            return callbacks->read_nil(data);
+         break;
+      case _MPF_FALSE:
+         if (callbacks->read_bool)
+            return callbacks->read_bool(0, data);
+         break;
+      case _MPF_TRUE:
+         if (callbacks->read_bool)
+            return callbacks->read_bool(1, data);
+         break;
+      case _MPF_BIN8:
+      case _MPF_BIN16:
+      case _MPF_BIN32:
+         if (buf_read_buff(buf, len, pos, (uint64_t)1 << (type - _MPF_BIN8),
+                  &buff, &tmp_len) < 0)
+            return -EINVAL;
+
+         if (callbacks->read_bin)
+            return callbacks->read_bin(buff, (uint32_t)tmp_len, data);
+         break;
+      case _MPF_UINT8:
+      case _MPF_UINT16:
+      case _MPF_UINT32:
+      case _MPF_UINT64:
+         if (buf_read_uint(buf, len, pos, &tmp_uint,
+                  (size_t)1 << (type - _MPF_UINT8)) < 0)
+            return -EINVAL;
+
+         if (callbacks->read_uint)
+            return callbacks->read_uint(tmp_uint, data);
+         break;
+      case _MPF_INT8:
+      case _MPF_INT16:
+      case _MPF_INT32:
+      case _MPF_INT64:
+         if (buf_read_int(buf, len, pos, &tmp_int,
+                  (size_t)1 << (type - _MPF_INT8)) < 0)
+            return -EINVAL;
+
+         if (callbacks->read_int)
+            return callbacks->read_int(tmp_int, data);
+         break;
+      case _MPF_STR8:
+      case _MPF_STR16:
+      case _MPF_STR32:
+         if (buf_read_buff(buf, len, pos, (uint64_t)1 << (type - _MPF_STR8),
+                  &buff, &tmp_len) < 0)
+            return -EINVAL;
+
+         if (callbacks->read_string)
+            return callbacks->read_string(buff, (uint32_t)tmp_len, data);
+         break;
+      case _MPF_ARRAY16:
+      case _MPF_ARRAY32:
+         if (buf_read_uint(buf, len, pos, &tmp_len,
+                  (size_t)2 << (type - _MPF_ARRAY16)) < 0)
+            return -EINVAL;
+         goto array;
+      case _MPF_MAP16:
+      case _MPF_MAP32:
+         if (buf_read_uint(buf, len, pos, &tmp_len,
+                  (size_t)2 << (type - _MPF_MAP16)) < 0)
+            return -EINVAL;
+         goto map;
+   }
+
+   return 0;
+
+map:
+   /* Every pair takes at least two bytes */
+   if (tmp_len > (len - *pos) / 2)
+      return -EINVAL;
+
+   if (callbacks->read_map_start &&
+         (rv = callbacks->read_map_start((uint32_t)tmp_len, data)) < 0)
+      return rv;
+
+   for (i = 0; i < tmp_len; i++)
+   {
+      if ((rv = rmsgpack_read_buf(buf, len, pos, callbacks, data)) < 0)
+         return rv;
+      if ((rv = rmsgpack_read_buf(buf, len, pos, callbacks, data)) < 0)
+         return rv;
+   }
+   return 0;
+
+array:
+   if (tmp_len > len - *pos)
+      return -EINVAL;
+
+   if (callbacks->read_array_start &&
+         (rv = callbacks->read_array_start((uint32_t)tmp_len, data)) < 0)
+      return rv;
+
+   for (i = 0; i < tmp_len; i++)
+   {
+      if ((rv = rmsgpack_read_buf(buf, len, pos, callbacks, data)) < 0)
+         return rv;
+   }
+   return 0;
+}
@@ -24,6 +24,7 @@
 #define __LIBRETRODB_MSGPACK_H__
 
 #include <stdint.h>
+#include <stddef.h>
 
 #include <streams/file_stream.h>
 
@@ -57,4 +58,7 @@ int rmsgpack_write_uint(RFILE *fd, uint64_t value );
 
 int rmsgpack_read(RFILE *fd, struct rmsgpack_read_callbacks *callbacks, void *data);
 
+int rmsgpack_read_buf(const uint8_t *buf, size_t len, size_t *pos,
+      struct rmsgpack_read_callbacks *callbacks, void *data);
+
 #endif
@@ -33,10 +33,15 @@
 
 #define MAX_DEPTH 128
 
+/* Returned while reading into a pool that is too small;
+ * not an errno value, it never leaves this file */
+#define DOM_POOL_FULL (-0x7fff)
+
 struct dom_reader_state
 {
 	int i;
 	struct rmsgpack_dom_value *stack[MAX_DEPTH];
+	struct rmsgpack_dom_pool *pool; /* NULL to allocate maps and arrays */
 };
 
 static struct rmsgpack_dom_value *dom_reader_state_pop(
@@ -134,8 +139,19 @@ static int dom_read_map_start(uint32_t len, void *data)
    v->val.map.len                     = len;
    v->val.map.items                   = NULL;
 
-   items                              = (struct rmsgpack_dom_pair *)
-      calloc(len, sizeof(struct rmsgpack_dom_pair));
+   if (dom_state->pool)
+   {
+      if (!len)
+         return 0;
+      if (len > dom_state->pool->pairs_size - dom_state->pool->pairs_used)
+         return DOM_POOL_FULL;
+      items                           = dom_state->pool->pairs
+         + dom_state->pool->pairs_used;
+      dom_state->pool->pairs_used    += len;
+   }
+   else
+      items                           = (struct rmsgpack_dom_pair *)
+         calloc(len, sizeof(struct rmsgpack_dom_pair));
 
    if (!items)
       return -ENOMEM;
@@ -164,8 +180,19 @@ static int dom_read_array_start(uint32_t len, void *data)
 	v->val.array.len                   = len;
 	v->val.array.items                 = NULL;
 
-	items                              = (struct rmsgpack_dom_value *)
-      calloc(len, sizeof(*items));
+   if (dom_state->pool)
+   {
+      if (!len)
+         return 0;
+      if (len > dom_state->pool->values_size - dom_state->pool->values_used)
+         return DOM_POOL_FULL;
+      items                           = dom_state->pool->values
+         + dom_state->pool->values_used;
+      dom_state->pool->values_used   += len;
+   }
+   else
+      items                           = (struct rmsgpack_dom_value *)
+         calloc(len, sizeof(*items));
 
 	if (!items)
 		return -ENOMEM;
@@ -414,6 +441,7 @@ int rmsgpack_dom_read(RFILE *fd, struct rmsgpack_dom_value *out)
 
    s.i        = 0;
    s.stack[0] = out;
+   s.pool     = NULL;
 
    rv         = rmsgpack_read(fd, &dom_reader_callbacks, &s);
 
@@ -505,3 +533,200 @@ clean:
    rmsgpack_dom_value_free(&map);
    return 0;
 }
+
+struct dom_pool_count
+{
+   size_t pairs;
+   size_t values;
+};
+
+static int dom_count_map_start(uint32_t len, void *data)
+{
+   ((struct dom_pool_count*)data)->pairs += len;
+   return 0;
+}
+
+static int dom_count_array_start(uint32_t len, void *data)
+{
+   ((struct dom_pool_count*)data)->values += len;
+   return 0;
+}
+
+static struct rmsgpack_read_callbacks dom_count_callbacks = {
+	NULL,
+	NULL,
+	NULL,
+	NULL,
+	NULL,
+	NULL,
+	dom_count_map_start,
+	dom_count_array_start
+};
+
+static int dom_pool_reserve(struct rmsgpack_dom_pool *pool,
+      const struct dom_pool_count *count)
+{
+   if (count->pairs > pool->pairs_size)
+   {
+      size_t size                     = pool->pairs_size * 2;
+      struct rmsgpack_dom_pair *pairs = NULL;
+
+      if (size < count->pairs)
+         size = count->pairs;
+
+      if (!(pairs = (struct rmsgpack_dom_pair*)
+               realloc(pool->pairs, size * sizeof(*pairs))))
+         return -ENOMEM;
+
+      pool->pairs      = pairs;
+      pool->pairs_size = size;
+   }
+
+   if (count->values > pool->values_size)
+   {
+      size_t size                       = pool->values_size * 2;
+      struct rmsgpack_dom_value *values = NULL;
+
+      if (size < count->values)
+         size = count->values;
+
+      if (!(values = (struct rmsgpack_dom_value*)
+               realloc(pool->values, size * sizeof(*values))))
+         return -ENOMEM;
+
+      pool->values      = values;
+      pool->values_size = size;
+   }
+
+   pool->pairs_used  = 0;
+   pool->values_used = 0;
+   return 0;
+}
+
+int rmsgpack_dom_read_buf(const uint8_t *buf, size_t len, size_t *pos,
+      struct rmsgpack_dom_pool *pool, struct rmsgpack_dom_value *out)
+{
+   int rv;
+   struct dom_reader_state s;
+   struct dom_pool_count count;
+   size_t start      = *pos;
+
+   s.i               = 0;
+   s.stack[0]        = out;
+   s.pool            = pool;
+   pool->pairs_used  = 0;
+   pool->values_used = 0;
+
+   if ((rv = rmsgpack_read_buf(buf, len, pos,
+               &dom_reader_callbacks, &s)) != DOM_POOL_FULL)
+      return rv;
+
+   /* The pool is too small for this object. Size it first and
+    * read again, rather than move what was read already. */
+   count.pairs       = 0;
+   count.values      = 0;
+   *pos              = start;
+
+   if ((rv = rmsgpack_read_buf(buf, len, pos,
+               &dom_count_callbacks, &count)) < 0)
+      return rv;
+
+   if ((rv = dom_pool_reserve(pool, &count)) < 0)
+      return rv;
+
+   *pos              = start;
+   s.i               = 0;
+   s.stack[0]        = out;
+
+   return rmsgpack_read_buf(buf, len, pos, &dom_reader_callbacks, &s);
+}
+
+void rmsgpack_dom_pool_free(struct rmsgpack_dom_pool *pool)
+{
+   free(pool->pairs);
+   free(pool->values);
+   pool->pairs       = NULL;
+   pool->values      = NULL;
+   pool->pairs_size  = 0;
+   pool->values_size = 0;
+   pool->pairs_used  = 0;
+   pool->values_used = 0;
+}
+
+int rmsgpack_dom_value_copy(struct rmsgpack_dom_value *dst,
+      const struct rmsgpack_dom_value *src)
+{
+   unsigned i;
+
+   *dst = *src;
+
+   switch (src->type)
+   {
+      case RDT_STRING:
+         if (!(dst->val.string.buff = (char*)
+                  malloc(src->val.string.len + 1)))
+            break;
+         memcpy(dst->val.string.buff, src->val.string.buff,
+               src->val.string.len);
+         dst->val.string.buff[src->val.string.len] = '\0';
+         return 0;
+      case RDT_BINARY:
+         if (!(dst->val.binary.buff = (char*)
+                  malloc(src->val.binary.len + 1)))
+            break;
+         memcpy(dst->val.binary.buff, src->val.binary.buff,
+               src->val.binary.len);
+         dst->val.binary.buff[src->val.binary.len] = '\0';
+         return 0;
+      case RDT_MAP:
+         if (!src->val.map.len)
+         {
+            dst->val.map.items = NULL;
+            return 0;
+         }
+         if (!(dst->val.map.items = (struct rmsgpack_dom_pair*)
+                  calloc(src->val.map.len, sizeof(*dst->val.map.items))))
+            break;
+         for (i = 0; i < src->val.map.len; i++)
+         {
+            if (     rmsgpack_dom_value_copy(&dst->val.map.items[i].key,
+                        &src->val.map.items[i].key) < 0
+                  || rmsgpack_dom_value_copy(&dst->val.map.items[i].value,
+                        &src->val.map.items[i].value) < 0)
+            {
+               rmsgpack_dom_value_free(dst);
+               break;
+            }
+         }
+         if (i < src->val.map.len)
+            break;
+         return 0;
+      case RDT_ARRAY:
+         if (!src->val.array.len)
+         {
+            dst->val.array.items = NULL;
+            return 0;
+         }
+         if (!(dst->val.array.items = (struct rmsgpack_dom_value*)
+                  calloc(src->val.array.len, sizeof(*dst->val.array.items))))
+            break;
+         for (i = 0; i < src->val.array.len; i++)
+         {
+            if (rmsgpack_dom_value_copy(&dst->val.array.items[i],
+                     &src->val.array.items[i]) < 0)
+            {
+               rmsgpack_dom_value_free(dst);
+               break;
+            }
+         }
+         if (i < src->val.array.len)
+            break;
+         return 0;
+      default:
+         return 0;
+   }
+
+   /* Out of memory; a failed copy holds nothing to free */
+   dst->type = RDT_NULL;
+   return -ENOMEM;
+}
@@ -24,6 +24,7 @@
 #define __LIBRETRODB_MSGPACK_DOM_H__
 
 #include <stdint.h>
+#include <stddef.h>
 
 #include <retro_common_api.h>
 #include <streams/file_stream.h>
@@ -79,6 +80,19 @@ struct rmsgpack_dom_pair
 	struct rmsgpack_dom_value value; /* uint64_t alignment */
 };
 
+/* Storage for the maps and arrays of the values read by
+ * rmsgpack_dom_read_buf(), reused from one read to the next.
+ * Zero it before the first read. */
+struct rmsgpack_dom_pool
+{
+   struct rmsgpack_dom_pair *pairs;
+   struct rmsgpack_dom_value *values;
+   size_t pairs_size;
+   size_t values_size;
+   size_t pairs_used;
+   size_t values_used;
+};
+
 void rmsgpack_dom_value_print(struct rmsgpack_dom_value *obj);
 void rmsgpack_dom_value_free(struct rmsgpack_dom_value *v);
 
@@ -95,6 +109,38 @@ int rmsgpack_dom_write(RFILE *fd, const struct rmsgpack_dom_value *obj);
 
 int rmsgpack_dom_read_into(RFILE *fd, ...);
 
+/**
+ * rmsgpack_dom_read_buf:
+ * @buf                 : msgpack data.
+ * @len                 : size of @buf.
+ * @pos                 : offset in @buf of the object to read, moved
+ *                        past it.
+ * @pool                : storage for the maps and arrays.
+ * @out                 : the object.
+ *
+ * Reads an object without copying it: its strings and binaries
+ * point into @buf and are not NUL-terminated, its maps and arrays
+ * into @pool. It stays valid until the next read with @pool and
+ * must not be freed; rmsgpack_dom_value_copy() makes one that can.
+ *
+ * Returns: 0 if successful, otherwise negative.
+ **/
+int rmsgpack_dom_read_buf(const uint8_t *buf, size_t len, size_t *pos,
+      struct rmsgpack_dom_pool *pool, struct rmsgpack_dom_value *out);
+
+void rmsgpack_dom_pool_free(struct rmsgpack_dom_pool *pool);
+
+/**
+ * rmsgpack_dom_value_copy:
+ * @dst                 : the copy, to be freed with
+ *                        rmsgpack_dom_value_free().
+ * @src                 : object to copy.
+ *
+ * Returns: 0 if successful, otherwise negative.
+ **/
+int rmsgpack_dom_value_copy(struct rmsgpack_dom_value *dst,
+      const struct rmsgpack_dom_value *src);
+
 RETRO_END_DECLS
 
 #endif
@@ -434,6 +434,7 @@ DEFAULT_SUBLABEL_MACRO(action_bind_sublabel_add_content_list,              MENU_
 DEFAULT_SUBLABEL_MACRO(action_bind_sublabel_video_frame_delay,             MENU_ENUM_SUBLABEL_VIDEO_FRAME_DELAY)
 DEFAULT_SUBLABEL_MACRO(action_bind_sublabel_video_frame_delay_auto,        MENU_ENUM_SUBLABEL_VIDEO_FRAME_DELAY_AUTO)
 DEFAULT_SUBLABEL_MACRO(action_bind_sublabel_video_shader_delay,            MENU_ENUM_SUBLABEL_VIDEO_SHADER_DELAY)
+DEFAULT_SUBLABEL_MACRO(action_bind_sublabel_video_shader_cache_size,       MENU_ENUM_SUBLABEL_VIDEO_SHADER_CACHE_SIZE)
 DEFAULT_SUBLABEL_MACRO(action_bind_sublabel_video_black_frame_insertion,   MENU_ENUM_SUBLABEL_VIDEO_BLACK_FRAME_INSERTION)
 DEFAULT_SUBLABEL_MACRO(action_bind_sublabel_systeminfo_cpu_cores,          MENU_ENUM_SUBLABEL_CPU_CORES)
 DEFAULT_SUBLABEL_MACRO(action_bind_sublabel_toggle_gamepad_combo,          MENU_ENUM_SUBLABEL_INPUT_MENU_ENUM_TOGGLE_GAMEPAD_COMBO)
@@ -517,6 +518,7 @@ DEFAULT_SUBLABEL_MACRO(action_bind_sublabel_quit_press_twice,              MENU_
 DEFAULT_SUBLABEL_MACRO(action_bind_sublabel_onscreen_notifications_enable, MENU_ENUM_SUBLABEL_VIDEO_FONT_ENABLE)
 DEFAULT_SUBLABEL_MACRO(action_bind_sublabel_video_crop_overscan,           MENU_ENUM_SUBLABEL_VIDEO_CROP_OVERSCAN)
 DEFAULT_SUBLABEL_MACRO(action_bind_sublabel_video_filter,                  MENU_ENUM_SUBLABEL_VIDEO_FILTER)
+DEFAULT_SUBLABEL_MACRO(action_bind_sublabel_video_filter_threads,          MENU_ENUM_SUBLABEL_VIDEO_FILTER_THREADS)
 DEFAULT_SUBLABEL_MACRO(action_bind_sublabel_video_filter_remove,           MENU_ENUM_SUBLABEL_VIDEO_FILTER_REMOVE)
 DEFAULT_SUBLABEL_MACRO(action_bind_sublabel_netplay_nickname,              MENU_ENUM_SUBLABEL_NETPLAY_NICKNAME)
 DEFAULT_SUBLABEL_MACRO(action_bind_sublabel_cheevos_username,              MENU_ENUM_SUBLABEL_CHEEVOS_USERNAME)
@@ -604,6 +606,8 @@ DEFAULT_SUBLABEL_MACRO(action_bind_sublabel_content_collection_list,       MENU_
 DEFAULT_SUBLABEL_MACRO(action_bind_sublabel_video_scale_integer,           MENU_ENUM_SUBLABEL_VIDEO_SCALE_INTEGER)
 DEFAULT_SUBLABEL_MACRO(action_bind_sublabel_video_scale_integer_overscale, MENU_ENUM_SUBLABEL_VIDEO_SCALE_INTEGER_OVERSCALE)
 DEFAULT_SUBLABEL_MACRO(action_bind_sublabel_video_gpu_screenshot,          MENU_ENUM_SUBLABEL_VIDEO_GPU_SCREENSHOT)
+DEFAULT_SUBLABEL_MACRO(action_bind_sublabel_video_frame_diff,              MENU_ENUM_SUBLABEL_VIDEO_FRAME_DIFF)
+DEFAULT_SUBLABEL_MACRO(action_bind_sublabel_video_upload_ring,             MENU_ENUM_SUBLABEL_VIDEO_UPLOAD_RING)
 DEFAULT_SUBLABEL_MACRO(action_bind_sublabel_video_rotation,                MENU_ENUM_SUBLABEL_VIDEO_ROTATION)
 DEFAULT_SUBLABEL_MACRO(action_bind_sublabel_screen_orientation,            MENU_ENUM_SUBLABEL_SCREEN_ORIENTATION)
 DEFAULT_SUBLABEL_MACRO(action_bind_sublabel_video_force_srgb_enable,       MENU_ENUM_SUBLABEL_VIDEO_FORCE_SRGB_DISABLE)
@@ -619,8 +623,13 @@ DEFAULT_SUBLABEL_MACRO(action_bind_sublabel_slowmotion_ratio,              MENU_
 DEFAULT_SUBLABEL_MACRO(action_bind_sublabel_run_ahead_unsupported,         MENU_ENUM_SUBLABEL_RUN_AHEAD_UNSUPPORTED)
 DEFAULT_SUBLABEL_MACRO(action_bind_sublabel_run_ahead_enabled,             MENU_ENUM_SUBLABEL_RUN_AHEAD_ENABLED)
 DEFAULT_SUBLABEL_MACRO(action_bind_sublabel_run_ahead_secondary_instance,  MENU_ENUM_SUBLABEL_RUN_AHEAD_SECONDARY_INSTANCE)
+DEFAULT_SUBLABEL_MACRO(action_bind_sublabel_run_ahead_secondary_threaded,  MENU_ENUM_SUBLABEL_RUN_AHEAD_SECONDARY_THREADED)
+DEFAULT_SUBLABEL_MACRO(action_bind_sublabel_run_ahead_preemptive_frames,   MENU_ENUM_SUBLABEL_RUN_AHEAD_PREEMPTIVE_FRAMES)
 DEFAULT_SUBLABEL_MACRO(action_bind_sublabel_run_ahead_hide_warnings,       MENU_ENUM_SUBLABEL_RUN_AHEAD_HIDE_WARNINGS)
 DEFAULT_SUBLABEL_MACRO(action_bind_sublabel_run_ahead_frames,              MENU_ENUM_SUBLABEL_RUN_AHEAD_FRAMES)
+DEFAULT_SUBLABEL_MACRO(action_bind_sublabel_frame_profiler_enable,         MENU_ENUM_SUBLABEL_FRAME_PROFILER_ENABLE)
+DEFAULT_SUBLABEL_MACRO(action_bind_sublabel_frame_profiler_show_graph,     MENU_ENUM_SUBLABEL_FRAME_PROFILER_SHOW_GRAPH)
+DEFAULT_SUBLABEL_MACRO(action_bind_sublabel_frame_profiler_export,         MENU_ENUM_SUBLABEL_FRAME_PROFILER_EXPORT)
 DEFAULT_SUBLABEL_MACRO(action_bind_sublabel_input_block_timeout,           MENU_ENUM_SUBLABEL_INPUT_BLOCK_TIMEOUT)
 DEFAULT_SUBLABEL_MACRO(action_bind_sublabel_rewind,                        MENU_ENUM_SUBLABEL_REWIND_ENABLE)
 #ifdef HAVE_CHEATS
@@ -662,6 +671,9 @@ DEFAULT_SUBLABEL_MACRO(action_bind_sublabel_cheat_file_load_append,        MENU_
 DEFAULT_SUBLABEL_MACRO(action_bind_sublabel_cheat_file_save_as,            MENU_ENUM_SUBLABEL_CHEAT_FILE_SAVE_AS)
 #endif
 DEFAULT_SUBLABEL_MACRO(action_bind_sublabel_rewind_granularity,            MENU_ENUM_SUBLABEL_REWIND_GRANULARITY)
+DEFAULT_SUBLABEL_MACRO(action_bind_sublabel_rewind_compression_threads,    MENU_ENUM_SUBLABEL_REWIND_COMPRESSION_THREADS)
+DEFAULT_SUBLABEL_MACRO(action_bind_sublabel_rewind_cold_buffer_size,       MENU_ENUM_SUBLABEL_REWIND_COLD_BUFFER_SIZE)
+DEFAULT_SUBLABEL_MACRO(action_bind_sublabel_rewind_spill_size,             MENU_ENUM_SUBLABEL_REWIND_SPILL_SIZE)
 DEFAULT_SUBLABEL_MACRO(action_bind_sublabel_rewind_buffer_size,            MENU_ENUM_SUBLABEL_REWIND_BUFFER_SIZE)
 DEFAULT_SUBLABEL_MACRO(action_bind_sublabel_rewind_buffer_size_step,       MENU_ENUM_SUBLABEL_REWIND_BUFFER_SIZE_STEP)
 DEFAULT_SUBLABEL_MACRO(action_bind_sublabel_libretro_log_level,            MENU_ENUM_SUBLABEL_LIBRETRO_LOG_LEVEL)
@@ -3426,6 +3438,15 @@ int menu_cbs_init_bind_sublabel(menu_file_list_cbs_t *cbs,
          case MENU_ENUM_LABEL_REWIND_GRANULARITY:
             BIND_ACTION_SUBLABEL(cbs, action_bind_sublabel_rewind_granularity);
             break;
+         case MENU_ENUM_LABEL_REWIND_COMPRESSION_THREADS:
+            BIND_ACTION_SUBLABEL(cbs, action_bind_sublabel_rewind_compression_threads);
+            break;
+         case MENU_ENUM_LABEL_REWIND_COLD_BUFFER_SIZE:
+            BIND_ACTION_SUBLABEL(cbs, action_bind_sublabel_rewind_cold_buffer_size);
+            break;
+         case MENU_ENUM_LABEL_REWIND_SPILL_SIZE:
+            BIND_ACTION_SUBLABEL(cbs, action_bind_sublabel_rewind_spill_size);
+            break;
          case MENU_ENUM_LABEL_REWIND_BUFFER_SIZE:
             BIND_ACTION_SUBLABEL(cbs, action_bind_sublabel_rewind_buffer_size);
             break;
@@ -3564,12 +3585,27 @@ int menu_cbs_init_bind_sublabel(menu_file_list_cbs_t *cbs,
          case MENU_ENUM_LABEL_RUN_AHEAD_SECONDARY_INSTANCE:
             BIND_ACTION_SUBLABEL(cbs, action_bind_sublabel_run_ahead_secondary_instance);
             break;
+         case MENU_ENUM_LABEL_RUN_AHEAD_SECONDARY_THREADED:
+            BIND_ACTION_SUBLABEL(cbs, action_bind_sublabel_run_ahead_secondary_threaded);
+            break;
+         case MENU_ENUM_LABEL_RUN_AHEAD_PREEMPTIVE_FRAMES:
+            BIND_ACTION_SUBLABEL(cbs, action_bind_sublabel_run_ahead_preemptive_frames);
+            break;
          case MENU_ENUM_LABEL_RUN_AHEAD_HIDE_WARNINGS:
             BIND_ACTION_SUBLABEL(cbs, action_bind_sublabel_run_ahead_hide_warnings);
             break;
          case MENU_ENUM_LABEL_RUN_AHEAD_FRAMES:
             BIND_ACTION_SUBLABEL(cbs, action_bind_sublabel_run_ahead_frames);
             break;
+         case MENU_ENUM_LABEL_FRAME_PROFILER_ENABLE:
+            BIND_ACTION_SUBLABEL(cbs, action_bind_sublabel_frame_profiler_enable);
+            break;
+         case MENU_ENUM_LABEL_FRAME_PROFILER_SHOW_GRAPH:
+            BIND_ACTION_SUBLABEL(cbs, action_bind_sublabel_frame_profiler_show_graph);
+            break;
+         case MENU_ENUM_LABEL_FRAME_PROFILER_EXPORT:
+            BIND_ACTION_SUBLABEL(cbs, action_bind_sublabel_frame_profiler_export);
+            break;
          case MENU_ENUM_LABEL_INPUT_BLOCK_TIMEOUT:
             BIND_ACTION_SUBLABEL(cbs, action_bind_sublabel_input_block_timeout);
             break;
@@ -3609,6 +3645,12 @@ int menu_cbs_init_bind_sublabel(menu_file_list_cbs_t *cbs,
          case MENU_ENUM_LABEL_VIDEO_GPU_SCREENSHOT:
             BIND_ACTION_SUBLABEL(cbs, action_bind_sublabel_video_gpu_screenshot);
             break;
+         case MENU_ENUM_LABEL_VIDEO_FRAME_DIFF:
+            BIND_ACTION_SUBLABEL(cbs, action_bind_sublabel_video_frame_diff);
+            break;
+         case MENU_ENUM_LABEL_VIDEO_UPLOAD_RING:
+            BIND_ACTION_SUBLABEL(cbs, action_bind_sublabel_video_upload_ring);
+            break;
          case MENU_ENUM_LABEL_VIDEO_SCALE_INTEGER:
             BIND_ACTION_SUBLABEL(cbs, action_bind_sublabel_video_scale_integer);
             break;
@@ -3814,6 +3856,9 @@ int menu_cbs_init_bind_sublabel(menu_file_list_cbs_t *cbs,
          case MENU_ENUM_LABEL_VIDEO_FILTER:
             BIND_ACTION_SUBLABEL(cbs, action_bind_sublabel_video_filter);
             break;
+         case MENU_ENUM_LABEL_VIDEO_FILTER_THREADS:
+            BIND_ACTION_SUBLABEL(cbs, action_bind_sublabel_video_filter_threads);
+            break;
          case MENU_ENUM_LABEL_VIDEO_FILTER_REMOVE:
             BIND_ACTION_SUBLABEL(cbs, action_bind_sublabel_video_filter_remove);
             break;
@@ -4109,6 +4154,9 @@ int menu_cbs_init_bind_sublabel(menu_file_list_cbs_t *cbs,
          case MENU_ENUM_LABEL_VIDEO_SHADER_DELAY:
             BIND_ACTION_SUBLABEL(cbs, action_bind_sublabel_video_shader_delay);
             break;
+         case MENU_ENUM_LABEL_VIDEO_SHADER_CACHE_SIZE:
+            BIND_ACTION_SUBLABEL(cbs, action_bind_sublabel_video_shader_cache_size);
+            break;
          case MENU_ENUM_LABEL_ADD_CONTENT_LIST:
             BIND_ACTION_SUBLABEL(cbs, action_bind_sublabel_add_content_list);
             break;
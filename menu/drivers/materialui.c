@@ -2446,6 +2446,8 @@ static void materialui_context_reset_textures(materialui_handle_t *mui)
          icon_path, sizeof(icon_path),
          APPLICATION_SPECIAL_DIRECTORY_ASSETS_MATERIALUI_ICONS);
 
+   gfx_display_atlas_begin(disp_get_ptr(), TEXTURE_FILTER_MIPMAP_LINEAR);
+
    /* Loop through all textures */
    for (i = 0; i < MUI_TEXTURE_LAST; i++)
    {
@@ -2459,6 +2461,8 @@ static void materialui_context_reset_textures(materialui_handle_t *mui)
       }
    }
 
+   gfx_display_atlas_end(disp_get_ptr());
+
    /* Warn user if assets are missing */
    if (!has_all_assets)
       runloop_msg_queue_push(
@@ -8226,6 +8230,7 @@ static void materialui_context_destroy(void *data)
       return;
 
    /* Free standard menu textures */
+   gfx_display_atlas_free(disp_get_ptr());
    for (i = 0; i < MUI_TEXTURE_LAST; i++)
       video_driver_texture_unload(&mui->textures.list[i]);
 
@@ -7723,6 +7723,8 @@ static void ozone_context_reset(void *data, bool is_threaded)
 
       ozone_set_layout(ozone, settings, is_threaded);
 
+      gfx_display_atlas_begin(disp_get_ptr(), TEXTURE_FILTER_MIPMAP_LINEAR);
+
       /* Textures init */
       for (i = 0; i < OZONE_TEXTURE_LAST; i++)
       {
@@ -7791,6 +7793,8 @@ static void ozone_context_reset(void *data, bool is_threaded)
          }
       }
 
+      gfx_display_atlas_end(disp_get_ptr());
+
       gfx_display_deinit_white_texture();
       gfx_display_init_white_texture();
 
@@ -7866,6 +7870,8 @@ static void ozone_context_destroy(void *data)
    /* Theme */
    ozone_unload_theme_textures(ozone);
 
+   gfx_display_atlas_free(disp_get_ptr());
+
    /* Icons */
    for (i = 0; i < OZONE_ENTRIES_ICONS_TEXTURE_LAST; i++)
       video_driver_texture_unload(&ozone->icons_textures[i]);
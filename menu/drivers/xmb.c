@@ -6345,6 +6345,8 @@ static void xmb_context_reset_textures(
    gfx_display_deinit_white_texture();
    gfx_display_init_white_texture();
 
+   gfx_display_atlas_begin(disp_get_ptr(), TEXTURE_FILTER_MIPMAP_LINEAR);
+
    for (i = 0; i < XMB_TEXTURE_LAST; i++)
    {
       if (!gfx_display_reset_textures_list(xmb_texture_path(i), iconpath, &xmb->textures.list[i], TEXTURE_FILTER_MIPMAP_LINEAR, NULL, NULL))
@@ -6389,6 +6391,8 @@ static void xmb_context_reset_textures(
       }
    }
 
+   gfx_display_atlas_end(disp_get_ptr());
+
    xmb->main_menu_node.icon     = xmb->textures.list[XMB_TEXTURE_MAIN_MENU];
    xmb->main_menu_node.alpha    = xmb->categories_active_alpha;
    xmb->main_menu_node.zoom     = xmb->categories_active_zoom;
@@ -6471,6 +6475,7 @@ static void xmb_context_reset_textures(
    return;
 
 error:
+   gfx_display_atlas_end(disp_get_ptr());
    xmb->assets_missing = true;
    RARCH_WARN("[XMB]: Critical asset missing, no icons will be drawn.\n");
 }
@@ -6923,6 +6928,8 @@ static void xmb_context_destroy(void *data)
    if (!xmb)
       return;
 
+   gfx_display_atlas_free(disp_get_ptr());
+
    for (i = 0; i < XMB_TEXTURE_LAST; i++)
       video_driver_texture_unload(&xmb->textures.list[i]);
 
@@ -6632,6 +6632,14 @@ unsigned menu_displaylist_build_list(
                         PARSE_ONLY_BOOL, false) == 0)
                   count++;
 #endif
+            if (MENU_DISPLAYLIST_PARSE_SETTINGS_ENUM(list,
+                     MENU_ENUM_LABEL_VIDEO_FRAME_DIFF,
+                     PARSE_ONLY_BOOL, false) == 0)
+               count++;
+            if (MENU_DISPLAYLIST_PARSE_SETTINGS_ENUM(list,
+                     MENU_ENUM_LABEL_VIDEO_UPLOAD_RING,
+                     PARSE_ONLY_BOOL, false) == 0)
+               count++;
             if (MENU_DISPLAYLIST_PARSE_SETTINGS_ENUM(list,
                      MENU_ENUM_LABEL_VIDEO_SMOOTH,
                      PARSE_ONLY_BOOL, false) == 0)
@@ -6656,11 +6664,19 @@ unsigned menu_displaylist_build_list(
                      MENU_ENUM_LABEL_VIDEO_SHADER_DELAY,
                      PARSE_ONLY_UINT, false) == 0)
                count++;
+            if (MENU_DISPLAYLIST_PARSE_SETTINGS_ENUM(list,
+                     MENU_ENUM_LABEL_VIDEO_SHADER_CACHE_SIZE,
+                     PARSE_ONLY_UINT, false) == 0)
+               count++;
 #ifdef HAVE_VIDEO_FILTER
             if (MENU_DISPLAYLIST_PARSE_SETTINGS_ENUM(list,
                      MENU_ENUM_LABEL_VIDEO_FILTER,
                      PARSE_ONLY_PATH, false) == 0)
                count++;
+            if (MENU_DISPLAYLIST_PARSE_SETTINGS_ENUM(list,
+                     MENU_ENUM_LABEL_VIDEO_FILTER_THREADS,
+                     PARSE_ONLY_UINT, false) == 0)
+               count++;
 
             if (!string_is_empty(settings->paths.path_softfilter_plugin))
                if (menu_entries_append_enum(list,
@@ -8920,9 +8936,11 @@ unsigned menu_displaylist_build_list(
       case DISPLAYLIST_LATENCY_SETTINGS_LIST:
          {
             bool video_hard_sync          = settings->bools.video_hard_sync;
+            bool frame_profiler_enable    = settings->bools.frame_profiler_enable;
 #ifdef HAVE_RUNAHEAD
             bool runahead_supported       = true;
             bool runahead_enabled         = settings->bools.run_ahead_enabled;
+            bool runahead_secondary       = settings->bools.run_ahead_secondary_instance;
 #endif
             menu_displaylist_build_info_selective_t build_list[] = {
                {MENU_ENUM_LABEL_VIDEO_FRAME_DELAY,                     PARSE_ONLY_UINT, true },
@@ -8934,6 +8952,8 @@ unsigned menu_displaylist_build_list(
                {MENU_ENUM_LABEL_RUN_AHEAD_ENABLED,                     PARSE_ONLY_BOOL, false },
                {MENU_ENUM_LABEL_RUN_AHEAD_FRAMES,                      PARSE_ONLY_UINT, false },
                {MENU_ENUM_LABEL_RUN_AHEAD_SECONDARY_INSTANCE,          PARSE_ONLY_BOOL, false },
+               {MENU_ENUM_LABEL_RUN_AHEAD_SECONDARY_THREADED,          PARSE_ONLY_BOOL, false },
+               {MENU_ENUM_LABEL_RUN_AHEAD_PREEMPTIVE_FRAMES,           PARSE_ONLY_BOOL, false },
                {MENU_ENUM_LABEL_RUN_AHEAD_HIDE_WARNINGS,               PARSE_ONLY_BOOL, false },
 #endif
             };
@@ -8977,10 +8997,15 @@ unsigned menu_displaylist_build_list(
                         break;
                      case MENU_ENUM_LABEL_RUN_AHEAD_FRAMES:
                      case MENU_ENUM_LABEL_RUN_AHEAD_SECONDARY_INSTANCE:
+                     case MENU_ENUM_LABEL_RUN_AHEAD_PREEMPTIVE_FRAMES:
                      case MENU_ENUM_LABEL_RUN_AHEAD_HIDE_WARNINGS:
                         if (runahead_enabled)
                            build_list[i].checked = true;
                         break;
+                     case MENU_ENUM_LABEL_RUN_AHEAD_SECONDARY_THREADED:
+                        if (runahead_enabled && runahead_secondary)
+                           build_list[i].checked = true;
+                        break;
                      default:
                         break;
                   }
@@ -9010,6 +9035,22 @@ unsigned menu_displaylist_build_list(
             if (MENU_DISPLAYLIST_PARSE_SETTINGS_ENUM(list,
                      MENU_ENUM_LABEL_GAMEMODE_ENABLE, PARSE_ONLY_BOOL, false) == 0)
                count++;
+
+            if (MENU_DISPLAYLIST_PARSE_SETTINGS_ENUM(list,
+                     MENU_ENUM_LABEL_FRAME_PROFILER_ENABLE, PARSE_ONLY_BOOL, false) == 0)
+               count++;
+
+            if (frame_profiler_enable || include_everything)
+            {
+#ifdef HAVE_GFX_WIDGETS
+               if (MENU_DISPLAYLIST_PARSE_SETTINGS_ENUM(list,
+                        MENU_ENUM_LABEL_FRAME_PROFILER_SHOW_GRAPH, PARSE_ONLY_BOOL, false) == 0)
+                  count++;
+#endif
+               if (MENU_DISPLAYLIST_PARSE_SETTINGS_ENUM(list,
+                        MENU_ENUM_LABEL_FRAME_PROFILER_EXPORT, PARSE_ACTION, false) == 0)
+                  count++;
+            }
          }
          break;
       case DISPLAYLIST_ONSCREEN_NOTIFICATIONS_SETTINGS_LIST:
@@ -9903,6 +9944,11 @@ unsigned menu_displaylist_build_list(
                {MENU_ENUM_LABEL_REWIND_GRANULARITY,      PARSE_ONLY_UINT, false},
                {MENU_ENUM_LABEL_REWIND_BUFFER_SIZE,      PARSE_ONLY_SIZE, false},
                {MENU_ENUM_LABEL_REWIND_BUFFER_SIZE_STEP, PARSE_ONLY_UINT, false},
+               {MENU_ENUM_LABEL_REWIND_COLD_BUFFER_SIZE, PARSE_ONLY_SIZE, false},
+               {MENU_ENUM_LABEL_REWIND_SPILL_SIZE,       PARSE_ONLY_SIZE, false},
+#ifdef HAVE_THREADS
+               {MENU_ENUM_LABEL_REWIND_COMPRESSION_THREADS, PARSE_ONLY_UINT, false},
+#endif
             };
 
             for (i = 0; i < ARRAY_SIZE(build_list); i++)
@@ -9912,6 +9958,11 @@ unsigned menu_displaylist_build_list(
                   case MENU_ENUM_LABEL_REWIND_GRANULARITY:
                   case MENU_ENUM_LABEL_REWIND_BUFFER_SIZE:
                   case MENU_ENUM_LABEL_REWIND_BUFFER_SIZE_STEP:
+                  case MENU_ENUM_LABEL_REWIND_COLD_BUFFER_SIZE:
+                  case MENU_ENUM_LABEL_REWIND_SPILL_SIZE:
+#ifdef HAVE_THREADS
+                  case MENU_ENUM_LABEL_REWIND_COMPRESSION_THREADS:
+#endif
                      if (rewind_enable)
                         build_list[i].checked = true;
                      break;
@@ -9930,6 +9981,39 @@ unsigned menu_displaylist_build_list(
                         false) == 0)
                   count++;
             }
+
+#ifdef HAVE_REWIND
+            {
+               /* Show what the tiers actually hold right now,
+                * not what the settings would allow. */
+               state_manager_stats_t stats;
+               runloop_state_t *runloop_st     = runloop_state_get_ptr();
+               video_driver_state_t *video_st  = video_state_get_ptr();
+
+               if (state_manager_get_stats(&runloop_st->rewind_st, &stats))
+               {
+                  char tmp[256];
+                  unsigned granularity = settings->uints.rewind_granularity;
+                  unsigned entries     = stats.ram_entries
+                     + stats.cold_entries + stats.spill_entries;
+                  double fps           = (video_st->av_info.timing.fps > 0.0)
+                     ? video_st->av_info.timing.fps : 60.0;
+
+                  snprintf(tmp, sizeof(tmp),
+                        msg_hash_to_str(MSG_REWIND_RETAINED),
+                        entries * (granularity ? granularity : 1) / fps,
+                        entries,
+                        stats.ram_size   / (1024.0 * 1024.0),
+                        stats.cold_size  / (1024.0 * 1024.0),
+                        stats.spill_size / (1024.0 * 1024.0));
+
+                  if (menu_entries_append_enum(list, tmp, "",
+                        MENU_ENUM_LABEL_SYSTEM_INFO_ENTRY,
+                        MENU_SETTINGS_CORE_INFO_NONE, 0, 0))
+                     count++;
+               }
+            }
+#endif
          }
          break;
       case DISPLAYLIST_FRAME_THROTTLE_SETTINGS_LIST:
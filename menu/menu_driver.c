@@ -4856,7 +4856,18 @@ void menu_driver_frame(bool menu_is_alive, video_frame_info_t *video_info)
 {
    struct menu_state    *menu_st = &menu_driver_state;
    if (menu_is_alive && menu_st->driver_ctx->frame)
+   {
+      gfx_display_t *p_disp     = disp_get_ptr();
+      /* Quads of the same texture go out together */
+      bool batch                = gfx_display_batch_begin(
+            &p_disp->batch, &p_disp->dispctx, video_info->userdata,
+            video_info->width, video_info->height);
+
       menu_st->driver_ctx->frame(menu_st->userdata, video_info);
+
+      if (batch)
+         gfx_display_batch_end(&p_disp->batch, &p_disp->dispctx);
+   }
 }
 
 bool menu_driver_list_cache(menu_ctx_list_t *list)
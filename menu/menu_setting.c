@@ -3072,6 +3072,35 @@ static void setting_get_string_representation_video_filter(rarch_setting_t *sett
    fill_short_pathname_representation(s, setting->value.target.string, len);
 }
 
+static void setting_get_string_representation_video_filter_threads(rarch_setting_t *setting,
+      char *s, size_t len)
+{
+   if (!setting)
+      return;
+
+   if (*setting->value.target.unsigned_integer)
+      snprintf(s, len, "%u",
+            *setting->value.target.unsigned_integer);
+   else
+      strlcpy(s, "0 (Auto)", len);
+}
+
+#if defined(HAVE_SLANG)
+static void setting_get_string_representation_video_shader_cache_size(
+      rarch_setting_t *setting,
+      char *s, size_t len)
+{
+   if (!setting)
+      return;
+
+   if (*setting->value.target.unsigned_integer)
+      snprintf(s, len, "%u MB",
+            *setting->value.target.unsigned_integer);
+   else
+      strlcpy(s, msg_hash_to_str(MENU_ENUM_LABEL_VALUE_OFF), len);
+}
+#endif
+
 static void setting_get_string_representation_state_slot(rarch_setting_t *setting,
       char *s, size_t len)
 {
@@ -10816,6 +10845,51 @@ static bool setting_append_list(
             (*list)[list_info->index - 1].offset_by     = 1;
             menu_settings_list_current_add_range(list, list_info, 1, 100, 1, true, true);
 
+            CONFIG_SIZE(
+                  list, list_info,
+                  &settings->sizes.rewind_cold_buffer_size,
+                  MENU_ENUM_LABEL_REWIND_COLD_BUFFER_SIZE,
+                  MENU_ENUM_LABEL_VALUE_REWIND_COLD_BUFFER_SIZE,
+                  DEFAULT_REWIND_COLD_BUFFER_SIZE,
+                  &group_info,
+                  &subgroup_info,
+                  parent_group,
+                  general_write_handler,
+                  general_read_handler,
+                  &setting_get_string_representation_size_in_mb);
+            menu_settings_list_current_add_range(list, list_info, 0, 1024*1024*1024, settings->uints.rewind_buffer_size_step*1024*1024, true, true);
+
+            CONFIG_SIZE(
+                  list, list_info,
+                  &settings->sizes.rewind_spill_size,
+                  MENU_ENUM_LABEL_REWIND_SPILL_SIZE,
+                  MENU_ENUM_LABEL_VALUE_REWIND_SPILL_SIZE,
+                  DEFAULT_REWIND_SPILL_SIZE,
+                  &group_info,
+                  &subgroup_info,
+                  parent_group,
+                  general_write_handler,
+                  general_read_handler,
+                  &setting_get_string_representation_size_in_mb);
+            menu_settings_list_current_add_range(list, list_info, 0, 4096.0*1024*1024, settings->uints.rewind_buffer_size_step*1024*1024, true, true);
+
+#ifdef HAVE_THREADS
+            CONFIG_UINT(
+                  list, list_info,
+                  &settings->uints.rewind_compression_threads,
+                  MENU_ENUM_LABEL_REWIND_COMPRESSION_THREADS,
+                  MENU_ENUM_LABEL_VALUE_REWIND_COMPRESSION_THREADS,
+                  DEFAULT_REWIND_COMPRESSION_THREADS,
+                  &group_info,
+                  &subgroup_info,
+                  parent_group,
+                  general_write_handler,
+                  general_read_handler);
+            (*list)[list_info->index - 1].action_ok     = &setting_action_ok_uint;
+            (*list)[list_info->index - 1].offset_by     = 0;
+            menu_settings_list_current_add_range(list, list_info, 0, STATE_MANAGER_DELTA_THREADS_MAX, 1, true, true);
+#endif
+
          END_SUB_GROUP(list, list_info, parent_group);
          END_GROUP(list, list_info, parent_group);
          break;
@@ -12540,6 +12614,28 @@ static bool setting_append_list(
             }
 #endif
 
+#if defined(HAVE_SLANG)
+            if (video_shader_is_supported(RARCH_SHADER_SLANG))
+            {
+               CONFIG_UINT(
+                     list, list_info,
+                     &settings->uints.video_shader_cache_size,
+                     MENU_ENUM_LABEL_VIDEO_SHADER_CACHE_SIZE,
+                     MENU_ENUM_LABEL_VALUE_VIDEO_SHADER_CACHE_SIZE,
+                     DEFAULT_VIDEO_SHADER_CACHE_SIZE,
+                     &group_info,
+                     &subgroup_info,
+                     parent_group,
+                     general_write_handler,
+                     general_read_handler);
+               (*list)[list_info->index - 1].action_ok = &setting_action_ok_uint;
+               (*list)[list_info->index - 1].get_string_representation =
+                  &setting_get_string_representation_video_shader_cache_size;
+               menu_settings_list_current_add_range(list, list_info, 0, 1024, 16, true, true);
+               SETTINGS_DATA_LIST_CURRENT_ADD_FLAGS(list, list_info, SD_FLAG_ADVANCED);
+            }
+#endif
+
             CONFIG_BOOL(
                   list, list_info,
                   &settings->bools.video_shader_watch_files,
@@ -12617,6 +12713,42 @@ static bool setting_append_list(
                   );
             SETTINGS_DATA_LIST_CURRENT_ADD_FLAGS(list, list_info, SD_FLAG_ADVANCED);
 
+            CONFIG_BOOL(
+                  list, list_info,
+                  &settings->bools.video_frame_diff,
+                  MENU_ENUM_LABEL_VIDEO_FRAME_DIFF,
+                  MENU_ENUM_LABEL_VALUE_VIDEO_FRAME_DIFF,
+                  DEFAULT_VIDEO_FRAME_DIFF,
+                  MENU_ENUM_LABEL_VALUE_OFF,
+                  MENU_ENUM_LABEL_VALUE_ON,
+                  &group_info,
+                  &subgroup_info,
+                  parent_group,
+                  general_write_handler,
+                  general_read_handler,
+                  SD_FLAG_NONE
+                  );
+            MENU_SETTINGS_LIST_CURRENT_ADD_CMD(list, list_info, CMD_EVENT_REINIT);
+            SETTINGS_DATA_LIST_CURRENT_ADD_FLAGS(list, list_info, SD_FLAG_ADVANCED);
+
+            CONFIG_BOOL(
+                  list, list_info,
+                  &settings->bools.video_upload_ring,
+                  MENU_ENUM_LABEL_VIDEO_UPLOAD_RING,
+                  MENU_ENUM_LABEL_VALUE_VIDEO_UPLOAD_RING,
+                  DEFAULT_VIDEO_UPLOAD_RING,
+                  MENU_ENUM_LABEL_VALUE_OFF,
+                  MENU_ENUM_LABEL_VALUE_ON,
+                  &group_info,
+                  &subgroup_info,
+                  parent_group,
+                  general_write_handler,
+                  general_read_handler,
+                  SD_FLAG_NONE
+                  );
+            MENU_SETTINGS_LIST_CURRENT_ADD_CMD(list, list_info, CMD_EVENT_REINIT);
+            SETTINGS_DATA_LIST_CURRENT_ADD_FLAGS(list, list_info, SD_FLAG_ADVANCED);
+
             CONFIG_BOOL(
                   list, list_info,
                   &settings->bools.video_crop_overscan,
@@ -12652,6 +12784,23 @@ static bool setting_append_list(
             MENU_SETTINGS_LIST_CURRENT_ADD_CMD(list, list_info, CMD_EVENT_REINIT);
             SETTINGS_DATA_LIST_CURRENT_ADD_FLAGS(list, list_info, SD_FLAG_LAKKA_ADVANCED);
 
+            CONFIG_UINT(
+                  list, list_info,
+                  &settings->uints.video_filter_threads,
+                  MENU_ENUM_LABEL_VIDEO_FILTER_THREADS,
+                  MENU_ENUM_LABEL_VALUE_VIDEO_FILTER_THREADS,
+                  DEFAULT_VIDEO_FILTER_THREADS,
+                  &group_info,
+                  &subgroup_info,
+                  parent_group,
+                  general_write_handler,
+                  general_read_handler);
+            MENU_SETTINGS_LIST_CURRENT_ADD_CMD(list, list_info, CMD_EVENT_REINIT);
+            menu_settings_list_current_add_range(list, list_info, 0, 32, 1, true, true);
+            (*list)[list_info->index - 1].get_string_representation =
+               &setting_get_string_representation_video_filter_threads;
+            SETTINGS_DATA_LIST_CURRENT_ADD_FLAGS(list, list_info, SD_FLAG_LAKKA_ADVANCED);
+
             END_SUB_GROUP(list, list_info, parent_group);
             END_GROUP(list, list_info, parent_group);
          }
@@ -14266,8 +14415,45 @@ static bool setting_append_list(
                general_read_handler,
                SD_FLAG_NONE
                );
+         (*list)[list_info->index - 1].action_ok     = setting_bool_action_left_with_refresh;
+         (*list)[list_info->index - 1].action_left   = setting_bool_action_left_with_refresh;
+         (*list)[list_info->index - 1].action_right  = setting_bool_action_right_with_refresh;
+
+#ifdef HAVE_THREADS
+         CONFIG_BOOL(
+               list, list_info,
+               &settings->bools.run_ahead_secondary_threaded,
+               MENU_ENUM_LABEL_RUN_AHEAD_SECONDARY_THREADED,
+               MENU_ENUM_LABEL_VALUE_RUN_AHEAD_SECONDARY_THREADED,
+               DEFAULT_RUN_AHEAD_SECONDARY_THREADED,
+               MENU_ENUM_LABEL_VALUE_OFF,
+               MENU_ENUM_LABEL_VALUE_ON,
+               &group_info,
+               &subgroup_info,
+               parent_group,
+               general_write_handler,
+               general_read_handler,
+               SD_FLAG_ADVANCED
+               );
+#endif
 #endif
 
+         CONFIG_BOOL(
+               list, list_info,
+               &settings->bools.run_ahead_preemptive_frames,
+               MENU_ENUM_LABEL_RUN_AHEAD_PREEMPTIVE_FRAMES,
+               MENU_ENUM_LABEL_VALUE_RUN_AHEAD_PREEMPTIVE_FRAMES,
+               DEFAULT_RUN_AHEAD_PREEMPTIVE_FRAMES,
+               MENU_ENUM_LABEL_VALUE_OFF,
+               MENU_ENUM_LABEL_VALUE_ON,
+               &group_info,
+               &subgroup_info,
+               parent_group,
+               general_write_handler,
+               general_read_handler,
+               SD_FLAG_NONE
+               );
+
          CONFIG_BOOL(
                list, list_info,
                &settings->bools.run_ahead_hide_warnings,
@@ -14317,6 +14503,53 @@ static bool setting_append_list(
                SD_FLAG_ADVANCED
                );
 
+         CONFIG_BOOL(
+               list, list_info,
+               &settings->bools.frame_profiler_enable,
+               MENU_ENUM_LABEL_FRAME_PROFILER_ENABLE,
+               MENU_ENUM_LABEL_VALUE_FRAME_PROFILER_ENABLE,
+               DEFAULT_FRAME_PROFILER_ENABLE,
+               MENU_ENUM_LABEL_VALUE_OFF,
+               MENU_ENUM_LABEL_VALUE_ON,
+               &group_info,
+               &subgroup_info,
+               parent_group,
+               general_write_handler,
+               general_read_handler,
+               SD_FLAG_ADVANCED
+               );
+         (*list)[list_info->index - 1].action_ok     = setting_bool_action_left_with_refresh;
+         (*list)[list_info->index - 1].action_left   = setting_bool_action_left_with_refresh;
+         (*list)[list_info->index - 1].action_right  = setting_bool_action_right_with_refresh;
+
+#ifdef HAVE_GFX_WIDGETS
+         CONFIG_BOOL(
+               list, list_info,
+               &settings->bools.frame_profiler_show_graph,
+               MENU_ENUM_LABEL_FRAME_PROFILER_SHOW_GRAPH,
+               MENU_ENUM_LABEL_VALUE_FRAME_PROFILER_SHOW_GRAPH,
+               DEFAULT_FRAME_PROFILER_SHOW_GRAPH,
+               MENU_ENUM_LABEL_VALUE_OFF,
+               MENU_ENUM_LABEL_VALUE_ON,
+               &group_info,
+               &subgroup_info,
+               parent_group,
+               general_write_handler,
+               general_read_handler,
+               SD_FLAG_ADVANCED
+               );
+#endif
+
+         CONFIG_ACTION(
+               list, list_info,
+               MENU_ENUM_LABEL_FRAME_PROFILER_EXPORT,
+               MENU_ENUM_LABEL_VALUE_FRAME_PROFILER_EXPORT,
+               &group_info,
+               &subgroup_info,
+               parent_group);
+         MENU_SETTINGS_LIST_CURRENT_ADD_CMD(list, list_info, CMD_EVENT_FRAME_PROFILER_EXPORT);
+         SETTINGS_DATA_LIST_CURRENT_ADD_FLAGS(list, list_info, SD_FLAG_ADVANCED);
+
          END_SUB_GROUP(list, list_info, parent_group);
          END_GROUP(list, list_info, parent_group);
          break;
@@ -379,6 +379,7 @@ enum msg_hash_enums
    MSG_REWIND_INIT,
    MSG_REWIND_INIT_FAILED,
    MSG_REWIND_INIT_FAILED_THREADED_AUDIO,
+   MSG_REWIND_RETAINED,
    MSG_LIBRETRO_ABI_BREAK,
    MSG_DETECTED_VIEWPORT_OF,
    MSG_RECORDING_TO,
@@ -494,6 +495,8 @@ enum msg_hash_enums
    MSG_RUNAHEAD_FAILED_TO_SAVE_STATE,
    MSG_RUNAHEAD_FAILED_TO_LOAD_STATE,
    MSG_RUNAHEAD_FAILED_TO_CREATE_SECONDARY_INSTANCE,
+   MSG_FRAME_PROFILER_EXPORTED,
+   MSG_FRAME_PROFILER_EXPORT_FAILED,
    MSG_MISSING_ASSETS,
    MSG_RGUI_MISSING_FONTS,
    MSG_RGUI_INVALID_LANGUAGE,
@@ -1088,10 +1091,13 @@ enum msg_hash_enums
    MENU_LABEL(VIDEO_SOFT_FILTER),
    MENU_LABEL(VIDEO_MAX_SWAPCHAIN_IMAGES),
    MENU_LABEL(VIDEO_GPU_SCREENSHOT),
+   MENU_LABEL(VIDEO_FRAME_DIFF),
+   MENU_LABEL(VIDEO_UPLOAD_RING),
    MENU_LABEL(VIDEO_BLACK_FRAME_INSERTION),
    MENU_LABEL(VIDEO_FRAME_DELAY),
    MENU_LABEL(VIDEO_FRAME_DELAY_AUTO),
    MENU_LABEL(VIDEO_SHADER_DELAY),
+   MENU_LABEL(VIDEO_SHADER_CACHE_SIZE),
    MENU_LABEL(VIDEO_VSYNC),
    MENU_LABEL(VIDEO_ADAPTIVE_VSYNC),
    MENU_LABEL(VIDEO_HARD_SYNC),
@@ -1857,6 +1863,9 @@ enum msg_hash_enums
    MENU_LABEL(SCREENSHOT),
    MENU_LABEL(REWIND),
    MENU_LABEL(REWIND_GRANULARITY),
+   MENU_LABEL(REWIND_COMPRESSION_THREADS),
+   MENU_LABEL(REWIND_COLD_BUFFER_SIZE),
+   MENU_LABEL(REWIND_SPILL_SIZE),
    MENU_LABEL(REWIND_BUFFER_SIZE),
    MENU_LABEL(REWIND_BUFFER_SIZE_STEP),
    /* TODO/FIXME: INPUT_META_REWIND is incorrectly defined;
@@ -2092,8 +2101,13 @@ enum msg_hash_enums
    MENU_LABEL(RUN_AHEAD_UNSUPPORTED),
    MENU_LABEL(RUN_AHEAD_ENABLED),
    MENU_LABEL(RUN_AHEAD_SECONDARY_INSTANCE),
+   MENU_LABEL(RUN_AHEAD_SECONDARY_THREADED),
+   MENU_LABEL(RUN_AHEAD_PREEMPTIVE_FRAMES),
    MENU_LABEL(RUN_AHEAD_HIDE_WARNINGS),
    MENU_LABEL(RUN_AHEAD_FRAMES),
+   MENU_LABEL(FRAME_PROFILER_ENABLE),
+   MENU_LABEL(FRAME_PROFILER_SHOW_GRAPH),
+   MENU_LABEL(FRAME_PROFILER_EXPORT),
    MENU_LABEL(INPUT_BLOCK_TIMEOUT),
    MENU_LABEL(TURBO),
 
@@ -2475,6 +2489,7 @@ enum msg_hash_enums
    MENU_LABEL(RECORDING_CONFIG_DIRECTORY),
    MENU_LABEL(VIDEO_FILTER),
    MENU_LABEL(VIDEO_FILTER_REMOVE),
+   MENU_LABEL(VIDEO_FILTER_THREADS),
    MENU_LABEL(PAL60_ENABLE),
 
    MENU_LABEL(CONTENT_HISTORY_PATH),
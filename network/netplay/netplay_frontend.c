@@ -2103,7 +2103,7 @@ static void netplay_delta_frame_free(struct delta_frame *delta)
 
    if (delta->state)
    {
-      free(delta->state);
+      content_state_pool_put(delta->state);
       delta->state = NULL;
    }
 
@@ -6604,10 +6604,11 @@ static bool netplay_init_serialization(netplay_t *netplay)
       return false;
 
    netplay->state_size = info.size;
+   content_state_pool_init(netplay->state_size);
 
    for (i = 0; i < netplay->buffer_size; i++)
    {
-      netplay->buffer[i].state = calloc(netplay->state_size, 1);
+      netplay->buffer[i].state = content_state_pool_get();
 
       if (!netplay->buffer[i].state)
       {
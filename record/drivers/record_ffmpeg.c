@@ -470,6 +470,8 @@ static bool ffmpeg_init_video(ffmpeg_t *handle)
    video->codec->pix_fmt             = video->pix_fmt;
 
    video->codec->thread_count = params->threads;
+   /* The in-house scaler splits frames across as many */
+   video->scaler.threads      = params->threads;
 
    if (params->video_qscale)
    {
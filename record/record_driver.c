@@ -179,6 +179,14 @@ bool recording_deinit(void)
    recording_st->data              = NULL;
    recording_st->driver            = NULL;
 
+   if (recording_st->frame_diff.frames)
+      RARCH_LOG("[Recording]: %" PRIu64 " of %" PRIu64
+            " frames were unchanged and not converted again.\n",
+            recording_st->frame_diff.frames_unchanged,
+            recording_st->frame_diff.frames);
+   frame_diff_free(&recording_st->frame_diff);
+   memset(&recording_st->frame_diff, 0, sizeof(recording_st->frame_diff));
+
    video_driver_gpu_record_deinit();
 
    return true;
@@ -2,6 +2,7 @@
 #define _RECORD_DRIVER_H
 
 #include <boolean.h>
+#include <gfx/frame_diff.h>
 
 enum ffemu_pix_format
 {
@@ -112,6 +113,9 @@ typedef struct record_driver
 
 struct recording
 {
+   /* Finds the frames that repeat the previous one */
+   frame_diff_t frame_diff;      /* uint64_t alignment */
+
    const record_driver_t *driver;
    void *data;
 
@@ -174,6 +174,7 @@
 #include "msg_hash.h"
 #include "paths.h"
 #include "file_path_special.h"
+#include "frame_profiler.h"
 #include "ui/ui_companion_driver.h"
 #include "verbosity.h"
 
@@ -1489,6 +1490,36 @@ bool command_event(enum event_command cmd, void *data)
       case CMD_EVENT_SAVE_FILES:
          event_save_files(runloop_st->use_sram);
          break;
+      case CMD_EVENT_FRAME_PROFILER_EXPORT:
+         {
+            char msg[PATH_MAX_LENGTH + 64];
+            char trace_path[PATH_MAX_LENGTH];
+            char trace_name[64];
+            const char *log_dir = settings->paths.log_dir;
+
+            fill_str_dated_filename(trace_name, "frame-profile",
+                  "json", sizeof(trace_name));
+
+            if (     !string_is_empty(log_dir)
+                  && (path_is_directory(log_dir) || path_mkdir(log_dir)))
+               fill_pathname_join(trace_path, log_dir, trace_name,
+                     sizeof(trace_path));
+            else
+               strlcpy(trace_path, trace_name, sizeof(trace_path));
+
+            if (frame_profiler_export(trace_path))
+               snprintf(msg, sizeof(msg),
+                     msg_hash_to_str(MSG_FRAME_PROFILER_EXPORTED),
+                     trace_path);
+            else
+               strlcpy(msg,
+                     msg_hash_to_str(MSG_FRAME_PROFILER_EXPORT_FAILED),
+                     sizeof(msg));
+
+            runloop_msg_queue_push(msg, 1, 180, true, NULL,
+                  MESSAGE_QUEUE_ICON_DEFAULT, MESSAGE_QUEUE_CATEGORY_INFO);
+         }
+         break;
       case CMD_EVENT_OVERLAY_DEINIT:
 #ifdef HAVE_OVERLAY
          input_overlay_deinit();
@@ -2029,6 +2060,9 @@ bool command_event(enum event_command cmd, void *data)
          {
             bool rewind_enable        = settings->bools.rewind_enable;
             size_t rewind_buf_size    = settings->sizes.rewind_buffer_size;
+            unsigned rewind_threads   = settings->uints.rewind_compression_threads;
+            size_t rewind_cold_size   = settings->sizes.rewind_cold_buffer_size;
+            size_t rewind_spill_size  = settings->sizes.rewind_spill_size;
             bool core_type_is_dummy   = runloop_st->current_core_type == CORE_TYPE_DUMMY;
 
             if (core_type_is_dummy)
@@ -2047,7 +2081,9 @@ bool command_event(enum event_command cmd, void *data)
 #endif
                {
                   state_manager_event_init(&runloop_st->rewind_st,
-                        (unsigned)rewind_buf_size);
+                        (unsigned)rewind_buf_size, rewind_threads,
+                        rewind_cold_size, rewind_spill_size,
+                        settings->paths.directory_cache);
                }
             }
          }
@@ -5915,6 +5951,7 @@ int retroarch_get_capabilities(enum rarch_capabilities type,
       case RARCH_CAPABILITIES_CPU:
          {
             uint64_t cpu     = cpu_features_get();
+            uint64_t cpu_ext = cpu_features_get_extensions();
 
             if (cpu & RETRO_SIMD_MMX)
                strlcat(s, " MMX", len);
@@ -5938,6 +5975,10 @@ int retroarch_get_capabilities(enum rarch_capabilities type,
                strlcat(s, " AVX", len);
             if (cpu & RETRO_SIMD_AVX2)
                strlcat(s, " AVX2", len);
+            if (cpu_ext & CPU_FEATURES_FMA)
+               strlcat(s, " FMA", len);
+            if (cpu_ext & CPU_FEATURES_AVX512)
+               strlcat(s, " AVX-512", len);
             if (cpu & RETRO_SIMD_NEON)
                strlcat(s, " NEON", len);
             if (cpu & RETRO_SIMD_VFPV3)
@@ -185,6 +185,7 @@
 #include "dynamic.h"
 #include "defaults.h"
 #include "driver.h"
+#include "frame_profiler.h"
 #include "msg_hash.h"
 #include "paths.h"
 #include "file_path_special.h"
@@ -3725,12 +3726,23 @@ static void strcat_alloc(char **dst, const char *s)
    strcpy_literal(src + len1, s);
 }
 
+#if defined(HAVE_RUNAHEAD) && defined(HAVE_THREADS)
+static void runahead_secondary_thread_free(runloop_state_t *runloop_st);
+static bool runahead_secondary_thread_is_worker(runloop_state_t *runloop_st);
+static bool runahead_secondary_thread_environment(
+      struct runahead_secondary_thread *thr, unsigned cmd, void *data);
+#endif
+
 void runloop_secondary_core_destroy(void)
 {
    runloop_state_t *runloop_st      = &runloop_state;
    if (!runloop_st->secondary_lib_handle)
       return;
 
+#if defined(HAVE_RUNAHEAD) && defined(HAVE_THREADS)
+   runahead_secondary_thread_free(runloop_st);
+#endif
+
    /* unload game from core */
    if (runloop_st->secondary_core.retro_unload_game)
       runloop_st->secondary_core.retro_unload_game();
@@ -3942,8 +3954,18 @@ end:
 static bool runloop_environment_secondary_core_hook(
       unsigned cmd, void *data)
 {
+   bool result;
    runloop_state_t *runloop_st    = &runloop_state;
-   bool result                    = runloop_environment_cb(cmd, data);
+
+#if defined(HAVE_RUNAHEAD) && defined(HAVE_THREADS)
+   /* runloop_environment_cb() must not be entered off the
+    * main thread, the worker gets its own callback */
+   if (runahead_secondary_thread_is_worker(runloop_st))
+      return runahead_secondary_thread_environment(
+            runloop_st->secondary_thread, cmd, data);
+#endif
+
+   result                         = runloop_environment_cb(cmd, data);
 
    if (runloop_st->has_variable_update)
    {
@@ -4142,6 +4164,500 @@ static bool secondary_core_run_use_last_input(void)
 
    return true;
 }
+
+#if defined(HAVE_RUNAHEAD) && defined(HAVE_THREADS)
+/* Threaded secondary instance
+ *
+ * Runs the secondary core on a worker thread. Each frame the
+ * worker speculatively advances the secondary core by one frame,
+ * assuming the input does not change, while the main thread runs
+ * the primary core. Only when the input did change does the main
+ * thread have to wait for the worker to reload the primary state
+ * and replay the run-ahead frames.
+ *
+ * The worker never touches the video or audio driver; the last
+ * frame of each job is copied and presented by the main thread.
+ * Hardware rendered cores therefore stay on the synchronous path.
+ * Nor does it enter runloop_environment_cb(), environment calls
+ * are answered by runahead_secondary_thread_environment(). */
+
+enum runahead_secondary_job
+{
+   RUNAHEAD_SECONDARY_JOB_NONE = 0,
+   /* Run 'frames' frames on top of the current state */
+   RUNAHEAD_SECONDARY_JOB_RUN,
+   /* Load state slot 'slot', then run 'frames' frames */
+   RUNAHEAD_SECONDARY_JOB_REPLAY,
+   RUNAHEAD_SECONDARY_JOB_QUIT
+};
+
+struct runahead_secondary_thread
+{
+   sthread_t *thread;
+   slock_t *lock;
+   scond_t *cond;
+   /* Primary core savestates, double buffered so that the main
+    * thread can serialize into one while the worker is still
+    * busy with a job that may reference the other */
+   void *slots[2];
+   /* Snapshot of the logged input, taken when a job is queued */
+   input_list_element *input;
+   /* Snapshot of the core option values, as pairs of
+    * NUL terminated keys and values */
+   char *variables;
+   uint8_t *frame;
+   size_t slot_size;
+   size_t variables_size;
+   size_t variables_capacity;
+   size_t frame_capacity;
+   size_t frame_pitch;
+   retro_perf_tick_t job_ticks;
+   unsigned input_count;
+   unsigned input_capacity;
+   unsigned variable_count;
+   unsigned frame_width;
+   unsigned frame_height;
+   unsigned frames;
+   unsigned slot;
+   unsigned next_slot;
+   enum runahead_secondary_job job;
+   bool busy;
+   bool okay;
+   bool capture;
+   bool frame_valid;
+   /* Copied along with the option values */
+   bool variable_update;
+   bool options_updated;
+   bool fastmotion;
+};
+
+static struct retro_perf_counter runahead_secondary_overlap_perf;
+static struct retro_perf_counter runahead_secondary_stall_perf;
+
+static void runahead_secondary_thread_video_cb(const void *data,
+      unsigned width, unsigned height, size_t pitch)
+{
+   struct runahead_secondary_thread *thr =
+      runloop_state.secondary_thread;
+   size_t size                           = height * pitch;
+
+   if (!thr->capture)
+      return;
+
+   thr->frame_width  = width;
+   thr->frame_height = height;
+   thr->frame_pitch  = pitch;
+   thr->frame_valid  = false;
+
+   /* Frame dupe, present the previous one again */
+   if (!data || data == RETRO_HW_FRAME_BUFFER_VALID)
+      return;
+
+   if (size > thr->frame_capacity)
+   {
+      uint8_t *frame = (uint8_t*)realloc(thr->frame, size);
+      if (!frame)
+         return;
+      thr->frame          = frame;
+      thr->frame_capacity = size;
+   }
+
+   memcpy(thr->frame, data, size);
+   thr->frame_valid  = true;
+}
+
+static void runahead_secondary_thread_audio_cb(int16_t left, int16_t right) { }
+
+static size_t runahead_secondary_thread_audio_batch_cb(
+      const int16_t *data, size_t frames)
+{
+   return frames;
+}
+
+static int16_t runahead_secondary_thread_input_cb(unsigned port,
+      unsigned device, unsigned index, unsigned id)
+{
+   unsigned i;
+   struct runahead_secondary_thread *thr =
+      runloop_state.secondary_thread;
+
+   for (i = 0; i < thr->input_count; i++)
+   {
+      input_list_element *element = &thr->input[i];
+
+      if (  (element->port   == port)   &&
+            (element->device == device) &&
+            (element->index  == index))
+      {
+         if (id < element->state_size)
+            return element->state[id];
+         return 0;
+      }
+   }
+   return 0;
+}
+
+static bool runahead_secondary_thread_is_worker(runloop_state_t *runloop_st)
+{
+   return runloop_st->secondary_thread
+      && sthread_isself(runloop_st->secondary_thread->thread);
+}
+
+/* Environment callback of the secondary core while the worker
+ * runs it. Only answers the queries that can be served from what
+ * was copied when the job was queued; everything else is refused,
+ * as the rest of the frontend is not safe to use from here. */
+static bool runahead_secondary_thread_environment(
+      struct runahead_secondary_thread *thr, unsigned cmd, void *data)
+{
+   switch (cmd)
+   {
+      case RETRO_ENVIRONMENT_GET_VARIABLE_UPDATE:
+         *(bool*)data         = thr->variable_update
+            || thr->options_updated;
+         thr->variable_update = false;
+         break;
+
+      case RETRO_ENVIRONMENT_GET_VARIABLE:
+         {
+            unsigned i;
+            struct retro_variable *var = (struct retro_variable*)data;
+            const char *key            = thr->variables;
+
+            thr->variable_update       = false;
+
+            if (!var)
+               break;
+
+            var->value = NULL;
+
+            if (string_is_empty(var->key))
+               break;
+
+            for (i = 0; i < thr->variable_count; i++)
+            {
+               const char *val = key + strlen(key) + 1;
+
+               if (string_is_equal(key, var->key))
+               {
+                  var->value = val;
+                  break;
+               }
+
+               key = val + strlen(val) + 1;
+            }
+         }
+         break;
+
+      case RETRO_ENVIRONMENT_GET_AUDIO_VIDEO_ENABLE:
+         /* Only the last frame of a job is presented and
+          * none of the audio is */
+         if (data)
+            *(int*)data = (thr->capture ? 1 : 0) | 4 | 8;
+         break;
+
+      case RETRO_ENVIRONMENT_GET_FASTFORWARDING:
+         *(bool*)data = thr->fastmotion;
+         break;
+
+      case RETRO_ENVIRONMENT_GET_CAN_DUPE:
+         *(bool*)data = true;
+         break;
+
+      case RETRO_ENVIRONMENT_GET_INPUT_BITMASKS:
+         break;
+
+      default:
+         return false;
+   }
+
+   return true;
+}
+
+static void runahead_secondary_thread_loop(void *data)
+{
+   struct runahead_secondary_thread *thr =
+      (struct runahead_secondary_thread*)data;
+   struct retro_core_t *core             =
+      &runloop_state.secondary_core;
+
+   slock_lock(thr->lock);
+
+   for (;;)
+   {
+      unsigned i;
+      retro_perf_tick_t start;
+      enum runahead_secondary_job job;
+      bool okay = true;
+
+      while (thr->job == RUNAHEAD_SECONDARY_JOB_NONE)
+         scond_wait(thr->cond, thr->lock);
+
+      if ((job = thr->job) == RUNAHEAD_SECONDARY_JOB_QUIT)
+         break;
+
+      slock_unlock(thr->lock);
+
+      start = cpu_features_get_perf_counter();
+
+      if (job == RUNAHEAD_SECONDARY_JOB_REPLAY)
+      {
+         frame_profiler_begin(FRAME_PROFILER_THREAD_RUNAHEAD,
+               FRAME_PROFILER_STAGE_RUNAHEAD);
+         okay = core->retro_unserialize(thr->slots[thr->slot],
+               thr->slot_size);
+         frame_profiler_end(FRAME_PROFILER_THREAD_RUNAHEAD,
+               FRAME_PROFILER_STAGE_RUNAHEAD);
+      }
+
+      for (i = 0; okay && i < thr->frames; i++)
+      {
+         thr->capture = (i == thr->frames - 1);
+         frame_profiler_begin(FRAME_PROFILER_THREAD_RUNAHEAD,
+               FRAME_PROFILER_STAGE_CORE_RUN);
+         core->retro_run();
+         frame_profiler_end(FRAME_PROFILER_THREAD_RUNAHEAD,
+               FRAME_PROFILER_STAGE_CORE_RUN);
+      }
+
+      slock_lock(thr->lock);
+      thr->job_ticks = cpu_features_get_perf_counter() - start;
+      thr->okay      = okay;
+      thr->job       = RUNAHEAD_SECONDARY_JOB_NONE;
+      thr->busy      = false;
+      scond_signal(thr->cond);
+   }
+
+   slock_unlock(thr->lock);
+}
+
+static void runahead_secondary_thread_free(runloop_state_t *runloop_st)
+{
+   unsigned i;
+   struct runahead_secondary_thread *thr = runloop_st->secondary_thread;
+
+   if (!thr)
+      return;
+
+   if (thr->thread)
+   {
+      slock_lock(thr->lock);
+      while (thr->busy)
+         scond_wait(thr->cond, thr->lock);
+      thr->job = RUNAHEAD_SECONDARY_JOB_QUIT;
+      scond_signal(thr->cond);
+      slock_unlock(thr->lock);
+      sthread_join(thr->thread);
+   }
+
+   if (thr->lock)
+      slock_free(thr->lock);
+   if (thr->cond)
+      scond_free(thr->cond);
+
+   for (i = 0; i < thr->input_capacity; i++)
+      free(thr->input[i].state);
+   free(thr->input);
+   free(thr->variables);
+   free(thr->slots[0]);
+   free(thr->slots[1]);
+   free(thr->frame);
+   free(thr);
+
+   runloop_st->secondary_thread = NULL;
+}
+
+static bool runahead_secondary_thread_init(runloop_state_t *runloop_st)
+{
+   struct runahead_secondary_thread *thr = runloop_st->secondary_thread;
+   size_t slot_size = runloop_st->runahead_save_state_size;
+
+   if (thr && thr->slot_size == slot_size)
+      return true;
+
+   runahead_secondary_thread_free(runloop_st);
+
+   if (!(thr = (struct runahead_secondary_thread*)
+            calloc(1, sizeof(*thr))))
+      return false;
+
+   runloop_st->secondary_thread = thr;
+   thr->slot_size               = slot_size;
+   thr->slots[0]                = malloc(slot_size);
+   thr->slots[1]                = malloc(slot_size);
+   thr->lock                    = slock_new();
+   thr->cond                    = scond_new();
+
+   if (    !thr->slots[0]
+         || !thr->slots[1]
+         || !thr->lock
+         || !thr->cond
+         || !(thr->thread = sthread_create(
+               runahead_secondary_thread_loop, thr)))
+   {
+      runahead_secondary_thread_free(runloop_st);
+      return false;
+   }
+
+   return true;
+}
+
+/* Copies the input log so the worker does not race the
+ * primary core, which keeps updating it. */
+static void runahead_secondary_thread_snapshot_input(
+      runloop_state_t *runloop_st,
+      struct runahead_secondary_thread *thr)
+{
+   unsigned i;
+   unsigned count = runloop_st->input_state_list
+      ? (unsigned)runloop_st->input_state_list->size : 0;
+
+   if (count > thr->input_capacity)
+   {
+      input_list_element *input = (input_list_element*)realloc(
+            thr->input, count * sizeof(*input));
+      if (!input)
+         count = thr->input_capacity;
+      else
+      {
+         memset(input + thr->input_capacity, 0,
+               (count - thr->input_capacity) * sizeof(*input));
+         thr->input          = input;
+         thr->input_capacity = count;
+      }
+   }
+
+   thr->input_count = 0;
+
+   for (i = 0; i < count; i++)
+   {
+      input_list_element *src =
+         (input_list_element*)runloop_st->input_state_list->data[i];
+      input_list_element *dst = &thr->input[thr->input_count];
+
+      if (src->state_size > dst->state_size)
+      {
+         int16_t *state = (int16_t*)realloc(dst->state,
+               src->state_size * sizeof(int16_t));
+         if (!state)
+            continue;
+         dst->state      = state;
+         dst->state_size = src->state_size;
+      }
+
+      memcpy(dst->state, src->state, src->state_size * sizeof(int16_t));
+      dst->state_size   = src->state_size;
+      dst->port         = src->port;
+      dst->device       = src->device;
+      dst->index        = src->index;
+      thr->input_count++;
+   }
+}
+
+/* Copies what the worker's environment callback answers with.
+ * The variable update flag is handed over to the worker, which
+ * clears it the way runloop_environment_secondary_core_hook()
+ * does, and handed back by runahead_secondary_thread_wait(). */
+static void runahead_secondary_thread_snapshot_variables(
+      runloop_state_t *runloop_st,
+      struct runahead_secondary_thread *thr)
+{
+   size_t i;
+   core_option_manager_t *opts     = runloop_st->core_options;
+
+   thr->variables_size             = 0;
+   thr->variable_count             = 0;
+   thr->variable_update            = runloop_st->has_variable_update;
+   thr->options_updated            = opts && opts->updated;
+   thr->fastmotion                 = runloop_st->fastmotion;
+   runloop_st->has_variable_update = false;
+
+   if (!opts)
+      return;
+
+   for (i = 0; i < opts->size; i++)
+   {
+      size_t key_len, val_len, size;
+      const char *key = opts->opts[i].key;
+      const char *val = core_option_manager_get_val(opts, i);
+
+      if (string_is_empty(key) || !val)
+         continue;
+
+      key_len = strlen(key) + 1;
+      val_len = strlen(val) + 1;
+      size    = thr->variables_size + key_len + val_len;
+
+      if (size > thr->variables_capacity)
+      {
+         char *variables = (char*)realloc(thr->variables, size * 2);
+         if (!variables)
+            return;
+         thr->variables          = variables;
+         thr->variables_capacity = size * 2;
+      }
+
+      memcpy(thr->variables + thr->variables_size, key, key_len);
+      memcpy(thr->variables + thr->variables_size + key_len, val, val_len);
+      thr->variables_size = size;
+      thr->variable_count++;
+   }
+}
+
+static void runahead_secondary_thread_queue(runloop_state_t *runloop_st,
+      enum runahead_secondary_job job, unsigned frames, unsigned slot)
+{
+   struct runahead_secondary_thread *thr = runloop_st->secondary_thread;
+   struct retro_core_t *core             = &runloop_st->secondary_core;
+
+   runahead_secondary_thread_snapshot_input(runloop_st, thr);
+   runahead_secondary_thread_snapshot_variables(runloop_st, thr);
+
+   core->retro_set_video_refresh(runahead_secondary_thread_video_cb);
+   core->retro_set_audio_sample(runahead_secondary_thread_audio_cb);
+   core->retro_set_audio_sample_batch(
+         runahead_secondary_thread_audio_batch_cb);
+   core->retro_set_input_poll(secondary_core_input_poll_null);
+   core->retro_set_input_state(runahead_secondary_thread_input_cb);
+
+   slock_lock(thr->lock);
+   thr->frames = frames;
+   thr->slot   = slot;
+   thr->job    = job;
+   thr->busy   = true;
+   scond_signal(thr->cond);
+   slock_unlock(thr->lock);
+}
+
+static bool runahead_secondary_thread_wait(runloop_state_t *runloop_st)
+{
+   struct runahead_secondary_thread *thr = runloop_st->secondary_thread;
+   struct retro_callbacks *cbs           = &runloop_st->secondary_callbacks;
+   struct retro_core_t *core             = &runloop_st->secondary_core;
+   bool perfcnt_enable                   = runloop_st->perfcnt_enable;
+
+   performance_counter_start_plus(perfcnt_enable,
+         runahead_secondary_stall_perf);
+   slock_lock(thr->lock);
+   while (thr->busy)
+      scond_wait(thr->cond, thr->lock);
+   slock_unlock(thr->lock);
+   performance_counter_stop_plus(perfcnt_enable,
+         runahead_secondary_stall_perf);
+
+   /* The secondary core did not read it, keep it for later */
+   if (thr->variable_update)
+      runloop_st->has_variable_update = true;
+
+   core->retro_set_video_refresh(cbs->frame_cb);
+   core->retro_set_audio_sample(cbs->sample_cb);
+   core->retro_set_audio_sample_batch(cbs->sample_batch_cb);
+   core->retro_set_input_poll(cbs->poll_cb);
+   core->retro_set_input_state(cbs->state_cb);
+
+   return thr->okay;
+}
+#endif
 #else
 void runloop_secondary_core_destroy(void) { }
 static void remember_controller_port_device(long port, long device) { }
@@ -4259,6 +4775,7 @@ static void *input_list_element_constructor(void)
    element->device             = 0;
    element->index              = 0;
    element->state              = (int16_t*)calloc(256, sizeof(int16_t));
+   element->logged             = (uint8_t*)calloc(256, sizeof(uint8_t));
    element->state_size         = 256;
 
    return ptr;
@@ -4270,10 +4787,14 @@ static void input_list_element_realloc(
 {
    if (new_size > element->state_size)
    {
-      element->state = (int16_t*)realloc(element->state,
+      element->state  = (int16_t*)realloc(element->state,
             new_size * sizeof(int16_t));
+      element->logged = (uint8_t*)realloc(element->logged,
+            new_size * sizeof(uint8_t));
       memset(&element->state[element->state_size], 0,
             (new_size - element->state_size) * sizeof(int16_t));
+      memset(&element->logged[element->state_size], 0,
+            (new_size - element->state_size) * sizeof(uint8_t));
       element->state_size = new_size;
    }
 }
@@ -4296,6 +4817,7 @@ static void input_list_element_destructor(void* element_ptr)
       return;
 
    free(element->state);
+   free(element->logged);
    free(element_ptr);
 }
 
@@ -4323,7 +4845,8 @@ static void input_state_set_last(
       {
          if (id >= element->state_size)
             input_list_element_expand(element, id);
-         element->state[id] = value;
+         element->state[id]  = value;
+         element->logged[id] = 1;
          return;
       }
    }
@@ -4340,6 +4863,24 @@ static void input_state_set_last(
       if (id >= element->state_size)
          input_list_element_expand(element, id);
       element->state[id]    = value;
+      element->logged[id]   = 1;
+   }
+}
+
+/* Forgets which inputs the core has read, so that preemptive
+ * frames only check the ones it reads from now on. */
+static void input_state_clear_logged(runloop_state_t *runloop_st)
+{
+   int i;
+
+   if (!runloop_st->input_state_list)
+      return;
+
+   for (i = 0; i < runloop_st->input_state_list->size; i++)
+   {
+      input_list_element *element =
+         (input_list_element*)runloop_st->input_state_list->data[i];
+      memset(element->logged, 0, element->state_size * sizeof(uint8_t));
    }
 }
 
@@ -4370,7 +4911,10 @@ static void reset_hook(void)
 {
    runloop_state_t     *runloop_st = &runloop_state;
 
-   runloop_st->input_is_dirty      = true;
+   runloop_st->input_is_dirty         = true;
+   runloop_st->runahead_preempt_count = 0;
+   runloop_st->runahead_save_state_current = false;
+   input_state_clear_logged(runloop_st);
 
    if (runloop_st->retro_reset_callback_original)
       runloop_st->retro_reset_callback_original();
@@ -4380,7 +4924,10 @@ static bool unserialize_hook(const void *buf, size_t size)
 {
    runloop_state_t     *runloop_st = &runloop_state;
 
-   runloop_st->input_is_dirty      = true;
+   runloop_st->input_is_dirty         = true;
+   runloop_st->runahead_preempt_count = 0;
+   runloop_st->runahead_save_state_current = false;
+   input_state_clear_logged(runloop_st);
 
    if (runloop_st->retro_unserialize_callback_original)
       return runloop_st->retro_unserialize_callback_original(buf, size);
@@ -4456,7 +5003,7 @@ static void *runahead_save_state_alloc(void)
    if (    (runloop_st->runahead_save_state_size > 0)
          && runloop_st->runahead_save_state_size_known)
    {
-      savestate->data       = malloc(runloop_st->runahead_save_state_size);
+      savestate->data       = content_state_pool_get();
       savestate->data_const = savestate->data;
       savestate->size       = runloop_st->runahead_save_state_size;
    }
@@ -4469,7 +5016,7 @@ static void runahead_save_state_free(void *data)
    retro_ctx_serialize_info_t *savestate = (retro_ctx_serialize_info_t*)data;
    if (!savestate)
       return;
-   free(savestate->data);
+   content_state_pool_put(savestate->data);
    free(savestate);
 }
 
@@ -4480,6 +5027,8 @@ static void runahead_save_state_list_init(
    runloop_st->runahead_save_state_size       = save_state_size;
    runloop_st->runahead_save_state_size_known = true;
 
+   content_state_pool_init(save_state_size);
+
    mylist_create(&runloop_st->runahead_save_state_list, 16,
          runahead_save_state_alloc, runahead_save_state_free);
 }
@@ -4588,7 +5137,8 @@ static bool runahead_create(runloop_state_t *runloop_st)
    return true;
 }
 
-static bool runahead_save_state(runloop_state_t *runloop_st)
+static bool runahead_save_state(runloop_state_t *runloop_st,
+      unsigned slot)
 {
    retro_ctx_serialize_info_t *serialize_info;
    bool okay                       = false;
@@ -4597,7 +5147,7 @@ static bool runahead_save_state(runloop_state_t *runloop_st)
       return false;
 
    serialize_info                  =
-      (retro_ctx_serialize_info_t*)runloop_st->runahead_save_state_list->data[0];
+      (retro_ctx_serialize_info_t*)runloop_st->runahead_save_state_list->data[slot];
 
    runloop_st->request_fast_savestate = true;
    okay                               = core_serialize(serialize_info);
@@ -4610,13 +5160,15 @@ static bool runahead_save_state(runloop_state_t *runloop_st)
    return false;
 }
 
-static bool runahead_load_state(runloop_state_t *runloop_st)
+static bool runahead_load_state(runloop_state_t *runloop_st,
+      unsigned slot)
 {
    bool okay                                  = false;
    retro_ctx_serialize_info_t *serialize_info = 
       (retro_ctx_serialize_info_t*)
-      runloop_st->runahead_save_state_list->data[0];
+      runloop_st->runahead_save_state_list->data[slot];
    bool last_dirty                            = runloop_st->input_is_dirty;
+   unsigned last_preempt_count                = runloop_st->runahead_preempt_count;
 
    runloop_st->request_fast_savestate         = true;
    /* calling core_unserialize has side effects with
@@ -4627,6 +5179,7 @@ static bool runahead_load_state(runloop_state_t *runloop_st)
 
    runloop_st->request_fast_savestate         = false;
    runloop_st->input_is_dirty                 = last_dirty;
+   runloop_st->runahead_preempt_count         = last_preempt_count;
 
    if (!okay)
       runahead_error(runloop_st);
@@ -4660,6 +5213,98 @@ static bool runahead_load_state_secondary(void)
 }
 #endif
 
+#if defined(HAVE_DYNAMIC) && defined(HAVE_THREADS)
+static bool runahead_run_secondary_threaded(
+      runloop_state_t *runloop_st, int runahead_count)
+{
+   retro_perf_tick_t primary_start, primary_ticks;
+   struct runahead_secondary_thread *thr = runloop_st->secondary_thread;
+   video_driver_state_t *video_st        = video_state_get_ptr();
+   bool perfcnt_enable                   = runloop_st->perfcnt_enable;
+   bool speculate                        =
+      !runloop_st->runahead_force_input_dirty;
+   bool replay                           = !speculate;
+
+   performance_counter_init(runahead_secondary_overlap_perf,
+         "runahead_secondary_overlap");
+   performance_counter_init(runahead_secondary_stall_perf,
+         "runahead_secondary_stall");
+
+   /* Assume the input will not change, in which case the
+    * secondary core only needs to advance by one frame and
+    * can do so while the primary core is running */
+   if (speculate)
+      runahead_secondary_thread_queue(runloop_st,
+            RUNAHEAD_SECONDARY_JOB_RUN, 1, 0);
+
+   /* run main core with video suspended */
+   video_st->active     = false;
+   primary_start        = cpu_features_get_perf_counter();
+   core_run();
+   primary_ticks        = cpu_features_get_perf_counter() - primary_start;
+   video_st->active     = video_st->runahead_is_active;
+
+   if (runloop_st->input_is_dirty)
+      replay            = true;
+   runloop_st->input_is_dirty = false;
+
+   if (replay)
+   {
+      retro_ctx_serialize_info_t serialize_info;
+      bool okay;
+      unsigned slot          = thr->next_slot;
+
+      /* The speculative frame (if any) may still be running;
+       * serialize into the slot it is not using */
+      thr->next_slot        ^= 1;
+      serialize_info.data       = thr->slots[slot];
+      serialize_info.data_const = thr->slots[slot];
+      serialize_info.size       = thr->slot_size;
+
+      runloop_st->request_fast_savestate = true;
+      okay = core_serialize(&serialize_info);
+      runloop_st->request_fast_savestate = false;
+
+      if (speculate)
+         runahead_secondary_thread_wait(runloop_st);
+
+      if (!okay)
+      {
+         runahead_error(runloop_st);
+         runloop_msg_queue_push(msg_hash_to_str(MSG_RUNAHEAD_FAILED_TO_SAVE_STATE), 0, 3 * 60, true, NULL, MESSAGE_QUEUE_ICON_DEFAULT, MESSAGE_QUEUE_CATEGORY_INFO);
+         RARCH_WARN("[Run-Ahead]: %s\n", msg_hash_to_str(MSG_RUNAHEAD_FAILED_TO_SAVE_STATE));
+         return false;
+      }
+
+      runahead_secondary_thread_queue(runloop_st,
+            RUNAHEAD_SECONDARY_JOB_REPLAY, runahead_count, slot);
+   }
+
+   if (!runahead_secondary_thread_wait(runloop_st))
+   {
+      runloop_st->runahead_secondary_core_available = false;
+      runahead_error(runloop_st);
+      runloop_msg_queue_push(msg_hash_to_str(MSG_RUNAHEAD_FAILED_TO_LOAD_STATE), 0, 3 * 60, true, NULL, MESSAGE_QUEUE_ICON_DEFAULT, MESSAGE_QUEUE_CATEGORY_INFO);
+      RARCH_WARN("[Run-Ahead]: %s\n", msg_hash_to_str(MSG_RUNAHEAD_FAILED_TO_LOAD_STATE));
+      return false;
+   }
+
+   /* Only a speculative frame that turned out to be
+    * usable actually overlapped with the primary core */
+   if (perfcnt_enable && !replay)
+   {
+      runahead_secondary_overlap_perf.call_cnt++;
+      runahead_secondary_overlap_perf.total +=
+         (thr->job_ticks < primary_ticks) ? thr->job_ticks : primary_ticks;
+   }
+
+   video_driver_frame(thr->frame_valid ? thr->frame : NULL,
+         thr->frame_width, thr->frame_height, thr->frame_pitch);
+
+   return true;
+}
+#endif
+
 static void runahead_core_run_use_last_input(runloop_state_t *runloop_st)
 {
    struct retro_callbacks *cbs            = &runloop_st->retro_ctx;
@@ -4681,28 +5326,20 @@ static void runahead_core_run_use_last_input(runloop_state_t *runloop_st)
    runloop_st->current_core.retro_set_input_state(cbs->state_cb);
 }
 
-static void do_runahead(
-      runloop_state_t *runloop_st,
-      int runahead_count,
-      bool runahead_hide_warnings,
-      bool use_secondary)
+/**
+ * runahead_prepare:
+ *
+ * Creates the run-ahead savestate buffer and input hooks
+ * the first time they are needed.
+ *
+ * Returns: false if run-ahead cannot be used, in which
+ * case the caller should just run the core normally.
+ **/
+static bool runahead_prepare(runloop_state_t *runloop_st,
+      bool runahead_hide_warnings)
 {
-   int frame_number        = 0;
-   bool last_frame         = false;
-   bool suspended_frame    = false;
-#if defined(HAVE_DYNAMIC) || defined(HAVE_DYLIB)
-   const bool have_dynamic = true;
-#else
-   const bool have_dynamic = false;
-#endif
-   video_driver_state_t 
-      *video_st            = video_state_get_ptr();
-   uint64_t frame_count    = video_st->frame_count;
-   audio_driver_state_t 
-      *audio_st            = audio_state_get_ptr();
-
-   if (runahead_count <= 0 || !runloop_st->runahead_available)
-      goto force_input_dirty;
+   if (!runloop_st->runahead_available)
+      return false;
 
    if (!runloop_st->runahead_save_state_size_known)
    {
@@ -4723,7 +5360,7 @@ static void do_runahead(
           * runahead-compatible but subsequently fails in
           * execution */
          RARCH_WARN("[Run-Ahead]: %s\n", msg_hash_to_str(MSG_RUNAHEAD_CORE_DOES_NOT_SUPPORT_RUNAHEAD));
-         goto force_input_dirty;
+         return false;
       }
 
       if (!runahead_create(runloop_st))
@@ -4731,10 +5368,38 @@ static void do_runahead(
          if (!runahead_hide_warnings)
             runloop_msg_queue_push(msg_hash_to_str(MSG_RUNAHEAD_CORE_DOES_NOT_SUPPORT_SAVESTATES), 0, 2 * 60, true, NULL, MESSAGE_QUEUE_ICON_DEFAULT, MESSAGE_QUEUE_CATEGORY_INFO);
          RARCH_WARN("[Run-Ahead]: %s\n", msg_hash_to_str(MSG_RUNAHEAD_CORE_DOES_NOT_SUPPORT_SAVESTATES));
-         goto force_input_dirty;
+         return false;
       }
    }
 
+   return true;
+}
+
+static void do_runahead(
+      runloop_state_t *runloop_st,
+      int runahead_count,
+      bool runahead_hide_warnings,
+      bool use_secondary,
+      bool use_secondary_thread)
+{
+   int frame_number        = 0;
+   bool last_frame         = false;
+   bool suspended_frame    = false;
+#if defined(HAVE_DYNAMIC) || defined(HAVE_DYLIB)
+   const bool have_dynamic = true;
+#else
+   const bool have_dynamic = false;
+#endif
+   video_driver_state_t 
+      *video_st            = video_state_get_ptr();
+   uint64_t frame_count    = video_st->frame_count;
+   audio_driver_state_t 
+      *audio_st            = audio_state_get_ptr();
+
+   if (     runahead_count <= 0
+         || !runahead_prepare(runloop_st, runahead_hide_warnings))
+      goto force_input_dirty;
+
    /* Check for GUI */
    /* Hack: If we were in the GUI, force a resync. */
    if (frame_count != runloop_st->runahead_last_frame_count + 1)
@@ -4772,7 +5437,7 @@ static void do_runahead(
 
          if (frame_number == 0)
          {
-            if (!runahead_save_state(runloop_st))
+            if (!runahead_save_state(runloop_st, 0))
             {
                runloop_msg_queue_push(msg_hash_to_str(MSG_RUNAHEAD_FAILED_TO_SAVE_STATE), 0, 3 * 60, true, NULL, MESSAGE_QUEUE_ICON_DEFAULT, MESSAGE_QUEUE_CATEGORY_INFO);
                RARCH_WARN("[Run-Ahead]: %s\n", msg_hash_to_str(MSG_RUNAHEAD_FAILED_TO_SAVE_STATE));
@@ -4782,12 +5447,16 @@ static void do_runahead(
 
          if (last_frame)
          {
-            if (!runahead_load_state(runloop_st))
+            if (!runahead_load_state(runloop_st, 0))
             {
                runloop_msg_queue_push(msg_hash_to_str(MSG_RUNAHEAD_FAILED_TO_LOAD_STATE), 0, 3 * 60, true, NULL, MESSAGE_QUEUE_ICON_DEFAULT, MESSAGE_QUEUE_CATEGORY_INFO);
                RARCH_WARN("[Run-Ahead]: %s\n", msg_hash_to_str(MSG_RUNAHEAD_FAILED_TO_LOAD_STATE));
                return;
             }
+
+            /* The core is now exactly at the saved state,
+             * rewind can take it instead of serializing */
+            runloop_st->runahead_save_state_current = true;
          }
       }
    }
@@ -4803,6 +5472,17 @@ static void do_runahead(
          goto force_input_dirty;
       }
 
+#ifdef HAVE_THREADS
+      if (     use_secondary_thread
+            && !video_driver_is_hw_context()
+            && runahead_secondary_thread_init(runloop_st))
+      {
+         if (runahead_run_secondary_threaded(runloop_st, runahead_count))
+            runloop_st->runahead_force_input_dirty = false;
+         return;
+      }
+#endif
+
       /* run main core with video suspended */
       video_st->active     = false;
       core_run();
@@ -4813,7 +5493,7 @@ static void do_runahead(
       {
          runloop_st->input_is_dirty       = false;
 
-         if (!runahead_save_state(runloop_st))
+         if (!runahead_save_state(runloop_st, 0))
          {
             runloop_msg_queue_push(msg_hash_to_str(MSG_RUNAHEAD_FAILED_TO_SAVE_STATE), 0, 3 * 60, true, NULL, MESSAGE_QUEUE_ICON_DEFAULT, MESSAGE_QUEUE_CATEGORY_INFO);
             RARCH_WARN("[Run-Ahead]: %s\n", msg_hash_to_str(MSG_RUNAHEAD_FAILED_TO_SAVE_STATE));
@@ -4854,6 +5534,186 @@ force_input_dirty:
    core_run();
    runloop_st->runahead_force_input_dirty= true;
 }
+
+/* Preemptive frames
+ *
+ * Instead of re-running 'frames' frames every frame, keep the
+ * savestates taken before each of the last 'frames' frames and
+ * only roll back and replay them when the input the core is
+ * about to see differs from what it saw last frame. While input
+ * is unchanged this costs a single savestate per frame. */
+
+static struct retro_perf_counter runahead_preempt_frame_perf;
+static struct retro_perf_counter runahead_preempt_replay_perf;
+
+/* Returns true if any input the core read last frame
+ * now has a different value. Reads the inputs through
+ * input_state_internal(), as input_driver_state_wrapper()
+ * would consume BSV movie input and flag analog requests. */
+static bool runahead_preempt_input_changed(runloop_state_t *runloop_st)
+{
+   int i;
+
+   if (!runloop_st->input_state_list)
+      return false;
+
+   for (i = 0; i < runloop_st->input_state_list->size; i++)
+   {
+      unsigned id;
+      input_list_element *element =
+         (input_list_element*)runloop_st->input_state_list->data[i];
+
+      for (id = 0; id < element->state_size; id++)
+      {
+         if (!element->logged[id])
+            continue;
+         if (input_state_internal(element->port,
+                  element->device, element->index, id)
+               != element->state[id])
+            return true;
+      }
+   }
+
+   return false;
+}
+
+static void runahead_preempt_core_run(runloop_state_t *runloop_st)
+{
+   struct retro_callbacks *cbs          = &runloop_st->retro_ctx;
+   retro_input_poll_t old_poll_function = cbs->poll_cb;
+
+   /* Input has already been polled for this frame */
+   cbs->poll_cb                         = retro_input_poll_null;
+   runloop_st->current_core.retro_set_input_poll(cbs->poll_cb);
+
+   core_run();
+
+   cbs->poll_cb                         = old_poll_function;
+   runloop_st->current_core.retro_set_input_poll(cbs->poll_cb);
+}
+
+static bool runahead_preempt_replay(runloop_state_t *runloop_st,
+      unsigned frames)
+{
+   unsigned i;
+   video_driver_state_t *video_st = video_state_get_ptr();
+   audio_driver_state_t *audio_st = audio_state_get_ptr();
+   unsigned count                 = runloop_st->runahead_preempt_count;
+   unsigned oldest                = (runloop_st->runahead_preempt_pos
+         + frames - count) % frames;
+
+   if (!runahead_load_state(runloop_st, oldest))
+      return false;
+
+   for (i = 0; i < count; i++)
+   {
+      /* The oldest state is still valid, the rest
+       * are replaced by the states with the new input */
+      if (i > 0 && !runahead_save_state(runloop_st, (oldest + i) % frames))
+         return false;
+
+      audio_st->suspended = true;
+      video_st->active    = false;
+      runahead_preempt_core_run(runloop_st);
+      video_st->active    = video_st->runahead_is_active;
+      audio_st->suspended = false;
+   }
+
+   return true;
+}
+
+static void do_runahead_preempt(
+      runloop_state_t *runloop_st,
+      unsigned frames,
+      bool runahead_hide_warnings)
+{
+   video_driver_state_t *video_st = video_state_get_ptr();
+   uint64_t frame_count           = video_st->frame_count;
+   bool perfcnt_enable            = runloop_st->perfcnt_enable;
+#ifdef HAVE_BSV_MOVIE
+   input_driver_state_t *input_st = input_state_get_ptr();
+
+   /* The movie records and replays exactly the input the core
+    * reads, which rolling back would read a second time */
+   if (input_st->bsv_movie_state_handle)
+      frames                      = 0;
+#endif
+
+   if (     !frames
+         || !runahead_prepare(runloop_st, runahead_hide_warnings))
+   {
+      core_run();
+      runloop_st->runahead_force_input_dirty = true;
+      return;
+   }
+
+   performance_counter_init(runahead_preempt_frame_perf,
+         "runahead_preempt_frame");
+   performance_counter_init(runahead_preempt_replay_perf,
+         "runahead_preempt_replay");
+   performance_counter_start_plus(perfcnt_enable,
+         runahead_preempt_frame_perf);
+
+   /* Hack: If we were in the GUI, force a resync. */
+   if (frame_count != runloop_st->runahead_last_frame_count + 1)
+      runloop_st->runahead_force_input_dirty = true;
+   runloop_st->runahead_last_frame_count     = frame_count;
+
+   if (     runloop_st->runahead_preempt_frames != frames
+         || runloop_st->runahead_save_state_list->size != (int)frames)
+   {
+      mylist_resize(runloop_st->runahead_save_state_list, frames, true);
+      runloop_st->runahead_preempt_frames    = frames;
+      runloop_st->runahead_force_input_dirty = true;
+   }
+
+   if (runloop_st->runahead_force_input_dirty)
+   {
+      runloop_st->runahead_preempt_pos       = 0;
+      runloop_st->runahead_preempt_count     = 0;
+      runloop_st->runahead_force_input_dirty = false;
+      input_state_clear_logged(runloop_st);
+   }
+
+   input_driver_poll();
+
+   if (     runloop_st->runahead_preempt_count
+         && runahead_preempt_input_changed(runloop_st))
+   {
+      bool okay;
+
+      performance_counter_start_plus(perfcnt_enable,
+            runahead_preempt_replay_perf);
+      okay = runahead_preempt_replay(runloop_st, frames);
+      performance_counter_stop_plus(perfcnt_enable,
+            runahead_preempt_replay_perf);
+
+      if (!okay)
+      {
+         runloop_msg_queue_push(msg_hash_to_str(MSG_RUNAHEAD_FAILED_TO_LOAD_STATE), 0, 3 * 60, true, NULL, MESSAGE_QUEUE_ICON_DEFAULT, MESSAGE_QUEUE_CATEGORY_INFO);
+         RARCH_WARN("[Run-Ahead]: %s\n", msg_hash_to_str(MSG_RUNAHEAD_FAILED_TO_LOAD_STATE));
+         goto end;
+      }
+   }
+
+   if (!runahead_save_state(runloop_st, runloop_st->runahead_preempt_pos))
+   {
+      runloop_msg_queue_push(msg_hash_to_str(MSG_RUNAHEAD_FAILED_TO_SAVE_STATE), 0, 3 * 60, true, NULL, MESSAGE_QUEUE_ICON_DEFAULT, MESSAGE_QUEUE_CATEGORY_INFO);
+      RARCH_WARN("[Run-Ahead]: %s\n", msg_hash_to_str(MSG_RUNAHEAD_FAILED_TO_SAVE_STATE));
+      goto end;
+   }
+
+   runloop_st->runahead_preempt_pos =
+      (runloop_st->runahead_preempt_pos + 1) % frames;
+   if (runloop_st->runahead_preempt_count < frames)
+      runloop_st->runahead_preempt_count++;
+
+   runahead_preempt_core_run(runloop_st);
+
+end:
+   performance_counter_stop_plus(perfcnt_enable,
+         runahead_preempt_frame_perf);
+}
 #endif
 
 static retro_time_t runloop_core_runtime_tick(
@@ -4981,6 +5841,83 @@ static void runloop_apply_fastmotion_override(runloop_state_t *runloop_st, setti
 }
 
 
+/* Frame delay profiles go to
+ * <cache>/frame_delay/<core name>/<content name>.cfg */
+static void runloop_frame_delay_profile_path(runloop_state_t *runloop_st,
+      char *s, size_t len, bool create_dir)
+{
+   char dir[PATH_MAX_LENGTH];
+   char name[NAME_MAX_LENGTH];
+   const char *core_name = runloop_st->system.info.library_name;
+   const char *content   = path_basename(
+         runloop_st->runtime_content_path_basename);
+
+   s[0] = '\0';
+
+   if (string_is_empty(core_name) || string_is_empty(content))
+      return;
+
+   fill_pathname_application_special(dir, sizeof(dir),
+         APPLICATION_SPECIAL_DIRECTORY_CACHE);
+   if (string_is_empty(dir))
+      return;
+
+   fill_pathname_join(dir, dir, "frame_delay", sizeof(dir));
+   fill_pathname_join(dir, dir, core_name, sizeof(dir));
+   if (create_dir && !path_is_directory(dir) && !path_mkdir(dir))
+      return;
+
+   strlcpy(name, content, sizeof(name));
+   strlcat(name, ".cfg", sizeof(name));
+   fill_pathname_join(s, dir, name, len);
+}
+
+/* Saves what the frame delay learned for this content,
+ * then forgets it so that it cannot end up in the
+ * profile of whatever runs next. */
+static void runloop_frame_delay_profile_save(runloop_state_t *runloop_st,
+      video_driver_state_t *video_st)
+{
+   char path[PATH_MAX_LENGTH];
+   frame_delay_learn_t *fdl = &video_st->frame_delay_learn;
+
+   if (!frame_delay_learn_ready(fdl))
+      return;
+
+   if (fdl->frames)
+      RARCH_LOG("[Video]: Frame delay averaged %.1f over %" PRIu64
+            " frames, %" PRIu64 " missed deadlines.\n",
+            (double)fdl->delay_sum / fdl->frames, fdl->frames, fdl->misses);
+
+   runloop_frame_delay_profile_path(runloop_st, path, sizeof(path), true);
+   if (frame_delay_learn_save(fdl, path))
+      RARCH_LOG("[Video]: Saved frame delay profile \"%s\".\n", path);
+
+   frame_delay_learn_init(fdl, 0.0f, 0, 0);
+}
+
+static void runloop_frame_delay_learn(video_driver_state_t *video_st,
+      retro_time_t core_run_time)
+{
+   frame_delay_learn_t *fdl = &video_st->frame_delay_learn;
+   uint64_t misses          = fdl->misses;
+   retro_time_t frame_time  = video_st->frame_time_samples[
+         (video_st->frame_time_count - 1)
+         & (MEASURE_FRAME_TIME_SAMPLES_COUNT - 1)];
+
+   if (!frame_delay_learn_push(fdl, core_run_time, frame_time))
+      return;
+
+   if (fdl->misses != misses)
+      RARCH_LOG("[Video]: Frame delay decrease to %u due to missed deadline: %d > %u, headroom now %u usec.\n",
+            fdl->delay, (int)frame_time, fdl->period, fdl->headroom);
+   else
+      RARCH_LOG("[Video]: Frame delay set to %u for core run time %u usec (%u%%) + headroom %u usec,"
+            " input lag %u ms lower than without frame delay, %" PRIu64 " missed deadlines.\n",
+            fdl->delay, fdl->work_high, FRAME_DELAY_LEARN_PERMILLE / 10,
+            fdl->headroom, fdl->delay, fdl->misses);
+}
+
 void runloop_event_deinit_core(void)
 {
    video_driver_state_t 
@@ -4988,6 +5925,9 @@ void runloop_event_deinit_core(void)
    runloop_state_t *runloop_st = &runloop_state;
    settings_t        *settings = config_get_ptr();
 
+   /* Keep what the frame delay learned for next time */
+   runloop_frame_delay_profile_save(runloop_st, video_st);
+
    core_unload_game();
 
    video_driver_set_cached_frame_ptr(NULL);
@@ -5454,6 +6394,39 @@ void runloop_runahead_clear_variables(runloop_state_t *runloop_st)
    runloop_st->runahead_secondary_core_available = true;
    runloop_st->runahead_force_input_dirty        = true;
    runloop_st->runahead_last_frame_count         = 0;
+   runloop_st->runahead_preempt_frames           = 0;
+   runloop_st->runahead_preempt_pos              = 0;
+   runloop_st->runahead_preempt_count            = 0;
+   runloop_st->runahead_save_state_current       = false;
+}
+
+bool runloop_runahead_exchange_state(void **data, size_t size)
+{
+   void *rastate;
+   retro_ctx_serialize_info_t *serialize_info;
+   runloop_state_t *runloop_st = &runloop_state;
+
+   if (     !runloop_st->runahead_save_state_current
+         || !runloop_st->runahead_save_state_list
+         ||  runloop_st->runahead_save_state_list->size < 1
+         ||  runloop_st->runahead_save_state_size
+               != content_state_pool_get_size()
+         ||  content_state_pool_get_rastate_size() != size)
+      return false;
+
+   serialize_info = (retro_ctx_serialize_info_t*)
+      runloop_st->runahead_save_state_list->data[0];
+   if (!serialize_info->data)
+      return false;
+
+   rastate                    = content_state_pool_to_rastate(
+         serialize_info->data);
+   serialize_info->data       = content_state_pool_from_rastate(*data);
+   serialize_info->data_const = serialize_info->data;
+   *data                      = rastate;
+
+   runloop_st->runahead_save_state_current = false;
+   return true;
 }
 #endif
 
@@ -7180,6 +8153,8 @@ static enum runloop_state_enum runloop_check_state(
 
          s[0]           = '\0';
 
+         frame_profiler_begin(FRAME_PROFILER_THREAD_MAIN,
+               FRAME_PROFILER_STAGE_REWIND);
          rewinding      = state_manager_check_rewind(
                &runloop_st->rewind_st,
                &runloop_st->current_core,
@@ -7187,6 +8162,8 @@ static enum runloop_state_enum runloop_check_state(
                settings->uints.rewind_granularity,
                runloop_st->paused,
                s, sizeof(s), &t);
+         frame_profiler_end(FRAME_PROFILER_THREAD_MAIN,
+               FRAME_PROFILER_STAGE_REWIND);
 
 #if defined(HAVE_GFX_WIDGETS)
          if (widgets_active)
@@ -7399,7 +8376,12 @@ int runloop_iterate(void)
    bool audio_sync                              = settings->bools.audio_sync;
 #ifdef HAVE_DISCORD
    discord_state_t *discord_st                  = discord_state_get_ptr();
+#endif
+
+   frame_profiler_update(settings->bools.frame_profiler_enable,
+         settings->bools.frame_profiler_show_graph);
 
+#ifdef HAVE_DISCORD
    if (discord_st->inited)
    {
       Discord_RunCallbacks();
@@ -7611,6 +8593,7 @@ int runloop_iterate(void)
    {
       if (settings->bools.video_frame_delay_auto)
       {
+         frame_delay_learn_t *fdl     = &video_st->frame_delay_learn;
          float refresh_rate           = settings->floats.video_refresh_rate;
          unsigned video_swap_interval = settings->uints.video_swap_interval;
          unsigned video_bfi           = settings->uints.video_black_frame_insertion;
@@ -7627,13 +8610,31 @@ int runloop_iterate(void)
          if (video_frame_delay == 0)
             video_frame_delay = 1 / refresh_rate * 1000 / 2;
 
-         if (video_st->frame_delay_target != video_frame_delay)
+         if (     video_st->frame_delay_target != video_frame_delay
+               || !fdl->period)
          {
-            video_st->frame_delay_target = video_frame_delay_effective = video_frame_delay;
-            RARCH_LOG("[Video]: Frame delay reset to %d.\n", video_frame_delay);
+            char path[PATH_MAX_LENGTH];
+
+            /* Same content, new timing */
+            runloop_frame_delay_profile_save(runloop_st, video_st);
+
+            video_st->frame_delay_target = video_frame_delay;
+            frame_delay_learn_init(fdl, refresh_rate,
+                  video_frame_delay, video_frame_delay);
+            runloop_frame_delay_profile_path(runloop_st,
+                  path, sizeof(path), false);
+            if (frame_delay_learn_load(fdl, path))
+               RARCH_LOG("[Video]: Frame delay reset to %u learned for this content.\n",
+                     fdl->delay);
+            else
+               RARCH_LOG("[Video]: Frame delay reset to %d.\n", video_frame_delay);
          }
 
-         if (video_frame_delay_effective > 0 && frame_time_update)
+         /* Until the core run time is known, frame times
+          * alone bring the delay down */
+         if (     fdl->delay > 0
+               && frame_time_update
+               && !frame_delay_learn_ready(fdl))
          {
             video_frame_delay_auto_t vfda = {0};
             vfda.frame_time_interval      = frame_time_interval;
@@ -7642,11 +8643,13 @@ int runloop_iterate(void)
             video_frame_delay_auto(video_st, &vfda);
             if (vfda.decrease > 0)
             {
-               video_frame_delay_effective -= vfda.decrease;
+               fdl->delay -= vfda.decrease;
                RARCH_LOG("[Video]: Frame delay decrease by %d to %d due to frame time: %d > %d.\n",
-                     vfda.decrease, video_frame_delay_effective, vfda.time, vfda.target);
+                     vfda.decrease, fdl->delay, vfda.time, vfda.target);
             }
          }
+
+         video_frame_delay_effective = fdl->delay;
       }
       else
          video_st->frame_delay_target = video_frame_delay_effective = video_frame_delay;
@@ -7654,15 +8657,31 @@ int runloop_iterate(void)
       video_st->frame_delay_effective = video_frame_delay_effective;
 
       if (video_frame_delay_effective > 0)
+      {
+         frame_profiler_begin(FRAME_PROFILER_THREAD_MAIN,
+               FRAME_PROFILER_STAGE_SLEEP);
          retro_sleep(video_frame_delay_effective);
+         frame_profiler_end(FRAME_PROFILER_THREAD_MAIN,
+               FRAME_PROFILER_STAGE_SLEEP);
+      }
    }
 
    {
+      /* What the core takes of the frame, video driver aside,
+       * is what the automatic frame delay learns from */
+      bool frame_delay_learn            = video_st->frame_delay_target
+            && settings->bools.video_frame_delay_auto
+            && input_st && !input_st->nonblocking_flag;
+      uint64_t frame_count              = video_st->frame_count;
+      retro_time_t present_time         = video_st->frame_present_time;
+      retro_time_t core_run_start       = cpu_features_get_time_usec();
 #ifdef HAVE_RUNAHEAD
       bool run_ahead_enabled            = settings->bools.run_ahead_enabled;
       unsigned run_ahead_num_frames     = settings->uints.run_ahead_frames;
       bool run_ahead_hide_warnings      = settings->bools.run_ahead_hide_warnings;
       bool run_ahead_secondary_instance = settings->bools.run_ahead_secondary_instance;
+      bool run_ahead_secondary_threaded = settings->bools.run_ahead_secondary_threaded;
+      bool run_ahead_preemptive_frames  = settings->bools.run_ahead_preemptive_frames;
       /* Run Ahead Feature replaces the call to core_run in this loop */
       bool want_runahead                = run_ahead_enabled &&
             (run_ahead_num_frames > 0) && runloop_st->runahead_available;
@@ -7670,15 +8689,39 @@ int runloop_iterate(void)
       want_runahead                     = want_runahead && !netplay_driver_ctl(RARCH_NETPLAY_CTL_IS_ENABLED, NULL);
 #endif
 
+      runloop_st->runahead_save_state_current = false;
+
       if (want_runahead)
-         do_runahead(
-               runloop_st,
-               run_ahead_num_frames,
-               run_ahead_hide_warnings,
-               run_ahead_secondary_instance);
+      {
+         /* Frames run through core_run() are recorded as such,
+          * what remains is savestate and secondary core overhead. */
+         frame_profiler_begin(FRAME_PROFILER_THREAD_MAIN,
+               FRAME_PROFILER_STAGE_RUNAHEAD);
+         if (run_ahead_preemptive_frames)
+            do_runahead_preempt(
+                  runloop_st,
+                  run_ahead_num_frames,
+                  run_ahead_hide_warnings);
+         else
+            do_runahead(
+                  runloop_st,
+                  run_ahead_num_frames,
+                  run_ahead_hide_warnings,
+                  run_ahead_secondary_instance,
+                  run_ahead_secondary_threaded);
+         frame_profiler_end(FRAME_PROFILER_THREAD_MAIN,
+               FRAME_PROFILER_STAGE_RUNAHEAD);
+      }
       else
 #endif
          core_run();
+
+      if (     frame_delay_learn
+            && video_st->frame_count != frame_count
+            && video_st->frame_time_count)
+         runloop_frame_delay_learn(video_st,
+                 cpu_features_get_time_usec() - core_run_start
+               - (video_st->frame_present_time - present_time));
    }
 
    /* Increment runtime tick counter after each call to
@@ -7798,10 +8841,14 @@ end:
 
          if (sleep_ms > 0)
          {
+            frame_profiler_begin(FRAME_PROFILER_THREAD_MAIN,
+                  FRAME_PROFILER_STAGE_SLEEP);
 #if defined(HAVE_COCOATOUCH)
             if (!uico_state_get_ptr()->is_on_foreground)
 #endif
                retro_sleep(sleep_ms);
+            frame_profiler_end(FRAME_PROFILER_THREAD_MAIN,
+                  FRAME_PROFILER_STAGE_SLEEP);
          }
 
          return 1;
@@ -8250,6 +9297,9 @@ bool core_run(void)
    }
 #endif
 
+   frame_profiler_begin(FRAME_PROFILER_THREAD_MAIN,
+         FRAME_PROFILER_STAGE_CORE_RUN);
+
    if (early_polling)
       input_driver_poll();
    else if (late_polling)
@@ -8260,6 +9310,9 @@ bool core_run(void)
    if (late_polling && !current_core->input_polled)
       input_driver_poll();
 
+   frame_profiler_end(FRAME_PROFILER_THREAD_MAIN,
+         FRAME_PROFILER_STAGE_CORE_RUN);
+
 #ifdef HAVE_NETWORKING
    netplay_driver_ctl(RARCH_NETPLAY_CTL_POST_FRAME, NULL);
 #endif
@@ -174,6 +174,9 @@ struct runloop
       retro_unserialize_callback_original;               /* ptr alignment */
 #if defined(HAVE_DYNAMIC) || defined(HAVE_DYLIB)
    struct retro_callbacks secondary_callbacks;           /* ptr alignment */
+#ifdef HAVE_THREADS
+   struct runahead_secondary_thread *secondary_thread;   /* ptr alignment */
+#endif
 #endif
 #endif
 #ifdef HAVE_THREADS
@@ -219,6 +222,11 @@ struct runloop
    unsigned perf_ptr_libretro;
    unsigned subsystem_current_count;
    unsigned entry_state_slot;
+#if defined(HAVE_RUNAHEAD)
+   unsigned runahead_preempt_frames;
+   unsigned runahead_preempt_pos;
+   unsigned runahead_preempt_count;
+#endif
 
    fastmotion_overrides_t fastmotion_override; /* float alignment */
 
@@ -291,6 +299,7 @@ struct runloop
    bool runahead_available;
    bool runahead_secondary_core_available;
    bool runahead_force_input_dirty;
+   bool runahead_save_state_current;
 #endif
 #ifdef HAVE_PATCH
    bool patch_blocked;
@@ -398,6 +407,20 @@ void runloop_event_deinit_core(void);
 
 #ifdef HAVE_RUNAHEAD
 void runloop_runahead_clear_variables(runloop_state_t *runloop_st);
+
+/**
+ * runloop_runahead_exchange_state:
+ * @data       : in: pooled RASTATE image (see content_state_pool_to_rastate)
+ *               to give to run-ahead. out: RASTATE image of the current
+ *               core state.
+ * @size       : size of the RASTATE image.
+ *
+ * If run-ahead left the core at a state it still has serialized,
+ * swaps that buffer for the caller's, saving a serialization.
+ *
+ * Returns: true if the buffers were exchanged.
+ **/
+bool runloop_runahead_exchange_state(void **data, size_t size);
 #endif
 
 bool runloop_event_init_core(
@@ -0,0 +1,366 @@
+/* Audio resampler benchmark.
+ *
+ * Resamples a 1 kHz stereo sine from 44.1 kHz to 48 kHz, in
+ * blocks the size audio_driver_flush() typically hands to the
+ * resampler, with the sinc, nearest and polyphase drivers at
+ * every quality level. Reports throughput and THD+N of the
+ * output; the latter is the energy left after removing the best
+ * fitting 1 kHz sine, relative to that sine.
+ *
+ * The polyphase driver is also run once per SIMD kernel the CPU
+ * supports, and with 6 channels to show the multichannel path:
+ *
+ *    ./audio_resampler_bench [seconds of audio]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#include <boolean.h>
+#include <retro_miscellaneous.h>
+#include <features/features_cpu.h>
+#include <audio/audio_resampler.h>
+
+#define BENCH_IN_RATE    44100.0
+#define BENCH_OUT_RATE   48000.0
+#define BENCH_TONE       1000.0
+#define BENCH_AMPLITUDE  0.5
+#define BENCH_BLOCK      1024
+/* Output frames skipped before measuring, covers the
+ * longest filter delay */
+#define BENCH_SETTLE     4096
+
+struct bench_result
+{
+   double frames_per_sec;
+   double thd_n;
+   size_t out_frames;
+};
+
+static const char *bench_quality_names[] = {
+   "dontcare",
+   "lowest",
+   "lower",
+   "normal",
+   "higher",
+   "highest"
+};
+
+/* Solves the n x n system m * x = v in place, n <= 5. */
+static bool bench_solve(double m[5][5], double *v, unsigned n)
+{
+   unsigned i, j, k;
+
+   for (i = 0; i < n; i++)
+   {
+      unsigned pivot = i;
+      for (j = i + 1; j < n; j++)
+         if (fabs(m[j][i]) > fabs(m[pivot][i]))
+            pivot = j;
+      if (m[pivot][i] == 0.0)
+         return false;
+      if (pivot != i)
+      {
+         double tmp;
+         for (k = 0; k < n; k++)
+         {
+            tmp         = m[i][k];
+            m[i][k]     = m[pivot][k];
+            m[pivot][k] = tmp;
+         }
+         tmp      = v[i];
+         v[i]     = v[pivot];
+         v[pivot] = tmp;
+      }
+      for (j = i + 1; j < n; j++)
+      {
+         double f = m[j][i] / m[i][i];
+         for (k = i; k < n; k++)
+            m[j][k] -= f * m[i][k];
+         v[j] -= f * v[i];
+      }
+   }
+
+   for (i = n; i-- > 0; )
+   {
+      for (k = i + 1; k < n; k++)
+         v[i] -= m[i][k] * v[k];
+      v[i] /= m[i][i];
+   }
+
+   return true;
+}
+
+/* Least-squares fit of sin, cos, a constant and (while refining
+ * the frequency) their derivative with respect to frequency. */
+static bool bench_fit(const float *out, size_t frames,
+      unsigned channels, double w, unsigned n, double *x)
+{
+   size_t i;
+   unsigned j, k;
+   double m[5][5] = {{0}};
+   double t0      = (BENCH_SETTLE + frames) / 2.0;
+
+   for (j = 0; j < n; j++)
+      x[j] = 0.0;
+
+   for (i = BENCH_SETTLE; i < frames; i++)
+   {
+      double t    = i - t0;
+      double s    = sin(w * t);
+      double co   = cos(w * t);
+      double b[5];
+      b[0]        = s;
+      b[1]        = co;
+      b[2]        = 1.0;
+      b[3]        = t * co;
+      b[4]        = -t * s;
+      for (j = 0; j < n; j++)
+      {
+         x[j] += b[j] * out[i * channels];
+         for (k = 0; k < n; k++)
+            m[j][k] += b[j] * b[k];
+      }
+   }
+
+   return bench_solve(m, x, n);
+}
+
+/* Fits a sine of the tone frequency, refining the frequency as
+ * the resamplers' fixed-point step shifts it slightly, and returns
+ * 10*log10(residual energy / fitted sine energy). */
+static double bench_thd_n(const float *out, size_t frames,
+      unsigned channels, double rate)
+{
+   size_t i;
+   unsigned iter;
+   double x[5];
+   double signal   = 0.0;
+   double residual = 0.0;
+   double w        = 2.0 * M_PI * BENCH_TONE / rate;
+   double t0       = (BENCH_SETTLE + frames) / 2.0;
+
+   if (frames <= BENCH_SETTLE)
+      return 0.0;
+
+   /* Gauss-Newton on the frequency */
+   for (iter = 0; iter < 4; iter++)
+   {
+      double amp;
+      if (!bench_fit(out, frames, channels, w, 5, x))
+         return 0.0;
+      if ((amp = x[0] * x[0] + x[1] * x[1]) <= 0.0)
+         return 0.0;
+      w += (x[0] * x[3] + x[1] * x[4]) / amp;
+   }
+
+   if (!bench_fit(out, frames, channels, w, 3, x))
+      return 0.0;
+
+   for (i = BENCH_SETTLE; i < frames; i++)
+   {
+      double t   = i - t0;
+      double fit = x[0] * sin(w * t) + x[1] * cos(w * t);
+      double err = out[i * channels] - fit - x[2];
+      signal    += fit * fit;
+      residual  += err * err;
+   }
+
+   if (residual <= 0.0)
+      return -200.0;
+   return 10.0 * log10(residual / signal);
+}
+
+static float *bench_make_input(size_t frames, unsigned channels)
+{
+   size_t i;
+   unsigned c;
+   float *in = (float*)malloc(frames * channels * sizeof(float));
+
+   if (!in)
+      return NULL;
+
+   for (i = 0; i < frames; i++)
+      for (c = 0; c < channels; c++)
+         in[i * channels + c] = (float)(BENCH_AMPLITUDE
+               * sin(2.0 * M_PI * BENCH_TONE * i / BENCH_IN_RATE
+                  + c * 0.25));
+   return in;
+}
+
+static bool bench_driver(retro_resampler_t *driver,
+      enum resampler_quality quality, resampler_simd_mask_t mask,
+      const float *in, size_t in_frames, float *out,
+      struct bench_result *res)
+{
+   size_t pos;
+   retro_time_t start;
+   double ratio = BENCH_OUT_RATE / BENCH_IN_RATE;
+   void *re     = driver->init(NULL, ratio, quality, mask);
+
+   if (!re)
+      return false;
+
+   res->out_frames = 0;
+   start           = cpu_features_get_time_usec();
+
+   for (pos = 0; pos < in_frames; pos += BENCH_BLOCK)
+   {
+      struct resampler_data data;
+
+      data.data_in       = in + pos * 2;
+      data.data_out      = out + res->out_frames * 2;
+      data.input_frames  = MIN(BENCH_BLOCK, in_frames - pos);
+      data.output_frames = 0;
+      data.ratio         = ratio;
+
+      driver->process(re, &data);
+      res->out_frames   += data.output_frames;
+   }
+
+   res->frames_per_sec = in_frames * 1000000.0
+      / MAX(cpu_features_get_time_usec() - start, 1);
+   res->thd_n          = bench_thd_n(out, res->out_frames, 2,
+         BENCH_OUT_RATE);
+
+   driver->free(re);
+   return true;
+}
+
+static bool bench_polyphase(unsigned channels,
+      enum resampler_quality quality, resampler_simd_mask_t mask,
+      const float *in, size_t in_frames, float *out,
+      struct bench_result *res, const char **kernel)
+{
+   size_t pos;
+   retro_time_t start;
+   double ratio              = BENCH_OUT_RATE / BENCH_IN_RATE;
+   polyphase_resampler_t *re = polyphase_resampler_new(channels,
+         ratio, quality, mask);
+
+   if (!re)
+      return false;
+
+   *kernel         = polyphase_resampler_kernel(re);
+   res->out_frames = 0;
+   start           = cpu_features_get_time_usec();
+
+   for (pos = 0; pos < in_frames; pos += BENCH_BLOCK)
+      res->out_frames += polyphase_resampler_process(re,
+            in + pos * channels, MIN(BENCH_BLOCK, in_frames - pos),
+            out + res->out_frames * channels, ratio);
+
+   res->frames_per_sec = in_frames * 1000000.0
+      / MAX(cpu_features_get_time_usec() - start, 1);
+   res->thd_n          = bench_thd_n(out, res->out_frames, channels,
+         BENCH_OUT_RATE);
+
+   polyphase_resampler_free(re);
+   return true;
+}
+
+static void bench_print(const char *name, const char *quality,
+      const char *kernel, unsigned channels,
+      const struct bench_result *res)
+{
+   printf("%-10s %-9s %-7s %3u %14.2f %10.1f\n",
+         name, quality, kernel, channels,
+         res->frames_per_sec * channels / 1000000.0, res->thd_n);
+}
+
+int main(int argc, char *argv[])
+{
+   unsigned q, k;
+   size_t in_frames;
+   float *in, *in_multi, *out;
+   struct bench_result res;
+   double seconds                   = 10.0;
+   resampler_simd_mask_t cpu_mask   = (resampler_simd_mask_t)
+      cpu_features_get();
+   uint64_t cpu_ext                 = cpu_features_get_extensions();
+   const char *kernel               = NULL;
+   static const struct
+   {
+      const char *name;
+      resampler_simd_mask_t mask;
+   } kernels[] = {
+      { "c",      0 },
+      { "sse",    RESAMPLER_SIMD_SSE },
+      { "avx2",   RESAMPLER_SIMD_SSE | RESAMPLER_SIMD_AVX2
+                | RESAMPLER_SIMD_FMA },
+      { "avx512", RESAMPLER_SIMD_SSE | RESAMPLER_SIMD_AVX2
+                | RESAMPLER_SIMD_FMA | RESAMPLER_SIMD_AVX512 },
+      { "neon",   RESAMPLER_SIMD_NEON }
+   };
+
+   if (cpu_ext & CPU_FEATURES_FMA)
+      cpu_mask |= RESAMPLER_SIMD_FMA;
+   if (cpu_ext & CPU_FEATURES_AVX512)
+      cpu_mask |= RESAMPLER_SIMD_AVX512;
+
+   if (argc > 1)
+      seconds = atof(argv[1]);
+   if (seconds <= 0.0)
+   {
+      fprintf(stderr, "Usage: %s [seconds of audio]\n", argv[0]);
+      return 1;
+   }
+
+   in_frames = (size_t)(seconds * BENCH_IN_RATE);
+   in        = bench_make_input(in_frames, 2);
+   in_multi  = bench_make_input(in_frames, 6);
+   out       = (float*)malloc((size_t)(in_frames
+            * BENCH_OUT_RATE / BENCH_IN_RATE + 2 * BENCH_BLOCK)
+         * 6 * sizeof(float));
+
+   if (!in || !in_multi || !out)
+   {
+      fprintf(stderr, "Out of memory.\n");
+      return 1;
+   }
+
+   printf("%.1f s of %g Hz -> %g Hz, %u frame blocks\n\n",
+         seconds, BENCH_IN_RATE, BENCH_OUT_RATE, BENCH_BLOCK);
+   printf("%-10s %-9s %-7s %3s %14s %10s\n",
+         "driver", "quality", "kernel", "ch", "Msamples/s", "THD+N dB");
+
+   for (q = RESAMPLER_QUALITY_LOWEST; q <= RESAMPLER_QUALITY_HIGHEST; q++)
+   {
+      if (bench_driver(&sinc_resampler, (enum resampler_quality)q,
+               cpu_mask, in, in_frames, out, &res))
+         bench_print("sinc", bench_quality_names[q], "auto", 2, &res);
+      if (bench_driver(&nearest_resampler, (enum resampler_quality)q,
+               cpu_mask, in, in_frames, out, &res))
+         bench_print("nearest", bench_quality_names[q], "c", 2, &res);
+      if (bench_driver(&polyphase_resampler, (enum resampler_quality)q,
+               cpu_mask, in, in_frames, out, &res))
+         bench_print("polyphase", bench_quality_names[q], "auto", 2, &res);
+
+      /* Every kernel the CPU can run */
+      for (k = 0; k < ARRAY_SIZE(kernels); k++)
+      {
+         if ((kernels[k].mask & cpu_mask) != kernels[k].mask)
+            continue;
+         if (!bench_polyphase(2, (enum resampler_quality)q,
+                  kernels[k].mask, in, in_frames, out, &res, &kernel))
+            continue;
+         /* Kernel not built for this target */
+         if (strcmp(kernel, kernels[k].name))
+            continue;
+         bench_print("polyphase", bench_quality_names[q], kernel, 2, &res);
+      }
+
+      if (bench_polyphase(6, (enum resampler_quality)q,
+               cpu_mask, in_multi, in_frames, out, &res, &kernel))
+         bench_print("polyphase", bench_quality_names[q], kernel, 6, &res);
+
+      printf("\n");
+   }
+
+   free(in);
+   free(in_multi);
+   free(out);
+   return 0;
+}
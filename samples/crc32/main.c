@@ -0,0 +1,99 @@
+/* CRC32 throughput benchmark.
+ *
+ * Runs every encoding_crc32() implementation this build and CPU
+ * support over buffers of a few sizes, from the short strings the
+ * cheat and patch code hashes to the megabytes of a content scan,
+ * and checks each agrees with the byte-wise table.
+ *
+ *    ./crc32_bench [megabytes per run]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <boolean.h>
+#include <encodings/crc32.h>
+#include <features/features_cpu.h>
+
+static const struct
+{
+   enum encoding_crc32_impl impl;
+   const char *name;
+} impls[] = {
+   { ENCODING_CRC32_TABLE,   "table"   },
+   { ENCODING_CRC32_SLICE16, "slice16" },
+   { ENCODING_CRC32_PCLMUL,  "pclmul"  },
+   { ENCODING_CRC32_ARMV8,   "armv8"   }
+};
+
+static const size_t sizes[] = { 16, 64, 1024, 65536, 16 << 20 };
+
+/* Keeps the timed loops from being optimized out */
+static volatile uint32_t crc32_sink;
+
+int main(int argc, char *argv[])
+{
+   unsigned i, j;
+   uint8_t *buf;
+   size_t total = (size_t)(argc > 1 ? atoi(argv[1]) : 256) << 20;
+   size_t max   = sizes[sizeof(sizes) / sizeof(sizes[0]) - 1];
+   bool ok      = true;
+
+   if (!total || !(buf = (uint8_t*)malloc(max)))
+      return 1;
+
+   for (i = 0; i < max; i++)
+      buf[i] = (uint8_t)(i * 2654435761u >> 24);
+
+   printf("%-8s", "bytes");
+   for (j = 0; j < sizeof(impls) / sizeof(impls[0]); j++)
+      if (encoding_crc32_select(impls[j].impl))
+         printf(" %10s", impls[j].name);
+   printf("   (MB/s)\n");
+
+   for (i = 0; i < sizeof(sizes) / sizeof(sizes[0]); i++)
+   {
+      uint32_t expected;
+      size_t runs = total / sizes[i];
+
+      encoding_crc32_select(ENCODING_CRC32_TABLE);
+      expected = encoding_crc32(0, buf, sizes[i]);
+
+      printf("%-8u", (unsigned)sizes[i]);
+
+      for (j = 0; j < sizeof(impls) / sizeof(impls[0]); j++)
+      {
+         size_t run;
+         retro_time_t start;
+         double seconds;
+         uint32_t crc = 0;
+
+         if (!encoding_crc32_select(impls[j].impl))
+            continue;
+
+         start = cpu_features_get_time_usec();
+         for (run = 0; run < runs; run++)
+            crc = encoding_crc32(crc, buf, sizes[i]);
+         seconds = (cpu_features_get_time_usec() - start) / 1000000.0;
+
+         if (encoding_crc32(0, buf, sizes[i]) != expected)
+         {
+            fprintf(stderr, "%s: wrong CRC for %u bytes\n",
+                  impls[j].name, (unsigned)sizes[i]);
+            ok = false;
+         }
+
+         crc32_sink = crc;
+         printf(" %10.0f", seconds > 0
+               ? (double)runs * sizes[i] / seconds / 1048576.0 : 0.0);
+      }
+      printf("\n");
+   }
+
+   for (j = 0; j < sizeof(impls) / sizeof(impls[0]); j++)
+      if (impls[j].impl == encoding_crc32_best())
+         printf("default: %s\n", impls[j].name);
+
+   free(buf);
+   return ok ? 0 : 1;
+}
@@ -0,0 +1,448 @@
+/* Content scan lookup benchmark.
+ *
+ * Writes a directory of made up content files and a set of .rdb
+ * databases in which some of them appear, by CRC32 or (for one in
+ * eight, standing in for disc images) by serial. Then scans the
+ * files the way the database task does:
+ *
+ *    query    every file queries every database, each query
+ *             reading the whole .rdb (what the scanner did so far)
+ *    index    every database is read into a database_index_t once,
+ *             each file then only reads the records that match
+ *
+ * Both count the reading and hashing of the files, and must find
+ * the same records. The query scan only does the first files, as
+ * it takes time in proportion to all records of all databases.
+ *
+ *    ./database_scan_bench [files] [databases] [records per database]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <boolean.h>
+#include <compat/strl.h>
+#include <encodings/crc32.h>
+#include <features/features_cpu.h>
+#include <file/file_path.h>
+#include <streams/file_stream.h>
+
+#include "../../libretro-db/libretrodb.h"
+#include "../../database_index.h"
+
+#define SCAN_DIR          "database_scan_tmp"
+#define SCAN_QUERY_FILES  100
+/* One in SCAN_KNOWN files is in a database */
+#define SCAN_KNOWN        2
+/* One in SCAN_DISC files is looked up by serial */
+#define SCAN_DISC         8
+
+struct scan_db_ctx
+{
+   unsigned db;
+   unsigned dbs;
+   unsigned files;
+   unsigned records;
+   unsigned next;
+   const uint32_t *crcs;
+};
+
+struct scan_result
+{
+   unsigned files;
+   unsigned matches;
+   double seconds;
+};
+
+static uint32_t scan_random(uint32_t *seed)
+{
+   *seed = *seed * 1664525 + 1013904223;
+   return *seed >> 8;
+}
+
+static void scan_serial(char *s, size_t len, unsigned file)
+{
+   snprintf(s, len, "SLUS-%05u", file);
+}
+
+static void scan_string(struct rmsgpack_dom_value *v, const char *s)
+{
+   v->type             = RDT_STRING;
+   v->val.string.len   = (uint32_t)strlen(s);
+   v->val.string.buff  = strdup(s);
+}
+
+static void scan_binary(struct rmsgpack_dom_value *v,
+      const void *data, uint32_t len)
+{
+   v->type             = RDT_BINARY;
+   v->val.binary.len   = len;
+   v->val.binary.buff  = (char*)malloc(len + 1);
+   memcpy(v->val.binary.buff, data, len);
+   v->val.binary.buff[len] = '\0';
+}
+
+static void scan_uint(struct rmsgpack_dom_value *v, uint64_t n)
+{
+   v->type             = RDT_UINT;
+   v->val.uint_        = n;
+}
+
+/* Record j of database db. Known files are spread over the
+ * databases; the other records have CRCs no file has. */
+static int scan_db_provider(void *data, struct rmsgpack_dom_value *out)
+{
+   char buf[64];
+   uint8_t crc_be[4];
+   uint32_t crc;
+   unsigned file;
+   struct scan_db_ctx *ctx          = (struct scan_db_ctx*)data;
+   unsigned j                       = ctx->next++;
+   struct rmsgpack_dom_pair *items  = NULL;
+   bool disc                        = false;
+
+   if (j >= ctx->records)
+      return 1;
+
+   file = (j * ctx->dbs + ctx->db) * SCAN_KNOWN;
+   if (file < ctx->files)
+   {
+      crc  = ctx->crcs[file];
+      disc = (file % SCAN_DISC) == 0;
+   }
+   else
+   {
+      crc  = 0x9e3779b9u * (j * ctx->dbs + ctx->db + 1);
+      file = 0;
+   }
+
+   items             = (struct rmsgpack_dom_pair*)
+      calloc(6, sizeof(*items));
+   out->type         = RDT_MAP;
+   out->val.map.len  = 6;
+   out->val.map.items = items;
+
+   snprintf(buf, sizeof(buf), "Game %u-%u (USA)", ctx->db, j);
+   scan_string(&items[0].key, "name");
+   scan_string(&items[0].value, buf);
+   snprintf(buf, sizeof(buf), "Game %u-%u (USA).bin", ctx->db, j);
+   scan_string(&items[1].key, "rom_name");
+   scan_string(&items[1].value, buf);
+   scan_string(&items[2].key, "description");
+   scan_string(&items[2].value, "Made up for the scan benchmark");
+   scan_string(&items[3].key, "size");
+   scan_uint(&items[3].value, 4096 + j);
+   crc_be[0] = (uint8_t)(crc >> 24);
+   crc_be[1] = (uint8_t)(crc >> 16);
+   crc_be[2] = (uint8_t)(crc >>  8);
+   crc_be[3] = (uint8_t)(crc);
+   scan_string(&items[4].key, "crc");
+   scan_binary(&items[4].value, crc_be, 4);
+   if (disc)
+      scan_serial(buf, sizeof(buf), file);
+   else
+      snprintf(buf, sizeof(buf), "SLES-%05u", j * ctx->dbs + ctx->db);
+   scan_string(&items[5].key, "serial");
+   scan_binary(&items[5].value, buf, (uint32_t)strlen(buf));
+
+   return 0;
+}
+
+static bool scan_setup(unsigned files, unsigned dbs, unsigned records,
+      uint32_t *crcs)
+{
+   unsigned i;
+   char path[256];
+   uint32_t seed   = 1;
+   uint8_t *buf    = (uint8_t*)malloc(16384);
+
+   if (!buf || !path_mkdir(SCAN_DIR))
+      return false;
+
+   for (i = 0; i < files; i++)
+   {
+      unsigned j;
+      unsigned len = 1024 + scan_random(&seed) % 15360;
+
+      for (j = 0; j < len; j++)
+         buf[j]    = (uint8_t)scan_random(&seed);
+
+      crcs[i]      = encoding_crc32(0, buf, len);
+      snprintf(path, sizeof(path), SCAN_DIR "/file%05u.bin", i);
+      if (!filestream_write_file(path, buf, len))
+         return false;
+   }
+
+   free(buf);
+
+   for (i = 0; i < dbs; i++)
+   {
+      struct scan_db_ctx ctx;
+      RFILE *fd;
+
+      snprintf(path, sizeof(path), SCAN_DIR "/db%03u.rdb", i);
+      fd           = filestream_open(path, RETRO_VFS_FILE_ACCESS_WRITE,
+            RETRO_VFS_FILE_ACCESS_HINT_NONE);
+      if (!fd)
+         return false;
+
+      ctx.db       = i;
+      ctx.dbs      = dbs;
+      ctx.files    = files;
+      ctx.records  = records;
+      ctx.next     = 0;
+      ctx.crcs     = crcs;
+      libretrodb_create(fd, scan_db_provider, &ctx);
+      filestream_close(fd);
+   }
+
+   return true;
+}
+
+static void scan_cleanup(unsigned files, unsigned dbs)
+{
+   unsigned i;
+   char path[256];
+
+   for (i = 0; i < files; i++)
+   {
+      snprintf(path, sizeof(path), SCAN_DIR "/file%05u.bin", i);
+      filestream_delete(path);
+   }
+   for (i = 0; i < dbs; i++)
+   {
+      snprintf(path, sizeof(path), SCAN_DIR "/db%03u.rdb", i);
+      filestream_delete(path);
+   }
+   filestream_delete(SCAN_DIR);
+}
+
+/* What the task gets for a file: its CRC, or its serial */
+static uint32_t scan_hash_file(unsigned file, char *serial, size_t len)
+{
+   char path[256];
+   void *buf     = NULL;
+   int64_t size  = 0;
+   uint32_t crc  = 0;
+
+   snprintf(path, sizeof(path), SCAN_DIR "/file%05u.bin", file);
+   if (filestream_read_file(path, &buf, &size))
+      crc = encoding_crc32(0, (const uint8_t*)buf, (size_t)size);
+   free(buf);
+
+   serial[0] = '\0';
+   if (file % SCAN_DISC == 0)
+      scan_serial(serial, len, file);
+   return crc;
+}
+
+/* database_info_list_new(), minus filling in database_info_t */
+static unsigned scan_query(const char *rdb_path, const char *query)
+{
+   struct rmsgpack_dom_value item;
+   const char *error        = NULL;
+   unsigned found           = 0;
+   libretrodb_t *db         = libretrodb_new();
+   libretrodb_cursor_t *cur = libretrodb_cursor_new();
+   libretrodb_query_t *q    = NULL;
+
+   if (libretrodb_open(rdb_path, db) == 0)
+   {
+      q = (libretrodb_query_t*)libretrodb_query_compile(db, query,
+            strlen(query), &error);
+      if (!error && libretrodb_cursor_open(db, cur, q) == 0)
+      {
+         while (libretrodb_cursor_read_item(cur, &item) == 0)
+         {
+            found++;
+            rmsgpack_dom_value_free(&item);
+         }
+         libretrodb_cursor_close(cur);
+      }
+      if (q)
+         libretrodb_query_free(q);
+      libretrodb_close(db);
+   }
+
+   libretrodb_cursor_free(cur);
+   libretrodb_free(db);
+   return found;
+}
+
+static void scan_run_query(unsigned files, unsigned dbs,
+      struct scan_result *result)
+{
+   unsigned i, j;
+   retro_time_t start = cpu_features_get_time_usec();
+
+   result->files      = files;
+   result->matches    = 0;
+
+   for (i = 0; i < files; i++)
+   {
+      char serial[32];
+      char query[64];
+      uint32_t crc = scan_hash_file(i, serial, sizeof(serial));
+
+      if (serial[0])
+      {
+         char hex[32];
+         size_t k;
+         for (k = 0; serial[k]; k++)
+            snprintf(hex + k * 2, 3, "%02X", (uint8_t)serial[k]);
+         snprintf(query, sizeof(query), "{'serial': b'%s'}", hex);
+      }
+      else
+         snprintf(query, sizeof(query), "{crc:or(b\"%08lX\",b\"%08lX\")}",
+               (unsigned long)crc, 0ul);
+
+      for (j = 0; j < dbs; j++)
+      {
+         char path[256];
+         snprintf(path, sizeof(path), SCAN_DIR "/db%03u.rdb", j);
+         result->matches += scan_query(path, query);
+      }
+   }
+
+   result->seconds = (cpu_features_get_time_usec() - start) / 1000000.0;
+}
+
+/* database_info_list_new_offsets(), minus filling in
+ * database_info_t. Serial hits are compared, as the task does. */
+static unsigned scan_read_offsets(const char *rdb_path,
+      const uint64_t *offsets, size_t count, const char *serial)
+{
+   size_t i;
+   struct rmsgpack_dom_value item;
+   unsigned found           = 0;
+   libretrodb_t *db         = libretrodb_new();
+   libretrodb_cursor_t *cur = libretrodb_cursor_new();
+
+   if (      libretrodb_open(rdb_path, db) == 0
+         &&  libretrodb_cursor_open(db, cur, NULL) == 0)
+   {
+      for (i = 0; i < count; i++)
+      {
+         unsigned k;
+
+         if (libretrodb_cursor_seek(cur, offsets[i]) != 0
+               || libretrodb_cursor_read_item(cur, &item) != 0)
+            continue;
+
+         if (!serial[0])
+            found++;
+         else
+         {
+            for (k = 0; k < item.val.map.len; k++)
+               if (     !strcmp(item.val.map.items[k].key.val.string.buff,
+                        "serial")
+                     && !strcmp(item.val.map.items[k].value.val.string.buff,
+                        serial))
+                  found++;
+         }
+         rmsgpack_dom_value_free(&item);
+      }
+      libretrodb_cursor_close(cur);
+   }
+
+   libretrodb_close(db);
+   libretrodb_cursor_free(cur);
+   libretrodb_free(db);
+   return found;
+}
+
+static void scan_run_index(unsigned files, unsigned dbs,
+      struct scan_result *result, size_t *records)
+{
+   unsigned i, j;
+   database_index_t *index = database_index_new();
+   retro_time_t start      = cpu_features_get_time_usec();
+
+   result->files           = files;
+   result->matches         = 0;
+
+   for (i = 0; i < files; i++)
+   {
+      char serial[32];
+      uint32_t crc = scan_hash_file(i, serial, sizeof(serial));
+
+      for (j = 0; j < dbs; j++)
+      {
+         char path[256];
+         uint64_t offsets[DATABASE_INDEX_MAX_MATCHES];
+         size_t count;
+         int id;
+
+         snprintf(path, sizeof(path), SCAN_DIR "/db%03u.rdb", j);
+         if ((id = database_index_load(index, path)) < 0)
+            continue;
+
+         if (serial[0])
+            count = database_index_find_serial(index, id, serial,
+                  offsets, DATABASE_INDEX_MAX_MATCHES);
+         else
+            count = database_index_find_crc(index, id, crc,
+                  offsets, DATABASE_INDEX_MAX_MATCHES);
+
+         if (count)
+            result->matches += scan_read_offsets(path, offsets, count,
+                  serial);
+      }
+   }
+
+   result->seconds = (cpu_features_get_time_usec() - start) / 1000000.0;
+   *records        = database_index_records(index);
+   database_index_free(index);
+}
+
+int main(int argc, char *argv[])
+{
+   struct scan_result query, index, index_all;
+   size_t records_indexed;
+   unsigned files     = argc > 1 ? (unsigned)atoi(argv[1]) : 5000;
+   unsigned dbs       = argc > 2 ? (unsigned)atoi(argv[2]) : 100;
+   unsigned records   = argc > 3 ? (unsigned)atoi(argv[3]) : 1000;
+   unsigned subset    = files < SCAN_QUERY_FILES ? files : SCAN_QUERY_FILES;
+   uint32_t *crcs     = (uint32_t*)calloc(files ? files : 1,
+         sizeof(*crcs));
+
+   if (!files || !dbs || !records || !crcs)
+      return 1;
+
+   if (!scan_setup(files, dbs, records, crcs))
+   {
+      fprintf(stderr, "Could not write " SCAN_DIR "\n");
+      scan_cleanup(files, dbs);
+      return 1;
+   }
+
+   printf("%u files, %u databases of %u records\n\n",
+         files, dbs, records);
+
+   scan_run_query(subset, dbs, &query);
+   scan_run_index(subset, dbs, &index, &records_indexed);
+   scan_run_index(files, dbs, &index_all, &records_indexed);
+
+   printf("%-6s %6s %8s %9s %11s\n",
+         "method", "files", "matches", "seconds", "files/sec");
+   printf("%-6s %6u %8u %9.3f %11.1f\n", "query",
+         query.files, query.matches, query.seconds,
+         query.files / query.seconds);
+   printf("%-6s %6u %8u %9.3f %11.1f\n", "index",
+         index.files, index.matches, index.seconds,
+         index.files / index.seconds);
+   printf("%-6s %6u %8u %9.3f %11.1f\n", "index",
+         index_all.files, index_all.matches, index_all.seconds,
+         index_all.files / index_all.seconds);
+
+   printf("\n%u records indexed, %.1fx the files/sec, matches %s\n",
+         (unsigned)records_indexed,
+         (index_all.files / index_all.seconds)
+         / (query.files / query.seconds),
+         query.matches == index.matches ? "ok" : "DIFFER");
+
+   scan_cleanup(files, dbs);
+   free(crcs);
+   return query.matches == index.matches ? 0 : 1;
+}
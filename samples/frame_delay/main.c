@@ -0,0 +1,205 @@
+/* Automatic frame delay simulation.
+ *
+ * Runs a made up core whose cost per frame changes from scene
+ * to scene, on a 60 Hz display that waits for vsync, with:
+ *
+ *    none     no frame delay
+ *    fixed    half a frame of delay, never changed
+ *    auto     starts at half a frame, frame time heuristics bring
+ *             it down (what video_frame_delay_auto did so far)
+ *    learned  starts at half a frame, the core run time
+ *             percentile and the slowest recent run time set it
+ *             from then on, never above half a frame
+ *    profile  the same, starting from the profile the previous
+ *             run saved
+ *
+ * Every run sees the same frames. Reports the average delay, the
+ * time from the core reading input to the frame going out, and
+ * how many frames missed their vblank.
+ *
+ *    ./frame_delay_sim [seconds per run]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <boolean.h>
+#include <retro_miscellaneous.h>
+
+#include "../../gfx/video_frame_delay.h"
+
+#define SIM_REFRESH_RATE 60.0f
+#define SIM_PERIOD       16667
+#define SIM_SAMPLES      2048
+#define SIM_PROFILE      "frame_delay_sim.cfg"
+
+enum sim_policy
+{
+   SIM_NONE = 0,
+   SIM_FIXED,
+   SIM_AUTO,
+   SIM_LEARNED,
+   SIM_PROFILE_LEARNED
+};
+
+static const char *sim_policy_names[] = {
+   "none",
+   "fixed",
+   "auto",
+   "learned",
+   "profile"
+};
+
+/* Mean and spread of the core run time in usec, and how often
+ * a frame takes far longer, in frames per thousand */
+struct sim_scene
+{
+   unsigned mean;
+   unsigned spread;
+   unsigned spike_permille;
+   unsigned spike;
+};
+
+static const struct sim_scene sim_scenes[] = {
+   { 2500,  500,  0,     0 }, /* menu, title screen */
+   { 9000, 1500, 10, 13500 }, /* busy level */
+   { 5000, 1000,  2,  9000 }, /* regular level */
+   { 3500, 2500,  5, 11000 }  /* loading in the background */
+};
+
+/* Frames per scene: 20 seconds */
+#define SIM_SCENE_FRAMES 1200
+
+static uint32_t sim_random(uint32_t *seed)
+{
+   *seed = *seed * 1664525 + 1013904223;
+   return *seed >> 8;
+}
+
+/* Roughly normal, from the sum of four uniform numbers */
+static unsigned sim_core_run_time(unsigned frame, uint32_t *seed)
+{
+   const struct sim_scene *scene = &sim_scenes[
+      (frame / SIM_SCENE_FRAMES) % ARRAY_SIZE(sim_scenes)];
+   int sum = 0;
+   int i;
+
+   if (scene->spike && sim_random(seed) % 1000 < scene->spike_permille)
+      return scene->spike;
+
+   for (i = 0; i < 4; i++)
+      sum += (int)(sim_random(seed) % 1001) - 500;
+
+   sum = (int)scene->mean + sum * (int)scene->spread / 1000;
+   return sum > 100 ? (unsigned)sum : 100;
+}
+
+struct sim_result
+{
+   double delay;
+   double latency;
+   unsigned misses;
+   unsigned frames;
+};
+
+static void sim_run(enum sim_policy policy, unsigned frames,
+      struct sim_result *result)
+{
+   unsigned i;
+   frame_delay_learn_t fdl;
+   retro_time_t samples[SIM_SAMPLES];
+   uint64_t sample_count = 0;
+   uint64_t delay_sum    = 0;
+   uint64_t latency_sum  = 0;
+   uint32_t seed         = 0x2545f491;
+   unsigned half         = (unsigned)(1000.0f / SIM_REFRESH_RATE / 2);
+   unsigned delay        = policy == SIM_NONE ? 0 : half;
+   bool learn            = policy >= SIM_LEARNED;
+
+   memset(samples, 0, sizeof(samples));
+   memset(result, 0, sizeof(*result));
+
+   frame_delay_learn_init(&fdl, SIM_REFRESH_RATE, half, half);
+   if (policy == SIM_PROFILE_LEARNED)
+   {
+      if (frame_delay_learn_load(&fdl, SIM_PROFILE))
+         delay = fdl.delay;
+      else
+         fprintf(stderr, "Could not load %s.\n", SIM_PROFILE);
+   }
+
+   for (i = 0; i < frames; i++)
+   {
+      unsigned work    = sim_core_run_time(i, &seed);
+      /* Sleeping overshoots a little, presenting costs a little */
+      unsigned slept   = delay * 1000 + sim_random(&seed) % 200;
+      unsigned present = 700 + sim_random(&seed) % 300;
+      unsigned done    = slept + work + present;
+      unsigned vblanks = MAX((done + SIM_PERIOD - 1) / SIM_PERIOD, 1);
+      /* Measured a little early or late */
+      retro_time_t frame_time = (retro_time_t)vblanks * SIM_PERIOD
+         + (int)(sim_random(&seed) % 201) - 100;
+
+      delay_sum   += delay;
+      latency_sum += frame_time - slept;
+      if (vblanks > 1)
+         result->misses++;
+
+      samples[sample_count++ & (SIM_SAMPLES - 1)] = frame_time;
+
+      if (learn)
+      {
+         frame_delay_learn_push(&fdl, work, frame_time);
+         delay = fdl.delay;
+      }
+
+      /* The runloop's frame time heuristics, every 8 frames */
+      if (     (policy == SIM_AUTO || (learn && !frame_delay_learn_ready(&fdl)))
+            && delay > 0 && i > 8 && i % 8 == 0)
+      {
+         video_frame_delay_auto_t vfda = {0};
+         vfda.frame_time_interval      = 8;
+         vfda.refresh_rate             = SIM_REFRESH_RATE;
+
+         video_frame_delay_auto_samples(samples,
+               (unsigned)(sample_count & (SIM_SAMPLES - 1)), delay, &vfda);
+         delay -= vfda.decrease;
+         if (learn)
+            fdl.delay = delay;
+      }
+   }
+
+   if (policy == SIM_LEARNED && !frame_delay_learn_save(&fdl, SIM_PROFILE))
+      fprintf(stderr, "Could not save %s.\n", SIM_PROFILE);
+
+   result->frames  = frames;
+   result->delay   = (double)delay_sum / frames;
+   result->latency = (double)latency_sum / frames / 1000.0;
+}
+
+int main(int argc, char *argv[])
+{
+   unsigned i;
+   struct sim_result results[SIM_PROFILE_LEARNED + 1];
+   double seconds  = argc > 1 ? atof(argv[1]) : 300.0;
+   unsigned frames = (unsigned)(seconds * SIM_REFRESH_RATE);
+
+   if (frames < 8)
+      frames = 8;
+
+   printf("%u frames at %.0f Hz per run\n\n", frames, SIM_REFRESH_RATE);
+   printf("%-8s %9s %11s %8s %10s\n",
+         "policy", "delay ms", "latency ms", "missed", "vs auto ms");
+
+   for (i = SIM_NONE; i <= SIM_PROFILE_LEARNED; i++)
+      sim_run((enum sim_policy)i, frames, &results[i]);
+
+   for (i = SIM_NONE; i <= SIM_PROFILE_LEARNED; i++)
+      printf("%-8s %9.2f %11.2f %8u %+10.2f\n", sim_policy_names[i],
+            results[i].delay, results[i].latency, results[i].misses,
+            results[i].latency - results[SIM_AUTO].latency);
+
+   remove(SIM_PROFILE);
+   return 0;
+}
@@ -0,0 +1,307 @@
+/* Software frame upload benchmark.
+ *
+ * Streams XRGB8888 frames into a texture at 320x240, 640x480
+ * and 1920x1080 the way the gl and glcore drivers do:
+ *
+ *    client      glTexSubImage2D() from the core's own buffer
+ *    orphan      copied into an orphaned unpack buffer first
+ *    persistent  copied into a persistently mapped unpack buffer
+ *    direct      the core draws into the persistently mapped
+ *                buffer itself (GET_CURRENT_SOFTWARE_FRAMEBUFFER)
+ *
+ * Reports the time per frame spent uploading, and the whole
+ * frame time including the core drawing the frame and the GPU
+ * finishing. The last frame of every run is read back and
+ * compared with what the core drew.
+ *
+ * Runs headless on the EGL surfaceless platform, so it works
+ * with Mesa llvmpipe:
+ *
+ *    LIBGL_ALWAYS_SOFTWARE=1 ./gl_upload_bench [frames per run]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <EGL/egl.h>
+#include <EGL/eglext.h>
+
+#include <boolean.h>
+#include <retro_miscellaneous.h>
+#include <features/features_cpu.h>
+#include <glsym/glsym.h>
+#include <gfx/gl_capabilities.h>
+
+#include "../../gfx/common/gl_common.h"
+
+#ifndef EGL_PLATFORM_SURFACELESS_MESA
+#define EGL_PLATFORM_SURFACELESS_MESA 0x31DD
+#endif
+
+enum bench_mode
+{
+   BENCH_CLIENT = 0,
+   BENCH_ORPHAN,
+   BENCH_PERSISTENT,
+   BENCH_DIRECT
+};
+
+static const char *bench_mode_names[] = {
+   "client",
+   "orphan",
+   "persistent",
+   "direct"
+};
+
+static const unsigned bench_sizes[][2] = {
+   {  320,  240 },
+   {  640,  480 },
+   { 1920, 1080 }
+};
+
+static rglgen_func_t bench_get_proc_address(const char *sym)
+{
+   return (rglgen_func_t)eglGetProcAddress(sym);
+}
+
+static bool bench_egl_init(EGLDisplay *out_dpy, EGLContext *out_ctx)
+{
+   EGLConfig config;
+   EGLint num_configs                      = 0;
+   EGLDisplay dpy                          = EGL_NO_DISPLAY;
+   EGLContext ctx                          = EGL_NO_CONTEXT;
+   PFNEGLGETPLATFORMDISPLAYEXTPROC get_dpy = (PFNEGLGETPLATFORMDISPLAYEXTPROC)
+      eglGetProcAddress("eglGetPlatformDisplayEXT");
+   static const EGLint config_attribs[]    = {
+      EGL_RENDERABLE_TYPE, EGL_OPENGL_BIT,
+      EGL_NONE
+   };
+   static const EGLint context_attribs[]   = {
+      EGL_CONTEXT_MAJOR_VERSION, 3,
+      EGL_CONTEXT_MINOR_VERSION, 3,
+      EGL_CONTEXT_OPENGL_PROFILE_MASK, EGL_CONTEXT_OPENGL_CORE_PROFILE_BIT,
+      EGL_NONE
+   };
+
+   if (get_dpy)
+      dpy = get_dpy(EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY, NULL);
+   if (dpy == EGL_NO_DISPLAY)
+      dpy = eglGetDisplay(EGL_DEFAULT_DISPLAY);
+
+   if (     dpy == EGL_NO_DISPLAY
+         || !eglInitialize(dpy, NULL, NULL)
+         || !eglBindAPI(EGL_OPENGL_API))
+      return false;
+
+   /* The surfaceless platform may have no configs at all,
+    * but we never draw to a surface anyway. */
+   if (     !eglChooseConfig(dpy, config_attribs, &config, 1, &num_configs)
+         || num_configs < 1)
+      config = (EGLConfig)0; /* EGL_NO_CONFIG_KHR */
+
+   ctx = eglCreateContext(dpy, config, EGL_NO_CONTEXT, context_attribs);
+   if (ctx == EGL_NO_CONTEXT)
+      return false;
+
+   if (!eglMakeCurrent(dpy, EGL_NO_SURFACE, EGL_NO_SURFACE, ctx))
+      return false;
+
+   *out_dpy = dpy;
+   *out_ctx = ctx;
+   return true;
+}
+
+/* Stands in for the core drawing a frame */
+static void bench_draw(uint8_t *dst, unsigned width, unsigned height,
+      unsigned pitch, unsigned frame)
+{
+   unsigned x, y;
+
+   for (y = 0; y < height; y++, dst += pitch)
+   {
+      uint32_t *line = (uint32_t*)dst;
+      for (x = 0; x < width; x++)
+         line[x] = ((x + y * width) * 2654435761u) ^ (frame * 0x01010101u);
+   }
+}
+
+/* Reads the texture back and compares it with the last frame */
+static bool bench_verify(GLuint tex, const uint8_t *frame,
+      unsigned width, unsigned height)
+{
+   GLuint fbo;
+   bool same     = true;
+   uint8_t *read = (uint8_t*)malloc((size_t)width * height * 4);
+
+   if (!read)
+      return false;
+
+   glGenFramebuffers(1, &fbo);
+   glBindFramebuffer(GL_FRAMEBUFFER, fbo);
+   glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0,
+         GL_TEXTURE_2D, tex, 0);
+   glPixelStorei(GL_PACK_ALIGNMENT, 4);
+   glReadPixels(0, 0, width, height, GL_RGBA, GL_UNSIGNED_BYTE, read);
+   glBindFramebuffer(GL_FRAMEBUFFER, 0);
+   glDeleteFramebuffers(1, &fbo);
+
+   same = !memcmp(read, frame, (size_t)width * height * 4);
+   free(read);
+   return same;
+}
+
+/* Returns false if the ring could not be created or the
+ * uploaded texture does not match. */
+static bool bench_run(enum bench_mode mode,
+      unsigned width, unsigned height, unsigned frames,
+      double *upload_ms, double *frame_ms)
+{
+   GLuint tex;
+   gl_upload_ring_t ring;
+   unsigned i;
+   bool ok                = true;
+   unsigned pitch         = width * 4;
+   size_t size            = (size_t)pitch * height;
+   uint8_t *core          = (uint8_t*)malloc(size);
+   retro_time_t upload    = 0;
+   retro_time_t start     = 0;
+
+   if (!core)
+      return false;
+
+   gl_upload_ring_init(&ring, mode >= BENCH_PERSISTENT, true);
+   if (mode != BENCH_CLIENT && !gl_upload_ring_reserve(&ring, size))
+   {
+      free(core);
+      return false;
+   }
+
+   glGenTextures(1, &tex);
+   glBindTexture(GL_TEXTURE_2D, tex);
+   glTexStorage2D(GL_TEXTURE_2D, 1, GL_RGBA8, width, height);
+   glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+   glPixelStorei(GL_UNPACK_ROW_LENGTH, width);
+   glFinish();
+
+   start = cpu_features_get_time_usec();
+   for (i = 0; i < frames; i++)
+   {
+      retro_time_t t;
+      uint8_t *dst = NULL;
+
+      if (mode == BENCH_DIRECT)
+         dst = gl_upload_ring_map(&ring);
+      bench_draw(dst ? dst : core, width, height, pitch, i);
+
+      t = cpu_features_get_time_usec();
+      if (mode == BENCH_CLIENT)
+         glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, width, height,
+               GL_RGBA, GL_UNSIGNED_BYTE, core);
+      else
+      {
+         if (!dst)
+         {
+            if (!(dst = gl_upload_ring_map(&ring)))
+            {
+               ok = false;
+               break;
+            }
+            memcpy(dst, core, size);
+         }
+         gl_upload_ring_bind(&ring);
+         glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, width, height,
+               GL_RGBA, GL_UNSIGNED_BYTE, NULL);
+         gl_upload_ring_submit(&ring);
+      }
+      glFlush();
+      upload += cpu_features_get_time_usec() - t;
+   }
+   glFinish();
+
+   *upload_ms = upload / 1000.0 / frames;
+   *frame_ms  = (cpu_features_get_time_usec() - start) / 1000.0 / frames;
+
+   /* The direct run drew its last frame into the ring */
+   if (ok && mode == BENCH_DIRECT)
+      bench_draw(core, width, height, pitch, frames - 1);
+   ok = ok && bench_verify(tex, core, width, height);
+
+   glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
+   glDeleteTextures(1, &tex);
+   gl_upload_ring_free(&ring);
+   free(core);
+   return ok;
+}
+
+int main(int argc, char *argv[])
+{
+   unsigned i, j;
+   EGLDisplay dpy;
+   EGLContext ctx;
+   unsigned frames = argc > 1 ? (unsigned)strtoul(argv[1], NULL, 0) : 200;
+   bool persistent = false;
+   bool ok         = true;
+
+   if (!frames)
+      frames = 1;
+
+   if (!bench_egl_init(&dpy, &ctx))
+   {
+      fprintf(stderr, "Could not create a headless GL 3.3 core context.\n");
+      return 1;
+   }
+
+   rglgen_resolve_symbols(bench_get_proc_address);
+   gl_query_core_context_set(true);
+
+   persistent = gl_check_capability(GL_CAPS_BUFFER_STORAGE)
+      && gl_check_capability(GL_CAPS_SYNC);
+
+   printf("%s, %s, %u frames per run\n\n",
+         (const char*)glGetString(GL_RENDERER),
+         (const char*)glGetString(GL_VERSION), frames);
+   printf("%-12s %-11s %11s %11s\n",
+         "size", "path", "upload ms", "frame ms");
+
+   for (i = 0; i < ARRAY_SIZE(bench_sizes); i++)
+   {
+      char name[32];
+      unsigned width  = bench_sizes[i][0];
+      unsigned height = bench_sizes[i][1];
+
+      snprintf(name, sizeof(name), "%ux%u", width, height);
+
+      for (j = BENCH_CLIENT; j <= BENCH_DIRECT; j++)
+      {
+         double upload_ms = 0.0;
+         double frame_ms  = 0.0;
+
+         if (j >= BENCH_PERSISTENT && !persistent)
+         {
+            printf("%-12s %-11s %23s\n", name, bench_mode_names[j],
+                  "no ARB_buffer_storage");
+            continue;
+         }
+
+         if (bench_run((enum bench_mode)j, width, height, frames,
+                  &upload_ms, &frame_ms))
+            printf("%-12s %-11s %11.3f %11.3f\n", name,
+                  bench_mode_names[j], upload_ms, frame_ms);
+         else
+         {
+            printf("%-12s %-11s %23s\n", name, bench_mode_names[j],
+                  "MISMATCH");
+            ok = false;
+         }
+      }
+   }
+
+   eglMakeCurrent(dpy, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+   eglDestroyContext(dpy, ctx);
+   eglTerminate(dpy);
+
+   if (!ok)
+      printf("FAILED\n");
+   return ok ? 0 : 1;
+}
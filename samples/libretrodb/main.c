@@ -0,0 +1,339 @@
+/* libretrodb full-table scan benchmark.
+ *
+ * Scans a database with no query, with the CRC query the scanner
+ * runs and with a glob on the name, once through a cursor and once
+ * the way cursors used to read it: a record at a time from a file
+ * stream, freed again when the query rejects it. Reports records
+ * per second and, where the allocator can be wrapped, allocations
+ * per record.
+ *
+ * Without a database, one shaped like the largest bundled ones is
+ * written to libretrodb_bench.rdb first.
+ *
+ *    ./libretrodb_bench [database] [passes]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <boolean.h>
+#include <compat/strl.h>
+#include <retro_endianness.h>
+#include <streams/file_stream.h>
+#include <features/features_cpu.h>
+
+#include "libretrodb.h"
+#include "rmsgpack_dom.h"
+
+#define BENCH_RECORDS    60000
+#define BENCH_FIELDS     12
+
+/* Magic number and metadata offset */
+#define RDB_HEADER_SIZE  16
+
+#ifdef LIBRETRODB_BENCH_WRAP_ALLOC
+void *__real_malloc(size_t size);
+void *__real_calloc(size_t nmemb, size_t size);
+void *__real_realloc(void *ptr, size_t size);
+
+static size_t bench_allocs;
+
+void *__wrap_malloc(size_t size)
+{
+   bench_allocs++;
+   return __real_malloc(size);
+}
+
+void *__wrap_calloc(size_t nmemb, size_t size)
+{
+   bench_allocs++;
+   return __real_calloc(nmemb, size);
+}
+
+void *__wrap_realloc(void *ptr, size_t size)
+{
+   bench_allocs++;
+   return __real_realloc(ptr, size);
+}
+#endif
+
+static const char *regions[] = { "USA", "Europe", "Japan", "World" };
+
+struct bench_result
+{
+   double seconds;
+   size_t allocs;
+   unsigned matches;
+};
+
+static void bench_string(struct rmsgpack_dom_value *v, const char *s)
+{
+   v->type            = RDT_STRING;
+   v->val.string.len  = (uint32_t)strlen(s);
+   v->val.string.buff = strdup(s);
+}
+
+static void bench_binary(struct rmsgpack_dom_value *v,
+      uint32_t seed, uint32_t len)
+{
+   uint32_t i;
+
+   v->type            = RDT_BINARY;
+   v->val.binary.len  = len;
+   v->val.binary.buff = (char*)malloc(len);
+
+   for (i = 0; i < len; i++)
+      v->val.binary.buff[i] = (char)((seed + i) * 2654435761u >> 24);
+}
+
+static void bench_uint(struct rmsgpack_dom_value *v, uint64_t n)
+{
+   v->type      = RDT_UINT;
+   v->val.uint_ = n;
+}
+
+/* A No-Intro style record; the CRC is the record number */
+static int bench_value_provider(void *ctx, struct rmsgpack_dom_value *out)
+{
+   char name[128];
+   char serial[32];
+   unsigned *n                     = (unsigned*)ctx;
+   const char *region              = regions[*n % 4];
+   struct rmsgpack_dom_pair *pairs = NULL;
+   uint32_t crc                    = swap_if_little32(*n + 1);
+
+   if (*n == BENCH_RECORDS)
+      return 1;
+
+   pairs = (struct rmsgpack_dom_pair*)calloc(BENCH_FIELDS, sizeof(*pairs));
+   if (!pairs)
+      return -1;
+
+   snprintf(name, sizeof(name), "Game %u (%s) (Rev %u)", *n, region, *n % 3);
+   snprintf(serial, sizeof(serial), "SLUS-%05u", *n);
+
+   bench_string(&pairs[0].key, "name");
+   bench_string(&pairs[0].value, name);
+   bench_string(&pairs[1].key, "description");
+   bench_string(&pairs[1].value, name);
+   bench_string(&pairs[2].key, "rom_name");
+   strlcat(name, ".bin", sizeof(name));
+   bench_string(&pairs[2].value, name);
+   bench_string(&pairs[3].key, "size");
+   bench_uint(&pairs[3].value, 262144 + *n * 16);
+   bench_string(&pairs[4].key, "crc");
+   bench_binary(&pairs[4].value, 0, 4);
+   memcpy(pairs[4].value.val.binary.buff, &crc, 4);
+   bench_string(&pairs[5].key, "md5");
+   bench_binary(&pairs[5].value, *n, 16);
+   bench_string(&pairs[6].key, "sha1");
+   bench_binary(&pairs[6].value, *n, 20);
+   bench_string(&pairs[7].key, "serial");
+   bench_string(&pairs[7].value, serial);
+   bench_string(&pairs[8].key, "developer");
+   bench_string(&pairs[8].value, "Developer");
+   bench_string(&pairs[9].key, "publisher");
+   bench_string(&pairs[9].value, "Publisher");
+   bench_string(&pairs[10].key, "genre");
+   bench_string(&pairs[10].value, "Action");
+   bench_string(&pairs[11].key, "releaseyear");
+   bench_uint(&pairs[11].value, 1985 + *n % 30);
+
+   out->type          = RDT_MAP;
+   out->val.map.len   = BENCH_FIELDS;
+   out->val.map.items = pairs;
+
+   (*n)++;
+   return 0;
+}
+
+static bool bench_create(const char *path)
+{
+   int rv;
+   unsigned n = 0;
+   RFILE *fd  = filestream_open(path,
+         RETRO_VFS_FILE_ACCESS_WRITE,
+         RETRO_VFS_FILE_ACCESS_HINT_NONE);
+
+   if (!fd)
+      return false;
+
+   rv = libretrodb_create(fd, bench_value_provider, &n);
+   filestream_close(fd);
+   return rv >= 0;
+}
+
+/* How libretrodb_cursor_read_item() used to go about it */
+static bool bench_stream(const char *path, libretrodb_query_t *q,
+      unsigned passes, struct bench_result *res)
+{
+   unsigned pass;
+   retro_time_t start = cpu_features_get_time_usec();
+
+   for (pass = 0; pass < passes; pass++)
+   {
+      struct rmsgpack_dom_value item;
+      RFILE *fd = filestream_open(path,
+            RETRO_VFS_FILE_ACCESS_READ,
+            RETRO_VFS_FILE_ACCESS_HINT_NONE);
+
+      if (!fd)
+         return false;
+
+      filestream_seek(fd, RDB_HEADER_SIZE, RETRO_VFS_SEEK_POSITION_START);
+
+      while (rmsgpack_dom_read(fd, &item) == 0 && item.type != RDT_NULL)
+      {
+         if (!q || libretrodb_query_filter(q, &item))
+            res->matches++;
+         rmsgpack_dom_value_free(&item);
+      }
+
+      filestream_close(fd);
+   }
+
+   res->seconds = (cpu_features_get_time_usec() - start) / 1000000.0;
+   return true;
+}
+
+static bool bench_cursor(libretrodb_t *db, libretrodb_query_t *q,
+      unsigned passes, struct bench_result *res)
+{
+   unsigned pass;
+   retro_time_t start       = cpu_features_get_time_usec();
+   libretrodb_cursor_t *cur = libretrodb_cursor_new();
+
+   if (!cur)
+      return false;
+
+   for (pass = 0; pass < passes; pass++)
+   {
+      struct rmsgpack_dom_value item;
+
+      if (libretrodb_cursor_open(db, cur, q) != 0)
+      {
+         libretrodb_cursor_free(cur);
+         return false;
+      }
+
+      while (libretrodb_cursor_read_item(cur, &item) == 0)
+      {
+         res->matches++;
+         rmsgpack_dom_value_free(&item);
+      }
+
+      libretrodb_cursor_close(cur);
+   }
+
+   libretrodb_cursor_free(cur);
+   res->seconds = (cpu_features_get_time_usec() - start) / 1000000.0;
+   return true;
+}
+
+static void bench_print(const char *name, const struct bench_result *res,
+      unsigned records, unsigned passes)
+{
+   double total = (double)records * passes;
+
+   printf("  %-8s %12.0f records/s %8u matches", name,
+         res->seconds > 0 ? total / res->seconds : 0.0,
+         res->matches / passes);
+#ifdef LIBRETRODB_BENCH_WRAP_ALLOC
+   printf(" %8.2f allocs/record", res->allocs / total);
+#endif
+   printf("\n");
+}
+
+int main(int argc, char *argv[])
+{
+   unsigned i;
+   char crc_query[64];
+   const char *path   = argc > 1 ? argv[1] : "libretrodb_bench.rdb";
+   unsigned passes    = argc > 2 ? (unsigned)atoi(argv[2]) : 5;
+   unsigned records   = 0;
+   bool ok            = true;
+   libretrodb_t *db   = NULL;
+   const char *queries[3];
+
+   if (!passes)
+      return 1;
+
+   if (argc <= 1 && !bench_create(path))
+   {
+      fprintf(stderr, "could not write %s\n", path);
+      return 1;
+   }
+
+   db = libretrodb_new();
+   if (!db || libretrodb_open(path, db) != 0)
+   {
+      fprintf(stderr, "could not open %s\n", path);
+      return 1;
+   }
+
+   /* A CRC in the middle of the generated database */
+   snprintf(crc_query, sizeof(crc_query), "{'crc':b'%08X'}",
+         BENCH_RECORDS / 2);
+
+   queries[0] = NULL;
+   queries[1] = crc_query;
+   queries[2] = "{'name':glob('*(Japan)*')}";
+
+   for (i = 0; i < sizeof(queries) / sizeof(queries[0]); i++)
+   {
+      struct bench_result stream, cursor;
+      const char *error     = NULL;
+      libretrodb_query_t *q = NULL;
+
+      if (queries[i])
+      {
+         q = (libretrodb_query_t*)libretrodb_query_compile(db,
+               queries[i], strlen(queries[i]), &error);
+         if (error)
+         {
+            fprintf(stderr, "%s: %s\n", queries[i], error);
+            ok = false;
+            continue;
+         }
+      }
+
+      memset(&stream, 0, sizeof(stream));
+      memset(&cursor, 0, sizeof(cursor));
+
+#ifdef LIBRETRODB_BENCH_WRAP_ALLOC
+      stream.allocs = bench_allocs;
+#endif
+      ok           &= bench_stream(path, q, passes, &stream);
+#ifdef LIBRETRODB_BENCH_WRAP_ALLOC
+      stream.allocs = bench_allocs - stream.allocs;
+      cursor.allocs = bench_allocs;
+#endif
+      ok           &= bench_cursor(db, q, passes, &cursor);
+#ifdef LIBRETRODB_BENCH_WRAP_ALLOC
+      cursor.allocs = bench_allocs - cursor.allocs;
+#endif
+
+      /* Every record matches the empty query */
+      if (!q)
+         records = stream.matches / passes;
+
+      printf("%s\n", queries[i] ? queries[i] : "(all records)");
+      bench_print("stream", &stream, records, passes);
+      bench_print("cursor", &cursor, records, passes);
+
+      if (stream.matches != cursor.matches)
+      {
+         fprintf(stderr, "cursor found %u records, stream %u\n",
+               cursor.matches / passes, stream.matches / passes);
+         ok = false;
+      }
+
+      if (q)
+         libretrodb_query_free(q);
+   }
+
+   libretrodb_close(db);
+   libretrodb_free(db);
+   return ok ? 0 : 1;
+}
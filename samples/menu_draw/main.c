@@ -0,0 +1,560 @@
+/* Menu draw batching benchmark.
+ *
+ * Replays frames laid out like those of XMB, Ozone and MaterialUI
+ * through a display driver that behaves like the GL one but only
+ * copies the vertices out, three times each:
+ *
+ *    direct   every draw the menu makes is a draw call
+ *    batched  gfx_display_batch_begin() groups quads by texture
+ *    atlas    the same, with the menu icons in one atlas
+ *
+ * Reports draw calls and CPU time per frame, and fails if the
+ * area each texture covers on screen is not the same every way.
+ * The time is that of the menu and gfx_display only: what a real
+ * driver spends on every draw call, which batching saves, comes
+ * on top of the direct runs.
+ *
+ *    ./menu_draw_bench [frames per run]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#include <boolean.h>
+#include <retro_miscellaneous.h>
+#include <features/features_cpu.h>
+#include <gfx/math/matrix_4x4.h>
+
+#include "../../gfx/gfx_display.h"
+
+#define BENCH_WIDTH     1920
+#define BENCH_HEIGHT    1080
+#define BENCH_TEX_WHITE 1
+#define BENCH_TEX_BG    2
+#define BENCH_TEX_ICON  3
+#define BENCH_ICONS     40
+#define BENCH_TEX_ATLAS 200
+#define BENCH_TEXTURES  256
+#define BENCH_SCRATCH   (1 << 16)
+
+enum bench_mode
+{
+   BENCH_DIRECT = 0,
+   BENCH_BATCHED,
+   BENCH_ATLAS
+};
+
+static const char *bench_mode_names[] = {
+   "direct",
+   "batched",
+   "atlas"
+};
+
+struct bench_menu
+{
+   const char *name;
+   /* Side of its icons in pixels */
+   unsigned icon_size;
+   void (*frame)(gfx_display_t *p_disp, unsigned frame);
+};
+
+static math_matrix_4x4 bench_mvp;
+static float bench_vertexes[8]   = { 0, 0, 1, 0, 0, 1, 1, 1 };
+static float bench_tex_coords[8] = { 0, 1, 1, 1, 0, 0, 1, 0 };
+static float bench_scratch[BENCH_SCRATCH];
+static double bench_area[BENCH_TEXTURES];
+static uint64_t bench_draws;
+
+static void *bench_get_default_mvp(void *data)
+{
+   return &bench_mvp;
+}
+
+static const float *bench_get_default_vertices(void)
+{
+   return &bench_vertexes[0];
+}
+
+static const float *bench_get_default_tex_coords(void)
+{
+   return &bench_tex_coords[0];
+}
+
+static void bench_window(const gfx_display_ctx_draw_t *draw,
+      const math_matrix_4x4 *mat, const float *v, double *out)
+{
+   float cx = MAT_ELEM_4X4(*mat, 0, 0) * v[0]
+      + MAT_ELEM_4X4(*mat, 0, 1) * v[1] + MAT_ELEM_4X4(*mat, 0, 3);
+   float cy = MAT_ELEM_4X4(*mat, 1, 0) * v[0]
+      + MAT_ELEM_4X4(*mat, 1, 1) * v[1] + MAT_ELEM_4X4(*mat, 1, 3);
+   out[0]   = (int)draw->x + (cx + 1.0) * 0.5 * draw->width;
+   out[1]   = (int)draw->y + (cy + 1.0) * 0.5 * draw->height;
+}
+
+/* What the GL driver does with a draw, short of drawing it: the
+ * arrays are copied out, the area of every triangle is added to
+ * that of its texture */
+static void bench_draw(gfx_display_ctx_draw_t *draw,
+      void *data, unsigned video_width, unsigned video_height)
+{
+   unsigned i, step, count;
+   const struct video_coords *coords = draw->coords;
+   const float *vertex    = coords->vertex    ? coords->vertex    : bench_vertexes;
+   const float *tex_coord = coords->tex_coord ? coords->tex_coord : bench_tex_coords;
+   const math_matrix_4x4 *mat = draw->matrix_data
+      ? (const math_matrix_4x4*)draw->matrix_data : &bench_mvp;
+   size_t floats          = MIN(coords->vertices * 8, BENCH_SCRATCH);
+
+   memcpy(bench_scratch, vertex, floats / 4 * sizeof(float));
+   memcpy(bench_scratch + floats / 4, tex_coord, floats / 4 * sizeof(float));
+   memcpy(bench_scratch + floats / 2, coords->color, floats / 2 * sizeof(float));
+
+   if (draw->prim_type == GFX_DISPLAY_PRIM_TRIANGLESTRIP)
+   {
+      step  = 1;
+      count = coords->vertices >= 3 ? coords->vertices - 2 : 0;
+   }
+   else
+   {
+      step  = 3;
+      count = coords->vertices / 3;
+   }
+
+   for (i = 0; i < count; i++)
+   {
+      double a[2], b[2], c[2];
+      const float *v = vertex + i * step * 2;
+      bench_window(draw, mat, v,     a);
+      bench_window(draw, mat, v + 2, b);
+      bench_window(draw, mat, v + 4, c);
+      bench_area[draw->texture % BENCH_TEXTURES] += fabs(
+            (b[0] - a[0]) * (c[1] - a[1])
+          - (c[0] - a[0]) * (b[1] - a[1])) * 0.5;
+   }
+
+   bench_draws++;
+}
+
+static void bench_blend(void *data) { }
+
+static void bench_scissor_begin(void *data, unsigned video_width,
+      unsigned video_height, int x, int y, unsigned width, unsigned height) { }
+
+static void bench_scissor_end(void *data, unsigned video_width,
+      unsigned video_height) { }
+
+static gfx_display_ctx_driver_t bench_display = {
+   bench_draw,
+   NULL,
+   bench_blend,
+   bench_blend,
+   bench_get_default_mvp,
+   bench_get_default_vertices,
+   bench_get_default_tex_coords,
+   NULL,
+   GFX_VIDEO_DRIVER_OPENGL,
+   "bench",
+   false,
+   bench_scissor_begin,
+   bench_scissor_end
+};
+
+/* gfx_display_draw_quad() */
+static void bench_quad(gfx_display_t *p_disp, int x, int y,
+      unsigned w, unsigned h, float *color, uintptr_t texture)
+{
+   gfx_display_ctx_draw_t draw;
+   struct video_coords coords;
+
+   coords.vertices      = 4;
+   coords.vertex        = NULL;
+   coords.tex_coord     = NULL;
+   coords.lut_tex_coord = NULL;
+   coords.color         = color;
+
+   memset(&draw, 0, sizeof(draw));
+   draw.x               = x;
+   draw.y               = (int)BENCH_HEIGHT - y - (int)h;
+   draw.width           = w;
+   draw.height          = h;
+   draw.coords          = &coords;
+   draw.texture         = texture;
+   draw.prim_type       = GFX_DISPLAY_PRIM_TRIANGLESTRIP;
+   draw.scale_factor    = 1.0f;
+
+   p_disp->dispctx->draw(&draw, NULL, BENCH_WIDTH, BENCH_HEIGHT);
+}
+
+/* xmb_draw_icon(), shadow first */
+static void bench_icon(gfx_display_t *p_disp, float x, float y,
+      unsigned size, float scale, float *color, float *shadow,
+      uintptr_t texture)
+{
+   gfx_display_ctx_draw_t draw;
+   struct video_coords coords;
+   math_matrix_4x4 rotated, scaled, mymat, mvp;
+
+   matrix_4x4_rotate_z(rotated, 0.0f);
+   matrix_4x4_multiply(mvp, rotated, bench_mvp);
+   matrix_4x4_scale(scaled, scale, scale, 1.0f);
+   matrix_4x4_multiply(mymat, scaled, mvp);
+
+   coords.vertices      = 4;
+   coords.vertex        = NULL;
+   coords.tex_coord     = NULL;
+   coords.lut_tex_coord = NULL;
+
+   memset(&draw, 0, sizeof(draw));
+   draw.width           = size;
+   draw.height          = size;
+   draw.coords          = &coords;
+   draw.matrix_data     = &mymat;
+   draw.texture         = texture;
+   draw.prim_type       = GFX_DISPLAY_PRIM_TRIANGLESTRIP;
+
+   if (shadow)
+   {
+      coords.color      = shadow;
+      draw.x            = x + 2;
+      draw.y            = BENCH_HEIGHT - y - 2;
+      p_disp->dispctx->draw(&draw, NULL, BENCH_WIDTH, BENCH_HEIGHT);
+   }
+
+   coords.color         = color;
+   draw.x               = x;
+   draw.y               = BENCH_HEIGHT - y;
+   p_disp->dispctx->draw(&draw, NULL, BENCH_WIDTH, BENCH_HEIGHT);
+}
+
+/* gfx_display_draw_texture_slice(): nine draws over the whole
+ * screen, each with its own vertices and texture coordinates */
+static void bench_slice(gfx_display_t *p_disp, int x, int y,
+      unsigned w, unsigned h, unsigned offset, float *color,
+      uintptr_t texture)
+{
+   unsigned row, col;
+   gfx_display_ctx_draw_t draw;
+   struct video_coords coords;
+   float vert_coord[8];
+   float tex_coord[8];
+   float vx[4], vy[4];
+   static const float tx[4] = { 0.0f, 0.25f, 0.75f, 1.0f };
+
+   vx[0] = x / (float)BENCH_WIDTH;
+   vx[1] = (x + offset) / (float)BENCH_WIDTH;
+   vx[2] = (x + w - offset) / (float)BENCH_WIDTH;
+   vx[3] = (x + w) / (float)BENCH_WIDTH;
+   vy[0] = (BENCH_HEIGHT - y) / (float)BENCH_HEIGHT;
+   vy[1] = (BENCH_HEIGHT - y - (int)offset) / (float)BENCH_HEIGHT;
+   vy[2] = (BENCH_HEIGHT - y - (int)h + (int)offset) / (float)BENCH_HEIGHT;
+   vy[3] = (BENCH_HEIGHT - y - (int)h) / (float)BENCH_HEIGHT;
+
+   coords.vertices      = 4;
+   coords.vertex        = vert_coord;
+   coords.tex_coord     = tex_coord;
+   coords.lut_tex_coord = NULL;
+   coords.color         = color;
+
+   memset(&draw, 0, sizeof(draw));
+   draw.width           = BENCH_WIDTH;
+   draw.height          = BENCH_HEIGHT;
+   draw.coords          = &coords;
+   draw.matrix_data     = &bench_mvp;
+   draw.texture         = texture;
+   draw.prim_type       = GFX_DISPLAY_PRIM_TRIANGLESTRIP;
+
+   for (row = 0; row < 3; row++)
+   {
+      for (col = 0; col < 3; col++)
+      {
+         /* BL BR TL TR */
+         vert_coord[0] = vx[col];     vert_coord[1] = vy[row + 1];
+         vert_coord[2] = vx[col + 1]; vert_coord[3] = vy[row + 1];
+         vert_coord[4] = vx[col];     vert_coord[5] = vy[row];
+         vert_coord[6] = vx[col + 1]; vert_coord[7] = vy[row];
+         tex_coord[0]  = tx[col];     tex_coord[1]  = tx[row + 1];
+         tex_coord[2]  = tx[col + 1]; tex_coord[3]  = tx[row + 1];
+         tex_coord[4]  = tx[col];     tex_coord[5]  = tx[row];
+         tex_coord[6]  = tx[col + 1]; tex_coord[7]  = tx[row];
+         p_disp->dispctx->draw(&draw, NULL, BENCH_WIDTH, BENCH_HEIGHT);
+      }
+   }
+}
+
+static float bench_white[16]  = {
+   1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1
+};
+static float bench_shadow[16] = {
+   0, 0, 0, 0.5f, 0, 0, 0, 0.5f, 0, 0, 0, 0.5f, 0, 0, 0, 0.5f
+};
+static float bench_panel[16]  = {
+   0.1f, 0.1f, 0.1f, 0.9f, 0.1f, 0.1f, 0.1f, 0.9f,
+   0.2f, 0.2f, 0.2f, 0.9f, 0.2f, 0.2f, 0.2f, 0.9f
+};
+
+/* Wallpaper, a row of category icons, a column of entries with
+ * an icon each and a toggle on some, the status icons, all with
+ * shadows; the text is one block at the end */
+static void bench_frame_xmb(gfx_display_t *p_disp, unsigned frame)
+{
+   unsigned i;
+   float scroll = (float)(frame % 96);
+
+   p_disp->dispctx->blend_begin(NULL);
+
+   bench_quad(p_disp, 0, 0, BENCH_WIDTH, BENCH_HEIGHT,
+         bench_white, BENCH_TEX_BG);
+
+   for (i = 0; i < 10; i++)
+      bench_icon(p_disp, 300.0f + i * 220.0f - scroll, 260.0f, 256,
+            i == 2 ? 1.0f : 0.5f, bench_white, bench_shadow,
+            BENCH_TEX_ICON + i);
+
+   for (i = 0; i < 12; i++)
+   {
+      float y = 400.0f + i * 60.0f + scroll * 0.25f;
+      bench_icon(p_disp, 500.0f, y, 256, 0.25f, bench_white,
+            bench_shadow, BENCH_TEX_ICON + 10 + (i * 7) % 24);
+      if (i & 1)
+         bench_icon(p_disp, 1700.0f, y, 256, 0.25f, bench_white,
+               bench_shadow, BENCH_TEX_ICON + 34 + (i & 2));
+   }
+
+   for (i = 0; i < 4; i++)
+      bench_icon(p_disp, 1600.0f + i * 60.0f, 80.0f, 256, 0.2f,
+            bench_white, bench_shadow, BENCH_TEX_ICON + 36 + i);
+
+   gfx_display_batch_flush();
+   p_disp->dispctx->blend_end(NULL);
+}
+
+/* Header and footer bars with separators, the sidebar with its
+ * cursor, the entries inside a scissor with a separator and an icon
+ * each and the cursor over them; text goes out after each part */
+static void bench_frame_ozone(gfx_display_t *p_disp, unsigned frame)
+{
+   unsigned i;
+   int scroll = (int)(frame % 48);
+
+   p_disp->dispctx->blend_begin(NULL);
+
+   bench_quad(p_disp, 0, 0, BENCH_WIDTH, BENCH_HEIGHT,
+         bench_panel, BENCH_TEX_WHITE);
+   bench_quad(p_disp, 0, 0, BENCH_WIDTH, 90, bench_panel, BENCH_TEX_WHITE);
+   bench_quad(p_disp, 30, 90, BENCH_WIDTH - 60, 2,
+         bench_white, BENCH_TEX_WHITE);
+   bench_icon(p_disp, 40.0f, 70.0f, 64, 1.0f, bench_white, NULL,
+         BENCH_TEX_ICON);
+   gfx_display_batch_flush();
+
+   p_disp->dispctx->scissor_begin(NULL, BENCH_WIDTH, BENCH_HEIGHT,
+         0, 92, 480, 900);
+   bench_quad(p_disp, 0, 92, 480, 900, bench_panel, BENCH_TEX_WHITE);
+   bench_slice(p_disp, 20, 120 + (frame % 8) * 70, 440, 64, 16,
+         bench_white, BENCH_TEX_ICON + 1);
+   for (i = 0; i < 10; i++)
+      bench_icon(p_disp, 40.0f, 170.0f + i * 70.0f, 64, 1.0f,
+            bench_white, NULL, BENCH_TEX_ICON + 2 + i);
+   bench_quad(p_disp, 20, 830, 440, 2, bench_white, BENCH_TEX_WHITE);
+   p_disp->dispctx->scissor_end(NULL, BENCH_WIDTH, BENCH_HEIGHT);
+   gfx_display_batch_flush();
+
+   p_disp->dispctx->scissor_begin(NULL, BENCH_WIDTH, BENCH_HEIGHT,
+         480, 92, BENCH_WIDTH - 480, 900);
+   for (i = 0; i < 14; i++)
+   {
+      int y = 110 + (int)i * 64 - scroll;
+      bench_quad(p_disp, 520, y, BENCH_WIDTH - 600, 1,
+            bench_white, BENCH_TEX_WHITE);
+      bench_icon(p_disp, 540.0f, y + 52.0f, 64, 0.75f, bench_white, NULL,
+            BENCH_TEX_ICON + 12 + (i * 5) % 20);
+      if (i % 3 == 0)
+         bench_icon(p_disp, 1760.0f, y + 52.0f, 64, 0.75f, bench_white,
+               NULL, BENCH_TEX_ICON + 32);
+   }
+   bench_slice(p_disp, 500, 110 + (frame % 12) * 64, BENCH_WIDTH - 560,
+         64, 16, bench_white, BENCH_TEX_ICON + 1);
+   p_disp->dispctx->scissor_end(NULL, BENCH_WIDTH, BENCH_HEIGHT);
+   gfx_display_batch_flush();
+
+   bench_quad(p_disp, 0, BENCH_HEIGHT - 80, BENCH_WIDTH, 80,
+         bench_panel, BENCH_TEX_WHITE);
+   bench_quad(p_disp, 30, BENCH_HEIGHT - 80, BENCH_WIDTH - 60, 2,
+         bench_white, BENCH_TEX_WHITE);
+   for (i = 0; i < 4; i++)
+      bench_icon(p_disp, 1400.0f + i * 120.0f, BENCH_HEIGHT - 24.0f, 64,
+            0.5f, bench_white, NULL, BENCH_TEX_ICON + 33 + i);
+   gfx_display_batch_flush();
+
+   p_disp->dispctx->blend_end(NULL);
+}
+
+/* Background, header and navigation bars with their shadows, and
+ * list entries with a divider, an icon and a switch of two parts */
+static void bench_frame_materialui(gfx_display_t *p_disp, unsigned frame)
+{
+   unsigned i;
+   int scroll = (int)(frame % 40);
+
+   p_disp->dispctx->blend_begin(NULL);
+
+   bench_quad(p_disp, 0, 0, BENCH_WIDTH, BENCH_HEIGHT,
+         bench_panel, BENCH_TEX_WHITE);
+
+   for (i = 0; i < 14; i++)
+   {
+      int y = 140 + (int)i * 72 - scroll;
+      bench_quad(p_disp, 0, y + 71, BENCH_WIDTH, 1,
+            bench_shadow, BENCH_TEX_WHITE);
+      bench_icon(p_disp, 24.0f, y + 60.0f, 128, 0.375f, bench_white, NULL,
+            BENCH_TEX_ICON + (i * 3) % 24);
+      if (i & 1)
+      {
+         bench_icon(p_disp, 1800.0f, y + 60.0f, 128, 0.375f,
+               bench_white, NULL, BENCH_TEX_ICON + 24);
+         bench_icon(p_disp, 1800.0f, y + 60.0f, 128, 0.375f,
+               bench_white, NULL, BENCH_TEX_ICON + 25 + (i & 2));
+      }
+   }
+
+   bench_quad(p_disp, 0, 0, BENCH_WIDTH, 24, bench_panel, BENCH_TEX_WHITE);
+   bench_quad(p_disp, 0, 24, BENCH_WIDTH, 96, bench_panel, BENCH_TEX_WHITE);
+   bench_quad(p_disp, 0, 120, BENCH_WIDTH, 12, bench_shadow, BENCH_TEX_WHITE);
+   bench_icon(p_disp, 24.0f, 96.0f, 128, 0.5f, bench_white, NULL,
+         BENCH_TEX_ICON + 28);
+   bench_icon(p_disp, BENCH_WIDTH - 88.0f, 96.0f, 128, 0.5f, bench_white,
+         NULL, BENCH_TEX_ICON + 29);
+
+   bench_quad(p_disp, 0, BENCH_HEIGHT - 100, BENCH_WIDTH, 12,
+         bench_shadow, BENCH_TEX_WHITE);
+   bench_quad(p_disp, 0, BENCH_HEIGHT - 88, BENCH_WIDTH, 88,
+         bench_panel, BENCH_TEX_WHITE);
+   for (i = 0; i < 4; i++)
+      bench_icon(p_disp, 200.0f + i * 460.0f, BENCH_HEIGHT - 20.0f, 128,
+            0.5f, bench_white, NULL, BENCH_TEX_ICON + 30 + i);
+
+   gfx_display_batch_flush();
+   p_disp->dispctx->blend_end(NULL);
+}
+
+static const struct bench_menu bench_menus[] = {
+   { "xmb",        256, bench_frame_xmb        },
+   { "ozone",       64, bench_frame_ozone      },
+   { "materialui", 128, bench_frame_materialui }
+};
+
+struct bench_result
+{
+   double draws;
+   double usec;
+   double area[BENCH_TEXTURES];
+};
+
+static void bench_run(const struct bench_menu *menu, enum bench_mode mode,
+      unsigned frames, struct bench_result *result)
+{
+   unsigned i;
+   retro_time_t start;
+   gfx_display_t disp;
+
+   memset(&disp, 0, sizeof(disp));
+   memset(bench_area, 0, sizeof(bench_area));
+   bench_draws    = 0;
+   disp.dispctx   = &bench_display;
+
+   if (mode == BENCH_ATLAS)
+   {
+      for (i = 0; i < BENCH_ICONS; i++)
+      {
+         unsigned x, y;
+         gfx_display_atlas_place(&disp.batch, BENCH_TEX_ICON + i,
+               menu->icon_size, menu->icon_size, &x, &y);
+      }
+      gfx_display_atlas_finish(&disp.batch, BENCH_TEX_ATLAS,
+            GFX_DISPLAY_ATLAS_SIZE);
+   }
+
+   start = cpu_features_get_time_usec();
+
+   for (i = 0; i < frames; i++)
+   {
+      bool batch = mode != BENCH_DIRECT && gfx_display_batch_begin(
+            &disp.batch, &disp.dispctx, NULL, BENCH_WIDTH, BENCH_HEIGHT);
+
+      menu->frame(&disp, i);
+
+      if (batch)
+         gfx_display_batch_end(&disp.batch, &disp.dispctx);
+   }
+
+   result->usec  = (double)(cpu_features_get_time_usec() - start) / frames;
+   result->draws = (double)bench_draws / frames;
+   memcpy(result->area, bench_area, sizeof(bench_area));
+
+   gfx_display_batch_free(&disp.batch);
+}
+
+/* Every texture covers the same area, or with the atlas
+ * at least all of them together do */
+static bool bench_check(const struct bench_result *a,
+      const struct bench_result *b, bool per_texture)
+{
+   unsigned i;
+   double total_a = 0.0;
+   double total_b = 0.0;
+
+   for (i = 0; i < BENCH_TEXTURES; i++)
+   {
+      total_a += a->area[i];
+      total_b += b->area[i];
+      if (per_texture && fabs(a->area[i] - b->area[i])
+            > 1e-4 * MAX(a->area[i], 1.0))
+         return false;
+   }
+
+   return fabs(total_a - total_b) <= 1e-4 * MAX(total_a, 1.0);
+}
+
+int main(int argc, char *argv[])
+{
+   unsigned i, j;
+   int ret         = 0;
+   unsigned frames = argc > 1 ? (unsigned)atoi(argv[1]) : 2000;
+   struct bench_result *results = (struct bench_result*)
+      calloc(BENCH_ATLAS + 1, sizeof(*results));
+
+   if (!results)
+      return 1;
+   if (frames < 1)
+      frames = 1;
+
+   matrix_4x4_ortho(bench_mvp, 0, 1, 0, 1, -1, 1);
+
+   printf("%u frames of %ux%u per run\n\n", frames, BENCH_WIDTH, BENCH_HEIGHT);
+   printf("%-11s %-8s %14s %12s %6s\n",
+         "menu", "mode", "draws/frame", "usec/frame", "area");
+
+   for (i = 0; i < ARRAY_SIZE(bench_menus); i++)
+   {
+      for (j = BENCH_DIRECT; j <= BENCH_ATLAS; j++)
+      {
+         bool ok = true;
+
+         bench_run(&bench_menus[i], (enum bench_mode)j, frames, &results[j]);
+         if (j != BENCH_DIRECT)
+            ok = bench_check(&results[BENCH_DIRECT], &results[j],
+                  j == BENCH_BATCHED);
+         if (!ok)
+            ret = 1;
+
+         printf("%-11s %-8s %14.1f %12.2f %6s\n", bench_menus[i].name,
+               bench_mode_names[j], results[j].draws, results[j].usec,
+               ok ? "ok" : "FAIL");
+      }
+   }
+
+   free(results);
+   return ret;
+}
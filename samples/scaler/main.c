@@ -0,0 +1,224 @@
+/* Image scaler benchmark.
+ *
+ * Scales 1080p to 720p and 240p to 4K with the point, bilinear
+ * and sinc filters of scaler_ctx_scale(), three times each:
+ *
+ *    base     SSE2 and C kernels only, one thread
+ *    simd     the AVX2 or NEON kernels the CPU has, one thread
+ *    threads  the same, with frames split across threads
+ *
+ * Reports the time per frame of each run, and fails if the
+ * output of the last two is not byte for byte that of the first.
+ * A few odd sizes and pixel formats are checked the same way.
+ *
+ *    ./scaler_bench [threads] [seconds per run]
+ *
+ * threads defaults to the number of cores, but at least 2.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <boolean.h>
+#include <retro_miscellaneous.h>
+#include <features/features_cpu.h>
+#include <gfx/scaler/scaler.h>
+
+struct bench_size
+{
+   int in_width;
+   int in_height;
+   int out_width;
+   int out_height;
+   enum scaler_pix_fmt in_fmt;
+   enum scaler_pix_fmt out_fmt;
+   bool timed;
+};
+
+static const struct bench_size bench_sizes[] = {
+   { 1920, 1080, 1280,  720, SCALER_FMT_ARGB8888, SCALER_FMT_ARGB8888, true  },
+   {  320,  240, 3840, 2160, SCALER_FMT_ARGB8888, SCALER_FMT_ARGB8888, true  },
+   /* Odd sizes leave a few pixels to the scalar loops */
+   {  333,  217,  517,  301, SCALER_FMT_ARGB8888, SCALER_FMT_ARGB8888, false },
+   { 1023,  767,   97,   61, SCALER_FMT_ARGB8888, SCALER_FMT_ARGB8888, false },
+   /* Recording and screenshot formats */
+   {  256,  224,  854,  480, SCALER_FMT_RGB565,   SCALER_FMT_BGR24,    false },
+   {  640,  480,  321,  239, SCALER_FMT_BGR24,    SCALER_FMT_ARGB8888, false },
+   {  400,  300,  400,  300, SCALER_FMT_RGB565,   SCALER_FMT_BGR24,    false }
+};
+
+static const enum scaler_type bench_types[] = {
+   SCALER_TYPE_POINT,
+   SCALER_TYPE_BILINEAR,
+   SCALER_TYPE_SINC
+};
+
+static const char *bench_type_names[] = {
+   "unknown",
+   "point",
+   "bilinear",
+   "sinc"
+};
+
+static int bench_bpp(enum scaler_pix_fmt fmt)
+{
+   switch (fmt)
+   {
+      case SCALER_FMT_BGR24:
+         return 3;
+      case SCALER_FMT_RGB565:
+      case SCALER_FMT_0RGB1555:
+      case SCALER_FMT_RGBA4444:
+      case SCALER_FMT_YUYV:
+         return 2;
+      default:
+         break;
+   }
+   return 4;
+}
+
+static bool bench_setup(struct scaler_ctx *ctx,
+      const struct bench_size *size, enum scaler_type type,
+      unsigned threads)
+{
+   memset(ctx, 0, sizeof(*ctx));
+   ctx->in_width    = size->in_width;
+   ctx->in_height   = size->in_height;
+   ctx->in_stride   = size->in_width * bench_bpp(size->in_fmt);
+   ctx->in_fmt      = size->in_fmt;
+   ctx->out_width   = size->out_width;
+   ctx->out_height  = size->out_height;
+   ctx->out_stride  = size->out_width * bench_bpp(size->out_fmt);
+   ctx->out_fmt     = size->out_fmt;
+   ctx->scaler_type = type;
+   ctx->threads     = threads;
+   return scaler_ctx_gen_filter(ctx);
+}
+
+/* Scales for at least @seconds and 3 frames,
+ * returns milliseconds per frame. */
+static double bench_run(const struct bench_size *size,
+      enum scaler_type type, unsigned threads, double seconds,
+      uint8_t *output, const uint8_t *input)
+{
+   struct scaler_ctx ctx;
+   unsigned frames    = 0;
+   retro_time_t start = 0;
+   retro_time_t usec  = 0;
+
+   if (!bench_setup(&ctx, size, type, threads))
+   {
+      fprintf(stderr, "Could not set up %dx%d -> %dx%d %s.\n",
+            size->in_width, size->in_height,
+            size->out_width, size->out_height,
+            bench_type_names[type]);
+      scaler_ctx_gen_reset(&ctx);
+      return -1.0;
+   }
+
+   start = cpu_features_get_time_usec();
+   do
+   {
+      scaler_ctx_scale(&ctx, output, input);
+      frames++;
+      usec = cpu_features_get_time_usec() - start;
+   } while (size->timed && (frames < 3 || usec < seconds * 1000000.0));
+
+   scaler_ctx_gen_reset(&ctx);
+   return usec / 1000.0 / frames;
+}
+
+int main(int argc, char *argv[])
+{
+   unsigned i, j;
+   unsigned threads = argc > 1 ? (unsigned)strtoul(argv[1], NULL, 0)
+      : MAX(cpu_features_get_core_amount(), 2);
+   double seconds   = argc > 2 ? atof(argv[2]) : 0.5;
+   uint64_t cpu     = cpu_features_get();
+   bool ok          = true;
+
+   printf("%u cores, %u threads, %s\n\n",
+         cpu_features_get_core_amount(), threads,
+         (cpu & RETRO_SIMD_AVX2) ? "AVX2"
+         : (cpu & RETRO_SIMD_NEON) ? "NEON" : "no AVX2 or NEON");
+   printf("%-24s %-9s %10s %10s %10s %8s %8s\n", "size", "filter",
+         "base ms", "simd ms", "thread ms", "simd x", "total x");
+
+   for (i = 0; i < ARRAY_SIZE(bench_sizes); i++)
+   {
+      const struct bench_size *size = &bench_sizes[i];
+      size_t in_size   = (size_t)size->in_width * size->in_height
+         * bench_bpp(size->in_fmt);
+      size_t out_size  = (size_t)size->out_width * size->out_height
+         * bench_bpp(size->out_fmt);
+      uint8_t *input   = (uint8_t*)malloc(in_size);
+      uint8_t *base    = (uint8_t*)malloc(out_size);
+      uint8_t *output  = (uint8_t*)malloc(out_size);
+      uint32_t seed    = 0x12345678;
+      char name[64];
+
+      if (!input || !base || !output)
+         return 1;
+
+      /* Noise in every channel, alpha too */
+      for (j = 0; j < in_size; j++)
+      {
+         seed     = seed * 1664525 + 1013904223;
+         input[j] = (uint8_t)(seed >> 24);
+      }
+
+      snprintf(name, sizeof(name), "%dx%d -> %dx%d%s",
+            size->in_width, size->in_height,
+            size->out_width, size->out_height,
+            (size->in_fmt == SCALER_FMT_ARGB8888
+             && size->out_fmt == SCALER_FMT_ARGB8888) ? "" : " fmt");
+
+      for (j = 0; j < ARRAY_SIZE(bench_types); j++)
+      {
+         double base_ms, simd_ms, thread_ms;
+         bool same = true;
+
+         scaler_init_simd(0);
+         memset(base, 0, out_size);
+         base_ms   = bench_run(size, bench_types[j], 1, seconds,
+               base, input);
+
+         scaler_init_simd(cpu);
+         memset(output, 0xaa, out_size);
+         simd_ms   = bench_run(size, bench_types[j], 1, seconds,
+               output, input);
+         same      = !memcmp(base, output, out_size);
+
+         memset(output, 0x55, out_size);
+         thread_ms = bench_run(size, bench_types[j], threads, seconds,
+               output, input);
+         same      = same && !memcmp(base, output, out_size);
+
+         if (base_ms < 0.0 || simd_ms < 0.0 || thread_ms < 0.0)
+            same = false;
+
+         if (size->timed)
+            printf("%-24s %-9s %10.2f %10.2f %10.2f %8.2f %8.2f%s\n",
+                  name, bench_type_names[bench_types[j]],
+                  base_ms, simd_ms, thread_ms,
+                  base_ms / simd_ms, base_ms / thread_ms,
+                  same ? "" : "  MISMATCH");
+         else
+            printf("%-24s %-9s %43s\n", name,
+                  bench_type_names[bench_types[j]],
+                  same ? "same" : "MISMATCH");
+
+         if (!same)
+            ok = false;
+      }
+
+      free(input);
+      free(base);
+      free(output);
+   }
+
+   if (!ok)
+      printf("FAILED\n");
+   return ok ? 0 : 1;
+}
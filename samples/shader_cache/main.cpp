@@ -0,0 +1,334 @@
+/* Slang shader cache benchmark.
+ *
+ * Compiles every pass of the given presets or shaders with the
+ * shader cache disabled, one pass after the other and then all
+ * passes at once through glslang_compile_shaders(). Then they
+ * are compiled twice more, first against an empty shader cache
+ * and then against the entries the first run stored. Reports
+ * all four times. The parallel and the cached output have to
+ * match what glslang produced. Finally the cache is trimmed
+ * to half its size to check that eviction keeps it in bounds.
+ *
+ *    ./shader_cache_bench [cache dir] [file.slangp|file.slang ...]
+ *
+ * Without files, a small built-in shader is compiled.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdarg.h>
+#include <string.h>
+
+#include <string>
+#include <vector>
+
+#include <file/file_path.h>
+#include <file/config_file.h>
+#include <lists/dir_list.h>
+#include <streams/file_stream.h>
+#include <string/stdstring.h>
+#include <features/features_cpu.h>
+
+#include "../../gfx/drivers_shader/glslang_util.h"
+#include "../../gfx/drivers_shader/glslang_util_cxx.h"
+#include "../../gfx/drivers_shader/glslang_cache.h"
+
+static const char *builtin_shader =
+   "#version 450\n"
+   "\n"
+   "#pragma name Builtin\n"
+   "#pragma format R8G8B8A8_SRGB\n"
+   "#pragma parameter STRENGTH \"Strength\" 0.5 0.0 1.0 0.05\n"
+   "\n"
+   "layout(push_constant) uniform Push\n"
+   "{\n"
+   "   vec4 SourceSize;\n"
+   "   float STRENGTH;\n"
+   "} params;\n"
+   "\n"
+   "layout(std140, set = 0, binding = 0) uniform UBO\n"
+   "{\n"
+   "   mat4 MVP;\n"
+   "} global;\n"
+   "\n"
+   "#pragma stage vertex\n"
+   "layout(location = 0) in vec4 Position;\n"
+   "layout(location = 1) in vec2 TexCoord;\n"
+   "layout(location = 0) out vec2 vTexCoord;\n"
+   "\n"
+   "void main()\n"
+   "{\n"
+   "   gl_Position = global.MVP * Position;\n"
+   "   vTexCoord   = TexCoord;\n"
+   "}\n"
+   "\n"
+   "#pragma stage fragment\n"
+   "layout(location = 0) in vec2 vTexCoord;\n"
+   "layout(location = 0) out vec4 FragColor;\n"
+   "layout(set = 0, binding = 2) uniform sampler2D Source;\n"
+   "\n"
+   "void main()\n"
+   "{\n"
+   "   vec2 d    = params.SourceSize.zw;\n"
+   "   vec4 blur = texture(Source, vTexCoord + vec2(d.x, 0.0))\n"
+   "             + texture(Source, vTexCoord - vec2(d.x, 0.0))\n"
+   "             + texture(Source, vTexCoord + vec2(0.0, d.y))\n"
+   "             + texture(Source, vTexCoord - vec2(0.0, d.y));\n"
+   "   FragColor = mix(texture(Source, vTexCoord), 0.25 * blur,\n"
+   "         params.STRENGTH);\n"
+   "}\n";
+
+/* glslang_util and the cache log through these */
+extern "C" {
+void RARCH_LOG(const char *fmt, ...) { }
+void RARCH_DBG(const char *fmt, ...) { }
+
+void RARCH_WARN(const char *fmt, ...)
+{
+   va_list ap;
+   va_start(ap, fmt);
+   vfprintf(stderr, fmt, ap);
+   va_end(ap);
+}
+
+void RARCH_ERR(const char *fmt, ...)
+{
+   va_list ap;
+   va_start(ap, fmt);
+   vfprintf(stderr, fmt, ap);
+   va_end(ap);
+}
+}
+
+static void add_preset_passes(const char *path,
+      std::vector<std::string> *passes)
+{
+   unsigned i, count = 0;
+   config_file_t *conf = config_file_new_from_path_to_string(path);
+
+   if (!conf)
+      return;
+
+   config_get_uint(conf, "shaders", &count);
+
+   for (i = 0; i < count; i++)
+   {
+      char key[64];
+      char shader[PATH_MAX_LENGTH];
+      char resolved[PATH_MAX_LENGTH];
+
+      snprintf(key, sizeof(key), "shader%u", i);
+      if (!config_get_path(conf, key, shader, sizeof(shader)))
+         continue;
+
+      fill_pathname_resolve_relative(resolved, path, shader,
+            sizeof(resolved));
+      passes->push_back(resolved);
+   }
+
+   config_file_free(conf);
+}
+
+static void clear_dir(const char *dir)
+{
+   size_t i;
+   struct string_list *list = dir_list_new(dir, NULL,
+         false, true, false, false);
+
+   if (!list)
+      return;
+
+   for (i = 0; i < list->size; i++)
+      filestream_delete(list->elems[i].data);
+   dir_list_free(list);
+}
+
+static uint64_t dir_size(const char *dir, unsigned *files)
+{
+   size_t i;
+   uint64_t size            = 0;
+   struct string_list *list = dir_list_new(dir, NULL,
+         false, true, false, false);
+
+   *files = 0;
+   if (!list)
+      return 0;
+
+   for (i = 0; i < list->size; i++)
+      size += (uint64_t)path_get_size(list->elems[i].data);
+   *files = (unsigned)list->size;
+   dir_list_free(list);
+   return size;
+}
+
+static bool same_output(const glslang_output &a, const glslang_output &b)
+{
+   size_t i;
+
+   if (     a.vertex         != b.vertex
+         || a.fragment       != b.fragment
+         || a.meta.name      != b.meta.name
+         || a.meta.rt_format != b.meta.rt_format
+         || a.meta.parameters.size() != b.meta.parameters.size())
+      return false;
+
+   for (i = 0; i < a.meta.parameters.size(); i++)
+   {
+      const glslang_parameter &pa = a.meta.parameters[i];
+      const glslang_parameter &pb = b.meta.parameters[i];
+      if (     pa.id      != pb.id      || pa.desc    != pb.desc
+            || pa.initial != pb.initial || pa.minimum != pb.minimum
+            || pa.maximum != pb.maximum || pa.step    != pb.step)
+         return false;
+   }
+
+   return true;
+}
+
+static retro_time_t compile_all(const std::vector<std::string> &passes,
+      std::vector<glslang_output> *outputs)
+{
+   size_t i;
+   retro_time_t start = cpu_features_get_time_usec();
+
+   outputs->resize(passes.size());
+   for (i = 0; i < passes.size(); i++)
+   {
+      if (!glslang_compile_shader(passes[i].c_str(), &(*outputs)[i]))
+      {
+         fprintf(stderr, "Failed to compile \"%s\".\n", passes[i].c_str());
+         return -1;
+      }
+   }
+
+   return cpu_features_get_time_usec() - start;
+}
+
+static bool compare_all(const std::vector<std::string> &passes,
+      const std::vector<glslang_output> &a,
+      const std::vector<glslang_output> &b, const char *what)
+{
+   size_t i;
+   bool ok = true;
+
+   for (i = 0; i < passes.size(); i++)
+   {
+      if (!same_output(a[i], b[i]))
+      {
+         fprintf(stderr, "%s output differs for \"%s\".\n",
+               what, passes[i].c_str());
+         ok = false;
+      }
+   }
+
+   return ok;
+}
+
+static void print_run(const char *name, retro_time_t usec, size_t passes)
+{
+   printf("%-10s %12.2f %12.2f\n", name, usec / 1000.0,
+         usec / 1000.0 / passes);
+}
+
+int main(int argc, char *argv[])
+{
+   int i;
+   size_t j;
+   unsigned files;
+   uint64_t size;
+   retro_time_t serial, parallel, cold, warm;
+   std::vector<std::string> passes;
+   std::vector<const char*> paths;
+   std::vector<glslang_output> serial_out, parallel_out, cold_out, warm_out;
+   char builtin_path[PATH_MAX_LENGTH];
+   char cache_dir[PATH_MAX_LENGTH];
+   const char *dir = argc > 1 ? argv[1] : "shader_cache_bench";
+   bool ok         = true;
+
+   for (i = 2; i < argc; i++)
+   {
+      if (string_is_equal(path_get_extension(argv[i]), "slangp"))
+         add_preset_passes(argv[i], &passes);
+      else
+         passes.push_back(argv[i]);
+   }
+
+   if (!path_is_directory(dir) && !path_mkdir(dir))
+   {
+      fprintf(stderr, "Could not create \"%s\".\n", dir);
+      return 1;
+   }
+
+   if (passes.empty())
+   {
+      RFILE *file;
+
+      fill_pathname_join(builtin_path, dir, "builtin.slang",
+            sizeof(builtin_path));
+      if (!(file = filestream_open(builtin_path, RETRO_VFS_FILE_ACCESS_WRITE,
+                  RETRO_VFS_FILE_ACCESS_HINT_NONE)))
+         return 1;
+      filestream_write(file, builtin_shader, strlen(builtin_shader));
+      filestream_close(file);
+      passes.push_back(builtin_path);
+   }
+
+   /* The cache lives in a subdirectory, so the builtin
+    * shader is not taken for a stray cache entry */
+   fill_pathname_join(cache_dir, dir, "cache", sizeof(cache_dir));
+   clear_dir(cache_dir);
+
+   /* Without the cache */
+   glslang_cache_init(cache_dir, 0);
+   if ((serial = compile_all(passes, &serial_out)) < 0)
+      return 1;
+
+   for (j = 0; j < passes.size(); j++)
+      paths.push_back(passes[j].c_str());
+   parallel_out.resize(passes.size());
+   parallel = cpu_features_get_time_usec();
+   if (!glslang_compile_shaders(paths.data(), (unsigned)paths.size(),
+            parallel_out.data(), NULL))
+      return 1;
+   parallel = cpu_features_get_time_usec() - parallel;
+   ok       = compare_all(passes, serial_out, parallel_out, "Parallel");
+
+   glslang_cache_init(cache_dir, (uint64_t)64 << 20);
+   if ((cold = compile_all(passes, &cold_out)) < 0)
+      return 1;
+   /* Restarting reloads the cache from disk */
+   glslang_cache_init(cache_dir, (uint64_t)64 << 20);
+   if ((warm = compile_all(passes, &warm_out)) < 0)
+      return 1;
+   if (!compare_all(passes, cold_out, warm_out, "Cached"))
+      ok = false;
+
+   size = dir_size(cache_dir, &files);
+   printf("%u passes, %u cores, %u cache files, %u KB\n\n",
+         (unsigned)passes.size(), cpu_features_get_core_amount(),
+         files, (unsigned)(size >> 10));
+   printf("%-10s %12s %12s\n", "run", "total ms", "per pass ms");
+   print_run("serial", serial, passes.size());
+   print_run("parallel", parallel, passes.size());
+   print_run("cold", cold, passes.size());
+   print_run("warm", warm, passes.size());
+   printf("\nparallel is %.1fx faster, warm is %.1fx faster\n",
+         (double)serial / (parallel ? parallel : 1),
+         (double)cold / (warm ? warm : 1));
+
+   /* Eviction keeps the cache within its limit */
+   if (files > 1)
+   {
+      uint64_t limit = size / 2;
+      glslang_cache_init(cache_dir, limit);
+      size = dir_size(cache_dir, &files);
+      printf("after trimming to half: %u cache files, %u KB\n",
+            files, (unsigned)(size >> 10));
+      if (size > limit)
+         ok = false;
+   }
+
+   if (!ok)
+      printf("FAILED\n");
+   return ok ? 0 : 1;
+}
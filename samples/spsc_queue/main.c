@@ -0,0 +1,271 @@
+/* Audio ring buffer stress test.
+ *
+ * Feeds a simulated realtime audio thread from an emulator-like
+ * producer, once through a fifo_buffer_t guarded by a lock (the
+ * way the threaded audio drivers used to) and once through the
+ * lock-free spsc_queue_t. Extra threads keep the CPU busy and
+ * poll the free space the way the frontend does for rate control,
+ * so the lock gets held by threads that get preempted.
+ *
+ * Reports how often the audio thread found less than a period
+ * of data (underruns), the worst time it spent fetching a period,
+ * and the worst time a producer write took:
+ *
+ *    ./spsc_queue_stress [seconds] [contending threads]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <boolean.h>
+#include <retro_timers.h>
+#include <rthreads/rthreads.h>
+#include <features/features_cpu.h>
+#include <queues/fifo_queue.h>
+#include <queues/spsc_queue.h>
+
+/* 48 kHz stereo S16 */
+#define STRESS_RATE          48000
+#define STRESS_FRAME_BYTES   4
+/* Audio thread wakes up every 256 frames */
+#define STRESS_PERIOD_FRAMES 256
+/* Producer writes one 60 Hz video frame worth at a time */
+#define STRESS_CHUNK_FRAMES  (STRESS_RATE / 60)
+#define STRESS_BUFFER_BYTES  (STRESS_PERIOD_FRAMES * 8 * STRESS_FRAME_BYTES)
+
+struct stress_state
+{
+   fifo_buffer_t *fifo;
+   slock_t *fifo_lock;
+   spsc_queue_t *queue;
+
+   retro_time_t end_time;
+   /* Audio thread */
+   retro_time_t worst_read_usec;
+   unsigned underruns;
+   unsigned periods;
+   bool corrupt;
+   /* Producer */
+   retro_time_t worst_write_usec;
+   volatile bool done;
+   bool lock_free;
+};
+
+static size_t stress_write(struct stress_state *st,
+      const uint8_t *data, size_t size)
+{
+   size_t written;
+
+   if (st->lock_free)
+      return spsc_queue_write(st->queue, data, size);
+
+   slock_lock(st->fifo_lock);
+   written = FIFO_WRITE_AVAIL(st->fifo);
+   if (written > size)
+      written = size;
+   fifo_write(st->fifo, data, written);
+   slock_unlock(st->fifo_lock);
+   return written;
+}
+
+static size_t stress_read(struct stress_state *st,
+      uint8_t *data, size_t size)
+{
+   size_t read;
+
+   if (st->lock_free)
+      return spsc_queue_read(st->queue, data, size);
+
+   slock_lock(st->fifo_lock);
+   read = FIFO_READ_AVAIL(st->fifo);
+   if (read > size)
+      read = size;
+   fifo_read(st->fifo, data, read);
+   slock_unlock(st->fifo_lock);
+   return read;
+}
+
+static size_t stress_write_avail(struct stress_state *st)
+{
+   size_t avail;
+
+   if (st->lock_free)
+      return spsc_queue_write_avail(st->queue);
+
+   slock_lock(st->fifo_lock);
+   avail = FIFO_WRITE_AVAIL(st->fifo);
+   slock_unlock(st->fifo_lock);
+   return avail;
+}
+
+static void stress_audio_thread(void *data)
+{
+   uint8_t period[STRESS_PERIOD_FRAMES * STRESS_FRAME_BYTES];
+   struct stress_state *st = (struct stress_state*)data;
+   retro_time_t period_usec = (retro_time_t)STRESS_PERIOD_FRAMES
+      * 1000000 / STRESS_RATE;
+   retro_time_t deadline    = cpu_features_get_time_usec() + period_usec;
+   uint8_t expected         = 0;
+
+   while (deadline < st->end_time)
+   {
+      size_t i, read;
+      retro_time_t start, elapsed;
+
+      /* Wait for the "hardware" to want the next period */
+      while (cpu_features_get_time_usec() < deadline)
+         retro_sleep(1);
+      deadline += period_usec;
+
+      start   = cpu_features_get_time_usec();
+      read    = stress_read(st, period, sizeof(period));
+      elapsed = cpu_features_get_time_usec() - start;
+
+      if (elapsed > st->worst_read_usec)
+         st->worst_read_usec = elapsed;
+      if (read < sizeof(period))
+         st->underruns++;
+      st->periods++;
+
+      for (i = 0; i < read; i++, expected++)
+         if (period[i] != expected)
+            st->corrupt = true;
+   }
+
+   st->done = true;
+}
+
+static void stress_producer_thread(void *data)
+{
+   uint8_t chunk[STRESS_CHUNK_FRAMES * STRESS_FRAME_BYTES];
+   struct stress_state *st = (struct stress_state*)data;
+   uint8_t next            = 0;
+
+   while (!st->done)
+   {
+      size_t written = 0;
+
+      while (written < sizeof(chunk) && !st->done)
+      {
+         size_t i, amount;
+         retro_time_t elapsed;
+         retro_time_t start = cpu_features_get_time_usec();
+
+         for (i = written; i < sizeof(chunk); i++)
+            chunk[i] = (uint8_t)(next + (i - written));
+
+         amount  = stress_write(st, chunk + written, sizeof(chunk) - written);
+         elapsed = cpu_features_get_time_usec() - start;
+         if (elapsed > st->worst_write_usec)
+            st->worst_write_usec = elapsed;
+
+         next    += (uint8_t)amount;
+         written += amount;
+
+         /* Blocking write, wait for room */
+         if (written < sizeof(chunk))
+            retro_sleep(1);
+      }
+   }
+}
+
+/* Burns CPU and polls the free space like the
+ * frontend's dynamic rate control does. */
+static void stress_contender_thread(void *data)
+{
+   struct stress_state *st = (struct stress_state*)data;
+   volatile size_t sink    = 0;
+
+   while (!st->done)
+   {
+      unsigned i;
+      for (i = 0; i < 10000; i++)
+         sink += i;
+      sink += stress_write_avail(st);
+   }
+}
+
+static bool stress_run(bool lock_free, double seconds,
+      unsigned contenders, struct stress_state *st)
+{
+   unsigned i;
+   sthread_t *audio, *producer;
+   sthread_t *threads[64];
+
+   memset(st, 0, sizeof(*st));
+   st->lock_free = lock_free;
+   st->end_time  = cpu_features_get_time_usec()
+      + (retro_time_t)(seconds * 1000000.0);
+
+   if (lock_free)
+      st->queue     = spsc_queue_new(STRESS_BUFFER_BYTES);
+   else
+   {
+      st->fifo      = fifo_new(STRESS_BUFFER_BYTES);
+      st->fifo_lock = slock_new();
+   }
+
+   if (!st->queue && (!st->fifo || !st->fifo_lock))
+      return false;
+
+   producer = sthread_create(stress_producer_thread, st);
+   for (i = 0; i < contenders; i++)
+      threads[i] = sthread_create(stress_contender_thread, st);
+   audio    = sthread_create_with_priority(stress_audio_thread, st, 95);
+   if (!audio)
+      audio = sthread_create(stress_audio_thread, st);
+
+   sthread_join(audio);
+   sthread_join(producer);
+   for (i = 0; i < contenders; i++)
+      sthread_join(threads[i]);
+
+   spsc_queue_free(st->queue);
+   fifo_free(st->fifo);
+   if (st->fifo_lock)
+      slock_free(st->fifo_lock);
+   return true;
+}
+
+int main(int argc, char *argv[])
+{
+   unsigned mode;
+   struct stress_state st;
+   double seconds      = 5.0;
+   unsigned contenders = 4;
+
+   if (argc > 1)
+      seconds    = atof(argv[1]);
+   if (argc > 2)
+      contenders = (unsigned)atoi(argv[2]);
+   if (seconds <= 0.0 || contenders > 64)
+   {
+      fprintf(stderr, "Usage: %s [seconds] [contending threads, max 64]\n",
+            argv[0]);
+      return 1;
+   }
+
+   printf("%.1f s per run, %u contending threads, %u frame periods\n\n",
+         seconds, contenders, STRESS_PERIOD_FRAMES);
+   printf("%-12s %10s %10s %16s %16s\n", "buffer", "periods",
+         "underruns", "worst read us", "worst write us");
+
+   for (mode = 0; mode < 2; mode++)
+   {
+      if (!stress_run(mode == 1, seconds, contenders, &st))
+      {
+         fprintf(stderr, "Out of memory.\n");
+         return 1;
+      }
+
+      printf("%-12s %10u %10u %16lld %16lld%s\n",
+            mode ? "spsc_queue" : "fifo+lock",
+            st.periods, st.underruns,
+            (long long)st.worst_read_usec,
+            (long long)st.worst_write_usec,
+            st.corrupt ? "  DATA CORRUPTED" : "");
+   }
+
+   return 0;
+}
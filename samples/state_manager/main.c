@@ -0,0 +1,194 @@
+/* Rewind delta compressor benchmark.
+ *
+ * Replays a recorded sequence of savestates through the rewind
+ * delta compressor, the same way state_manager.c feeds it every
+ * rewind granularity tick, and reports throughput and per-push
+ * latency.
+ *
+ * Record the input by saving states every few frames with
+ * savestate compression disabled (rzip-compressed states are
+ * unpacked transparently), then run e.g.:
+ *
+ *    ./state_manager_bench -t 4 -n 20 capture-*.state
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <features/features_cpu.h>
+#include <streams/rzip_stream.h>
+
+#include "../../state_manager_delta.h"
+
+struct bench_result
+{
+   retro_time_t total_usec;
+   retro_time_t max_usec;
+   /* Time the caller is blocked in state_manager_delta_begin(),
+    * which is all the frame pays for when compression is threaded. */
+   retro_time_t begin_usec;
+   uint64_t patch_bytes;
+   unsigned pushes;
+};
+
+static void bench_run(uint8_t **states, unsigned num_states,
+      size_t state_size, unsigned threads, unsigned iterations,
+      uint8_t *patch, uint8_t *verify, struct bench_result *res)
+{
+   unsigned i, j;
+   state_manager_delta_t *delta = state_manager_delta_new(
+         state_size, threads);
+
+   memset(res, 0, sizeof(*res));
+
+   if (!delta)
+      return;
+
+   for (j = 0; j < iterations; j++)
+   {
+      for (i = 1; i < num_states; i++)
+      {
+         size_t written;
+         retro_time_t start = cpu_features_get_time_usec();
+         retro_time_t elapsed;
+
+         state_manager_delta_begin(delta, states[i - 1], states[i], patch);
+         res->begin_usec += cpu_features_get_time_usec() - start;
+         written = state_manager_delta_end(delta);
+         elapsed = cpu_features_get_time_usec() - start;
+
+         res->total_usec  += elapsed;
+         res->patch_bytes += written;
+         res->pushes++;
+         if (elapsed > res->max_usec)
+            res->max_usec = elapsed;
+
+         /* Check the patch turns the new state back into the old one. */
+         if (verify && j == 0)
+         {
+            memcpy(verify, states[i], state_size);
+            state_manager_raw_decompress(patch, written, verify, state_size);
+            if (memcmp(verify, states[i - 1], state_size))
+               fprintf(stderr, "Patch %u does not round-trip!\n", i);
+         }
+      }
+   }
+
+   state_manager_delta_free(delta);
+}
+
+static void bench_print(const char *label, size_t state_size,
+      const struct bench_result *res)
+{
+   double mb = (double)state_size * res->pushes / (1024.0 * 1024.0);
+
+   if (!res->pushes || !res->total_usec)
+      return;
+
+   printf("%-12s %10.1f MB/s  avg %8.1f us/push  max %8lld us/push  main thread %8.1f us/push  ratio %5.2f%%\n",
+         label,
+         mb / (res->total_usec / 1000000.0),
+         (double)res->total_usec / res->pushes,
+         (long long)res->max_usec,
+         (double)res->begin_usec / res->pushes,
+         100.0 * res->patch_bytes / ((double)state_size * res->pushes));
+}
+
+int main(int argc, char *argv[])
+{
+   int i;
+   unsigned t;
+   char label[32];
+   struct bench_result res;
+   unsigned threads     = 4;
+   unsigned iterations  = 10;
+   unsigned num_states  = 0;
+   size_t state_size    = 0;
+   uint8_t **states     = NULL;
+   uint8_t *patch       = NULL;
+   uint8_t *verify      = NULL;
+
+   for (i = 1; i < argc; i++)
+   {
+      if (!strcmp(argv[i], "-t") && i + 1 < argc)
+         threads    = (unsigned)strtoul(argv[++i], NULL, 0);
+      else if (!strcmp(argv[i], "-n") && i + 1 < argc)
+         iterations = (unsigned)strtoul(argv[++i], NULL, 0);
+      else
+         break;
+   }
+
+   if (argc - i < 2)
+   {
+      fprintf(stderr, "Usage: %s [-t max threads] [-n iterations] <state> <state> [...]\n", argv[0]);
+      return 1;
+   }
+
+   states = (uint8_t**)calloc(argc - i, sizeof(*states));
+
+   for (; i < argc; i++)
+   {
+      void *buf   = NULL;
+      int64_t len = 0;
+
+      if (!rzipstream_read_file(argv[i], &buf, &len) || len <= 0)
+      {
+         fprintf(stderr, "Failed to read %s, skipping.\n", argv[i]);
+         continue;
+      }
+
+      if (!state_size)
+         state_size = (size_t)len;
+      else if ((size_t)len != state_size)
+      {
+         fprintf(stderr, "%s is %lld bytes, expected %u, skipping.\n",
+               argv[i], (long long)len, (unsigned)state_size);
+         free(buf);
+         continue;
+      }
+
+      /* The compressor needs its end markers to alternate. */
+      states[num_states] = (uint8_t*)state_manager_raw_alloc(
+            state_size, num_states & 1);
+      memcpy(states[num_states], buf, state_size);
+      free(buf);
+      num_states++;
+   }
+
+   if (num_states < 2)
+   {
+      fprintf(stderr, "Need at least two savestates of the same size.\n");
+      return 1;
+   }
+
+   patch  = (uint8_t*)malloc(state_manager_raw_maxsize(state_size));
+   verify = (uint8_t*)state_manager_raw_alloc(state_size, 2);
+
+   printf("%u states of %u bytes, %u iterations\n",
+         num_states, (unsigned)state_size, iterations);
+
+   bench_run(states, num_states, state_size, 0, iterations,
+         patch, verify, &res);
+   bench_print("sync", state_size, &res);
+
+#ifdef HAVE_THREADS
+   for (t = 1; t <= threads && t <= STATE_MANAGER_DELTA_THREADS_MAX; t++)
+   {
+      snprintf(label, sizeof(label), "%u thread(s)", t);
+      bench_run(states, num_states, state_size, t, iterations,
+            patch, verify, &res);
+      bench_print(label, state_size, &res);
+   }
+#else
+   (void)label;
+#endif
+
+   for (t = 0; t < num_states; t++)
+      free(states[t]);
+   free(states);
+   free(patch);
+   free(verify);
+
+   return 0;
+}
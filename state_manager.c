@@ -25,15 +25,26 @@
 
 #include <retro_inline.h>
 #include <compat/strl.h>
-#include <compat/intrinsics.h>
+#include <file/file_path.h>
+#include <streams/trans_stream.h>
+#include <string/stdstring.h>
+
+#if defined(HAVE_MMAP) && !defined(_WIN32)
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#define HAVE_REWIND_SPILL
+#endif
 
 #include "state_manager.h"
+#include "state_manager_delta.h"
 #include "msg_hash.h"
 #include "core.h"
 #include "core_info.h"
 #include "retroarch.h"
 #include "verbosity.h"
 #include "content.h"
+#include "runloop.h"
 #include "audio/audio_driver.h"
 
 #ifdef HAVE_NETWORKING
@@ -44,335 +55,506 @@
 /* Keep it off unless you're chasing a core bug, it slows things down. */
 #define STRICT_BUF_SIZE 0
 
-#ifndef UINT16_MAX
-#define UINT16_MAX 0xffff
-#endif
+/* Amount of evicted deltas recompressed together into one
+ * cold block. Small enough that compressing a block (which
+ * happens on the main thread) stays well under a frame. */
+#define STATE_MANAGER_COLD_BLOCK_SIZE (256 * 1024)
 
-#ifndef UINT32_MAX
-#define UINT32_MAX 0xffffffffu
-#endif
+/* zlib level used for cold blocks; speed matters more than
+ * ratio here, the deltas are mostly zeros anyway. */
+#define STATE_MANAGER_COLD_LEVEL 1
 
-#if defined(__x86_64__) || defined(__i386__) || defined(__i486__) || defined(__i686__) || defined(_M_IX86) || defined(_M_AMD64) || defined(_M_X64)
-#define CPU_X86
-#endif
+/* The start offsets point to 'nextstart' of any given compressed frame.
+ * Each uint16 is stored native endian; anything that claims any other
+ * endianness refers to the endianness of this specific item.
+ * The uint32 is stored little endian.
+ *
+ * Each size value is stored native endian if alignment is not enforced;
+ * if it is, they're little endian.
+ *
+ * The start of the buffer contains a size pointing to the end of the
+ * buffer; the end points to its start.
+ *
+ * Wrapping is handled by returning to the start of the buffer if the
+ * compressed data could potentially hit the edge;
+ *
+ * if the compressed data could potentially overwrite the tail pointer,
+ * the tail retreats until it can no longer collide.
+ *
+ * This means that on average, ~2 * maxcompsize is
+ * unused at any given moment. */
 
-/* Other arches SIGBUS (usually) on unaligned accesses. */
-#ifndef CPU_X86
-#define NO_UNALIGNED_MEM
-#endif
+/* These are called very few constant times per frame,
+ * keep it as simple as possible. */
+static INLINE void write_size_t(void *ptr, size_t val)
+{
+   memcpy(ptr, &val, sizeof(val));
+}
 
-#if __SSE2__
-#include <emmintrin.h>
-#endif
+static INLINE size_t read_size_t(const void *ptr)
+{
+   size_t ret;
 
-/* Format per frame (pseudocode): */
-#if 0
-size nextstart;
-repeat {
-   uint16 numchanged; /* everything is counted in units of uint16 */
-   if (numchanged)
+   memcpy(&ret, ptr, sizeof(ret));
+   return ret;
+}
+
+/* Cold tier */
+
+static uint8_t *state_manager_cold_compress(state_manager_t *state,
+      const uint8_t *in, uint32_t in_size, uint32_t *out_size)
+{
+   uint8_t *out                                = NULL;
+   uint8_t *shrunk                             = NULL;
+   const struct trans_stream_backend *backend  =
+      trans_stream_get_zlib_deflate_backend();
+
+   if (!(out = (uint8_t*)malloc(in_size)))
+      return NULL;
+
+   if (backend && state->deflate_stream)
    {
-      uint16 numunchanged; /* skip these before handling numchanged */
-      uint16[numchanged] changeddata;
+      uint32_t rd                 = 0;
+      uint32_t wn                 = 0;
+      enum trans_stream_error err = TRANS_STREAM_ERROR_NONE;
+
+      backend->define(state->deflate_stream, "level",
+            STATE_MANAGER_COLD_LEVEL);
+      backend->set_in(state->deflate_stream, in, in_size);
+      /* One byte short, so a compressed block can never be
+       * mistaken for a stored one. */
+      backend->set_out(state->deflate_stream, out, in_size - 1);
+
+      if (     backend->trans(state->deflate_stream, true, &rd, &wn, &err)
+            && err == TRANS_STREAM_ERROR_NONE)
+      {
+         *out_size = wn;
+         if ((shrunk = (uint8_t*)realloc(out, wn)))
+            out    = shrunk;
+         return out;
+      }
+
+      /* Didn't fit (or failed), the stream is in an unknown
+       * state now. Start over with a fresh one next time. */
+      backend->stream_free(state->deflate_stream);
+      state->deflate_stream = backend->stream_new();
    }
-   else
+
+   /* Store uncompressed; comp_size == raw_size marks this. */
+   memcpy(out, in, in_size);
+   *out_size = in_size;
+   return out;
+}
+
+static bool state_manager_cold_decompress(state_manager_t *state,
+      const uint8_t *in, uint32_t in_size, uint8_t *out, uint32_t out_size)
+{
+   uint32_t rd                                 = 0;
+   uint32_t wn                                 = 0;
+   enum trans_stream_error err                 = TRANS_STREAM_ERROR_NONE;
+   const struct trans_stream_backend *backend  =
+      trans_stream_get_zlib_inflate_backend();
+
+   if (in_size == out_size)
    {
-      uint32 numunchanged;
-      if (!numunchanged)
-         break;
+      memcpy(out, in, out_size);
+      return true;
    }
+
+   if (!backend || !state->inflate_stream)
+      return false;
+
+   backend->set_in(state->inflate_stream, in, in_size);
+   backend->set_out(state->inflate_stream, out, out_size);
+
+   if (     backend->trans(state->inflate_stream, true, &rd, &wn, &err)
+         && err == TRANS_STREAM_ERROR_NONE
+         && wn == out_size)
+      return true;
+
+   backend->stream_free(state->inflate_stream);
+   state->inflate_stream = backend->stream_new();
+   return false;
 }
-size thisstart;
-#endif
 
-/* There's no equivalent in libc, you'd think so ...
- * std::mismatch exists, but it's not optimized at all. */
-static size_t find_change(const uint16_t *a, const uint16_t *b)
+/* Forgets the oldest cold block, wherever it lives. */
+static void state_manager_cold_drop_oldest(state_manager_t *state)
 {
-#if __SSE2__
-   const __m128i *a128 = (const __m128i*)a;
-   const __m128i *b128 = (const __m128i*)b;
+   struct state_manager_cold_block *block = &state->cold_blocks[0];
+
+   if (!state->cold_count)
+      return;
 
-   for (;;)
+   if (state->spill_count)
+   {
+      state->spill_count--;
+      state->spill_entries -= block->entries;
+      state->spill_size    -= block->comp_size;
+   }
+   else
    {
-      __m128i v0    = _mm_loadu_si128(a128);
-      __m128i v1    = _mm_loadu_si128(b128);
-      __m128i c     = _mm_cmpeq_epi8(v0, v1);
-      uint32_t mask = _mm_movemask_epi8(c);
+      free(block->data);
+      state->cold_entries  -= block->entries;
+      state->cold_size     -= block->comp_size;
+   }
 
-      if (mask != 0xffff) /* Something has changed, figure out where. */
-      {
-         /* calculate the real offset to the differing byte */
-         size_t ret = (((uint8_t*)a128 - (uint8_t*)a) |
-               (compat_ctz(~mask)));
+   state->cold_count--;
+   memmove(state->cold_blocks, state->cold_blocks + 1,
+         state->cold_count * sizeof(*state->cold_blocks));
+}
 
-         /* and convert that to the uint16_t offset */
-         return (ret >> 1);
-      }
+#ifdef HAVE_REWIND_SPILL
+/* Moves the oldest in-memory cold block to the spill file. */
+static void state_manager_spill_oldest(state_manager_t *state)
+{
+   size_t pos                             = state->spill_pos;
+   struct state_manager_cold_block *block =
+      &state->cold_blocks[state->spill_count];
 
-      a128++;
-      b128++;
+   if (block->comp_size > state->spill_capacity)
+   {
+      /* Can't ever fit; everything older has to go with it. */
+      while (state->spill_count)
+         state_manager_cold_drop_oldest(state);
+      state_manager_cold_drop_oldest(state);
+      return;
    }
-#else
-   const uint16_t *a_org = a;
-#ifdef NO_UNALIGNED_MEM
-   while (((uintptr_t)a & (sizeof(size_t) - 1)) && *a == *b)
+
+   if (pos + block->comp_size > state->spill_capacity)
    {
-      a++;
-      b++;
+      /* Whatever is left past the wrap point is from the
+       * previous lap and therefore the oldest data. */
+      while (     state->spill_count
+            && state->cold_blocks[0].spill_offset >= pos)
+         state_manager_cold_drop_oldest(state);
+      pos = 0;
    }
-   if (*a == *b)
-#endif
+
+   /* The file is a ring, so whatever we are about to
+    * overwrite is always the oldest data. */
+   while (state->spill_count)
    {
-      const size_t *a_big = (const size_t*)a;
-      const size_t *b_big = (const size_t*)b;
+      struct state_manager_cold_block *oldest = &state->cold_blocks[0];
+      if (     oldest->spill_offset >= pos + block->comp_size
+            || pos >= oldest->spill_offset + oldest->comp_size)
+         break;
+      state_manager_cold_drop_oldest(state);
+   }
 
-      while (*a_big == *b_big)
-      {
-         a_big++;
-         b_big++;
-      }
-      a = (const uint16_t*)a_big;
-      b = (const uint16_t*)b_big;
+   block                 = &state->cold_blocks[state->spill_count];
+   memcpy(state->spill_data + pos, block->data, block->comp_size);
+   free(block->data);
+   block->data           = NULL;
+   block->spill_offset   = pos;
+
+   state->cold_entries  -= block->entries;
+   state->cold_size     -= block->comp_size;
+   state->spill_entries += block->entries;
+   state->spill_size    += block->comp_size;
+   state->spill_pos      = pos + block->comp_size;
+   state->spill_count++;
+}
+#endif
 
-      while (*a == *b)
-      {
-         a++;
-         b++;
-      }
+/* Recompresses the staging buffer into a new cold block,
+ * then brings the cold tier back within budget. */
+static void state_manager_cold_flush(state_manager_t *state)
+{
+   uint32_t comp_size = 0;
+   uint8_t *comp      = NULL;
+   struct state_manager_cold_block *block;
+
+   if (!state->stage_entries)
+      return;
+
+   if (state->cold_count == state->cold_blocks_capacity)
+   {
+      unsigned new_cap = state->cold_blocks_capacity
+         ? state->cold_blocks_capacity * 2 : 16;
+      struct state_manager_cold_block *blocks =
+         (struct state_manager_cold_block*)realloc(state->cold_blocks,
+               new_cap * sizeof(*blocks));
+      if (!blocks)
+         return;
+      state->cold_blocks          = blocks;
+      state->cold_blocks_capacity = new_cap;
    }
-   return a - a_org;
+
+   if (!(comp = state_manager_cold_compress(state, state->stage,
+               (uint32_t)state->stage_size, &comp_size)))
+      return;
+
+   block               = &state->cold_blocks[state->cold_count++];
+   block->data         = comp;
+   block->spill_offset = 0;
+   block->comp_size    = comp_size;
+   block->raw_size     = (uint32_t)state->stage_size;
+   block->entries      = state->stage_entries;
+
+   state->cold_size    += comp_size;
+   state->cold_entries += state->stage_entries;
+   state->stage_size    = 0;
+   state->stage_entries = 0;
+
+   while (state->cold_size > state->cold_capacity
+         && state->cold_count > state->spill_count)
+   {
+#ifdef HAVE_REWIND_SPILL
+      if (state->spill_data)
+         state_manager_spill_oldest(state);
+      else
 #endif
+         state_manager_cold_drop_oldest(state);
+   }
 }
 
-static size_t find_same(const uint16_t *a, const uint16_t *b)
+static bool state_manager_stage_reserve(state_manager_t *state,
+      size_t size, unsigned entries)
 {
-   const uint16_t *a_org = a;
-#ifdef NO_UNALIGNED_MEM
-   if (((uintptr_t)a & (sizeof(uint32_t) - 1)) && *a != *b)
+   if (size > state->stage_capacity)
    {
-      a++;
-      b++;
+      size_t new_cap   = state->stage_capacity
+         ? state->stage_capacity : STATE_MANAGER_COLD_BLOCK_SIZE;
+      uint8_t *stage   = NULL;
+      while (new_cap < size)
+         new_cap      *= 2;
+      if (!(stage = (uint8_t*)realloc(state->stage, new_cap)))
+         return false;
+      state->stage          = stage;
+      state->stage_capacity = new_cap;
    }
-   if (*a != *b)
-#endif
-   {
-      /* With this, it's random whether two consecutive identical
-       * words are caught.
-       *
-       * Luckily, compression rate is the same for both cases, and
-       * three is always caught.
-       *
-       * (We prefer to miss two-word blocks, anyways; fewer iterations
-       * of the outer loop, as well as in the decompressor.) */
-      const uint32_t *a_big = (const uint32_t*)a;
-      const uint32_t *b_big = (const uint32_t*)b;
-
-      while (*a_big != *b_big)
-      {
-         a_big++;
-         b_big++;
-      }
-      a = (const uint16_t*)a_big;
-      b = (const uint16_t*)b_big;
 
-      if (a != a_org && a[-1] == b[-1])
-      {
-         a--;
-         b--;
-      }
+   if (entries > state->stage_offsets_capacity)
+   {
+      unsigned new_cap = state->stage_offsets_capacity
+         ? state->stage_offsets_capacity : 64;
+      size_t *offsets  = NULL;
+      while (new_cap < entries)
+         new_cap      *= 2;
+      if (!(offsets = (size_t*)realloc(state->stage_offsets,
+                  new_cap * sizeof(*offsets))))
+         return false;
+      state->stage_offsets          = offsets;
+      state->stage_offsets_capacity = new_cap;
    }
-   return a - a_org;
-}
 
-/* Returns the maximum compressed size of a savestate.
- * It is very likely to compress to far less. */
-static size_t state_manager_raw_maxsize(size_t uncomp)
-{
-   /* bytes covered by a compressed block */
-   const int maxcblkcover = UINT16_MAX * sizeof(uint16_t);
-   /* uncompressed size, rounded to 16 bits */
-   size_t uncomp16        = (uncomp + sizeof(uint16_t) - 1) & -sizeof(uint16_t);
-   /* number of blocks */
-   size_t maxcblks        = (uncomp + maxcblkcover - 1) / maxcblkcover;
-   return uncomp16 + maxcblks * sizeof(uint16_t) * 2 /* two u16 overhead per block */ + sizeof(uint16_t) *
-      3; /* three u16 to end it */
+   return true;
 }
 
-/*
- * See state_manager_raw_compress for information about this.
- * When you're done with it, send it to free().
- */
-static void *state_manager_raw_alloc(size_t len, uint16_t uniq)
+/* Drops the oldest delta from the ring, handing it
+ * to the cold tier if there is one. */
+static void state_manager_evict_tail(state_manager_t *state)
 {
-   size_t  len16 = (len + sizeof(uint16_t) - 1) & -sizeof(uint16_t);
-   uint16_t *ret = (uint16_t*)calloc(len16 + sizeof(uint16_t) * 4 + 16, 1);
+   if (state->cold_capacity)
+   {
+      const uint8_t *patch = state->tail + sizeof(size_t);
+      size_t len           = state_manager_raw_patch_size(patch);
 
-   if (!ret)
-      return NULL;
+      if (state_manager_stage_reserve(state,
+               state->stage_size + len, state->stage_entries + 1))
+      {
+         memcpy(state->stage + state->stage_size, patch, len);
+         state->stage_offsets[state->stage_entries++] = state->stage_size;
+         state->stage_size += len;
 
-   /* Force in a different byte at the end, so we don't need to check
-    * bounds in the innermost loop (it's expensive).
-    *
-    * There is also a large amount of data that's the same, to stop
-    * the other scan.
-    *
-    * There is also some padding at the end. This is so we don't
-    * read outside the buffer end if we're reading in large blocks;
-    *
-    * It doesn't make any difference to us, but sacrificing 16 bytes to get
-    * Valgrind happy is worth it. */
-   ret[len16/sizeof(uint16_t) + 3] = uniq;
+         if (state->stage_size >= STATE_MANAGER_COLD_BLOCK_SIZE)
+            state_manager_cold_flush(state);
+      }
+      else
+      {
+         /* Lost the delta; nothing older can be reached. */
+         while (state->cold_count)
+            state_manager_cold_drop_oldest(state);
+         state->stage_size    = 0;
+         state->stage_entries = 0;
+      }
+   }
 
-   return ret;
+   state->tail = state->data + read_size_t(state->tail);
+   state->entries--;
 }
 
-/*
- * Takes two savestates and creates a patch that turns 'src' into 'dst'.
- * Both 'src' and 'dst' must be returned from state_manager_raw_alloc(),
- * with the same 'len', and different 'uniq'.
- *
- * 'patch' must be size 'state_manager_raw_maxsize(len)' or more.
- * Returns the number of bytes actually written to 'patch'.
- */
-static size_t state_manager_raw_compress(const void *src,
-      const void *dst, size_t len, void *patch)
+/* Returns the newest delta from the cold tiers, or NULL
+ * once rewinding has reached the oldest retained state. */
+static const uint8_t *state_manager_stage_pop(state_manager_t *state)
 {
-   const uint16_t  *old16 = (const uint16_t*)src;
-   const uint16_t  *new16 = (const uint16_t*)dst;
-   uint16_t *compressed16 = (uint16_t*)patch;
-   size_t          num16s = (len + sizeof(uint16_t) - 1)
-      / sizeof(uint16_t);
-
-   while (num16s)
+   if (!state->stage_entries)
    {
-      size_t i, changed;
-      size_t skip = find_change(old16, new16);
+      size_t offset                          = 0;
+      const uint8_t *src                     = NULL;
+      struct state_manager_cold_block *block = NULL;
 
-      if (skip >= num16s)
-         break;
+      if (!state->cold_count)
+         return NULL;
 
-      old16  += skip;
-      new16  += skip;
-      num16s -= skip;
+      block = &state->cold_blocks[state->cold_count - 1];
+      src   = block->data ? block->data
+         : state->spill_data + block->spill_offset;
 
-      if (skip > UINT16_MAX)
+      if (     !state_manager_stage_reserve(state,
+                  block->raw_size, block->entries)
+            || !state_manager_cold_decompress(state, src,
+                  block->comp_size, state->stage, block->raw_size))
       {
-         /* This will make it scan the entire thing again,
-          * but it only hits on 8GB unchanged data anyways,
-          * and if you're doing that, you've got bigger problems. */
-         if (skip > UINT32_MAX)
-            skip         = UINT32_MAX;
-
-         *compressed16++ = 0;
-         *compressed16++ = skip;
-         *compressed16++ = skip >> 16;
-         continue;
+         /* Lost the block; the chain can't continue past it. */
+         while (state->cold_count)
+            state_manager_cold_drop_oldest(state);
+         return NULL;
       }
 
-      changed         = find_same(old16, new16);
-      if (changed > UINT16_MAX)
-         changed = UINT16_MAX;
-
-      *compressed16++ = changed;
-      *compressed16++ = skip;
-
-      for (i = 0; i < changed; i++)
-         compressed16[i] = old16[i];
+      while (offset < block->raw_size)
+      {
+         state->stage_offsets[state->stage_entries++] = offset;
+         offset += state_manager_raw_patch_size(state->stage + offset);
+      }
+      state->stage_size = block->raw_size;
 
-      old16        += changed;
-      new16        += changed;
-      num16s       -= changed;
-      compressed16 += changed;
+      if (block->data)
+      {
+         free(block->data);
+         state->cold_entries  -= block->entries;
+         state->cold_size     -= block->comp_size;
+      }
+      else
+      {
+         /* Newest spilled block; reuse its space. */
+         state->spill_pos      = block->spill_offset;
+         state->spill_entries -= block->entries;
+         state->spill_size    -= block->comp_size;
+         state->spill_count--;
+      }
+      state->cold_count--;
    }
 
-   compressed16[0]  = 0;
-   compressed16[1]  = 0;
-   compressed16[2]  = 0;
-
-   return (uint8_t*)(compressed16 + 3) - (uint8_t*)patch;
+   state->stage_size = state->stage_offsets[--state->stage_entries];
+   return state->stage + state->stage_size;
 }
 
-/*
- * Takes 'patch' from a previous call to 'state_manager_raw_compress'
- * and applies it to 'data' ('src' from that call),
- * yielding 'dst' in that call.
- *
- * If the given arguments do not match a previous call to
- * state_manager_raw_compress(), anything at all can happen.
- */
-static void state_manager_raw_decompress(const void *patch,
-      size_t patchlen, void *data, size_t datalen)
+static void state_manager_cold_init(state_manager_t *state,
+      size_t cold_size, size_t spill_size, const char *spill_dir)
 {
-   uint16_t         *out16 = (uint16_t*)data;
-   const uint16_t *patch16 = (const uint16_t*)patch;
+   const struct trans_stream_backend *deflate =
+      trans_stream_get_zlib_deflate_backend();
+   const struct trans_stream_backend *inflate =
+      trans_stream_get_zlib_inflate_backend();
 
-   for (;;)
-   {
-      uint16_t numchanged  = *(patch16++);
+   state->spill_fd      = -1;
+   state->cold_capacity = cold_size;
 
-      if (numchanged)
-      {
-         uint16_t i;
+   if (!cold_size)
+      return;
 
-         out16       += *patch16++;
+   if (deflate)
+      state->deflate_stream = deflate->stream_new();
+   if (inflate)
+      state->inflate_stream = inflate->stream_new();
 
-         /* We could do memcpy, but it seems that memcpy has a
-          * constant-per-call overhead that actually shows up.
-          *
-          * Our average size in here seems to be 8 or something.
-          * Therefore, we do something with lower overhead. */
-         for (i = 0; i < numchanged; i++)
-            out16[i]  = patch16[i];
+   if (!spill_size)
+      return;
 
-         patch16     += numchanged;
-         out16       += numchanged;
-      }
-      else
-      {
-         uint32_t numunchanged = patch16[0] | (patch16[1] << 16);
+#ifdef HAVE_REWIND_SPILL
+   if (!string_is_empty(spill_dir))
+   {
+      char path[PATH_MAX_LENGTH];
+      int fd = -1;
 
-         if (!numunchanged)
-            break;
-         patch16 += 2;
-         out16   += numunchanged;
+      fill_pathname_join(path, spill_dir, "rewind.spill", sizeof(path));
+
+      if ((fd = open(path, O_RDWR | O_CREAT | O_TRUNC, 0600)) >= 0)
+      {
+         if (ftruncate(fd, (off_t)spill_size) == 0)
+         {
+            void *map = mmap(NULL, spill_size,
+                  PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+
+            if (map != MAP_FAILED)
+            {
+               state->spill_data     = (uint8_t*)map;
+               state->spill_capacity = spill_size;
+               state->spill_fd       = fd;
+            }
+         }
+
+         /* Nobody else needs to see it; the mapping keeps it
+          * alive and it's gone as soon as we are. */
+         unlink(path);
+
+         if (!state->spill_data)
+            close(fd);
       }
    }
-}
 
-/* The start offsets point to 'nextstart' of any given compressed frame.
- * Each uint16 is stored native endian; anything that claims any other
- * endianness refers to the endianness of this specific item.
- * The uint32 is stored little endian.
- *
- * Each size value is stored native endian if alignment is not enforced;
- * if it is, they're little endian.
- *
- * The start of the buffer contains a size pointing to the end of the
- * buffer; the end points to its start.
- *
- * Wrapping is handled by returning to the start of the buffer if the
- * compressed data could potentially hit the edge;
- *
- * if the compressed data could potentially overwrite the tail pointer,
- * the tail retreats until it can no longer collide.
- *
- * This means that on average, ~2 * maxcompsize is
- * unused at any given moment. */
+   if (!state->spill_data)
+      RARCH_WARN("[Rewind]: Could not create spill file in \"%s\".\n",
+            spill_dir ? spill_dir : "");
+#else
+   RARCH_WARN("[Rewind]: Disk spill is not supported on this platform.\n");
+#endif
+}
 
-/* These are called very few constant times per frame,
- * keep it as simple as possible. */
-static INLINE void write_size_t(void *ptr, size_t val)
+static void state_manager_cold_deinit(state_manager_t *state)
 {
-   memcpy(ptr, &val, sizeof(val));
+   const struct trans_stream_backend *deflate =
+      trans_stream_get_zlib_deflate_backend();
+   const struct trans_stream_backend *inflate =
+      trans_stream_get_zlib_inflate_backend();
+
+   while (state->cold_count)
+      state_manager_cold_drop_oldest(state);
+
+#ifdef HAVE_REWIND_SPILL
+   if (state->spill_data)
+      munmap(state->spill_data, state->spill_capacity);
+   if (state->spill_fd >= 0)
+      close(state->spill_fd);
+#endif
+
+   if (deflate && state->deflate_stream)
+      deflate->stream_free(state->deflate_stream);
+   if (inflate && state->inflate_stream)
+      inflate->stream_free(state->inflate_stream);
+   if (state->cold_blocks)
+      free(state->cold_blocks);
+   if (state->stage)
+      free(state->stage);
+   if (state->stage_offsets)
+      free(state->stage_offsets);
+
+   state->deflate_stream = NULL;
+   state->inflate_stream = NULL;
+   state->cold_blocks    = NULL;
+   state->stage          = NULL;
+   state->stage_offsets  = NULL;
+   state->spill_data     = NULL;
+   state->spill_fd       = -1;
 }
 
-static INLINE size_t read_size_t(const void *ptr)
+static uint8_t *state_manager_block_alloc(state_manager_t *state,
+      size_t state_size, uint16_t uniq)
 {
-   size_t ret;
+   void *data;
+   uint8_t *block;
 
-   memcpy(&ret, ptr, sizeof(ret));
-   return ret;
+   if (!state->pooled)
+      return (uint8_t*)state_manager_raw_alloc(state_size, uniq);
+
+   if (!(data = content_state_pool_get()))
+      return NULL;
+
+   block = (uint8_t*)content_state_pool_to_rastate(data);
+   state_manager_raw_set_uniq(block, state_size, uniq);
+   return block;
+}
+
+static void state_manager_block_free(state_manager_t *state,
+      uint8_t *block)
+{
+   if (!block)
+      return;
+   if (state->pooled)
+      content_state_pool_put(content_state_pool_from_rastate(block));
+   else
+      free(block);
 }
 
 static void state_manager_free(state_manager_t *state)
@@ -380,24 +562,32 @@ static void state_manager_free(state_manager_t *state)
    if (!state)
       return;
 
+   if (state->delta)
+   {
+      /* Don't free buffers a worker may still be reading. */
+      state_manager_delta_end(state->delta);
+      state_manager_delta_free(state->delta);
+   }
+   state_manager_cold_deinit(state);
    if (state->data)
       free(state->data);
-   if (state->thisblock)
-      free(state->thisblock);
-   if (state->nextblock)
-      free(state->nextblock);
+   state_manager_block_free(state, state->thisblock);
+   state_manager_block_free(state, state->nextblock);
 #if STRICT_BUF_SIZE
    if (state->debugblock)
       free(state->debugblock);
    state->debugblock = NULL;
 #endif
+   state->delta      = NULL;
    state->data       = NULL;
    state->thisblock  = NULL;
    state->nextblock  = NULL;
 }
 
 static state_manager_t *state_manager_new(
-      size_t state_size, size_t buffer_size)
+      size_t state_size, size_t buffer_size, unsigned threads,
+      size_t cold_size, size_t spill_size, const char *spill_dir,
+      bool pooled)
 {
    size_t max_comp_size, block_size;
    uint8_t *next_block    = NULL;
@@ -408,6 +598,8 @@ static state_manager_t *state_manager_new(
    if (!state)
       return NULL;
 
+   state->spill_fd    = -1;
+   state->pooled      = pooled;
    block_size         = (state_size + sizeof(uint16_t) - 1) & -sizeof(uint16_t);
    /* the compressed data is surrounded by pointers to the other side */
    max_comp_size      = state_manager_raw_maxsize(state_size) + sizeof(size_t) * 2;
@@ -416,22 +608,28 @@ static state_manager_t *state_manager_new(
    if (!state_data)
       goto error;
 
-   this_block         = (uint8_t*)state_manager_raw_alloc(state_size, 0);
-   next_block         = (uint8_t*)state_manager_raw_alloc(state_size, 1);
+   this_block         = state_manager_block_alloc(state, state_size, 0);
+   next_block         = state_manager_block_alloc(state, state_size, 1);
 
    if (!this_block || !next_block)
       goto error;
 
+   if (!(state->delta = state_manager_delta_new(state_size, threads)))
+      goto error;
+
    state->blocksize   = block_size;
    state->maxcompsize = max_comp_size;
    state->data        = state_data;
    state->thisblock   = this_block;
    state->nextblock   = next_block;
+   state->nextuniq    = 1;
    state->capacity    = buffer_size;
 
    state->head        = state->data + sizeof(size_t);
    state->tail        = state->data + sizeof(size_t);
 
+   state_manager_cold_init(state, cold_size, spill_size, spill_dir);
+
 #if STRICT_BUF_SIZE
    state->debugsize   = state_size;
    state->debugblock  = (uint8_t*)malloc(state_size);
@@ -442,12 +640,39 @@ static state_manager_t *state_manager_new(
 error:
    if (state_data)
       free(state_data);
+   state_manager_block_free(state, this_block);
+   state_manager_block_free(state, next_block);
    state_manager_free(state);
    free(state);
 
    return NULL;
 }
 
+/* Waits for the patch of the previous push and links it
+ * into the ring. Must be called before the ring or either
+ * savestate block is touched again. */
+static void state_manager_push_finish(state_manager_t *state)
+{
+   uint8_t *compressed;
+
+   if (!state_manager_delta_pending(state->delta))
+      return;
+
+   compressed  = state->head + sizeof(size_t);
+   compressed += state_manager_delta_end(state->delta);
+
+   if (compressed - state->data + state->maxcompsize > state->capacity)
+   {
+      compressed     = state->data;
+      if (state->tail == state->data + sizeof(size_t))
+         state_manager_evict_tail(state);
+   }
+   write_size_t(compressed, state->head-state->data);
+   compressed       += sizeof(size_t);
+   write_size_t(state->head, compressed-state->data);
+   state->head       = compressed;
+}
+
 static bool state_manager_pop(state_manager_t *state, const void **data)
 {
    size_t start;
@@ -456,6 +681,8 @@ static bool state_manager_pop(state_manager_t *state, const void **data)
 
    *data                        = NULL;
 
+   state_manager_push_finish(state);
+
    if (state->thisblock_valid)
    {
       state->thisblock_valid    = false;
@@ -465,13 +692,22 @@ static bool state_manager_pop(state_manager_t *state, const void **data)
    }
 
    *data                        = state->thisblock;
+   out                          = state->thisblock;
+
    if (state->head == state->tail)
-      return false;
+   {
+      /* Ring exhausted, continue with the cold tiers. */
+      if (!(compressed = state_manager_stage_pop(state)))
+         return false;
+
+      state_manager_raw_decompress(compressed,
+            state->maxcompsize, out, state->blocksize);
+      return true;
+   }
 
    start                        = read_size_t(state->head - sizeof(size_t));
    state->head                  = state->data + start;
    compressed                   = state->data + start + sizeof(size_t);
-   out                          = state->thisblock;
 
    state_manager_raw_decompress(compressed,
          state->maxcompsize, out, state->blocksize);
@@ -486,6 +722,8 @@ static void state_manager_push_where(state_manager_t *state, void **data)
     * pushed state, or we could end up applying a 'patch' to wrong
     * savestate, and that'd blow up rather quickly. */
 
+   state_manager_push_finish(state);
+
    if (!state->thisblock_valid)
    {
       const void *ignored;
@@ -502,6 +740,15 @@ static void state_manager_push_where(state_manager_t *state, void **data)
 #endif
 }
 
+/* Swaps the buffer handed out by state_manager_push_where()
+ * for another pooled RASTATE image of the same size. */
+static void state_manager_push_replace(state_manager_t *state,
+      void *data)
+{
+   state->nextblock = (uint8_t*)data;
+   state_manager_raw_set_uniq(data, state->blocksize, state->nextuniq);
+}
+
 static void state_manager_push_do(state_manager_t *state)
 {
    uint8_t *swap = NULL;
@@ -512,8 +759,6 @@ static void state_manager_push_do(state_manager_t *state)
 
    if (state->thisblock_valid)
    {
-      const uint8_t *oldb, *newb;
-      uint8_t *compressed;
       size_t headpos, tailpos, remaining;
       if (state->capacity < sizeof(size_t) + state->maxcompsize)
          return;
@@ -526,28 +771,16 @@ recheckcapacity:;
 
       if (remaining <= state->maxcompsize)
       {
-         state->tail = state->data + read_size_t(state->tail);
-         state->entries--;
+         state_manager_evict_tail(state);
          goto recheckcapacity;
       }
 
-      oldb              = state->thisblock;
-      newb              = state->nextblock;
-      compressed        = state->head + sizeof(size_t);
-
-      compressed       += state_manager_raw_compress(oldb, newb,
-            state->blocksize, compressed);
-
-      if (compressed - state->data + state->maxcompsize > state->capacity)
-      {
-         compressed     = state->data;
-         if (state->tail == state->data + sizeof(size_t))
-            state->tail = state->data + read_size_t(state->tail);
-      }
-      write_size_t(compressed, state->head-state->data);
-      compressed       += sizeof(size_t);
-      write_size_t(state->head, compressed-state->data);
-      state->head       = compressed;
+      /* With worker threads this returns right away; the
+       * patch is linked in by state_manager_push_finish()
+       * before the next capture or pop. */
+      state_manager_delta_begin(state->delta,
+            state->thisblock, state->nextblock,
+            state->head + sizeof(size_t));
    }
    else
       state->thisblock_valid = true;
@@ -555,32 +788,48 @@ recheckcapacity:;
    swap                      = state->thisblock;
    state->thisblock          = state->nextblock;
    state->nextblock          = swap;
+   state->nextuniq          ^= 1;
 
    state->entries++;
 }
 
-#if 0
-static void state_manager_capacity(state_manager_t *state,
-      unsigned *entries, size_t *bytes, bool *full)
+bool state_manager_get_stats(
+      const struct state_manager_rewind_state *rewind_st,
+      state_manager_stats_t *stats)
 {
-   size_t headpos   = state->head - state->data;
-   size_t tailpos   = state->tail - state->data;
-   size_t remaining = (tailpos + state->capacity -
+   size_t headpos, tailpos, remaining;
+   const state_manager_t *state = rewind_st ? rewind_st->state : NULL;
+
+   if (!state)
+      return false;
+
+   headpos               = state->head - state->data;
+   tailpos               = state->tail - state->data;
+   remaining             = (tailpos + state->capacity -
          sizeof(size_t) - headpos - 1) % state->capacity + 1;
 
-   if (entries)
-      *entries      = state->entries;
-   if (bytes)
-      *bytes        = state->capacity-remaining;
-   if (full)
-      *full         = remaining <= state->maxcompsize * 2;
+   /* Anything waiting in the staging buffer is
+    * uncompressed memory, count it with the ring. */
+   stats->ram_entries    = state->entries + state->stage_entries;
+   stats->ram_size       = state->capacity - remaining + state->stage_size;
+   stats->ram_capacity   = state->capacity;
+   stats->cold_entries   = state->cold_entries;
+   stats->cold_size      = state->cold_size;
+   stats->cold_capacity  = state->cold_capacity;
+   stats->spill_entries  = state->spill_entries;
+   stats->spill_size     = state->spill_size;
+   stats->spill_capacity = state->spill_capacity;
+   return true;
 }
-#endif
 
 void state_manager_event_init(
       struct state_manager_rewind_state *rewind_st,
-      unsigned rewind_buffer_size)
+      unsigned rewind_buffer_size, unsigned rewind_threads,
+      size_t rewind_cold_size, size_t rewind_spill_size,
+      const char *spill_dir)
 {
+   retro_ctx_size_info_t info;
+   bool pooled            = false;
    core_info_t *core_info = NULL;
    void *state            = NULL;
 
@@ -624,15 +873,33 @@ void state_manager_event_init(
       return;
    }
 
+   /* Take buffers from the savestate pool whenever the state
+    * fits, so run-ahead can hand its states over */
+   core_serialize_size(&info);
+   pooled = content_state_pool_init(info.size)
+      && content_state_pool_get_rastate_size() == rewind_st->size;
+
    RARCH_LOG("%s: %u MB\n",
          msg_hash_to_str(MSG_REWIND_INIT),
          (unsigned)(rewind_buffer_size / 1000000));
 
+   if (rewind_threads)
+      RARCH_LOG("[Rewind]: Compressing deltas on %u worker thread(s).\n",
+            rewind_threads);
+   if (rewind_cold_size)
+      RARCH_LOG("[Rewind]: Compressed tier: %u MB, disk spill: %u MB.\n",
+            (unsigned)(rewind_cold_size / 1000000),
+            (unsigned)(rewind_spill_size / 1000000));
+
    rewind_st->state = state_manager_new(rewind_st->size,
-         rewind_buffer_size);
+         rewind_buffer_size, rewind_threads,
+         rewind_cold_size, rewind_spill_size, spill_dir, pooled);
 
    if (!rewind_st->state)
+   {
       RARCH_WARN("%s.\n", msg_hash_to_str(MSG_REWIND_INIT_FAILED));
+      return;
+   }
 
    state_manager_push_where(rewind_st->state, &state);
 
@@ -792,7 +1059,13 @@ bool state_manager_check_rewind(
 
          state_manager_push_where(rewind_st->state, &state);
 
-         content_serialize_state(state, rewind_st->size);
+#if defined(HAVE_RUNAHEAD) && !STRICT_BUF_SIZE
+         if (     rewind_st->state->pooled
+               && runloop_runahead_exchange_state(&state, rewind_st->size))
+            state_manager_push_replace(rewind_st->state, state);
+         else
+#endif
+            content_serialize_state(state, rewind_st->size);
 
          state_manager_push_do(rewind_st->state);
       }
@@ -25,9 +25,23 @@
 #include <retro_common_api.h>
 
 #include "dynamic.h"
+#include "state_manager_delta.h"
 
 RETRO_BEGIN_DECLS
 
+/* A batch of deltas evicted from the ring buffer,
+ * recompressed as a whole. Deltas inside a block are
+ * stored oldest first. */
+struct state_manager_cold_block
+{
+   /* Compressed deltas, or NULL once spilled to disk. */
+   uint8_t *data;
+   size_t spill_offset;
+   uint32_t comp_size;
+   uint32_t raw_size;
+   unsigned entries;
+};
+
 struct state_manager
 {
    uint8_t *data;
@@ -38,6 +52,9 @@ struct state_manager
 
    uint8_t *thisblock;
    uint8_t *nextblock;
+   /* Produces the patch between thisblock and nextblock,
+    * possibly on worker threads. */
+   state_manager_delta_t *delta;
 #if STRICT_BUF_SIZE
    uint8_t *debugblock;
    size_t debugsize;
@@ -51,12 +68,61 @@ struct state_manager
     * (yes, the math is a bit ugly). */
    size_t maxcompsize;
 
+   /* Cold tier. Deltas that fall off the tail of the ring
+    * are appended to 'stage'; once that holds a full block
+    * it is recompressed into 'cold_blocks' (oldest first).
+    * When rewinding past the ring, the newest block is
+    * unpacked back into 'stage' and popped from there. */
+   struct state_manager_cold_block *cold_blocks;
+   uint8_t *stage;
+   size_t *stage_offsets;
+   void *deflate_stream;
+   void *inflate_stream;
+   size_t stage_size;
+   size_t stage_capacity;
+   size_t cold_capacity;
+   size_t cold_size;
+   unsigned stage_entries;
+   unsigned stage_offsets_capacity;
+   unsigned cold_count;
+   unsigned cold_blocks_capacity;
+   unsigned cold_entries;
+
+   /* Disk tier. The first 'spill_count' cold blocks live
+    * in a memory-mapped file used as a ring. */
+   uint8_t *spill_data;
+   size_t spill_capacity;
+   size_t spill_pos;
+   size_t spill_size;
+   int spill_fd;
+   unsigned spill_count;
+   unsigned spill_entries;
+
    unsigned entries;
+   /* End marker nextblock needs, see state_manager_raw_alloc() */
+   uint16_t nextuniq;
    bool thisblock_valid;
+   /* thisblock and nextblock come from the savestate pool */
+   bool pooled;
 };
 
 typedef struct state_manager state_manager_t;
 
+typedef struct state_manager_stats
+{
+   /* Deltas held by each tier. */
+   unsigned ram_entries;
+   unsigned cold_entries;
+   unsigned spill_entries;
+   /* Bytes in use and budget of each tier. */
+   size_t ram_size;
+   size_t ram_capacity;
+   size_t cold_size;
+   size_t cold_capacity;
+   size_t spill_size;
+   size_t spill_capacity;
+} state_manager_stats_t;
+
 struct state_manager_rewind_state
 {
    /* Rewind support. */
@@ -75,7 +141,21 @@ void state_manager_event_deinit(
       struct retro_core_t *current_core);
 
 void state_manager_event_init(struct state_manager_rewind_state *rewind_st,
-      unsigned rewind_buffer_size);
+      unsigned rewind_buffer_size, unsigned rewind_threads,
+      size_t rewind_cold_size, size_t rewind_spill_size,
+      const char *spill_dir);
+
+/**
+ * state_manager_get_stats:
+ *
+ * Reports how many deltas each rewind tier retains and
+ * how much memory/disk they use.
+ *
+ * Returns: false if rewind is not initialised.
+ **/
+bool state_manager_get_stats(
+      const struct state_manager_rewind_state *rewind_st,
+      state_manager_stats_t *stats);
 
 /**
  * check_rewind:
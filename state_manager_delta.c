@@ -0,0 +1,724 @@
+/*  RetroArch - A frontend for libretro.
+ *  Copyright (C) 2010-2014 - Hans-Kristian Arntzen
+ *  Copyright (C) 2011-2017 - Daniel De Matteis
+ *  Copyright (C) 2014-2017 - Alfred Agrell
+ *
+ *  RetroArch is free software: you can redistribute it and/or modify it under the terms
+ *  of the GNU General Public License as published by the Free Software Found-
+ *  ation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  RetroArch is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ *  without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ *  PURPOSE.  See the GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along with RetroArch.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __STDC_LIMIT_MACROS
+#define __STDC_LIMIT_MACROS
+#endif
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <retro_inline.h>
+#include <compat/intrinsics.h>
+
+#ifdef HAVE_THREADS
+#include <rthreads/tpool.h>
+#endif
+
+#include "state_manager_delta.h"
+
+#ifndef UINT16_MAX
+#define UINT16_MAX 0xffff
+#endif
+
+#ifndef UINT32_MAX
+#define UINT32_MAX 0xffffffffu
+#endif
+
+#if defined(__x86_64__) || defined(__i386__) || defined(__i486__) || defined(__i686__) || defined(_M_IX86) || defined(_M_AMD64) || defined(_M_X64)
+#define CPU_X86
+#endif
+
+/* Other arches SIGBUS (usually) on unaligned accesses. */
+#ifndef CPU_X86
+#define NO_UNALIGNED_MEM
+#endif
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif __SSE2__
+#include <emmintrin.h>
+#elif (defined(__ARM_NEON__) || defined(__ARM_NEON)) && !defined(__ARM_BIG_ENDIAN)
+#include <arm_neon.h>
+#define DELTA_NEON
+#endif
+
+/* Padding behind the end marker of every state buffer,
+ * so the vector loops can overread by one full vector. */
+#define DELTA_PADDING 32
+
+/* Format per frame (pseudocode): */
+#if 0
+size nextstart;
+repeat {
+   uint16 numchanged; /* everything is counted in units of uint16 */
+   if (numchanged)
+   {
+      uint16 numunchanged; /* skip these before handling numchanged */
+      uint16[numchanged] changeddata;
+   }
+   else
+   {
+      uint32 numunchanged;
+      if (!numunchanged)
+         break;
+   }
+}
+size thisstart;
+#endif
+
+struct state_manager_delta_stripe
+{
+   const uint16_t *old16;
+   const uint16_t *new16;
+   uint16_t *out16;
+   size_t num16s;
+   /* Number of uint16 written to out16. */
+   size_t written;
+   bool last;
+};
+
+struct state_manager_delta
+{
+#ifdef HAVE_THREADS
+   tpool_t *pool;
+#endif
+   uint8_t *patch;
+   /* Output for every stripe except the first one,
+    * which is written straight into the patch. */
+   uint16_t *scratch;
+   size_t len;
+   size_t written;
+   size_t stripe16s;
+   struct state_manager_delta_stripe stripes[STATE_MANAGER_DELTA_THREADS_MAX];
+   unsigned num_stripes;
+   bool pending;
+};
+
+/* There's no equivalent in libc, you'd think so ...
+ * std::mismatch exists, but it's not optimized at all.
+ *
+ * Returns the offset of the first differing uint16, or
+ * something >= 'limit' if the first 'limit' are identical.
+ * The caller's end marker guarantees termination; 'limit'
+ * only keeps stripes from scanning into their neighbour. */
+static size_t find_change(const uint16_t *a, const uint16_t *b,
+      size_t limit)
+{
+#if defined(__AVX2__)
+   const __m256i *a256 = (const __m256i*)a;
+   const __m256i *b256 = (const __m256i*)b;
+
+   for (;;)
+   {
+      __m256i v0    = _mm256_loadu_si256(a256);
+      __m256i v1    = _mm256_loadu_si256(b256);
+      __m256i c     = _mm256_cmpeq_epi8(v0, v1);
+      uint32_t mask = (uint32_t)_mm256_movemask_epi8(c);
+
+      if (mask != 0xffffffff)
+      {
+         size_t ret = (((uint8_t*)a256 - (uint8_t*)a) |
+               (compat_ctz(~mask)));
+         return (ret >> 1);
+      }
+
+      a256++;
+      b256++;
+
+      if ((size_t)((const uint16_t*)a256 - a) >= limit)
+         return limit;
+   }
+#elif __SSE2__
+   const __m128i *a128 = (const __m128i*)a;
+   const __m128i *b128 = (const __m128i*)b;
+
+   for (;;)
+   {
+      __m128i v0    = _mm_loadu_si128(a128);
+      __m128i v1    = _mm_loadu_si128(b128);
+      __m128i c     = _mm_cmpeq_epi8(v0, v1);
+      uint32_t mask = _mm_movemask_epi8(c);
+
+      if (mask != 0xffff) /* Something has changed, figure out where. */
+      {
+         /* calculate the real offset to the differing byte */
+         size_t ret = (((uint8_t*)a128 - (uint8_t*)a) |
+               (compat_ctz(~mask)));
+
+         /* and convert that to the uint16_t offset */
+         return (ret >> 1);
+      }
+
+      a128++;
+      b128++;
+
+      if ((size_t)((const uint16_t*)a128 - a) >= limit)
+         return limit;
+   }
+#elif defined(DELTA_NEON)
+   const uint8_t *a8 = (const uint8_t*)a;
+   const uint8_t *b8 = (const uint8_t*)b;
+
+   for (;;)
+   {
+      uint64x2_t x = vreinterpretq_u64_u8(
+            veorq_u8(vld1q_u8(a8), vld1q_u8(b8)));
+      uint64_t lo  = vgetq_lane_u64(x, 0);
+      uint64_t hi  = vgetq_lane_u64(x, 1);
+
+      if (lo | hi)
+      {
+         size_t ret = a8 - (const uint8_t*)a;
+
+         if (!lo)
+         {
+            lo   = hi;
+            ret += 8;
+         }
+         if (!(uint32_t)lo)
+         {
+            lo >>= 32;
+            ret += 4;
+         }
+         ret += compat_ctz((uint32_t)lo) >> 3;
+         return (ret >> 1);
+      }
+
+      a8 += 16;
+      b8 += 16;
+
+      if ((size_t)((const uint16_t*)a8 - a) >= limit)
+         return limit;
+   }
+#else
+   const uint16_t *a_org = a;
+#ifdef NO_UNALIGNED_MEM
+   while (((uintptr_t)a & (sizeof(size_t) - 1)) && *a == *b)
+   {
+      a++;
+      b++;
+   }
+   if (*a == *b)
+#endif
+   {
+      const size_t *a_big = (const size_t*)a;
+      const size_t *b_big = (const size_t*)b;
+
+      while (*a_big == *b_big)
+      {
+         a_big++;
+         b_big++;
+
+         if ((size_t)((const uint16_t*)a_big - a_org) >= limit)
+            return limit;
+      }
+      a = (const uint16_t*)a_big;
+      b = (const uint16_t*)b_big;
+
+      while (*a == *b)
+      {
+         a++;
+         b++;
+      }
+   }
+   return a - a_org;
+#endif
+}
+
+/* With this, it's random whether two consecutive identical
+ * words are caught.
+ *
+ * Luckily, compression rate is the same for both cases, and
+ * three is always caught.
+ *
+ * (We prefer to miss two-word blocks, anyways; fewer iterations
+ * of the outer loop, as well as in the decompressor.)
+ *
+ * Like find_change(), may return anything >= 'limit' if no
+ * identical word pair starts before it. */
+static size_t find_same(const uint16_t *a, const uint16_t *b,
+      size_t limit)
+{
+   size_t ret;
+#if defined(__AVX2__)
+   const __m256i *a256 = (const __m256i*)a;
+   const __m256i *b256 = (const __m256i*)b;
+
+   for (;;)
+   {
+      __m256i v0    = _mm256_loadu_si256(a256);
+      __m256i v1    = _mm256_loadu_si256(b256);
+      __m256i c     = _mm256_cmpeq_epi32(v0, v1);
+      unsigned mask = (unsigned)_mm256_movemask_ps(_mm256_castsi256_ps(c));
+
+      if (mask)
+      {
+         ret = ((const uint16_t*)a256 - a) + compat_ctz(mask) * 2;
+         break;
+      }
+
+      a256++;
+      b256++;
+
+      if ((size_t)((const uint16_t*)a256 - a) >= limit)
+         return limit;
+   }
+#elif __SSE2__
+   const __m128i *a128 = (const __m128i*)a;
+   const __m128i *b128 = (const __m128i*)b;
+
+   for (;;)
+   {
+      __m128i v0    = _mm_loadu_si128(a128);
+      __m128i v1    = _mm_loadu_si128(b128);
+      __m128i c     = _mm_cmpeq_epi32(v0, v1);
+      unsigned mask = (unsigned)_mm_movemask_ps(_mm_castsi128_ps(c));
+
+      if (mask)
+      {
+         ret = ((const uint16_t*)a128 - a) + compat_ctz(mask) * 2;
+         break;
+      }
+
+      a128++;
+      b128++;
+
+      if ((size_t)((const uint16_t*)a128 - a) >= limit)
+         return limit;
+   }
+#elif defined(DELTA_NEON)
+   const uint8_t *a8 = (const uint8_t*)a;
+   const uint8_t *b8 = (const uint8_t*)b;
+
+   for (;;)
+   {
+      uint32x4_t c = vceqq_u32(
+            vreinterpretq_u32_u8(vld1q_u8(a8)),
+            vreinterpretq_u32_u8(vld1q_u8(b8)));
+      uint64x2_t c64 = vreinterpretq_u64_u32(c);
+
+      if (vgetq_lane_u64(c64, 0) | vgetq_lane_u64(c64, 1))
+      {
+         unsigned lane = 0;
+
+         while (!vgetq_lane_u32(c, 0))
+         {
+            c = vextq_u32(c, c, 1);
+            lane++;
+         }
+         ret = ((const uint16_t*)a8 - a) + lane * 2;
+         break;
+      }
+
+      a8 += 16;
+      b8 += 16;
+
+      if ((size_t)((const uint16_t*)a8 - a) >= limit)
+         return limit;
+   }
+#else
+   const uint16_t *a16 = a;
+   const uint16_t *b16 = b;
+#ifdef NO_UNALIGNED_MEM
+   if (((uintptr_t)a16 & (sizeof(uint32_t) - 1)) && *a16 != *b16)
+   {
+      a16++;
+      b16++;
+   }
+   if (*a16 != *b16)
+#endif
+   {
+      const uint32_t *a_big = (const uint32_t*)a16;
+      const uint32_t *b_big = (const uint32_t*)b16;
+
+      while (*a_big != *b_big)
+      {
+         a_big++;
+         b_big++;
+
+         if ((size_t)((const uint16_t*)a_big - a) >= limit)
+            return limit;
+      }
+      a16 = (const uint16_t*)a_big;
+   }
+   ret = a16 - a;
+#endif
+
+   if (ret && a[ret - 1] == b[ret - 1])
+      ret--;
+   return ret;
+}
+
+size_t state_manager_raw_maxsize(size_t uncomp)
+{
+   /* bytes covered by a compressed block */
+   const int maxcblkcover = UINT16_MAX * sizeof(uint16_t);
+   /* uncompressed size, rounded to 16 bits */
+   size_t uncomp16        = (uncomp + sizeof(uint16_t) - 1) & -sizeof(uint16_t);
+   /* number of blocks */
+   size_t maxcblks        = (uncomp + maxcblkcover - 1) / maxcblkcover;
+   return uncomp16 + maxcblks * sizeof(uint16_t) * 2 /* two u16 overhead per block */ + sizeof(uint16_t) *
+      3; /* three u16 to end it */
+}
+
+void *state_manager_raw_alloc(size_t len, uint16_t uniq)
+{
+   size_t  len16 = (len + sizeof(uint16_t) - 1) & -sizeof(uint16_t);
+   uint16_t *ret = (uint16_t*)calloc(len16 + sizeof(uint16_t) * 4 + DELTA_PADDING, 1);
+
+   if (!ret)
+      return NULL;
+
+   /* Force in a different byte at the end, so we don't need to check
+    * bounds in the innermost loop (it's expensive).
+    *
+    * There is also a large amount of data that's the same, to stop
+    * the other scan.
+    *
+    * There is also some padding at the end. This is so we don't
+    * read outside the buffer end if we're reading in large blocks;
+    *
+    * It doesn't make any difference to us, but sacrificing a vector's
+    * worth of bytes to get Valgrind happy is worth it. */
+   ret[len16/sizeof(uint16_t) + 3] = uniq;
+
+   return ret;
+}
+
+void state_manager_raw_set_uniq(void *data, size_t len, uint16_t uniq)
+{
+   size_t  len16 = (len + sizeof(uint16_t) - 1) & -sizeof(uint16_t);
+   uint16_t *tail = (uint16_t*)((uint8_t*)data + len16);
+
+   if (len16 != len)
+      ((uint8_t*)data)[len] = 0;
+   tail[0] = 0;
+   tail[1] = 0;
+   tail[2] = 0;
+   tail[3] = uniq;
+}
+
+/* Compresses 'num16s' uint16 into 'compressed16' without the
+ * end marker. Unless this is the 'last' range, trailing unchanged
+ * data is emitted as an explicit skip so that the output of
+ * consecutive ranges can simply be concatenated.
+ *
+ * Returns the number of uint16 written. */
+static size_t state_manager_raw_compress_range(
+      const uint16_t *old16, const uint16_t *new16,
+      size_t num16s, uint16_t *compressed16, bool last)
+{
+   uint16_t *compressed16_org = compressed16;
+
+   while (num16s)
+   {
+      size_t i, changed;
+      size_t skip = find_change(old16, new16, num16s);
+
+      if (skip >= num16s)
+      {
+         if (!last)
+         {
+            *compressed16++ = 0;
+            *compressed16++ = num16s;
+            *compressed16++ = num16s >> 16;
+         }
+         break;
+      }
+
+      old16  += skip;
+      new16  += skip;
+      num16s -= skip;
+
+      if (skip > UINT16_MAX)
+      {
+         /* This will make it scan the entire thing again,
+          * but it only hits on 8GB unchanged data anyways,
+          * and if you're doing that, you've got bigger problems. */
+         if (skip > UINT32_MAX)
+            skip         = UINT32_MAX;
+
+         *compressed16++ = 0;
+         *compressed16++ = skip;
+         *compressed16++ = skip >> 16;
+         continue;
+      }
+
+      changed         = find_same(old16, new16, num16s);
+      if (changed > num16s)
+         changed = num16s;
+      if (changed > UINT16_MAX)
+         changed = UINT16_MAX;
+
+      *compressed16++ = changed;
+      *compressed16++ = skip;
+
+      for (i = 0; i < changed; i++)
+         compressed16[i] = old16[i];
+
+      old16        += changed;
+      new16        += changed;
+      num16s       -= changed;
+      compressed16 += changed;
+   }
+
+   return compressed16 - compressed16_org;
+}
+
+size_t state_manager_raw_compress(const void *src,
+      const void *dst, size_t len, void *patch)
+{
+   uint16_t *compressed16 = (uint16_t*)patch;
+   size_t          num16s = (len + sizeof(uint16_t) - 1)
+      / sizeof(uint16_t);
+
+   compressed16    += state_manager_raw_compress_range(
+         (const uint16_t*)src, (const uint16_t*)dst,
+         num16s, compressed16, true);
+
+   compressed16[0]  = 0;
+   compressed16[1]  = 0;
+   compressed16[2]  = 0;
+
+   return (uint8_t*)(compressed16 + 3) - (uint8_t*)patch;
+}
+
+void state_manager_raw_decompress(const void *patch,
+      size_t patchlen, void *data, size_t datalen)
+{
+   uint16_t         *out16 = (uint16_t*)data;
+   const uint16_t *patch16 = (const uint16_t*)patch;
+
+   for (;;)
+   {
+      uint16_t numchanged  = *(patch16++);
+
+      if (numchanged)
+      {
+         uint16_t i;
+
+         out16       += *patch16++;
+
+         /* We could do memcpy, but it seems that memcpy has a
+          * constant-per-call overhead that actually shows up.
+          *
+          * Our average size in here seems to be 8 or something.
+          * Therefore, we do something with lower overhead. */
+         for (i = 0; i < numchanged; i++)
+            out16[i]  = patch16[i];
+
+         patch16     += numchanged;
+         out16       += numchanged;
+      }
+      else
+      {
+         uint32_t numunchanged = patch16[0] | (patch16[1] << 16);
+
+         if (!numunchanged)
+            break;
+         patch16 += 2;
+         out16   += numunchanged;
+      }
+   }
+}
+
+size_t state_manager_raw_patch_size(const void *patch)
+{
+   const uint16_t *patch16 = (const uint16_t*)patch;
+
+   for (;;)
+   {
+      uint16_t numchanged  = *(patch16++);
+
+      if (numchanged)
+         patch16 += 1 + numchanged;
+      else
+      {
+         uint32_t numunchanged = patch16[0] | (patch16[1] << 16);
+
+         patch16 += 2;
+         if (!numunchanged)
+            break;
+      }
+   }
+
+   return (const uint8_t*)patch16 - (const uint8_t*)patch;
+}
+
+#ifdef HAVE_THREADS
+static void state_manager_delta_stripe_cb(void *data)
+{
+   struct state_manager_delta_stripe *stripe =
+      (struct state_manager_delta_stripe*)data;
+
+   stripe->written = state_manager_raw_compress_range(
+         stripe->old16, stripe->new16, stripe->num16s,
+         stripe->out16, stripe->last);
+}
+#endif
+
+state_manager_delta_t *state_manager_delta_new(size_t len,
+      unsigned threads)
+{
+   size_t num16s;
+   unsigned num_stripes         = 1;
+   state_manager_delta_t *delta = (state_manager_delta_t*)
+      calloc(1, sizeof(*delta));
+
+   if (!delta)
+      return NULL;
+
+   delta->len   = len;
+   num16s       = (len + sizeof(uint16_t) - 1) / sizeof(uint16_t);
+
+#ifdef HAVE_THREADS
+   if (threads > STATE_MANAGER_DELTA_THREADS_MAX)
+      threads   = STATE_MANAGER_DELTA_THREADS_MAX;
+
+   if (threads)
+   {
+      num_stripes = threads;
+      while (num_stripes > 1 &&
+            len / num_stripes < STATE_MANAGER_DELTA_STRIPE_MIN)
+         num_stripes--;
+
+      if (!(delta->pool = tpool_create(num_stripes)))
+         goto error;
+   }
+#endif
+
+   /* Keep stripe boundaries vector aligned relative
+    * to the start of the state. */
+   delta->num_stripes = num_stripes;
+   delta->stripe16s   = ((num16s + num_stripes - 1) / num_stripes + 15) & ~(size_t)15;
+
+   if (num_stripes > 1)
+   {
+      size_t stripe_max = state_manager_raw_maxsize(
+            delta->stripe16s * sizeof(uint16_t));
+      if (!(delta->scratch = (uint16_t*)malloc(
+                  stripe_max * (num_stripes - 1))))
+         goto error;
+   }
+
+   return delta;
+
+error:
+   state_manager_delta_free(delta);
+   return NULL;
+}
+
+void state_manager_delta_free(state_manager_delta_t *delta)
+{
+   if (!delta)
+      return;
+
+#ifdef HAVE_THREADS
+   if (delta->pool)
+      tpool_destroy(delta->pool);
+#endif
+   if (delta->scratch)
+      free(delta->scratch);
+   free(delta);
+}
+
+void state_manager_delta_begin(state_manager_delta_t *delta,
+      const void *src, const void *dst, void *patch)
+{
+#ifdef HAVE_THREADS
+   if (delta->pool)
+   {
+      unsigned i;
+      size_t stripe_max    = state_manager_raw_maxsize(
+            delta->stripe16s * sizeof(uint16_t));
+      size_t num16s        = (delta->len + sizeof(uint16_t) - 1)
+         / sizeof(uint16_t);
+      size_t offset        = 0;
+      const uint16_t *old16 = (const uint16_t*)src;
+      const uint16_t *new16 = (const uint16_t*)dst;
+
+      for (i = 0; i < delta->num_stripes; i++)
+      {
+         struct state_manager_delta_stripe *stripe = &delta->stripes[i];
+
+         stripe->old16   = old16 + offset;
+         stripe->new16   = new16 + offset;
+         stripe->out16   = (i == 0) ? (uint16_t*)patch
+            : (uint16_t*)((uint8_t*)delta->scratch + stripe_max * (i - 1));
+         stripe->num16s  = (num16s - offset < delta->stripe16s)
+            ? num16s - offset : delta->stripe16s;
+         stripe->last    = (i == delta->num_stripes - 1);
+         stripe->written = 0;
+         offset         += stripe->num16s;
+
+         /* Nothing else picks up stripes that failed to queue */
+         if (!tpool_add_work(delta->pool,
+                  state_manager_delta_stripe_cb, stripe))
+            state_manager_delta_stripe_cb(stripe);
+      }
+
+      delta->patch   = (uint8_t*)patch;
+      delta->pending = true;
+      return;
+   }
+#endif
+
+   delta->patch   = (uint8_t*)patch;
+   delta->written = state_manager_raw_compress(src, dst, delta->len, patch);
+   delta->pending = true;
+}
+
+size_t state_manager_delta_end(state_manager_delta_t *delta)
+{
+   if (!delta->pending)
+      return 0;
+
+#ifdef HAVE_THREADS
+   if (delta->pool)
+   {
+      unsigned i;
+      uint16_t *compressed16 = (uint16_t*)delta->patch;
+
+      tpool_wait(delta->pool);
+
+      compressed16 += delta->stripes[0].written;
+
+      for (i = 1; i < delta->num_stripes; i++)
+      {
+         memcpy(compressed16, delta->stripes[i].out16,
+               delta->stripes[i].written * sizeof(uint16_t));
+         compressed16 += delta->stripes[i].written;
+      }
+
+      compressed16[0] = 0;
+      compressed16[1] = 0;
+      compressed16[2] = 0;
+
+      delta->written  = (uint8_t*)(compressed16 + 3) - delta->patch;
+   }
+#endif
+
+   delta->pending = false;
+   return delta->written;
+}
+
+bool state_manager_delta_pending(state_manager_delta_t *delta)
+{
+   return delta && delta->pending;
+}
@@ -0,0 +1,129 @@
+/*  RetroArch - A frontend for libretro.
+ *  Copyright (C) 2010-2014 - Hans-Kristian Arntzen
+ *  Copyright (C) 2011-2017 - Daniel De Matteis
+ *  Copyright (C) 2014-2017 - Alfred Agrell
+ *
+ *  RetroArch is free software: you can redistribute it and/or modify it under the terms
+ *  of the GNU General Public License as published by the Free Software Found-
+ *  ation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  RetroArch is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ *  without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ *  PURPOSE.  See the GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along with RetroArch.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __STATE_MANAGER_DELTA_H
+#define __STATE_MANAGER_DELTA_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+#include <boolean.h>
+#include <retro_common_api.h>
+
+RETRO_BEGIN_DECLS
+
+/* Savestates smaller than this are never split into
+ * stripes; the thread handoff would cost more than
+ * the scan itself. */
+#define STATE_MANAGER_DELTA_STRIPE_MIN (256 * 1024)
+
+/* Upper bound on the number of stripes/worker threads. */
+#define STATE_MANAGER_DELTA_THREADS_MAX 8
+
+typedef struct state_manager_delta state_manager_delta_t;
+
+/* Returns the maximum compressed size of a savestate.
+ * It is very likely to compress to far less. */
+size_t state_manager_raw_maxsize(size_t uncomp);
+
+/*
+ * Allocates a savestate buffer suitable for
+ * state_manager_raw_compress(). 'uniq' must differ
+ * between the two buffers handed to the compressor.
+ * When you're done with it, send it to free().
+ */
+void *state_manager_raw_alloc(size_t len, uint16_t uniq);
+
+/*
+ * Prepares the tail of a buffer that was not allocated by
+ * state_manager_raw_alloc() the same way, so it can be handed to
+ * the compressor. The buffer needs at least 48 bytes of writable
+ * padding after 'len'.
+ */
+void state_manager_raw_set_uniq(void *data, size_t len, uint16_t uniq);
+
+/*
+ * Takes two savestates and creates a patch that turns 'src' into 'dst'.
+ * Both 'src' and 'dst' must be returned from state_manager_raw_alloc(),
+ * with the same 'len', and different 'uniq'.
+ *
+ * 'patch' must be size 'state_manager_raw_maxsize(len)' or more.
+ * Returns the number of bytes actually written to 'patch'.
+ */
+size_t state_manager_raw_compress(const void *src,
+      const void *dst, size_t len, void *patch);
+
+/*
+ * Takes 'patch' from a previous call to 'state_manager_raw_compress'
+ * and applies it to 'data' ('src' from that call),
+ * yielding 'dst' in that call.
+ *
+ * If the given arguments do not match a previous call to
+ * state_manager_raw_compress(), anything at all can happen.
+ */
+void state_manager_raw_decompress(const void *patch,
+      size_t patchlen, void *data, size_t datalen);
+
+/*
+ * Returns the size in bytes of a patch produced by
+ * state_manager_raw_compress(), end marker included.
+ */
+size_t state_manager_raw_patch_size(const void *patch);
+
+/**
+ * state_manager_delta_new:
+ * @len                  : size of the savestates to compress.
+ * @threads              : number of worker threads. 0 compresses
+ *                         synchronously on the calling thread.
+ *
+ * Creates a (possibly threaded) delta compressor. With worker
+ * threads, large states are split into stripes that are scanned
+ * in parallel, and compression runs asynchronously between
+ * state_manager_delta_begin() and state_manager_delta_end().
+ *
+ * Returns: new compressor, or NULL on failure.
+ **/
+state_manager_delta_t *state_manager_delta_new(size_t len,
+      unsigned threads);
+
+void state_manager_delta_free(state_manager_delta_t *delta);
+
+/**
+ * state_manager_delta_begin:
+ *
+ * Starts producing a patch that turns 'src' into 'dst'. Same
+ * requirements as state_manager_raw_compress(). 'src', 'dst' and
+ * 'patch' must not be touched until state_manager_delta_end()
+ * has returned.
+ **/
+void state_manager_delta_begin(state_manager_delta_t *delta,
+      const void *src, const void *dst, void *patch);
+
+/**
+ * state_manager_delta_end:
+ *
+ * Waits for the patch started by state_manager_delta_begin().
+ *
+ * Returns: number of bytes written to 'patch'.
+ **/
+size_t state_manager_delta_end(state_manager_delta_t *delta);
+
+bool state_manager_delta_pending(state_manager_delta_t *delta);
+
+RETRO_END_DECLS
+
+#endif
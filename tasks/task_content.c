@@ -2995,6 +2995,7 @@ void content_deinit(void)
 
    content_file_override_free(p_content);
    content_file_list_free(p_content->content_list);
+   content_state_pool_deinit();
 
    p_content->content_list                 = NULL;
    p_content->rom_crc                      = 0;
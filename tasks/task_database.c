@@ -27,10 +27,17 @@
 #include <streams/file_stream.h>
 #include <streams/chd_stream.h>
 #include <streams/interface_stream.h>
+#ifdef HAVE_THREADS
+#include <features/features_cpu.h>
+#include <rthreads/rthreads.h>
+#include <rthreads/tpool.h>
+#endif
 #include "tasks_internal.h"
 
 #include "../core_info.h"
+#include "../database_index.h"
 #include "../database_info.h"
+#include "../database_scan_cache.h"
 
 #include "../file_path_special.h"
 #include "../msg_hash.h"
@@ -52,21 +59,70 @@ typedef struct database_state_handle
    size_t entry_index;
    uint32_t crc;
    uint32_t archive_crc;
+   int64_t file_size;    /* of the current file, for the scan cache */
+   int64_t file_mtime;
+   bool file_stat;       /* file_size and file_mtime are valid */
+   bool file_cached;     /* probed out of the scan cache */
    char archive_name[511];
    char serial[4096];
 } database_state_handle_t;
 
+#ifdef HAVE_THREADS
+/* Files the hashing workers may get ahead of the scan, each */
+#define DATABASE_SCAN_AHEAD    4
+#define DATABASE_SCAN_MAX_JOBS 64
+
+struct db_handle;
+
+/* A file handed to the hashing workers. The scan takes the
+ * results in list order, so playlists come out the same as
+ * when it did the hashing itself. */
+typedef struct database_scan_job
+{
+   struct db_handle *db;
+   char *path;          /* copy, the list can grow meanwhile */
+   size_t index;        /* in the list of files */
+   int64_t size;        /* for the scan cache */
+   int64_t mtime;
+   enum database_type type;
+   uint32_t crc;
+   uint32_t archive_crc;
+   int ret;
+   bool queued;
+   bool done;           /* under scan_lock */
+   bool probed;         /* serial is valid */
+   bool stat;           /* size and mtime are valid */
+   bool cached;         /* out of the scan cache, never queued */
+   char serial[4096];
+} database_scan_job_t;
+#endif
+
 typedef struct db_handle
 {
    char *playlist_directory;
    char *content_database_path;
    char *fullpath;
+   char *cache_path;
    database_info_handle_t *handle;
+   database_index_t *index;
+   database_scan_cache_t *cache;
+   size_t files_hashed;
+   size_t files_cached;
+#ifdef HAVE_THREADS
+   tpool_t *scan_pool;
+   slock_t *scan_lock;
+   scond_t *scan_cond;
+   database_scan_job_t *scan_jobs;
+   size_t scan_num_jobs;
+   size_t scan_next;       /* next file to hand to the workers */
+   size_t scan_sheets_end; /* files up to here are cue/gdi sheets */
+#endif
    database_state_handle_t state;
    playlist_config_t playlist_config; /* size_t alignment */
    unsigned status;
    bool is_directory;
    bool scan_started;
+   bool scan_finished;
    bool scan_without_core_match;
    bool show_hidden_files;
 } db_handle_t;
@@ -575,78 +631,232 @@ static enum msg_file_type extension_to_file_type(const char *ext)
    return FILE_TYPE_NONE;
 }
 
-static int task_database_iterate_playlist(
-      database_state_handle_t *db_state,
-      database_info_handle_t *db, const char *name)
+/* Works out how to look a file up, and hashes it or reads its
+ * serial. It only reads the file, so the scan runs it on its
+ * workers as well. */
+static int task_database_probe(const char *name,
+      enum database_type *type, uint32_t *crc, uint32_t *archive_crc,
+      char *serial)
 {
    switch (extension_to_file_type(path_get_extension(name)))
    {
       case FILE_TYPE_COMPRESSED:
 #ifdef HAVE_COMPRESSION
-         db->type = DATABASE_TYPE_CRC_LOOKUP;
+         *type = DATABASE_TYPE_CRC_LOOKUP;
          /* first check crc of archive itself */
          return intfstream_file_get_crc(name,
-               0, SIZE_MAX, &db_state->archive_crc);
+               0, SIZE_MAX, archive_crc);
 #else
          break;
 #endif
       case FILE_TYPE_CUE:
-         task_database_cue_prune(db, name);
-         db_state->serial[0] = '\0';
-         if (task_database_cue_get_serial(name, db_state->serial))
-            db->type = DATABASE_TYPE_SERIAL_LOOKUP;
+         serial[0] = '\0';
+         if (task_database_cue_get_serial(name, serial))
+            *type = DATABASE_TYPE_SERIAL_LOOKUP;
          else
          {
-            db->type = DATABASE_TYPE_CRC_LOOKUP;
-            return task_database_cue_get_crc(name, &db_state->crc);
+            *type = DATABASE_TYPE_CRC_LOOKUP;
+            return task_database_cue_get_crc(name, crc);
          }
          break;
       case FILE_TYPE_GDI:
-         gdi_prune(db, name);
-         db_state->serial[0] = '\0';
+         serial[0] = '\0';
          /* There are no serial databases, so don't bother with
             serials at the moment */
-         if (0 && task_database_gdi_get_serial(name, db_state->serial))
-            db->type = DATABASE_TYPE_SERIAL_LOOKUP;
+         if (0 && task_database_gdi_get_serial(name, serial))
+            *type = DATABASE_TYPE_SERIAL_LOOKUP;
          else
          {
-            db->type = DATABASE_TYPE_CRC_LOOKUP;
-            return task_database_gdi_get_crc(name, &db_state->crc);
+            *type = DATABASE_TYPE_CRC_LOOKUP;
+            return task_database_gdi_get_crc(name, crc);
          }
          break;
       /* Consider Wii WBFS files similar to ISO files. */
       case FILE_TYPE_WBFS:
-         db_state->serial[0] = '\0';
-         intfstream_file_get_serial(name, 0, SIZE_MAX, db_state->serial);
-         db->type            =  DATABASE_TYPE_SERIAL_LOOKUP;
+         serial[0] = '\0';
+         intfstream_file_get_serial(name, 0, SIZE_MAX, serial);
+         *type     =  DATABASE_TYPE_SERIAL_LOOKUP;
          break;
       case FILE_TYPE_ISO:
-         db_state->serial[0] = '\0';
-         intfstream_file_get_serial(name, 0, SIZE_MAX, db_state->serial);
-         db->type            =  DATABASE_TYPE_SERIAL_LOOKUP;
+         serial[0] = '\0';
+         intfstream_file_get_serial(name, 0, SIZE_MAX, serial);
+         *type     =  DATABASE_TYPE_SERIAL_LOOKUP;
          break;
       case FILE_TYPE_CHD:
-         db_state->serial[0] = '\0';
-         if (task_database_chd_get_serial(name, db_state->serial))
-            db->type         = DATABASE_TYPE_SERIAL_LOOKUP;
+         serial[0] = '\0';
+         if (task_database_chd_get_serial(name, serial))
+            *type  = DATABASE_TYPE_SERIAL_LOOKUP;
          else
          {
-            db->type         = DATABASE_TYPE_CRC_LOOKUP;
-            return task_database_chd_get_crc(name, &db_state->crc);
+            *type  = DATABASE_TYPE_CRC_LOOKUP;
+            return task_database_chd_get_crc(name, crc);
          }
          break;
       case FILE_TYPE_LUTRO:
-         db->type            = DATABASE_TYPE_ITERATE_LUTRO;
+         *type     = DATABASE_TYPE_ITERATE_LUTRO;
          break;
       default:
-         db_state->serial[0] = '\0';
-         db->type            = DATABASE_TYPE_CRC_LOOKUP;
-         return intfstream_file_get_crc(name, 0, SIZE_MAX, &db_state->crc);
+         serial[0] = '\0';
+         *type     = DATABASE_TYPE_CRC_LOOKUP;
+         return intfstream_file_get_crc(name, 0, SIZE_MAX, crc);
    }
 
    return 1;
 }
 
+/* Takes the files a cue or gdi sheet refers to off the list */
+static void task_database_prune(database_info_handle_t *db, const char *name)
+{
+   switch (extension_to_file_type(path_get_extension(name)))
+   {
+      case FILE_TYPE_CUE:
+         task_database_cue_prune(db, name);
+         break;
+      case FILE_TYPE_GDI:
+         gdi_prune(db, name);
+         break;
+      default:
+         break;
+   }
+}
+
+/* Size and modification time the scan cache keeps @name under.
+ * What a cue or gdi sheet hashes to depends on its tracks too,
+ * so their sizes add up and the latest time counts. */
+static bool task_database_stat(const char *name,
+      int64_t *size, int64_t *mtime)
+{
+   char path[PATH_MAX_LENGTH];
+   intfstream_t *fd        = NULL;
+   enum msg_file_type type = FILE_TYPE_NONE;
+
+   if (!database_scan_cache_stat(name, size, mtime))
+      return false;
+
+   type = extension_to_file_type(path_get_extension(name));
+
+   if (type != FILE_TYPE_CUE && type != FILE_TYPE_GDI)
+      return true;
+
+   if (!(fd = intfstream_open_file(name,
+         RETRO_VFS_FILE_ACCESS_READ, RETRO_VFS_FILE_ACCESS_HINT_NONE)))
+      return true;
+
+   path[0] = '\0';
+
+   while (type == FILE_TYPE_CUE
+         ? cue_next_file(fd, name, path, sizeof(path))
+         : gdi_next_file(fd, name, path, sizeof(path)))
+   {
+      /* A missing track counts too, for when it turns up */
+      int64_t track_size  = -1;
+      int64_t track_mtime = -1;
+
+      path_get_info(path, &track_size, &track_mtime);
+
+      *size += track_size;
+      if (track_mtime > *mtime)
+         *mtime = track_mtime;
+   }
+
+   intfstream_close(fd);
+   free(fd);
+   return true;
+}
+
+/* Entry of @name in the scan cache, if it did not change since.
+ * Leaves its size and modification time for the entry the scan
+ * stores otherwise. */
+static database_scan_cache_entry_t *task_database_cache_find(
+      db_handle_t *_db, const char *name,
+      int64_t *size, int64_t *mtime, bool *stat)
+{
+   *stat = _db->cache && task_database_stat(name, size, mtime);
+   if (!*stat)
+      return NULL;
+   return database_scan_cache_find(_db->cache, name, *size, *mtime);
+}
+
+/* Takes what probing @name would find out of the scan cache */
+static bool task_database_cache_lookup(db_handle_t *_db,
+      database_state_handle_t *db_state, enum database_type *type,
+      const char *name)
+{
+   database_scan_cache_entry_t *entry = task_database_cache_find(_db,
+         name, &db_state->file_size, &db_state->file_mtime,
+         &db_state->file_stat);
+
+   db_state->file_cached    = false;
+
+   if (!entry)
+      return false;
+
+   *type                    = entry->type;
+   db_state->crc            = entry->crc;
+   db_state->archive_crc    = entry->archive_crc;
+   if (entry->type != DATABASE_TYPE_ITERATE_ARCHIVE)
+      strlcpy(db_state->serial, entry->serial ? entry->serial : "",
+            sizeof(db_state->serial));
+   db_state->file_cached    = true;
+   _db->files_cached++;
+   return true;
+}
+
+/* Keeps what probing @name found for the next scans */
+static void task_database_cache_store(db_handle_t *_db,
+      database_state_handle_t *db_state, enum database_type type,
+      const char *name)
+{
+   if (type == DATABASE_TYPE_ITERATE_LUTRO)
+      return;
+
+   _db->files_hashed++;
+
+   /* Members the archive has no CRC for are not worth it */
+   if (     db_state->file_stat
+         && (type != DATABASE_TYPE_ITERATE_ARCHIVE || db_state->crc))
+      database_scan_cache_put(_db->cache, name,
+            db_state->file_size, db_state->file_mtime, type,
+            db_state->crc, db_state->archive_crc,
+            type == DATABASE_TYPE_SERIAL_LOOKUP ? db_state->serial : NULL);
+}
+
+static int task_database_iterate_playlist(
+      db_handle_t *_db,
+      database_state_handle_t *db_state,
+      database_info_handle_t *db, const char *name)
+{
+   int ret;
+
+   task_database_prune(db, name);
+
+   if (task_database_cache_lookup(_db, db_state, &db->type, name))
+      return 1;
+
+   ret = task_database_probe(name, &db->type,
+         &db_state->crc, &db_state->archive_crc, db_state->serial);
+
+   if (ret)
+      task_database_cache_store(_db, db_state, db->type, name);
+
+   return ret;
+}
+
+/* The CRC of a file in an archive comes from the archive's
+ * directory */
+static void task_database_iterate_archive_member(db_handle_t *_db,
+      database_state_handle_t *db_state, const char *name)
+{
+   enum database_type type = DATABASE_TYPE_ITERATE_ARCHIVE;
+
+   if (task_database_cache_lookup(_db, db_state, &type, name))
+      return;
+
+   db_state->crc = file_archive_get_file_crc32(name);
+   task_database_cache_store(_db, db_state,
+         DATABASE_TYPE_ITERATE_ARCHIVE, name);
+}
+
 static int database_info_list_iterate_end_no_match(
       database_info_handle_t *db,
       database_state_handle_t *db_state,
@@ -724,32 +934,78 @@ static int database_info_list_iterate_new(database_state_handle_t *db_state,
    return 0;
 }
 
-static int database_info_list_iterate_found_match(
-      db_handle_t *_db,
-      database_state_handle_t *db_state,
-      database_info_handle_t *db,
-      const char *archive_name
-      )
+static int database_index_offset_compare(const void *a, const void *b)
+{
+   uint64_t l = *(const uint64_t*)a;
+   uint64_t r = *(const uint64_t*)b;
+   return (l > r) - (l < r);
+}
+
+/* Fills db_state->info with the records of the current database
+ * that have either CRC, or the serial, out of the scan's index.
+ * Each database is read into the index the first time it is
+ * looked at, so after that a lookup only reads the records that
+ * match. Returns false if the database could not be indexed and
+ * has to be queried instead. */
+static bool database_info_list_iterate_index(db_handle_t *_db,
+      database_state_handle_t *db_state, bool serial)
+{
+   uint64_t offsets[DATABASE_INDEX_MAX_MATCHES];
+   size_t count             = 0;
+   const char *new_database = database_info_get_current_name(db_state);
+   int id                   = -1;
+
+   if (!_db->index)
+      _db->index = database_index_new();
+   if (!_db->index)
+      return false;
+
+   if ((id = database_index_load(_db->index, new_database)) < 0)
+      return false;
+
+   if (serial)
+      count = database_index_find_serial(_db->index, id,
+            db_state->serial, offsets, DATABASE_INDEX_MAX_MATCHES);
+   else
+   {
+      count = database_index_find_crc(_db->index, id,
+            db_state->crc, offsets, DATABASE_INDEX_MAX_MATCHES);
+      if (db_state->archive_crc != db_state->crc)
+         count += database_index_find_crc(_db->index, id,
+               db_state->archive_crc, offsets + count,
+               DATABASE_INDEX_MAX_MATCHES - count);
+   }
+
+   /* Same order as the query would have found them in */
+   qsort(offsets, count, sizeof(*offsets), database_index_offset_compare);
+
+   if (db_state->info)
+   {
+      database_info_list_free(db_state->info);
+      free(db_state->info);
+   }
+   db_state->info = database_info_list_new_offsets(new_database,
+         offsets, count);
+   return true;
+}
+
+/* Adds @entry_path to the playlist of the database at @db_path,
+ * unless it is there already */
+static void task_database_add_to_playlist(db_handle_t *_db,
+      const char *db_path, const char *entry_path,
+      const char *archive_name, const char *label, const char *db_crc)
 {
    /* TODO/FIXME - heap allocations are done here to avoid
     * running out of stack space on systems with a limited stack size.
     * We should use less fullsize paths in the future so that we don't
     * need to have all these big char arrays here */
    size_t str_len                 = PATH_MAX_LENGTH * sizeof(char);
-   char* db_crc                   = (char*)malloc(str_len);
    char* db_playlist_base_str     = (char*)malloc(str_len);
    char* db_playlist_path         = (char*)malloc(str_len);
    char* entry_path_str           = (char*)malloc(str_len);
    char *hash                     = NULL;
    playlist_t   *playlist         = NULL;
-   const char         *db_path    =
-      database_info_get_current_name(db_state);
-   const char         *entry_path =
-      database_info_get_current_element_name(db);
-   database_info_t *db_info_entry =
-      &db_state->info->list[db_state->entry_index];
 
-   db_crc[0]                      = '\0';
    db_playlist_path[0]            = '\0';
    db_playlist_base_str[0]        = '\0';
    entry_path_str[0]              = '\0';
@@ -766,15 +1022,6 @@ static int database_info_list_iterate_found_match(
    playlist_config_set_path(&_db->playlist_config, db_playlist_path);
    playlist = playlist_init(&_db->playlist_config);
 
-   if (!string_is_empty(db_state->serial))
-   {
-      snprintf(db_crc, str_len, "%s|serial", db_state->serial);
-   }
-   else
-   {
-      snprintf(db_crc, str_len, "%08lX|crc", (unsigned long)db_info_entry->crc32);
-   }
-
    if (entry_path)
       strlcpy(entry_path_str, entry_path, str_len);
 
@@ -782,8 +1029,7 @@ static int database_info_list_iterate_found_match(
       fill_pathname_join_delim(entry_path_str,
             entry_path_str, archive_name, '#', str_len);
 
-   if (core_info_database_match_archive_member(
-         db_state->list->elems[db_state->list_index].data) &&
+   if (core_info_database_match_archive_member(db_path) &&
        (hash = strchr(entry_path_str, '#')))
        *hash = '\0';
 
@@ -818,11 +1064,11 @@ static int database_info_list_iterate_found_match(
       /* the push function reads our entry as const,
        * so these casts are safe */
       entry.path              = entry_path_str;
-      entry.label             = db_info_entry->name;
+      entry.label             = (char*)label;
       entry.core_path         = (char*)"DETECT";
       entry.core_name         = (char*)"DETECT";
       entry.db_name           = db_playlist_base_str;
-      entry.crc32             = db_crc;
+      entry.crc32             = (char*)db_crc;
       entry.subsystem_ident   = NULL;
       entry.subsystem_name    = NULL;
       entry.subsystem_roms    = NULL;
@@ -842,6 +1088,44 @@ static int database_info_list_iterate_found_match(
    playlist_write_file(playlist);
    playlist_free(playlist);
 
+   free(db_playlist_base_str);
+   free(db_playlist_path);
+   free(entry_path_str);
+}
+
+static int database_info_list_iterate_found_match(
+      db_handle_t *_db,
+      database_state_handle_t *db_state,
+      database_info_handle_t *db,
+      const char *archive_name
+      )
+{
+   size_t str_len                 = PATH_MAX_LENGTH * sizeof(char);
+   char* db_crc                   = (char*)malloc(str_len);
+   const char         *db_path    =
+      database_info_get_current_name(db_state);
+   const char         *entry_path =
+      database_info_get_current_element_name(db);
+   database_info_t *db_info_entry =
+      &db_state->info->list[db_state->entry_index];
+
+   if (!string_is_empty(db_state->serial))
+   {
+      snprintf(db_crc, str_len, "%s|serial", db_state->serial);
+   }
+   else
+   {
+      snprintf(db_crc, str_len, "%08lX|crc", (unsigned long)db_info_entry->crc32);
+   }
+
+   task_database_add_to_playlist(_db, db_path, entry_path, archive_name,
+         db_info_entry->name, db_crc);
+
+   /* The next scan can go straight to the playlist entry */
+   if (db_state->file_stat && entry_path && string_is_empty(archive_name))
+      database_scan_cache_set_match(_db->cache, entry_path, db_path,
+            db_info_entry->name, db_crc);
+
    database_info_list_free(db_state->info);
    free(db_state->info);
 
@@ -862,12 +1146,50 @@ static int database_info_list_iterate_found_match(
    }
 
    free(db_crc);
-   free(db_playlist_base_str);
-   free(db_playlist_path);
-   free(entry_path_str);
    return 0;
 }
 
+/* Adds a file whose probe came out of the scan cache to the
+ * playlist it got last time, if it still would. Returns false
+ * if the databases have to be looked through after all. */
+static bool task_database_iterate_cached_match(db_handle_t *_db,
+      database_state_handle_t *db_state, database_info_handle_t *db,
+      const char *name, bool path_contains_compressed_file)
+{
+   size_t i;
+   database_scan_cache_entry_t *entry = database_scan_cache_find(
+         _db->cache, name, db_state->file_size, db_state->file_mtime);
+
+   if (!entry || !entry->db_path || !db_state->list)
+      return false;
+
+   /* Not one of the databases this scan uses */
+   for (i = 0; i < db_state->list->size; i++)
+      if (string_is_equal(db_state->list->elems[i].data, entry->db_path))
+         break;
+   if (i == db_state->list->size)
+      return false;
+
+   /* What task_database_iterate_crc_lookup() would skip the
+    * database for; the cores may have changed since */
+   if (     db->type != DATABASE_TYPE_SERIAL_LOOKUP
+         && !_db->scan_without_core_match)
+   {
+      if (!core_info_database_supports_content_path(entry->db_path, name))
+         return false;
+      if (     !path_contains_compressed_file
+            && core_info_database_match_archive_member(entry->db_path))
+         return false;
+   }
+
+   task_database_add_to_playlist(_db, entry->db_path, name, NULL,
+         entry->label, entry->db_crc);
+
+   db_state->crc         = 0;
+   db_state->archive_crc = 0;
+   return true;
+}
+
 /* End of entries in database info list and didn't find a
  * match, go to the next database. */
 static int database_info_list_iterate_next(
@@ -932,11 +1254,15 @@ static int task_database_iterate_crc_lookup(
          }
       }
 
-      snprintf(query, sizeof(query),
-            "{crc:or(b\"%08lX\",b\"%08lX\")}",
-            (unsigned long)db_state->crc, (unsigned long)db_state->archive_crc);
+      if (!database_info_list_iterate_index(_db, db_state, false))
+      {
+         snprintf(query, sizeof(query),
+               "{crc:or(b\"%08lX\",b\"%08lX\")}",
+               (unsigned long)db_state->crc,
+               (unsigned long)db_state->archive_crc);
 
-      database_info_list_iterate_new(db_state, query);
+         database_info_list_iterate_new(db_state, query);
+      }
    }
 
    if (db_state->info)
@@ -1055,7 +1381,8 @@ static int task_database_iterate_serial_lookup(
       return database_info_list_iterate_end_no_match(db, db_state, name,
             path_contains_compressed_file);
 
-   if (db_state->entry_index == 0)
+   if (db_state->entry_index == 0 &&
+         !database_info_list_iterate_index(_db, db_state, true))
    {
       char query[50];
       char *serial_buf = bin_to_hex_alloc(
@@ -1116,10 +1443,19 @@ static int task_database_iterate(
       database_info_handle_t *db,
       bool path_contains_compressed_file)
 {
+   /* Once, before the first database is looked at */
+   if (db_state->file_cached && db->type != DATABASE_TYPE_ITERATE)
+   {
+      db_state->file_cached = false;
+      if (task_database_iterate_cached_match(_db, db_state, db, name,
+               path_contains_compressed_file))
+         return 0;
+   }
+
    switch (db->type)
    {
       case DATABASE_TYPE_ITERATE:
-         return task_database_iterate_playlist(db_state, db, name);
+         return task_database_iterate_playlist(_db, db_state, db, name);
       case DATABASE_TYPE_ITERATE_ARCHIVE:
 #ifdef HAVE_COMPRESSION
          return task_database_iterate_crc_lookup(
@@ -1155,6 +1491,246 @@ static void task_database_cleanup_state(
    db_state->buf = NULL;
 }
 
+#ifdef HAVE_THREADS
+static bool task_database_is_sheet(const char *path)
+{
+   enum msg_file_type type = extension_to_file_type(
+         path_get_extension(path));
+   return type == FILE_TYPE_CUE || type == FILE_TYPE_GDI;
+}
+
+static void task_database_scan_work(void *data)
+{
+   database_scan_job_t *job = (database_scan_job_t*)data;
+   enum database_type type  = DATABASE_TYPE_ITERATE;
+   uint32_t crc             = 0;
+   uint32_t archive_crc     = 0;
+   int ret                  = 1;
+   bool probed              = false;
+
+   /* The scan only reads the CRC of a file in an archive
+    * from the archive's directory */
+   if (path_contains_compressed_file(job->path))
+   {
+      crc    = file_archive_get_file_crc32(job->path);
+      type   = DATABASE_TYPE_ITERATE_ARCHIVE;
+   }
+   else
+   {
+      ret    = task_database_probe(job->path, &type,
+            &crc, &archive_crc, job->serial);
+      probed = true;
+   }
+
+   slock_lock(job->db->scan_lock);
+   job->type        = type;
+   job->crc         = crc;
+   job->archive_crc = archive_crc;
+   job->ret         = ret;
+   job->probed      = probed;
+   job->done        = true;
+   scond_signal(job->db->scan_cond);
+   slock_unlock(job->db->scan_lock);
+}
+
+static void task_database_scan_init(db_handle_t *_db,
+      database_info_handle_t *dbinfo)
+{
+   size_t i;
+   unsigned workers = cpu_features_get_core_amount();
+   size_t num_jobs  = (size_t)workers * DATABASE_SCAN_AHEAD;
+
+   if (dbinfo->list->size < 2)
+      return;
+
+   if (num_jobs > DATABASE_SCAN_MAX_JOBS)
+      num_jobs = DATABASE_SCAN_MAX_JOBS;
+
+   _db->scan_jobs = (database_scan_job_t*)
+      calloc(num_jobs, sizeof(*_db->scan_jobs));
+   _db->scan_lock = slock_new();
+   _db->scan_cond = scond_new();
+   _db->scan_pool = tpool_create(workers);
+
+   if (!_db->scan_jobs || !_db->scan_lock || !_db->scan_cond
+         || !_db->scan_pool)
+   {
+      if (_db->scan_pool)
+         tpool_destroy(_db->scan_pool);
+      if (_db->scan_cond)
+         scond_free(_db->scan_cond);
+      if (_db->scan_lock)
+         slock_free(_db->scan_lock);
+      free(_db->scan_jobs);
+      _db->scan_pool = NULL;
+      _db->scan_cond = NULL;
+      _db->scan_lock = NULL;
+      _db->scan_jobs = NULL;
+      return;
+   }
+
+   _db->scan_num_jobs   = num_jobs;
+   _db->scan_next       = 0;
+
+   /* dir_list_prioritize() put the sheets first */
+   for (i = 0; i < dbinfo->list->size; i++)
+      if (!task_database_is_sheet(dbinfo->list->elems[i].data))
+         break;
+   _db->scan_sheets_end = i;
+
+   RARCH_LOG("[Scanner]: Hashing with %u workers.\n", workers);
+}
+
+static void task_database_scan_deinit(db_handle_t *_db)
+{
+   size_t i;
+
+   if (!_db->scan_pool)
+      return;
+
+   /* Waits for the files being hashed, drops the rest */
+   tpool_destroy(_db->scan_pool);
+   scond_free(_db->scan_cond);
+   slock_free(_db->scan_lock);
+
+   for (i = 0; i < _db->scan_num_jobs; i++)
+      free(_db->scan_jobs[i].path);
+   free(_db->scan_jobs);
+
+   _db->scan_pool = NULL;
+   _db->scan_cond = NULL;
+   _db->scan_lock = NULL;
+   _db->scan_jobs = NULL;
+}
+
+/* Hands the workers the files after the one being matched, as
+ * many as there are jobs */
+static void task_database_scan_queue(db_handle_t *_db,
+      database_info_handle_t *dbinfo)
+{
+   while (     _db->scan_next < dbinfo->list->size
+         &&    _db->scan_next < dbinfo->list_ptr + _db->scan_num_jobs)
+   {
+      database_scan_job_t *job =
+         &_db->scan_jobs[_db->scan_next % _db->scan_num_jobs];
+      const char *path         = dbinfo->list->elems[_db->scan_next].data;
+
+      if (job->queued)
+      {
+         /* A file pruned while it was being hashed */
+         bool done;
+         slock_lock(_db->scan_lock);
+         done = job->done;
+         slock_unlock(_db->scan_lock);
+         if (!done)
+            break;
+         free(job->path);
+         job->path   = NULL;
+         job->queued = false;
+      }
+
+      if (path)
+      {
+         database_scan_cache_entry_t *entry = NULL;
+
+         /* The sheets can still prune any file after them */
+         if (     _db->scan_next >= _db->scan_sheets_end
+               && dbinfo->list_ptr < _db->scan_sheets_end)
+            break;
+
+         job->db        = _db;
+         job->path      = strdup(path);
+         job->index     = _db->scan_next;
+         job->done      = false;
+         job->cached    = false;
+         job->serial[0] = '\0';
+
+         if (!job->path)
+            break;
+
+         /* Nothing to hash, the result is ready */
+         if ((entry = task_database_cache_find(_db, path,
+                     &job->size, &job->mtime, &job->stat)))
+         {
+            job->type        = entry->type;
+            job->crc         = entry->crc;
+            job->archive_crc = entry->archive_crc;
+            job->ret         = 1;
+            job->probed      = entry->type != DATABASE_TYPE_ITERATE_ARCHIVE;
+            if (entry->serial)
+               strlcpy(job->serial, entry->serial, sizeof(job->serial));
+            job->cached      = true;
+            job->done        = true;
+         }
+         else if (!tpool_add_work(_db->scan_pool,
+                  task_database_scan_work, job))
+         {
+            free(job->path);
+            job->path = NULL;
+            break;
+         }
+
+         job->queued    = true;
+      }
+
+      _db->scan_next++;
+   }
+}
+
+/* Takes the workers' result for the current file.
+ *
+ * Returns: -1 while it is still being hashed, 2 if it was never
+ * handed out, otherwise what task_database_iterate_playlist()
+ * would have. */
+static int task_database_scan_collect(db_handle_t *_db,
+      database_state_handle_t *db_state,
+      database_info_handle_t *dbinfo,
+      const char *name)
+{
+   int ret;
+   bool done;
+   database_scan_job_t *job =
+      &_db->scan_jobs[dbinfo->list_ptr % _db->scan_num_jobs];
+
+   if (!job->queued || job->index != dbinfo->list_ptr)
+      return 2;
+
+   /* Not for long, the task has to see it being cancelled */
+   slock_lock(_db->scan_lock);
+   if (!job->done)
+      scond_wait_timeout(_db->scan_cond, _db->scan_lock, 10000);
+   done = job->done;
+   slock_unlock(_db->scan_lock);
+
+   if (!done)
+      return -1;
+
+   task_database_prune(dbinfo, name);
+
+   dbinfo->type          = job->type;
+   db_state->crc         = job->crc;
+   db_state->archive_crc = job->archive_crc;
+   db_state->file_size   = job->size;
+   db_state->file_mtime  = job->mtime;
+   db_state->file_stat   = job->stat;
+   db_state->file_cached = job->cached;
+   if (job->probed)
+      strlcpy(db_state->serial, job->serial, sizeof(db_state->serial));
+   ret                   = job->ret;
+
+   if (job->cached)
+      _db->files_cached++;
+   else if (ret)
+      task_database_cache_store(_db, db_state, job->type, name);
+
+   free(job->path);
+   job->path             = NULL;
+   job->queued           = false;
+
+   return ret;
+}
+#endif
+
 static void task_database_handler(retro_task_t *task)
 {
    const char *name                 = NULL;
@@ -1196,6 +1772,11 @@ static void task_database_handler(retro_task_t *task)
    if (!dbinfo || task_get_cancelled(task))
       goto task_finished;
 
+#ifdef HAVE_THREADS
+   if (db->scan_pool)
+      task_database_scan_queue(db, dbinfo);
+#endif
+
    switch (dbinfo->status)
    {
       case DATABASE_STATUS_ITERATE_BEGIN:
@@ -1208,6 +1789,12 @@ static void task_database_handler(retro_task_t *task)
                      db->show_hidden_files,
                      false, false);
 
+            /* Against all databases, scanning a single one
+             * does not make the others' matches stale */
+            if (!string_is_empty(db->cache_path))
+               db->cache = database_scan_cache_load(db->cache_path,
+                     database_scan_cache_signature(dbstate->list));
+
             /* If the scan path matches a database path exactly then
              * save time by only processing that database. */
             if (dbstate->list && db->is_directory)
@@ -1248,6 +1835,9 @@ static void task_database_handler(retro_task_t *task)
                }
             }
          }
+#ifdef HAVE_THREADS
+         task_database_scan_init(db, dbinfo);
+#endif
          dbinfo->status = DATABASE_STATUS_ITERATE_START;
          break;
       case DATABASE_STATUS_ITERATE_START:
@@ -1255,6 +1845,8 @@ static void task_database_handler(retro_task_t *task)
          task_database_cleanup_state(dbstate);
          dbstate->list_index  = 0;
          dbstate->entry_index = 0;
+         dbstate->file_stat   = false;
+         dbstate->file_cached = false;
          task_database_iterate_start(task, dbinfo, name);
          break;
       case DATABASE_STATUS_ITERATE:
@@ -1265,10 +1857,30 @@ static void task_database_handler(retro_task_t *task)
             if (!name)
                goto task_finished;
 
+#ifdef HAVE_THREADS
+            if (db->scan_pool && dbinfo->type == DATABASE_TYPE_ITERATE)
+            {
+               int ret = task_database_scan_collect(db, dbstate, dbinfo,
+                     name);
+
+               if (ret == -1 || ret == 1)
+                  break;
+               if (ret == 0)
+               {
+                  dbinfo->status = DATABASE_STATUS_ITERATE_NEXT;
+                  dbinfo->type   = DATABASE_TYPE_ITERATE;
+                  break;
+               }
+            }
+#endif
+
             path_contains_compressed_file      = path_contains_compressed_file(name);
             if (path_contains_compressed_file)
                if (dbinfo->type == DATABASE_TYPE_ITERATE)
+               {
                   dbinfo->type   = DATABASE_TYPE_ITERATE_ARCHIVE;
+                  task_database_iterate_archive_member(db, dbstate, name);
+               }
 
             if (task_database_iterate(db, name, dbstate, dbinfo,
                      path_contains_compressed_file) == 0)
@@ -1293,6 +1905,7 @@ static void task_database_handler(retro_task_t *task)
                msg = msg_hash_to_str(MSG_SCANNING_OF_DIRECTORY_FINISHED);
             else
                msg = msg_hash_to_str(MSG_SCANNING_OF_FILE_FINISHED);
+            db->scan_finished = true;
 #ifdef RARCH_INTERNAL
             task_free_title(task);
             task_set_title(task, strdup(msg));
@@ -1323,6 +1936,23 @@ task_finished:
 
    if (db)
    {
+#ifdef HAVE_THREADS
+      task_database_scan_deinit(db);
+#endif
+      if (db->cache)
+      {
+         /* Files of a directory scanned through that the scan did
+          * not come across are gone */
+         database_scan_cache_save(db->cache, db->cache_path,
+               (db->scan_finished && db->is_directory)
+               ? db->fullpath : NULL);
+         database_scan_cache_free(db->cache);
+         RARCH_LOG("[Scanner]: Hashed " STRING_REP_USIZE " files, "
+               STRING_REP_USIZE " were in the scan cache.\n",
+               db->files_hashed, db->files_cached);
+      }
+      if (!string_is_empty(db->cache_path))
+         free(db->cache_path);
       if (!string_is_empty(db->playlist_directory))
          free(db->playlist_directory);
       if (!string_is_empty(db->content_database_path))
@@ -1334,6 +1964,8 @@ task_finished:
 
       if (db->handle)
          database_info_free(db->handle);
+      if (db->index)
+         database_index_free(db->index);
       free(db);
    }
 
@@ -1395,6 +2027,25 @@ bool task_push_dbscan(
    db->playlist_directory                  = strdup(playlist_directory);
    db->content_database_path               = strdup(content_database);
 
+   {
+      char cache_dir[PATH_MAX_LENGTH];
+      char cache_path[PATH_MAX_LENGTH];
+
+      cache_dir[0]                         = '\0';
+#ifdef RARCH_INTERNAL
+      fill_pathname_application_special(cache_dir, sizeof(cache_dir),
+            APPLICATION_SPECIAL_DIRECTORY_CACHE);
+#else
+      strlcpy(cache_dir, playlist_directory, sizeof(cache_dir));
+#endif
+      if (!string_is_empty(cache_dir))
+      {
+         fill_pathname_join(cache_path, cache_dir,
+               FILE_PATH_DATABASE_SCAN_CACHE, sizeof(cache_path));
+         db->cache_path                    = strdup(cache_path);
+      }
+   }
+
    task_queue_push(t);
 
    return true;
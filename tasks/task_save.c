@@ -167,6 +167,30 @@ static struct ram_save_state_buf ram_buf;
 static struct autosave_st autosave_state;
 #endif
 
+/* Spare buffers kept around by the savestate pool */
+#define CONTENT_STATE_POOL_SPARES 8
+
+/* RASTATE identifier plus memory block header */
+#define CONTENT_STATE_POOL_HEADER 16
+
+/* Bookkeeping in front of the RASTATE header, keeps the core data
+ * 16-byte aligned */
+#define CONTENT_STATE_POOL_PREFIX 16
+
+/* Room behind the RASTATE end block. Covers the end marker and
+ * read-ahead padding of state_manager_raw_compress(). */
+#define CONTENT_STATE_POOL_PADDING 64
+
+struct content_state_pool
+{
+   void *spares[CONTENT_STATE_POOL_SPARES];
+   size_t size;
+   unsigned num_spares;
+};
+
+/* TODO/FIXME - global state - perhaps move outside this file */
+static struct content_state_pool content_state_pool;
+
 /* TODO/FIXME - global state - perhaps move outside this file */
 static bool save_state_in_background       = false;
 static struct string_list *task_save_files = NULL;
@@ -704,6 +728,127 @@ bool content_serialize_state(void* buffer, size_t buffer_size)
    return content_write_serialized_state(buffer, &size);
 }
 
+/* Pooled buffers are laid out as
+ *
+ *    [prefix][RASTATE header][core data][END block][padding]
+ *
+ * with the prefix holding the core data size the buffer was
+ * allocated for. */
+static size_t content_state_pool_alloc_size(size_t size)
+{
+   return CONTENT_STATE_POOL_PREFIX + CONTENT_STATE_POOL_HEADER
+      + content_align_size(size) + 8 + CONTENT_STATE_POOL_PADDING;
+}
+
+bool content_state_pool_init(size_t size)
+{
+   struct content_state_pool *pool = &content_state_pool;
+
+   if (!size)
+      return false;
+
+   if (pool->size != size)
+   {
+      content_state_pool_deinit();
+      pool->size = size;
+   }
+
+   return true;
+}
+
+void content_state_pool_deinit(void)
+{
+   struct content_state_pool *pool = &content_state_pool;
+
+   while (pool->num_spares)
+      free(pool->spares[--pool->num_spares]);
+
+   pool->size = 0;
+}
+
+size_t content_state_pool_get_size(void)
+{
+   return content_state_pool.size;
+}
+
+void *content_state_pool_get(void)
+{
+   uint8_t *buf;
+   struct content_state_pool *pool = &content_state_pool;
+
+   if (!pool->size)
+      return NULL;
+
+   if (pool->num_spares)
+      buf = (uint8_t*)pool->spares[--pool->num_spares];
+   else
+   {
+      if (!(buf = (uint8_t*)calloc(1,
+                  content_state_pool_alloc_size(pool->size))))
+         return NULL;
+      memcpy(buf, &pool->size, sizeof(size_t));
+   }
+
+   return buf + CONTENT_STATE_POOL_PREFIX + CONTENT_STATE_POOL_HEADER;
+}
+
+void content_state_pool_put(void *data)
+{
+   size_t size;
+   uint8_t *buf;
+   struct content_state_pool *pool = &content_state_pool;
+
+   if (!data)
+      return;
+
+   buf = (uint8_t*)data - CONTENT_STATE_POOL_HEADER
+      - CONTENT_STATE_POOL_PREFIX;
+   memcpy(&size, buf, sizeof(size_t));
+
+   if (     size == pool->size
+         && pool->num_spares < CONTENT_STATE_POOL_SPARES)
+      pool->spares[pool->num_spares++] = buf;
+   else
+      free(buf);
+}
+
+size_t content_state_pool_get_rastate_size(void)
+{
+   struct content_state_pool *pool = &content_state_pool;
+
+   if (!pool->size)
+      return 0;
+
+#ifdef HAVE_CHEEVOS
+   if (rcheevos_get_serialize_size() > 0)
+      return 0;
+#endif
+
+   return CONTENT_STATE_POOL_HEADER + content_align_size(pool->size) + 8;
+}
+
+void *content_state_pool_to_rastate(void *data)
+{
+   size_t size;
+   unsigned char *output = (unsigned char*)data
+      - CONTENT_STATE_POOL_HEADER;
+
+   memcpy(&size, output - CONTENT_STATE_POOL_PREFIX, sizeof(size_t));
+
+   memcpy(output, "RASTATE", 7);
+   output[7] = RASTATE_VERSION;
+   content_write_block_header(output + 8, RASTATE_MEM_BLOCK, size);
+   content_write_block_header(output + CONTENT_STATE_POOL_HEADER
+         + content_align_size(size), RASTATE_END_BLOCK, 0);
+
+   return output;
+}
+
+void *content_state_pool_from_rastate(void *rastate)
+{
+   return (uint8_t*)rastate + CONTENT_STATE_POOL_HEADER;
+}
+
 static void *content_get_serialized_data(size_t* serial_size)
 {
    void* data;